@@ -28,6 +28,9 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "types.h"
 #include "utility.h"
 #include "UFO/portable_cpuid.h"
+#if defined( _MSC_VER )
+#include <immintrin.h>
+#endif
 
 
 namespace iSTD
@@ -44,10 +47,31 @@ enum CPU_INSTRUCTION_LEVEL
     CPU_INSTRUCTION_LEVEL_SSE3,
     CPU_INSTRUCTION_LEVEL_SSE4,
     CPU_INSTRUCTION_LEVEL_SSE4_1,
+    CPU_INSTRUCTION_LEVEL_AVX2,
+    CPU_INSTRUCTION_LEVEL_AVX512,
     NUM_CPU_INSTRUCTION_LEVELS
 };
 
 
+/*****************************************************************************\
+Inline Function:
+    GetXCR0
+
+Description:
+    Returns the low 32 bits of XCR0, i.e. the register state the OS saves
+    on context switch. Only valid when CPUID.1:ECX.OSXSAVE is set.
+\*****************************************************************************/
+inline unsigned int GetXCR0( void )
+{
+#if defined( _MSC_VER )
+    return static_cast<unsigned int>( _xgetbv( 0 ) );
+#else
+    unsigned int eax = 0, edx = 0;
+    __asm__ __volatile__( "xgetbv" : "=a"( eax ), "=d"( edx ) : "c"( 0 ) );
+    return eax;
+#endif
+}
+
 /*****************************************************************************\
 Inline Function:
     GetCpuInstructionLevel
@@ -76,6 +100,28 @@ inline CPU_INSTRUCTION_LEVEL GetCpuInstructionLevel( void )
     if( CPUInfo[2] & BIT(19) )
     {
         CpuInstructionLevel = CPU_INSTRUCTION_LEVEL_SSE4_1;
+
+        // AVX2 / AVX-512 also need the OS to save the wider register state
+        const bool osxsave = ( CPUInfo[2] & BIT(27) ) != 0;
+        const unsigned int xcr0 = osxsave ? GetXCR0() : 0;
+        const unsigned int ymmState = BIT(1) | BIT(2);
+        const unsigned int zmmState = ymmState | BIT(5) | BIT(6) | BIT(7);
+
+        int maxLeaf[4] = { 0, 0, 0, 0 };
+        __cpuid(maxLeaf, 0);
+        if( maxLeaf[0] >= 7 && ( xcr0 & ymmState ) == ymmState )
+        {
+            int extInfo[4] = { 0, 0, 0, 0 };
+            __cpuidex(extInfo, 7, 0);
+            if( extInfo[1] & BIT(5) )
+            {
+                CpuInstructionLevel = CPU_INSTRUCTION_LEVEL_AVX2;
+                if( ( extInfo[1] & BIT(16) ) && ( xcr0 & zmmState ) == zmmState )
+                {
+                    CpuInstructionLevel = CPU_INSTRUCTION_LEVEL_AVX512;
+                }
+            }
+        }
     }
     else if( CPUInfo[2] & BIT(0) )
     {
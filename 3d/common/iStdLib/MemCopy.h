@@ -69,8 +69,26 @@ enum
     DUAL_CACHE_SIZE     = 128,
     MIN_ERMSB_ALIGNED   = 4096,
     MIN_STREAM_SIZE     = 524288,
+    MIN_AVX_STREAM_SIZE = 2097152,
 };
 
+/*****************************************************************************\
+MACROS:
+    ISTD_TARGET_AVX2
+    ISTD_TARGET_AVX512
+
+Description:
+    Allows AVX2 / AVX-512 intrinsics in functions that are only reached
+    after a runtime CPUID check, without building the whole TU for them
+\*****************************************************************************/
+#if defined( __GNUC__ ) || defined( __clang__ )
+#   define ISTD_TARGET_AVX2     __attribute__(( target( "avx2" ) ))
+#   define ISTD_TARGET_AVX512   __attribute__(( target( "avx512f" ) ))
+#else
+#   define ISTD_TARGET_AVX2
+#   define ISTD_TARGET_AVX512
+#endif
+
 #ifdef _WIN64
 #   define USE_INLINE_ASM 0
 #else
@@ -92,6 +110,8 @@ template <size_t size>
 inline void MemCopy( void*, const void* );
 inline void MemCopy( void*, const void*, const size_t );
 inline void MemCopyWC( void*, const void*, const size_t );
+inline void MemCopyStreamAVX2( void*, const void*, const size_t );
+inline void MemCopyStreamAVX512( void*, const void*, const size_t );
 inline void MemCopySwapBytes( void*, const void*, const size_t, const unsigned int);
 inline void ScalarSwapBytes( __m128i**, const __m128i**, const size_t, const unsigned int);
 
@@ -245,6 +265,24 @@ Description:
 \*****************************************************************************/
 inline void MemCopy( void* dst, const void* src, const size_t bytes )
 {
+    // multi-MB copies go through the widest streaming kernel the CPU has;
+    // below this a cached copy is still faster
+    if( bytes > MIN_AVX_STREAM_SIZE )
+    {
+        static const CPU_INSTRUCTION_LEVEL cpuInstructionLevel = GetCpuInstructionLevel();
+
+        if( cpuInstructionLevel >= CPU_INSTRUCTION_LEVEL_AVX512 )
+        {
+            MemCopyStreamAVX512( dst, src, bytes );
+            return;
+        }
+        if( cpuInstructionLevel >= CPU_INSTRUCTION_LEVEL_AVX2 )
+        {
+            MemCopyStreamAVX2( dst, src, bytes );
+            return;
+        }
+    }
+
 #if defined ( _MSC_VER )
     UINT8*			pDst8 = reinterpret_cast<UINT8*>( dst );
     const UINT8*	pSrc8 = reinterpret_cast<const UINT8*>( src );
@@ -637,6 +675,127 @@ inline void MemCopy( void* dst, const void* src, const size_t bytes )
 #endif
 }
 
+/*****************************************************************************\
+Inline Function:
+    MemCopyStreamAVX2
+
+Description:
+    Memory copy for buffers larger than half the largest cache. Aligns the
+    destination to 32 bytes and writes it with non-temporal 256-bit stores
+    so the copy does not evict the working set. The caller must have
+    checked for CPU_INSTRUCTION_LEVEL_AVX2.
+
+Input:
+    dst - pointer to destination buffer
+    src - pointer to source buffer
+    bytes - number of bytes to copy
+\*****************************************************************************/
+ISTD_TARGET_AVX2
+inline void MemCopyStreamAVX2( void* dst, const void* src, const size_t bytes )
+{
+    UINT8*          pDst8 = reinterpret_cast<UINT8*>( dst );
+    const UINT8*    pSrc8 = reinterpret_cast<const UINT8*>( src );
+    size_t          bytesRemaining = bytes;
+
+    // align the destination to 32 bytes
+    const size_t alignDst32 = reinterpret_cast<UINT_PTR>( pDst8 ) & ( INSTR_WIDTH_256 - 1 );
+    if( alignDst32 != 0 )
+    {
+        const size_t alignSize = INSTR_WIDTH_256 - alignDst32;
+        ::memcpy( pDst8, pSrc8, alignSize );
+
+        pDst8 += alignSize;
+        pSrc8 += alignSize;
+        bytesRemaining -= alignSize;
+    }
+
+    while( bytesRemaining >= DUAL_CACHE_SIZE )
+    {
+        const __m256i ymm0 = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( pSrc8 ) );
+        const __m256i ymm1 = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( pSrc8 + 32 ) );
+        const __m256i ymm2 = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( pSrc8 + 64 ) );
+        const __m256i ymm3 = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( pSrc8 + 96 ) );
+
+        _mm256_stream_si256( reinterpret_cast<__m256i*>( pDst8 ), ymm0 );
+        _mm256_stream_si256( reinterpret_cast<__m256i*>( pDst8 + 32 ), ymm1 );
+        _mm256_stream_si256( reinterpret_cast<__m256i*>( pDst8 + 64 ), ymm2 );
+        _mm256_stream_si256( reinterpret_cast<__m256i*>( pDst8 + 96 ), ymm3 );
+
+        pDst8 += DUAL_CACHE_SIZE;
+        pSrc8 += DUAL_CACHE_SIZE;
+        bytesRemaining -= DUAL_CACHE_SIZE;
+    }
+
+    // order the streaming stores before the (cached) tail and any reader
+    _mm_sfence();
+    _mm256_zeroupper();
+
+    if( bytesRemaining )
+    {
+        ::memcpy( pDst8, pSrc8, bytesRemaining );
+    }
+}
+
+/*****************************************************************************\
+Inline Function:
+    MemCopyStreamAVX512
+
+Description:
+    AVX-512 variant of MemCopyStreamAVX2: aligns the destination to 64
+    bytes and streams four cachelines per iteration. The caller must have
+    checked for CPU_INSTRUCTION_LEVEL_AVX512.
+
+Input:
+    dst - pointer to destination buffer
+    src - pointer to source buffer
+    bytes - number of bytes to copy
+\*****************************************************************************/
+ISTD_TARGET_AVX512
+inline void MemCopyStreamAVX512( void* dst, const void* src, const size_t bytes )
+{
+    UINT8*          pDst8 = reinterpret_cast<UINT8*>( dst );
+    const UINT8*    pSrc8 = reinterpret_cast<const UINT8*>( src );
+    size_t          bytesRemaining = bytes;
+
+    // align the destination to a cacheline
+    const size_t alignDst64 = reinterpret_cast<UINT_PTR>( pDst8 ) & ( CACHE_LINE_SIZE - 1 );
+    if( alignDst64 != 0 )
+    {
+        const size_t alignSize = CACHE_LINE_SIZE - alignDst64;
+        ::memcpy( pDst8, pSrc8, alignSize );
+
+        pDst8 += alignSize;
+        pSrc8 += alignSize;
+        bytesRemaining -= alignSize;
+    }
+
+    while( bytesRemaining >= 4 * CACHE_LINE_SIZE )
+    {
+        const __m512i zmm0 = _mm512_loadu_si512( pSrc8 );
+        const __m512i zmm1 = _mm512_loadu_si512( pSrc8 + 64 );
+        const __m512i zmm2 = _mm512_loadu_si512( pSrc8 + 128 );
+        const __m512i zmm3 = _mm512_loadu_si512( pSrc8 + 192 );
+
+        _mm512_stream_si512( reinterpret_cast<__m512i*>( pDst8 ), zmm0 );
+        _mm512_stream_si512( reinterpret_cast<__m512i*>( pDst8 + 64 ), zmm1 );
+        _mm512_stream_si512( reinterpret_cast<__m512i*>( pDst8 + 128 ), zmm2 );
+        _mm512_stream_si512( reinterpret_cast<__m512i*>( pDst8 + 192 ), zmm3 );
+
+        pDst8 += 4 * CACHE_LINE_SIZE;
+        pSrc8 += 4 * CACHE_LINE_SIZE;
+        bytesRemaining -= 4 * CACHE_LINE_SIZE;
+    }
+
+    // order the streaming stores before the (cached) tail and any reader
+    _mm_sfence();
+    _mm256_zeroupper();
+
+    if( bytesRemaining )
+    {
+        ::memcpy( pDst8, pSrc8, bytesRemaining );
+    }
+}
+
 /*****************************************************************************\
 Inline Function:
     MemCopyWC
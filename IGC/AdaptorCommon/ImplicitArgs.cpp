@@ -572,6 +572,8 @@ const ImplicitArg ImplicitArgs::IMPLICIT_ARGS[ImplicitArg::NUM_IMPLICIT_ARGS] =
 
     ImplicitArg(ImplicitArg::STAGE_IN_GRID_ORIGIN, "stageInGridOrigin", ImplicitArg::INT, WIAnalysis::UNIFORM, 3, ImplicitArg::ALIGN_GRF, true),
     ImplicitArg(ImplicitArg::STAGE_IN_GRID_SIZE, "stageInGridSize", ImplicitArg::INT, WIAnalysis::UNIFORM, 3, ImplicitArg::ALIGN_GRF, true),
+
+    ImplicitArg(ImplicitArg::PRECOMPUTED_VALUE, "precomputedValue", ImplicitArg::INT, WIAnalysis::UNIFORM, 1, ImplicitArg::ALIGN_DWORD, true),
 };
 
 const int ImplicitArgs::numImageArgTypes = ImplicitArg::IMAGES_END - ImplicitArg::IMAGES_START + 1;
@@ -121,6 +121,8 @@ namespace IGC
             STAGE_IN_GRID_ORIGIN,
             STAGE_IN_GRID_SIZE,
 
+            PRECOMPUTED_VALUE,
+
             NUM_IMPLICIT_ARGS
         };
 
@@ -182,6 +182,101 @@ static bool hasSLMUsage(llvm::Module &M)
     return false;
 }
 
+// Check whether memory is never written through pointer `V` nor through any
+// pointer derived from it, and `V` does not escape. Pointers passed to a
+// defined function are followed into its body.
+static bool isNeverStoredThrough(Value *V, SmallPtrSetImpl<Value *> &Visited)
+{
+    if (!Visited.insert(V).second)
+    {
+        return true;
+    }
+
+    for (auto *U : V->users())
+    {
+        if (isa<LoadInst>(U))
+        {
+            continue;
+        }
+        if (isa<GetElementPtrInst>(U) || isa<BitCastInst>(U) ||
+            isa<AddrSpaceCastInst>(U) || isa<PHINode>(U) || isa<SelectInst>(U))
+        {
+            if (!isNeverStoredThrough(U, Visited))
+            {
+                return false;
+            }
+            continue;
+        }
+        if (auto *CI = dyn_cast<CallInst>(U))
+        {
+            Function *Callee = CI->getCalledFunction();
+            if (!Callee || Callee->isVarArg())
+            {
+                return false;
+            }
+            if (Callee->isDeclaration())
+            {
+                // Only trust declarations that promise not to write memory.
+                if (!Callee->onlyReadsMemory())
+                {
+                    return false;
+                }
+                continue;
+            }
+            for (unsigned i = 0, e = CI->getNumArgOperands(); i != e; ++i)
+            {
+                if (CI->getArgOperand(i) != V)
+                {
+                    continue;
+                }
+                auto ArgIt = Callee->arg_begin();
+                std::advance(ArgIt, i);
+                if (!isNeverStoredThrough(&*ArgIt, Visited))
+                {
+                    return false;
+                }
+            }
+            continue;
+        }
+        // Stores (of or through the pointer), atomics, ptrtoint, returns...
+        return false;
+    }
+    return true;
+}
+
+// Kernel buffer arguments are assumed to alias each other by default. Let the
+// driver and the static analysis above relax that.
+static bool processKernelBufferArgs(Function *F, const ModuleMetaData *modMD)
+{
+    bool Changed = false;
+    for (auto &Arg : F->args())
+    {
+        PointerType *PtrTy = dyn_cast<PointerType>(Arg.getType());
+        if (!PtrTy ||
+            (PtrTy->getAddressSpace() != ADDRESS_SPACE_GLOBAL &&
+             PtrTy->getAddressSpace() != ADDRESS_SPACE_CONSTANT))
+        {
+            continue;
+        }
+
+        if (modMD->compOpt.KernelBuffersNotAliased && !Arg.hasNoAliasAttr())
+        {
+            Arg.addAttr(llvm::Attribute::NoAlias);
+            Changed = true;
+        }
+
+        SmallPtrSet<Value *, 16> Visited;
+        if (IGC_IS_FLAG_ENABLED(EnableReadOnlyKernelArgs) &&
+            !Arg.onlyReadsMemory() && isNeverStoredThrough(&Arg, Visited))
+        {
+            Arg.addAttr(llvm::Attribute::ReadOnly);
+            Arg.addAttr(llvm::Attribute::NoCapture);
+            Changed = true;
+        }
+    }
+    return Changed;
+}
+
 bool ProcessFuncAttributes::runOnModule(Module& M)
 {
     MetaDataUtilsWrapper &mduw = getAnalysis<MetaDataUtilsWrapper>();
@@ -268,6 +363,10 @@ bool ProcessFuncAttributes::runOnModule(Module& M)
             F->setLinkage(GlobalValue::InternalLinkage);
             Changed = true;
         }
+        else
+        {
+            Changed |= processKernelBufferArgs(F, modMD);
+        }
 
         // inline all OCL math functions if __FastRelaxedMath is set
         if (fastMathFunct.find(F) != fastMathFunct.end()) continue;
@@ -0,0 +1,294 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#include "AdaptorOCL/BinaryCacheOCL.hpp"
+#include "AdaptorOCL/OCL/sp/gtpin_igc_ocl.h"
+#include "common/igc_regkeys.hpp"
+#include "common/secure_mem.h"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/CachePruning.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/Process.h>
+#include <llvm/Support/raw_ostream.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+using namespace llvm;
+
+namespace TC
+{
+
+namespace
+{
+    // Bump when the entry layout or the key composition changes.
+    const uint32_t CACHE_FORMAT_VERSION = 2;
+    const char CACHE_MAGIC[4] = { 'I', 'G', 'C', 'B' };
+    // pruneCache only considers files with this prefix.
+    const char CACHE_ENTRY_PREFIX[] = "llvmcache-igc-";
+
+    struct CacheEntryHeader
+    {
+        char     magic[4];
+        uint32_t version;
+        uint8_t  key[16];
+        uint32_t outputSize;
+        uint32_t debugDataSize;
+        uint32_t errorStringSize;
+    };
+
+    void hashBuffer(MD5& hash, const void* pData, uint32_t size)
+    {
+        hash.update(ArrayRef<uint8_t>(reinterpret_cast<const uint8_t*>(&size), sizeof(size)));
+        if (pData && size)
+        {
+            hash.update(ArrayRef<uint8_t>(static_cast<const uint8_t*>(pData), size));
+        }
+    }
+
+    template <typename T>
+    void hashValue(MD5& hash, const T& value)
+    {
+        hashBuffer(hash, &value, sizeof(T));
+    }
+
+    std::string getCacheDir()
+    {
+        const char* pDir = IGC_GET_REGKEYSTRING(OCLBinaryCacheDir);
+        if (pDir == nullptr || pDir[0] == '\0')
+        {
+            pDir = getenv("IGC_OCL_BINARY_CACHE_DIR");
+        }
+        return (pDir != nullptr) ? std::string(pDir) : std::string();
+    }
+}
+
+BinaryCacheOCL::BinaryCacheOCL(
+    const STB_TranslateInputArgs* pInputArgs,
+    TB_DATA_FORMAT inputDataFormat,
+    const IGC::CPlatform& platform,
+    float profilingTimerResolution)
+{
+    memset(m_key, 0, sizeof(m_key));
+
+    // Dumps, overrides and instrumentation are side effects that a cache hit
+    // would silently drop, so those compiles always go through the compiler.
+    // Tracing options are opaque to the translation block (their element
+    // layout is not part of the interface), so they cannot be keyed either.
+    if (IGC_IS_FLAG_ENABLED(ShaderDumpEnable) ||
+        IGC_IS_FLAG_ENABLED(ShaderOverride) ||
+        pInputArgs->GTPinInput != nullptr ||
+        (pInputArgs->pTracingOptions != nullptr && pInputArgs->TracingOptionsCount != 0) ||
+        pInputArgs->CompileTimeStatisticsEnable ||
+        GTPIN_IGC_OCL_IsEnabled())
+    {
+        return;
+    }
+
+    m_cacheDir = getCacheDir();
+    if (m_cacheDir.empty())
+    {
+        return;
+    }
+
+    MD5 hash;
+    hashValue(hash, CACHE_FORMAT_VERSION);
+    hashValue(hash, TC::STB_VERSION);
+#ifdef TB_BUILD_ID
+    hashValue(hash, (uint32_t)TB_BUILD_ID);
+#else
+    // Without a CI build id, tell builds apart by the time this file was built.
+    hash.update(StringRef(__DATE__ " " __TIME__));
+#endif
+    hashValue(hash, inputDataFormat);
+    hashValue(hash, profilingTimerResolution);
+    hashBuffer(hash, pInputArgs->pInput, pInputArgs->InputSize);
+    hashBuffer(hash, pInputArgs->pOptions, pInputArgs->OptionsSize);
+    hashBuffer(hash, pInputArgs->pInternalOptions, pInputArgs->InternalOptionsSize);
+    hashValue(hash, platform.getPlatformInfo());
+    hashValue(hash, platform.getSkuTable());
+    hashValue(hash, platform.getWATable());
+    hashValue(hash, platform.GetGTSystemInfo());
+
+#if defined(IGC_DEBUG_VARIABLES)
+    // Regkeys are only variable on builds that have IGC_DEBUG_VARIABLES.
+    SRegKeyVariableMetaData* pRegKeyVariable = (SRegKeyVariableMetaData*)&IGC_REGKEY_LIST;
+    unsigned NUM_REGKEY_ENTRIES = sizeof(SRegKeysList) / sizeof(SRegKeyVariableMetaData);
+    for (unsigned i = 0; i < NUM_REGKEY_ENTRIES; i++)
+    {
+        hash.update(StringRef(pRegKeyVariable[i].GetName()));
+        hashBuffer(hash, pRegKeyVariable[i].m_string, sizeof(debugString));
+        for (const HashRange& range : pRegKeyVariable[i].hashes)
+        {
+            hashValue(hash, range.start);
+            hashValue(hash, range.end);
+        }
+    }
+#endif
+
+    MD5::MD5Result result;
+    hash.final(result);
+    memcpy_s(m_key, sizeof(m_key), result.Bytes.data(), sizeof(m_key));
+
+    SmallString<256> entryPath(m_cacheDir);
+    sys::path::append(entryPath, std::string(CACHE_ENTRY_PREFIX) + result.digest().str().str());
+    m_entryPath = entryPath.str();
+}
+
+bool BinaryCacheOCL::load(STB_TranslateOutputArgs* pOutputArgs) const
+{
+    if (!isEnabled())
+    {
+        return false;
+    }
+
+    ErrorOr<std::unique_ptr<MemoryBuffer>> bufferOrErr = MemoryBuffer::getFile(m_entryPath);
+    if (!bufferOrErr)
+    {
+        return false;
+    }
+
+    const MemoryBuffer& buffer = **bufferOrErr;
+    if (buffer.getBufferSize() < sizeof(CacheEntryHeader))
+    {
+        return false;
+    }
+
+    CacheEntryHeader header;
+    memcpy_s(&header, sizeof(header), buffer.getBufferStart(), sizeof(header));
+    if (memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header.version != CACHE_FORMAT_VERSION ||
+        memcmp(header.key, m_key, sizeof(m_key)) != 0 ||
+        header.outputSize == 0 ||
+        buffer.getBufferSize() !=
+            sizeof(CacheEntryHeader) + (size_t)header.outputSize + header.debugDataSize +
+            header.errorStringSize)
+    {
+        return false;
+    }
+
+    const char* pData = buffer.getBufferStart() + sizeof(CacheEntryHeader);
+    char* pOutput = new char[header.outputSize];
+    memcpy_s(pOutput, header.outputSize, pData, header.outputSize);
+    pOutputArgs->pOutput = pOutput;
+    pOutputArgs->OutputSize = header.outputSize;
+
+    if (header.debugDataSize > 0)
+    {
+        char* pDebugData = new char[header.debugDataSize];
+        memcpy_s(pDebugData, header.debugDataSize, pData + header.outputSize, header.debugDataSize);
+        pOutputArgs->pDebugData = pDebugData;
+        pOutputArgs->DebugDataSize = header.debugDataSize;
+    }
+
+    // The build log of the original compile, e.g. warnings.
+    if (header.errorStringSize > 0)
+    {
+        char* pErrorString = new char[header.errorStringSize];
+        memcpy_s(pErrorString, header.errorStringSize,
+            pData + header.outputSize + header.debugDataSize, header.errorStringSize);
+        pErrorString[header.errorStringSize - 1] = '\0';
+        pOutputArgs->pErrorString = pErrorString;
+        pOutputArgs->ErrorStringSize = header.errorStringSize;
+    }
+
+    // Refresh the timestamps so that pruning evicts in LRU order.
+    int fd = -1;
+    if (!sys::fs::openFileForRead(m_entryPath, fd))
+    {
+        sys::fs::setLastModificationAndAccessTime(fd, std::chrono::system_clock::now());
+        sys::Process::SafelyCloseFileDescriptor(fd);
+    }
+    return true;
+}
+
+void BinaryCacheOCL::store(const STB_TranslateOutputArgs* pOutputArgs) const
+{
+    if (!isEnabled() || pOutputArgs->pOutput == nullptr || pOutputArgs->OutputSize == 0)
+    {
+        return;
+    }
+
+    if (sys::fs::create_directories(m_cacheDir))
+    {
+        return;
+    }
+
+    CacheEntryHeader header;
+    memcpy_s(header.magic, sizeof(header.magic), CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_FORMAT_VERSION;
+    memcpy_s(header.key, sizeof(header.key), m_key, sizeof(m_key));
+    header.outputSize = pOutputArgs->OutputSize;
+    header.debugDataSize = pOutputArgs->pDebugData ? pOutputArgs->DebugDataSize : 0;
+    header.errorStringSize = pOutputArgs->pErrorString ? pOutputArgs->ErrorStringSize : 0;
+
+    // Write to a private file first: other processes must never observe a
+    // partially written entry, and rename is atomic within a directory.
+    int fd = -1;
+    SmallString<256> tempPath;
+    if (sys::fs::createUniqueFile(m_entryPath + ".tmp-%%%%%%%%", fd, tempPath))
+    {
+        return;
+    }
+
+    bool writeFailed = false;
+    {
+        raw_fd_ostream os(fd, /*shouldClose=*/true);
+        os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        os.write(pOutputArgs->pOutput, pOutputArgs->OutputSize);
+        if (header.debugDataSize > 0)
+        {
+            os.write(pOutputArgs->pDebugData, header.debugDataSize);
+        }
+        if (header.errorStringSize > 0)
+        {
+            os.write(pOutputArgs->pErrorString, header.errorStringSize);
+        }
+        os.close();
+        writeFailed = os.has_error();
+        os.clear_error();
+    }
+
+    if (writeFailed || sys::fs::rename(tempPath, m_entryPath))
+    {
+        sys::fs::remove(tempPath);
+        return;
+    }
+
+    CachePruningPolicy policy;
+    policy.Interval = std::chrono::seconds(0);
+    policy.MaxSizeBytes = (uint64_t)IGC_GET_FLAG_VALUE(OCLBinaryCacheMaxSizeMB) * 1024 * 1024;
+    pruneCache(m_cacheDir, policy);
+}
+
+} // namespace TC
@@ -0,0 +1,66 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#pragma once
+#include "AdaptorOCL/OCL/TB/igc_tb.h"
+#include "Compiler/CISACodeGen/Platform.hpp"
+
+#include <string>
+
+namespace TC
+{
+    /// Persistent on-disk cache of TranslateBuild results.
+    ///
+    /// The key covers everything that can change the produced binary: the
+    /// input, the build options, the platform description (PLATFORM, SKU, WA
+    /// table and GT system info), the IGC build and, on builds where they can
+    /// be changed, the IGC regkeys. Entries are written to a unique temporary
+    /// file and renamed into place, so concurrent processes only ever observe
+    /// complete entries. The directory is pruned in LRU order once it grows
+    /// above OCLBinaryCacheMaxSizeMB.
+    class BinaryCacheOCL
+    {
+    public:
+        BinaryCacheOCL(
+            const STB_TranslateInputArgs* pInputArgs,
+            TB_DATA_FORMAT inputDataFormat,
+            const IGC::CPlatform& platform,
+            float profilingTimerResolution);
+
+        /// false if the cache is disabled or the compile can't be cached
+        bool isEnabled() const { return !m_entryPath.empty(); }
+
+        /// On a hit, fill pOutputArgs with the cached binary and debug data.
+        bool load(STB_TranslateOutputArgs* pOutputArgs) const;
+
+        /// Store the final binary and debug data of a successful build.
+        void store(const STB_TranslateOutputArgs* pOutputArgs) const;
+
+    private:
+        std::string m_cacheDir;
+        std::string m_entryPath;
+        uint8_t m_key[16];
+    };
+}
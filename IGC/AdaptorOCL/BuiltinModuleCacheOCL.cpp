@@ -0,0 +1,105 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#include "AdaptorOCL/BuiltinModuleCacheOCL.hpp"
+#include "AdaptorOCL/OCL/LoadBuffer.h"
+
+using namespace llvm;
+
+namespace TC
+{
+
+BuiltinModuleCacheOCL& BuiltinModuleCacheOCL::get()
+{
+    static BuiltinModuleCacheOCL cache;
+    return cache;
+}
+
+Expected<BitcodeModule> BuiltinModuleCacheOCL::getBitcodeModule(const char* pResName)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Entry& entry = m_entries[pResName];
+    if (entry.BCModule.hasValue())
+    {
+        return *entry.BCModule;
+    }
+
+    if (!entry.Buffer)
+    {
+        entry.Buffer.reset(LoadBufferFromResource(pResName, "BC"));
+        if (!entry.Buffer)
+        {
+            return make_error<StringError>(
+                "Error loading builtin resource", inconvertibleErrorCode());
+        }
+    }
+
+    Expected<std::vector<BitcodeModule>> BCModulesOrErr =
+        getBitcodeModuleList(entry.Buffer->getMemBufferRef());
+    if (!BCModulesOrErr)
+    {
+        return BCModulesOrErr.takeError();
+    }
+    if (BCModulesOrErr->size() != 1)
+    {
+        return make_error<StringError>(
+            "Expected a single module in builtin resource", inconvertibleErrorCode());
+    }
+    entry.BCModule = BCModulesOrErr->front();
+    return *entry.BCModule;
+}
+
+const IGC::BiFCallGraphSummary* BuiltinModuleCacheOCL::getCallGraphSummary(const char* pResName)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Entry& entry = m_entries[pResName];
+    if (!entry.CallGraphLoaded)
+    {
+        entry.CallGraphLoaded = true;
+        entry.CallGraphBuffer.reset(LoadBufferFromResource(pResName, "CG"));
+        if (entry.CallGraphBuffer)
+        {
+            entry.CallGraph.parse(entry.CallGraphBuffer->getBuffer());
+        }
+    }
+    return entry.CallGraph.empty() ? nullptr : &entry.CallGraph;
+}
+
+Expected<std::unique_ptr<Module>> BuiltinModuleCacheOCL::getLazyModule(
+    const char* pResName, LLVMContext& Context)
+{
+    Expected<BitcodeModule> BCModuleOrErr = getBitcodeModule(pResName);
+    if (!BCModuleOrErr)
+    {
+        return BCModuleOrErr.takeError();
+    }
+    // BitcodeModule only points into the cached buffer and reading from it
+    // never modifies it, so concurrent compiles can do this without the lock.
+    return BCModuleOrErr->getLazyModule(Context, /*ShouldLazyLoadMetadata=*/true, /*IsImporting=*/false);
+}
+
+}
@@ -0,0 +1,88 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#pragma once
+
+#include "Compiler/Optimizer/BiFCallGraphSummary.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/Optional.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace TC
+{
+    /// Process-wide cache of the builtin (BiF) bitcode libraries.
+    ///
+    /// An llvm::Module can't be shared between LLVMContexts, so we keep what
+    /// can be: the resource buffer and its parsed bitcode index. Every compile
+    /// then only creates a lazy module on top of the shared buffer. Metadata
+    /// is loaded lazily as well, so only the functions BIImport reaches from
+    /// the kernel (and the metadata they reference) ever get materialized.
+    /// Entries are never evicted; the buffers live until the library unloads.
+    class BuiltinModuleCacheOCL
+    {
+    public:
+        static BuiltinModuleCacheOCL& get();
+
+        /// Returns a new lazily loaded module for resource pResName, owned by
+        /// Context. The module references the cached buffer, so the caller
+        /// doesn't need to keep any buffer alive.
+        llvm::Expected<std::unique_ptr<llvm::Module>> getLazyModule(
+            const char* pResName, llvm::LLVMContext& Context);
+
+        /// Returns the call graph summary embedded next to resource pResName,
+        /// or nullptr if the library doesn't carry one.
+        const IGC::BiFCallGraphSummary* getCallGraphSummary(const char* pResName);
+
+    private:
+        struct Entry
+        {
+            std::unique_ptr<llvm::MemoryBuffer> Buffer;
+            llvm::Optional<llvm::BitcodeModule> BCModule;
+            std::unique_ptr<llvm::MemoryBuffer> CallGraphBuffer;
+            IGC::BiFCallGraphSummary CallGraph;
+            bool CallGraphLoaded = false;
+        };
+
+        BuiltinModuleCacheOCL() = default;
+        BuiltinModuleCacheOCL(const BuiltinModuleCacheOCL&) = delete;
+        BuiltinModuleCacheOCL& operator=(const BuiltinModuleCacheOCL&) = delete;
+
+        llvm::Expected<llvm::BitcodeModule> getBitcodeModule(const char* pResName);
+
+        std::mutex m_mutex;
+        std::map<std::string, Entry> m_entries;
+    };
+}
@@ -186,6 +186,54 @@ E_RETVAL CElfWriter::AddSection(
     return retVal;
 }
 
+/******************************************************************************\
+ Member Function: CElfWriter::ReserveSection
+\******************************************************************************/
+E_RETVAL CElfWriter::ReserveSection(
+    SSectionNode* pSectionNode,
+    unsigned int& sectionIndex )
+{
+    if( !pSectionNode )
+    {
+        return FAILURE;
+    }
+
+    SSectionNode* pNode = new SSectionNode();
+    if( !pNode )
+    {
+        return OUT_OF_MEMORY;
+    }
+
+    pNode->Flags    = pSectionNode->Flags;
+    pNode->Type     = pSectionNode->Type;
+    pNode->Name     = pSectionNode->Name;
+    pNode->DataSize = pSectionNode->DataSize;
+
+    m_nodeQueue.push( pNode );
+
+    sectionIndex = m_numSections;
+    m_dataSize += pNode->DataSize;
+    m_stringTableSize += pNode->Name.size() + 1;
+    m_numSections++;
+
+    return SUCCESS;
+}
+
+/******************************************************************************\
+ Member Function: CElfWriter::GetSectionData
+\******************************************************************************/
+char* CElfWriter::GetSectionData(
+    char* const pBinary,
+    unsigned int sectionIndex ) const
+{
+    if( !pBinary || sectionIndex >= m_sectionDataOffsets.size() )
+    {
+        return NULL;
+    }
+
+    return pBinary + m_sectionDataOffsets[sectionIndex];
+}
+
 /******************************************************************************\
  Member Function: CElfWriter::ResolveBinary
 \******************************************************************************/
@@ -224,6 +272,9 @@ E_RETVAL CElfWriter::ResolveBinary(
 
         pCurString = pStringTable;
 
+        m_sectionDataOffsets.clear();
+        m_sectionDataOffsets.reserve( m_numSections );
+
         // Walk through the section nodes
         while( m_nodeQueue.empty() == false )
         {
@@ -243,8 +294,13 @@ E_RETVAL CElfWriter::ResolveBinary(
                 pCurSectionHeader = (SElf64SectionHeader*)( 
                     (unsigned char*)pCurSectionHeader + sizeof( SElf64SectionHeader ) );
 
-                // copy the data, move the data pointer
-                memcpy_s( pData, pNode->DataSize, pNode->pData, pNode->DataSize );
+                // copy the data, move the data pointer; reserved sections
+                // have no data yet and are filled in place by the caller
+                m_sectionDataOffsets.push_back( pData - pBinary );
+                if( pNode->pData )
+                {
+                    memcpy_s( pData, pNode->DataSize, pNode->pData, pNode->DataSize );
+                }
                 pData += pNode->DataSize;
 
                 // copy the name into the string table, move the string pointer
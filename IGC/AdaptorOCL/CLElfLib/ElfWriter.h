@@ -28,6 +28,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "CLElfTypes.h"
 #include <queue>
 #include <string>
+#include <vector>
 
 #if defined(_WIN32) && (__KLOCWORK__ == 0)
   #define ELF_CALL __stdcall
@@ -86,10 +87,24 @@ public:
     E_RETVAL ELF_CALL AddSection(
         SSectionNode* pSectionNode );
 
+    // Adds a section of pSectionNode->DataSize bytes without copying any
+    // data; pSectionNode->pData is ignored. Once the binary is resolved the
+    // caller writes the contents in place through GetSectionData(), so large
+    // sections are only ever copied into the final buffer.
+    E_RETVAL ELF_CALL ReserveSection(
+        SSectionNode* pSectionNode,
+        unsigned int& sectionIndex );
+
     E_RETVAL ELF_CALL ResolveBinary( 
         char* const pBinary,
         size_t& dataSize );
 
+    // Returns where the data of the given section lives in a binary produced
+    // by ResolveBinary, or NULL for an unknown section.
+    char* ELF_CALL GetSectionData(
+        char* const pBinary,
+        unsigned int sectionIndex ) const;
+
     E_RETVAL ELF_CALL Initialize();
     E_RETVAL ELF_CALL PatchElfHeader( char* const pBinary );
 
@@ -106,6 +121,7 @@ protected:
     Elf64_Xword m_flags;
 
     std::queue<SSectionNode*> m_nodeQueue;
+    std::vector<size_t> m_sectionDataOffsets;
 
     unsigned int m_dataSize;
     unsigned int m_numSections;
@@ -296,6 +296,8 @@ struct ExecutionEnivronment
     DWORD  NumGRFRequired;
 	DWORD  WorkgroupWalkOrder[3] = { 3, 3, 3 };
     bool   HasGlobalAtomics                           = false;
+    DWORD  WalkOrderHint                              = 0;
+    DWORD  WorkGroupCombineFactor                     = 1;
 };
 
 struct KernelTypeProgramBinaryInfo
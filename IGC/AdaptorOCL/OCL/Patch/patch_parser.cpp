@@ -523,6 +523,10 @@ void DebugPatchList(
                         ICBE_DPF_STR(output, GFXDBG_HARDWARE,
                             "\tType = BUFFER_STATEFUL\n");
                         break;
+                    case iOpenCL::DATA_PARAMETER_PRECOMPUTED_VALUE:
+                        ICBE_DPF_STR(output, GFXDBG_HARDWARE,
+                            "\tType = PRECOMPUTED_VALUE\n");
+                        break;
                     default:
                         ICBE_DPF_STR( output, GFXDBG_HARDWARE,
                             "\tType = UNKNOWN_TYPE\n" );
@@ -864,6 +868,12 @@ void DebugPatchList(
                 ICBE_DPF_STR( output, GFXDBG_HARDWARE,
                     "\tHasGlobalAtomics = %s\n",
                     pPatchItem->HasGlobalAtomics ? "true" : "false");
+                ICBE_DPF_STR( output, GFXDBG_HARDWARE,
+                    "\tWalkOrderHint = %x\n",
+                    pPatchItem->WalkOrderHint );
+                ICBE_DPF_STR( output, GFXDBG_HARDWARE,
+                    "\tWorkGroupCombineFactor = %d\n",
+                    pPatchItem->WorkGroupCombineFactor );
             }
             break;
 
@@ -1438,6 +1448,69 @@ void DebugPatchList(
         }
         break;
 
+        case iOpenCL::PATCH_TOKEN_PRECOMPUTED_ARGS_PROGRAM:
+        {
+            const iOpenCL::SPatchPrecomputedArgsProgram* pPatchItem =
+                (const iOpenCL::SPatchPrecomputedArgsProgram*)pHeader;
+
+            ICBE_DPF_STR(output, GFXDBG_HARDWARE,
+                "PATCH_TOKEN_PRECOMPUTED_ARGS_PROGRAM (%08X) (size = %d)\n",
+                pPatchItem->Token,
+                pPatchItem->Size);
+
+            ICBE_DPF_STR(output, GFXDBG_HARDWARE,
+                "\tNumValues = %d\n",
+                pPatchItem->NumValues);
+            ICBE_DPF_STR(output, GFXDBG_HARDWARE,
+                "\tProgramSize = %d\n",
+                pPatchItem->ProgramSize);
+        }
+        break;
+
+        case iOpenCL::PATCH_TOKEN_INTERESTING_ARGUMENT:
+        {
+            const iOpenCL::SPatchInterestingArgument* pPatchItem =
+                (const iOpenCL::SPatchInterestingArgument*)pHeader;
+
+            ICBE_DPF_STR(output, GFXDBG_HARDWARE,
+                "PATCH_TOKEN_INTERESTING_ARGUMENT (%08X) (size = %d)\n",
+                pPatchItem->Token,
+                pPatchItem->Size);
+
+            ICBE_DPF_STR(output, GFXDBG_HARDWARE,
+                "\tArgumentNumber = %d\n",
+                pPatchItem->ArgumentNumber);
+            ICBE_DPF_STR(output, GFXDBG_HARDWARE,
+                "\tDataSize = %d\n",
+                pPatchItem->DataSize);
+            ICBE_DPF_STR(output, GFXDBG_HARDWARE,
+                "\tAnyValue = %d\n",
+                pPatchItem->AnyValue);
+            ICBE_DPF_STR(output, GFXDBG_HARDWARE,
+                "\tValue = %08X\n",
+                pPatchItem->Value);
+        }
+        break;
+
+        case iOpenCL::PATCH_TOKEN_SPECIALIZED_ARGUMENT:
+        {
+            const iOpenCL::SPatchSpecializedArgument* pPatchItem =
+                (const iOpenCL::SPatchSpecializedArgument*)pHeader;
+
+            ICBE_DPF_STR(output, GFXDBG_HARDWARE,
+                "PATCH_TOKEN_SPECIALIZED_ARGUMENT (%08X) (size = %d)\n",
+                pPatchItem->Token,
+                pPatchItem->Size);
+
+            ICBE_DPF_STR(output, GFXDBG_HARDWARE,
+                "\tArgumentNumber = %d\n",
+                pPatchItem->ArgumentNumber);
+            ICBE_DPF_STR(output, GFXDBG_HARDWARE,
+                "\tValue = %08X\n",
+                pPatchItem->Value);
+        }
+        break;
+
         default:
             {
                 ICBE_ASSERT( 0 );
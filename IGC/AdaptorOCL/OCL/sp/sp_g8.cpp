@@ -1969,6 +1969,10 @@ RETVAL CGen8OpenCLStateProcessor::CreatePatchList(
 
         patch.HasGlobalAtomics = annotations.m_executionEnivronment.HasGlobalAtomics;
 
+        patch.WalkOrderHint = annotations.m_executionEnivronment.WalkOrderHint;
+
+        patch.WorkGroupCombineFactor = annotations.m_executionEnivronment.WorkGroupCombineFactor;
+
 
 
         retValue = AddPatchItem(
@@ -2098,6 +2102,79 @@ RETVAL CGen8OpenCLStateProcessor::CreatePatchList(
         }
     }
 
+    // Patch for the host-evaluated argument-only uniform values
+    if (retValue.Success && !annotations.m_precomputedArgsProgram.empty())
+    {
+        iOpenCL::SPatchPrecomputedArgsProgram patch;
+        memset(&patch, 0, sizeof(patch));
+
+        const uint32_t programSize = (uint32_t)annotations.m_precomputedArgsProgram.size();
+        const uint32_t alignedProgramSize = iSTD::Align(programSize, sizeof(DWORD));
+
+        patch.Token = iOpenCL::PATCH_TOKEN_PRECOMPUTED_ARGS_PROGRAM;
+        patch.Size = sizeof(patch) + alignedProgramSize;
+        patch.NumValues = annotations.m_numPrecomputedArgs;
+        patch.ProgramSize = programSize;
+
+        retValue = AddPatchItem(patch, membuf);
+
+        if (retValue.Success &&
+            !membuf.Write(annotations.m_precomputedArgsProgram.data(), programSize))
+        {
+            retValue.Success = false;
+            return retValue;
+        }
+
+        for (uint32_t i = programSize; retValue.Success && i < alignedProgramSize; i++)
+        {
+            if (!membuf.Write('\0'))
+            {
+                retValue.Success = false;
+                return retValue;
+            }
+        }
+    }
+
+    // Patch for the args worth specializing the kernel for
+    for (const auto& interesting : annotations.m_interestingArgs)
+    {
+        if (!retValue.Success)
+        {
+            break;
+        }
+
+        iOpenCL::SPatchInterestingArgument patch;
+        memset(&patch, 0, sizeof(patch));
+
+        patch.Token = iOpenCL::PATCH_TOKEN_INTERESTING_ARGUMENT;
+        patch.Size = sizeof(patch);
+        patch.ArgumentNumber = interesting.ArgumentNumber;
+        patch.DataSize = interesting.Size;
+        patch.AnyValue = interesting.AnyValue;
+        patch.Value = interesting.Value;
+
+        retValue = AddPatchItem(patch, membuf);
+    }
+
+    // Patch for the args folded in this variant of the kernel
+    for (const auto& specialized : annotations.m_specializedArgs)
+    {
+        if (!retValue.Success)
+        {
+            break;
+        }
+
+        iOpenCL::SPatchSpecializedArgument patch;
+        memset(&patch, 0, sizeof(patch));
+
+        patch.Token = iOpenCL::PATCH_TOKEN_SPECIALIZED_ARGUMENT;
+        patch.Size = sizeof(patch);
+        patch.ArgumentNumber = specialized.first;
+        patch.Value = specialized.second;
+
+        retValue = AddPatchItem(patch, membuf);
+    }
+
     return retValue;
 }
 
@@ -30,12 +30,34 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "program_debug_data.h"
 #include "../../../common/Types.hpp"
 #include "../../../Compiler/CISACodeGen/OpenCLKernelCodeGen.hpp"
+#include "../../../Compiler/CISACodeGen/KernelBinaryCache.hpp"
 
 namespace iOpenCL
 {
 
 extern RETVAL g_cInitRetValue;
 
+// Static metrics of the binary of kernelInfo, reported by GetLastKernelMetrics.
+static TC::STB_KernelMetrics GetKernelMetrics(const IGC::SOpenCLKernelInfo& kernelInfo)
+{
+    uint32_t simdSize = kernelInfo.m_executionEnivronment.CompiledSIMDSize;
+    const IGC::SProgramOutput& output =
+        simdSize == 32 ? kernelInfo.m_kernelProgram.simd32 :
+        simdSize == 16 ? kernelInfo.m_kernelProgram.simd16 :
+                         kernelInfo.m_kernelProgram.simd8;
+
+    TC::STB_KernelMetrics metrics = {};
+    metrics.SIMDSize = simdSize;
+    metrics.InstructionCount = output.m_InstructionCount;
+    metrics.SamplerSends = output.m_numSamplerSends;
+    metrics.DataPortSends = output.m_numDataPortSends;
+    metrics.OtherSends = output.m_numOtherSends;
+    metrics.SpillBytes = output.m_scratchSpaceUsedBySpills;
+    metrics.GRFUsed = output.m_numGRFUsed;
+    metrics.EstimatedCycles = output.m_numEstimatedCycles;
+    return metrics;
+}
+
 CGen8OpenCLProgram::CGen8OpenCLProgram(PLATFORM platform, IGC::OpenCLProgramContext &context) :
     m_StateProcessor( platform, context ),
     m_Platform( platform ),
@@ -192,6 +214,8 @@ void CGen8OpenCLProgram::CreateKernelBinaries()
                 kernelVec.push_back(simd8Shader);
         }
 
+        std::vector<std::string> cacheBinaries;
+        std::vector<TC::STB_KernelMetrics> cacheMetrics;
         for (auto kernel : kernelVec)
         {
             IGC::SProgramOutput* pOutput = kernel->ProgramOutput();
@@ -200,6 +224,8 @@ void CGen8OpenCLProgram::CreateKernelBinaries()
             KernelData data;
             data.pKernelInfo = &(kernel->m_kernelInfo);
             data.kernelBinary = new Util::BinaryStream();
+            data.kernelName = kernel->m_kernelInfo.m_kernelName;
+            data.metrics = GetKernelMetrics(kernel->m_kernelInfo);
 
             m_StateProcessor.CreateKernelBinary(
                 (const char*)pOutput->m_programBin,
@@ -228,6 +254,69 @@ void CGen8OpenCLProgram::CreateKernelBinaries()
             }
 
             m_KernelBinaries.push_back(data);
+            cacheBinaries.emplace_back(
+                (const char*)data.kernelBinary->GetLinearPointer(), (size_t)data.kernelBinary->Size());
+            cacheMetrics.push_back(data.metrics);
+
+            // Duplicates reuse the code of this kernel under their own name.
+            for (const auto& duplicate : m_pContext->m_duplicateKernels)
+            {
+                if (duplicate.second != kernel->m_kernelInfo.m_kernelName)
+                {
+                    continue;
+                }
+
+                m_DuplicateKernelInfos.emplace_back(new IGC::SOpenCLKernelInfo(kernel->m_kernelInfo));
+                IGC::SOpenCLKernelInfo& duplicateInfo = *m_DuplicateKernelInfos.back();
+                duplicateInfo.m_kernelName = duplicate.first;
+
+                KernelData duplicateData;
+                duplicateData.pKernelInfo = &duplicateInfo;
+                duplicateData.kernelBinary = new Util::BinaryStream();
+                duplicateData.kernelName = duplicate.first;
+                duplicateData.metrics = data.metrics;
+
+                m_StateProcessor.CreateKernelBinary(
+                    (const char*)pOutput->m_programBin,
+                    pOutput->m_programSize,
+                    duplicateInfo,
+                    m_pContext->m_programInfo,
+                    m_pContext->btiLayout,
+                    *(duplicateData.kernelBinary),
+                    m_pSystemThreadKernelOutput,
+                    pOutput->m_unpaddedProgramSize);
+
+                m_KernelBinaries.push_back(duplicateData);
+            }
+        }
+
+        if (!kernelVec.empty())
+        {
+            auto key = m_pContext->m_kernelBinaryCacheKeys.find(kernelVec.front()->m_kernelInfo.m_kernelName);
+            if (key != m_pContext->m_kernelBinaryCacheKeys.end())
+            {
+                IGC::KernelBinaryCache::Store(key->second, cacheBinaries, cacheMetrics);
+            }
+        }
+    }
+
+    // Kernels found in the kernel binary cache only have their binaries and
+    // the metrics of those.
+    for (const auto& cached : m_pContext->m_cachedKernelBinaries)
+    {
+        const std::vector<TC::STB_KernelMetrics>& metrics =
+            m_pContext->m_cachedKernelMetrics[cached.first];
+        for (size_t i = 0; i < cached.second.size(); i++)
+        {
+            KernelData data;
+            data.kernelBinary = new Util::BinaryStream();
+            data.kernelBinary->Write(cached.second[i].data(), cached.second[i].size());
+            data.kernelName = cached.first;
+            if (i < metrics.size())
+            {
+                data.metrics = metrics[i];
+            }
+            m_KernelBinaries.push_back(data);
         }
     }
 }
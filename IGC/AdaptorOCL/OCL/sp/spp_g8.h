@@ -27,9 +27,13 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 
 #include "../util/BinaryStream.h"
+#include "../../TranslationBlock.h"
 #include "usc.h"
 #include "sp_g8.h"
 
+#include <memory>
+#include <string>
+
 namespace IGC
 {
     class OpenCLProgramContext;
@@ -41,9 +45,14 @@ namespace iOpenCL
 
 struct KernelData
 {
+    // null for binaries taken from the kernel binary cache
     const IGC::SOpenCLKernelInfo* pKernelInfo = nullptr;
     Util::BinaryStream* kernelBinary = nullptr;
     Util::BinaryStream* kernelDebugData = nullptr;
+    // Set for all binaries, cached ones included. pKernelName of metrics is
+    // left null.
+    std::string kernelName;
+    TC::STB_KernelMetrics metrics = {};
 };
 
 class CGen8OpenCLProgram : DisallowCopy
@@ -70,6 +79,10 @@ public:
     // Used to store per-kernel binary streams and kernelInfo
     std::vector<KernelData> m_KernelBinaries;
 
+    // Kernel info of the kernels in m_pContext->m_duplicateKernels. These
+    // are shallow copies: the annotations belong to the original kernel.
+    std::vector<std::unique_ptr<IGC::SOpenCLKernelInfo>> m_DuplicateKernelInfos;
+
 private:
     CGen8OpenCLStateProcessor m_StateProcessor;
     Util::BinaryStream* m_ProgramScopePatchStream;
@@ -841,6 +841,16 @@ Function *getOrCreateFunction(Module *M, Type *RetTy,
 	IGCLLVM::AttributeSet *Attrs = nullptr, bool takeName = true);
 std::vector<Value *> getArguments(CallInst* CI);
 
+/// While alive, memoizes the per-type part of builtin name mangling for the
+/// current thread. Only one translation per thread owns the cache.
+class ScopedMangleCache {
+public:
+  ScopedMangleCache();
+  ~ScopedMangleCache();
+private:
+  bool Owner = false;
+};
+
 void decorateSPIRVBuiltin(std::string &S);
 void decorateSPIRVBuiltin(std::string &S, std::vector<Type*> ArgTypes);
 void decorateSPIRVExtInst(std::string &S, std::vector<Type*> ArgTypes);
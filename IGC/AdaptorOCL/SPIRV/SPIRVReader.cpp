@@ -3183,7 +3183,7 @@ SPIRVToLLVM::transSPIRVBuiltinFromInst(SPIRVInstruction *BI, BasicBlock *BB) {
       ArgTys.insert(ArgTys.begin(), RetTy);
   }
 
-  std::string builtinName(getSPIRVBuiltinName(OC, BI, ArgTys, suffix));
+  std::string builtinName;
 
   // Fix mangling of VME builtins.
   if (isIntelVMEOpCode(OC)) {
@@ -3200,6 +3200,9 @@ SPIRVToLLVM::transSPIRVBuiltinFromInst(SPIRVInstruction *BI, BasicBlock *BB) {
     }
     builtinName = getSPIRVBuiltinName(OC, BI, ArgTysWithVME_WA, suffix);
   }
+  else {
+    builtinName = getSPIRVBuiltinName(OC, BI, ArgTys, suffix);
+  }
 
   if (hasReturnTypeInTypeList)
   {
@@ -3249,6 +3252,8 @@ Type* SPIRVToLLVM::getNamedBarrierType()
 
 bool
 SPIRVToLLVM::translate() {
+  ScopedMangleCache MangleCache;
+
   if (!transAddressingModel())
     return false;
 
@@ -3843,4 +3848,11 @@ bool ReadSPIRV(LLVMContext &C, std::istream &IS, Module *&M,
   return Succeed;
 }
 
+bool ReadSPIRV(LLVMContext &C, const char *pData, size_t size, Module *&M,
+    StringRef options,
+    std::string &ErrMsg) {
+  SPIRVInputStream IS(pData, size);
+  return ReadSPIRV(C, IS, M, options, ErrMsg);
+}
+
 }
@@ -78,6 +78,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "SPIRVInternal.h"
 #include "Mangler/ParameterType.h"
 
+#include <unordered_map>
+
 namespace spv{
 
 void
@@ -201,14 +203,50 @@ std::string recursive_mangle(const Type* pType)
 }
 
 
+// Mangled names of the types seen by the current translation, see
+// ScopedMangleCache. Types are uniqued per LLVMContext, so the cache is only
+// enabled while a module is being translated on this thread.
+static thread_local std::unordered_map<const Type*, std::string>* MangledTypes = nullptr;
+
+ScopedMangleCache::ScopedMangleCache()
+{
+    if (!MangledTypes)
+    {
+        MangledTypes = new std::unordered_map<const Type*, std::string>();
+        Owner = true;
+    }
+}
+
+ScopedMangleCache::~ScopedMangleCache()
+{
+    if (Owner)
+    {
+        delete MangledTypes;
+        MangledTypes = nullptr;
+    }
+}
+
 std::string Mangler(const std::string &FuncName, const std::vector<Type*> &ArgTypes)
 {
-    std::string str_type;
+    std::string str_type = FuncName;
     for (auto U : ArgTypes)
     {
-        str_type += "_" + recursive_mangle(U);
+        str_type += "_";
+        if (MangledTypes)
+        {
+            auto It = MangledTypes->find(U);
+            if (It == MangledTypes->end())
+            {
+                It = MangledTypes->emplace(U, recursive_mangle(U)).first;
+            }
+            str_type += It->second;
+        }
+        else
+        {
+            str_type += recursive_mangle(U);
+        }
     }
-    return FuncName + str_type;
+    return str_type;
 }
 
 void
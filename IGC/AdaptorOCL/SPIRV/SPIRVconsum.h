@@ -47,5 +47,9 @@ bool ReadSPIRV(llvm::LLVMContext &C, std::istream &IS, llvm::Module *&M,
     llvm::StringRef options,
     std::string &ErrMsg);
 
+// Same as above, but decodes the size bytes at pData in place.
+bool ReadSPIRV(llvm::LLVMContext &C, const char *pData, size_t size,
+    llvm::Module *&M, llvm::StringRef options, std::string &ErrMsg);
+
 }
 #endif
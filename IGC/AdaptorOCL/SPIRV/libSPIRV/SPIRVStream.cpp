@@ -68,15 +68,44 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "SPIRVInstruction.h"
 #include "SPIRVDebugInfoExt.h"
 
+#include <cstring>
+
 namespace spv{
 
+SPIRVInputBuffer::pos_type
+SPIRVInputBuffer::seekoff(off_type Off, std::ios_base::seekdir Dir,
+                          std::ios_base::openmode Which) {
+  char *Base = (Dir == std::ios_base::beg) ? eback() :
+               (Dir == std::ios_base::cur) ? gptr() : egptr();
+  char *Pos = Base + Off;
+  if (!(Which & std::ios_base::in) || Pos < eback() || Pos > egptr())
+    return pos_type(off_type(-1));
+  setg(eback(), Pos, egptr());
+  return pos_type(Pos - eback());
+}
+
+// Slot in std::ios_base::pword() that links an SPIRVInputStream to its
+// buffer, so that decoders can find it without RTTI.
+static const int SPIRVInputBufferIndex = std::ios_base::xalloc();
+
+SPIRVInputStream::SPIRVInputStream(const char *Data, size_t Size)
+  :std::istream(nullptr), Buf(Data, Size) {
+  rdbuf(&Buf);
+  pword(SPIRVInputBufferIndex) = &Buf;
+}
+
+SPIRVInputBuffer *
+SPIRVInputStream::getBuffer(std::istream &IS) {
+  return static_cast<SPIRVInputBuffer*>(IS.pword(SPIRVInputBufferIndex));
+}
+
 SPIRVDecoder::SPIRVDecoder(std::istream &InputStream, SPIRVFunction &F)
-  :IS(InputStream), M(*F.getModule()), WordCount(0), OpCode(OpNop),
-   Scope(&F){}
+  :IS(InputStream), Buf(SPIRVInputStream::getBuffer(InputStream)),
+   M(*F.getModule()), WordCount(0), OpCode(OpNop), Scope(&F){}
 
 SPIRVDecoder::SPIRVDecoder(std::istream &InputStream, SPIRVBasicBlock &BB)
-  :IS(InputStream), M(*BB.getModule()), WordCount(0), OpCode(OpNop),
-   Scope(&BB){}
+  :IS(InputStream), Buf(SPIRVInputStream::getBuffer(InputStream)),
+   M(*BB.getModule()), WordCount(0), OpCode(OpNop), Scope(&BB){}
 
 void
 SPIRVDecoder::setScope(SPIRVEntry *TheScope) {
@@ -85,10 +114,21 @@ SPIRVDecoder::setScope(SPIRVEntry *TheScope) {
   Scope = TheScope;
 }
 
+// Reads Size bytes, straight from the buffer when the whole range is
+// available. Short reads go through the stream so that it sets eof/fail.
+static void readBytes(const SPIRVDecoder& I, void *Dst, size_t Size) {
+  if (I.Buf && I.Buf->available() >= Size) {
+    memcpy(Dst, I.Buf->current(), Size);
+    I.Buf->consume(Size);
+    return;
+  }
+  I.IS.read(reinterpret_cast<char*>(Dst), Size);
+}
+
 template<>
 const SPIRVDecoder& DecodeBinary(const SPIRVDecoder& I, bool &V) {
    SPIRVWord W;
-   I.IS.read(reinterpret_cast<char*>(&W), sizeof(W));
+   readBytes(I, &W, sizeof(W));
    V = (W == 0) ? false : true;
    return I;
 }
@@ -96,7 +136,7 @@ const SPIRVDecoder& DecodeBinary(const SPIRVDecoder& I, bool &V) {
 template<>
 const SPIRVDecoder&
 DecodeBinary(const SPIRVDecoder& I, SPIRVWord &V) {
-   I.IS.read(reinterpret_cast<char*>(&V), sizeof(V));
+   readBytes(I, &V, sizeof(V));
    return I;
 }
 
@@ -151,6 +191,17 @@ SPIRV_DEF_DEC(OCLExtOpDbgKind)
 // words.
 const SPIRVDecoder&
 operator>>(const SPIRVDecoder&I, std::string& Str) {
+  if (I.Buf) {
+    const char *Begin = I.Buf->current();
+    size_t Avail = I.Buf->available();
+    if (const char *Nul = static_cast<const char*>(memchr(Begin, '\0', Avail))) {
+      Str.append(Begin, Nul);
+      size_t Padded = ((Nul - Begin) + 1 + 3) & ~size_t(3);
+      I.Buf->consume(std::min(Padded, Avail));
+      return I;
+    }
+  }
+
   uint64_t Count = 0;
   char Ch;
   while ((!I.IS.eof() && I.IS.get(Ch)) && Ch != '\0') {
@@ -166,6 +217,27 @@ operator>>(const SPIRVDecoder&I, std::string& Str) {
   return I;
 }
 
+// Operand lists are copied in one go.
+const SPIRVDecoder&
+operator>>(const SPIRVDecoder&I, std::vector<SPIRVWord>& V) {
+  if (!V.empty())
+    readBytes(I, V.data(), V.size() * sizeof(SPIRVWord));
+  return I;
+}
+
+// Module-scope debug instructions that nothing downstream of the decoder
+// reads. They are skipped without creating an entry.
+static bool isSkippedOpCode(Op OpCode) {
+  switch (OpCode) {
+  case OpMemberName:
+  case OpSourceContinued:
+  case OpModuleProcessed:
+    return true;
+  default:
+    return false;
+  }
+}
+
 bool
 SPIRVDecoder::getWordCountAndOpCode() {
   if (IS.eof()) {
@@ -192,6 +264,14 @@ SPIRVEntry *
 SPIRVDecoder::getEntry() {
   if (WordCount == 0 || OpCode == OpNop)
     return NULL;
+  if (!Scope && isSkippedOpCode(OpCode)) {
+    size_t Size = (WordCount - 1) * sizeof(SPIRVWord);
+    if (Buf && Buf->available() >= Size)
+      Buf->consume(Size);
+    else
+      IS.ignore(Size);
+    return NULL;
+  }
   SPIRVEntry *Entry = SPIRVEntry::create(OpCode);
   Entry->setModule(&M);
   Entry->setWordCount(WordCount);
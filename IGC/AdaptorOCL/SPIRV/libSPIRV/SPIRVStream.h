@@ -81,11 +81,49 @@ namespace spv{
 class SPIRVFunction;
 class SPIRVBasicBlock;
 
+// Read-only std::streambuf over a SPIR-V binary held in memory. Decoders of
+// an SPIRVInputStream read words, operand lists and string literals straight
+// out of this buffer instead of going through the std::istream interface.
+class SPIRVInputBuffer : public std::streambuf {
+public:
+  SPIRVInputBuffer(const char *Data, size_t Size) {
+    char *Begin = const_cast<char*>(Data);
+    setg(Begin, Begin, Begin + Size);
+  }
+
+  const char *current() const { return gptr(); }
+  size_t available() const { return egptr() - gptr(); }
+  void consume(size_t N) {
+    assert(N <= available());
+    setg(eback(), gptr() + N, egptr());
+  }
+
+protected:
+  pos_type seekoff(off_type Off, std::ios_base::seekdir Dir,
+                   std::ios_base::openmode Which) override;
+  pos_type seekpos(pos_type Pos, std::ios_base::openmode Which) override {
+    return seekoff(off_type(Pos), std::ios_base::beg, Which);
+  }
+};
+
+// std::istream over an in-memory SPIR-V binary; no copy of the input is made.
+class SPIRVInputStream : public std::istream {
+public:
+  SPIRVInputStream(const char *Data, size_t Size);
+
+  // Returns the in-memory buffer behind IS, or NULL if IS is not an
+  // SPIRVInputStream.
+  static SPIRVInputBuffer *getBuffer(std::istream &IS);
+
+private:
+  SPIRVInputBuffer Buf;
+};
+
 class SPIRVDecoder {
 public:
   SPIRVDecoder(std::istream& InputStream, SPIRVModule& Module)
-    :IS(InputStream), M(Module), WordCount(0), OpCode(OpNop),
-     Scope(NULL){}
+    :IS(InputStream), Buf(SPIRVInputStream::getBuffer(InputStream)),
+     M(Module), WordCount(0), OpCode(OpNop), Scope(NULL){}
   SPIRVDecoder(std::istream& InputStream, SPIRVFunction& F);
   SPIRVDecoder(std::istream& InputStream, SPIRVBasicBlock &BB);
 
@@ -95,6 +133,7 @@ public:
   void validate()const;
 
   std::istream &IS;
+  SPIRVInputBuffer *Buf; // Set when IS is an SPIRVInputStream
   SPIRVModule &M;
   SPIRVWord WordCount;
   Op OpCode;
@@ -145,6 +184,7 @@ SPIRV_DEC_DEC(OCLExtOpKind)
 SPIRV_DEC_DEC(OCLExtOpDbgKind)
 
 const SPIRVDecoder& operator>>(const SPIRVDecoder&I, std::string& Str);
+const SPIRVDecoder& operator>>(const SPIRVDecoder&I, std::vector<SPIRVWord>& V);
 
 } // namespace spv
 #endif
@@ -55,12 +55,40 @@ static const uint32_t STB_MAX_ERROR_STRING_SIZE = 1024UL;
 // Forward prototyping
 struct STB_RegisterArgs;
 struct STB_CreateArgs;
+struct STB_KernelMetrics;
 class  CTranslationBlock;
 
 extern "C" TRANSLATION_BLOCK_API void TRANSLATION_BLOCK_CALLING_CONV Register(STB_RegisterArgs* pRegisterArgs);
 extern "C" TRANSLATION_BLOCK_API CTranslationBlock* TRANSLATION_BLOCK_CALLING_CONV Create(STB_CreateArgs* pCreateArgs);
 extern "C" TRANSLATION_BLOCK_API void TRANSLATION_BLOCK_CALLING_CONV Delete(CTranslationBlock* pBlock);
 
+// Copies up to count interval names and times (ns) of the last Translate() on the
+// calling thread; returns the total number of intervals. Either array may be NULL.
+extern "C" TRANSLATION_BLOCK_API uint32_t TRANSLATION_BLOCK_CALLING_CONV GetLastCompileTimes(const char** pNames, uint64_t* pTimesNS, uint32_t count);
+
+// Copies up to count interval names, and the times (ns) and hit counts summed
+// over every Translate() of the process so far (EnableStatsTotals); returns the
+// total number of intervals. Any array may be NULL. Other threads may be compiling.
+extern "C" TRANSLATION_BLOCK_API uint32_t TRANSLATION_BLOCK_CALLING_CONV GetTotalCompileTimes(const char** pNames, uint64_t* pTimesNS, uint64_t* pHits, uint32_t count);
+
+// Same as GetTotalCompileTimes() for the shader quality metrics items.
+extern "C" TRANSLATION_BLOCK_API uint32_t TRANSLATION_BLOCK_CALLING_CONV GetTotalShaderStats(const char** pNames, int64_t* pValues, uint32_t count);
+
+// Copies up to count static code metrics of the kernels produced by the last
+// Translate() on the calling thread; returns the total number of kernels.
+// pMetrics may be NULL. Kernel names stay valid until the next Translate().
+extern "C" TRANSLATION_BLOCK_API uint32_t TRANSLATION_BLOCK_CALLING_CONV GetLastKernelMetrics(STB_KernelMetrics* pMetrics, uint32_t count);
+
+// Returns the ShaderHash of the input of the last Translate() on the calling
+// thread, the key of TuningDatabase entries.
+extern "C" TRANSLATION_BLOCK_API uint64_t TRANSLATION_BLOCK_CALLING_CONV GetLastShaderHash();
+
+// Compiles the following Translate() calls of the calling thread with the
+// regkey settings "Name=Value,Name=Value" (the syntax of Options.txt) in place
+// of the TuningDatabase entry; "" compiles with the plain regkeys and NULL
+// consults the TuningDatabase again. Returns false in builds without regkeys.
+extern "C" TRANSLATION_BLOCK_API bool TRANSLATION_BLOCK_CALLING_CONV SetRegKeyOverrides(const char* pSettings);
+
 #undef TRANSLATION_BLOCK_CALLING_CONV
 
 /******************************************************************************\
@@ -231,6 +259,28 @@ struct STB_TranslateOutputArgs
     }
 };
 
+/******************************************************************************\
+
+Structure:
+    STB_KernelMetrics
+
+Description:
+    Static code metrics of one compiled kernel, returned by GetLastKernelMetrics
+
+\******************************************************************************/
+struct STB_KernelMetrics
+{
+    const char* pKernelName;        // name of the kernel
+    uint32_t    SIMDSize;           // selected dispatch width
+    uint32_t    InstructionCount;   // number of Gen ISA instructions
+    uint32_t    SamplerSends;       // sends to the sampler
+    uint32_t    DataPortSends;      // sends to the data ports, including spill/fill
+    uint32_t    OtherSends;         // sends to all other shared functions
+    uint32_t    SpillBytes;         // scratch space used by spills (bytes)
+    uint32_t    GRFUsed;            // number of allocated GRFs
+    uint32_t    EstimatedCycles;    // static cycle estimate weighted by loop nesting (EnableStaticCycleEstimate), else 0
+};
+
 struct TranslationBlockVersion
 {
     static const uint32_t VersioningIsUnsupported = (uint32_t)-1;
@@ -0,0 +1,177 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#include "AdaptorOCL/UnifiedModuleCacheOCL.hpp"
+#include "common/igc_regkeys.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+#include "llvmWrapper/Bitcode/BitcodeWriter.h"
+#include "common/LLVMWarningsPop.hpp"
+
+#include <map>
+#include <mutex>
+
+using namespace llvm;
+
+namespace TC
+{
+
+namespace
+{
+    struct CacheEntry
+    {
+        std::unique_ptr<MemoryBuffer> Bitcode;
+        uint64_t LastUse = 0;
+    };
+
+    struct CacheStorage
+    {
+        std::mutex Mutex;
+        std::map<std::string, CacheEntry> Entries;
+        uint64_t Clock = 0;
+    };
+
+    CacheStorage& getStorage()
+    {
+        static CacheStorage storage;
+        return storage;
+    }
+
+    void hashBuffer(MD5& hash, const void* pData, uint32_t size)
+    {
+        hash.update(ArrayRef<uint8_t>(reinterpret_cast<const uint8_t*>(&size), sizeof(size)));
+        if (pData && size)
+        {
+            hash.update(ArrayRef<uint8_t>(static_cast<const uint8_t*>(pData), size));
+        }
+    }
+
+    template <typename T>
+    void hashValue(MD5& hash, const T& value)
+    {
+        hashBuffer(hash, &value, sizeof(T));
+    }
+}
+
+UnifiedModuleCacheOCL::UnifiedModuleCacheOCL(
+    const STB_TranslateInputArgs* pInputArgs,
+    TB_DATA_FORMAT inputDataFormat,
+    const IGC::CPlatform& platform)
+{
+    // Only SPIR-V goes through translation; the dumps of the unification
+    // passes would silently be skipped on a hit.
+    if (IGC_IS_FLAG_DISABLED(EnableUnifiedModuleCache) ||
+        IGC_GET_FLAG_VALUE(UnifiedModuleCacheMaxEntries) == 0 ||
+        inputDataFormat != TB_DATA_FORMAT_SPIR_V ||
+        IGC_IS_FLAG_ENABLED(ShaderDumpEnable) ||
+        pInputArgs->GTPinInput != nullptr)
+    {
+        return;
+    }
+
+    MD5 hash;
+    hashBuffer(hash, pInputArgs->pInput, pInputArgs->InputSize);
+    hashBuffer(hash, pInputArgs->pOptions, pInputArgs->OptionsSize);
+    hashBuffer(hash, pInputArgs->pInternalOptions, pInputArgs->InternalOptionsSize);
+    hashValue(hash, platform.getPlatformInfo());
+    hashValue(hash, platform.getSkuTable());
+    hashValue(hash, platform.getWATable());
+    hashValue(hash, platform.GetGTSystemInfo());
+
+    MD5::MD5Result result;
+    hash.final(result);
+    m_key = result.digest().str().str();
+}
+
+std::unique_ptr<Module> UnifiedModuleCacheOCL::load(LLVMContext& Context) const
+{
+    if (!isEnabled())
+    {
+        return nullptr;
+    }
+
+    CacheStorage& storage = getStorage();
+    std::lock_guard<std::mutex> lock(storage.Mutex);
+
+    auto it = storage.Entries.find(m_key);
+    if (it == storage.Entries.end())
+    {
+        return nullptr;
+    }
+    it->second.LastUse = ++storage.Clock;
+
+    Expected<std::unique_ptr<Module>> ModuleOrErr =
+        parseBitcodeFile(it->second.Bitcode->getMemBufferRef(), Context);
+    if (Error E = ModuleOrErr.takeError())
+    {
+        consumeError(std::move(E));
+        storage.Entries.erase(it);
+        return nullptr;
+    }
+    return std::move(*ModuleOrErr);
+}
+
+void UnifiedModuleCacheOCL::store(const Module& M) const
+{
+    if (!isEnabled())
+    {
+        return;
+    }
+
+    SmallVector<char, 0> bitcode;
+    {
+        raw_svector_ostream os(bitcode);
+        IGCLLVM::WriteBitcodeToFile(&M, os);
+    }
+
+    CacheStorage& storage = getStorage();
+    std::lock_guard<std::mutex> lock(storage.Mutex);
+
+    CacheEntry& entry = storage.Entries[m_key];
+    entry.Bitcode = MemoryBuffer::getMemBufferCopy(StringRef(bitcode.data(), bitcode.size()));
+    entry.LastUse = ++storage.Clock;
+
+    const size_t maxEntries = IGC_GET_FLAG_VALUE(UnifiedModuleCacheMaxEntries);
+    while (storage.Entries.size() > maxEntries)
+    {
+        auto lru = storage.Entries.begin();
+        for (auto it = storage.Entries.begin(); it != storage.Entries.end(); ++it)
+        {
+            if (it->second.LastUse < lru->second.LastUse)
+            {
+                lru = it;
+            }
+        }
+        storage.Entries.erase(lru);
+    }
+}
+
+} // namespace TC
@@ -0,0 +1,72 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#pragma once
+#include "AdaptorOCL/OCL/TB/igc_tb.h"
+#include "Compiler/CISACodeGen/Platform.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <memory>
+#include <string>
+
+namespace TC
+{
+    /// Process-wide cache of SPIR-V modules after unification.
+    ///
+    /// An entry holds the bitcode of the module right after UnifyIROCL, i.e.
+    /// once it was translated from SPIR-V and linked with the builtins but
+    /// before OptimizeIR. Building the same module again then only runs
+    /// OptimizeIR and CodeGen.
+    ///
+    /// The key covers the input, the build options and the platform
+    /// description, which are everything unification depends on. Entries live
+    /// in memory only; the least recently used one is evicted once there are
+    /// more than UnifiedModuleCacheMaxEntries.
+    class UnifiedModuleCacheOCL
+    {
+    public:
+        UnifiedModuleCacheOCL(
+            const STB_TranslateInputArgs* pInputArgs,
+            TB_DATA_FORMAT inputDataFormat,
+            const IGC::CPlatform& platform);
+
+        /// false if the cache is disabled or the compile can't be cached
+        bool isEnabled() const { return !m_key.empty(); }
+
+        /// On a hit, returns a copy of the unified module owned by Context.
+        std::unique_ptr<llvm::Module> load(llvm::LLVMContext& Context) const;
+
+        /// Store the unified module. Its IGC metadata must have been saved
+        /// and serialized into the module already.
+        void store(const llvm::Module& M) const;
+
+    private:
+        std::string m_key;
+    };
+}
@@ -57,6 +57,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/CISACodeGen/ResolvePredefinedConstant.h"
 #include "Compiler/CISACodeGen/SimplifyConstant.h"
 #include "Compiler/CISACodeGen/FoldKnownWorkGroupSizes.h"
+#include "Compiler/ThreadCombining.hpp"
 
 #include "Compiler/Optimizer/BuiltInFuncImport.h"
 #include "Compiler/Optimizer/CodeAssumption.hpp"
@@ -91,12 +92,15 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/Optimizer/OpenCLPasses/AddressSpaceAliasAnalysis/AddressSpaceAliasAnalysis.h"
 #include "Compiler/Optimizer/OpenCLPasses/DeviceEnqueueFuncs/DeviceEnqueue.hpp"
 #include "Compiler/Optimizer/OpenCLPasses/DeviceEnqueueFuncs/TransformBlocks.hpp"
+#include "Compiler/Optimizer/OpenCLPasses/PrecomputedArgs/PrecomputedArgs.hpp"
 #include "Compiler/Optimizer/OpenCLPasses/UndefinedReferences/UndefinedReferencesPass.hpp"
 #include "Compiler/Optimizer/OpenCLPasses/SubGroupFuncs/SubGroupFuncsResolution.hpp"
 #include "Compiler/Optimizer/OpenCLPasses/BIFTransforms/BIFTransforms.hpp"
 #include "Compiler/Optimizer/OpenCLPasses/BreakdownIntrinsic.h"
 #include "Compiler/Optimizer/OpenCLPasses/StatelessToStatefull/StatelessToStatefull.hpp"
 #include "Compiler/Optimizer/OpenCLPasses/KernelFunctionCloning.h"
+#include "Compiler/Optimizer/OpenCLPasses/KernelArgSpecialization/KernelArgSpecialization.hpp"
+#include "Compiler/Optimizer/OpenCLPasses/IndirectCallDevirtualization.h"
 #include "Compiler/Legalizer/TypeLegalizerPass.h"
 #include "Compiler/Optimizer/OpenCLPasses/ClampLoopUnroll/ClampLoopUnroll.hpp"
 #include "Compiler/Optimizer/OpenCLPasses/Image3dToImage2darray/Image3dToImage2darray.hpp"
@@ -172,7 +176,9 @@ namespace IGC
 static void CommonOCLBasedPasses(
     OpenCLProgramContext* pContext,
     std::unique_ptr<llvm::Module> BuiltinGenericModule,
-    std::unique_ptr<llvm::Module> BuiltinSizeModule)
+    std::unique_ptr<llvm::Module> BuiltinSizeModule,
+    const BiFCallGraphSummary* BuiltinGenericCallGraph,
+    const BiFCallGraphSummary* BuiltinSizeCallGraph)
 {
     IGCPassManager mpm(pContext, "Unify");
 
@@ -225,6 +231,12 @@ static void CommonOCLBasedPasses(
     pContext->getModuleMetaData()->compOpt.replaceGlobalOffsetsByZero =
         static_cast<OpenCLProgramContext*>(pContext)->m_InternalOptions.replaceGlobalOffsetsByZero;
 
+    pContext->getModuleMetaData()->compOpt.TrimLocalIDs =
+        static_cast<OpenCLProgramContext*>(pContext)->m_InternalOptions.TrimLocalIDs;
+
+    pContext->getModuleMetaData()->compOpt.FastCompile =
+        static_cast<OpenCLProgramContext*>(pContext)->m_InternalOptions.FastCompile;
+
     pContext->getModuleMetaData()->compOpt.SubgroupIndependentForwardProgressRequired =
         (static_cast<OpenCLProgramContext*>(pContext)->m_Options.NoSubgroupIFP == false);
 
@@ -237,6 +249,9 @@ static void CommonOCLBasedPasses(
     pContext->getModuleMetaData()->compOpt.HasBufferOffsetArg =
         static_cast<OpenCLProgramContext*>(pContext)->m_InternalOptions.IntelHasBufferOffsetArg;
 
+    pContext->getModuleMetaData()->compOpt.KernelBuffersNotAliased =
+        static_cast<OpenCLProgramContext*>(pContext)->m_InternalOptions.BuffersNotAliased;
+
     // right now we don't support any standard function in the code gen
     // maybe we want to support some at some point to take advantage of LLVM optimizations
     TargetLibraryInfoImpl TLI;
@@ -272,6 +287,14 @@ static void CommonOCLBasedPasses(
     // Clone kernel function being used as user function.
     mpm.add(createKernelFunctionCloningPass());
 
+    // Fold the args the runtime specializes this build for. Kernels called as
+    // user functions were cloned above, so the clones stay generic.
+    if (IGC_IS_FLAG_DISABLED(DisableDynamicConstantFolding) &&
+        !pContext->m_InternalOptions.SpecializedArgs.empty())
+    {
+        mpm.add(new KernelArgSpecialization());
+    }
+
     mpm.add(new CorrectlyRoundedDivSqrt(shouldForceCR, false));
     if(IGC_IS_FLAG_ENABLED(EnableIntelFast))
     {
@@ -289,9 +312,14 @@ static void CommonOCLBasedPasses(
 	}
 
     mpm.add(new PreBIImportAnalysis());
-    mpm.add(createBuiltInImportPass(std::move(BuiltinGenericModule), std::move(BuiltinSizeModule)));
+    mpm.add(createBuiltInImportPass(std::move(BuiltinGenericModule), std::move(BuiltinSizeModule),
+        BuiltinGenericCallGraph, BuiltinSizeCallGraph));
     mpm.add(new UndefinedReferencesPass());
 
+    // Resolve indirect calls now that the whole program, builtins included,
+    // is available, so that the inliner below can see through them.
+    mpm.add(createIndirectCallDevirtualizationPass());
+
     // Estimate maximal function size in the module and disable subroutine if not profitable.
     mpm.add(createEstimateFunctionSizePass());
 
@@ -339,11 +367,23 @@ static void CommonOCLBasedPasses(
         // Add fix up of illegal `addrspacecast` in respect to OCL 2.0 spec.
         mpm.add(createFixAddrSpaceCastPass());
         mpm.add(createResolveGASPass());
+        if (IGC_IS_FLAG_ENABLED(EnableGASRetyping))
+        {
+            // Narrow generic pointers passed through arguments and private
+            // slots, then resolve the casts this exposes.
+            mpm.add(createGASRetypingPass());
+            mpm.add(createResolveGASPass());
+        }
         // Run another round of constant breaking as GAS resolving may generate constants (constant address)
         mpm.add(new BreakConstantExpr());
     }
 
 
+    if (IGC_IS_FLAG_ENABLED(EnableOCLThreadCombining))
+    {
+        mpm.add(new OpenCLThreadCombining());
+    }
+
     mpm.add(CreateFoldKnownWorkGroupSizes());
 
     // Run the AlignmentAnalysis pass before the passes which add implicit arguments, to ensure we do not lose load/store alignment information.
@@ -361,6 +401,10 @@ static void CommonOCLBasedPasses(
     mpm.add(new ExtensionFuncsAnalysis());
     mpm.add(new ExtensionArgAnalysis());
     mpm.add(new DeviceEnqueueFuncsAnalysis());
+    if (IGC_IS_FLAG_ENABLED(EnablePrecomputedArgs))
+    {
+        mpm.add(new PrecomputedArgsAnalysis());
+    }
     mpm.add(createGenericAddressAnalysisPass());
     if (IGC_GET_FLAG_VALUE(FunctionControl) != FLAG_FCALL_FORCE_INLINE)
     {
@@ -386,6 +430,10 @@ static void CommonOCLBasedPasses(
     mpm.add(new ResolveAggregateArguments());
     mpm.add(new ExtensionFuncsResolution());
     mpm.add(new DeviceEnqueueFuncsResolution());
+    if (IGC_IS_FLAG_ENABLED(EnablePrecomputedArgs))
+    {
+        mpm.add(new PrecomputedArgsResolution());
+    }
 
     mpm.add(createDeadCodeEliminationPass());
 
@@ -462,16 +510,22 @@ static void CommonOCLBasedPasses(
 void UnifyIROCL(
     OpenCLProgramContext* pContext,
     std::unique_ptr<llvm::Module> BuiltinGenericModule,
-    std::unique_ptr<llvm::Module> BuiltinSizeModule)
+    std::unique_ptr<llvm::Module> BuiltinSizeModule,
+    const BiFCallGraphSummary* BuiltinGenericCallGraph,
+    const BiFCallGraphSummary* BuiltinSizeCallGraph)
 {
-    CommonOCLBasedPasses(pContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule));
+    CommonOCLBasedPasses(pContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule),
+        BuiltinGenericCallGraph, BuiltinSizeCallGraph);
 }
 
 void UnifyIRSPIR(
     OpenCLProgramContext* pContext,
     std::unique_ptr<llvm::Module> BuiltinGenericModule,
-    std::unique_ptr<llvm::Module> BuiltinSizeModule)
+    std::unique_ptr<llvm::Module> BuiltinSizeModule,
+    const BiFCallGraphSummary* BuiltinGenericCallGraph,
+    const BiFCallGraphSummary* BuiltinSizeCallGraph)
 {
-    CommonOCLBasedPasses(pContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule));
+    CommonOCLBasedPasses(pContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule),
+        BuiltinGenericCallGraph, BuiltinSizeCallGraph);
 }
 }
@@ -25,16 +25,21 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 ======================= end_copyright_notice ==================================*/
 #pragma once
 #include "Compiler/CodeGenPublic.h"
+#include "Compiler/Optimizer/BiFCallGraphSummary.hpp"
 
 namespace IGC
 {
     void UnifyIROCL(
         OpenCLProgramContext* pContext,
         std::unique_ptr<llvm::Module> BuiltinGenericModule,
-        std::unique_ptr<llvm::Module> BuiltinSizeModule);
+        std::unique_ptr<llvm::Module> BuiltinSizeModule,
+        const BiFCallGraphSummary* BuiltinGenericCallGraph = nullptr,
+        const BiFCallGraphSummary* BuiltinSizeCallGraph = nullptr);
 
     void UnifyIRSPIR(
         OpenCLProgramContext* pContext,
         std::unique_ptr<llvm::Module> BuiltinGenericModule,
-        std::unique_ptr<llvm::Module> BuiltinSizeModule);
+        std::unique_ptr<llvm::Module> BuiltinSizeModule,
+        const BiFCallGraphSummary* BuiltinGenericCallGraph = nullptr,
+        const BiFCallGraphSummary* BuiltinSizeCallGraph = nullptr);
 }
\ No newline at end of file
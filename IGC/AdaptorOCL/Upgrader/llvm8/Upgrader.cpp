@@ -59,7 +59,24 @@ upgrader::upgradeBitcodeFile(MemoryBufferRef Buffer, LLVMContext &Context) {
   return MemoryBuffer::getMemBufferCopy(OS.str());
 }
 
+bool
+upgrader::isCurrentBitcode(MemoryBufferRef Buffer) {
+  // The identification block (LLVM 3.8+) records the producer as
+  // "LLVM<version>". Anything older or from another producer is upgraded.
+  Expected<std::string> Producer = llvm::getBitcodeProducerString(Buffer);
+  if (!Producer) {
+    consumeError(Producer.takeError());
+    return false;
+  }
+  std::string Current = "LLVM" + std::to_string(LLVM_VERSION_MAJOR) + ".";
+  return Producer->compare(0, Current.size(), Current) == 0;
+}
+
 Expected<std::unique_ptr<Module>>
 upgrader::upgradeAndParseBitcodeFile(MemoryBufferRef Buffer, LLVMContext &Context) {
+  // Bitcode written by the LLVM IGC is built with never needs the legacy
+  // fixups, so skip straight to the regular reader.
+  if (isCurrentBitcode(Buffer))
+    return llvm::parseBitcodeFile(Buffer, Context);
   return upgrader::parseBitcodeFile(Buffer, Context);
 }
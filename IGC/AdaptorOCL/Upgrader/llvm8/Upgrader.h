@@ -41,6 +41,10 @@ llvm::Expected<std::unique_ptr<llvm::Module>> parseBitcodeFile(llvm::MemoryBuffe
 
 std::unique_ptr<llvm::MemoryBuffer> upgradeBitcodeFile(llvm::MemoryBufferRef, llvm::LLVMContext &);
 
+// Returns true if the bitcode was produced by the same LLVM major version
+// IGC is built against and can be read without upgrading.
+bool isCurrentBitcode(llvm::MemoryBufferRef);
+
 llvm::Expected<std::unique_ptr<llvm::Module>> upgradeAndParseBitcodeFile(llvm::MemoryBufferRef, llvm::LLVMContext &);
 
 } // End upgrader namespace
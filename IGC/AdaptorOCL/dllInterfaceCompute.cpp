@@ -41,6 +41,10 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "AdaptorOCL/Upgrader/Upgrader.h"
 #include "AdaptorOCL/UnifyIROCL.hpp"
 #include "AdaptorOCL/DriverInfoOCL.hpp"
+#include "AdaptorOCL/BinaryCacheOCL.hpp"
+#include "AdaptorOCL/BuiltinModuleCacheOCL.hpp"
+#include "AdaptorOCL/UnifiedModuleCacheOCL.hpp"
+#include "Compiler/CISACodeGen/KernelBinaryCache.hpp"
 
 #include "Compiler/MetaDataApi/IGCMetaDataHelper.h"
 #include "Compiler/MetaDataApi/IGCMetaDataDefs.h"
@@ -49,6 +53,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "common/debug/Dump.hpp"
 #include "common/debug/Debug.hpp"
+#include "common/debug/DumpWriter.hpp"
 #include "common/igc_regkeys.hpp"
 #include "common/secure_mem.h"
 
@@ -138,6 +143,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/Support/Format.h>
 #include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/SourceMgr.h>
+#include <llvm/Transforms/Utils/Cloning.h>
 #include "common/LLVMWarningsPop.hpp"
 
 using namespace IGC::IGCMD;
@@ -148,6 +154,38 @@ using namespace IGC;
 namespace TC
 {
 
+// Per-interval compile times of the most recent TranslateBuild on this thread.
+// Read back through GetLastCompileTimes() by tools such as igc_bench.
+static thread_local uint64_t g_lastCompileTimeNS[MAX_COMPILE_TIME_INTERVALS];
+
+// Per-kernel static metrics of the most recent TranslateBuild on this thread.
+// Read back through GetLastKernelMetrics().
+static thread_local std::vector<std::string> g_lastKernelNames;
+static thread_local std::vector<STB_KernelMetrics> g_lastKernelMetrics;
+
+// ShaderHash of the input of the most recent TranslateBuild on this thread.
+static thread_local uint64_t g_lastShaderHash = 0;
+
+// Regkey settings given to SetRegKeyOverrides on this thread, used by
+// TranslateBuild in place of the TuningDatabase while set.
+static thread_local bool g_hasRegKeyOverrides = false;
+static thread_local std::string g_regKeyOverrides;
+
+// Applies per-build regkey settings to the calling thread until the end of
+// the build.
+class ScopedRegKeyOverrides
+{
+public:
+    explicit ScopedRegKeyOverrides(const char* pSettings)
+    {
+        SetThreadRegKeyOverrides(pSettings);
+    }
+    ~ScopedRegKeyOverrides()
+    {
+        SetThreadRegKeyOverrides(nullptr);
+    }
+};
+
 extern bool ProcessElfInput(
   STB_TranslateInputArgs &InputArgs,
   STB_TranslateOutputArgs &OutputArgs,
@@ -192,6 +230,19 @@ static void SetErrorMessage(const std::string & ErrorMessage, STB_TranslateOutpu
     pOutputArgs.ErrorStringSize = ErrorMessage.size() + 1;
 }
 
+// Adds ErrorMessage as a new line of the build log, keeping what is already there.
+static void AppendErrorMessage(const std::string & ErrorMessage, STB_TranslateOutputArgs & pOutputArgs)
+{
+    if (pOutputArgs.pErrorString == nullptr)
+    {
+        SetErrorMessage(ErrorMessage, pOutputArgs);
+        return;
+    }
+    std::string buildLog(pOutputArgs.pErrorString);
+    delete[] pOutputArgs.pErrorString;
+    SetErrorMessage(buildLog + "\n" + ErrorMessage, pOutputArgs);
+}
+
 bool CIGCTranslationBlock::Create(
     const STB_CreateArgs* pCreateArgs,
     CIGCTranslationBlock* &pTranslationBlock )
@@ -224,6 +275,14 @@ void CIGCTranslationBlock::Delete(
     pTranslationBlock = NULL;
 }
 
+// Concurrency: Translate may be called from several threads at once, on the
+// same or on different translation blocks. Each call compiles against its own
+// OpenCLProgramContext (and LLVMContext), vISA builder and options; registry
+// keys and LLVM command line options are read only once per process in
+// LoadRegistryKeys and are read-only afterwards. Process-wide caches
+// (BuiltinModuleCacheOCL, UnifiedModuleCacheOCL) and the dump writer are
+// internally synchronized. Debug-only features that change regkeys at
+// runtime (e.g. PreRAScheduler DDG dumps) are not covered by this guarantee.
 bool CIGCTranslationBlock::Translate(
     const STB_TranslateInputArgs* pInputArgs,
     STB_TranslateOutputArgs* pOutputArgs )
@@ -338,13 +397,13 @@ bool ProcessElfInput(
               llvm::Module* pKernelModule = nullptr;
 #if defined(IGC_SPIRV_ENABLED)
               Context.setAsSPIRV();
-              std::istringstream IS(buf);
               std::string stringErrMsg;
               llvm::StringRef options;
               if(InputArgs.OptionsSize > 0){
                   options = llvm::StringRef(InputArgs.pOptions, InputArgs.OptionsSize - 1);
               }
-              bool success = spv::ReadSPIRV(*Context.getLLVMContext(), IS, pKernelModule, options, stringErrMsg);
+              bool success = spv::ReadSPIRV(*Context.getLLVMContext(), buf.data(), buf.size(),
+                  pKernelModule, options, stringErrMsg);
 #else
               std::string stringErrMsg{ "SPIRV consumption not enabled for the TARGET." };
               bool success = false;
@@ -540,13 +599,13 @@ bool ParseInput(
     else if (inputDataFormatTemp == TB_DATA_FORMAT_SPIR_V) {
 #if defined(IGC_SPIRV_ENABLED)
         //convert SPIR-V binary to LLVM module
-        std::istringstream IS(strInput);        
         std::string stringErrMsg;
         llvm::StringRef options;
         if(pInputArgs->OptionsSize > 0){
             options = llvm::StringRef(pInputArgs->pOptions, pInputArgs->OptionsSize);
         }
-        bool success = spv::ReadSPIRV(oclContext, IS, pKernelModule, options, stringErrMsg);
+        bool success = spv::ReadSPIRV(oclContext, strInput.data(), strInput.size(),
+            pKernelModule, options, stringErrMsg);
 #else
         std::string stringErrMsg{"SPIRV consumption not enabled for the TARGET."};
         bool success = false;
@@ -599,13 +658,7 @@ void DumpShaderFile(const char *pOutputFolder, const char * pBuffer, UINT buffer
 			<< std::setfill(' ')
 			<< pExt;
 
-		FILE* pFile = NULL;
-		fopen_s(&pFile, ss.str().c_str(), "wb");
-		if (pFile)
-		{
-			fwrite(pBuffer, 1, bufferSize, pFile);
-			fclose(pFile);
-		}
+		IGC::Debug::WriteDumpFile(ss.str(), std::string(pBuffer, bufferSize));
 	}
 }
 
@@ -650,6 +703,13 @@ bool TranslateBuild(
     const IGC::CPlatform& IGCPlatform, 
     float profilingTimerResolution)
 {
+    ShaderHash inputShHash = ShaderHashOCL((const UINT*)pInputArgs->pInput, pInputArgs->InputSize / 4);
+    g_lastShaderHash = inputShHash.getAsmHash();
+
+    // Knob settings selected for this shader by igc_bench -tune.
+    ScopedRegKeyOverrides regKeyOverrides(g_hasRegKeyOverrides ?
+        g_regKeyOverrides.c_str() : GetTunedRegKeySettings(g_lastShaderHash));
+
     if (IGC_IS_FLAG_ENABLED(QualityMetricsEnable))
     {
         IGC::Debug::SetDebugFlag(IGC::Debug::DebugFlag::SHADER_QUALITY_METRICS, true);
@@ -657,13 +717,17 @@ bool TranslateBuild(
     
     MEM_USAGERESET;
 
+    BinaryCacheOCL binaryCache(pInputArgs, inputDataFormatTemp, IGCPlatform, profilingTimerResolution);
+    if (binaryCache.load(pOutputArgs))
+    {
+        return true;
+    }
+
     // Parse the module we want to compile
     llvm::Module* pKernelModule = nullptr;
-    LLVMContextWrapper* llvmContext = new LLVMContextWrapper;
+    LLVMContextWrapper* llvmContext = LLVMContextWrapper::Create();
     RegisterComputeErrHandlers(*llvmContext);
 
-	ShaderHash inputShHash = ShaderHashOCL((const UINT*)pInputArgs->pInput, pInputArgs->InputSize / 4);
-
 	if (IGC_IS_FLAG_ENABLED(ShaderDumpEnable))
 	{
 		const char *pOutputFolder = IGC::Debug::GetShaderOutputFolder();
@@ -692,7 +756,18 @@ bool TranslateBuild(
 		DumpShaderFile(pOutputFolder, (char *)pInputArgs->pOptions, pInputArgs->OptionsSize, hash, "_options.txt");
 	}
 
-    if (!ParseInput(pKernelModule, pInputArgs, pOutputArgs, *llvmContext, inputDataFormatTemp))
+    // A hit replaces translation, builtin linking and unification at once.
+    UnifiedModuleCacheOCL unifiedCache(pInputArgs, inputDataFormatTemp, IGCPlatform);
+    bool isUnifiedFromCache = false;
+    auto parseOrLoadUnified = [&](llvm::LLVMContext& Context)
+    {
+        pKernelModule = unifiedCache.load(Context).release();
+        isUnifiedFromCache = (pKernelModule != nullptr);
+        return isUnifiedFromCache ||
+            ParseInput(pKernelModule, pInputArgs, pOutputArgs, Context, inputDataFormatTemp);
+    };
+
+    if (!parseOrLoadUnified(*llvmContext))
     {
         return false;
     }
@@ -724,6 +799,7 @@ bool TranslateBuild(
     }
 
 	oclContext.hash = inputShHash;
+    oclContext.m_kernelBinaryCacheBuildKey = KernelBinaryCache::GetBuildKey(pInputArgs, IGCPlatform);
     oclContext.annotater = nullptr;
 
     // Set default denorm.
@@ -741,12 +817,18 @@ bool TranslateBuild(
     /// set retry manager
     bool retry = false;
     oclContext.m_retryManager.Enable();
+    if (oclContext.m_InternalOptions.FastCompile)
+    {
+        // First tier binary: a single compile, whatever it spills.
+        oclContext.m_retryManager.Disable();
+    }
     do
     {
         std::unique_ptr<llvm::Module> BuiltinGenericModule = nullptr;
         std::unique_ptr<llvm::Module> BuiltinSizeModule = nullptr;
-        std::unique_ptr<llvm::MemoryBuffer> pGenericBuffer = nullptr;
-        std::unique_ptr<llvm::MemoryBuffer> pSizeTBuffer = nullptr;
+        const IGC::BiFCallGraphSummary* BuiltinGenericCallGraph = nullptr;
+        const IGC::BiFCallGraphSummary* BuiltinSizeCallGraph = nullptr;
+        if (!isUnifiedFromCache)
 		{
 			// IGC has two BIF Modules: 
 			//            1. kernel Module (pKernelModule)
@@ -768,22 +850,30 @@ bool TranslateBuild(
 			// when linking M1 into M0 (M0 : dstModule, M1 : srcModule), the final type is the type
 			// used in M0.
 
-			// Load the builtin module -  Generic BC
+			// The resource buffers and their bitcode index are shared by all
+			// compiles in the process (see BuiltinModuleCacheOCL); only the lazy
+			// modules themselves are created per LLVMContext.
+
 			// Load the builtin module -  Generic BC
 			{
-				char Resource[5] = { '-' };
-				_snprintf(Resource, sizeof(Resource), "#%d", OCL_BC);
-
-				pGenericBuffer.reset(llvm::LoadBufferFromResource(Resource, "BC"));
+				// The platform variants have __UseNative64BitSubgroupBuiltin and __CRMacros
+				// folded in, so they only replace the generic library on a matching platform.
+				int ResId = OCL_BC;
+				if (IGC_IS_FLAG_ENABLED(EnablePlatformBiF))
+				{
+					const bool native64 = !oclContext.platform.hasNo64BitInst();
+					const bool crMacros = oclContext.platform.hasCorrectlyRoundedMacros();
+					if (native64 && crMacros)
+						ResId = OCL_BC_NATIVE64;
+					else if (!native64 && !crMacros)
+						ResId = OCL_BC_NO64;
+				}
 
-                if (pGenericBuffer == NULL) 
-                {
-                    SetErrorMessage("Error loading the Generic builtin resource", *pOutputArgs);
-                    return false;
-                }
+				char Resource[5] = { '-' };
+				_snprintf(Resource, sizeof(Resource), "#%d", ResId);
 
                 llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
-                    getLazyBitcodeModule(pGenericBuffer->getMemBufferRef(), *oclContext.getLLVMContext());
+                    BuiltinModuleCacheOCL::get().getLazyModule(Resource, *oclContext.getLLVMContext());
                 
                 if (llvm::Error EC = ModuleOrErr.takeError()) 
                 {
@@ -795,6 +885,7 @@ bool TranslateBuild(
                 else
                 {
                     BuiltinGenericModule = std::move(*ModuleOrErr);
+                    BuiltinGenericCallGraph = BuiltinModuleCacheOCL::get().getCallGraphSummary(Resource);
                 }
 
                 if (BuiltinGenericModule == NULL)
@@ -819,16 +910,15 @@ bool TranslateBuild(
 					assert(0 && "Unknown bitness of compiled module");
 				}
 
-				// the MemoryBuffer becomes owned by the module and does not need to be managed
-				pSizeTBuffer.reset(llvm::LoadBufferFromResource(ResNumber, "BC"));
-				assert(pSizeTBuffer && "Error loading builtin resource");
-
 				llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
-					getLazyBitcodeModule(pSizeTBuffer->getMemBufferRef(), *oclContext.getLLVMContext());
+					BuiltinModuleCacheOCL::get().getLazyModule(ResNumber, *oclContext.getLLVMContext());
 				if (llvm::Error EC = ModuleOrErr.takeError())
 					assert(0 && "Error lazily loading bitcode for size_t builtins");
 				else
+				{
 					BuiltinSizeModule = std::move(*ModuleOrErr);
+					BuiltinSizeCallGraph = BuiltinModuleCacheOCL::get().getCallGraphSummary(ResNumber);
+				}
 
 				assert(BuiltinSizeModule
 					&& "Error loading builtin module from buffer");
@@ -839,14 +929,25 @@ bool TranslateBuild(
 		}
 
         oclContext.getModuleMetaData()->csInfo.forcedSIMDSize |= IGC_GET_FLAG_VALUE(ForceOCLSIMDWidth);
+        if (oclContext.m_InternalOptions.FastCompile &&
+            oclContext.getModuleMetaData()->csInfo.forcedSIMDSize == 0)
+        {
+            oclContext.getModuleMetaData()->csInfo.forcedSIMDSize = 8;
+        }
 
-        if (llvm::StringRef(oclContext.getModule()->getTargetTriple()).startswith("spir"))
+        if (isUnifiedFromCache)
+        {
+            // The builtins are linked in already and unification is done.
+        }
+        else if (llvm::StringRef(oclContext.getModule()->getTargetTriple()).startswith("spir"))
         {
-            IGC::UnifyIRSPIR(&oclContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule));
+            IGC::UnifyIRSPIR(&oclContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule),
+                BuiltinGenericCallGraph, BuiltinSizeCallGraph);
         }
         else // not SPIR
         {
-            IGC::UnifyIROCL(&oclContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule));
+            IGC::UnifyIROCL(&oclContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule),
+                BuiltinGenericCallGraph, BuiltinSizeCallGraph);
         }
 
         if (!(oclContext.oclErrorMessage.empty()))
@@ -868,14 +969,61 @@ bool TranslateBuild(
             oclContext.m_floatDenormMode32 = FLOAT_DENORM_FLUSH_TO_ZERO;
         }
 
-        // Optimize the IR. This happens once for each program, not per-kernel.
-        IGC::OptimizeIR(&oclContext);
+        if (unifiedCache.isEnabled() && !isUnifiedFromCache)
+        {
+            oclContext.getMetaDataUtils()->save(*oclContext.getLLVMContext());
+            serialize(*modMD, oclContext.getModule());
+            unifiedCache.store(*oclContext.getModule());
+        }
 
-        // Now, perform code generation
-        IGC::CodeGen(&oclContext);
+        // Nothing up to here depends on the retry state (the first passes it
+        // changes run in OptimizeIR), so keep a copy of the unified module and
+        // restart retries from it instead of from the input.
+        std::unique_ptr<llvm::Module> pUnifiedModule;
+        if (IGC_IS_FLAG_ENABLED(EnableIncrementalRetry) &&
+            !oclContext.m_retryManager.IsLastTry(&oclContext))
+        {
+            oclContext.getMetaDataUtils()->save(*oclContext.getLLVMContext());
+            serialize(*modMD, oclContext.getModule());
+            pUnifiedModule = llvm::CloneModule(*oclContext.getModule());
+        }
 
-        retry = (oclContext.m_retryManager.AdvanceState() &&
-                !oclContext.m_retryManager.kernelSet.empty());
+        bool retryFromUnifiedModule = false;
+        do
+        {
+            // Optimize the IR. This happens once for each program, not per-kernel.
+            IGC::OptimizeIR(&oclContext);
+
+            // Give up on retries and wider SIMD if the compile-time budget
+            // is running out.
+            if (oclContext.m_compileTimeBudget.Degrade(CompileTimeBudget::STEP_SKIP_RETRY))
+            {
+                oclContext.m_retryManager.Disable();
+            }
+            if (oclContext.m_compileTimeBudget.Degrade(CompileTimeBudget::STEP_SIMD8_ONLY) &&
+                oclContext.getModuleMetaData()->csInfo.forcedSIMDSize == 0)
+            {
+                oclContext.getModuleMetaData()->csInfo.forcedSIMDSize = 8;
+            }
+
+            // Now, perform code generation
+            IGC::CodeGen(&oclContext);
+
+            retry = (oclContext.m_retryManager.AdvanceState() &&
+                    !oclContext.m_retryManager.kernelSet.empty());
+
+            // Kernels that are done stay in m_programOutput and are skipped by
+            // EmitPass, so only the kernels in kernelSet get compiled again.
+            retryFromUnifiedModule = retry && pUnifiedModule;
+            if (retryFromUnifiedModule)
+            {
+                llvm::Module* pModule = oclContext.m_retryManager.IsLastTry(&oclContext) ?
+                    pUnifiedModule.release() : llvm::CloneModule(*pUnifiedModule).release();
+                oclContext.deleteModule();
+                oclContext.setModule(pModule);
+                deserialize(*oclContext.getModuleMetaData(), pModule);
+            }
+        } while (retryFromUnifiedModule);
 
         if (retry)
         {
@@ -886,17 +1034,29 @@ bool TranslateBuild(
 			
 			IGC::Debug::RegisterComputeErrHandlers(*oclContext.getLLVMContext());
 
-            if (!ParseInput(pKernelModule, pInputArgs, pOutputArgs, *oclContext.getLLVMContext(), inputDataFormatTemp))
+            if (!parseOrLoadUnified(*oclContext.getLLVMContext()))
             {
                 return false;
             }
             oclContext.setModule(pKernelModule);
+            if (isUnifiedFromCache)
+            {
+                deserialize(*oclContext.getModuleMetaData(), pKernelModule);
+            }
         }
     } while (retry);
 
     // Create the binary streams for each compiled kernel
     oclContext.m_programOutput.CreateKernelBinaries();
 
+    g_lastKernelNames.clear();
+    g_lastKernelMetrics.clear();
+    for (const auto& kernelData : oclContext.m_programOutput.m_KernelBinaries)
+    {
+        g_lastKernelNames.push_back(kernelData.kernelName);
+        g_lastKernelMetrics.push_back(kernelData.metrics);
+    }
+
     unsigned int pointerSizeInBytes = (PtrSzInBits == 64) ? 8 : 4; 
 
     // Prepare and set program binary
@@ -925,6 +1085,16 @@ bool TranslateBuild(
         pOutputArgs->pDebugData = debugDataOutput;
     }
 
+    // Report the steps the compile-time budget forced in the build log.
+    std::string budgetReport = oclContext.m_compileTimeBudget.GetReport();
+    if (!budgetReport.empty())
+    {
+        AppendErrorMessage(budgetReport, *pOutputArgs);
+    }
+
+    // Stored with the build log, which a hit restores.
+    binaryCache.store(pOutputArgs);
+
     const char* driverName =
         GTPIN_DRIVERVERSION_OPEN;
     // If GT-Pin is enabled, instrument the binary. Finally pOutputArgs will 
@@ -953,6 +1123,11 @@ bool TranslateBuild(
 
     COMPILER_TIME_PRINT(&oclContext, ShaderType::OPENCL_SHADER, oclContext.hash);
 
+    MEM_SNAPSHOT(IGC::SMS_COMPILE_END);
+    MEM_DUMP_JSON(ShaderType::OPENCL_SHADER, oclContext.hash);
+
+    COMPILER_TIME_ADD_TOTALS(&oclContext);
+    COMPILER_TIME_SNAPSHOT(&oclContext, g_lastCompileTimeNS);
     COMPILER_TIME_DEL(&oclContext, m_compilerTimeStats);
 
     return true;
@@ -1070,6 +1245,85 @@ TRANSLATION_BLOCK_API void Delete(
     CIGCTranslationBlock::Delete(pIGCTranslationBlock);
 }
 
+TRANSLATION_BLOCK_API uint32_t GetLastCompileTimes(
+    const char** pNames,
+    uint64_t* pTimesNS,
+    uint32_t count)
+{
+    for (uint32_t i = 0; i < count && i < MAX_COMPILE_TIME_INTERVALS; i++)
+    {
+        if (pNames)
+        {
+            pNames[i] = g_cCompTimeIntervals[i];
+        }
+        if (pTimesNS)
+        {
+            pTimesNS[i] = g_lastCompileTimeNS[i];
+        }
+    }
+
+    return MAX_COMPILE_TIME_INTERVALS;
+}
+
+TRANSLATION_BLOCK_API uint32_t GetTotalCompileTimes(
+    const char** pNames,
+    uint64_t* pTimesNS,
+    uint64_t* pHits,
+    uint32_t count)
+{
+    for (uint32_t i = 0; pNames && i < count && i < MAX_COMPILE_TIME_INTERVALS; i++)
+    {
+        pNames[i] = g_cCompTimeIntervals[i];
+    }
+    StatsTotals::get().snapshotTimes(pTimesNS, pHits, count);
+
+    return MAX_COMPILE_TIME_INTERVALS;
+}
+
+TRANSLATION_BLOCK_API uint32_t GetTotalShaderStats(
+    const char** pNames,
+    int64_t* pValues,
+    uint32_t count)
+{
+    for (uint32_t i = 0; pNames && i < count && i < STATS_MAX_SHADER_STATS_ITEMS; i++)
+    {
+        pNames[i] = g_cShaderStatItems[i];
+    }
+    StatsTotals::get().snapshotShaderStats(pValues, count);
+
+    return STATS_MAX_SHADER_STATS_ITEMS;
+}
+
+TRANSLATION_BLOCK_API uint32_t GetLastKernelMetrics(
+    STB_KernelMetrics* pMetrics,
+    uint32_t count)
+{
+    for (uint32_t i = 0; pMetrics && i < count && i < g_lastKernelMetrics.size(); i++)
+    {
+        pMetrics[i] = g_lastKernelMetrics[i];
+        pMetrics[i].pKernelName = g_lastKernelNames[i].c_str();
+    }
+
+    return (uint32_t)g_lastKernelMetrics.size();
+}
+
+TRANSLATION_BLOCK_API uint64_t GetLastShaderHash()
+{
+    return g_lastShaderHash;
+}
+
+TRANSLATION_BLOCK_API bool SetRegKeyOverrides(
+    const char* pSettings)
+{
+    g_hasRegKeyOverrides = (pSettings != nullptr);
+    g_regKeyOverrides = pSettings ? pSettings : "";
+#if defined(IGC_DEBUG_VARIABLES)
+    return true;
+#else
+    return false;
+#endif
+}
+
 }
 
 
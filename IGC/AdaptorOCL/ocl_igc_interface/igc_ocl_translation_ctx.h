@@ -27,6 +27,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 
 #include <cinttypes>
+#include <vector>
 
 #include "cif/builtins/memory/buffer/buffer.h"
 #include "cif/common/id.h"
@@ -93,6 +94,68 @@ protected:
                                                   void *gtPinInput);
 };
 
+CIF_DEFINE_INTERFACE_VER_WITH_COMPATIBILITY(IgcOclTranslationCtx, 3, 2) {
+  using IgcOclTranslationCtx<2>::TranslateImpl;
+  using IgcOclTranslationCtx<2>::Translate;
+
+  CIF_INHERIT_CONSTRUCTOR();
+
+  // Invoked on an IGC worker thread once an asynchronous translation is done.
+  // The callback takes ownership of output (nullptr on OOM) and must release it.
+  using TranslateCallback = void (*)(void *userData, OclTranslationOutputBase *output);
+
+  // Queues the translation and returns immediately; false if it could not be queued.
+  // All buffers must stay alive until the callback fires. Destroying this
+  // context waits for the queued translations to finish.
+  template <typename OclTranslationOutputInterface = OclTranslationOutputTagOCL>
+  bool TranslateAsync(CIF::Builtins::BufferSimple *src,
+                      CIF::Builtins::BufferSimple *options,
+                      CIF::Builtins::BufferSimple *internalOptions,
+                      CIF::Builtins::BufferSimple *tracingOptions,
+                      uint32_t tracingOptionsCount,
+                      TranslateCallback callback,
+                      void *userData) {
+      return TranslateAsyncImpl(OclTranslationOutputInterface::GetVersion(), src, options, internalOptions, tracingOptions, tracingOptionsCount, callback, userData);
+  }
+
+  // Translates count programs, running up to maxParallelism of them at a time
+  // (0 : one per hardware thread), and blocks until all of them are done.
+  // options and internalOptions may be nullptr, otherwise they hold count entries.
+  template <typename OclTranslationOutputInterface = OclTranslationOutputTagOCL>
+  std::vector<CIF::RAII::UPtr_t<OclTranslationOutputInterface>> TranslateBatch(uint32_t count,
+                                                                               CIF::Builtins::BufferSimple **srcs,
+                                                                               CIF::Builtins::BufferSimple **options,
+                                                                               CIF::Builtins::BufferSimple **internalOptions,
+                                                                               uint32_t maxParallelism) {
+      std::vector<OclTranslationOutputBase *> outputs(count, nullptr);
+      TranslateBatchImpl(OclTranslationOutputInterface::GetVersion(), count, srcs, options, internalOptions, maxParallelism, outputs.data());
+      std::vector<CIF::RAII::UPtr_t<OclTranslationOutputInterface>> ret;
+      ret.reserve(count);
+      for (auto p : outputs) {
+          ret.push_back(CIF::RAII::Pack<OclTranslationOutputInterface>(p));
+      }
+      return ret;
+  }
+
+protected:
+  virtual bool TranslateAsyncImpl(CIF::Version_t outVersion,
+                                  CIF::Builtins::BufferSimple *src,
+                                  CIF::Builtins::BufferSimple *options,
+                                  CIF::Builtins::BufferSimple *internalOptions,
+                                  CIF::Builtins::BufferSimple *tracingOptions,
+                                  uint32_t tracingOptionsCount,
+                                  TranslateCallback callback,
+                                  void *userData);
+
+  virtual void TranslateBatchImpl(CIF::Version_t outVersion,
+                                  uint32_t count,
+                                  CIF::Builtins::BufferSimple **srcs,
+                                  CIF::Builtins::BufferSimple **options,
+                                  CIF::Builtins::BufferSimple **internalOptions,
+                                  uint32_t maxParallelism,
+                                  OclTranslationOutputBase **outputs);
+};
+
 CIF_GENERATE_VERSIONS_LIST_AND_DECLARE_INTERFACE_DEPENDENCIES(IgcOclTranslationCtx, IGC::OclTranslationOutput, CIF::Builtins::Buffer);
 CIF_MARK_LATEST_VERSION(IgcOclTranslationCtxLatest, IgcOclTranslationCtx);
 using IgcOclTranslationCtxTagOCL = IgcOclTranslationCtxLatest; // Note : can tag with different version for
@@ -52,6 +52,29 @@ OclTranslationOutputBase *CIF_GET_INTERFACE_CLASS(IgcOclTranslationCtx, 2)::Tran
     return CIF_GET_PIMPL()->Translate(outVersion, src, options, internalOptions, tracingOptions, tracingOptionsCount, gtPinInput);
 }
 
+bool CIF_GET_INTERFACE_CLASS(IgcOclTranslationCtx, 3)::TranslateAsyncImpl(
+                                                 CIF::Version_t outVersion,
+                                                 CIF::Builtins::BufferSimple *src,
+                                                 CIF::Builtins::BufferSimple *options,
+                                                 CIF::Builtins::BufferSimple *internalOptions,
+                                                 CIF::Builtins::BufferSimple *tracingOptions,
+                                                 uint32_t tracingOptionsCount,
+                                                 TranslateCallback callback,
+                                                 void *userData) {
+    return CIF_GET_PIMPL()->TranslateAsync(outVersion, src, options, internalOptions, tracingOptions, tracingOptionsCount, callback, userData);
+}
+
+void CIF_GET_INTERFACE_CLASS(IgcOclTranslationCtx, 3)::TranslateBatchImpl(
+                                                 CIF::Version_t outVersion,
+                                                 uint32_t count,
+                                                 CIF::Builtins::BufferSimple **srcs,
+                                                 CIF::Builtins::BufferSimple **options,
+                                                 CIF::Builtins::BufferSimple **internalOptions,
+                                                 uint32_t maxParallelism,
+                                                 OclTranslationOutputBase **outputs) {
+    CIF_GET_PIMPL()->TranslateBatch(outVersion, count, srcs, options, internalOptions, maxParallelism, outputs);
+}
+
 }
 
 #include "cif/macros/disable.h"
@@ -29,7 +29,9 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "ocl_igc_interface/igc_ocl_translation_ctx.h"
 #include "ocl_igc_interface/impl/igc_ocl_device_ctx_impl.h"
 
+#include <algorithm>
 #include <memory>
+#include <mutex>
 
 #include "cif/builtins/memory/buffer/impl/buffer_impl.h"
 #include "cif/helpers/error.h"
@@ -40,6 +42,11 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "AdaptorOCL/OCL/TB/igc_tb.h"
 #include "common/debug/Debug.hpp"
 
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Support/ThreadPool.h>
+#include <llvm/Support/Threading.h>
+#include "common/LLVMWarningsPop.hpp"
+
 #include "cif/macros/enable.h"
 
 namespace TC{
@@ -134,7 +141,10 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
                     src->PushBackRawBytes(arg, strlen(arg));
                 }
             }
-            inputArgs.pInput = src->GetMemoryWriteable<char>();
+            // TranslateBuild only reads its input, so this must not use the
+            // writeable accessor: for a buffer wrapping caller-owned const
+            // memory that would copy the whole input
+            inputArgs.pInput = const_cast<char*>(src->GetMemory<char>());
             inputArgs.InputSize = static_cast<uint32_t>(src->GetSizeRaw());
         }
         if(options != nullptr){
@@ -204,8 +214,9 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
         bool dataCopiedSuccessfuly = true;
         if(success){
             dataCopiedSuccessfuly &= outputInterface->GetImpl()->AddWarning(output.pErrorString, output.ErrorStringSize);
-            dataCopiedSuccessfuly &= outputInterface->GetImpl()->CloneDebugData(output.pDebugData, output.DebugDataSize);
-            dataCopiedSuccessfuly &= outputInterface->GetImpl()->SetSuccessfulAndCloneOutput(output.pOutput, output.OutputSize);
+            // the binary and debug data are moved, not copied, into the output
+            dataCopiedSuccessfuly &= outputInterface->GetImpl()->TakeDebugData(debugData.release(), output.DebugDataSize);
+            dataCopiedSuccessfuly &= outputInterface->GetImpl()->SetSuccessfulAndTakeOutput(outputData.release(), output.OutputSize);
         }else{
             dataCopiedSuccessfuly &= outputInterface->GetImpl()->SetError(TranslationErrorType::FailedCompilation, output.pErrorString);
         }
@@ -216,11 +227,78 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
 
         return outputInterface.release();
     }
+
+    using TranslateCallback = IgcOclTranslationCtx<3>::TranslateCallback;
+
+    bool TranslateAsync(CIF::Version_t outVersion,
+                        CIF::Builtins::BufferSimple *src,
+                        CIF::Builtins::BufferSimple *options,
+                        CIF::Builtins::BufferSimple *internalOptions,
+                        CIF::Builtins::BufferSimple *tracingOptions,
+                        uint32_t tracingOptionsCount,
+                        TranslateCallback callback,
+                        void *userData) const{
+        if(callback == nullptr){
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(this->asyncPoolMutex);
+        if(this->asyncPool == nullptr){
+            this->asyncPool.reset(new llvm::ThreadPool(llvm::heavyweight_hardware_concurrency()));
+        }
+        this->asyncPool->async([=]() {
+            callback(userData, this->Translate(outVersion, src, options, internalOptions, tracingOptions, tracingOptionsCount, nullptr));
+        });
+        return true;
+    }
+
+    void TranslateBatch(CIF::Version_t outVersion,
+                        uint32_t count,
+                        CIF::Builtins::BufferSimple **srcs,
+                        CIF::Builtins::BufferSimple **options,
+                        CIF::Builtins::BufferSimple **internalOptions,
+                        uint32_t maxParallelism,
+                        OclTranslationOutputBase **outputs) const{
+        if(count == 0){
+            return;
+        }
+        CIF::Sanity::NotNullOrAbort(srcs);
+        CIF::Sanity::NotNullOrAbort(outputs);
+
+        // Load the registry keys up front rather than from every worker.
+        LoadRegistryKeys();
+
+        auto translateOne = [=](uint32_t i) {
+            outputs[i] = this->Translate(outVersion, srcs[i],
+                                         options ? options[i] : nullptr,
+                                         internalOptions ? internalOptions[i] : nullptr,
+                                         nullptr, 0, nullptr);
+        };
+
+        unsigned numThreads = (maxParallelism != 0) ? maxParallelism : llvm::heavyweight_hardware_concurrency();
+        numThreads = std::min<unsigned>(numThreads, count);
+        if(numThreads <= 1){
+            for(uint32_t i = 0; i < count; ++i){
+                translateOne(i);
+            }
+            return;
+        }
+
+        llvm::ThreadPool pool(numThreads);
+        for(uint32_t i = 0; i < count; ++i){
+            pool.async(translateOne, i);
+        }
+        pool.wait();
+    }
     
 protected:
     CIF_PIMPL(IgcOclDeviceCtx) &globalState;
     CodeType::CodeType_t inType;
     CodeType::CodeType_t outType;
+
+    // Workers for TranslateAsync, created on first use. Destroying the pool
+    // (with this object) waits for all queued translations.
+    mutable std::mutex asyncPoolMutex;
+    mutable std::unique_ptr<llvm::ThreadPool> asyncPool;
 };
 
 CIF_DEFINE_INTERFACE_TO_PIMPL_FORWARDING_CTOR_DTOR(IgcOclTranslationCtx);
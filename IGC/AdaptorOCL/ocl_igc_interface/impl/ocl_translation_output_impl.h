@@ -50,6 +50,12 @@ struct TranslationErrorType
     static constexpr ErrorCode_t UnhandledInput    = ErrorCodeCoder::Enc("E_UNH_INPUT");
 };
 
+// Deallocator for outputs produced by TranslateBuild, which allocates them with new[]
+inline void CIF_CALLING_CONV DeleteTranslationOutput(void *memory)
+{
+    delete[] static_cast<char*>(memory);
+}
+
 CIF_DECLARE_INTERFACE_PIMPL(OclTranslationOutput) : CIF::PimplBase
 {
     CIF_PIMPL_DECLARE_CONSTRUCTOR(CodeType::CodeType_t OutputType)
@@ -146,7 +152,38 @@ CIF_DECLARE_INTERFACE_PIMPL(OclTranslationOutput) : CIF::PimplBase
         return DebugData->PushBackRawBytes(data, size);
     }
 
+    /// Hands the new[]-allocated output over to the output buffer instead of
+    /// copying it; the buffer frees it with DeleteTranslationOutput
+    bool SetSuccessfulAndTakeOutput(char * data, size_t size)
+    {
+        this->Error = TranslationErrorType::Success;
+        return TakeStorage(Output.GetImpl(), data, size);
+    }
+
+    /// Same as CloneDebugData, but takes ownership of the new[]-allocated data
+    bool TakeDebugData(char * data, size_t size)
+    {
+        return TakeStorage(DebugData.GetImpl(), data, size);
+    }
+
 protected:
+    template<typename BufferT>
+    static bool TakeStorage(BufferT * buffer, char * data, size_t size)
+    {
+        if((data == nullptr) || (size == 0)){
+            delete[] data;
+            return true;
+        }
+        if(buffer->GetSizeRaw() != 0){
+            // already has contents, append to them
+            bool success = buffer->PushBackRawBytes(data, size);
+            delete[] data;
+            return success;
+        }
+        buffer->SetUnderlyingStorage(data, size, DeleteTranslationOutput);
+        return true;
+    }
+
     CIF::Multiversion<CIF::Builtins::Buffer> BuildLog;
     CIF::Multiversion<CIF::Builtins::Buffer> Output;
     CIF::Multiversion<CIF::Builtins::Buffer> DebugData;
@@ -34,7 +34,7 @@ Abstract:   Contains common patch structure definitions
 namespace iOpenCL
 {
 
-const uint32_t CURRENT_ICBE_VERSION = 1056;
+const uint32_t CURRENT_ICBE_VERSION = 1060;
 
 const uint32_t MAGIC_CL = 0x494E5443;      // 'I', 'N', 'T', 'C'
 const uint32_t INVALID_INDEX = 0xFFFFFFFF;
@@ -148,12 +148,15 @@ enum PATCH_TOKEN
     PATCH_TOKEN_INLINE_VME_SAMPLER_INFO,                           // 50	- (Unused)
     PATCH_TOKEN_GTPIN_FREE_GRF_INFO,                               // 51	@SPatchGtpinFreeGRFInfo@
     PATCH_TOKEN_GTPIN_INFO,
+    PATCH_TOKEN_PRECOMPUTED_ARGS_PROGRAM,                          // 53	@SPatchPrecomputedArgsProgram@
+    PATCH_TOKEN_INTERESTING_ARGUMENT,                              // 54	@SPatchInterestingArgument@
+    PATCH_TOKEN_SPECIALIZED_ARGUMENT,                              // 55	@SPatchSpecializedArgument@
 
     NUM_PATCH_TOKENS
 };
 
 // Update CURRENT_ICBE_VERSION when modifying the patch list
-static_assert( NUM_PATCH_TOKENS == 53, "NUM_PATCH_TOKENS has invalid value");
+static_assert( NUM_PATCH_TOKENS == 56, "NUM_PATCH_TOKENS has invalid value");
 
 /*****************************************************************************\
 ENUM: IMAGE_MEMORY_OBJECT_TYPE    
@@ -257,11 +260,12 @@ enum DATA_PARAMETER_TOKEN
     DATA_PARAMETER_STAGE_IN_GRID_SIZE,                              // 41
     DATA_PARAMETER_BUFFER_OFFSET,                                   // 42
     DATA_PARAMETER_BUFFER_STATEFUL,                                 // 43
+    DATA_PARAMETER_PRECOMPUTED_VALUE,                               // 44
     NUM_DATA_PARAMETER_TOKENS
 };
 
 // Update CURRENT_ICBE_VERSION when modifying the patch list
-static_assert( NUM_DATA_PARAMETER_TOKENS == 44, "NUM_DATA_PARAMETER_TOKENS has invalid value");
+static_assert( NUM_DATA_PARAMETER_TOKENS == 45, "NUM_DATA_PARAMETER_TOKENS has invalid value");
 
 /*****************************************************************************\
 ENUM: CONSTANT_BUFFER_TYPE
@@ -328,6 +332,23 @@ enum PROGRAM_SCOPE_KERNEL_TYPE
 // Update CURRENT_ICBE_VERSION when modifying the patch list
 static_assert( NUM_PROGRAM_SCOPE_KERNEL_TYPE == 2, "NUM_PROGRAM_SCOPE_KERNEL_TYPE has invalid value");
 
+/*****************************************************************************\
+ENUM: WALK_ORDER_HINT
+    Kind of walk recommended for the kernel, stored in bits [7:0] of
+    SPatchExecutionEnvironment::WalkOrderHint. For WALK_ORDER_HINT_TILED,
+    bits [15:8] hold the tile height in work items.
+\*****************************************************************************/
+enum WALK_ORDER_HINT
+{
+    WALK_ORDER_HINT_NONE,
+    WALK_ORDER_HINT_LINEAR,
+    WALK_ORDER_HINT_TILED,
+    NUM_WALK_ORDER_HINT
+};
+
+// Update CURRENT_ICBE_VERSION when modifying the patch list
+static_assert( NUM_WALK_ORDER_HINT == 3, "NUM_WALK_ORDER_HINT has invalid value");
+
 /*****************************************************************************\
 STRUCT: SPatchItemHeader
 \*****************************************************************************/
@@ -207,11 +207,12 @@ struct SPatchExecutionEnvironment :
     uint32_t    NumGRFRequired;
 	uint32_t    WorkgroupWalkOrderDims; // dim0 : [0 : 1]; dim1 : [2 : 3]; dim2 : [4 : 5]
     uint32_t    HasGlobalAtomics;
-    uint32_t    reserved;
+    uint32_t    WalkOrderHint; // kind : [0 : 7] (WALK_ORDER_HINT); tile height : [8 : 15]
+    uint32_t    WorkGroupCombineFactor; // 1 or the number of work groups packed into one hardware thread group
 };
 
 // Update CURRENT_ICBE_VERSION when modifying the patch list
-static_assert(sizeof(SPatchExecutionEnvironment) == (92 + sizeof(SPatchItemHeader)), "The size of SPatchExecutionEnvironment is not what is expected");
+static_assert(sizeof(SPatchExecutionEnvironment) == (96 + sizeof(SPatchItemHeader)), "The size of SPatchExecutionEnvironment is not what is expected");
 
 /*****************************************************************************\
 STRUCT: SPatchString
@@ -540,6 +541,56 @@ struct SPatchGtpinFreeGRFInfo :
 // Update CURRENT_ICBE_VERSION when modifying the patch list
 static_assert(sizeof(SPatchGtpinFreeGRFInfo) == (4 + sizeof(SPatchItemHeader)), "The size of SPatchGtpinFreeGRFInfo is not what is expected");
 
+/*****************************************************************************\
+STRUCT: SPatchPrecomputedArgsProgram
+    Followed by ProgramSize bytes of LLVM bitcode defining
+    void PrecomputeArgs(<explicit kernel args>..., i32* values). The runtime
+    evaluates it once per enqueue and writes values[ArgumentNumber] to every
+    DATA_PARAMETER_PRECOMPUTED_VALUE of the kernel.
+\*****************************************************************************/
+struct SPatchPrecomputedArgsProgram :
+    SPatchItemHeader
+{
+    uint32_t   NumValues;
+    uint32_t   ProgramSize;
+};
+
+// Update CURRENT_ICBE_VERSION when modifying the patch list
+static_assert(sizeof(SPatchPrecomputedArgsProgram) == (8 + sizeof(SPatchItemHeader)), "The size of SPatchPrecomputedArgsProgram is not what is expected");
+
+/*****************************************************************************\
+STRUCT: SPatchInterestingArgument
+    Explicit argument whose value would let a specialized variant of the
+    kernel fold significant code: any fixed value when AnyValue is set,
+    otherwise only Value.
+\*****************************************************************************/
+struct SPatchInterestingArgument :
+    SPatchItemHeader
+{
+    uint32_t   ArgumentNumber;
+    uint32_t   DataSize;
+    uint32_t   AnyValue;
+    uint32_t   Value;
+};
+
+// Update CURRENT_ICBE_VERSION when modifying the patch list
+static_assert(sizeof(SPatchInterestingArgument) == (16 + sizeof(SPatchItemHeader)), "The size of SPatchInterestingArgument is not what is expected");
+
+/*****************************************************************************\
+STRUCT: SPatchSpecializedArgument
+    Explicit argument folded to Value in this kernel binary. The binary
+    must not be enqueued with a different value for it.
+\*****************************************************************************/
+struct SPatchSpecializedArgument :
+    SPatchItemHeader
+{
+    uint32_t   ArgumentNumber;
+    uint32_t   Value;
+};
+
+// Update CURRENT_ICBE_VERSION when modifying the patch list
+static_assert(sizeof(SPatchSpecializedArgument) == (8 + sizeof(SPatchItemHeader)), "The size of SPatchSpecializedArgument is not what is expected");
+
 
 } // namespace
 #pragma pack( pop )
@@ -25,6 +25,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 ======================= end_copyright_notice ==================================*/
 
  extern __constant int __UseNative64BitSubgroupBuiltin;
+ extern __constant int __UseNativeWorkGroupReduceScan;
 
 // Group Instructions
 
@@ -1425,6 +1426,70 @@ static double   OVERLOADABLE __intel_add(double lhs, double rhs) { return lhs +
     return X;                                                           				 \
 }
 
+// Two-level work group collectives: each sub-group reduces/scans in registers with the
+// native sub-group builtins, then one value per sub-group is combined through SLM.
+#define DEFN_WORK_GROUP_REDUCE_NATIVE(func, type, type_abbr, op, identity, X)              \
+{                                                                                        \
+    GET_MEMPOOL_PTR(data, type, true, 0)                                                 \
+    uint sgid = __builtin_spirv_BuiltInSubgroupId();                                     \
+    uint numsg = __builtin_spirv_BuiltInNumSubgroups();                                  \
+    type sgX = __builtin_IB_sub_group_reduce_##func##_##type_abbr(X);                      \
+    if (__builtin_spirv_BuiltInSubgroupLocalInvocationId() == 0)                         \
+    {                                                                                    \
+        data[sgid] = sgX;                                                                \
+    }                                                                                    \
+    __builtin_spirv_OpControlBarrier_i32_i32_i32(Workgroup, 0, AcquireRelease | WorkgroupMemory);         \
+    type ret = identity;                                                                 \
+    for (uint i = 0; i < numsg; ++i)                                                     \
+    {                                                                                    \
+        ret = op(ret, data[i]);                                                          \
+    }                                                                                    \
+    __builtin_spirv_OpControlBarrier_i32_i32_i32(Workgroup, 0, AcquireRelease | WorkgroupMemory);         \
+    return ret;                                                                          \
+}
+
+#define DEFN_WORK_GROUP_SCAN_NATIVE(func, type, type_abbr, op, identity, X, inclusive)     \
+{                                                                                        \
+    GET_MEMPOOL_PTR(data, type, true, 0)                                                 \
+    uint sgid = __builtin_spirv_BuiltInSubgroupId();                                     \
+    type sgX = __builtin_IB_sub_group_reduce_##func##_##type_abbr(X);                      \
+    type sgScan = __builtin_IB_sub_group_scan_##func##_##type_abbr(X);                     \
+    if (inclusive)                                                                       \
+    {                                                                                    \
+        sgScan = op(X, sgScan);                                                          \
+    }                                                                                    \
+    if (__builtin_spirv_BuiltInSubgroupLocalInvocationId() == 0)                         \
+    {                                                                                    \
+        data[sgid] = sgX;                                                                \
+    }                                                                                    \
+    __builtin_spirv_OpControlBarrier_i32_i32_i32(Workgroup, 0, AcquireRelease | WorkgroupMemory);         \
+    type prefix = identity;                                                              \
+    for (uint i = 0; i < sgid; ++i)                                                      \
+    {                                                                                    \
+        prefix = op(prefix, data[i]);                                                    \
+    }                                                                                    \
+    __builtin_spirv_OpControlBarrier_i32_i32_i32(Workgroup, 0, AcquireRelease | WorkgroupMemory);         \
+    return op(prefix, sgScan);                                                           \
+}
+
+#define WORK_GROUP_SWITCH_NATIVE(func, type, type_abbr, op, identity, X, Operation)        \
+{                                                                                        \
+    switch(Operation){                                                                   \
+        case GroupOperationReduce:                                                       \
+            DEFN_WORK_GROUP_REDUCE_NATIVE(func, type, type_abbr, op, identity, X)        \
+            break;                                                                       \
+        case GroupOperationInclusiveScan:                                                \
+            DEFN_WORK_GROUP_SCAN_NATIVE(func, type, type_abbr, op, identity, X, true)    \
+            break;                                                                       \
+        case GroupOperationExclusiveScan:                                                \
+            DEFN_WORK_GROUP_SCAN_NATIVE(func, type, type_abbr, op, identity, X, false)   \
+            break;                                                                       \
+        default:                                                                         \
+            return 0;                                                                    \
+            break;                                                                       \
+    }                                                                                    \
+}
+
 #define DEFN_SUB_GROUP_REDUCE(type, type_abbr, op, identity, X)    						 \
 {																						 \
 	uint sgsize = __builtin_spirv_BuiltInSubgroupSize();                                 \
@@ -1581,6 +1646,11 @@ type  __builtin_spirv_##func##_i32_i32_##type_abbr(uint Execution, uint Operatio
 {                                                                                                \
     if (Execution == Workgroup)                                                                  \
     {                                                                                            \
+        if (__UseNativeWorkGroupReduceScan &&                                                    \
+            (sizeof(X) < 8 || __UseNative64BitSubgroupBuiltin))                                  \
+        {                                                                                        \
+            WORK_GROUP_SWITCH_NATIVE(func, type, type_abbr, op, identity, X, Operation)          \
+        }                                                                                        \
         WORK_GROUP_SWITCH(type, op, identity, X, Operation)                                      \
     }                                                                                            \
     else if (Execution == Subgroup)                                                              \
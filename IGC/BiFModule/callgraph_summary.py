@@ -0,0 +1,94 @@
+#===================== begin_copyright_notice ==================================
+
+#Copyright (c) 2017 Intel Corporation
+
+#Permission is hereby granted, free of charge, to any person obtaining a
+#copy of this software and associated documentation files (the
+#"Software"), to deal in the Software without restriction, including
+#without limitation the rights to use, copy, modify, merge, publish,
+#distribute, sublicense, and/or sell copies of the Software, and to
+#permit persons to whom the Software is furnished to do so, subject to
+#the following conditions:
+
+#The above copyright notice and this permission notice shall be included
+#in all copies or substantial portions of the Software.
+
+#THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+#OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+#MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+#IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+#CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+#TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+#SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#======================= end_copyright_notice ==================================
+
+import os
+import re
+import sys
+
+
+
+# Writes the direct call graph of a disassembled BiF module (.ll) in the format
+# read by IGC::BiFCallGraphSummary: one line per defined function, the function
+# name followed by the names of the functions it calls directly.
+
+def PrintHelp():
+    sys.stdout.write('Usage: {0} <input .ll file> <output file>\n'.format(os.path.basename(__file__)))
+    sys.stdout.write('\n')
+    sys.stdout.write('    <input .ll file> - Disassembled BiF module.\n')
+    sys.stdout.write('    <output file>    - Path to output call graph summary.\n')
+
+
+
+nameRe   = r'@("[^"]+"|[-a-zA-Z$._0-9]+)\('
+defineRe = re.compile(r'^define\b[^@]*' + nameRe)
+# Only direct calls: a call through a bitcast has a constant expression
+# (and hence a '(') between the call and the callee name.
+callRe   = re.compile(r'\bcall\b[^@(]*(?:\((?:[^@()]|\([^@()]*\))*\)\*?\s*)?' + nameRe)
+
+
+
+if len(sys.argv) < 3:
+    PrintHelp()
+    exit(0)
+for arg in sys.argv:
+    if arg == '-h' or arg == '--help':
+        PrintHelp()
+        exit(0)
+
+try:
+    inFile = open(sys.argv[1], 'r')
+except EnvironmentError as ex:
+    sys.stderr.write('ERROR: Cannot open input file "{0}".\n       {1}.\n'.format(sys.argv[1], ex.strerror))
+    exit(1)
+
+callGraph = []
+callees   = None
+with inFile:
+    for line in inFile:
+        if callees is None:
+            match = defineRe.match(line)
+            if match:
+                callees = []
+                callGraph.append((match.group(1).strip('"'), callees))
+            continue
+        if line.startswith('}'):
+            callees = None
+            continue
+        match = callRe.search(line)
+        if match:
+            callee = match.group(1).strip('"')
+            if not callee.startswith('llvm.') and callee not in callees:
+                callees.append(callee)
+
+try:
+    outFile = open(sys.argv[2], 'w')
+except EnvironmentError as ex:
+    sys.stderr.write('ERROR: Cannot create/open output file "{0}".\n       {1}.\n'.format(sys.argv[2], ex.strerror))
+    exit(1)
+
+with outFile:
+    for caller, callees in callGraph:
+        outFile.write(' '.join([caller] + callees) + '\n')
@@ -0,0 +1,305 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/Pass.h>
+#include "common/LLVMWarningsPop.hpp"
+#include "GenISAIntrinsics/GenIntrinsicInst.h"
+#include "Compiler/CISACodeGen/BarrierElision.h"
+#include "Compiler/CISACodeGen/ShaderCodeGen.hpp"
+#include "Compiler/CISACodeGen/helper.h"
+#include "Compiler/IGCPassSupport.h"
+#include "Compiler/MetaDataUtilsWrapper.h"
+
+using namespace llvm;
+using namespace IGC;
+
+namespace {
+
+/// Per-instruction view of which memory an access may touch.
+struct MemAccess {
+  bool global = false; // global, constant, stateful or generic memory
+  bool slm = false;    // shared local memory (or generic)
+  bool write = false;
+
+  bool any() const { return global || slm; }
+};
+
+class BarrierElision : public FunctionPass {
+public:
+  static char ID;
+
+  BarrierElision() : FunctionPass(ID) {}
+
+  bool runOnFunction(Function &F) override;
+
+  StringRef getPassName() const override { return "Barrier Elision"; }
+
+private:
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.setPreservesCFG();
+    AU.addRequired<MetaDataUtilsWrapper>();
+  }
+
+  // Operand positions of GenISA_memoryfence.
+  enum FenceOp {
+    FENCE_COMMIT = 0,
+    FENCE_GLOBAL = 5,
+    FENCE_NUM_OPS = 7
+  };
+
+  static bool isBarrier(const Instruction *I);
+  static bool isFence(const Instruction *I);
+  static bool hasConstantFlags(const GenIntrinsicInst *Fence);
+  static bool covers(const GenIntrinsicInst *A, const GenIntrinsicInst *B);
+  static MemAccess getAccess(Instruction *I);
+
+  bool weakenFence(GenIntrinsicInst *Fence) const;
+  bool runOnBlock(BasicBlock &BB);
+
+  // Fences may only be weakened in kernels, since a callee's fence can order
+  // accesses made by its caller.
+  bool CanWeaken = false;
+
+  // Summary of the memory accesses made by the whole function.
+  MemAccess FuncAccess;
+  bool FuncWritesGlobal = false;
+  bool FuncWritesSLM = false;
+};
+
+char BarrierElision::ID = 0;
+
+} // End anonymous namespace
+
+FunctionPass *IGC::createBarrierElisionPass() {
+  return new BarrierElision();
+}
+
+#define PASS_FLAG     "igc-barrier-elision"
+#define PASS_DESC     "Redundant barrier and fence elision"
+#define PASS_CFG_ONLY true
+#define PASS_ANALYSIS false
+namespace IGC {
+IGC_INITIALIZE_PASS_BEGIN(BarrierElision, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
+IGC_INITIALIZE_PASS_END(BarrierElision, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+} // End namespace IGC
+
+bool BarrierElision::isBarrier(const Instruction *I) {
+  if (auto GII = dyn_cast<GenIntrinsicInst>(I))
+    return GII->getIntrinsicID() == GenISAIntrinsic::GenISA_threadgroupbarrier;
+  return false;
+}
+
+bool BarrierElision::isFence(const Instruction *I) {
+  if (auto GII = dyn_cast<GenIntrinsicInst>(I))
+    return GII->getIntrinsicID() == GenISAIntrinsic::GenISA_memoryfence;
+  return false;
+}
+
+bool BarrierElision::hasConstantFlags(const GenIntrinsicInst *Fence) {
+  for (unsigned i = 0; i < FENCE_NUM_OPS; ++i)
+    if (!isa<ConstantInt>(Fence->getOperand(i)))
+      return false;
+  return true;
+}
+
+/// Return true if every flag set on fence B is also set on fence A.
+bool BarrierElision::covers(const GenIntrinsicInst *A,
+                            const GenIntrinsicInst *B) {
+  for (unsigned i = 0; i < FENCE_NUM_OPS; ++i) {
+    bool a = cast<ConstantInt>(A->getOperand(i))->isOne();
+    bool b = cast<ConstantInt>(B->getOperand(i))->isOne();
+    if (b && !a)
+      return false;
+  }
+  return true;
+}
+
+static void addAddressSpace(MemAccess &MA, unsigned AS) {
+  switch (AS) {
+  case ADDRESS_SPACE_PRIVATE:
+    break;
+  case ADDRESS_SPACE_LOCAL:
+    MA.slm = true;
+    break;
+  case ADDRESS_SPACE_GENERIC:
+    MA.slm = true;
+    MA.global = true;
+    break;
+  default:
+    MA.global = true;
+    break;
+  }
+}
+
+MemAccess BarrierElision::getAccess(Instruction *I) {
+  MemAccess MA;
+  if (!I->mayReadOrWriteMemory() || isBarrier(I) || isFence(I))
+    return MA;
+
+  if (auto LI = dyn_cast<LoadInst>(I)) {
+    addAddressSpace(MA, LI->getPointerAddressSpace());
+  } else if (auto SI = dyn_cast<StoreInst>(I)) {
+    addAddressSpace(MA, SI->getPointerAddressSpace());
+    MA.write = true;
+  } else if (auto RMW = dyn_cast<AtomicRMWInst>(I)) {
+    addAddressSpace(MA, RMW->getPointerAddressSpace());
+    MA.write = true;
+  } else if (auto CX = dyn_cast<AtomicCmpXchgInst>(I)) {
+    addAddressSpace(MA, CX->getPointerAddressSpace());
+    MA.write = true;
+  } else if (auto GII = dyn_cast<GenIntrinsicInst>(I)) {
+    // Classify by the first pointer operand; intrinsics without one (e.g.
+    // typed or bindless surface accesses) are treated as global.
+    bool found = false;
+    for (unsigned i = 0, e = GII->getNumArgOperands(); i < e; ++i) {
+      if (auto PtrTy = dyn_cast<PointerType>(GII->getArgOperand(i)->getType())) {
+        addAddressSpace(MA, PtrTy->getAddressSpace());
+        found = true;
+        break;
+      }
+    }
+    if (!found)
+      MA.global = true;
+    MA.write = GII->mayWriteToMemory();
+  } else {
+    // Calls and anything else we do not model: assume the worst.
+    MA.global = true;
+    MA.slm = true;
+    MA.write = I->mayWriteToMemory();
+  }
+  return MA;
+}
+
+/// Drop fence flags that order nothing in this function: the global flag
+/// when only SLM (or private) memory is accessed, and the commit flag when
+/// nothing the fence covers is ever written.
+bool BarrierElision::weakenFence(GenIntrinsicInst *Fence) const {
+  bool Changed = false;
+  LLVMContext &Ctx = Fence->getContext();
+  bool isGlobal = cast<ConstantInt>(Fence->getOperand(FENCE_GLOBAL))->isOne();
+  if (isGlobal && !FuncAccess.global) {
+    Fence->setOperand(FENCE_GLOBAL, ConstantInt::getFalse(Ctx));
+    isGlobal = false;
+    Changed = true;
+  }
+
+  bool isCommit = cast<ConstantInt>(Fence->getOperand(FENCE_COMMIT))->isOne();
+  bool hasWrites = FuncWritesSLM || (isGlobal && FuncWritesGlobal);
+  if (isCommit && !hasWrites) {
+    Fence->setOperand(FENCE_COMMIT, ConstantInt::getFalse(Ctx));
+    Changed = true;
+  }
+  return Changed;
+}
+
+bool BarrierElision::runOnBlock(BasicBlock &BB) {
+  bool Changed = false;
+  // The last barrier / fence with no memory access after it, if any.
+  Instruction *LastBarrier = nullptr;
+  GenIntrinsicInst *LastFence = nullptr;
+
+  for (auto II = BB.begin(), IE = BB.end(); II != IE;) {
+    Instruction *I = &*II++;
+
+    if (isBarrier(I)) {
+      if (LastBarrier) {
+        // Nothing was done since the previous barrier: all threads are
+        // already in lock step.
+        I->eraseFromParent();
+        Changed = true;
+        continue;
+      }
+      LastBarrier = I;
+      // A fence before the barrier orders the accesses other threads wait
+      // for there; a later fence cannot stand in for it.
+      LastFence = nullptr;
+      continue;
+    }
+
+    if (isFence(I)) {
+      auto Fence = cast<GenIntrinsicInst>(I);
+      if (!hasConstantFlags(Fence)) {
+        LastFence = nullptr;
+        continue;
+      }
+      if (CanWeaken)
+        Changed |= weakenFence(Fence);
+      if (LastFence && covers(LastFence, Fence)) {
+        Fence->eraseFromParent();
+        Changed = true;
+        continue;
+      }
+      if (LastFence && covers(Fence, LastFence)) {
+        LastFence->eraseFromParent();
+        Changed = true;
+      }
+      LastFence = Fence;
+      // The next barrier is what makes this fence visible to other threads.
+      LastBarrier = nullptr;
+      continue;
+    }
+
+    if (getAccess(I).any() || (isa<CallInst>(I) && !isa<IntrinsicInst>(I) &&
+                               !isa<GenIntrinsicInst>(I))) {
+      // Any memory access, or a call that may itself synchronize, starts a
+      // new region that needs its own barrier and fence.
+      LastBarrier = nullptr;
+      LastFence = nullptr;
+    }
+  }
+  return Changed;
+}
+
+bool BarrierElision::runOnFunction(Function &F) {
+  FuncAccess = MemAccess();
+  FuncWritesGlobal = false;
+  FuncWritesSLM = false;
+
+  auto MDU = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+  CanWeaken = isEntryFunc(MDU, &F);
+
+  bool HasSync = false;
+  for (auto &BB : F) {
+    for (auto &I : BB) {
+      HasSync |= isBarrier(&I) || isFence(&I);
+      MemAccess MA = getAccess(&I);
+      FuncAccess.global |= MA.global;
+      FuncAccess.slm |= MA.slm;
+      FuncWritesGlobal |= MA.write && MA.global;
+      FuncWritesSLM |= MA.write && MA.slm;
+    }
+  }
+  if (!HasSync)
+    return false;
+
+  bool Changed = false;
+  for (auto &BB : F)
+    Changed |= runOnBlock(BB);
+  return Changed;
+}
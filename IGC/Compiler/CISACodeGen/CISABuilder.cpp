@@ -32,6 +32,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/Types.hpp"
 #include "common/Stats.hpp"
 #include "common/MemStats.h"
+#include "common/debug/Debug.hpp"
 #include "common/debug/Dump.hpp"
 #include "common/igc_regkeys.hpp"
 #include "common/secure_mem.h"
@@ -3469,6 +3470,23 @@ void CEncoder::InitEncoder( bool canAbortOnSpill )
         params.push_back(High);
     }
 
+    const char* profileDir = IGC_GET_REGKEYSTRING(ProfileFeedbackDir);
+    if (profileDir && profileDir[0] != '\0')
+    {
+        // Per-BB counts collected by an instrumented (GTPin) run of this shader,
+        // one file per shader hash and SIMD width since BB ids differ between them.
+        char profileFile[MAX_PATH];
+        sprintf_s(profileFile, sizeof(profileFile), "%s/%016llx_simd%d.prof",
+            profileDir, (unsigned long long)context->hash.getAsmHash(), numLanes(m_program->m_dispatchSize));
+        if (FILE* fp = fopen(profileFile, "r"))
+        {
+            fclose(fp);
+            params.push_back("-profileFeedback");
+            // params are only read when the builder is created, see above.
+            params.push_back(_strdup(profileFile));
+        }
+    }
+
     SetVISAWaTable(m_program->m_Platform->getWATable());
 
     bool enableVISADump = IGC_IS_FLAG_ENABLED(EnableVISASlowpath) || IGC_IS_FLAG_ENABLED(ShaderDumpEnable);
@@ -3520,7 +3538,9 @@ void CEncoder::InitEncoder( bool canAbortOnSpill )
             return false;
         if (context->type == ShaderType::OPENCL_SHADER) {
             auto ClContext = static_cast<OpenCLProgramContext*>(context);
-            if (!ClContext->m_InternalOptions.IntelEnablePreRAScheduling)
+            if (!ClContext->m_InternalOptions.IntelEnablePreRAScheduling ||
+                ClContext->m_InternalOptions.FastCompile ||
+                ClContext->m_compileTimeBudget.Degrade(CompileTimeBudget::STEP_NO_PRERA_SCHEDULING))
                 return false;
         }
 
@@ -3559,17 +3579,53 @@ void CEncoder::InitEncoder( bool canAbortOnSpill )
         vbuilder->SetOption(vISA_preRA_Schedule, false);
     }
 
-    if (IGC_IS_FLAG_ENABLED(FastSpill))
+    if (IGC_IS_FLAG_ENABLED(FastSpill) ||
+        context->getModuleMetaData()->compOpt.FastCompile)
     {
         vbuilder->SetOption(vISA_FastSpill, true);
     }
 
+    if (context->type == ShaderType::OPENCL_SHADER)
+    {
+        // Cheaper RA, control flow and scheduling once the compile-time
+        // budget is (nearly) used up.
+        auto &budget = static_cast<OpenCLProgramContext*>(context)->m_compileTimeBudget;
+        if (budget.Degrade(CompileTimeBudget::STEP_FAST_RA))
+        {
+            vbuilder->SetOption(vISA_FastSpill, true);
+        }
+        if (budget.Degrade(CompileTimeBudget::STEP_NO_STRUCTURIZER))
+        {
+            vbuilder->SetOption(vISA_EnableStructurizer, false);
+        }
+        if (budget.Degrade(CompileTimeBudget::STEP_NO_POSTRA_SCHEDULING))
+        {
+            vbuilder->SetOption(vISA_LocalScheduling, false);
+        }
+    }
+
     vbuilder->SetOption(vISA_NoVerifyvISA, true);
 
+    if (IGC_IS_FLAG_ENABLED(EnableStaticCycleEstimate))
+    {
+        vbuilder->SetOption(vISA_EstimateCycles, true);
+    }
+
     if (context->m_instrTypes.hasDebugInfo)
     {
         vbuilder->SetOption(vISA_GenerateDebugInfo, true);
     }
+    else if (IGC_IS_FLAG_ENABLED(EnableStreamingCodeGen))
+    {
+        vbuilder->SetOption(vISA_StreamFinalize, true);
+    }
+
+    if (IGC_GET_FLAG_VALUE(VISAEncodeThreads) > 1)
+    {
+        // only separately linked stack functions can be encoded in parallel
+        vbuilder->SetOption(vISA_LinkStackFuncs, true);
+        vbuilder->SetOption(vISA_EncodeThreads, IGC_GET_FLAG_VALUE(VISAEncodeThreads));
+    }
 
     if (canAbortOnSpill)
     {
@@ -3637,6 +3693,16 @@ void CEncoder::InitEncoder( bool canAbortOnSpill )
         vbuilder->SetOption(vISA_StructurizeCF, false);
     }
 
+    if (IGC_GET_FLAG_VALUE(VISAStructurizerMaxBBs) != 0)
+    {
+        vbuilder->SetOption(vISA_StructurizerMaxBBs, IGC_GET_FLAG_VALUE(VISAStructurizerMaxBBs));
+    }
+
+    if (IGC_IS_FLAG_ENABLED(EnableIPACallerSave))
+    {
+        vbuilder->SetOption(vISA_IPACallerSave, true);
+    }
+
     if (IGC_IS_FLAG_DISABLED(EnableVISAJmpi))
     {
         vbuilder->SetOption(vISA_EnableScalarJmp, false);
@@ -3696,6 +3762,10 @@ void CEncoder::InitEncoder( bool canAbortOnSpill )
     {
         vbuilder->SetOption(vISA_Compaction, false);
     }
+    else if (IGC_IS_FLAG_ENABLED(EnableCompactionRewrite))
+    {
+        vbuilder->SetOption(vISA_CompactionRewrite, true);
+    }
 
     // In Vulkan and OGL buffer variable memory reads and writes within
     // a single shader invocation must be processed in order.
@@ -3775,6 +3845,10 @@ void CEncoder::InitEncoder( bool canAbortOnSpill )
     {
         vbuilder->SetOption(vISA_enableBCR, true);
     }
+    if (IGC_IS_FLAG_ENABLED(EnableGlobalBankVotes))
+    {
+        vbuilder->SetOption(vISA_GlobalBankVotes, true);
+    }
     if (IGC_IS_FLAG_ENABLED(forceSamplerHeader))
     {
         vbuilder->SetOption(vISA_forceSamplerHeader, true);
@@ -3807,6 +3881,10 @@ void CEncoder::InitEncoder( bool canAbortOnSpill )
         {
             vbuilder->SetOption(vISA_accSubMadm, true);
         }
+        if (IGC_IS_FLAG_ENABLED(EnableMultiAccSub))
+        {
+            vbuilder->SetOption(vISA_multiAccSub, true);
+        }
     }
     else
     {
@@ -4181,9 +4259,6 @@ void CEncoder::Compile()
 {
     COMPILER_TIME_START(m_program->GetContext(), TIME_CG_vISAEmitPass);
 
-    CodeGenContext* context = m_program->GetContext();
-    SProgramOutput* pOutput = m_program->ProgramOutput();
-
     if( m_program->m_dispatchSize == SIMDMode::SIMD8 )
     {
         MEM_SNAPSHOT( IGC::SMS_AFTER_CISACreateDestroy_SIMD8 );
@@ -4200,10 +4275,24 @@ void CEncoder::Compile()
     COMPILER_TIME_END(m_program->GetContext(), TIME_CG_vISAEmitPass);
 
     COMPILER_TIME_START(m_program->GetContext(), TIME_CG_vISACompile);
+    CompileVISA();
+    COMPILER_TIME_END(m_program->GetContext(), TIME_CG_vISACompile);
+
+#if GET_TIME_STATS
+    // handle the vISA time counters differently here
+    if (m_program->GetContext()->m_compilerTimeStats)
+    {
+        m_program->GetContext()->m_compilerTimeStats->recordVISATimers();
+    }
+#endif
 
+    FinishCompile();
+}
+
+void CEncoder::CompileVISA()
+{
     //Compile to generate the V-ISA binary
     //TARGET_PLATFORM VISAPlatform = GetVISAPlatform(m_Platform);
-    int vIsaCompile = 0;
     if( m_enableVISAdump )
     {
         std::string isaName = IGC::Debug::GetDumpName(m_program, "isa");
@@ -4217,12 +4306,45 @@ void CEncoder::Compile()
         {
             isaName.resize(MAX_VISA_STRING_LENGTH);
         }
-        vIsaCompile = vbuilder->Compile(const_cast<char*>(isaName.c_str()));
+        m_vIsaCompileStatus = vbuilder->Compile(const_cast<char*>(isaName.c_str()));
     }
     else
     {
-        vIsaCompile = vbuilder->Compile("");
+        m_vIsaCompileStatus = vbuilder->Compile("");
+    }
+}
+
+void CEncoder::CompileVISAOnWorkerThread()
+{
+#if GET_TIME_STATS
+    // The vISA timers are per thread and not reset between the compiles a
+    // pool thread runs, so keep only what this compile added.
+    std::vector<int64_t> ticks = TimeStats::getVISATimerTicks();
+    CompileVISA();
+    m_workerVISATimerTicks = TimeStats::getVISATimerTicks();
+    for (unsigned i = 0; i < ticks.size() && i < m_workerVISATimerTicks.size(); i++)
+    {
+        m_workerVISATimerTicks[i] -= ticks[i];
     }
+#else
+    CompileVISA();
+#endif
+}
+
+void CEncoder::FinishCompile()
+{
+    CodeGenContext* context = m_program->GetContext();
+    SProgramOutput* pOutput = m_program->ProgramOutput();
+    int vIsaCompile = m_vIsaCompileStatus;
+
+#if GET_TIME_STATS
+    if (context->m_compilerTimeStats && !m_workerVISATimerTicks.empty())
+    {
+        context->m_compilerTimeStats->recordVISATimers(m_workerVISATimerTicks);
+    }
+    m_workerVISATimerTicks.clear();
+#endif
+
     FINALIZER_INFO *jitInfo;
     vMainKernel->GetJitInfo(jitInfo);
     if(jitInfo->isSpill)
@@ -4234,15 +4356,17 @@ void CEncoder::Compile()
 
         context->m_retryManager.numInstructions = jitInfo->numAsmCount;
     }
-    COMPILER_TIME_END(m_program->GetContext(), TIME_CG_vISACompile);
 
-#if GET_TIME_STATS
-    // handle the vISA time counters differently here
-    if (context->m_compilerTimeStats)
+    if (IGC_IS_FLAG_ENABLED(LogSpillPrediction) && m_program->m_spillPrediction >= 0)
     {
-        context->m_compilerTimeStats->recordVISATimers();
+        bool spilled = jitInfo->isSpill || vIsaCompile == -3;
+        IGC::Debug::ods() << "SpillPrediction: " << m_program->entry->getName()
+            << " SIMD" << numLanes(m_program->m_dispatchSize)
+            << " estimate=" << m_program->m_spillPredictionGRF
+            << " predicted=" << m_program->m_spillPrediction
+            << " actual=" << (spilled ? 1 : 0)
+            << " spillFill=" << jitInfo->numGRFSpillFill << "\n";
     }
-#endif
 
     if( vIsaCompile == -1 )
     {
@@ -4305,17 +4429,26 @@ void CEncoder::Compile()
     {
         COMPILER_SHADER_STATS_SET(m_program->m_shaderStats, STATS_ISA_INST_COUNT, jitInfo->numAsmCount);
         COMPILER_SHADER_STATS_SET(m_program->m_shaderStats, STATS_ISA_SPILL8, (int)jitInfo->isSpill);
+        COMPILER_SHADER_STATS_SET(m_program->m_shaderStats, STATS_ISA_GRF_USED8, jitInfo->numGRFUsed);
     }
     else if( m_program->m_dispatchSize == SIMDMode::SIMD16 )
     {
         COMPILER_SHADER_STATS_SET(m_program->m_shaderStats, STATS_ISA_INST_COUNT_SIMD16, jitInfo->numAsmCount);
         COMPILER_SHADER_STATS_SET(m_program->m_shaderStats, STATS_ISA_SPILL16, (int)jitInfo->isSpill);
+        COMPILER_SHADER_STATS_SET(m_program->m_shaderStats, STATS_ISA_GRF_USED16, jitInfo->numGRFUsed);
     }
     else if( m_program->m_dispatchSize == SIMDMode::SIMD32 )
     {
         COMPILER_SHADER_STATS_SET(m_program->m_shaderStats, STATS_ISA_INST_COUNT_SIMD32, jitInfo->numAsmCount);
         COMPILER_SHADER_STATS_SET(m_program->m_shaderStats, STATS_ISA_SPILL32, (int)jitInfo->isSpill);
+        COMPILER_SHADER_STATS_SET(m_program->m_shaderStats, STATS_ISA_GRF_USED32, jitInfo->numGRFUsed);
+    }
+    if (jitInfo->isSpill)
+    {
+        COMPILER_SHADER_STATS_SET(m_program->m_shaderStats, STATS_ISA_SPILL_FILL, jitInfo->numGRFSpillFill);
+        COMPILER_SHADER_STATS_SET(m_program->m_shaderStats, STATS_ISA_SPILL_BYTES, jitInfo->spillMemUsed);
     }
+    COMPILER_SHADER_STATS_SET(m_program->m_shaderStats, STATS_ISA_COMPACTED, jitInfo->numCompactedInst);
 #endif
 
     void* genxbin = nullptr;
@@ -4403,6 +4536,16 @@ void CEncoder::Compile()
     pOutput->m_debugDataGenISA = dbgInfo;
     pOutput->m_debugDataGenISASize = dbgSize;
     pOutput->m_InstructionCount = jitInfo->numAsmCount;
+    pOutput->m_peakVISAIRMemoryKB = jitInfo->peakIRArenaKB;
+    pOutput->m_peakVISARAMemoryKB = jitInfo->peakRAArenaKB;
+    pOutput->m_peakVISAPostRAMemoryKB = jitInfo->peakPostRAArenaKB;
+    pOutput->m_numGRFUsed = jitInfo->numGRFUsed;
+    pOutput->m_numSamplerSends = jitInfo->numSamplerSends;
+    pOutput->m_numDataPortSends = jitInfo->numDataPortSends;
+    pOutput->m_numOtherSends = jitInfo->numOtherSends;
+    pOutput->m_numEstimatedCycles = jitInfo->numEstimatedCycles;
+    MEM_FINALIZER_PEAKS(numLanes(m_program->m_dispatchSize),
+        jitInfo->peakIRArenaKB, jitInfo->peakRAArenaKB, jitInfo->peakPostRAArenaKB);
 
     vMainKernel->GetGTPinBuffer(pOutput->m_gtpinBuffer, pOutput->m_gtpinBufferSize);
 
@@ -5205,34 +5348,34 @@ void CEncoder::SetVISAWaTable(WA_TABLE const& waTable)
 {
     //Copy from driver WA table to VISA WA table
 
-    m_WaTable.WaHeaderRequiredOnSimd16Sample16bit = waTable.WaHeaderRequiredOnSimd16Sample16bit;
-    m_WaTable.WaSendsSrc1SizeLimitWhenEOT = waTable.WaSendsSrc1SizeLimitWhenEOT;
-    m_WaTable.WaDisallow64BitImmMov = waTable.WaDisallow64BitImmMov;
-    m_WaTable.WaThreadSwitchAfterCall = waTable.WaThreadSwitchAfterCall;
-    m_WaTable.WaSrc1ImmHfNotAllowed = waTable.WaSrc1ImmHfNotAllowed;
-    m_WaTable.WaDstSubRegNumNotAllowedWithLowPrecPacked = waTable.WaDstSubRegNumNotAllowedWithLowPrecPacked;
-    m_WaTable.WaDisableMixedModeLog = waTable.WaDisableMixedModeLog;
-    m_WaTable.WaDisableMixedModeFdiv = waTable.WaDisableMixedModeFdiv;
-    m_WaTable.WaDisableMixedModePow = waTable.WaDisableMixedModePow;
-    m_WaTable.WaFloatMixedModeSelNotAllowedWithPackedDestination = waTable.WaFloatMixedModeSelNotAllowedWithPackedDestination;
-    m_WaTable.WADisableWriteCommitForPageFault = waTable.WADisableWriteCommitForPageFault;
+    VISA_WA_SET(&m_WaTable, WaHeaderRequiredOnSimd16Sample16bit, waTable.WaHeaderRequiredOnSimd16Sample16bit);
+    VISA_WA_SET(&m_WaTable, WaSendsSrc1SizeLimitWhenEOT, waTable.WaSendsSrc1SizeLimitWhenEOT);
+    VISA_WA_SET(&m_WaTable, WaDisallow64BitImmMov, waTable.WaDisallow64BitImmMov);
+    VISA_WA_SET(&m_WaTable, WaThreadSwitchAfterCall, waTable.WaThreadSwitchAfterCall);
+    VISA_WA_SET(&m_WaTable, WaSrc1ImmHfNotAllowed, waTable.WaSrc1ImmHfNotAllowed);
+    VISA_WA_SET(&m_WaTable, WaDstSubRegNumNotAllowedWithLowPrecPacked, waTable.WaDstSubRegNumNotAllowedWithLowPrecPacked);
+    VISA_WA_SET(&m_WaTable, WaDisableMixedModeLog, waTable.WaDisableMixedModeLog);
+    VISA_WA_SET(&m_WaTable, WaDisableMixedModeFdiv, waTable.WaDisableMixedModeFdiv);
+    VISA_WA_SET(&m_WaTable, WaDisableMixedModePow, waTable.WaDisableMixedModePow);
+    VISA_WA_SET(&m_WaTable, WaFloatMixedModeSelNotAllowedWithPackedDestination, waTable.WaFloatMixedModeSelNotAllowedWithPackedDestination);
+    VISA_WA_SET(&m_WaTable, WADisableWriteCommitForPageFault, waTable.WADisableWriteCommitForPageFault);
     //To be enabled after VISA changes the name for this to be consistent
     //m_WaTable.WAInsertNOPBetweenMathPOWDIVAnd2RegInstr  = waTable.WAInsertNOPBetweenMathPOWDIVAnd2RegInstr;
-    m_WaTable.WaClearArfDependenciesBeforeEot = waTable.WaClearArfDependenciesBeforeEot;
-    m_WaTable.WaMixModeSelInstDstNotPacked = waTable.WaMixModeSelInstDstNotPacked;
-    m_WaTable.WaDisableSendsPreemption = waTable.WaDisableSendsPreemption;
-    m_WaTable.WaResetN0BeforeGatewayMessage = waTable.WaResetN0BeforeGatewayMessage;
+    VISA_WA_SET(&m_WaTable, WaClearArfDependenciesBeforeEot, waTable.WaClearArfDependenciesBeforeEot);
+    VISA_WA_SET(&m_WaTable, WaMixModeSelInstDstNotPacked, waTable.WaMixModeSelInstDstNotPacked);
+    VISA_WA_SET(&m_WaTable, WaDisableSendsPreemption, waTable.WaDisableSendsPreemption);
+    VISA_WA_SET(&m_WaTable, WaResetN0BeforeGatewayMessage, waTable.WaResetN0BeforeGatewayMessage);
 
     if (m_program->GetShaderType() != ShaderType::PIXEL_SHADER &&
         m_program->GetShaderType() != ShaderType::COMPUTE_SHADER &&
         m_program->GetShaderType() != ShaderType::OPENCL_SHADER )
     {
-        m_WaTable.WaClearTDRRegBeforeEOTForNonPS = waTable.WaClearTDRRegBeforeEOTForNonPS;
+        VISA_WA_SET(&m_WaTable, WaClearTDRRegBeforeEOTForNonPS, waTable.WaClearTDRRegBeforeEOTForNonPS);
     }
 
     if (IGC_IS_FLAG_DISABLED(ForceSendsSupportOnSKLA0))
     {
-        m_WaTable.WaDisableSendsSrc0DstOverlap = waTable.WaDisableSendsSrc0DstOverlap;
+        VISA_WA_SET(&m_WaTable, WaDisableSendsSrc0DstOverlap, waTable.WaDisableSendsSrc0DstOverlap);
     }
 
 
@@ -5241,13 +5384,13 @@ void CEncoder::SetVISAWaTable(WA_TABLE const& waTable)
     {
         if (IGC_IS_FLAG_DISABLED(DisableWaSendSEnableIndirectMsgDesc))
         {
-            m_WaTable.WaSendSEnableIndirectMsgDesc = waTable.WaSendSEnableIndirectMsgDesc;
+            VISA_WA_SET(&m_WaTable, WaSendSEnableIndirectMsgDesc, waTable.WaSendSEnableIndirectMsgDesc);
         }
     }
 
     if (IGC_IS_FLAG_DISABLED(DisableWaDisableSIMD16On3SrcInstr))
     {
-        m_WaTable.WaDisableSIMD16On3SrcInstr = waTable.WaDisableSIMD16On3SrcInstr;
+        VISA_WA_SET(&m_WaTable, WaDisableSIMD16On3SrcInstr, waTable.WaDisableSIMD16On3SrcInstr);
     }
 
     if (m_program->m_Platform->supportFtrWddm2Svm() ||
@@ -5255,12 +5398,12 @@ void CEncoder::SetVISAWaTable(WA_TABLE const& waTable)
         m_program->m_Platform->GetPlatformFamily() == IGFX_GEN11_CORE)
     {
         // no send src/dst overlap when page fault is enabled
-        m_WaTable.WaDisableSendSrcDstOverlap = true;
+        VISA_WA_ENABLE(&m_WaTable, WaDisableSendSrcDstOverlap);
     }
-    m_WaTable.WaNoSimd16TernarySrc0Imm = waTable.WaNoSimd16TernarySrc0Imm;
-    m_WaTable.Wa_1406306137 = waTable.Wa_1406306137;
-    m_WaTable.Wa_2201674230 = waTable.Wa_2201674230;
-	m_WaTable.Wa_1406950495 = waTable.Wa_1406950495;
+    VISA_WA_SET(&m_WaTable, WaNoSimd16TernarySrc0Imm, waTable.WaNoSimd16TernarySrc0Imm);
+    VISA_WA_SET(&m_WaTable, Wa_1406306137, waTable.Wa_1406306137);
+    VISA_WA_SET(&m_WaTable, Wa_2201674230, waTable.Wa_2201674230);
+	VISA_WA_SET(&m_WaTable, Wa_1406950495, waTable.Wa_1406950495);
 }
 
 void CEncoder::GetRowAndColOffset(CVariable* var, unsigned int subVar, unsigned int subReg, unsigned char& rowOff, unsigned char& colOff)
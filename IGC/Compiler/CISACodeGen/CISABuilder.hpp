@@ -141,6 +141,16 @@ public:
     void DeclareInput(CVariable* var, uint offset, uint instance);
     void MarkAsOutput(CVariable* var);
     void Compile();
+    /// Compile() split in two steps so that the vISA finalization can run on a
+    /// worker thread. CompileVISA() only touches this encoder's VISABuilder;
+    /// FinishCompile() publishes the result into the program output and the
+    /// context and must be called from the compiling thread.
+    void CompileVISA();
+    /// CompileVISA() on a worker thread, whose vISA timers FinishCompile()
+    /// then adds to the time stats of the context.
+    void CompileVISAOnWorkerThread();
+    void FinishCompile();
+    bool HasVISABuilder() const { return vbuilder != nullptr; }
     CEncoder();
     ~CEncoder();
     void SetProgram(CShader* program);
@@ -501,6 +511,11 @@ protected:
     VISAKernel*   vKernel;
     VISAKernel*   vMainKernel;
     VISABuilder* vbuilder;
+
+    /// Return value of the last vbuilder->Compile() call
+    int m_vIsaCompileStatus = 0;
+    /// vISA timer ticks spent by CompileVISAOnWorkerThread()
+    std::vector<int64_t> m_workerVISATimerTicks;
     
     bool m_enableVISAdump;
     std::vector<VISA_LabelOpnd*> labelMap;
@@ -114,6 +114,34 @@ void CShader::InitEncoder(SIMDMode simdSize, bool canAbortOnSpill, ShaderDispatc
     encoder.SetProgram(this);
 }
 
+bool CShader::HasStackCalls()
+{
+    return m_FGA && m_FGA->getGroup(entry)->hasStackCall();
+}
+
+// Short loop-free compute kernels don't benefit from mid-thread preemption.
+void CShader::CheckMidThreadPreemption()
+{
+    if ((GetShaderType() == ShaderType::COMPUTE_SHADER ||
+        GetShaderType() == ShaderType::OPENCL_SHADER) &&
+        m_Platform->supportDisableMidThreadPreemptionSwitch() &&
+        IGC_IS_FLAG_ENABLED(EnableDisableMidThreadPreemptionOpt) &&
+        (GetContext()->m_instrTypes.numLoopInsts == 0) &&
+        (ProgramOutput()->m_InstructionCount < IGC_GET_FLAG_VALUE(MidThreadPreemptionDisableThreshold)))
+    {
+        if (GetShaderType() == ShaderType::COMPUTE_SHADER)
+        {
+            CComputeShader* csProgram = static_cast<CComputeShader*>(this);
+            csProgram->SetDisableMidthreadPreemption();
+        }
+        else
+        {
+            COpenCLKernel* kernel = static_cast<COpenCLKernel*>(this);
+            kernel->SetDisableMidthreadPreemption();
+        }
+    }
+}
+
 // Pre-analysis pass to be executed before call to visa builder so we can pass scratch space offset
 void CShader::PreAnalysisPass()
 {
@@ -134,6 +162,24 @@ void CShader::PreAnalysisPass()
         }
     }
 
+    // The IR scan below does not depend on the SIMD width, so reuse the
+    // result of a variant of this program that has already done it.
+    if (IGC_IS_FLAG_ENABLED(ShareSIMDPreAnalysis))
+    {
+        const SIMDMode modes[] = { SIMDMode::SIMD8, SIMDMode::SIMD16, SIMDMode::SIMD32 };
+        for (SIMDMode mode : modes)
+        {
+            CShader* pSibling = m_parent->GetShader(mode, m_ShaderDispatchMode);
+            if (pSibling && pSibling != this &&
+                pSibling->m_ParsedShaderSpecificOpcodes &&
+                CopyShaderSpecificOpcodeInfo(pSibling))
+            {
+                m_ParsedShaderSpecificOpcodes = true;
+                return;
+            }
+        }
+    }
+
     for (auto BB = entry->begin(), BE = entry->end(); BB != BE; ++BB) {
         llvm::BasicBlock* pLLVMBB = &(*BB);
         llvm::BasicBlock::InstListType& instructionList = pLLVMBB->getInstList();
@@ -142,6 +188,7 @@ void CShader::PreAnalysisPass()
             ParseShaderSpecificOpcode(inst);
         }
     }
+    m_ParsedShaderSpecificOpcodes = true;
 }
 
 SProgramOutput* CShader::ProgramOutput()
@@ -1830,6 +1877,16 @@ void CShader::BeginFunction(llvm::Function *F)
     ccTupleMapping.clear();
     ConstantPool.clear();
 
+    // Most values in F end up with a CVariable; size the map up front so it
+    // does not rehash repeatedly while the function is being emitted.
+    // llvm::DenseMap grows once it is 75% full, so leave some headroom.
+    size_t nVals = F->arg_size();
+    for (auto &BB : *F)
+    {
+        nVals += BB.size();
+    }
+    symbolMapping.grow(int_cast<unsigned>((size_t)(nVals * 1.40f)));
+
     bool useStackCall = m_FGA->useStackCall(F);
     if (useStackCall)
     {
@@ -1987,6 +2044,7 @@ CVariable* CShader::getOrCreateArgumentSymbol(llvm::Argument *Arg, bool useStack
 // %y = op2 (%x, ...)
 // with some constraints:
 // - %x and %y belong to the same block
+//   (or, with EnableCrossBlockVariableReuse, %x dies in %y's block)
 // - %x and %y do not live out of this block
 // - %x does not interfere with %y
 // - %x is not phi
@@ -2157,6 +2215,8 @@ unsigned int CShader::EvaluateSIMDConstExpr(Value* C)
         {
         case Instruction::Add:
             return EvaluateSIMDConstExpr(op->getOperand(0)) + EvaluateSIMDConstExpr(op->getOperand(1));
+        case Instruction::Sub:
+            return EvaluateSIMDConstExpr(op->getOperand(0)) - EvaluateSIMDConstExpr(op->getOperand(1));
         case Instruction::Mul:
             return EvaluateSIMDConstExpr(op->getOperand(0)) * EvaluateSIMDConstExpr(op->getOperand(1));
         case Instruction::Shl:
@@ -2863,6 +2923,38 @@ void CShader::Destroy()
 {
 }
 
+// Free the variables and value mappings built while emitting vISA. Only valid
+// once the kernel is compiled and nothing will look up a CVariable again; the
+// program output and kernel info are kept.
+void CShader::ReleaseCodeGenState()
+{
+    llvm::DenseMap<llvm::Value *, CVariable*>().swap(globalSymbolMapping);
+    llvm::DenseMap<llvm::Value*, CVariable*>().swap(symbolMapping);
+    llvm::DenseMap<llvm::PHINode*, CVariable*>().swap(phiMapping);
+    llvm::DenseMap<llvm::Value*, CVariable*>().swap(rootMapping);
+    llvm::DenseMap<CoalescingEngine::CCTuple*, CVariable*>().swap(ccTupleMapping);
+    llvm::DenseMap<llvm::Constant *, CVariable *>().swap(ConstantPool);
+    llvm::DenseMap<llvm::Value*, uint32_t>().swap(extractMasks);
+    llvm::DenseMap<llvm::Instruction*, llvm::SmallVector<CVariable*, 8>>().swap(m_VectorBCItoCVars);
+    std::vector<CVariable*>().swap(setup);
+    std::vector<CVariable*>().swap(patchConstantSetup);
+    std::vector<llvm::Value*>().swap(m_argListCache);
+
+    m_R0 = nullptr;
+    m_NULL = nullptr;
+    m_TSC = nullptr;
+    m_SR0 = nullptr;
+    m_CR0 = nullptr;
+    m_CE0 = nullptr;
+    m_DBG = nullptr;
+    m_HW_TID = nullptr;
+    m_SP = nullptr;
+    m_SavedSP = nullptr;
+    m_ARGV = nullptr;
+    m_RETV = nullptr;
+    Allocator.Reset();
+}
+
 void CShader::SampleHeader(CVariable* payload, uint offset, uint writeMask, uint rti)
 {
     uint dword2 = offset | ((~writeMask & 0xF) << 12);
@@ -158,6 +158,19 @@ void CoalescingEngine::IncrementalCoalesce(BasicBlock* MBB)
     std::vector<Instruction*> &DefInstrs = BBProcessingDefs[MBB];
     std::sort(DefInstrs.begin(), DefInstrs.end(), MIIndexCompare(LV));
 
+    const bool useSlotVotes = IGC_IS_FLAG_ENABLED(EnablePayloadSlotVotes);
+    PayloadSlotVotes.clear();
+    if (useSlotVotes)
+    {
+        for (auto DefMI : DefInstrs)
+        {
+            if (!ValueNodeMap.count(DefMI) && IsTupleGeneratingInstruction(DefMI))
+            {
+                AddPayloadSlotVotes(DefMI, 1);
+            }
+        }
+    }
+
     for (std::vector<Instruction*>::const_iterator BBI = DefInstrs.begin(),
         BBE = DefInstrs.end(); BBI != BBE; ++BBI) 
     {
@@ -177,28 +190,81 @@ void CoalescingEngine::IncrementalCoalesce(BasicBlock* MBB)
                 //    continue;
                 //}
 
-                if (GenIntrinsicInst* intrinsic = llvm::dyn_cast<llvm::GenIntrinsicInst>(DefMI) )
+                if (IsTupleGeneratingInstruction(DefMI))
                 {
-                    GenISAIntrinsic::ID IID = intrinsic->getIntrinsicID();
-                    if ((isURBWriteIntrinsic(intrinsic) && !(IGC_IS_FLAG_ENABLED(DisablePayloadCoalescing_URB))) ||
-                        (IID == GenISAIntrinsic::GenISA_RTWrite && !(IGC_IS_FLAG_ENABLED(DisablePayloadCoalescing_RT))))
+                    ProcessTuple( DefMI );
+                    if (useSlotVotes)
                     {
-                        ProcessTuple( DefMI );
+                        AddPayloadSlotVotes(DefMI, -1);
                     }
-                }                
-
-                if (isSampleInstruction(DefMI) && !IGC_IS_FLAG_ENABLED(DisablePayloadCoalescing_Sample))
-                {
-                    ProcessTuple( DefMI );
-                }
-                else if (isLdInstruction(DefMI))
-                {
-                    ProcessTuple(DefMI);
                 }
             }
     }
 }
 
+bool CoalescingEngine::IsTupleGeneratingInstruction(Instruction* inst) const
+{
+    if (GenIntrinsicInst* intrinsic = llvm::dyn_cast<llvm::GenIntrinsicInst>(inst))
+    {
+        GenISAIntrinsic::ID IID = intrinsic->getIntrinsicID();
+        if ((isURBWriteIntrinsic(intrinsic) && !(IGC_IS_FLAG_ENABLED(DisablePayloadCoalescing_URB))) ||
+            (IID == GenISAIntrinsic::GenISA_RTWrite && !(IGC_IS_FLAG_ENABLED(DisablePayloadCoalescing_RT))))
+        {
+            return true;
+        }
+    }
+
+    if (isSampleInstruction(inst))
+    {
+        return !IGC_IS_FLAG_ENABLED(DisablePayloadCoalescing_Sample);
+    }
+    return isLdInstruction(inst);
+}
+
+/// Multi-tap filters issue several samples sharing a coordinate at the same
+/// slot, e.g. sample(u0, v), sample(u1, v), sample(u2, v). If the slot a value
+/// takes in the first payload is not the one most of the block's payloads
+/// want, anchoring it there makes all the others copy it. The votes let
+/// CreateTuple leave such a value to a later payload instead.
+void CoalescingEngine::AddPayloadSlotVotes(Instruction* tupleGeneratingInstruction, int delta)
+{
+    const uint numOperands = m_PayloadMapping.GetNumPayloadElements(tupleGeneratingInstruction);
+    for (uint i = 0; i < numOperands; i++)
+    {
+        Value* val = m_PayloadMapping.GetPayloadElementToValueMapping(tupleGeneratingInstruction, i);
+        if (!val || isa<Constant>(val))
+        {
+            continue;
+        }
+        SmallVector<uint, 8>& votes = PayloadSlotVotes[val];
+        if (votes.size() <= i)
+        {
+            votes.resize(i + 1, 0);
+        }
+        assert(delta > 0 || votes[i] > 0);
+        votes[i] += delta;
+    }
+}
+
+bool CoalescingEngine::IsOutvotedAtSlot(Value* val, uint index) const
+{
+    auto VI = PayloadSlotVotes.find(val);
+    if (VI == PayloadSlotVotes.end())
+    {
+        return false;
+    }
+    const SmallVector<uint, 8>& votes = VI->second;
+    uint here = index < votes.size() ? votes[index] : 0;
+    for (uint i = 0; i < votes.size(); i++)
+    {
+        if (i != index && votes[i] > here)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 static bool IsBindlessSampler(Instruction* inst)
 {
     if(SampleIntrinsic* sample = dyn_cast<SampleIntrinsic>(inst))
@@ -634,6 +700,14 @@ void CoalescingEngine::CreateTuple(
         ElementNode* RootNode = ValueNodeMap[RootV];
 
         auto CCTI = NodeCCTupleMap.find(RootNode);
+        if (CCTI == NodeCCTupleMap.end() &&
+            IsOutvotedAtSlot(val, currentLowBound_ + i))
+        {
+            //Leave the value free for the slot most remaining payloads want,
+            //it is copied into this one.
+            ccTuple->ResizeBounds(i);
+            continue;
+        }
         if( CCTI == NodeCCTupleMap.end() )
         {
             NodeCCTupleMap[RootNode] = ccTuple;
@@ -85,6 +85,7 @@ public:
         ValueNodeMap.clear();
         BBProcessingDefs.clear();
         NodeOffsetMap.clear();
+        PayloadSlotVotes.clear();
     }
 
     bool runOnFunction(llvm::Function&) override;
@@ -392,6 +393,14 @@ public:
 
 
     void IncrementalCoalesce(llvm::BasicBlock*);
+    bool IsTupleGeneratingInstruction(llvm::Instruction* inst) const;
+
+    /// Counts, for every value, the payload slots it takes in the tuple
+    /// generating instructions of a block that are not processed yet.
+    void AddPayloadSlotVotes(llvm::Instruction* tupleGeneratingInstruction, int delta);
+    /// Returns true if val is wanted at another slot by more of the remaining
+    /// messages than at slot index, so it should not be anchored there.
+    bool IsOutvotedAtSlot(llvm::Value* val, uint index) const;
     void PrepareTuple(
         const uint numOperands,
         llvm::Instruction *tupleGeneratingInstruction,
@@ -982,6 +991,8 @@ private:
     llvm::DenseMap<llvm::Value*, llvm::Value*> ImmediateDominatingParent;
 
     llvm::DenseMap<llvm::Instruction*, uint> splitPoint_;
+    //Per value: number of remaining payloads of the current block using it at each slot
+    llvm::DenseMap<llvm::Value*, llvm::SmallVector<uint, 8> > PayloadSlotVotes;
     unsigned currentLowBound_;
     //unsigned currentUpperBound_;
     unsigned currentPart_;
@@ -87,10 +87,12 @@ IGC_INITIALIZE_PASS_BEGIN(CodeSinking, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONL
 IGC_INITIALIZE_PASS_DEPENDENCY(DominatorTreeWrapperPass)
 IGC_INITIALIZE_PASS_DEPENDENCY(PostDominatorTreeWrapperPass)
 IGC_INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
+IGC_INITIALIZE_PASS_DEPENDENCY(RegisterEstimator)
 IGC_INITIALIZE_PASS_END(CodeSinking, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
 
 CodeSinking::CodeSinking(bool generalSinking) : FunctionPass(ID) {
     generalCodeSinking = generalSinking;
+    pressureDrivenLoopSink = generalSinking && IGC_IS_FLAG_ENABLED(EnablePressureDrivenLoopSink);
     initializeCodeSinkingPass(*PassRegistry::getPassRegistry());
 }
 
@@ -247,7 +249,15 @@ bool CodeSinking::runOnFunction(Function &F)
     LI = &getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
     DL = &F.getParent()->getDataLayout();
 
-    bool changed = hoistCongruentPhi(F);
+    // Undo LICM where it pushed a loop over the GRF budget. This goes first,
+    // as the liveness behind the estimate is only valid for the unmodified IR.
+    bool changed = false;
+    if (pressureDrivenLoopSink)
+    {
+        changed = loopSinkByPressure(F);
+    }
+
+    changed |= hoistCongruentPhi(F);
 
     bool madeChange, everMadeChange = false;
     totalGradientMoved = 0;
@@ -1029,6 +1039,29 @@ bool CodeSinking::hoistCongruentPhi(Function& F)
     return changed;
 }
 
+bool CodeSinking::loopSinkByPressure(Function &F)
+{
+    RegisterEstimator *RPE = &getAnalysis<RegisterEstimator>();
+    RPE->calculate();
+
+    const uint32_t limit = CTX->getNumGRFPerThread() + IGC_GET_FLAG_VALUE(LoopSinkThresholdDelta);
+    SmallVector<BasicBlock*, 8> fatBBs;
+    for (auto &BB : F)
+    {
+        if (LI->getLoopFor(&BB) && RPE->getMaxLiveGRFAtBB(&BB) > limit)
+        {
+            fatBBs.push_back(&BB);
+        }
+    }
+
+    bool changed = false;
+    for (auto BB : fatBBs)
+    {
+        changed |= loopSink(BB, true);
+    }
+    return changed;
+}
+
 bool CodeSinking::loopSink(BasicBlock* BBWithPressure, bool SinkMultipleLevel)
 {
     // Sink loop invariants back into the loop body if register
@@ -40,6 +40,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/Analysis/PostDominators.h>
 #include "common/LLVMWarningsPop.hpp"
 
+#include "Compiler/CISACodeGen/RegisterEstimator.hpp"
+
 namespace IGC {
 
 #define CODE_SINKING_MIN_SIZE  32
@@ -63,6 +65,10 @@ public:
         AU.addRequired<llvm::PostDominatorTreeWrapperPass>();
         AU.addRequired<llvm::LoopInfoWrapperPass>();
         AU.addRequired<CodeGenContextWrapper>();
+        if (pressureDrivenLoopSink)
+        {
+            AU.addRequired<RegisterEstimator>();
+        }
         AU.addPreserved<llvm::DominatorTreeWrapperPass>();
         AU.addPreserved<llvm::PostDominatorTreeWrapperPass>();
         AU.addPreserved<llvm::LoopInfoWrapperPass>();
@@ -96,6 +102,9 @@ private:
     unsigned numGradientMovedOutBB;
 
     bool generalCodeSinking;
+    // Reverse LICM into the loop blocks whose estimated pressure exceeds
+    // the GRF budget, see EnablePressureDrivenLoopSink.
+    bool pressureDrivenLoopSink;
     // diagnosis variable: int numChanges;
 
     // fat BB is the BB with the largest register pressure
@@ -145,6 +154,9 @@ private:
     bool hoistCongruentPhi(llvm::PHINode* phi);
     bool hoistCongruentPhi(llvm::Function& F);
 
+    // Run loopSink on every loop block RegisterEstimator finds over budget
+    bool loopSinkByPressure(llvm::Function &F);
+
     // Move LI back into loops
     bool loopSink(llvm::BasicBlock* BBWithPressure, bool SinkMultipleLevel);
     bool canLoopSink(llvm::Instruction *I, llvm::Loop *L, llvm::BasicBlock *BB);
@@ -83,6 +83,22 @@ void ConstantCoalescing::ProcessFunction( Function* function )
     dataLayout = &function->getParent()->getDataLayout();
     wiAns = &getAnalysis<WIAnalysis>();
 
+    m_hasNonPrivateWrites = false;
+    for (auto II = inst_begin(function), IE = inst_end(function); II != IE; ++II)
+    {
+        if (StoreInst* store = dyn_cast<StoreInst>(&*II))
+        {
+            if (store->getPointerAddressSpace() == ADDRESS_SPACE_PRIVATE)
+                continue;
+        }
+        else if (isa<DbgInfoIntrinsic>(&*II) || !II->mayWriteToMemory())
+        {
+            continue;
+        }
+        m_hasNonPrivateWrites = true;
+        break;
+    }
+
     // clean up unnecessary lcssa-phi
     for (Function::iterator I = function->begin(), E = function->end();
          I != E; ++I)
@@ -439,7 +455,8 @@ void ConstantCoalescing::ProcessBlock(
         // stateless path: use int2ptr, and support vector-loads
         Value* elt_idxv = nullptr;
         Value* buf_idxv = nullptr;
-        if (inst->getPointerAddressSpace() == ADDRESS_SPACE_CONSTANT)
+        if (inst->getPointerAddressSpace() == ADDRESS_SPACE_CONSTANT ||
+            IsReadOnlyStatelessLoad(inst))
         {
             // another limit: load has to be dword-aligned
             if (inst->getAlignment() % 4)
@@ -552,6 +569,20 @@ void ConstantCoalescing::ProcessBlock(
     } // loop over inst in block
 }
 
+/// A global load can go through the stateless constant path when nothing in
+/// the kernel can change what it reads: the load is marked invariant, or the
+/// kernel does not write any global memory at all.
+bool ConstantCoalescing::IsReadOnlyStatelessLoad(LoadInst *load) const
+{
+    if (IGC_IS_FLAG_DISABLED(EnableStatelessConstantCoalescing) ||
+        load->getPointerAddressSpace() != ADDRESS_SPACE_GLOBAL ||
+        load->isVolatile())
+    {
+        return false;
+    }
+    return load->getMetadata(LLVMContext::MD_invariant_load) || !m_hasNonPrivateWrites;
+}
+
 /// check if two access have the same buffer-base
 bool ConstantCoalescing::CompareBufferBase(Value *bufIdxV1, uint addrSpace1, Value *bufIdxV2, uint addrSpace2)
 {
@@ -764,7 +795,7 @@ void ConstantCoalescing::CombineTwoLoads( BufChunk *cov_chunk, Instruction *load
     {
         Value *addr_ptr = cov_chunk->chunkIO->getOperand(0);
         unsigned addrSpace = (cast<PointerType>(addr_ptr->getType()))->getAddressSpace();
-        if(addrSpace == ADDRESS_SPACE_CONSTANT)
+        if(addrSpace == ADDRESS_SPACE_CONSTANT || addrSpace == ADDRESS_SPACE_GLOBAL)
         {
             // no GEP, OCL path
             assert(isa<IntToPtrInst>(addr_ptr));
@@ -1901,7 +1932,7 @@ void ConstantCoalescing::ChangePTRtoOWordBased(BufChunk *chunk)
     // has to be a 3d-load for now.
     // Argument pointer coming from OCL may not be oword-aligned
     uint addrSpace = load->getPointerAddressSpace();
-    if (addrSpace == ADDRESS_SPACE_CONSTANT)
+    if (addrSpace == ADDRESS_SPACE_CONSTANT || addrSpace == ADDRESS_SPACE_GLOBAL)
     {
         return;
     }
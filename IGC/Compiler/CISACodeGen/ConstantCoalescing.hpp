@@ -35,6 +35,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/IR/PassManager.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/ADT/SmallBitVector.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/IntrinsicInst.h>
 #include "common/LLVMWarningsPop.hpp"
 #include "common/IGCIRBuilder.h"
 
@@ -230,6 +232,11 @@ private:
     WIAnalysis *wiAns;
     const llvm::DataLayout *dataLayout;
     TranslationTable *m_TT;
+    // whether the function may write to memory other than private
+    bool m_hasNonPrivateWrites;
+
+    /// global (stateless) loads that may be coalesced like constant ones
+    bool   IsReadOnlyStatelessLoad(llvm::LoadInst *load) const;
 
 
     /// check if two access have the same buffer-base
@@ -503,12 +503,21 @@ DeSSA::SplitInterferencesForBasicBlock(
         //   based on their ordering
         //  if (isa<PHINode>(A) && isa<PHINode>(B)) 
         //    return false;"
+        //
+        // Within MBB the defs are visited in instruction order, so compare
+        // their positions from LiveVars instead: DT->dominates() on two
+        // instructions of the same block walks the block, which made this
+        // loop quadratic on large unrolled blocks. The position test also
+        // covers two phi-nodes of the same block.
         if (isa<Argument>(NewParent)) {
           break;
-        } else if (DT->dominates(cast<Instruction>(NewParent), DefMI)) {
-          break;
-        } else if (cast<Instruction>(NewParent)->getParent() == MBB &&
-                   isa<PHINode>(DefMI) && isa<PHINode>(NewParent)) {
+        }
+        Instruction *ParentMI = cast<Instruction>(NewParent);
+        if (ParentMI->getParent() == MBB) {
+          if (LV->getDistance(ParentMI) < LV->getDistance(DefMI)) {
+            break;
+          }
+        } else if (DT->dominates(ParentMI->getParent(), MBB)) {
           break;
         }
       }
@@ -261,6 +261,14 @@ void EmitPass::CreateKernelShaderMap(CodeGenContext *ctx, MetaDataUtils *pMdUtil
                 if (!isEntryFunc(pMdUtils, pFunc))
                     continue;
 
+                // Duplicate kernels get the binary of the kernel they duplicate.
+                if (static_cast<OpenCLProgramContext*>(ctx)->m_duplicateKernels.count(pFunc->getName().str()))
+                    continue;
+
+                // Kernels found in the kernel binary cache need no codegen.
+                if (static_cast<OpenCLProgramContext*>(ctx)->m_cachedKernelBinaries.count(pFunc->getName().str()))
+                    continue;
+
                 if (ctx->m_retryManager.kernelSet.empty() ||
                     ctx->m_retryManager.kernelSet.count(pFunc->getName().str()))
                 {
@@ -357,6 +365,8 @@ bool EmitPass::runOnFunction(llvm::Function &F)
         }
     }
 
+    COMPILER_TIME_TRACE_SCOPE(m_currShader->GetContext(), F.getName().str(), numLanes(m_SimdMode),
+        m_currShader->GetContext()->m_retryManager.GetRetryId());
     COMPILER_TIME_START(m_currShader->GetContext(), TIME_CG_vISAEmitPass);
     COMPILER_TIME_START(m_currShader->GetContext(), TIME_vISAEmitInit);
 
@@ -454,6 +464,24 @@ bool EmitPass::runOnFunction(llvm::Function &F)
         DebugInfoData::hasDebugInfo(m_currShader) ||
         m_pattern->m_samplertoRenderTargetEnable;
 
+    // Until the retry allows slicing everywhere, slice only the blocks whose
+    // estimated pressure would otherwise make the SIMD32 kernel spill, and
+    // keep the full SIMD32 schedule elsewhere.
+    RegisterPressureEstimate* RPE = nullptr;
+    if (disableSlicing &&
+        m_SimdMode == SIMDMode::SIMD32 &&
+        IGC_IS_FLAG_ENABLED(EnableRegionSIMD32Slicing) &&
+        IGC_IS_FLAG_DISABLED(DisableSIMD32Slicing) &&
+        !DebugInfoData::hasDebugInfo(m_currShader) &&
+        !m_pattern->m_samplertoRenderTargetEnable)
+    {
+        RPE = &getAnalysis<RegisterPressureEstimate>();
+        if (!RPE->isAvailable())
+        {
+            RPE = nullptr;
+        }
+    }
+
     IGC::Debug::Dump* llvmtoVISADump = nullptr;
     if (IGC_IS_FLAG_ENABLED(ShaderDumpEnable))
     {
@@ -491,6 +519,14 @@ bool EmitPass::runOnFunction(llvm::Function &F)
         // Variable reuse per-block states.
         VariableReuseAnalysis::EnterBlockRAII EnterBlock(VRA, block.bb);
 
+        // The estimate is in bytes per lane, i.e. GRFs at SIMD32.
+        bool disableBlockSlicing = disableSlicing;
+        if (RPE)
+        {
+            disableBlockSlicing = RPE->getRegisterPressure(block.bb) <
+                IGC_GET_FLAG_VALUE(RegionSIMD32SlicingThreshold);
+        }
+
         // go through the list in reverse order
         auto I = block.m_dags.rbegin(), E = block.m_dags.rend();
         while (I != E)
@@ -522,7 +558,7 @@ bool EmitPass::runOnFunction(llvm::Function &F)
             bool slicing = false;
             uint numInstance = DecideInstanceAndSlice(*(block.bb), (*I), slicing);
             assert(numInstance == 1 || numInstance == 2);
-            if (slicing && !disableSlicing)
+            if (slicing && !disableBlockSlicing)
             {
                 IF_DEBUG_INFO_IF(m_pDebugEmitter, m_pDebugEmitter->BeginEncodingMark();)
                 I = emitInSlice(block, I);
@@ -630,6 +666,16 @@ bool EmitPass::runOnFunction(llvm::Function &F)
     IF_DEBUG_INFO_IF(m_currShader->diData, m_currShader->diData->markOutput(F, m_currShader);)
     IF_DEBUG_INFO_IF(m_currShader->diData, m_currShader->diData->addVISAModule(&F, m_pDebugEmitter->GetVISAModule());)
 
+    bool deferCompile = ctx->m_deferVISACompile ||
+        (ctx->m_deferFixedSIMDVISACompile && m_currShader->HasFixedSIMDSize(*m_currShader->entry));
+    if (finalize && deferCompile)
+    {
+        // Leave the vISA builder alive: it is compiled later, concurrently with
+        // the other SIMD variants of this kernel (see CompileDeferredVISA).
+        IF_DEBUG_INFO(IDebugEmitter::Release(m_pDebugEmitter);)
+        return false;
+    }
+
     // Compile only when this is the last function for this kernel.
     bool destroyVISABuilder = false;
     if (finalize)
@@ -657,24 +703,7 @@ bool EmitPass::runOnFunction(llvm::Function &F)
         }
     }
 
-    if ((m_currShader->GetShaderType() == ShaderType::COMPUTE_SHADER ||
-        m_currShader->GetShaderType() == ShaderType::OPENCL_SHADER) &&
-        m_currShader->m_Platform->supportDisableMidThreadPreemptionSwitch() &&
-        IGC_IS_FLAG_ENABLED(EnableDisableMidThreadPreemptionOpt) &&
-        (m_currShader->GetContext()->m_instrTypes.numLoopInsts == 0) &&
-        (m_currShader->ProgramOutput()->m_InstructionCount < IGC_GET_FLAG_VALUE(MidThreadPreemptionDisableThreshold)))
-    {
-        if (m_currShader->GetShaderType() == ShaderType::COMPUTE_SHADER)
-        {
-            CComputeShader* csProgram = static_cast<CComputeShader*>(m_currShader);
-            csProgram->SetDisableMidthreadPreemption();
-        }
-        else
-        {
-            COpenCLKernel* kernel = static_cast<COpenCLKernel*>(m_currShader);
-            kernel->SetDisableMidthreadPreemption();
-        }
-    }
+    m_currShader->CheckMidThreadPreemption();
 
     return false;
 }
@@ -4562,6 +4591,25 @@ void EmitPass::emitSimdShuffleDown( llvm::Instruction* inst )
     m_encoder->Copy( pCombinedData, pNextData );
     m_encoder->Push();
 
+    // With a constant delta every lane reads the combined data at the same
+    // offset, so a plain regioned move replaces the address computation below.
+    // shuffle_up( prev, cur, c ) reaches here as shuffle_down( prev, cur, simdSize - c ).
+    if ( pDelta->IsImmediate() )
+    {
+        uint64_t delta = pDelta->GetImmediateValue();
+        if ( delta <= numLanes( m_SimdMode ) )
+        {
+            CVariable* pShiftedData = m_currShader->GetNewAlias(
+                pCombinedData,
+                m_destination->GetType(),
+                int_cast<uint16_t>( delta * m_destination->GetElemSize() ),
+                numLanes( m_SimdMode ) );
+            m_encoder->Copy( m_destination, pShiftedData );
+            m_encoder->Push();
+            return;
+        }
+    }
+
     // Emits below instructions:
     // mov (8) r12.0<1>:w 0x76543210:v {Align1, Q1, NoMask}
     // mov (8) r38.0<1>:ud r12.0<8;8,1>:w {Align1, Q1, NoMask}
@@ -10027,6 +10075,9 @@ the destination addresses and the source are both uniform. For example lets say
 add happens with destination address as <addr> = constant. <src> = constant too. In this case, lets
 say for SIMD8 there are 8 lanes trying to write to the same address. H/W will serialize this to
 8 back to back atomic instructions which are extremely slow to execute.
+
+When pLaneMask is given, only the lanes set in it take part: the others contribute the identity
+value and keep their destination untouched. pDstAddr must then be the address of those lanes.
 */
 void EmitPass::emitScalarAtomics(
     llvm::Instruction* pInst,
@@ -10035,11 +10086,14 @@ void EmitPass::emitScalarAtomics(
     CVariable* pDstAddr,
     CVariable* pSrc,
     bool isA64,
-    bool is16Bit)
+    unsigned short bitwidth,
+    CVariable* pLaneMask)
 {
+    const bool is16Bit = (bitwidth == 16);
+    const bool is64Bit = (bitwidth == 64);
     e_opcode op = EOPCODE_ADD;
     // find the value for which opcode(x, identity) == x
-    unsigned int identityValue = 0;
+    uint64_t identityValue = 0;
     switch(atomic_op)
     {
     case EATOMIC_IADD:
@@ -10054,15 +10108,15 @@ void EmitPass::emitScalarAtomics(
         op = EOPCODE_MAX;
         break;
     case EATOMIC_IMAX:
-        identityValue = 0x80000000;
+        identityValue = is64Bit ? 0x8000000000000000ULL : 0x80000000;
         op = EOPCODE_MAX;
         break;
     case EATOMIC_UMIN:
-        identityValue = 0xFFFFFFFF;
+        identityValue = is64Bit ? 0xFFFFFFFFFFFFFFFFULL : 0xFFFFFFFF;
         op = EOPCODE_MIN;
         break;
     case EATOMIC_IMIN:
-        identityValue = 0X7FFFFFFF;
+        identityValue = is64Bit ? 0x7FFFFFFFFFFFFFFFULL : 0X7FFFFFFF;
         op = EOPCODE_MIN;
         break;
     default:
@@ -10070,7 +10124,7 @@ void EmitPass::emitScalarAtomics(
         break;
     }
 
-    VISA_Type type = is16Bit ? ISA_TYPE_W : ISA_TYPE_D;
+    VISA_Type type = is16Bit ? ISA_TYPE_W : (is64Bit ? ISA_TYPE_Q : ISA_TYPE_D);
     if (atomic_op == EATOMIC_INC || atomic_op == EATOMIC_DEC)
     {
         if (atomic_op == EATOMIC_INC)
@@ -10099,13 +10153,29 @@ void EmitPass::emitScalarAtomics(
     CVariable* pFinalAtomicSrcVal = m_currShader->GetNewVariable(
         1,
         type,
-        isA64 ? IGC::EALIGN_2GRF : IGC::EALIGN_GRF,
+        (isA64 || is64Bit) ? IGC::EALIGN_2GRF : IGC::EALIGN_GRF,
         true);
+    CVariable* pReduceSrc = pSrc;
+    if (pLaneMask)
+    {
+        // lanes outside of the mask contribute the identity value
+        pReduceSrc = m_currShader->GetNewVariable(
+            numLanes(m_currShader->m_SIMDSize),
+            type,
+            IGC::EALIGN_GRF,
+            false);
+        m_encoder->SetNoMask();
+        m_encoder->Copy(pReduceSrc, m_currShader->ImmToVariable(identityValue, type));
+        m_encoder->Push();
+        m_encoder->SetPredicate(pLaneMask);
+        m_encoder->Copy(pReduceSrc, pSrc);
+        m_encoder->Push();
+    }
     CVariable *pSrcsArr[2] = { nullptr, nullptr };
     if(returnsImmValue)
     {
         // sum all the lanes
-        emitPreOrPostFixOp(op, identityValue, type, negateSrc, pSrc, pSrcsArr);
+        emitPreOrPostFixOp(op, identityValue, type, negateSrc, pReduceSrc, pSrcsArr);
 
         CVariable *pSrcCopy = pSrcsArr[0];
         if(m_currShader->m_dispatchSize == SIMDMode::SIMD32)
@@ -10118,7 +10188,7 @@ void EmitPass::emitScalarAtomics(
     }
     else
     {
-        emitReductionAll(op, identityValue, type, negateSrc, pSrc, pFinalAtomicSrcVal);
+        emitReductionAll(op, identityValue, type, negateSrc, pReduceSrc, pFinalAtomicSrcVal);
     }
 
     if (pDstAddr->IsImmediate())
@@ -10131,11 +10201,23 @@ void EmitPass::emitScalarAtomics(
         pDstAddr = pDstAddrCopy;
     }
 
+    // 64-bit atomics only exist as A64 messages, extend 32-bit pointers
+    bool useA64 = isA64 || is64Bit;
+    if (useA64 && !isA64)
+    {
+        CVariable* pDstAddrA64 = m_currShader->GetNewVariable(1, ISA_TYPE_UQ, IGC::EALIGN_2GRF, true);
+        m_encoder->SetSimdSize(SIMDMode::SIMD1);
+        m_encoder->SetNoMask();
+        m_encoder->Cast(pDstAddrA64, m_currShader->BitCast(pDstAddr, ISA_TYPE_UD));
+        m_encoder->Push();
+        pDstAddr = pDstAddrA64;
+    }
+
     m_encoder->SetSimdSize(SIMDMode::SIMD1);
     m_encoder->SetNoMask();
 
     CVariable *pReturnVal = returnsImmValue ?
-        m_currShader->GetNewVariable(1, ISA_TYPE_UD, IGC::EALIGN_GRF, true) :
+        m_currShader->GetNewVariable(1, is64Bit ? ISA_TYPE_UQ : ISA_TYPE_UD, IGC::EALIGN_GRF, true) :
         nullptr;
 
     if (is16Bit)
@@ -10147,9 +10229,9 @@ void EmitPass::emitScalarAtomics(
         pFinalAtomicSrcVal = pCastAtomicSrcVal;
     }
 
-    if(isA64)
+    if(useA64)
     {
-        m_encoder->AtomicRawA64(uniformAtomicOp, pReturnVal, pDstAddr, pFinalAtomicSrcVal, nullptr, is16Bit ? 16 : 32);
+        m_encoder->AtomicRawA64(uniformAtomicOp, pReturnVal, pDstAddr, pFinalAtomicSrcVal, nullptr, is16Bit ? 16 : bitwidth);
     }
     else
     {
@@ -10171,6 +10253,10 @@ void EmitPass::emitScalarAtomics(
             {
                 m_encoder->SetSrcModifier(1, EMOD_NEG);
             }
+            if (pLaneMask)
+            {
+                m_encoder->SetPredicate(pLaneMask);
+            }
 
             m_encoder->SetSecondHalf(i == 1);
             m_encoder->Add(m_destination, pSrcsArr[i], pSrc);
@@ -10179,6 +10265,39 @@ void EmitPass::emitScalarAtomics(
     }
 }
 
+/*
+PeeledScalarAtomics: extends ScalarAtomics to divergent addresses. Each iteration takes the address
+of the first active lane, combines all the lanes using that address into a single atomic and
+retires them from the loop, so only one atomic is issued per unique address.
+*/
+void EmitPass::emitPeeledScalarAtomics(
+    llvm::Instruction* pInst,
+    const ResourceDescriptor& resource,
+    AtomicOp atomic_op,
+    CVariable* pDstAddr,
+    CVariable* pSrc,
+    bool isA64,
+    unsigned short bitwidth)
+{
+    uint label = m_encoder->GetNewLabelID();
+    m_encoder->Label(label);
+    m_encoder->Push();
+
+    CVariable* pUniformAddr = UniformCopy(pDstAddr);
+    CVariable* flag = m_currShader->GetNewVariable(numLanes(m_SimdMode), ISA_TYPE_BOOL, EALIGN_BYTE);
+    m_encoder->Cmp(EPREDICATE_EQ, flag, pUniformAddr, pDstAddr);
+    m_encoder->Push();
+
+    e_alignment uniformAlign = isA64 ? EALIGN_2GRF : EALIGN_GRF;
+    pUniformAddr = ReAlignUniformVariable(pUniformAddr, uniformAlign);
+    emitScalarAtomics(pInst, resource, atomic_op, pUniformAddr, pSrc, isA64, bitwidth, flag);
+
+    // lanes that are done leave the loop
+    m_encoder->SetInversePredicate(true);
+    m_encoder->Jump(flag, label);
+    m_encoder->Push();
+}
+
 bool EmitPass::IsUniformAtomic(llvm::Instruction* pInst)
 {
     if (llvm::GenIntrinsicInst* pIntrinsic = llvm::dyn_cast<llvm::GenIntrinsicInst>(pInst))
@@ -10215,6 +10334,39 @@ bool EmitPass::IsUniformAtomic(llvm::Instruction* pInst)
     return false;
 }
 
+bool EmitPass::IsPeelableAtomic(llvm::Instruction* pInst)
+{
+    if (IGC_IS_FLAG_DISABLED(EnablePeeledScalarAtomics) ||
+        IGC_IS_FLAG_ENABLED(DisableScalarAtomics) ||
+        m_currShader->m_DriverInfo->WASLMPointersDwordUnit())
+        return false;
+    // SIMD32 is emitted as two halves sharing the loop, keep it simple.
+    if (m_currShader->m_dispatchSize == SIMDMode::SIMD32)
+        return false;
+
+    llvm::GenIntrinsicInst* pIntrinsic = llvm::dyn_cast<llvm::GenIntrinsicInst>(pInst);
+    if (!pIntrinsic)
+        return false;
+    GenISAIntrinsic::ID id = pIntrinsic->getIntrinsicID();
+    if (id != GenISAIntrinsic::GenISA_intatomicraw &&
+        id != GenISAIntrinsic::GenISA_intatomicrawA64)
+        return false;
+    // uniform addresses are handled by the regular scalar atomics
+    if (GetSymbol(pInst->getOperand(1))->IsUniform())
+        return false;
+
+    AtomicOp atomic_op = static_cast<AtomicOp>(llvm::cast<llvm::ConstantInt>(pInst->getOperand(3))->getZExtValue());
+    bool isAddAtomic = atomic_op == EATOMIC_IADD ||
+        atomic_op == EATOMIC_INC ||
+        atomic_op == EATOMIC_SUB;
+    bool isMinMaxAtomic =
+        atomic_op == EATOMIC_UMAX ||
+        atomic_op == EATOMIC_UMIN ||
+        atomic_op == EATOMIC_IMIN ||
+        atomic_op == EATOMIC_IMAX;
+    return isAddAtomic || (isMinMaxAtomic && pInst->use_empty());
+}
+
 CVariable *EmitPass::UnpackOrBroadcastIfUniform(CVariable *pVar)
 {
     if (pVar->GetElemSize() == 4 || pVar->GetElemSize() == 8)
@@ -10294,18 +10446,31 @@ void EmitPass::emitAtomicRaw(llvm::GenIntrinsicInst* pInsn)
     // Dst address in bytes.
     CVariable* pDstAddr = GetSymbol(pllDstAddr);
     // If DisableScalarAtomics regkey is enabled or DisableIGCOptimizations regkey is enabled then
-    // don't enable scalar atomics, also do not enable for 64 bit
-    if (IsUniformAtomic(pInsn) && bitwidth != 64)
+    // don't enable scalar atomics, 64 bit only when the reduction can be done natively
+    bool scalarAtomicBitwidth = bitwidth != 64 ||
+        (IGC_IS_FLAG_ENABLED(EnableScalarAtomics64) &&
+         !m_currShader->m_Platform->hasNo64BitInst() &&
+         resource.m_surfaceType != ESURFACE_SLM);
+    if (IsUniformAtomic(pInsn) && scalarAtomicBitwidth)
     {
             PointerType *PtrTy = dyn_cast<PointerType>(pllDstAddr->getType());
             bool isA64 = PtrTy && isA64Ptr(PtrTy, m_currShader->GetContext());
             e_alignment uniformAlign = isA64 ? EALIGN_2GRF : EALIGN_GRF;
             // Re-align the pointer if it's not GRF aligned.
             pDstAddr = ReAlignUniformVariable(pDstAddr, uniformAlign);
-            emitScalarAtomics(pInsn, resource, atomic_op, pDstAddr, pSrc0, isA64, is16Bit);
+            emitScalarAtomics(pInsn, resource, atomic_op, pDstAddr, pSrc0, isA64, bitwidth);
             ResetVMask();
             return;
     }
+    if (scalarAtomicBitwidth && IsPeelableAtomic(pInsn) &&
+        (resource.m_resource == nullptr || resource.m_resource->IsUniform()))
+    {
+        PointerType *PtrTy = dyn_cast<PointerType>(pllDstAddr->getType());
+        bool isA64 = PtrTy && isA64Ptr(PtrTy, m_currShader->GetContext());
+        emitPeeledScalarAtomics(pInsn, resource, atomic_op, pDstAddr, pSrc0, isA64, bitwidth);
+        ResetVMask();
+        return;
+    }
 
     pDstAddr = BroadcastIfUniform(pDstAddr);
     if (pSrc0)
@@ -31,6 +31,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Simd32Profitability.hpp"
 #include "GenCodeGenModule.h"
 #include "VariableReuseAnalysis.hpp"
+#include "RegisterPressureEstimate.hpp"
 #include "Compiler/MetaDataUtilsWrapper.h"
 
 #include "common/LLVMWarningsPush.hpp"
@@ -70,6 +71,10 @@ public:
         AU.addRequired<Simd32ProfitabilityAnalysis>();
         AU.addRequired<CodeGenContextWrapper>();
         AU.addRequired<VariableReuseAnalysis>();
+        if (IGC_IS_FLAG_ENABLED(EnableRegionSIMD32Slicing))
+        {
+            AU.addRequired<RegisterPressureEstimate>();
+        }
         AU.setPreservesAll();
     }
 
@@ -236,7 +241,16 @@ public:
         CVariable* pDstAddr,
         CVariable* pSrc,
         bool isA64,
-        bool is16Bit);
+        unsigned short bitwidth,
+        CVariable* pLaneMask = nullptr);
+    void emitPeeledScalarAtomics(
+        llvm::Instruction* pInst,
+        const ResourceDescriptor& resource,
+        AtomicOp atomic_op,
+        CVariable* pDstAddr,
+        CVariable* pSrc,
+        bool isA64,
+        unsigned short bitwidth);
     /// do reduction and accummulate all the activate channels, return a uniform
     void emitReductionAll(
         e_opcode op,
@@ -259,6 +273,7 @@ public:
         bool isQuad = false);
 
     bool IsUniformAtomic(llvm::Instruction* pInst);
+    bool IsPeelableAtomic(llvm::Instruction* pInst);
     void emitAtomicRaw(llvm::GenIntrinsicInst* pInst);
     void emitAtomicStructured(llvm::Instruction* pInst);
     void emitAtomicTyped(llvm::GenIntrinsicInst* pInst);
@@ -45,6 +45,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "llvm/Pass.h"
 #include "llvm/PassAnalysisSupport.h"
 #include "llvm/Analysis/TargetFolder.h"
+#include "llvm/Analysis/ValueTracking.h"
+#include "llvm/Support/KnownBits.h"
 #include "common/LLVMWarningsPop.hpp"
 
 #include "common/LLVMUtils.h"
@@ -439,6 +441,127 @@ public:
           I->eraseFromParent();
       }
     }
+    // Narrow 64-bit operations which could be done in 32 bits.
+    if (IGC_IS_FLAG_ENABLED(EnableEmu64Narrowing))
+      Changed |= narrow(F);
+
+    return Changed;
+  }
+
+private:
+  // Number of known leading zeros of an i64 value.
+  unsigned getLeadingZeros(Value *V) const {
+    KnownBits Known = computeKnownBits(V, *Emu->DL);
+    return Known.countMinLeadingZeros();
+  }
+
+  // Whether the shift amount of a narrowed shift is known to be less than 32.
+  bool isShiftInRange(Value *Amt) const {
+    return getLeadingZeros(Amt) >= 64 - 5;
+  }
+
+  Value *createNarrowBinOp(BinaryOperator *BO) {
+    IRB->SetInsertPoint(BO);
+    Value *LHS = IRB->CreateTrunc(BO->getOperand(0), IRB->getInt32Ty());
+    Value *RHS = IRB->CreateTrunc(BO->getOperand(1), IRB->getInt32Ty());
+    return IRB->CreateBinOp(BO->getOpcode(), LHS, RHS);
+  }
+
+  // Check whether the high 32 bits of BO are known to be zero from the known
+  // bits of its operands, i.e. BO == zext(op32(trunc(LHS), trunc(RHS))).
+  bool hasZeroHighPart(BinaryOperator *BO) const {
+    unsigned LZ0 = getLeadingZeros(BO->getOperand(0));
+    unsigned LZ1 = getLeadingZeros(BO->getOperand(1));
+    switch (BO->getOpcode()) {
+    default:
+      break;
+    case Instruction::Add:
+      // No carry could propagate into the high part.
+      return LZ0 > 32 && LZ1 > 32;
+    case Instruction::Mul:
+      return (64 - LZ0) + (64 - LZ1) <= 32;
+    case Instruction::And:
+      return LZ0 >= 32 || LZ1 >= 32;
+    case Instruction::Or:
+    case Instruction::Xor:
+      return LZ0 >= 32 && LZ1 >= 32;
+    case Instruction::LShr:
+      return LZ0 >= 32 && isShiftInRange(BO->getOperand(1));
+    }
+    return false;
+  }
+
+  // Check whether only the low 32 bits or less of BO are used and they could
+  // be computed from the low 32 bits of its operands.
+  bool hasOnlyLowPartUsed(BinaryOperator *BO) const {
+    switch (BO->getOpcode()) {
+    default:
+      return false;
+    case Instruction::Add:
+    case Instruction::Sub:
+    case Instruction::Mul:
+    case Instruction::And:
+    case Instruction::Or:
+    case Instruction::Xor:
+      break;
+    case Instruction::Shl:
+      if (!isShiftInRange(BO->getOperand(1)))
+        return false;
+      break;
+    }
+    if (BO->user_empty())
+      return false;
+    for (auto *U : BO->users()) {
+      TruncInst *TI = dyn_cast<TruncInst>(U);
+      if (!TI || TI->getType()->getScalarSizeInBits() > 32)
+        return false;
+    }
+    return true;
+  }
+
+  // Rewrite 64-bit binary operations into 32-bit ones where either the high
+  // part of the result is known to be zero or no user observes it. Such
+  // operations are then expanded without add_pair/mul_pair and similar
+  // sequences.
+  bool narrow(Function &F) {
+    bool Changed = false;
+    // Known-bits narrowing is done in program order so that narrowed values
+    // (now zero-extended) refine the known bits of their users.
+    for (auto &BB : F) {
+      for (auto BI = BB.begin(), BE = BB.end(); BI != BE; /*EMPTY*/) {
+        BinaryOperator *BO = dyn_cast<BinaryOperator>(&*BI++);
+        if (!BO || !Emu->isInt64(BO) || !hasZeroHighPart(BO))
+          continue;
+        Value *NewVal = createNarrowBinOp(BO);
+        NewVal = IRB->CreateZExt(NewVal, BO->getType());
+        BO->replaceAllUsesWith(NewVal);
+        BO->eraseFromParent();
+        Changed = true;
+      }
+    }
+    // Demanded-bits narrowing is done in reverse order so that truncations
+    // introduced on operands expose their definitions in turn.
+    SmallVector<BinaryOperator *, 32> Worklist;
+    for (auto &BB : F)
+      for (auto &I : BB)
+        if (BinaryOperator *BO = dyn_cast<BinaryOperator>(&I))
+          if (Emu->isInt64(BO))
+            Worklist.push_back(BO);
+    while (!Worklist.empty()) {
+      BinaryOperator *BO = Worklist.pop_back_val();
+      if (!hasOnlyLowPartUsed(BO))
+        continue;
+      Value *NewVal = createNarrowBinOp(BO);
+      for (auto UI = BO->user_begin(), UE = BO->user_end(); UI != UE;
+           /*EMPTY*/) {
+        TruncInst *TI = cast<TruncInst>(*UI++);
+        IRB->SetInsertPoint(TI);
+        TI->replaceAllUsesWith(IRB->CreateZExtOrTrunc(NewVal, TI->getType()));
+        TI->eraseFromParent();
+      }
+      BO->eraseFromParent();
+      Changed = true;
+    }
 
     return Changed;
   }
@@ -46,6 +46,9 @@ namespace IGC
         FoldKnownWorkGroupSizes() : FunctionPass(ID) {}
         bool runOnFunction(llvm::Function &F);
         void visitCallInst(llvm::CallInst &I);
+    private:
+        // Calls folded away completely, erased once the visit is done.
+        std::vector<llvm::CallInst*> m_foldedCalls;
 
         void getAnalysisUsage(llvm::AnalysisUsage &AU) const
         {
@@ -66,6 +69,11 @@ using namespace IGCMD;
 bool FoldKnownWorkGroupSizes::runOnFunction(Function &F)
 {
     visit(F);
+    for (auto CI : m_foldedCalls)
+    {
+        CI->eraseFromParent();
+    }
+    m_foldedCalls.clear();
     return m_changed;
 }
 
@@ -93,6 +101,42 @@ void FoldKnownWorkGroupSizes::visitCallInst(llvm::CallInst &I)
         }
         return;
     }
+    else if (ctx->getModuleMetaData()->compOpt.TrimLocalIDs &&
+             (funcName.equals("__builtin_IB_get_local_id_x") ||
+              funcName.equals("__builtin_IB_get_local_id_y") ||
+              funcName.equals("__builtin_IB_get_local_id_z")))
+    {
+        // The local id is always 0 in a dimension of size 1. Removing the call
+        // lets WIFuncsAnalysis skip that local id in the per-thread payload.
+        auto itr = ctx->getMetaDataUtils()->findFunctionsInfoItem(I.getParent()->getParent());
+        if (itr == ctx->getMetaDataUtils()->end_FunctionsInfo())
+            return;
+        ThreadGroupSizeMetaDataHandle tgMD = itr->second->getThreadGroupSize();
+        if (!tgMD->hasValue())
+            return;
+
+        // With combined work groups the hardware local id x spans several
+        // logical groups, see OpenCLThreadCombining.
+        auto funcMD = ctx->getModuleMetaData()->FuncMD.find(function);
+        bool isCombined = funcMD != ctx->getModuleMetaData()->FuncMD.end() &&
+            funcMD->second.workGroupCombineFactor > 1;
+
+        bool isZero = false;
+        if (funcName.equals("__builtin_IB_get_local_id_x"))
+            isZero = !isCombined && tgMD->isXDimHasValue() && tgMD->getXDim() == 1;
+        else if (funcName.equals("__builtin_IB_get_local_id_y"))
+            isZero = tgMD->isYDimHasValue() && tgMD->getYDim() == 1;
+        else
+            isZero = tgMD->isZDimHasValue() && tgMD->getZDim() == 1;
+
+        if (isZero)
+        {
+            I.replaceAllUsesWith(Constant::getNullValue(I.getType()));
+            m_foldedCalls.push_back(&I);
+            m_changed = true;
+        }
+        return;
+    }
     else if (funcName.equals("__builtin_IB_get_enqueued_local_size"))
     {
         
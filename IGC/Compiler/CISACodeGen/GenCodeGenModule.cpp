@@ -55,6 +55,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/LLVMWarningsPop.hpp"
 #include "Compiler/DebugInfo/VISADebugEmitter.hpp"
 
+#include <algorithm>
 #include <numeric>
 #include <utility>
 
@@ -796,3 +797,83 @@ Pass *IGC::createSubroutineInlinerPass()
     initializeSubroutineInlinerPass(*PassRegistry::getPassRegistry());
     return new SubroutineInliner();
 }
+
+namespace {
+
+/// \brief Register the functions outlined by partial inlining as subroutines.
+///
+/// The partial inliner inlines the early-exit prefix of a subroutine into its
+/// callers and outlines the remaining body into a new function, which has no
+/// function info yet. Give it one so that it is compiled as a subroutine, or
+/// mark it always-inline when its arguments cannot cross a subroutine call, so
+/// that the following always-inliner folds it back.
+class OutlinedSubroutineMetaData : public ModulePass {
+public:
+    static char ID;
+
+    OutlinedSubroutineMetaData() : ModulePass(ID)
+    {
+        initializeOutlinedSubroutineMetaDataPass(*PassRegistry::getPassRegistry());
+    }
+
+    llvm::StringRef getPassName() const override { return "OutlinedSubroutineMetaData"; }
+
+    void getAnalysisUsage(AnalysisUsage &AU) const override
+    {
+        AU.addRequired<MetaDataUtilsWrapper>();
+    }
+
+    bool runOnModule(Module &M) override;
+};
+
+} // namespace
+
+IGC_INITIALIZE_PASS_BEGIN(OutlinedSubroutineMetaData, "OutlinedSubroutineMetaData", "OutlinedSubroutineMetaData", false, false)
+IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
+IGC_INITIALIZE_PASS_END(OutlinedSubroutineMetaData, "OutlinedSubroutineMetaData", "OutlinedSubroutineMetaData", false, false)
+
+char OutlinedSubroutineMetaData::ID = 0;
+
+bool OutlinedSubroutineMetaData::runOnModule(Module &M)
+{
+    IGCMD::MetaDataUtils *pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+
+    // Private and generic pointers refer to the caller's frame, and aggregates
+    // are not lowered for subroutine arguments.
+    auto isSupportedArg = [](const Argument &Arg) {
+        Type *Ty = Arg.getType();
+        if (auto PTy = dyn_cast<PointerType>(Ty))
+            return PTy->getAddressSpace() != ADDRESS_SPACE_PRIVATE &&
+                   PTy->getAddressSpace() != ADDRESS_SPACE_GENERIC;
+        return !Ty->isAggregateType();
+    };
+
+    bool Changed = false;
+    for (auto &F : M)
+    {
+        if (F.isDeclaration() ||
+            pMdUtils->findFunctionsInfoItem(&F) != pMdUtils->end_FunctionsInfo())
+            continue;
+
+        if (!std::all_of(F.arg_begin(), F.arg_end(), isSupportedArg))
+        {
+            F.addFnAttr(llvm::Attribute::AlwaysInline);
+        }
+        else
+        {
+            auto FHandle = IGCMD::FunctionInfoMetaDataHandle(IGCMD::FunctionInfoMetaData::get());
+            FHandle->setType(IGCMD::FunctionTypeEnum::OtherFunctionType);
+            pMdUtils->setFunctionsInfoItem(&F, FHandle);
+        }
+        Changed = true;
+    }
+
+    if (Changed)
+        pMdUtils->save(M.getContext());
+    return Changed;
+}
+
+ModulePass *IGC::createOutlinedSubroutineMetaDataPass()
+{
+    return new OutlinedSubroutineMetaData();
+}
@@ -209,5 +209,6 @@ public:
 llvm::ModulePass *createGenXCodeGenModulePass();
 llvm::ImmutablePass *createGenXFunctionGroupAnalysisPass();
 llvm::Pass *createSubroutineInlinerPass();
+llvm::ModulePass *createOutlinedSubroutineMetaDataPass();
 
 } // namespace IGC
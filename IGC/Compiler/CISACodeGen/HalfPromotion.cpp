@@ -57,7 +57,7 @@ IGC_INITIALIZE_PASS_END(HalfPromotion, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONL
 
 char HalfPromotion::ID = 0;
 
-HalfPromotion::HalfPromotion() : FunctionPass(ID)
+HalfPromotion::HalfPromotion(bool mathOnly) : FunctionPass(ID), m_mathOnly(mathOnly)
 {
     initializeHalfPromotionPass(*PassRegistry::getPassRegistry());
 }
@@ -83,18 +83,22 @@ void HalfPromotion::visitCallInst(llvm::CallInst &I)
 void IGC::HalfPromotion::handleLLVMIntrinsic(llvm::IntrinsicInst &I)
 {
     Intrinsic::ID id = I.getIntrinsicID();
-    if(id == Intrinsic::cos ||
+    bool isMath =
+        id == Intrinsic::cos ||
         id == Intrinsic::sin ||
         id == Intrinsic::log2 ||
         id == Intrinsic::exp2 ||
         id == Intrinsic::sqrt ||
+        id == Intrinsic::pow;
+    // these are exact or as accurate in half as in float
+    bool isExact =
         id == Intrinsic::floor ||
         id == Intrinsic::ceil ||
         id == Intrinsic::fabs ||
-        id == Intrinsic::pow ||
         id == Intrinsic::fma ||
         id == Intrinsic::maxnum ||
-        id == Intrinsic::minnum)
+        id == Intrinsic::minnum;
+    if(isMath || (isExact && !m_mathOnly))
     {
         Module* M = I.getParent()->getParent()->getParent();
         llvm::IGCIRBuilder<> builder(&I);
@@ -130,11 +134,13 @@ void IGC::HalfPromotion::handleLLVMIntrinsic(llvm::IntrinsicInst &I)
 void IGC::HalfPromotion::handleGenIntrinsic(llvm::GenIntrinsicInst &I)
 {
     GenISAIntrinsic::ID id = I.getIntrinsicID();
-    if(id == GenISAIntrinsic::GenISA_fsat ||
-        id == GenISAIntrinsic::GenISA_rsq ||
+    bool isMath = id == GenISAIntrinsic::GenISA_rsq;
+    bool isExact =
+        id == GenISAIntrinsic::GenISA_fsat ||
         id == GenISAIntrinsic::GenISA_GradientX ||
         id == GenISAIntrinsic::GenISA_GradientY ||
-        id == GenISAIntrinsic::GenISA_WaveShuffleIndex)
+        id == GenISAIntrinsic::GenISA_WaveShuffleIndex;
+    if(isMath || (isExact && !m_mathOnly))
     {
         Module* M = I.getParent()->getParent()->getParent();
         llvm::IGCIRBuilder<> builder(&I);
@@ -169,7 +175,7 @@ void IGC::HalfPromotion::handleGenIntrinsic(llvm::GenIntrinsicInst &I)
 
 void HalfPromotion::visitFCmp(llvm::FCmpInst &CmpI)
 {
-    if(CmpI.getOperand(0)->getType()->isHalfTy())
+    if(!m_mathOnly && CmpI.getOperand(0)->getType()->isHalfTy())
     {
         llvm::IGCIRBuilder<> builder(&CmpI);
         Value* op1 = builder.CreateFPExt(CmpI.getOperand(0), builder.getFloatTy());
@@ -183,9 +189,10 @@ void HalfPromotion::visitFCmp(llvm::FCmpInst &CmpI)
 void HalfPromotion::visitBinaryOperator(llvm::BinaryOperator &BI)
 {
     if(BI.getType()->isHalfTy() &&
-       (BI.getOpcode() == BinaryOperator::FAdd ||
-        BI.getOpcode() == BinaryOperator::FSub ||
-        BI.getOpcode() == BinaryOperator::FMul ||
+       ((!m_mathOnly &&
+         (BI.getOpcode() == BinaryOperator::FAdd ||
+          BI.getOpcode() == BinaryOperator::FSub ||
+          BI.getOpcode() == BinaryOperator::FMul)) ||
         BI.getOpcode() == BinaryOperator::FDiv))
     {
         llvm::IGCIRBuilder<> builder(&BI);
@@ -213,6 +220,10 @@ void HalfPromotion::visitBinaryOperator(llvm::BinaryOperator &BI)
 
 void HalfPromotion::visitCastInst(llvm::CastInst &CI)
 {
+    if(m_mathOnly)
+    {
+        return;
+    }
     if(CI.getType()->isHalfTy() &&
         (CI.getOpcode() == CastInst::UIToFP ||
          CI.getOpcode() == CastInst::SIToFP))
@@ -253,7 +264,7 @@ void HalfPromotion::visitCastInst(llvm::CastInst &CI)
 
 void HalfPromotion::visitSelectInst(llvm::SelectInst &SI)
 {
-    if(SI.getTrueValue()->getType()->isHalfTy())
+    if(!m_mathOnly && SI.getTrueValue()->getType()->isHalfTy())
     {
         llvm::IGCIRBuilder<> builder(&SI);
         Value* opTrue = builder.CreateFPExt(SI.getTrueValue(), builder.getFloatTy());
@@ -267,7 +278,7 @@ void HalfPromotion::visitSelectInst(llvm::SelectInst &SI)
 
 void HalfPromotion::visitPHINode(llvm::PHINode &PHI)
 {
-    if(!PHI.getType()->isHalfTy())
+    if(m_mathOnly || !PHI.getType()->isHalfTy())
     {
         return;
     }
@@ -40,7 +40,10 @@ namespace IGC
     public:
         static char ID;
 
-        HalfPromotion();
+        // When mathOnly is set, only the operations whose half precision
+        // result is not accurate enough are computed in float and the rest
+        // of the half chains stay native.
+        HalfPromotion(bool mathOnly = false);
 
         virtual llvm::StringRef getPassName() const override
         {
@@ -60,6 +63,7 @@ namespace IGC
         void handleLLVMIntrinsic(llvm::IntrinsicInst &I);
 
         bool m_changed = false;
+        bool m_mathOnly = false;
     };
 
 } // namespace IGC
@@ -293,6 +293,9 @@ void CHullShader::FillProgram(SHullShaderKernelProgram* pKernelProgram)
     pKernelProgram->isMessageTargetDataCacheDataPort = isMessageTargetDataCacheDataPort;
     pKernelProgram->bindingTableEntryCount           = this->GetMaxUsedBindingTableEntryCount();
     pKernelProgram->BindingTableEntryBitmap          = this->GetBindingTableEntryBitmap();
+
+    COMPILER_SHADER_STATS_SET(m_shaderStats, STATS_HS_DISPATCH_MODE, GetShaderDispatchMode());
+    COMPILER_SHADER_STATS_SET(m_shaderStats, STATS_HS_DISPATCH_REASON, m_properties.m_ShaderDispatchReason);
 }
 
 /// Allocates a new variable that keeps input vertex URB handles.
@@ -775,6 +775,7 @@ void CollectHullShaderProperties::gatherInformation(llvm::Function* kernel)
 
     // Dispatch mode might be also determined based on MetaData (which might be treated as Global Variable).
     m_hsProps.m_pShaderDispatchMode = DetermineDispatchMode(kernel);
+    m_hsProps.m_ShaderDispatchReason = DetermineDispatchReason(kernel);
 
     m_hsProps.m_ForcedDispatchMask = GetForcedDispatchMask(kernel);
 
@@ -806,6 +807,23 @@ HullShaderDispatchModes CollectHullShaderProperties::DetermineDispatchMode(Funct
     return shaderDispatchMode;
 }
 
+HullShaderDispatchReasons CollectHullShaderProperties::DetermineDispatchReason(Function* kernel) const
+{
+    HullShaderDispatchReasons reason = HS_DISPATCH_REASON_DEFAULT;
+    llvm::NamedMDNode *pMetaData = kernel->getParent()->getNamedMetadata("HullShaderDispatchMode");
+    if (pMetaData)
+    {
+        llvm::MDNode *pMdNode = pMetaData->getOperand(0);
+        if (pMdNode && pMdNode->getNumOperands() > 1)
+        {
+            llvm::Metadata *pReason = pMdNode->getOperand(1);
+            reason = (HullShaderDispatchReasons)
+                (llvm::mdconst::dyn_extract<ConstantInt>(pReason))->getZExtValue();
+        }
+    }
+    return reason;
+}
+
 unsigned CollectHullShaderProperties::GetForcedDispatchMask(Function* kernel) const
 {
     unsigned dispatchMask = 0;
@@ -831,6 +849,7 @@ m_pMaxOutputSignatureCount(0),
 m_pMaxPatchConstantSignatureDeclarations(0),
 m_HasClipCullAsInput(false),
 m_pShaderDispatchMode(SINGLE_PATCH_DISPATCH_MODE),
+m_ShaderDispatchReason(HS_DISPATCH_REASON_DEFAULT),
 m_ForcedDispatchMask(0)
 {}
 
@@ -47,6 +47,7 @@ public:
     unsigned int m_pMaxPatchConstantSignatureDeclarations; // number of patch constant declarations
 
     HullShaderDispatchModes m_pShaderDispatchMode;
+    HullShaderDispatchReasons m_ShaderDispatchReason;
     bool m_HasClipCullAsInput;
     unsigned m_ForcedDispatchMask; // if this value is != 0, it is used as a dispatch mask in HS.
 
@@ -69,6 +70,7 @@ public:
     const HullShaderProperties& GetProperties() { return m_hsProps; }
 protected:
     HullShaderDispatchModes DetermineDispatchMode(llvm::Function* kernel) const;
+    HullShaderDispatchReasons DetermineDispatchReason(llvm::Function* kernel) const;
     unsigned GetForcedDispatchMask(llvm::Function* kernel) const;
     HullShaderProperties m_hsProps;
 };
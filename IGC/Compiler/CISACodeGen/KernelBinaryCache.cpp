@@ -0,0 +1,432 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#include "Compiler/CISACodeGen/KernelBinaryCache.hpp"
+#include "Compiler/CodeGenPublic.h"
+#include "common/igc_regkeys.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/SetVector.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/raw_ostream.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <map>
+#include <mutex>
+#include <set>
+
+using namespace llvm;
+using namespace IGC;
+using namespace IGC::IGCMD;
+
+namespace
+{
+    struct CacheEntry
+    {
+        std::vector<std::string> Binaries;
+        std::vector<TC::STB_KernelMetrics> Metrics;
+        uint64_t LastUse = 0;
+    };
+
+    struct CacheStorage
+    {
+        std::mutex Mutex;
+        std::map<std::string, CacheEntry> Entries;
+        uint64_t Clock = 0;
+    };
+
+    CacheStorage& getStorage()
+    {
+        static CacheStorage storage;
+        return storage;
+    }
+
+    void hashBuffer(MD5& hash, const void* pData, uint32_t size)
+    {
+        hash.update(ArrayRef<uint8_t>(reinterpret_cast<const uint8_t*>(&size), sizeof(size)));
+        if (pData && size)
+        {
+            hash.update(ArrayRef<uint8_t>(static_cast<const uint8_t*>(pData), size));
+        }
+    }
+
+    void hashString(MD5& hash, const std::string& str)
+    {
+        hashBuffer(hash, str.data(), (uint32_t)str.size());
+    }
+
+    template <typename T>
+    void hashValue(MD5& hash, const T& value)
+    {
+        hashBuffer(hash, &value, sizeof(T));
+    }
+
+    // Hashes the platform field by field rather than as raw structs: the
+    // SKU and WA tables are bit fields whose unused bits, like padding, hold
+    // whatever the driver left there. Of the tables only the flags codegen
+    // reads (CPlatform, CEncoder::SetVISAWaTable) are part of the key, so
+    // a new flag read by codegen has to be added here as well.
+    void hashPlatform(MD5& hash, const CPlatform& platform)
+    {
+        const PLATFORM& info = platform.getPlatformInfo();
+        hashValue(hash, (uint32_t)info.eProductFamily);
+        hashValue(hash, (uint32_t)info.ePCHProductFamily);
+        hashValue(hash, (uint32_t)info.eDisplayCoreFamily);
+        hashValue(hash, (uint32_t)info.eRenderCoreFamily);
+        hashValue(hash, (uint32_t)info.ePlatformType);
+        hashValue(hash, (uint32_t)info.usDeviceID);
+        hashValue(hash, (uint32_t)info.usRevId);
+        hashValue(hash, (uint32_t)info.usDeviceID_PCH);
+        hashValue(hash, (uint32_t)info.usRevId_PCH);
+        hashValue(hash, (uint32_t)info.eGTType);
+
+        // The fields the translation block sets, see SetGTSystemInfo.
+        const GT_SYSTEM_INFO sysInfo = platform.GetGTSystemInfo();
+        hashValue(hash, (uint32_t)sysInfo.EUCount);
+        hashValue(hash, (uint32_t)sysInfo.ThreadCount);
+        hashValue(hash, (uint32_t)sysInfo.SliceCount);
+        hashValue(hash, (uint32_t)sysInfo.SubSliceCount);
+        hashValue(hash, (uint32_t)sysInfo.TotalPsThreadsWindowerRange);
+        hashValue(hash, (uint32_t)sysInfo.TotalVsThreads);
+        hashValue(hash, (uint32_t)sysInfo.TotalVsThreads_Pocs);
+        hashValue(hash, (uint32_t)sysInfo.TotalDsThreads);
+        hashValue(hash, (uint32_t)sysInfo.TotalGsThreads);
+        hashValue(hash, (uint32_t)sysInfo.TotalHsThreads);
+        hashValue(hash, (uint32_t)sysInfo.MaxEuPerSubSlice);
+        hashValue(hash, (uint32_t)sysInfo.EuCountPerPoolMax);
+        hashValue(hash, (uint32_t)sysInfo.EuCountPerPoolMin);
+        hashValue(hash, (uint32_t)sysInfo.MaxSlicesSupported);
+        hashValue(hash, (uint32_t)sysInfo.MaxSubSlicesSupported);
+        hashValue(hash, (uint32_t)sysInfo.IsDynamicallyPopulated);
+        hashValue(hash, (uint32_t)sysInfo.CsrSizeInMb);
+
+        const SKU_FEATURE_TABLE& skuTable = platform.getSkuTable();
+        hashValue(hash, (uint32_t)skuTable.FtrGpGpuMidThreadLevelPreempt);
+        hashValue(hash, (uint32_t)skuTable.FtrWddm2Svm);
+        hashValue(hash, (uint32_t)skuTable.FtrPooledEuEnabled);
+
+        const WA_TABLE& waTable = platform.getWATable();
+        hashValue(hash, (uint32_t)waTable.WaHeaderRequiredOnSimd16Sample16bit);
+        hashValue(hash, (uint32_t)waTable.WaSendsSrc1SizeLimitWhenEOT);
+        hashValue(hash, (uint32_t)waTable.WaDisallow64BitImmMov);
+        hashValue(hash, (uint32_t)waTable.WaThreadSwitchAfterCall);
+        hashValue(hash, (uint32_t)waTable.WaSrc1ImmHfNotAllowed);
+        hashValue(hash, (uint32_t)waTable.WaDstSubRegNumNotAllowedWithLowPrecPacked);
+        hashValue(hash, (uint32_t)waTable.WaDisableMixedModeLog);
+        hashValue(hash, (uint32_t)waTable.WaDisableMixedModeFdiv);
+        hashValue(hash, (uint32_t)waTable.WaDisableMixedModePow);
+        hashValue(hash, (uint32_t)waTable.WaFloatMixedModeSelNotAllowedWithPackedDestination);
+        hashValue(hash, (uint32_t)waTable.WADisableWriteCommitForPageFault);
+        hashValue(hash, (uint32_t)waTable.WaClearArfDependenciesBeforeEot);
+        hashValue(hash, (uint32_t)waTable.WaMixModeSelInstDstNotPacked);
+        hashValue(hash, (uint32_t)waTable.WaClearTDRRegBeforeEOTForNonPS);
+        hashValue(hash, (uint32_t)waTable.WaDisableSIMD16On3SrcInstr);
+        hashValue(hash, (uint32_t)waTable.WaDisableSendsPreemption);
+        hashValue(hash, (uint32_t)waTable.WaNoSimd16TernarySrc0Imm);
+        hashValue(hash, (uint32_t)waTable.WaResetN0BeforeGatewayMessage);
+        hashValue(hash, (uint32_t)waTable.WaSendSEnableIndirectMsgDesc);
+        hashValue(hash, (uint32_t)waTable.Wa_1406306137);
+        hashValue(hash, (uint32_t)waTable.Wa_1406950495);
+        hashValue(hash, (uint32_t)waTable.Wa_2201674230);
+        hashValue(hash, (uint32_t)waTable.WAInsertNOPBetweenMathPOWDIVAnd2RegInstr);
+        hashValue(hash, (uint32_t)waTable.WaDisableIndirectDataForIndirectDispatch);
+        hashValue(hash, (uint32_t)waTable.WaNoA32ByteScatteredStatelessMessages);
+        hashValue(hash, (uint32_t)waTable.Wa_1407528679);
+        hashValue(hash, (uint32_t)waTable.WaConservativeRasterization);
+        hashValue(hash, (uint32_t)waTable.WaDisableDSDualPatchMode);
+        hashValue(hash, (uint32_t)waTable.WaDisableDSPushConstantsInFusedDownModeWithOnlyTwoSubslices);
+        hashValue(hash, (uint32_t)waTable.WaDisableEuBypassOnSimd16Float32);
+        hashValue(hash, (uint32_t)waTable.WaDisableSendsSrc0DstOverlap);
+        hashValue(hash, (uint32_t)waTable.WaDisableVSPushConstantsInFusedDownModeWithOnlyTwoSubslices);
+        hashValue(hash, (uint32_t)waTable.WaDispatchGRFHWIssueInGSAndHSUnit);
+        hashValue(hash, (uint32_t)waTable.WaDoNotPushConstantsForAllPulledGSTopologies);
+        hashValue(hash, (uint32_t)waTable.WaForceCB0ToBeZeroWhenSendingPC);
+        hashValue(hash, (uint32_t)waTable.WaForceMinMaxGSThreadCount);
+        hashValue(hash, (uint32_t)waTable.WaOCLEnableFMaxFMinPlusZero);
+        hashValue(hash, (uint32_t)waTable.WaReturnZeroforRTReadOutsidePrimitive);
+        hashValue(hash, (uint32_t)waTable.WaSamplerResponseLengthMustBeGreaterThan1);
+        hashValue(hash, (uint32_t)waTable.Wa_1805992985);
+        hashValue(hash, (uint32_t)waTable.Wa_220856683);
+    }
+
+    // Adds the functions reachable from F to funcs, F first. Returns false
+    // if a call target is unknown, so the code of the kernel isn't either.
+    bool collectCallees(Function* F, SetVector<Function*>& funcs)
+    {
+        funcs.insert(F);
+        for (unsigned i = 0; i < funcs.size(); ++i)
+        {
+            for (auto& I : instructions(*funcs[i]))
+            {
+                CallInst* CI = dyn_cast<CallInst>(&I);
+                if (!CI || CI->isInlineAsm())
+                {
+                    continue;
+                }
+                Function* callee = CI->getCalledFunction();
+                if (!callee)
+                {
+                    return false;
+                }
+                if (!callee->isDeclaration())
+                {
+                    funcs.insert(callee);
+                }
+            }
+        }
+        return true;
+    }
+
+    bool usesGlobal(const Value* V)
+    {
+        if (isa<GlobalVariable>(V))
+        {
+            return true;
+        }
+        if (const ConstantExpr* CE = dyn_cast<ConstantExpr>(V))
+        {
+            for (const Value* op : CE->operands())
+            {
+                if (usesGlobal(op))
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool usesGlobals(ArrayRef<Function*> funcs)
+    {
+        for (Function* F : funcs)
+        {
+            for (auto& I : instructions(*F))
+            {
+                for (const Value* op : I.operands())
+                {
+                    if (usesGlobal(op))
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+}
+
+std::string KernelBinaryCache::GetBuildKey(
+    const TC::STB_TranslateInputArgs* pInputArgs,
+    const CPlatform& platform)
+{
+    // The dumps of codegen would silently be skipped on a hit.
+    if (IGC_IS_FLAG_DISABLED(EnableKernelBinaryCache) ||
+        IGC_GET_FLAG_VALUE(KernelBinaryCacheMaxEntries) == 0 ||
+        IGC_IS_FLAG_ENABLED(ShaderDumpEnable) ||
+        pInputArgs->GTPinInput != nullptr)
+    {
+        return std::string();
+    }
+
+#if defined(IGC_DEBUG_VARIABLES)
+    // The key doesn't cover the regkeys, which a build may override for its
+    // own thread.
+    if (g_pThreadRegKeyList != nullptr)
+    {
+        return std::string();
+    }
+#endif
+
+    MD5 hash;
+    hashBuffer(hash, pInputArgs->pOptions, pInputArgs->OptionsSize);
+    hashBuffer(hash, pInputArgs->pInternalOptions, pInputArgs->InternalOptionsSize);
+    hashPlatform(hash, platform);
+
+    MD5::MD5Result result;
+    hash.final(result);
+    return result.digest().str().str();
+}
+
+void KernelBinaryCache::Lookup(OpenCLProgramContext* ctx)
+{
+    // The debug info of a kernel is not part of the cached binaries.
+    if (ctx->m_kernelBinaryCacheBuildKey.empty() ||
+        ctx->m_instrTypes.hasDebugInfo)
+    {
+        return;
+    }
+
+    MetaDataUtils* pMdUtils = ctx->getMetaDataUtils();
+    ModuleMetaData* modMD = ctx->getModuleMetaData();
+    Module* pModule = ctx->getModule();
+    LLVMContext& C = pModule->getContext();
+
+    // Kernels sharing their code with a duplicate are compiled, so that the
+    // duplicates get their binaries under their own name.
+    std::set<std::string> sharedKernels;
+    for (const auto& duplicate : ctx->m_duplicateKernels)
+    {
+        sharedKernels.insert(duplicate.first);
+        sharedKernels.insert(duplicate.second);
+    }
+
+    // What all kernels of the module depend on.
+    std::string moduleKey;
+    {
+        raw_string_ostream os(moduleKey);
+        os << ctx->m_kernelBinaryCacheBuildKey;
+        os << getBlob(modMD->compOpt, pModule);
+        os << getBlob(modMD->csInfo, pModule);
+        os << modMD->isPrecise << modMD->privateMemoryPerWI << modMD->MinNOSPushConstantSize;
+        os << modMD->UseBindlessImage << modMD->statefullResourcesNotAliased;
+    }
+
+    // The program-scope buffers and the offsets of the globals in them, for
+    // the kernels using globals.
+    std::string globalsKey;
+    {
+        raw_string_ostream os(globalsKey);
+        for (auto& GV : pModule->globals())
+        {
+            GV.print(os);
+            os << "\n";
+        }
+        std::map<std::string, int> offsets;
+        for (const auto& offset : modMD->inlineProgramScopeOffsets)
+        {
+            offsets[offset.first->getName().str()] = offset.second;
+        }
+        for (const auto& offset : offsets)
+        {
+            os << offset.first << ":" << offset.second << "\n";
+        }
+    }
+
+    CacheStorage& storage = getStorage();
+    for (auto i = pMdUtils->begin_FunctionsInfo(), e = pMdUtils->end_FunctionsInfo(); i != e; ++i)
+    {
+        Function* pFunc = i->first;
+        if (!isEntryFunc(pMdUtils, pFunc) || sharedKernels.count(pFunc->getName().str()))
+        {
+            continue;
+        }
+
+        SetVector<Function*> funcs;
+        if (!collectCallees(pFunc, funcs))
+        {
+            continue;
+        }
+
+        MD5 hash;
+        hashString(hash, moduleKey);
+        if (usesGlobals(funcs.getArrayRef()))
+        {
+            hashString(hash, globalsKey);
+        }
+        for (Function* F : funcs)
+        {
+            std::string funcKey;
+            raw_string_ostream os(funcKey);
+            F->print(os);
+
+            // Print the metadata attached to the instructions, rather than
+            // only the module-specific slot numbers they refer to.
+            SmallVector<std::pair<unsigned, MDNode*>, 4> MDs;
+            for (auto& I : instructions(*F))
+            {
+                I.getAllMetadata(MDs);
+                for (auto& MD : MDs)
+                {
+                    MD.second->printTree(os, pModule);
+                }
+            }
+
+            auto info = pMdUtils->findFunctionsInfoItem(F);
+            if (info != pMdUtils->end_FunctionsInfo())
+            {
+                info->second->generateNode(C)->printTree(os, pModule);
+            }
+            auto funcMD = modMD->FuncMD.find(F);
+            if (funcMD != modMD->FuncMD.end())
+            {
+                os << getBlob(funcMD->second, pModule);
+            }
+            hashString(hash, os.str());
+        }
+
+        MD5::MD5Result result;
+        hash.final(result);
+        std::string key = result.digest().str().str();
+        const std::string name = pFunc->getName().str();
+
+        std::lock_guard<std::mutex> lock(storage.Mutex);
+        auto it = storage.Entries.find(key);
+        if (it != storage.Entries.end())
+        {
+            it->second.LastUse = ++storage.Clock;
+            ctx->m_cachedKernelBinaries[name] = it->second.Binaries;
+            ctx->m_cachedKernelMetrics[name] = it->second.Metrics;
+        }
+        else
+        {
+            ctx->m_kernelBinaryCacheKeys[name] = key;
+        }
+    }
+}
+
+void KernelBinaryCache::Store(
+    const std::string& key,
+    const std::vector<std::string>& binaries,
+    const std::vector<TC::STB_KernelMetrics>& metrics)
+{
+    if (binaries.empty())
+    {
+        return;
+    }
+
+    CacheStorage& storage = getStorage();
+    std::lock_guard<std::mutex> lock(storage.Mutex);
+
+    CacheEntry& entry = storage.Entries[key];
+    entry.Binaries = binaries;
+    entry.Metrics = metrics;
+    entry.LastUse = ++storage.Clock;
+
+    const size_t maxEntries = IGC_GET_FLAG_VALUE(KernelBinaryCacheMaxEntries);
+    while (storage.Entries.size() > maxEntries)
+    {
+        auto lru = storage.Entries.begin();
+        for (auto it = storage.Entries.begin(); it != storage.Entries.end(); ++it)
+        {
+            if (it->second.LastUse < lru->second.LastUse)
+            {
+                lru = it;
+            }
+        }
+        storage.Entries.erase(lru);
+    }
+}
@@ -0,0 +1,73 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#pragma once
+
+#include "AdaptorOCL/OCL/TB/igc_tb.h"
+#include "Compiler/CISACodeGen/Platform.hpp"
+
+#include <string>
+#include <vector>
+
+namespace IGC
+{
+    class OpenCLProgramContext;
+
+    /// Process-wide cache of OpenCL kernel binaries.
+    ///
+    /// An entry holds the patch-token binaries of one kernel, one per SIMD
+    /// width sent to the runtime. Its key covers the build options and the
+    /// platform, the IR of the kernel and of the functions it calls as seen
+    /// after OptimizeIR, their metadata, and the program-scope globals when
+    /// the kernel uses any. A kernel whose key is found skips codegen and
+    /// gets the cached binaries, so rebuilding a program that links the same
+    /// code again, e.g. against a changed library, only runs codegen for the
+    /// kernels the change reached.
+    ///
+    /// Entries live in memory only; the least recently used one is evicted
+    /// once there are more than KernelBinaryCacheMaxEntries.
+    class KernelBinaryCache
+    {
+    public:
+        /// Key of the build inputs other than the module. Empty if the cache
+        /// is disabled or the build can't be cached.
+        static std::string GetBuildKey(
+            const TC::STB_TranslateInputArgs* pInputArgs,
+            const CPlatform& platform);
+
+        /// Computes the key of every kernel of ctx that may be cached. Fills
+        /// ctx->m_cachedKernelBinaries and ctx->m_cachedKernelMetrics with the
+        /// kernels found in the cache and ctx->m_kernelBinaryCacheKeys with
+        /// the others.
+        static void Lookup(OpenCLProgramContext* ctx);
+
+        /// Stores the binaries of a kernel under the key Lookup gave it, with
+        /// the metrics of each binary (pKernelName unset).
+        static void Store(
+            const std::string& key,
+            const std::vector<std::string>& binaries,
+            const std::vector<TC::STB_KernelMetrics>& metrics);
+    };
+}
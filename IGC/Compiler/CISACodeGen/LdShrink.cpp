@@ -62,6 +62,7 @@ namespace {
     }
 
     unsigned getExtractIndexMask(LoadInst *LI) const;
+    bool shrinkToNarrowVector(LoadInst *LI, unsigned Mask) const;
   };
 
   char LdShrink::ID = 0;
@@ -113,6 +114,57 @@ unsigned LdShrink::getExtractIndexMask(LoadInst *LI) const {
   return Mask;
 }
 
+// Shrink a vector load into a narrower vector load covering only the span
+// from the first to the last used element. Unused elements inside the span
+// are still loaded, so a sparse mask is handled as well as a dense one.
+bool LdShrink::shrinkToNarrowVector(LoadInst *LI, unsigned Mask) const {
+  VectorType *VTy = cast<VectorType>(LI->getType());
+  unsigned Offset = llvm::countTrailingZeros(Mask);
+  unsigned Length = 32 - llvm::countLeadingZeros(Mask) - Offset;
+  if (Length >= VTy->getNumElements())
+    return false;
+  // Only shrink to vector sizes a single message can return.
+  if (Length != 2 && Length != 3 && Length != 4 && Length != 8 && Length != 16)
+    return false;
+
+  IRBuilder<> Builder(LI);
+
+  auto Ptr = LI->getPointerOperand();
+  Type *ScalarTy = VTy->getScalarType();
+  VectorType *NarrowTy = VectorType::get(ScalarTy, Length);
+  PointerType *PtrTy = cast<PointerType>(Ptr->getType());
+  Value *NarrowPtr = Ptr;
+  if (Offset) {
+    PointerType *ScalarPtrTy
+      = PointerType::get(ScalarTy, PtrTy->getAddressSpace());
+    NarrowPtr = Builder.CreatePointerCast(Ptr, ScalarPtrTy);
+    NarrowPtr = Builder.CreateInBoundsGEP(NarrowPtr, Builder.getInt32(Offset));
+  }
+  NarrowPtr = Builder.CreatePointerCast(NarrowPtr,
+                PointerType::get(NarrowTy, PtrTy->getAddressSpace()));
+
+  unsigned Align
+      = int_cast<unsigned int>(MinAlign(LI->getAlignment(),
+               DL->getTypeStoreSize(ScalarTy) * Offset));
+
+  LoadInst *NewLoad = Builder.CreateAlignedLoad(NarrowPtr, Align);
+  NewLoad->setDebugLoc(LI->getDebugLoc());
+
+  SmallVector<ExtractElementInst *, 8> Extracts;
+  for (auto U : LI->users())
+    Extracts.push_back(cast<ExtractElementInst>(U));
+  for (auto EEI : Extracts) {
+    uint64_t Idx = cast<ConstantInt>(EEI->getIndexOperand())->getZExtValue();
+    Builder.SetInsertPoint(EEI);
+    Value *NewEEI = Builder.CreateExtractElement(NewLoad,
+                      Builder.getInt32(int_cast<uint32_t>(Idx - Offset)));
+    EEI->replaceAllUsesWith(NewEEI);
+  }
+  // The original load and extracts are now dead and left to DCE, as the
+  // caller is still iterating over this block.
+  return true;
+}
+
 bool LdShrink::runOnFunction(Function &F) {
     DL = &F.getParent()->getDataLayout();
   if (!DL)
@@ -132,13 +184,13 @@ bool LdShrink::runOnFunction(Function &F) {
       unsigned Mask = getExtractIndexMask(LI);
       if (!Mask)
         continue;
-      if (!isShiftedMask_32(Mask))
-        continue;
       unsigned Offset = llvm::countTrailingZeros(Mask);
-      unsigned Length = llvm::countTrailingZeros((Mask >> Offset) + 1);
-      // TODO: So far skip narrow vector.
-      if (Length != 1)
+      if (!isShiftedMask_32(Mask) || (Mask >> Offset) != 1) {
+        if (IGC_IS_FLAG_ENABLED(EnableLdShrinkNarrowVector) &&
+            shrinkToNarrowVector(LI, Mask))
+          Changed = true;
         continue;
+      }
 
       IRBuilder<> Builder(LI);
 
@@ -24,6 +24,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 ======================= end_copyright_notice ==================================*/
 #include "Compiler/CISACodeGen/LinkTessControlShaderMCFPass.h"
+#include "Compiler/CISACodeGen/LinkTessControlShaderPass.h"
 #include "Compiler/IGCPassSupport.h"
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/IR/Constants.h>
@@ -340,7 +341,6 @@ namespace IGC
 
     HullShaderDispatchModes LinkTessControlShaderMCF::DetermineDispatchMode(void)
     {
-        llvm::NamedMDNode *metaData = GetModule()->getOrInsertNamedMetadata("HullShaderDispatchMode");
         IGC::CodeGenContext* pCodeGenContext = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
 
         /* Instance Count
@@ -358,32 +358,25 @@ namespace IGC
         // Use HS single patch if WA exists and input control points >= 29 as not enough registers for push constants
         bool useSinglePatch = !(pCodeGenContext->platform.WaDispatchGRFHWIssueInGSAndHSUnit() && inputControlPointCount >= 29);
                 
-        if (pCodeGenContext->platform.useOnlyEightPatchDispatchHS() ||
-            (pCodeGenContext->platform.supportHSEightPatchDispatch() &&
-            !(m_useMultipleHardwareThread && mOutputControlPointCount >= 16) &&
-            useSinglePatch &&
-            IGC_IS_FLAG_DISABLED(EnableHSSinglePatchDispatch)))
+        HullShaderDispatchModes dispatchMode = HullShaderDispatchModes::SINGLE_PATCH_DISPATCH_MODE;
+        HullShaderDispatchReasons reason = HS_DISPATCH_REASON_DEFAULT;
+        if (pCodeGenContext->platform.useOnlyEightPatchDispatchHS())
         {
-            Constant* cval = llvm::ConstantInt::get(
-                Builder().getInt32Ty(),
-                HullShaderDispatchModes::EIGHT_PATCH_DISPATCH_MODE);
-            llvm::MDNode *mdNode = llvm::MDNode::get(
-                Builder().getContext(),
-                llvm::ConstantAsMetadata::get(cval));
-            metaData->addOperand(mdNode);
-            return HullShaderDispatchModes::EIGHT_PATCH_DISPATCH_MODE;
+            dispatchMode = HullShaderDispatchModes::EIGHT_PATCH_DISPATCH_MODE;
         }
-        else
+        else if (pCodeGenContext->platform.supportHSEightPatchDispatch() &&
+            !(m_useMultipleHardwareThread && mOutputControlPointCount >= 16) &&
+            useSinglePatch &&
+            IGC_IS_FLAG_DISABLED(EnableHSSinglePatchDispatch))
         {
-            Constant* cval = llvm::ConstantInt::get(
-                Builder().getInt32Ty(),
-                HullShaderDispatchModes::SINGLE_PATCH_DISPATCH_MODE);
-            llvm::MDNode *mdNode = llvm::MDNode::get(
-                Builder().getContext(),
-                llvm::ConstantAsMetadata::get(cval));
-            metaData->addOperand(mdNode);
-            return HullShaderDispatchModes::SINGLE_PATCH_DISPATCH_MODE;
+            reason = CheckHSEightPatchCost(GetModule());
+            if (reason == HS_DISPATCH_REASON_DEFAULT)
+            {
+                dispatchMode = HullShaderDispatchModes::EIGHT_PATCH_DISPATCH_MODE;
+            }
         }
+        SetHSDispatchModeMetadata(GetModule(), dispatchMode, reason);
+        return dispatchMode;
     }
 
     //////////////////////////////////////////////////////////////////////////
@@ -96,8 +96,6 @@ namespace IGC
 
     HullShaderDispatchModes LinkTessControlShader::DetermineDispatchMode(llvm::Module* mod, llvm::IRBuilder<> *irBuilder)
     {
-        llvm::NamedMDNode *metaData = mod->getOrInsertNamedMetadata("HullShaderDispatchMode");
-
         // now find out the output control point count
         llvm::GlobalVariable* pOCPCount = mod->getGlobalVariable("HSOutputControlPointCount");
         uint32_t outputControlPointCount = int_cast<uint32_t>(llvm::cast<llvm::ConstantInt>(pOCPCount->getInitializer())->getZExtValue());
@@ -119,33 +117,65 @@ namespace IGC
         //use HS single patch if WA exists and input control points >= 29 as not enough registers for push constants
         bool useSinglePatch = !(pCodeGenContext->platform.WaDispatchGRFHWIssueInGSAndHSUnit() && inputControlPointCount >= 29);
 
-        if (pCodeGenContext->platform.useOnlyEightPatchDispatchHS() ||
-            (pCodeGenContext->platform.supportHSEightPatchDispatch() &&
+        HullShaderDispatchModes dispatchMode = HullShaderDispatchModes::SINGLE_PATCH_DISPATCH_MODE;
+        HullShaderDispatchReasons reason = HS_DISPATCH_REASON_DEFAULT;
+        if (pCodeGenContext->platform.useOnlyEightPatchDispatchHS())
+        {
+            dispatchMode = HullShaderDispatchModes::EIGHT_PATCH_DISPATCH_MODE;
+        }
+        else if (pCodeGenContext->platform.supportHSEightPatchDispatch() &&
              !(m_useMultipleHardwareThread && outputControlPointCount >= 16) &&
              useSinglePatch &&
-             IGC_IS_FLAG_DISABLED(EnableHSSinglePatchDispatch)))
+             IGC_IS_FLAG_DISABLED(EnableHSSinglePatchDispatch))
         {
-            Constant* cval = llvm::ConstantInt::get(
-                irBuilder->getInt32Ty(),
-                HullShaderDispatchModes::EIGHT_PATCH_DISPATCH_MODE);
-            llvm::MDNode *mdNode = llvm::MDNode::get(
-                irBuilder->getContext(),
-                llvm::ConstantAsMetadata::get(cval));
-            metaData->addOperand(mdNode);
-            return HullShaderDispatchModes::EIGHT_PATCH_DISPATCH_MODE;
+            reason = CheckHSEightPatchCost(mod);
+            if (reason == HS_DISPATCH_REASON_DEFAULT)
+            {
+                dispatchMode = HullShaderDispatchModes::EIGHT_PATCH_DISPATCH_MODE;
+            }
         }
-        else
+        SetHSDispatchModeMetadata(mod, dispatchMode, reason);
+        return dispatchMode;
+    }
+
+    HullShaderDispatchReasons CheckHSEightPatchCost(llvm::Module* mod)
+    {
+        if (IGC_IS_FLAG_DISABLED(EnableHSDispatchModeCostModel) ||
+            IGC_IS_FLAG_ENABLED(EnableHSEightPatchDispatch))
         {
-            Constant* cval = llvm::ConstantInt::get(
-                irBuilder->getInt32Ty(),
-                HullShaderDispatchModes::SINGLE_PATCH_DISPATCH_MODE);
-            llvm::MDNode *mdNode = llvm::MDNode::get(
-                irBuilder->getContext(),
-                llvm::ConstantAsMetadata::get(cval));
-            metaData->addOperand(mdNode);
-            return HullShaderDispatchModes::SINGLE_PATCH_DISPATCH_MODE;
+            return HS_DISPATCH_REASON_DEFAULT;
         }
+
+        llvm::GlobalVariable* pGlobal = mod->getGlobalVariable("TessInputControlPointCount");
+        unsigned int inputControlPointCount = int_cast<unsigned int>(llvm::cast<llvm::ConstantInt>(pGlobal->getInitializer())->getZExtValue());
+        pGlobal = mod->getGlobalVariable("MaxNumOfInputSignatureEntries");
+        unsigned int maxInputSignatureCount = pGlobal ?
+            int_cast<unsigned int>(llvm::cast<llvm::ConstantInt>(pGlobal->getInitializer())->getZExtValue()) : 0;
+
+        // Same limit as HullShaderProperties::GetMaxInputPushed() for 8 patches
+        const unsigned int maxNumOfHSPushedInputs = 96;
+        const unsigned int numberOfPatches = 8;
+        unsigned int pushedAttributesPerICP = inputControlPointCount > 0 ?
+            maxNumOfHSPushedInputs / (inputControlPointCount * numberOfPatches) : 0;
+        pushedAttributesPerICP = std::min(pushedAttributesPerICP & ~1u, maxInputSignatureCount);
+
+        // R0 and the output URB handles, one GRF of input URB handles per control point
+        // (a handle per patch), and 4 GRFs per pushed vec4 attribute of a control point.
+        unsigned int payloadGRFs = 2 + inputControlPointCount + inputControlPointCount * pushedAttributesPerICP * 4;
+        return payloadGRFs > IGC_GET_FLAG_VALUE(HSEightPatchMaxPayloadGRFs) ?
+            HS_DISPATCH_REASON_PAYLOAD : HS_DISPATCH_REASON_DEFAULT;
     }
+
+    void SetHSDispatchModeMetadata(llvm::Module* mod, HullShaderDispatchModes mode, HullShaderDispatchReasons reason)
+    {
+        llvm::NamedMDNode *metaData = mod->getOrInsertNamedMetadata("HullShaderDispatchMode");
+        llvm::Type* int32Ty = llvm::Type::getInt32Ty(mod->getContext());
+        llvm::Metadata* values[] = {
+            llvm::ConstantAsMetadata::get(llvm::ConstantInt::get(int32Ty, mode)),
+            llvm::ConstantAsMetadata::get(llvm::ConstantInt::get(int32Ty, reason)) };
+        metaData->addOperand(llvm::MDNode::get(mod->getContext(), values));
+    }
+
     /*
         Function pass to create a new entry function
     */
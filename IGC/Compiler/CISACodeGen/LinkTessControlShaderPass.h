@@ -30,11 +30,20 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/Pass.h>
 #include "common/LLVMWarningsPop.hpp"
 #include "Compiler/InitializePasses.h"
+#include "Compiler/CodeGenPublicEnums.h"
 void initializeLinkTessControlShaderPass(llvm::PassRegistry&);
 
 namespace IGC
 {
     llvm::Pass* createLinkTessControlShader();
+
+    /// Returns HS_DISPATCH_REASON_PAYLOAD if the estimated payload of an
+    /// eight-patch thread is too large for the HS in mod to be dispatched
+    /// that way, HS_DISPATCH_REASON_DEFAULT otherwise.
+    HullShaderDispatchReasons CheckHSEightPatchCost(llvm::Module* mod);
+
+    /// Records the dispatch mode and the reason for it as module metadata.
+    void SetHSDispatchModeMetadata(llvm::Module* mod, HullShaderDispatchModes mode, HullShaderDispatchReasons reason);
 }
 
 #endif
\ No newline at end of file
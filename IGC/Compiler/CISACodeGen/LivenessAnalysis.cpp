@@ -166,8 +166,15 @@ inline void LivenessAnalysis::setKillInsts(Value *V, Instruction *kill)
 
 bool LivenessAnalysis::isInstLastUseOfValue(Value *V, Instruction *I)
 {
-    ValueVec& VS = KillInsts[I];
-    for (int i = 0, e = (int)VS.size(); i < e; ++I)
+    // Use find() so that queries on instructions without kills do not
+    // insert empty entries into KillInsts.
+    ValueToValueVecMap::iterator II = KillInsts.find(I);
+    if (II == KillInsts.end())
+    {
+        return false;
+    }
+    ValueVec& VS = II->second;
+    for (int i = 0, e = (int)VS.size(); i < e; ++i)
     {
         if (VS[i] == V)
         {
@@ -278,7 +285,13 @@ void LivenessAnalysis::calculate(Function *F)
 
 void LivenessAnalysis::print_livein(raw_ostream& OS, BasicBlock *BB)
 {
-    SBitVector& BitVec = BBLiveIns[BB];
+    BBLiveInMap::iterator BI = BBLiveIns.find(BB);
+    if (BI == BBLiveIns.end())
+    {
+        OS << "    Live-In-Values (#values = 0 ):\n\n";
+        return;
+    }
+    SBitVector& BitVec = BI->second;
     OS << "    Live-In-Values (#values = " << BitVec.count() << " ):\n";
 
     SBitVector::iterator I, E;
@@ -0,0 +1,364 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/DepthFirstIterator.h>
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/Analysis/AliasAnalysis.h>
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/Analysis/MemoryLocation.h>
+#include <llvm/Analysis/ValueTracking.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/Pass.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include "Compiler/CISACodeGen/ShaderCodeGen.hpp"
+#include "Compiler/CISACodeGen/RegisterPressureEstimate.hpp"
+#include "Compiler/IGCPassSupport.h"
+#include "Compiler/CISACodeGen/LoopLoadPipelining.h"
+
+using namespace llvm;
+using namespace IGC;
+
+// Software-pipeline the loads of single-block innermost loops by one stage:
+// the load for iteration i+1 is issued at the top of iteration i, and
+// iteration i+1 picks its value up through a header PHI. The send latency
+// is then hidden behind the rest of iteration i instead of stalling its
+// first use.
+//
+//   preheader:                       preheader:
+//                                      %v0 = load %p(entry)
+//   loop:                            loop:
+//     %i = phi ...                     %i = phi ...
+//                            ==>       %v = phi [%v0, preheader], [%vn, loop]
+//                                      %pn = select %c, %p(next), %p(%i)
+//                                      %vn = load %pn
+//     %v = load %p(%i)
+//     ...                              ...
+//     br %c, loop, exit                br %c, loop, exit
+//
+// On the last iteration the address is redirected to the current one, so
+// no memory beyond what the original loop reads is ever touched.
+
+namespace {
+
+// GRF budget shared with private memory promotion.
+const unsigned MAX_PRESSURE_GRF_NUM = 64;
+
+const unsigned MAX_REBUILD_DEPTH = 16;
+
+class LoopLoadPipelining : public FunctionPass {
+  LoopInfo *LI;
+  AliasAnalysis *AA;
+  RegisterPressureEstimate *RPE;
+  unsigned PressureBudget;
+
+public:
+  static char ID;
+
+  LoopLoadPipelining()
+      : FunctionPass(ID), LI(nullptr), AA(nullptr), RPE(nullptr),
+        PressureBudget(0), Body(nullptr), Preheader(nullptr),
+        InsertPos(nullptr) {
+    initializeLoopLoadPipeliningPass(*PassRegistry::getPassRegistry());
+  }
+
+  bool runOnFunction(Function &F) override;
+
+  StringRef getPassName() const override { return "Loop Load Pipelining"; }
+
+private:
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.setPreservesCFG();
+    AU.addRequired<CodeGenContextWrapper>();
+    AU.addRequired<LoopInfoWrapperPass>();
+    AU.addRequired<AAResultsWrapperPass>();
+    AU.addRequired<RegisterPressureEstimate>();
+  }
+
+  bool pipelineLoop(Loop *L);
+
+  // Rebuilding state of the loop being pipelined.
+  BasicBlock *Body;
+  BasicBlock *Preheader;
+  // Instructions of Body already placed above InsertPos.
+  SmallPtrSet<Instruction *, 16> Hoisted;
+  Instruction *InsertPos;
+  DenseMap<Value *, Value *> NextValues;
+  DenseMap<Value *, Value *> EntryValues;
+
+  // Check if V can be recomputed from the header PHIs and loop-invariant
+  // values. With ThroughPHIs set, PHIs are followed into their value for
+  // the next iteration.
+  bool isComputable(Value *V, bool ThroughPHIs, unsigned Depth) const;
+
+  // Make the current iteration's value of V available before InsertPos by
+  // moving its computation up.
+  Value *hoistCurrent(Value *V);
+  // Compute the next iteration's value of V before InsertPos.
+  Value *buildNext(Value *V);
+  // Compute the first iteration's value of V in the preheader.
+  Value *buildEntry(Value *V);
+
+  bool isRebuildable(Instruction *I) const {
+    return !isa<PHINode>(I) && !I->mayReadOrWriteMemory() &&
+           !I->mayHaveSideEffects() && isSafeToSpeculativelyExecute(I);
+  }
+};
+
+char LoopLoadPipelining::ID = 0;
+
+} // End anonymous namespace
+
+FunctionPass *IGC::createLoopLoadPipeliningPass() {
+  return new LoopLoadPipelining();
+}
+
+#define PASS_FLAG     "igc-loop-load-pipelining"
+#define PASS_DESC     "Pipeline loads of innermost loops"
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS false
+namespace IGC {
+IGC_INITIALIZE_PASS_BEGIN(LoopLoadPipelining, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+IGC_INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
+IGC_INITIALIZE_PASS_DEPENDENCY(AAResultsWrapperPass)
+IGC_INITIALIZE_PASS_DEPENDENCY(RegisterPressureEstimate)
+IGC_INITIALIZE_PASS_END(LoopLoadPipelining, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+} // End namespace IGC
+
+bool LoopLoadPipelining::runOnFunction(Function &F) {
+  RPE = &getAnalysis<RegisterPressureEstimate>();
+  // Without a pressure estimate there is no way to tell whether the extra
+  // live values would spill.
+  if (!RPE->isAvailable())
+    return false;
+
+  CodeGenContext *Ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+  float GRFRatio = Ctx->getNumGRFPerThread() / 128.0f;
+  PressureBudget = unsigned(GRFRatio * MAX_PRESSURE_GRF_NUM * 4);
+
+  LI = &getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
+  AA = &getAnalysis<AAResultsWrapperPass>().getAAResults();
+
+  SmallVector<Loop *, 8> InnermostLoops;
+  for (auto I = LI->begin(), E = LI->end(); I != E; ++I)
+    for (auto DFI = df_begin(*I), DFE = df_end(*I); DFI != DFE; ++DFI) {
+      Loop *L = *DFI;
+      if (L->empty())
+        InnermostLoops.push_back(L);
+    }
+
+  bool Changed = false;
+  for (Loop *L : InnermostLoops)
+    Changed |= pipelineLoop(L);
+
+  return Changed;
+}
+
+bool LoopLoadPipelining::pipelineLoop(Loop *L) {
+  // Only single-block loops, where the header is also the latch and every
+  // load in it runs on every iteration.
+  if (L->getNumBlocks() != 1)
+    return false;
+  Body = L->getHeader();
+  Preheader = L->getLoopPreheader();
+  if (!Preheader)
+    return false;
+
+  BranchInst *Br = dyn_cast<BranchInst>(Body->getTerminator());
+  if (!Br || !Br->isConditional())
+    return false;
+  bool ContinueOnTrue = Br->getSuccessor(0) == Body;
+
+  // Loads move ahead of the stores of the current iteration, so every store
+  // must be provably disjoint from them. Anything else writing memory
+  // (atomics, barriers, fences, calls) keeps the order as is.
+  SmallVector<StoreInst *, 8> Stores;
+  SmallVector<LoadInst *, 8> Candidates;
+  for (auto &I : *Body) {
+    if (auto *SI = dyn_cast<StoreInst>(&I)) {
+      if (!SI->isSimple())
+        return false;
+      Stores.push_back(SI);
+      continue;
+    }
+    if (I.mayWriteToMemory())
+      return false;
+    auto *LD = dyn_cast<LoadInst>(&I);
+    if (!LD || !LD->isSimple())
+      continue;
+    // Loop-invariant addresses are LICM's business.
+    auto *Ptr = dyn_cast<Instruction>(LD->getPointerOperand());
+    if (!Ptr || Ptr->getParent() != Body)
+      continue;
+    Candidates.push_back(LD);
+  }
+
+  unsigned Pressure = RPE->getRegisterPressure(Body);
+  bool Changed = false;
+  Hoisted.clear();
+  NextValues.clear();
+  EntryValues.clear();
+  InsertPos = Body->getFirstNonPHI();
+  for (LoadInst *LD : Candidates) {
+    // The pipelined value lives across the whole body, alongside the value
+    // of the current iteration.
+    unsigned Size = LD->getType()->getPrimitiveSizeInBits() / 8;
+    if (Size == 0 || Pressure + Size > PressureBudget)
+      continue;
+
+    Value *Ptr = LD->getPointerOperand();
+    MemoryLocation LoadLoc(Ptr, MemoryLocation::UnknownSize);
+    bool Disjoint = true;
+    for (StoreInst *SI : Stores) {
+      MemoryLocation StoreLoc(SI->getPointerOperand(), MemoryLocation::UnknownSize);
+      if (AA->alias(LoadLoc, StoreLoc) != NoAlias) {
+        Disjoint = false;
+        break;
+      }
+    }
+    if (!Disjoint)
+      continue;
+
+    if (!isComputable(Br->getCondition(), false, 0) ||
+        !isComputable(Ptr, true, 0))
+      continue;
+
+    Value *Cond = hoistCurrent(Br->getCondition());
+    Value *CurPtr = hoistCurrent(Ptr);
+    Value *NextPtr = buildNext(Ptr);
+    Value *EntryPtr = buildEntry(Ptr);
+
+    IRBuilder<> EntryBuilder(Preheader->getTerminator());
+    LoadInst *EntryLD = cast<LoadInst>(LD->clone());
+    EntryLD->setOperand(LD->getPointerOperandIndex(), EntryPtr);
+    EntryBuilder.Insert(EntryLD, LD->getName() + ".pipe.entry");
+
+    IRBuilder<> Builder(InsertPos);
+    Value *Addr = ContinueOnTrue
+        ? Builder.CreateSelect(Cond, NextPtr, CurPtr, "pipe.addr")
+        : Builder.CreateSelect(Cond, CurPtr, NextPtr, "pipe.addr");
+    LoadInst *NextLD = cast<LoadInst>(LD->clone());
+    NextLD->setOperand(LD->getPointerOperandIndex(), Addr);
+    Builder.Insert(NextLD, LD->getName() + ".pipe.next");
+
+    PHINode *PN = PHINode::Create(LD->getType(), 2, LD->getName() + ".pipe",
+                                  &Body->front());
+    PN->addIncoming(EntryLD, Preheader);
+    PN->addIncoming(NextLD, Body);
+    LD->replaceAllUsesWith(PN);
+    LD->eraseFromParent();
+
+    Pressure += Size;
+    Changed = true;
+  }
+
+  return Changed;
+}
+
+bool LoopLoadPipelining::isComputable(Value *V, bool ThroughPHIs,
+                                      unsigned Depth) const {
+  Instruction *I = dyn_cast<Instruction>(V);
+  if (!I || I->getParent() != Body)
+    return true;
+  if (Depth > MAX_REBUILD_DEPTH)
+    return false;
+  if (PHINode *PN = dyn_cast<PHINode>(I))
+    return !ThroughPHIs ||
+           isComputable(PN->getIncomingValueForBlock(Body), false, Depth + 1);
+  if (!isRebuildable(I))
+    return false;
+  for (Value *Op : I->operands())
+    if (!isComputable(Op, ThroughPHIs, Depth + 1))
+      return false;
+  return true;
+}
+
+Value *LoopLoadPipelining::hoistCurrent(Value *V) {
+  Instruction *I = dyn_cast<Instruction>(V);
+  if (!I || I->getParent() != Body || isa<PHINode>(I) || Hoisted.count(I))
+    return V;
+
+  for (Value *Op : I->operands())
+    hoistCurrent(Op);
+
+  if (I == InsertPos)
+    InsertPos = InsertPos->getNextNode();
+  else
+    I->moveBefore(InsertPos);
+  Hoisted.insert(I);
+  return I;
+}
+
+Value *LoopLoadPipelining::buildNext(Value *V) {
+  Instruction *I = dyn_cast<Instruction>(V);
+  if (!I || I->getParent() != Body)
+    return V;
+  if (PHINode *PN = dyn_cast<PHINode>(I))
+    return hoistCurrent(PN->getIncomingValueForBlock(Body));
+
+  auto Iter = NextValues.find(I);
+  if (Iter != NextValues.end())
+    return Iter->second;
+
+  SmallVector<Value *, 4> Ops;
+  for (Value *Op : I->operands())
+    Ops.push_back(buildNext(Op));
+
+  Instruction *Clone = I->clone();
+  for (unsigned i = 0, e = Ops.size(); i != e; ++i)
+    Clone->setOperand(i, Ops[i]);
+  Clone->setName(I->getName() + ".pipe.next");
+  Clone->insertBefore(InsertPos);
+  NextValues[I] = Clone;
+  return Clone;
+}
+
+Value *LoopLoadPipelining::buildEntry(Value *V) {
+  Instruction *I = dyn_cast<Instruction>(V);
+  if (!I || I->getParent() != Body)
+    return V;
+  if (PHINode *PN = dyn_cast<PHINode>(I))
+    return PN->getIncomingValueForBlock(Preheader);
+
+  auto Iter = EntryValues.find(I);
+  if (Iter != EntryValues.end())
+    return Iter->second;
+
+  SmallVector<Value *, 4> Ops;
+  for (Value *Op : I->operands())
+    Ops.push_back(buildEntry(Op));
+
+  Instruction *Clone = I->clone();
+  for (unsigned i = 0, e = Ops.size(); i != e; ++i)
+    Clone->setOperand(i, Ops[i]);
+  Clone->setName(I->getName() + ".pipe.entry");
+  Clone->insertBefore(Preheader->getTerminator());
+  EntryValues[I] = Clone;
+  return Clone;
+}
@@ -45,6 +45,9 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #define MAX_ALLOCA_PROMOTE_GRF_NUM      48
 #define MAX_PRESSURE_GRF_NUM            64
+// Number of GRFs (out of 128) kept free of promoted allocas when
+// EnableLargePrivMemPromotion raises the pressure ceiling.
+#define LARGE_PROMOTE_RESERVED_GRF_NUM  32
 
 using namespace llvm;
 using namespace IGC;
@@ -242,11 +245,12 @@ bool LowerGEPForPrivMem::CheckIfAllocaPromotable(llvm::AllocaInst* pAlloca)
     float grfRatio = m_ctx->getNumGRFPerThread() / 128.0f;
     allowedAllocaSizeInBytes = (uint32_t) (allowedAllocaSizeInBytes * grfRatio);
 
+    unsigned d = 1;
     if (m_ctx->type == ShaderType::COMPUTE_SHADER)
     {
         ComputeShaderContext* ctx = static_cast<ComputeShaderContext*>(m_ctx);
         SIMDMode simdMode = ctx->GetLeastSIMDModeAllowed();
-        unsigned d = simdMode == SIMDMode::SIMD32 ? 4 : 1;
+        d = simdMode == SIMDMode::SIMD32 ? 4 : 1;
 
         allowedAllocaSizeInBytes = allowedAllocaSizeInBytes / d;
     }
@@ -286,6 +290,15 @@ bool LowerGEPForPrivMem::CheckIfAllocaPromotable(llvm::AllocaInst* pAlloca)
     GetAllocaLiverange(pAlloca, lowestAssignedNumber, highestAssignedNumber, m_pRegisterPressureEstimate);
     
     uint32_t maxGRFPressure = (uint32_t)(grfRatio * MAX_PRESSURE_GRF_NUM * 4);
+    if (IGC_IS_FLAG_ENABLED(EnableLargePrivMemPromotion))
+    {
+        // Let medium-sized arrays use the register file up to the point where only
+        // the reserved quarter is left for temporaries; dynamic indices are lowered
+        // to indirect accesses on the promoted vector.
+        uint32_t largeGRFPressure =
+            (uint32_t)(grfRatio * (128 - LARGE_PROMOTE_RESERVED_GRF_NUM) * 4) / d;
+        maxGRFPressure = std::max(maxGRFPressure, largeGRFPressure);
+    }
 
     unsigned int pressure = 0;
     for(unsigned int i = lowestAssignedNumber; i <= highestAssignedNumber; i++)
@@ -440,6 +453,37 @@ bool IGC::CanUseSOALayout(AllocaInst* I, Type*& base)
     return useSOA;
 }
 
+// Check whether lanes may index the alloca differently, i.e. whether any GEP
+// index on the way to its loads and stores is not uniform.
+static bool HasDivergentIndex(Instruction* I, WIAnalysis* WI)
+{
+    for (auto *U : I->users())
+    {
+        if (GetElementPtrInst *pGEP = dyn_cast<GetElementPtrInst>(U))
+        {
+            for (auto Idx = pGEP->idx_begin(), E = pGEP->idx_end(); Idx != E; ++Idx)
+            {
+                if (!isa<Constant>(*Idx) && WI->whichDepend(*Idx) != WIAnalysis::UNIFORM)
+                {
+                    return true;
+                }
+            }
+            if (HasDivergentIndex(pGEP, WI))
+            {
+                return true;
+            }
+        }
+        else if (BitCastInst *pBC = dyn_cast<BitCastInst>(U))
+        {
+            if (HasDivergentIndex(pBC, WI))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 void LowerGEPForPrivMem::visitAllocaInst(AllocaInst &I)
 {
     // Alloca should always be private memory
@@ -447,6 +491,15 @@ void LowerGEPForPrivMem::visitAllocaInst(AllocaInst &I)
     if (!CheckIfAllocaPromotable(&I))
     {
         // alloca size extends remain per-lane-reg space
+        if (IGC_IS_FLAG_ENABLED(EnablePrivateLayoutByUniformity) &&
+            !I.getMetadata("uniform") &&
+            HasDivergentIndex(&I, &getAnalysis<WIAnalysis>()))
+        {
+            // Lanes reading different elements gain nothing from the
+            // SIMD-interleaved layout, keep each lane's copy contiguous.
+            MDNode* node = MDNode::get(I.getContext(), ConstantAsMetadata::get(ConstantInt::getTrue(I.getContext())));
+            I.setMetadata("divergent_index", node);
+        }
         return;
     }
     m_allocasToPrivMem.push_back(&I);
@@ -24,14 +24,18 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 ======================= end_copyright_notice ==================================*/
 #include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/DenseSet.h>
 #include <llvm/ADT/STLExtras.h>
 #include <llvmWrapper/Analysis/MemoryLocation.h>
 #include <llvm/Analysis/AliasAnalysis.h>
 #include <llvm/Analysis/InstructionSimplify.h>
+#include <llvm/Analysis/PostDominators.h>
 #include <llvm/Analysis/ScalarEvolution.h>
 #include <llvm/Analysis/ScalarEvolutionExpressions.h>
 #include <llvm/Analysis/ValueTracking.h>
+#include <llvm/IR/CFG.h>
 #include <llvm/IR/DataLayout.h>
+#include <llvm/IR/Dominators.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/GlobalAlias.h>
 #include <llvm/IR/IRBuilder.h>
@@ -63,11 +67,18 @@ namespace {
   //   the non-tailing store is merged into the tailing one, iff there's no
   //   memory dependency between them which may results in different result.
   //
+  // With EnableMemOptCrossBlock, a block is also merged with its control-
+  // equivalent successor, i.e. its immediate post-dominator when it dominates
+  // that one. Memory references in the blocks in between are checked for
+  // dependency but never merged as they execute conditionally.
+  //
   class MemOpt : public FunctionPass {
     const DataLayout *DL;
     AliasAnalysis *AA;
     ScalarEvolution *SE;
     WIAnalysis *WI;
+    DominatorTree *DT;
+    PostDominatorTree *PDT;
 
     CodeGenContext *CGC;
     TargetLibraryInfo *TLI;
@@ -83,12 +94,22 @@ namespace {
     typedef std::vector<std::pair<Instruction *, unsigned> > MemRefListTy;
     typedef std::vector<Instruction *> TrivialMemRefListTy;
 
+    // Memory references from blocks between two control-equivalent blocks.
+    // They are only checked for dependency and never merged.
+    DenseSet<const Instruction *> CondMemRefs;
+
+    // The maximal number of blocks between two control-equivalent blocks.
+    static const unsigned MaxCrossBlockRegionSize = 8;
+
+    // The maximal gap (in elements) allowed between two merged stores.
+    static const unsigned MaxStoreGapElts = 2;
+
   public:
     static char ID;
 
     MemOpt() :
         FunctionPass(ID), DL(nullptr), AA(nullptr), SE(nullptr), WI(nullptr),
-        CGC(nullptr) {
+        DT(nullptr), PDT(nullptr), CGC(nullptr) {
       initializeMemOptPass(*PassRegistry::getPassRegistry());
     }
 
@@ -103,10 +124,17 @@ namespace {
       AU.addRequired<TargetLibraryInfoWrapperPass>();
       AU.addRequired<ScalarEvolutionWrapperPass>();
       AU.addRequired<WIAnalysis>();
+      AU.addRequired<DominatorTreeWrapperPass>();
+      AU.addRequired<PostDominatorTreeWrapperPass>();
     }
 
     void buildProfitVectorLengths(Function &F);
 
+    void collectMemRefs(BasicBlock *BB, MemRefListTy &MemRefs,
+                        unsigned &Distance) const;
+    BasicBlock *getControlEquivalentSucc(BasicBlock *BB,
+        SmallVectorImpl<BasicBlock *> &Region) const;
+
     bool mergeLoad(LoadInst *LeadingLoad, MemRefListTy::iterator MI,
                    MemRefListTy &MemRefs, TrivialMemRefListTy &ToOpt);
     bool mergeStore(StoreInst *LeadingStore, MemRefListTy::iterator MI,
@@ -361,6 +389,8 @@ IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
 IGC_INITIALIZE_PASS_DEPENDENCY(AAResultsWrapperPass)
 IGC_INITIALIZE_PASS_DEPENDENCY(TargetLibraryInfoWrapperPass)
 IGC_INITIALIZE_PASS_DEPENDENCY(WIAnalysis)
+IGC_INITIALIZE_PASS_DEPENDENCY(DominatorTreeWrapperPass)
+IGC_INITIALIZE_PASS_DEPENDENCY(PostDominatorTreeWrapperPass)
 IGC_INITIALIZE_PASS_END(MemOpt, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
 
 char MemOpt::ID = 0;
@@ -401,6 +431,8 @@ bool MemOpt::runOnFunction(Function &F) {
   AA = &getAnalysis<AAResultsWrapperPass>().getAAResults();
   SE = &getAnalysis<ScalarEvolutionWrapperPass>().getSE();
   WI = &getAnalysis<WIAnalysis>();
+  DT = &getAnalysis<DominatorTreeWrapperPass>().getDomTree();
+  PDT = &getAnalysis<PostDominatorTreeWrapperPass>().getPostDomTree();
 
   CGC = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
   TLI = &getAnalysis<TargetLibraryInfoWrapperPass>().getTLI();
@@ -409,6 +441,7 @@ bool MemOpt::runOnFunction(Function &F) {
     buildProfitVectorLengths(F);
 
   bool Changed = false;
+  bool CrossBlock = IGC_IS_FLAG_ENABLED(EnableMemOptCrossBlock);
 
   for (Function::iterator BB = F.begin(), BBE = F.end(); BB != BBE; ++BB) {
     // Find all instructions with memory reference. Remember the distance one
@@ -416,16 +449,26 @@ bool MemOpt::runOnFunction(Function &F) {
     MemRefListTy MemRefs;
     TrivialMemRefListTy MemRefsToOptimize;
     unsigned Distance = 0;
-    bool FirstMemRef = true;
-    for (auto BI = BB->begin(), BE = BB->end(); BI != BE; ++BI) {
-      Instruction *I = &(*BI);
-      Distance += FirstMemRef ? 0 : 1;
-      // Skip irrelevant instructions.
-      if (shouldSkip(I))
-        continue;
-      MemRefs.push_back(std::make_pair(I, Distance));
-      Distance = 0;
-      FirstMemRef = false;
+    collectMemRefs(&*BB, MemRefs, Distance);
+
+    // Only memory references from this BB lead merging.
+    unsigned NumLeadingRefs = unsigned(MemRefs.size());
+
+    // Append memory references from the control-equivalent successor, with
+    // the ones in between as dependency checks only.
+    CondMemRefs.clear();
+    SmallVector<BasicBlock *, 8> Region;
+    BasicBlock *EquivBB = nullptr;
+    if (CrossBlock && NumLeadingRefs > 0)
+      EquivBB = getControlEquivalentSucc(&*BB, Region);
+    if (EquivBB) {
+      for (auto *RB : Region) {
+        unsigned NumRefs = unsigned(MemRefs.size());
+        collectMemRefs(RB, MemRefs, Distance);
+        for (unsigned i = NumRefs, e = unsigned(MemRefs.size()); i != e; ++i)
+          CondMemRefs.insert(MemRefs[i].first);
+      }
+      collectMemRefs(EquivBB, MemRefs, Distance);
     }
 
     // Skip BB with no more than 2 loads/stores.
@@ -434,10 +477,11 @@ bool MemOpt::runOnFunction(Function &F) {
 
     // Canonicalize 64-bit GEP to help SCEV find constant offset by
     // distributing `zext`/`sext` over safe expressions.
-    for (auto &M : MemRefs)
-      Changed |= canonicalizeGEP64(M.first);
+    for (unsigned i = 0; i != NumLeadingRefs; ++i)
+      Changed |= canonicalizeGEP64(MemRefs[i].first);
 
-    for (auto MI = MemRefs.begin(), ME = MemRefs.end(); MI != ME; ++MI) {
+    auto LeadingEnd = MemRefs.begin() + NumLeadingRefs;
+    for (auto MI = MemRefs.begin(); MI != LeadingEnd; ++MI) {
       Instruction *I = MI->first;
 
       // Skip already merged one.
@@ -456,13 +500,62 @@ bool MemOpt::runOnFunction(Function &F) {
       Changed |= optimizeGEP64(I);
   }
 
+  CondMemRefs.clear();
+
   DL = nullptr;
   AA = nullptr;
   SE = nullptr;
+  DT = nullptr;
+  PDT = nullptr;
 
   return Changed;
 }
 
+// Append memory references in BB to MemRefs. Distance is the number of
+// instructions since the last memory reference and is carried over blocks.
+void MemOpt::collectMemRefs(BasicBlock *BB, MemRefListTy &MemRefs,
+                            unsigned &Distance) const {
+  for (auto BI = BB->begin(), BE = BB->end(); BI != BE; ++BI) {
+    Instruction *I = &(*BI);
+    Distance += MemRefs.empty() ? 0 : 1;
+    // Skip irrelevant instructions.
+    if (shouldSkip(I))
+      continue;
+    MemRefs.push_back(std::make_pair(I, Distance));
+    Distance = 0;
+  }
+}
+
+// Return the block that is control-equivalent to BB and follows it, i.e. its
+// immediate post-dominator if BB dominates that one. Blocks on paths from BB
+// to it are collected into Region. Return null if there is no such block, or
+// BB may be re-entered before reaching it.
+BasicBlock *MemOpt::getControlEquivalentSucc(BasicBlock *BB,
+    SmallVectorImpl<BasicBlock *> &Region) const {
+  DomTreeNode *Node = PDT->getNode(BB);
+  if (!Node || !Node->getIDom())
+    return nullptr;
+  BasicBlock *EquivBB = Node->getIDom()->getBlock();
+  if (!EquivBB || EquivBB == BB || !DT->dominates(BB, EquivBB))
+    return nullptr;
+
+  SmallPtrSet<BasicBlock *, 8> Visited;
+  SmallVector<BasicBlock *, 8> WorkList(succ_begin(BB), succ_end(BB));
+  while (!WorkList.empty()) {
+    BasicBlock *Succ = WorkList.pop_back_val();
+    if (Succ == EquivBB || !Visited.insert(Succ).second)
+      continue;
+    // A loop back to BB executes BB more often than EquivBB.
+    if (Succ == BB || Region.size() == MaxCrossBlockRegionSize) {
+      Region.clear();
+      return nullptr;
+    }
+    Region.push_back(Succ);
+    WorkList.append(succ_begin(Succ), succ_end(Succ));
+  }
+  return EquivBB;
+}
+
 bool MemOpt::mergeLoad(LoadInst *LeadingLoad,
                        MemRefListTy::iterator MI, MemRefListTy& MemRefs,
                        TrivialMemRefListTy &ToOpt) {
@@ -563,8 +656,8 @@ bool MemOpt::mergeLoad(LoadInst *LeadingLoad,
 
     LoadInst *NextLoad = dyn_cast<LoadInst>(NextMemRef);
 
-    // Skip non-load instruction.
-    if (!NextLoad)
+    // Skip non-load instruction and conditionally executed ones.
+    if (!NextLoad || CondMemRefs.count(NextLoad))
       continue;
 
     // Bail out if that load is not a simple one.
@@ -657,6 +750,21 @@ bool MemOpt::mergeLoad(LoadInst *LeadingLoad,
   assert(NumElts > 1
          && "It's expected to merge into at least 2-element vector!");
 
+  // If the merged load is not a profitable length, over-fetch up to the
+  // next profitable one when that stays within the alignment of the first
+  // load. Such padding cannot cross into another page.
+  if (IGC_IS_FLAG_ENABLED(EnableMemOptGaps)) {
+    unsigned FirstAlign = 0;
+    for (auto &I : LoadsToMerge)
+      if (std::get<1>(I) == LowestOffset)
+        FirstAlign = std::get<0>(I)->getAlignment();
+    unsigned PaddedElts = NumElts;
+    for (unsigned P : profitVec)
+      if (P >= NumElts && P * LdScalarSize <= FirstAlign)
+        PaddedElts = P;
+    NumElts = PaddedElts;
+  }
+
   // Try to find the profitable vector length first.
   unsigned s = LoadsToMerge.size();
   unsigned MaxElts = profitVec[0];
@@ -839,6 +947,13 @@ bool MemOpt::mergeStore(StoreInst *LeadingStore,
   if (!ProfitVectorLengths.count(typeSizeInBits))
     return false;
   SmallVector<unsigned, 4 >& profitVec = ProfitVectorLengths[typeSizeInBits];
+  unsigned StScalarSize =
+    unsigned(DL->getTypeStoreSize(LeadingStoreScalarType));
+
+  // Private memory is not shared among work items, so gaps between stores
+  // could be filled by reading it back before the merged store.
+  bool AllowGaps = IGC_IS_FLAG_ENABLED(EnableMemOptGaps) &&
+    LeadingStore->getPointerAddressSpace() == ADDRESS_SPACE_PRIVATE;
 
   NumElts += getNumElements(LeadingStoreType);
   if (NumElts >= profitVec[0])
@@ -851,6 +966,9 @@ bool MemOpt::mergeStore(StoreInst *LeadingStore,
   SmallVector<std::tuple<StoreInst *, int64_t, MemRefListTy::iterator>, 8>
     StoresToMerge;
   StoresToMerge.push_back(std::make_tuple(LeadingStore, 0, MI));
+  // The number of elements (including any gap) each store adds.
+  SmallVector<unsigned, 8> EltsToMerge;
+  EltsToMerge.push_back(NumElts);
 
   // Stores to be merged are scanned in the program order from the leading store
   // but need to be merged into the tailing store. So two edges of that
@@ -890,8 +1008,8 @@ bool MemOpt::mergeStore(StoreInst *LeadingStore,
     CheckList.push_back(NextMemRef);
 
     StoreInst *NextStore = dyn_cast<StoreInst>(NextMemRef);
-    // Skip non-store instruction.
-    if (!NextStore)
+    // Skip non-store instruction and conditionally executed ones.
+    if (!NextStore || CondMemRefs.count(NextStore))
       continue;
 
     // Bail out if that store is not a simple one.
@@ -944,12 +1062,18 @@ bool MemOpt::mergeStore(StoreInst *LeadingStore,
 
     unsigned NextStoreSize = unsigned(DL->getTypeStoreSize(NextStoreType));
 
-    // Check it's consecutive to the current stores to be merged.
-    if ((Off > 0 && Off != LastToLeading) ||
-        (Off < 0 && (-Off) != (LeadingToFirst + NextStoreSize)))
+    // Check it's consecutive to the current stores to be merged, or leaves
+    // a small gap when that's allowed.
+    int64_t Gap = (Off > 0) ? Off - LastToLeading
+                            : (-Off) - (LeadingToFirst + NextStoreSize);
+    if (Gap != 0 &&
+        (!AllowGaps || Gap < 0 || Gap % StScalarSize != 0 ||
+         Gap > int64_t(MaxStoreGapElts * StScalarSize)))
       continue;
 
-    NumElts += getNumElements(NextStoreType);
+    unsigned NewElts =
+      getNumElements(NextStoreType) + unsigned(Gap / StScalarSize);
+    NumElts += NewElts;
     // Bail out if the resulting vector store is already not profitable.
     if (NumElts > profitVec[0])
       break;
@@ -966,6 +1090,7 @@ bool MemOpt::mergeStore(StoreInst *LeadingStore,
     CheckList.clear();
 
     StoresToMerge.push_back(std::make_tuple(NextStore, Off, MI));
+    EltsToMerge.push_back(NewElts);
     if (Off > 0)
       LastToLeading = Off + NextStoreSize;
     else
@@ -985,10 +1110,8 @@ bool MemOpt::mergeStore(StoreInst *LeadingStore,
 
   // Start to merge stores.
   NumElts = 0;
-  for (auto &I : StoresToMerge) {
-    Type *Ty = std::get<0>(I)->getValueOperand()->getType();
-    NumElts += getNumElements(Ty);
-  }
+  for (unsigned Elts : EltsToMerge)
+    NumElts += Elts;
 
   assert(NumElts > 1 &&
          "It's expected to merge into at least 2-element vector!");
@@ -1002,10 +1125,8 @@ bool MemOpt::mergeStore(StoreInst *LeadingStore,
     while (NumElts < MaxElts && k != e)
         MaxElts = profitVec[k++];
     // Try remove stores to be merged.
-    while (NumElts > MaxElts && s != 1) {
-      Type *Ty = std::get<0>(StoresToMerge[--s])->getValueOperand()->getType();
-      NumElts -= getNumElements(Ty);
-    }
+    while (NumElts > MaxElts && s != 1)
+      NumElts -= EltsToMerge[--s];
   }
 
   if (NumElts != MaxElts || s < 2)
@@ -1016,18 +1137,48 @@ bool MemOpt::mergeStore(StoreInst *LeadingStore,
   StoresToMerge.resize(s);
   std::sort(StoresToMerge.begin(), StoresToMerge.end(), less_tuple<1>());
 
+  // Stores to be merged will be merged into the tailing store. However, the
+  // pointer from the first store (with the minimal offset) will be used as the
+  // new pointer.
+  StoreInst *FirstStore = std::get<0>(StoresToMerge.front());
+  int64_t FirstOffset = std::get<1>(StoresToMerge.front());
+
+  unsigned NumStoredElts = 0;
+  for (auto &I : StoresToMerge)
+    NumStoredElts += getNumElements(std::get<0>(I)->getValueOperand()->getType());
+  bool HasGap = NumStoredElts != NumElts;
+  if (HasGap && FirstStore->getAlignment() < 4)
+    return false;
+
+  // Next we need to check alignment
+  if (!checkAlignmentBeforeMerge(FirstStore, StoresToMerge, NumElts))
+      return false;
+
+  // We don't need to recalculate the new pointer as we merge stores to the
+  // tailing store, which is dominated by all mergable stores' address
+  // calculations.
   Type *NewStoreType = VectorType::get(LeadingStoreScalarType, NumElts);
-  Value *NewStoreVal = UndefValue::get(NewStoreType);
+  Type *NewPointerType =
+      PointerType::get(NewStoreType, LeadingStore->getPointerAddressSpace());
+  Value *NewPointer =
+      Builder.CreateBitCast(FirstStore->getPointerOperand(), NewPointerType);
+
+  // Read back what's in the gaps so that the merged store writes them
+  // unchanged.
+  Value *NewStoreVal = HasGap ?
+      static_cast<Value *>(Builder.CreateAlignedLoad(NewPointer,
+                                                     FirstStore->getAlignment())) :
+      static_cast<Value *>(UndefValue::get(NewStoreType));
 
   // Pack the store value from their original store values. For original vector
   // store values, extracting and inserting is necessary to avoid tracking uses
   // of each element in the original vector store value.
-  unsigned Pos = 0;
   for (auto &I : StoresToMerge) {
     Value *Val = std::get<0>(I)->getValueOperand();
     Type *Ty = Val->getType();
     Type *ScalarTy = Ty->getScalarType();
     assert(hasSameSize(ScalarTy, LeadingStoreScalarType));
+    unsigned Pos = unsigned((std::get<1>(I) - FirstOffset) / StScalarSize);
 
     if (Ty->isVectorTy()) {
       for (unsigned i = 0, e = Ty->getVectorNumElements(); i != e; ++i) {
@@ -1061,22 +1212,6 @@ bool MemOpt::mergeStore(StoreInst *LeadingStore,
     }
   }
 
-  // Stores to be merged will be merged into the tailing store. However, the
-  // pointer from the first store (with the minimal offset) will be used as the
-  // new pointer.
-  StoreInst *FirstStore = std::get<0>(StoresToMerge.front());
-  
-  // Next we need to check alignment
-  if (!checkAlignmentBeforeMerge(FirstStore, StoresToMerge, NumElts))
-      return false;
-  
-  // We don't need to recalculate the new pointer as we merge stores to the
-  // tailing store, which is dominated by all mergable stores' address
-  // calculations.
-  Type *NewPointerType =
-      PointerType::get(NewStoreType, LeadingStore->getPointerAddressSpace());
-  Value *NewPointer =
-      Builder.CreateBitCast(FirstStore->getPointerOperand(), NewPointerType);
   StoreInst *NewStore =
       Builder.CreateAlignedStore(NewStoreVal, NewPointer,
                                  LeadingStore->getAlignment());
@@ -29,13 +29,19 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/Pass.h>
 #include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/CFG.h>
 #include <llvm/IR/Instruction.h>
+#include <llvm/IR/Instructions.h>
 #include <llvm/IR/IntrinsicInst.h>
 #include <llvm/IR/Constants.h>
 #include "common/LLVMWarningsPop.hpp"
 
 #include "GenISAIntrinsics/GenIntrinsics.h"
 #include "GenISAIntrinsics/GenIntrinsicInst.h"
+#include "common/igc_regkeys.hpp"
+
+#include <map>
+#include <set>
 
 namespace 
 {
@@ -85,6 +91,10 @@ public:
     virtual llvm::StringRef getPassName() const { return "MergeURBWrites"; }
 
 private:
+    /// Sinks URB writes that end every predecessor of a block into the block
+    /// itself, so that FillWriteList sees them together with the writes there.
+    bool SinkURBWrites(Function &F);
+
     /// Stores all URB write instructions in a vector. 
     /// Also merges partial (channel granularity) writes to the same offset.
     void FillWriteList(BasicBlock &BB);
@@ -117,6 +127,62 @@ unsigned int GetChannelMask(CallInst* inst)
     return int_cast<unsigned int>(cast<ConstantInt>(inst->getOperand(1))->getZExtValue());
 }
 
+/// Returns true if URB writes cannot be moved across the intrinsic.
+bool IsURBWriteBarrier(GenISAIntrinsic::ID IID)
+{
+    return (IID == GenISAIntrinsic::GenISA_URBRead) ||
+        (IID == GenISAIntrinsic::GenISA_HSURBPatchHeaderRead) ||
+        (IID == GenISAIntrinsic::GenISA_DCL_HSOutputCntrlPtInputVec) ||
+        (IID == GenISAIntrinsic::GenISA_DCL_HSPatchConstInputVec) ||
+        (IID == GenISAIntrinsic::GenISA_DCL_HSinputVec) ||
+        (IID == GenISAIntrinsic::GenISA_threadgroupbarrier);
+}
+
+/// Collects the URB writes with immediate offset and mask that can be moved
+/// to the end of BB, i.e. that are not followed by a barrier or by another
+/// URB write to the same offset. Returns them keyed by offset.
+void GetTrailingURBWrites(BasicBlock* BB, std::map<unsigned int, CallInst*>& writes)
+{
+    std::set<unsigned int> blocked;
+    for (auto iit = BB->rbegin(); iit != BB->rend(); ++iit)
+    {
+        auto intrinsic = dyn_cast<GenIntrinsicInst>(&*iit);
+        if (intrinsic == nullptr) continue;
+
+        GenISAIntrinsic::ID IID = intrinsic->getIntrinsicID();
+        if (IsURBWriteBarrier(IID))
+        {
+            return;
+        }
+        if (IID != GenISAIntrinsic::GenISA_URBWrite)
+        {
+            continue;
+        }
+        ConstantInt * pOffset = dyn_cast<ConstantInt>(intrinsic->getOperand(0));
+        ConstantInt * pImmediateMask = dyn_cast<ConstantInt>(intrinsic->getOperand(1));
+        if (pOffset == nullptr || pImmediateMask == nullptr)
+        {
+            // the write may overlap with anything before it
+            return;
+        }
+        const unsigned int offset = int_cast<unsigned int>(pOffset->getZExtValue());
+        // a write of length 8 also covers offset+1
+        const unsigned int lastOffset = GetChannelMask(intrinsic) > 0x0F ? offset + 1 : offset;
+        if (blocked.count(offset) || blocked.count(lastOffset))
+        {
+            // an overlapping later write stays in BB, so this one has to stay too
+            writes.erase(offset);
+            writes.erase(lastOffset);
+        }
+        else
+        {
+            writes[offset] = intrinsic;
+        }
+        blocked.insert(offset);
+        blocked.insert(lastOffset);
+    }
+}
+
 } // end of unnamed namespace to contain class definition and auxiliary functions
 
 /// Do initialization of the data structure.
@@ -124,9 +190,96 @@ unsigned int GetChannelMask(CallInst* inst)
 bool MergeURBWrites::doInitialization(Function & F)
 {
     m_writeList.reserve(128); //most of the time we won't exceed offset = 127
+    if (IGC_IS_FLAG_ENABLED(EnableCrossBlockURBWriteMerge))
+    {
+        return SinkURBWrites(F);
+    }
     return false;
 }
 
+/// Per-output conditionals leave a partial URB write at the end of each arm:
+///
+///   then:  URBWrite(5, 0x3, a0, a1, ...)      join: %d0 = phi [a0, then], [b0, else]
+///          br join                      ==>         %d1 = phi [a1, then], [b1, else]
+///   else:  URBWrite(5, 0x3, b0, b1, ...)            URBWrite(5, 0x3, %d0, %d1, ...)
+///          br join
+///
+/// The writes are sunk only when every predecessor branches unconditionally
+/// to the join block and writes the same offset with the same channel mask,
+/// so the join block writes exactly what each path wrote before.
+bool MergeURBWrites::SinkURBWrites(Function &F)
+{
+    bool changed = false;
+    for (auto& BB : F)
+    {
+        llvm::SmallVector<BasicBlock*, 4> preds(pred_begin(&BB), pred_end(&BB));
+        if (preds.size() < 2)
+        {
+            continue;
+        }
+        bool allSinkable = true;
+        llvm::SmallVector<std::map<unsigned int, CallInst*>, 4> predWrites(preds.size());
+        for (unsigned int i = 0; i < preds.size() && allSinkable; ++i)
+        {
+            allSinkable = preds[i] != &BB && preds[i]->getSingleSuccessor() == &BB;
+            GetTrailingURBWrites(preds[i], predWrites[i]);
+        }
+        if (!allSinkable)
+        {
+            continue;
+        }
+
+        Instruction* insertPt = &*BB.getFirstInsertionPt();
+        for (auto& candidate : predWrites[0])
+        {
+            const unsigned int offset = candidate.first;
+            CallInst* write = candidate.second;
+            llvm::SmallVector<CallInst*, 4> writes;
+            for (auto& writesInPred : predWrites)
+            {
+                auto it = writesInPred.find(offset);
+                if (it == writesInPred.end() || GetChannelMask(it->second) != GetChannelMask(write))
+                {
+                    break;
+                }
+                writes.push_back(it->second);
+            }
+            if (writes.size() != preds.size())
+            {
+                continue;
+            }
+
+            CallInst* sunk = cast<CallInst>(write->clone());
+            sunk->insertBefore(insertPt);
+            for (unsigned int k = 2; k < write->getNumArgOperands(); ++k)
+            {
+                Value* data = write->getArgOperand(k);
+                bool same = true;
+                for (auto w : writes)
+                {
+                    same &= (w->getArgOperand(k) == data);
+                }
+                if (!same)
+                {
+                    PHINode* phi = PHINode::Create(data->getType(), preds.size(), "", &BB.front());
+                    for (unsigned int i = 0; i < preds.size(); ++i)
+                    {
+                        phi->addIncoming(writes[i]->getArgOperand(k), preds[i]);
+                    }
+                    data = phi;
+                }
+                sunk->setArgOperand(k, data);
+            }
+            for (auto w : writes)
+            {
+                w->eraseFromParent();
+            }
+            changed = true;
+        }
+    }
+    return changed;
+}
+
 /// This optimization merges shorter writes to URB to get a smaller number of longer writes 
 /// which is more efficient.
 /// Current implementation can:
@@ -166,12 +319,7 @@ void MergeURBWrites::FillWriteList(BasicBlock &BB)
         if (intrinsic == nullptr) continue;
 
         GenISAIntrinsic::ID IID = intrinsic->getIntrinsicID();
-        if ((IID == GenISAIntrinsic::GenISA_URBRead) ||
-            (IID == GenISAIntrinsic::GenISA_HSURBPatchHeaderRead) ||
-            (IID == GenISAIntrinsic::GenISA_DCL_HSOutputCntrlPtInputVec) ||
-            (IID == GenISAIntrinsic::GenISA_DCL_HSPatchConstInputVec) ||
-            (IID == GenISAIntrinsic::GenISA_DCL_HSinputVec) ||
-            (IID == GenISAIntrinsic::GenISA_threadgroupbarrier))
+        if (IsURBWriteBarrier(IID))
         {
             MergeInstructions();
             m_writeList.clear();
@@ -27,6 +27,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/Support/ScaledNumber.h>
 #include "llvm/IR/DataLayout.h"
 #include "llvm/ADT/StringExtras.h"
+#include "llvm/Transforms/Utils/FunctionComparator.h"
 #include "common/LLVMWarningsPop.hpp"
 
 #include "AdaptorCommon/ImplicitArgs.hpp"
@@ -38,6 +39,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/Optimizer/OpenCLPasses/LocalBuffers/InlineLocalsResolution.hpp"
 #include "Compiler/Optimizer/OpenCLPasses/KernelArgs.hpp"
 #include "Compiler/CISACodeGen/EmitVISAPass.hpp"
+#include "Compiler/CISACodeGen/KernelBinaryCache.hpp"
+#include "Compiler/CISACodeGen/SpillPredictor.hpp"
 #include "Compiler/Optimizer/OCLBIUtils.h"
 #include "AdaptorOCL/OCL/KernelAnnotations.hpp"
 #include "common/allocator.h"
@@ -67,6 +70,9 @@ CShader(pFunc, pProgram)
     m_HasTID                = false;
     m_HasGlobalSize         = false;
     m_disableMidThreadPreemption = false;
+    m_hasIEEEMacros         = false;
+    m_num1DAccesses         = 0;
+    m_num2DAccesses         = 0;
     m_perWIPrivateMemSize   = 0;
     m_Context               = const_cast<OpenCLProgramContext*>(ctx);
     m_localOffsetsMap.clear();
@@ -895,6 +901,7 @@ void COpenCLKernel::CreateAnnotations(KernelArg* kernelArg, uint payloadPosition
     case KernelArg::ArgType::IMPLICIT_DEVICE_ENQUEUE_DATA_PARAMETER_OBJECT_ID:
     case KernelArg::ArgType::IMPLICIT_DEVICE_ENQUEUE_DISPATCHER_SIMD_SIZE:
     case KernelArg::ArgType::IMPLICIT_BUFFER_OFFSET:
+    case KernelArg::ArgType::IMPLICIT_PRECOMPUTED_VALUE:
         constantType = kernelArg->getDataParamToken();
         assert(constantType != iOpenCL::DATA_PARAMETER_TOKEN_UNKNOWN);
         {
@@ -1117,9 +1124,14 @@ void COpenCLKernel::CreateAnnotations(KernelArg* kernelArg, uint payloadPosition
 
     case KernelArg::ArgType::IMPLICIT_LOCAL_IDS:
         {
-            m_kernelInfo.m_threadPayload.HasLocalIDx = true;
-            m_kernelInfo.m_threadPayload.HasLocalIDy = true;
-            m_kernelInfo.m_threadPayload.HasLocalIDz = true;
+            // Local ids come in x, y, z order, trailing ones may be missing
+            // (see TrimLocalIDs).
+            if (!m_kernelInfo.m_threadPayload.HasLocalIDx)
+                m_kernelInfo.m_threadPayload.HasLocalIDx = true;
+            else if (!m_kernelInfo.m_threadPayload.HasLocalIDy)
+                m_kernelInfo.m_threadPayload.HasLocalIDy = true;
+            else
+                m_kernelInfo.m_threadPayload.HasLocalIDz = true;
 
             ModuleMetaData *modMD = m_Context->getModuleMetaData();
             auto it = modMD->FuncMD.find(entry);
@@ -1298,6 +1310,7 @@ void COpenCLKernel::ParseShaderSpecificOpcode( llvm::Instruction* inst )
     case Instruction::FDiv:
         if(inst->getType()->isDoubleTy())
         {
+            m_hasIEEEMacros = true;
             SetDisableMidthreadPreemption();
         }
         break;
@@ -1306,6 +1319,7 @@ void COpenCLKernel::ParseShaderSpecificOpcode( llvm::Instruction* inst )
         {
             if (GetOpCode(inst) == llvm_sqrt)
             {
+                m_hasIEEEMacros = true;
                 SetDisableMidthreadPreemption();
             }
         }
@@ -1314,12 +1328,14 @@ void COpenCLKernel::ParseShaderSpecificOpcode( llvm::Instruction* inst )
     {
         unsigned AS = cast<LoadInst>(inst)->getPointerAddressSpace();
         setStatelessAccess(AS);
+        m_num1DAccesses++;
         break;
     }
     case Instruction::Store:
     {
         unsigned AS = cast<StoreInst>(inst)->getPointerAddressSpace();
         setStatelessAccess(AS);
+        m_num1DAccesses++;
         break;
     }
     default:
@@ -1340,6 +1356,15 @@ void COpenCLKernel::ParseShaderSpecificOpcode( llvm::Instruction* inst )
             case GenISAIntrinsic::GenISA_pair_to_ptr:
                 mayHasMemoryAccess = false;
                 break;
+            case GenISAIntrinsic::GenISA_typedread:
+            case GenISAIntrinsic::GenISA_typedwrite:
+                // operand 2 is the v coordinate
+                isa<Constant>(GII->getOperand(2)) ? m_num1DAccesses++ : m_num2DAccesses++;
+                break;
+            case GenISAIntrinsic::GenISA_ldptr:
+                // operand 1 is the v coordinate
+                isa<Constant>(GII->getOperand(1)) ? m_num1DAccesses++ : m_num2DAccesses++;
+                break;
             } // End of switch
         }
 
@@ -1367,6 +1392,86 @@ void COpenCLKernel::ParseShaderSpecificOpcode( llvm::Instruction* inst )
     }
 }
 
+bool COpenCLKernel::CopyShaderSpecificOpcodeInfo(CShader* pSibling)
+{
+    COpenCLKernel* pKernel = static_cast<COpenCLKernel*>(pSibling);
+    if (pKernel->m_hasIEEEMacros)
+    {
+        m_hasIEEEMacros = true;
+        SetDisableMidthreadPreemption();
+    }
+    if (pKernel->GetHasGlobalStatelessAccess())
+    {
+        SetHasGlobalStatelessAccess();
+    }
+    if (pKernel->GetHasConstantStatelessAccess())
+    {
+        SetHasConstantStatelessAccess();
+    }
+    m_num1DAccesses = pKernel->m_num1DAccesses;
+    m_num2DAccesses = pKernel->m_num2DAccesses;
+    return true;
+}
+
+// Implicit arguments which carry only values queried by the kernel, so their
+// payload (and patch token) can be dropped when the kernel does not use them.
+static bool IsDroppableImplicitArg(KernelArg::ArgType argType)
+{
+    switch (argType)
+    {
+    case KernelArg::ArgType::IMPLICIT_WORK_DIM:
+    case KernelArg::ArgType::IMPLICIT_NUM_GROUPS:
+    case KernelArg::ArgType::IMPLICIT_GLOBAL_SIZE:
+    case KernelArg::ArgType::IMPLICIT_LOCAL_SIZE:
+    case KernelArg::ArgType::IMPLICIT_ENQUEUED_LOCAL_WORK_SIZE:
+    case KernelArg::ArgType::IMPLICIT_IMAGE_HEIGHT:
+    case KernelArg::ArgType::IMPLICIT_IMAGE_WIDTH:
+    case KernelArg::ArgType::IMPLICIT_IMAGE_DEPTH:
+    case KernelArg::ArgType::IMPLICIT_IMAGE_NUM_MIP_LEVELS:
+    case KernelArg::ArgType::IMPLICIT_IMAGE_CHANNEL_DATA_TYPE:
+    case KernelArg::ArgType::IMPLICIT_IMAGE_CHANNEL_ORDER:
+    case KernelArg::ArgType::IMPLICIT_IMAGE_SRGB_CHANNEL_ORDER:
+    case KernelArg::ArgType::IMPLICIT_IMAGE_ARRAY_SIZE:
+    case KernelArg::ArgType::IMPLICIT_IMAGE_NUM_SAMPLES:
+    case KernelArg::ArgType::IMPLICIT_SAMPLER_ADDRESS:
+    case KernelArg::ArgType::IMPLICIT_SAMPLER_NORMALIZED:
+    case KernelArg::ArgType::IMPLICIT_SAMPLER_SNAP_WA:
+    case KernelArg::ArgType::IMPLICIT_LOCAL_MEMORY_STATELESS_WINDOW_START_ADDRESS:
+    case KernelArg::ArgType::IMPLICIT_LOCAL_MEMORY_STATELESS_WINDOW_SIZE:
+    case KernelArg::ArgType::IMPLICIT_PRIVATE_MEMORY_STATELESS_SIZE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Try to place an argument into one of the padding holes of the cross-thread
+// data. The argument may not cross a GRF boundary. On success, the hole is
+// shrunk and the offset of the argument is returned in argOffset.
+static bool AllocateInPayloadHole(std::vector<std::pair<uint, uint>>& holes,
+    uint size, uint align, uint& argOffset)
+{
+    for (auto& hole : holes)
+    {
+        uint start = iSTD::Align(hole.first, align);
+        uint end = start + size;
+        if (end > hole.second || start / SIZE_GRF != (end - 1) / SIZE_GRF)
+        {
+            continue;
+        }
+
+        uint holeStart = hole.first;
+        hole.first = end;
+        if (start > holeStart)
+        {
+            holes.push_back(std::make_pair(holeStart, start));
+        }
+        argOffset = start;
+        return true;
+    }
+    return false;
+}
+
 void COpenCLKernel::AllocatePayload()
 {
     assert(m_Context);
@@ -1434,6 +1539,17 @@ void COpenCLKernel::AllocatePayload()
         kernelArgs.checkForZeroPerThreadData();
     }
 
+    // With the compact layout, unused implicit arguments are dropped, the most
+    // used explicit arguments go first and small cross-thread arguments are
+    // placed into the alignment padding left by the previous ones.
+    bool compactLayout = IGC_IS_FLAG_ENABLED(EnableCompactKernelArgLayout);
+    if (compactLayout)
+    {
+        kernelArgs.sortByUses();
+    }
+    // Padding holes [start, end) in the cross-thread data.
+    std::vector<std::pair<uint, uint>> payloadHoles;
+
     for (KernelArgs::const_iterator i = kernelArgs.begin(), e = kernelArgs.end(); i != e; ++i) 
     {
         KernelArg arg = *i;
@@ -1441,7 +1557,8 @@ void COpenCLKernel::AllocatePayload()
 
         // skip unused arguments
         bool IsUnusedArg = (arg.getArgType() == KernelArg::ArgType::IMPLICIT_BUFFER_OFFSET ||
-            arg.getArgType() == KernelArg::ArgType::IMPLICIT_PRINTF_BUFFER) &&
+            arg.getArgType() == KernelArg::ArgType::IMPLICIT_PRINTF_BUFFER ||
+            (compactLayout && IsDroppableImplicitArg(arg.getArgType()))) &&
             arg.getArg()->use_empty();
 
         // Runtime Values should not be processed any further. No annotations shall be created for them.
@@ -1465,7 +1582,16 @@ void COpenCLKernel::AllocatePayload()
 
         if (!IsUnusedArg && !isRuntimeValue)
         {
-            if (arg.needsAllocation())
+            uint argOffset = offset;
+            bool inHole = false;
+            if (arg.needsAllocation() && compactLayout &&
+                arg.isConstantBuf() && numAllocInstances == 1)
+            {
+                inHole = AllocateInPayloadHole(payloadHoles, arg.getAllocateSize(),
+                    (uint)arg.getAlignment(), argOffset);
+            }
+
+            if (arg.needsAllocation() && !inHole)
             {
                 // Align on the desired alignment for this argument
                 offset = iSTD::Align(offset, arg.getAlignment());
@@ -1484,6 +1610,17 @@ void COpenCLKernel::AllocatePayload()
                     offset = iSTD::Align(offset, SIZE_GRF);
                 }
 
+                if (compactLayout && arg.isConstantBuf() && constantBufferStartSet &&
+                    argOffset >= constantBufferStart && offset > argOffset)
+                {
+                    payloadHoles.push_back(std::make_pair(argOffset, offset));
+                }
+                argOffset = offset;
+            }
+
+            if (arg.needsAllocation())
+            {
+
                 // And now actually tell vISA we need this space.
                 // (Except for r0, which is a predefined variable, and should never be allocated as input!)
                 const llvm::Argument * A = arg.getArg();
@@ -1492,7 +1629,7 @@ void COpenCLKernel::AllocatePayload()
                     CVariable* var = GetSymbol(const_cast<Argument*>(A));
                     for (int i = 0; i < numAllocInstances; ++i)
                     {
-                        AllocateInput(var, offset + (arg.getAllocateSize() * i), i);
+                        AllocateInput(var, argOffset + (arg.getAllocateSize() * i), i);
                     }
                 }
                 // or else we would just need to increase an offset
@@ -1500,9 +1637,9 @@ void COpenCLKernel::AllocatePayload()
 
             // Create annotations for the kernel argument
             // If an arg is unused, don't generate patch token for it.
-            CreateAnnotations(&arg, offset - constantBufferStart);
+            CreateAnnotations(&arg, argOffset - constantBufferStart);
 
-            if (arg.needsAllocation())
+            if (arg.needsAllocation() && !inHole)
             {
                 for (int i = 0; i < numAllocInstances; ++i)
                 {
@@ -1524,7 +1661,11 @@ void COpenCLKernel::AllocatePayload()
     {    
         if (loadThreadPayload)
         {
-            uint perThreadInputSize = SIZE_GRF * 3 * m_numberInstance;
+            uint numLocalIDs =
+                (m_kernelInfo.m_threadPayload.HasLocalIDx ? 1 : 0) +
+                (m_kernelInfo.m_threadPayload.HasLocalIDy ? 1 : 0) +
+                (m_kernelInfo.m_threadPayload.HasLocalIDz ? 1 : 0);
+            uint perThreadInputSize = SIZE_GRF * numLocalIDs * m_numberInstance;
             encoder.GetVISAKernel()->AddKernelAttribute("perThreadInputSize", sizeof(uint16_t), &perThreadInputSize);
         }
     }
@@ -1533,6 +1674,11 @@ void COpenCLKernel::AllocatePayload()
     m_kernelInfo.m_threadPayload.PassInlineData = false;
     
     m_ConstantBufferLength = iSTD::Align(m_ConstantBufferLength, SIZE_GRF);
+    COMPILER_SHADER_STATS_SET(m_shaderStats, STATS_CROSS_THREAD_PAYLOAD, m_ConstantBufferLength);
+    if (funcMD != m_Context->getModuleMetaData()->FuncMD.end())
+    {
+        COMPILER_SHADER_STATS_SET(m_shaderStats, STATS_SLM_BANK_CONFLICTS, funcMD->second.slmBankConflicts);
+    }
 
     CreateInlineSamplerAnnotations();
 
@@ -1639,6 +1785,26 @@ void COpenCLKernel::FillKernel()
 
     }
 
+    if (IGC_IS_FLAG_ENABLED(EnableWalkOrderHint))
+    {
+        // Recommend a tiled walk when most surface accesses vary in Y, so that
+        // neighbouring threads touch neighbouring rows. The tile height matches
+        // the one used for compute shaders and must divide a fixed Y size.
+        const DWORD tileHeight = 4;
+        const auto& execEnv = m_kernelInfo.m_executionEnivronment;
+        bool tileFits = !execEnv.HasFixedWorkGroupSize ||
+            (execEnv.FixedWorkgroupSize[1] % tileHeight) == 0;
+        if (m_num2DAccesses > m_num1DAccesses && tileFits)
+        {
+            m_kernelInfo.m_executionEnivronment.WalkOrderHint =
+                iOpenCL::WALK_ORDER_HINT_TILED | (tileHeight << 8);
+        }
+        else if (m_num1DAccesses + m_num2DAccesses > 0)
+        {
+            m_kernelInfo.m_executionEnivronment.WalkOrderHint = iOpenCL::WALK_ORDER_HINT_LINEAR;
+        }
+    }
+
     auto &FuncMap = m_Context->getModuleMetaData()->FuncMD;
     auto FuncIter = FuncMap.find(entry);
     if (FuncIter != FuncMap.end())
@@ -1646,6 +1812,7 @@ void COpenCLKernel::FillKernel()
         auto &FuncInfo = FuncIter->second;
 
         m_kernelInfo.m_executionEnivronment.IsInitializer = FuncInfo.IsInitializer;
+        m_kernelInfo.m_executionEnivronment.WorkGroupCombineFactor = FuncInfo.workGroupCombineFactor;
         m_kernelInfo.m_executionEnivronment.IsFinalizer   = FuncInfo.IsFinalizer;
 
         m_kernelInfo.m_executionEnivronment.CompiledSubGroupsNumber =
@@ -1654,6 +1821,24 @@ void COpenCLKernel::FillKernel()
 
     m_kernelInfo.m_executionEnivronment.HasGlobalAtomics = GetHasGlobalAtomics();
 
+    auto precomputed = m_Context->m_precomputedArgsPrograms.find(m_kernelInfo.m_kernelName);
+    if (precomputed != m_Context->m_precomputedArgsPrograms.end())
+    {
+        m_kernelInfo.m_precomputedArgsProgram = precomputed->second.bitcode;
+        m_kernelInfo.m_numPrecomputedArgs = precomputed->second.numValues;
+    }
+
+    auto interesting = m_Context->m_interestingArgs.find(m_kernelInfo.m_kernelName);
+    if (interesting != m_Context->m_interestingArgs.end())
+    {
+        m_kernelInfo.m_interestingArgs = interesting->second;
+    }
+
+    auto specialized = m_Context->m_specializedArgs.find(m_kernelInfo.m_kernelName);
+    if (specialized != m_Context->m_specializedArgs.end())
+    {
+        m_kernelInfo.m_specializedArgs = specialized->second;
+    }
 }
 
 void COpenCLKernel::RecomputeBTLayout()
@@ -1869,6 +2054,7 @@ void GatherDataForDriver(OpenCLProgramContext* ctx, COpenCLKernel* pShader, CSha
             ctx->m_programOutput.m_ShaderProgramList.push_back(pKernel);
         }
         COMPILER_SHADER_STATS_PRINT(pKernel->m_shaderStats, ShaderType::OPENCL_SHADER, ctx->hash, pFunc->getName());
+        COMPILER_SHADER_STATS_PRINT_JSONL(pKernel->m_shaderStats, ctx, pFunc->getName());
         COMPILER_SHADER_STATS_SUM(ctx->m_sumShaderStats, pKernel->m_shaderStats, ShaderType::OPENCL_SHADER);
         COMPILER_SHADER_STATS_DEL(pKernel->m_shaderStats);
     }
@@ -1902,6 +2088,58 @@ static bool SetKernelProgram(COpenCLKernel* shader, DWORD simdMode)
     return false;
 }
 
+// Find kernels that are identical to an earlier kernel up to their name,
+// comparing both the IR, after OptimizeIR, and the kernel metadata.
+static void FindDuplicateKernels(OpenCLProgramContext* ctx)
+{
+    // The debug info of a kernel describes that kernel only.
+    if (ctx->m_instrTypes.hasDebugInfo)
+    {
+        return;
+    }
+
+    MetaDataUtils *pMdUtils = ctx->getMetaDataUtils();
+    ModuleMetaData *modMD = ctx->getModuleMetaData();
+    Module *pModule = ctx->getModule();
+    LLVMContext &C = pModule->getContext();
+
+    // The info nodes are uniqued, so equal kernel metadata gives equal nodes.
+    typedef std::pair<FunctionComparator::FunctionHash, Metadata*> KernelKey;
+    std::map<KernelKey, std::vector<Function*>> buckets;
+    GlobalNumberState globalNumbers;
+
+    for (auto i = pMdUtils->begin_FunctionsInfo(), e = pMdUtils->end_FunctionsInfo(); i != e; ++i)
+    {
+        Function *pFunc = i->first;
+        if (!isEntryFunc(pMdUtils, pFunc) || pFunc->isDeclaration())
+        {
+            continue;
+        }
+
+        KernelKey key(FunctionComparator::functionHash(*pFunc), i->second->generateNode(C));
+        std::vector<Function*> &candidates = buckets[key];
+        Function *pOrig = nullptr;
+        for (Function *pCandidate : candidates)
+        {
+            if (FunctionComparator(pCandidate, pFunc, &globalNumbers).compare() == 0 &&
+                isEqual(modMD->FuncMD[pCandidate], modMD->FuncMD[pFunc], pModule))
+            {
+                pOrig = pCandidate;
+                break;
+            }
+        }
+
+        if (pOrig)
+        {
+            ctx->m_duplicateKernels[pFunc->getName().str()] = pOrig->getName().str();
+        }
+        else
+        {
+            candidates.push_back(pFunc);
+        }
+    }
+}
+
 void CodeGen(OpenCLProgramContext* ctx)
 {
     // Do program-wide code generation.
@@ -1910,6 +2148,13 @@ void CodeGen(OpenCLProgramContext* ctx)
     {
         CollectProgramInfo(ctx);
         ctx->m_programOutput.CreateProgramScopePatchStream(ctx->m_programInfo);
+
+        if (IGC_IS_FLAG_ENABLED(EnableOCLKernelDedup))
+        {
+            FindDuplicateKernels(ctx);
+        }
+
+        KernelBinaryCache::Lookup(ctx);
     }
 
     MetaDataUtils *pMdUtils = ctx->getMetaDataUtils();
@@ -2098,6 +2343,36 @@ bool COpenCLKernel::CompileSIMDSize(SIMDMode simdMode, EmitPass &EP, llvm::Funct
     return compileThisSIMD;
 }
 
+// True if at most one SIMD width of this kernel gets compiled, so the choice
+// of the other widths never depends on the vISA compile result of this one.
+bool COpenCLKernel::HasFixedSIMDSize(llvm::Function &F)
+{
+    if (m_Context->getModuleMetaData()->csInfo.forcedSIMDSize != 0)
+    {
+        return true;
+    }
+    FunctionInfoMetaDataHandle funcInfoMD = m_pMdUtils->getFunctionsInfoItem(&F);
+    return funcInfoMD->getSubGroupSize()->getSIMD_size() != 0;
+}
+
+// Returns true if this SIMD width should be skipped because it is predicted to
+// spill. The prediction is recorded in the shader for LogSpillPrediction, in
+// which case nothing is skipped so that it can be compared with the outcome.
+static bool SkipOnPredictedSpill(CShader* pShader, SIMDMode simdMode, EmitPass &EP)
+{
+    SpillPredictor* SP = EP.getAnalysisIfAvailable<SpillPredictor>();
+    if (!SP)
+    {
+        return false;
+    }
+
+    bool predicted = SP->isSpillPredicted(simdMode);
+    pShader->m_spillPrediction = predicted ? 1 : 0;
+    pShader->m_spillPredictionGRF = SP->getEstimatedGRF(simdMode);
+
+    return predicted && IGC_IS_FLAG_DISABLED(LogSpillPrediction);
+}
+
 bool COpenCLKernel::CompileThisSIMD(SIMDMode simdMode, EmitPass &EP, llvm::Function &F)
 {
     CShader* simd8Program = m_parent->GetShader(SIMDMode::SIMD8);
@@ -2198,6 +2473,26 @@ bool COpenCLKernel::CompileThisSIMD(SIMDMode simdMode, EmitPass &EP, llvm::Funct
             }
         }
 
+        // With a required work group size, skip a width whose threads leave
+        // noticeably more lanes empty than a narrower width would, e.g. SIMD16
+        // for a group of 24 fills 75% of the lanes while SIMD8 fills all.
+        uint32_t reqdGroupSize = IGCMetaDataHelper::getThreadGroupSize(*pMdUtils, &F);
+        if (reqdGroupSize != 0 && IGC_IS_FLAG_ENABLED(EnableLaneUtilizationSIMDSelection))
+        {
+            float utilization = GetLaneUtilization(simdMode, reqdGroupSize);
+            float narrowerUtilization = GetLaneUtilization(SIMDMode::SIMD8, reqdGroupSize);
+            if (simdMode == SIMDMode::SIMD32)
+            {
+                narrowerUtilization = std::max(narrowerUtilization,
+                    GetLaneUtilization(SIMDMode::SIMD16, reqdGroupSize));
+            }
+            if ((narrowerUtilization - utilization) * 100.0f >
+                (float)IGC_GET_FLAG_VALUE(LaneUtilizationLossThreshold))
+            {
+                return false;
+            }
+        }
+
         // Here we check profitablility, etc.
         if (simdMode == SIMDMode::SIMD16)
         {
@@ -2219,6 +2514,10 @@ bool COpenCLKernel::CompileThisSIMD(SIMDMode simdMode, EmitPass &EP, llvm::Funct
             {
                 return false;
             }
+            if (SkipOnPredictedSpill(this, simdMode, EP))
+            {
+                return false;
+            }
         }
         if (simdMode == SIMDMode::SIMD32)
         {
@@ -2239,6 +2538,10 @@ bool COpenCLKernel::CompileThisSIMD(SIMDMode simdMode, EmitPass &EP, llvm::Funct
             {
                 return false;
             }
+            if (SkipOnPredictedSpill(this, simdMode, EP))
+            {
+                return false;
+            }
         }
     }
 
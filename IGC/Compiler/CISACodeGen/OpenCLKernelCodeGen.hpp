@@ -45,11 +45,13 @@ public:
     virtual void PreCompile();
     virtual void AllocatePayload();
     virtual void ParseShaderSpecificOpcode( llvm::Instruction* inst );
+    virtual bool CopyShaderSpecificOpcodeInfo(CShader* pSibling);
     virtual void ExtractGlobalVariables() {}
 
     bool        hasReadWriteImage(llvm::Function &F);
     bool        CompileSIMDSize(SIMDMode simdMode, EmitPass &EP, llvm::Function &F);
     bool        CompileThisSIMD(SIMDMode simdMode, EmitPass &EP, llvm::Function &F);
+    bool        HasFixedSIMDSize(llvm::Function &F);
 
     void        FillKernel();
 
@@ -115,6 +117,14 @@ protected:
     bool m_HasTID;
     bool m_HasGlobalSize;
     bool m_disableMidThreadPreemption;
+    // Set if ParseShaderSpecificOpcode() found IEEE macros, as opposed to
+    // m_disableMidThreadPreemption which also depends on the compiled code.
+    bool m_hasIEEEMacros;
+
+    // Number of surface accesses with a varying vs. a constant Y coordinate,
+    // used to pick the recommended walk order.
+    uint m_num1DAccesses;
+    uint m_num2DAccesses;
 
     // Maps GlobalVariables representing local address-space pointers
     // to their offsets in SLM.
@@ -27,10 +27,14 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/IGCPassSupport.h"
 #include "common/LLVMWarningsPush.hpp"
 #include "llvm/IR/InstIterator.h"
+#include "llvm/Analysis/ValueTracking.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "common/LLVMWarningsPop.hpp"
 #include "GenISAIntrinsics/GenIntrinsicInst.h"
 #include "Compiler/CodeGenPublicEnums.h"
 #include "Compiler/CISACodeGen/helper.h"
+#include "common/debug/Debug.hpp"
+#include "common/igc_regkeys.hpp"
 
 #include <llvm/IR/PassManager.h>
 
@@ -110,4 +114,157 @@ bool RemoveNonPositionOutput::runOnFunction(Function &F)
         changed = true;
     }
     return changed;
-}
\ No newline at end of file
+}
+
+// Backward slice from the outputs left by RemoveNonPositionOutput. DCE only
+// drops values without uses, so computations that reach the position only
+// through private memory (stores to an alloca that no live load reads)
+// survive it. Here a store to an alloca is live only if the alloca is.
+class PositionOnlySlice : public llvm::FunctionPass
+{
+public:
+    static char ID;
+
+    PositionOnlySlice();
+
+    ~PositionOnlySlice() {}
+
+    virtual void getAnalysisUsage(llvm::AnalysisUsage &AU) const override
+    {
+        AU.setPreservesCFG();
+    }
+
+    virtual bool runOnFunction(llvm::Function &F) override;
+
+    virtual llvm::StringRef getPassName() const override
+    {
+        return "position-only shader backward slice";
+    }
+};
+
+llvm::FunctionPass* createPositionOnlySlicePass()
+{
+    return new PositionOnlySlice();
+}
+
+#define PASS_FLAG_POSH_SLICE "igc-posh-position-slice"
+#define PASS_DESCRIPTION_POSH_SLICE "Backward slice from position outputs for Position-Only Shader"
+#define PASS_CFG_ONLY_POSH_SLICE false
+#define PASS_ANALYSIS_POSH_SLICE false
+IGC_INITIALIZE_PASS_BEGIN(PositionOnlySlice, PASS_FLAG_POSH_SLICE, PASS_DESCRIPTION_POSH_SLICE, PASS_CFG_ONLY_POSH_SLICE, PASS_ANALYSIS_POSH_SLICE)
+IGC_INITIALIZE_PASS_END(PositionOnlySlice, PASS_FLAG_POSH_SLICE, PASS_DESCRIPTION_POSH_SLICE, PASS_CFG_ONLY_POSH_SLICE, PASS_ANALYSIS_POSH_SLICE)
+
+char PositionOnlySlice::ID = 0;
+
+PositionOnlySlice::PositionOnlySlice() : FunctionPass(ID)
+{
+    initializePositionOnlySlicePass(*PassRegistry::getPassRegistry());
+}
+
+bool PositionOnlySlice::runOnFunction(Function &F)
+{
+    const DataLayout& DL = F.getParent()->getDataLayout();
+
+    // stores whose only effect is on a private alloca
+    DenseMap<AllocaInst*, SmallVector<Instruction*, 4>> privateStores;
+    for (inst_iterator II = inst_begin(F), E = inst_end(F); II != E; ++II)
+    {
+        if (StoreInst* store = dyn_cast<StoreInst>(&*II))
+        {
+            Value* base = GetUnderlyingObject(store->getPointerOperand(), DL);
+            if (AllocaInst* alloca = dyn_cast<AllocaInst>(base))
+            {
+                if (!store->isVolatile())
+                {
+                    privateStores[alloca].push_back(store);
+                }
+            }
+        }
+    }
+
+    SmallPtrSet<Instruction*, 64> live;
+    SmallVector<Instruction*, 64> worklist;
+    auto markLive = [&](Instruction* I)
+    {
+        if (live.insert(I).second)
+        {
+            worklist.push_back(I);
+        }
+    };
+
+    unsigned numInst = 0;
+    for (inst_iterator II = inst_begin(F), E = inst_end(F); II != E; ++II)
+    {
+        Instruction* I = &*II;
+        numInst++;
+        if (I->isTerminator())
+        {
+            markLive(I);
+        }
+        else if (I->mayHaveSideEffects())
+        {
+            StoreInst* store = dyn_cast<StoreInst>(I);
+            if (!store || store->isVolatile() ||
+                !isa<AllocaInst>(GetUnderlyingObject(store->getPointerOperand(), DL)))
+            {
+                markLive(I);
+            }
+        }
+    }
+
+    while (!worklist.empty())
+    {
+        Instruction* I = worklist.pop_back_val();
+        if (AllocaInst* alloca = dyn_cast<AllocaInst>(I))
+        {
+            // the slot is read by live code, so everything written to it is needed
+            auto SI = privateStores.find(alloca);
+            if (SI != privateStores.end())
+            {
+                for (auto store : SI->second)
+                {
+                    markLive(store);
+                }
+            }
+        }
+        for (Value* op : I->operands())
+        {
+            if (Instruction* opInst = dyn_cast<Instruction>(op))
+            {
+                markLive(opInst);
+            }
+        }
+    }
+
+    SmallVector<Instruction*, 32> dead;
+    unsigned numResourceAccesses = 0;
+    for (inst_iterator II = inst_begin(F), E = inst_end(F); II != E; ++II)
+    {
+        Instruction* I = &*II;
+        if (!live.count(I))
+        {
+            dead.push_back(I);
+            if (isSampleLoadGather4InfoInstruction(I) || isa<LoadInst>(I))
+            {
+                numResourceAccesses++;
+            }
+        }
+    }
+
+    for (auto I : dead)
+    {
+        I->dropAllReferences();
+    }
+    for (auto I : dead)
+    {
+        I->eraseFromParent();
+    }
+
+    if (IGC_IS_FLAG_ENABLED(LogPOSHPositionSlice))
+    {
+        IGC::Debug::ods() << "POSH slice " << F.getName() << ": removed "
+            << (unsigned)dead.size() << " of " << numInst << " instructions, "
+            << numResourceAccesses << " of them loads or sampler messages\n";
+    }
+    return !dead.empty();
+}
@@ -26,4 +26,5 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
-llvm::FunctionPass* createRemoveNonPositionOutputPass();
\ No newline at end of file
+llvm::FunctionPass* createRemoveNonPositionOutputPass();
+llvm::FunctionPass* createPositionOnlySlicePass();
@@ -25,8 +25,10 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 ======================= end_copyright_notice ==================================*/
 
 #include "Compiler/CISACodeGen/PassTimer.hpp"
+#include "common/debug/Dump.hpp"
 
 char PassTimer::ID=0;
+char PassIRStats::ID=0;
 
 bool PassTimer::runOnModule(llvm::Module &M)
 {
@@ -41,3 +43,53 @@ bool PassTimer::runOnModule(llvm::Module &M)
 
     return false;
 }
+
+void PassIRStats::takeSnapshot(llvm::Module &M, Snapshot &S)
+{
+    S = Snapshot();
+    for (auto &F : M)
+    {
+        if (F.isDeclaration())
+        {
+            continue;
+        }
+        S.numFuncs++;
+        for (auto &BB : F)
+        {
+            S.numBlocks++;
+            S.numInsts += (unsigned)BB.size();
+        }
+    }
+}
+
+bool PassIRStats::runOnModule(llvm::Module &M)
+{
+    if (m_isStart)
+    {
+        takeSnapshot(M, *m_before);
+        m_before->start = std::chrono::steady_clock::now();
+        return false;
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    Snapshot after;
+    takeSnapshot(M, after);
+    double timeMS = std::chrono::duration<double, std::milli>(end - m_before->start).count();
+
+    const std::string outputFilePath = IGC::Debug::GetShaderOutputFolder() + std::string("\\SQM\\") +
+        IGC::Debug::GetShaderCorpusName() + "PassStats.jsonl";
+    FILE* fp = fopen(outputFilePath.c_str(), "a");
+    if (!fp)
+    {
+        return false;
+    }
+    fprintf(fp, "{\"hash\":\"%016llx\",\"pipeline\":\"%s\",\"index\":%u,\"pass\":\"%s\",\"timeMS\":%.3f,"
+        "\"before\":{\"funcs\":%u,\"blocks\":%u,\"insts\":%u},"
+        "\"after\":{\"funcs\":%u,\"blocks\":%u,\"insts\":%u}}\n",
+        (unsigned long long)m_context->hash.asmHash.value, m_pipeline.c_str(), m_passIndex,
+        m_passName.c_str(), timeMS,
+        m_before->numFuncs, m_before->numBlocks, m_before->numInsts,
+        after.numFuncs, after.numBlocks, after.numInsts);
+    fclose(fp);
+    return false;
+}
@@ -34,6 +34,10 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/IR/Module.h>
 #include "common/LLVMWarningsPop.hpp"
 
+#include <chrono>
+#include <memory>
+#include <string>
+
 class PassTimer : public llvm::ModulePass
 {
 public:
@@ -62,3 +66,48 @@ private:
     bool m_isStart;
 };
 
+/// Records how one pass changed the IR. A pair of PassIRStats is placed around
+/// the pass: the first takes a snapshot of the module size and the time, the
+/// second appends the elapsed time and the sizes before and after to
+/// <corpus>PassStats.jsonl.
+class PassIRStats : public llvm::ModulePass
+{
+public:
+    struct Snapshot
+    {
+        unsigned numFuncs = 0;
+        unsigned numBlocks = 0;
+        unsigned numInsts = 0;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    PassIRStats(IGC::CodeGenContext* ctx, const std::string& pipeline, const std::string& passName,
+        unsigned passIndex, std::shared_ptr<Snapshot> before, bool isStart) : llvm::ModulePass(ID),
+        m_context(ctx), m_pipeline(pipeline), m_passName(passName), m_passIndex(passIndex),
+        m_before(before), m_isStart(isStart)
+    {
+    }
+    virtual void getAnalysisUsage(llvm::AnalysisUsage &AU) const override
+    {
+        AU.setPreservesAll();
+    }
+
+    virtual bool runOnModule(llvm::Module &M) override;
+
+    virtual llvm::StringRef getPassName() const override
+    {
+        return "passIRStats";
+    }
+
+private:
+    static void takeSnapshot(llvm::Module &M, Snapshot &S);
+
+    IGC::CodeGenContext* m_context;
+    static char ID;
+    std::string m_pipeline;
+    std::string m_passName;
+    unsigned m_passIndex;
+    std::shared_ptr<Snapshot> m_before;
+    bool m_isStart;
+};
+
@@ -201,6 +201,9 @@ bool CodeGenPatternMatch::SIMDConstExpr(Instruction* C)
         case Instruction::Add:
             isConstExpr = IsConstOrSimdConstExpr(op->getOperand(0)) && IsConstOrSimdConstExpr(op->getOperand(1));
             break;
+        case Instruction::Sub:
+            isConstExpr = IsConstOrSimdConstExpr(op->getOperand(0)) && IsConstOrSimdConstExpr(op->getOperand(1));
+            break;
         case Instruction::Mul:
             isConstExpr = IsConstOrSimdConstExpr(op->getOperand(0)) && IsConstOrSimdConstExpr(op->getOperand(1));
             break;
@@ -949,79 +952,82 @@ void CodeGenPatternMatch::visitSelectInst(SelectInst &I)
     assert(match && "Pattern Match failed\n");
 }
 
+namespace
+{
+    typedef bool (*BinaryMatcher)(CodeGenPatternMatch&, llvm::BinaryOperator&);
+
+    bool MatchBinaryFrc(CodeGenPatternMatch& M, llvm::BinaryOperator& I) { return M.MatchFrc(I); }
+    bool MatchBinaryLrp(CodeGenPatternMatch& M, llvm::BinaryOperator& I) { return M.MatchLrp(I); }
+    bool MatchBinaryMad(CodeGenPatternMatch& M, llvm::BinaryOperator& I) { return M.MatchMad(I); }
+    bool MatchBinaryAbsNeg(CodeGenPatternMatch& M, llvm::BinaryOperator& I) { return M.MatchAbsNeg(I); }
+    bool MatchBinaryMulAdd16(CodeGenPatternMatch& M, llvm::BinaryOperator& I) { return M.MatchMulAdd16(I); }
+    bool MatchBinaryFullMul32(CodeGenPatternMatch& M, llvm::BinaryOperator& I) { return M.MatchFullMul32(I); }
+    bool MatchBinaryAvg(CodeGenPatternMatch& M, llvm::BinaryOperator& I) { return M.MatchAvg(I); }
+    bool MatchBinaryRsqrt(CodeGenPatternMatch& M, llvm::BinaryOperator& I) { return M.MatchRsqrt(I); }
+    bool MatchBinaryBoolOp(CodeGenPatternMatch& M, llvm::BinaryOperator& I) { return M.MatchBoolOp(I); }
+    bool MatchBinaryLogicAlu(CodeGenPatternMatch& M, llvm::BinaryOperator& I) { return M.MatchLogicAlu(I); }
+    bool MatchBinaryModifier(CodeGenPatternMatch& M, llvm::BinaryOperator& I) { return M.MatchModifier(I); }
+    bool MatchBinaryModifierNoSrc0Mod(CodeGenPatternMatch& M, llvm::BinaryOperator& I) { return M.MatchModifier(I, false); }
+
+    /// Candidate patterns for every binary opcode, tried in order until one
+    /// matches. An instruction only reaches the matchers listed for its own
+    /// opcode, and a new fused pattern only needs adding to the rows it can
+    /// apply to.
+    class BinaryPatternTable
+    {
+    public:
+        BinaryPatternTable()
+        {
+            set(Instruction::FSub, { MatchBinaryFrc, MatchBinaryLrp, MatchBinaryMad, MatchBinaryAbsNeg, MatchBinaryModifier });
+            set(Instruction::Sub, { MatchBinaryAbsNeg, MatchBinaryMulAdd16, MatchBinaryModifier });
+            set(Instruction::Mul, { MatchBinaryFullMul32, MatchBinaryMulAdd16, MatchBinaryModifier });
+            set(Instruction::Add, { MatchBinaryMulAdd16, MatchBinaryModifier });
+            set(Instruction::UDiv, { MatchBinaryAvg, MatchBinaryModifier });
+            set(Instruction::SDiv, { MatchBinaryAvg, MatchBinaryModifier });
+            set(Instruction::AShr, { MatchBinaryAvg, MatchBinaryModifier });
+            set(Instruction::FMul, { MatchBinaryModifier });
+            set(Instruction::URem, { MatchBinaryModifier });
+            set(Instruction::SRem, { MatchBinaryModifier });
+            set(Instruction::FRem, { MatchBinaryModifier });
+            set(Instruction::Shl, { MatchBinaryModifier });
+            set(Instruction::LShr, { MatchBinaryModifierNoSrc0Mod });
+            set(Instruction::FDiv, { MatchBinaryRsqrt, MatchBinaryModifier });
+            set(Instruction::FAdd, { MatchBinaryLrp, MatchBinaryMad, MatchBinaryModifier });
+            set(Instruction::And, { MatchBinaryBoolOp, MatchBinaryLogicAlu });
+            set(Instruction::Or, { MatchBinaryBoolOp, MatchBinaryLogicAlu });
+            set(Instruction::Xor, { MatchBinaryLogicAlu });
+        }
+
+        const std::vector<BinaryMatcher>& get(unsigned opcode) const
+        {
+            assert(opcode >= Instruction::BinaryOpsBegin && opcode < Instruction::BinaryOpsEnd);
+            return m_rows[opcode - Instruction::BinaryOpsBegin];
+        }
+
+    private:
+        void set(unsigned opcode, std::initializer_list<BinaryMatcher> matchers)
+        {
+            m_rows[opcode - Instruction::BinaryOpsBegin] = matchers;
+        }
+
+        std::vector<BinaryMatcher> m_rows[Instruction::BinaryOpsEnd - Instruction::BinaryOpsBegin];
+    };
+}
+
 void CodeGenPatternMatch::visitBinaryOperator(llvm::BinaryOperator &I)
 {
+    static const BinaryPatternTable table;
 
     bool match = false;
-    switch(I.getOpcode())
+    for (BinaryMatcher matcher : table.get(I.getOpcode()))
     {
-    case Instruction::FSub:
-        match = MatchFrc(I) ||
-                MatchLrp(I) ||
-                MatchMad(I) ||
-                MatchAbsNeg(I) ||
-                MatchModifier(I);
-        break;
-    case Instruction::Sub:
-        match =
-                MatchAbsNeg(I) ||
-                MatchMulAdd16(I) ||
-                MatchModifier(I);
-        break;
-    case Instruction::Mul:
-        match = MatchFullMul32(I) ||
-                MatchMulAdd16(I) ||
-                MatchModifier(I);
-        break;
-    case Instruction::Add:
-        match =
-                MatchMulAdd16(I) ||
-                MatchModifier(I);
-        break;
-    case Instruction::UDiv:
-    case Instruction::SDiv:
-    case Instruction::AShr:
-        match = MatchAvg(I) ||
-                MatchModifier(I);
-        break;
-    case Instruction::FMul:
-    case Instruction::URem:
-    case Instruction::SRem:
-    case Instruction::FRem:
-    case Instruction::Shl:
-        match = MatchModifier(I);
-        break;
-    case Instruction::LShr:
-        match = MatchModifier(I, false);
-        break;
-    case Instruction::FDiv:
-        match = MatchRsqrt(I) ||
-                MatchModifier(I);
-        break;
-    case Instruction::FAdd:
-        match = MatchLrp(I) ||
-                MatchMad(I) ||
-                MatchModifier(I);
-        break;
-    case Instruction::And:
-        match = 
-				MatchBoolOp(I) ||
-                MatchLogicAlu(I);
-        break;
-    case Instruction::Or:
-        match = 
-                MatchBoolOp(I) ||
-                MatchLogicAlu(I);
-        break;
-    case Instruction::Xor:
-		match =
-				MatchLogicAlu(I);
-		break;
-    default:
-        assert(0 && "unknown binary instruction");
-        break;
+        if (matcher(*this, I))
+        {
+            match = true;
+            break;
+        }
     }
-    assert(match == true);
+    assert(match && "unknown binary instruction");
 }
 
 void CodeGenPatternMatch::visitCmpInst(llvm::CmpInst &I)
@@ -1297,6 +1297,7 @@ namespace IGC
                 phaseFunc = (i == 0) ? coarsePhase : pixelPhase;
                 shaders[phaseFunc]->FillProgram(&outputs[i]);
                 COMPILER_SHADER_STATS_PRINT(shaders[phaseFunc]->m_shaderStats, ShaderType::PIXEL_SHADER, ctx->hash, "");
+                COMPILER_SHADER_STATS_PRINT_JSONL(shaders[phaseFunc]->m_shaderStats, ctx, "");
                 COMPILER_SHADER_STATS_SUM(ctx->m_sumShaderStats, shaders[phaseFunc]->m_shaderStats, ShaderType::PIXEL_SHADER);
                 COMPILER_SHADER_STATS_DEL(shaders[phaseFunc]->m_shaderStats);
                 delete shaders[phaseFunc];
@@ -1312,6 +1313,7 @@ namespace IGC
             // gather data to send back to the driver
             shaders[pFunc]->FillProgram(&ctx->programOutput);
             COMPILER_SHADER_STATS_PRINT(shaders[pFunc]->m_shaderStats, ShaderType::PIXEL_SHADER, ctx->hash, "");
+            COMPILER_SHADER_STATS_PRINT_JSONL(shaders[pFunc]->m_shaderStats, ctx, "");
             COMPILER_SHADER_STATS_SUM(ctx->m_sumShaderStats, shaders[pFunc]->m_shaderStats, ShaderType::PIXEL_SHADER);
             COMPILER_SHADER_STATS_DEL(shaders[pFunc]->m_shaderStats);
             delete shaders[pFunc];
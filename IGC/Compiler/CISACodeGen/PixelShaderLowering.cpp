@@ -737,6 +737,11 @@ void PixelShaderLowering::EmitRTWrite(
             if (hasDiscard)
             {
                 m_module->getOrInsertNamedMetadata("KillPixel");
+
+    if (IGC_IS_FLAG_ENABLED(EnableEarlyDiscardHoisting))
+    {
+        hoistDiscards();
+    }
             }
         }
     }
@@ -1388,6 +1393,32 @@ Instruction* DiscardLowering::addPhi(Instruction* v, BasicBlock* newRetBB)
     return phi;
 }
 
+void DiscardLowering::hoistDiscards()
+{
+    for (auto discard : m_discards)
+    {
+        Instruction* cond = dyn_cast<Instruction>(discard->getOperand(0));
+        BasicBlock* bb = discard->getParent();
+        Instruction* insertPt = discard;
+        while (insertPt != &bb->front())
+        {
+            Instruction* prev = insertPt->getPrevNode();
+            // killed pixels may skip pure computations, but memory writes
+            // and other side effects have to be kept in order
+            if (prev == cond || isa<PHINode>(prev) ||
+                prev->mayWriteToMemory() || prev->mayHaveSideEffects())
+            {
+                break;
+            }
+            insertPt = prev;
+        }
+        if (insertPt != discard)
+        {
+            discard->moveBefore(insertPt);
+        }
+    }
+}
+
 bool DiscardLowering::lowerDiscards(Function& F)
 {
     unsigned numDiscards = m_discards.size();
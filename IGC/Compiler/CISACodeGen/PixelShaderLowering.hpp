@@ -222,6 +222,10 @@ private:
 
     bool lowerDiscards(llvm::Function& F);
 
+    // move discards up to right after their condition so the early return
+    // skips as much work as possible
+    void hoistDiscards();
+
     // add phi node for output values in the new ret BB created for
     // discard early return
     llvm::Instruction* addPhi(llvm::Instruction* v,
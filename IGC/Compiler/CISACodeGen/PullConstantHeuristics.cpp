@@ -27,6 +27,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "PullConstantHeuristics.hpp"
 
 #include "Platform.hpp"
+#include "helper.h"
+#include "common/debug/Debug.hpp"
 
 using namespace llvm;
 using namespace IGC;
@@ -35,6 +37,9 @@ using namespace IGC;
 static const unsigned EUInstCycleCount = 2;
 static const unsigned SendInstCycleCount = 190;
 static const unsigned RTWriteInstCycleCount = 190;
+// Weight of a constant load per level of loop nesting in the cost model.
+static const unsigned LoopDepthWeight = 8;
+static const unsigned MaxLoopDepthWeighted = 3;
 
 char PullConstantHeuristics::ID = 0;
 
@@ -44,6 +49,7 @@ char PullConstantHeuristics::ID = 0;
 #define PASS_ANALYSIS true
 IGC_INITIALIZE_PASS_BEGIN(PullConstantHeuristics, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
 IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+IGC_INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
 IGC_INITIALIZE_PASS_END(PullConstantHeuristics, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
 
 
@@ -169,9 +175,83 @@ static unsigned getCurrentPayloadSizeEstimate(const Function &F)
     return payloadHeaderSIMD16 + payloadBarySIMD16 + inputGRFSize;
 }
 
+//Cost model: push the constants loaded by F, in the order PushAnalysis visits
+//them, for as long as the pull messages saved outweigh the extra payload.
+//  pull cost of a load   = SendInstCycleCount * LoopDepthWeight^loop_depth
+//  push cost of one GRF  = 0 while the payload is below the PSD bottleneck,
+//                          numThreadsPerSubslice above it (one more payload
+//                          GRF per thread in flight on the subslice)
+//Returns the number of GRFs to push for a SIMD16 dispatch.
+unsigned PullConstantHeuristics::getCostModelThreshold(Function &F, unsigned payloadWithoutConstants)
+{
+    CodeGenContext *ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+    LoopInfo &LI = getAnalysis<LoopInfoWrapperPass>(F).getLoopInfo();
+    const DataLayout &DL = F.getParent()->getDataLayout();
+    const unsigned numThreadsPerSubslice = ctx->platform.getMaxNumberThreadPerSubslice();
+
+    unsigned PSDBottleNeckThreshold = getPSDBottleNeckThreshold(F);
+    unsigned freeGRFs = PSDBottleNeckThreshold > payloadWithoutConstants ?
+        PSDBottleNeckThreshold - payloadWithoutConstants : 0;
+
+    unsigned numPulls = 0;
+    unsigned pushedBytes = 0;
+    int64_t gain = 0;
+    int64_t bestGain = 0;
+    unsigned bestGRFs = freeGRFs;
+    for (auto& BB : F)
+    {
+        unsigned depth = std::min(LI.getLoopDepth(&BB), MaxLoopDepthWeighted);
+        unsigned weight = 1;
+        for (unsigned i = 0; i < depth; ++i)
+        {
+            weight *= LoopDepthWeight;
+        }
+        for (auto& I : BB)
+        {
+            uint cbId = 0;
+            Value* eltPtrVal = nullptr;
+            if (!isa<LoadInst>(I) || !IsLoadFromDirectCB(&I, cbId, eltPtrVal))
+            {
+                continue;
+            }
+            numPulls++;
+            unsigned prevGRFs = (pushedBytes + SIZE_GRF - 1) / SIZE_GRF;
+            pushedBytes += (unsigned)DL.getTypeAllocSize(I.getType());
+            unsigned GRFs = (pushedBytes + SIZE_GRF - 1) / SIZE_GRF;
+            for (unsigned g = prevGRFs; g < GRFs; ++g)
+            {
+                if (g >= freeGRFs)
+                {
+                    gain -= numThreadsPerSubslice;
+                }
+            }
+            gain += weight * SendInstCycleCount;
+            if (gain > bestGain)
+            {
+                bestGain = gain;
+                bestGRFs = std::max(GRFs, freeGRFs);
+            }
+        }
+    }
+    bestGRFs = std::min(bestGRFs, pushConstantGRFThreshold);
+
+    if (IGC_IS_FLAG_ENABLED(LogPullConstantCostModel))
+    {
+        IGC::Debug::ods() << "PullConstantCostModel: " << F.getName()
+            << " payload=" << payloadWithoutConstants
+            << " PSDThreshold=" << PSDBottleNeckThreshold
+            << " constantLoads=" << numPulls
+            << " constantGRFs=" << (pushedBytes + SIZE_GRF - 1) / SIZE_GRF
+            << " push=" << bestGRFs
+            << " gain=" << bestGain << "\n";
+    }
+    return bestGRFs;
+}
+
 bool PullConstantHeuristics::runOnModule( Module &M)
 {
-    if (IGC_IS_FLAG_ENABLED(DisablePullConstantHeuristics))
+    if (IGC_IS_FLAG_ENABLED(DisablePullConstantHeuristics) &&
+        IGC_IS_FLAG_DISABLED(EnablePullConstantCostModel))
     {
         return false;
     }
@@ -180,6 +260,15 @@ bool PullConstantHeuristics::runOnModule( Module &M)
     {
         for (auto& F : M)
         {
+            if (IGC_IS_FLAG_ENABLED(EnablePullConstantCostModel))
+            {
+                if (!F.isDeclaration())
+                {
+                    unsigned threshold = getCostModelThreshold(F, getCurrentPayloadSizeEstimate(F));
+                    thresholdMap.insert(std::make_pair(&F, threshold));
+                }
+                continue;
+            }
             if (F.getBasicBlockList().size() == 1)
             {
                 BasicBlock* BB = &(*F.begin());
@@ -30,6 +30,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/LLVMWarningsPush.hpp"
 #include "llvm/Pass.h"
 #include "llvm/PassAnalysisSupport.h"
+#include "llvm/Analysis/LoopInfo.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/InstrTypes.h"
 #include <llvm/IR/InstVisitor.h>
@@ -52,11 +53,13 @@ namespace IGC
         virtual void getAnalysisUsage(llvm::AnalysisUsage &AU) const override
         {
             AU.addRequired<IGC::CodeGenContextWrapper>();
+            AU.addRequired<llvm::LoopInfoWrapperPass>();
             AU.setPreservesAll();
         }
 
         bool runOnModule(llvm::Module &M) override;
         unsigned getPSDBottleNeckThreshold(const llvm::Function &F);
+        unsigned getCostModelThreshold(llvm::Function &F, unsigned payloadWithoutConstants);
 
         unsigned getPushConstantThreshold(llvm::Function* F)
         {
@@ -223,6 +223,11 @@ namespace IGC
             return getNumRegs(grfuse, simdsize);
         }
 
+        // Return the number of GRF needed for a single value
+        uint32_t getNumGRFOfValue(llvm::Value *V, uint16_t simdsize = 16) const {
+            return getNumRegs(estimateNumOfRegs(V), simdsize);
+        }
+
         uint32_t getNumValues() const {
             return (uint32_t)m_ValueRegUses.capacity();
         }
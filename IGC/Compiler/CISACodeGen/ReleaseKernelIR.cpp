@@ -0,0 +1,98 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#include "ReleaseKernelIR.hpp"
+#include "GenCodeGenModule.h"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/SmallVector.h>
+#include "common/LLVMWarningsPop.hpp"
+
+using namespace llvm;
+using namespace IGC;
+
+char ReleaseKernelIRPass::ID = 0;
+
+ReleaseKernelIRPass::ReleaseKernelIRPass(CShaderProgram::KernelShaderMap &k) :
+    FunctionPass(ID),
+    kernels(k)
+{
+}
+
+bool ReleaseKernelIRPass::runOnFunction(Function &F)
+{
+    GenXFunctionGroupAnalysis* FGA = getAnalysisIfAvailable<GenXFunctionGroupAnalysis>();
+
+    Function* head = &F;
+    SmallVector<Function*, 8> groupFuncs;
+    if (FGA && FGA->getGroup(&F))
+    {
+        // EmitPass finalizes the kernel on the group tail
+        if (!FGA->isGroupTail(&F))
+        {
+            return false;
+        }
+        FunctionGroup* FG = FGA->getGroup(&F);
+        head = FG->getHead();
+        for (auto SubGroup : FG->Functions)
+        {
+            for (Function* G : *SubGroup)
+            {
+                groupFuncs.push_back(G);
+            }
+        }
+    }
+    else
+    {
+        groupFuncs.push_back(&F);
+    }
+
+    auto it = kernels.find(head);
+    if (it == kernels.end())
+    {
+        return false;
+    }
+
+    for (auto simd : { SIMDMode::SIMD8, SIMDMode::SIMD16, SIMDMode::SIMD32 })
+    {
+        if (CShader* shader = it->second->GetShader(simd))
+        {
+            shader->ReleaseCodeGenState();
+        }
+    }
+
+    // Group functions are cloned per kernel, so only calls from within the
+    // group (which go away as well) can refer to them.
+    bool changed = false;
+    for (Function* G : groupFuncs)
+    {
+        if (!G->isDeclaration() && !G->hasAddressTaken())
+        {
+            G->deleteBody();
+            changed = true;
+        }
+    }
+    return changed;
+}
@@ -0,0 +1,59 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#pragma once
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Pass.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include "ShaderCodeGen.hpp"
+
+namespace IGC
+{
+    /// Streaming mode for OpenCL code generation (EnableStreamingCodeGen).
+    /// Runs right after the last EmitPass. Once the tail of a function group
+    /// has been emitted for every SIMD width, the binaries of the kernel are
+    /// final, so the LLVM bodies of the group's functions and the codegen
+    /// state of its shaders are freed instead of living until the end of
+    /// CodeGen.
+    class ReleaseKernelIRPass : public llvm::FunctionPass
+    {
+    public:
+        static char ID;
+
+        ReleaseKernelIRPass(CShaderProgram::KernelShaderMap &k);
+
+        virtual llvm::StringRef getPassName() const override
+        {
+            return "ReleaseKernelIRPass";
+        }
+
+        virtual bool runOnFunction(llvm::Function &F) override;
+
+    private:
+        CShaderProgram::KernelShaderMap &kernels;
+    };
+} // namespace IGC
@@ -39,6 +39,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/ADT/DenseSet.h>
 #include <llvm/ADT/PostOrderIterator.h>
 #include <llvm/Analysis/LoopInfo.h>
+#include <llvm/IR/CallSite.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/NoFolder.h>
 #include <llvm/Pass.h>
@@ -136,10 +137,41 @@ private:
   bool visitCallInst(CallInst &);
 };
 
+// GASResolving only sees casts within one function. A generic pointer coming
+// in through a function argument or reloaded from a private slot stays
+// generic there even when every value that can reach it is cast from the same
+// address space. This pass retypes such arguments and slots to that address
+// space, leaving an `addrspacecast` to GAS behind for GASResolving to push
+// through the remaining uses.
+class GASRetyping : public ModulePass {
+  const unsigned GAS = ADDRESS_SPACE_GENERIC;
+
+public:
+  static char ID;
+
+  GASRetyping() : ModulePass(ID) {
+    initializeGASRetypingPass(*PassRegistry::getPassRegistry());
+  }
+
+  bool runOnModule(Module &) override;
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.addRequired<MetaDataUtilsWrapper>();
+    AU.addRequired<CodeGenContextWrapper>();
+  }
+
+private:
+  bool mergeAddrSpace(Value *V, unsigned &AS) const;
+  bool retypeAllocas(Function *F) const;
+  bool retypeArgs(Function *F) const;
+};
+
 } // End anonymous namespace
 
 FunctionPass *IGC::createResolveGASPass() { return new GASResolving(); }
 
+ModulePass *IGC::createGASRetypingPass() { return new GASRetyping(); }
+
 char GASResolving::ID = 0;
 
 #define PASS_FLAG "igc-gas-resolve"
@@ -154,6 +186,21 @@ IGC_INITIALIZE_PASS_END(GASResolving, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY,
                         PASS_ANALYSIS)
 }
 
+char GASRetyping::ID = 0;
+
+#undef PASS_FLAG
+#undef PASS_DESC
+#define PASS_FLAG "igc-gas-retyping"
+#define PASS_DESC "Retype generic pointer arguments and slots"
+namespace IGC {
+IGC_INITIALIZE_PASS_BEGIN(GASRetyping, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY,
+                          PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
+IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+IGC_INITIALIZE_PASS_END(GASRetyping, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY,
+                        PASS_ANALYSIS)
+}
+
 bool GASResolving::runOnFunction(Function &F) {
   BuilderType TheBuilder(F.getContext());
   GASPropagator ThePropagator(this, &TheBuilder);
@@ -633,3 +680,223 @@ bool GASPropagator::visitCallInst(CallInst &I) {
 
   return false;
 }
+
+bool GASRetyping::runOnModule(Module &M) {
+  bool Changed = false;
+
+  for (auto &F : M)
+    if (!F.isDeclaration())
+      Changed |= retypeAllocas(&F);
+
+  // Retyping a callee's argument exposes a cast at its own call sites, so
+  // iterate until no argument can be narrowed any more. Every round removes
+  // at least one generic argument, hence this terminates.
+  bool LocalChanged;
+  do {
+    LocalChanged = false;
+    for (auto FI = M.begin(), FE = M.end(); FI != FE; /* EMPTY */) {
+      Function *F = &*FI++; // Retyping replaces F in the function list.
+      LocalChanged |= retypeArgs(F);
+    }
+    Changed |= LocalChanged;
+  } while (LocalChanged);
+
+  return Changed;
+}
+
+// Merge the address space `V` is known to point to into `AS`. Null and undef
+// pointers are compatible with any address space.
+bool GASRetyping::mergeAddrSpace(Value *V, unsigned &AS) const {
+  if (isa<ConstantPointerNull>(V) || isa<UndefValue>(V))
+    return true;
+  AddrSpaceCastInst *ASCI = dyn_cast<AddrSpaceCastInst>(V);
+  if (!ASCI)
+    return false;
+  unsigned SrcAS = ASCI->getSrcTy()->getPointerAddressSpace();
+  if (SrcAS == GAS || (AS != GAS && AS != SrcAS))
+    return false;
+  AS = SrcAS;
+  return true;
+}
+
+// Get the value to use in place of `V` once its generic type `GASTy` is
+// narrowed to `NewTy`, inserting any bitcast needed before `InsertPt`.
+static Value *getNarrowedValue(Value *V, PointerType *NewTy,
+                               Instruction *InsertPt) {
+  if (isa<ConstantPointerNull>(V))
+    return ConstantPointerNull::get(NewTy);
+  if (isa<UndefValue>(V))
+    return UndefValue::get(NewTy);
+  Value *Src = cast<AddrSpaceCastInst>(V)->getOperand(0);
+  if (Src->getType() != NewTy)
+    Src = new BitCastInst(Src, NewTy, "", InsertPt);
+  return Src;
+}
+
+bool GASRetyping::retypeAllocas(Function *F) const {
+  SmallVector<std::pair<AllocaInst *, unsigned>, 4> Candidates;
+
+  for (auto &I : F->getEntryBlock()) {
+    AllocaInst *AI = dyn_cast<AllocaInst>(&I);
+    if (!AI || AI->isArrayAllocation())
+      continue;
+    PointerType *SlotTy = dyn_cast<PointerType>(AI->getAllocatedType());
+    if (!SlotTy || SlotTy->getAddressSpace() != GAS)
+      continue;
+
+    // The slot must not escape: it is only loaded from or stored into.
+    unsigned AS = GAS;
+    bool Resolvable = true;
+    for (auto *U : AI->users()) {
+      if (LoadInst *LI = dyn_cast<LoadInst>(U)) {
+        if (LI->isAtomic()) {
+          Resolvable = false;
+          break;
+        }
+        continue;
+      }
+      StoreInst *SI = dyn_cast<StoreInst>(U);
+      if (!SI || SI->isAtomic() || SI->getValueOperand() == AI ||
+          !mergeAddrSpace(SI->getValueOperand(), AS)) {
+        Resolvable = false;
+        break;
+      }
+    }
+    if (Resolvable && AS != GAS)
+      Candidates.push_back(std::make_pair(AI, AS));
+  }
+
+  for (auto &C : Candidates) {
+    AllocaInst *AI = C.first;
+    PointerType *SlotTy = cast<PointerType>(AI->getAllocatedType());
+    PointerType *NewTy = PointerType::get(SlotTy->getElementType(), C.second);
+
+    AllocaInst *NewAI = new AllocaInst(NewTy, AI->getType()->getAddressSpace(),
+                                       nullptr, AI->getAlignment(), "", AI);
+    NewAI->takeName(AI);
+    for (auto UI = AI->user_begin(), UE = AI->user_end(); UI != UE;
+         /* EMPTY */) {
+      Instruction *I = cast<Instruction>(*UI++);
+      if (StoreInst *SI = dyn_cast<StoreInst>(I)) {
+        SI->setOperand(0, getNarrowedValue(SI->getValueOperand(), NewTy, SI));
+        SI->setOperand(1, NewAI);
+        continue;
+      }
+      // Reload the narrowed pointer and cast it back to GAS so that
+      // GASResolving can propagate it.
+      LoadInst *LI = cast<LoadInst>(I);
+      LoadInst *NewLI = new LoadInst(NewAI, "", LI->isVolatile(),
+                                     LI->getAlignment(), LI);
+      NewLI->setDebugLoc(LI->getDebugLoc());
+      Instruction *NewPtr = new AddrSpaceCastInst(NewLI, SlotTy, "", LI);
+      NewPtr->takeName(LI);
+      LI->replaceAllUsesWith(NewPtr);
+      LI->eraseFromParent();
+    }
+    AI->eraseFromParent();
+  }
+
+  return !Candidates.empty();
+}
+
+bool GASRetyping::retypeArgs(Function *F) const {
+  if (F->isDeclaration() || !F->hasLocalLinkage() || F->isVarArg() ||
+      F->use_empty())
+    return false;
+
+  // Only functions whose every use is a direct call can have their signature
+  // changed.
+  SmallVector<CallInst *, 8> Calls;
+  for (auto &U : F->uses()) {
+    CallInst *CI = dyn_cast<CallInst>(U.getUser());
+    if (!CI || !CallSite(CI).isCallee(&U))
+      return false;
+    Calls.push_back(CI);
+  }
+
+  FunctionType *FTy = F->getFunctionType();
+  SmallVector<Type *, 8> ParamTys(FTy->param_begin(), FTy->param_end());
+  SmallVector<bool, 8> Narrowed(ParamTys.size(), false);
+  bool Changed = false;
+  for (unsigned i = 0, e = ParamTys.size(); i != e; ++i) {
+    PointerType *PtrTy = dyn_cast<PointerType>(ParamTys[i]);
+    if (!PtrTy || PtrTy->getAddressSpace() != GAS)
+      continue;
+    unsigned AS = GAS;
+    bool Resolvable = true;
+    for (auto *CI : Calls) {
+      if (!mergeAddrSpace(CI->getArgOperand(i), AS)) {
+        Resolvable = false;
+        break;
+      }
+    }
+    if (!Resolvable || AS == GAS)
+      continue;
+    ParamTys[i] = PointerType::get(PtrTy->getElementType(), AS);
+    Narrowed[i] = true;
+    Changed = true;
+  }
+  if (!Changed)
+    return false;
+
+  // Create the function with the narrowed signature and move the body over.
+  FunctionType *NewFTy =
+      FunctionType::get(FTy->getReturnType(), ParamTys, false);
+  Function *NewF = Function::Create(NewFTy, F->getLinkage());
+  NewF->copyAttributesFrom(F);
+  NewF->setSubprogram(F->getSubprogram());
+  F->getParent()->getFunctionList().insert(F->getIterator(), NewF);
+  NewF->takeName(F);
+  NewF->getBasicBlockList().splice(NewF->begin(), F->getBasicBlockList());
+
+  BuilderType IRB(NewF->getContext());
+  IRB.SetInsertPoint(&*NewF->getEntryBlock().getFirstInsertionPt());
+  for (auto AI = F->arg_begin(), AE = F->arg_end(), NAI = NewF->arg_begin();
+       AI != AE; ++AI, ++NAI) {
+    NAI->takeName(&*AI);
+    Value *NewVal = &*NAI;
+    if (Narrowed[AI->getArgNo()])
+      NewVal = IRB.CreateAddrSpaceCast(&*NAI, AI->getType());
+    AI->replaceAllUsesWith(NewVal);
+  }
+
+  for (auto *CI : Calls) {
+    SmallVector<Value *, 8> Args;
+    for (unsigned i = 0, e = CI->getNumArgOperands(); i != e; ++i) {
+      Value *Arg = CI->getArgOperand(i);
+      if (Narrowed[i])
+        Arg = getNarrowedValue(Arg, cast<PointerType>(ParamTys[i]), CI);
+      Args.push_back(Arg);
+    }
+    CallInst *NewCI = CallInst::Create(NewF, Args, "", CI);
+    NewCI->setCallingConv(CI->getCallingConv());
+    NewCI->setAttributes(CI->getAttributes());
+    NewCI->setTailCallKind(CI->getTailCallKind());
+    NewCI->setDebugLoc(CI->getDebugLoc());
+    NewCI->takeName(CI);
+    CI->replaceAllUsesWith(NewCI);
+    CI->eraseFromParent();
+  }
+
+  // The function declaration changed, move its metadata over.
+  MetaDataUtils *MDU = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+  auto FII = MDU->findFunctionsInfoItem(F);
+  if (FII != MDU->end_FunctionsInfo()) {
+    MDU->setFunctionsInfoItem(NewF, FII->second);
+    MDU->eraseFunctionsInfoItem(FII);
+    MDU->save(F->getContext());
+  }
+  auto &FuncMD = getAnalysis<CodeGenContextWrapper>()
+                     .getCodeGenContext()
+                     ->getModuleMetaData()
+                     ->FuncMD;
+  auto Loc = FuncMD.find(F);
+  if (Loc != FuncMD.end()) {
+    auto FuncInfo = Loc->second;
+    FuncMD.erase(F);
+    FuncMD[NewF] = FuncInfo;
+  }
+
+  F->eraseFromParent();
+  return true;
+}
@@ -45,6 +45,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/Support/MathExtras.h>
 #include "common/LLVMWarningsPop.hpp"
 
+#include <map>
 #include <vector>
 
 using namespace llvm;
@@ -133,12 +134,17 @@ namespace
         // Return true if constant propagation is performed.
         bool performConstProp();
 
+        // Return true if any load is replaced with a work-group uniform
+        // value stored to the same constant SLM address before the barrier.
+        bool forwardUniformStores();
+
         bool find_PATTERN_REPEAT_WITH_STRIDE(PatternInfo& aPattern);
         bool perform_PATTERN_REPEAT_WITH_STRIDE(PatternInfo& aPattern);
 
         // Helper functions
         bool isEqual(Constant* C0, Constant* C1);
         bool isLinearFuncOfLocalIds(SymExpr* SE);
+        bool isWorkGroupUniform(Value* V, DenseMap<Value*, bool>& visited, int depth);
         bool isFloatType(Type* Ty);
         Constant* convertIfNeeded(Type* Ty, Constant* C);
     };
@@ -978,6 +984,169 @@ bool SLMConstProp::performConstProp()
     return changed;
 }
 
+bool SLMConstProp::isWorkGroupUniform(
+    Value* V, DenseMap<Value*, bool>& visited, int depth)
+{
+    if (isa<Constant>(V)) {
+        return true;
+    }
+    Instruction* I = dyn_cast<Instruction>(V);
+    if (!I || depth > 16) {
+        return false;
+    }
+
+    auto MI = visited.find(V);
+    if (MI != visited.end()) {
+        return MI->second;
+    }
+    // Assume non-uniform while visiting to break any cycle.
+    visited[V] = false;
+
+    bool isUniform = false;
+    if (GenIntrinsicInst* GII = dyn_cast<GenIntrinsicInst>(I))
+    {
+        switch (GII->getIntrinsicID()) {
+        case GenISAIntrinsic::GenISA_RuntimeValue:
+            isUniform = true;
+            break;
+        case GenISAIntrinsic::GenISA_DCL_SystemValue:
+        {
+            SGVUsage usage = static_cast<SGVUsage>(
+                cast<ConstantInt>(GII->getOperand(0))->getZExtValue());
+            isUniform = (usage == THREAD_GROUP_ID_X ||
+                         usage == THREAD_GROUP_ID_Y ||
+                         usage == THREAD_GROUP_ID_Z);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    else if (LoadInst* LI = dyn_cast<LoadInst>(I))
+    {
+        // Only a load from a constant buffer at a uniform address
+        // gives the same value to every thread in the group.
+        bool directIdx = false;
+        unsigned int bufId = 0;
+        if (!LI->isVolatile() &&
+            DecodeAS4GFXResource(LI->getPointerAddressSpace(), directIdx, bufId) == CONSTANT_BUFFER)
+        {
+            isUniform = isWorkGroupUniform(LI->getPointerOperand(), visited, depth + 1);
+        }
+    }
+    else if (isa<BinaryOperator>(I) || isa<CastInst>(I) || isa<CmpInst>(I) ||
+             isa<SelectInst>(I) || isa<ExtractElementInst>(I) ||
+             isa<InsertElementInst>(I) || isa<GetElementPtrInst>(I))
+    {
+        // Phis are not handled, as a uniform incoming value may
+        // still be selected by a divergent branch.
+        isUniform = true;
+        for (Value* Opnd : I->operands())
+        {
+            if (!isWorkGroupUniform(Opnd, visited, depth + 1)) {
+                isUniform = false;
+                break;
+            }
+        }
+    }
+
+    visited[V] = isUniform;
+    return isUniform;
+}
+
+// A work-group uniform value that one thread writes to SLM before the
+// barrier and every thread reads back afterwards is equal to the value
+// each thread can compute on its own. Replace such loads with the stored
+// value, which removes the SLM round trip for the readers.
+//
+// Handled only when every SLM store is to a constant address, so there
+// is no aliasing between stores; a store whose address is not constant
+// disables the whole transformation.
+bool SLMConstProp::forwardUniformStores()
+{
+    struct UniformStore {
+        StoreInst* SI;
+        int64_t    size;
+        bool       valid;
+    };
+    std::map<int64_t, UniformStore> storeMap;
+
+    for (int i = 0, e = (int)m_storeInsts.size(); i < e; ++i)
+    {
+        StoreInst* SI = m_storeInsts[i];
+        SymExpr* SE = m_SymEval.getSymExpr(SI->getPointerOperand());
+        if (SE->SymTerms.size() != 0 || SI->isVolatile()) {
+            return false;
+        }
+        int64_t off = SE->ConstTerm;
+        int64_t sz = (int64_t)m_DL->getTypeStoreSize(SI->getValueOperand()->getType());
+        auto MI = storeMap.find(off);
+        if (MI != storeMap.end())
+        {
+            // Several stores to the same location are fine as long as they
+            // all store the same value of the same type.
+            UniformStore& US = MI->second;
+            if (US.size != sz ||
+                US.SI->getValueOperand() != SI->getValueOperand()) {
+                US.valid = false;
+            }
+            continue;
+        }
+        UniformStore US = { SI, sz, true };
+        storeMap[off] = US;
+    }
+
+    // Reject any partially overlapping stores.
+    int64_t prevEnd = INT64_MIN;
+    for (auto& II : storeMap)
+    {
+        if (II.first < prevEnd) {
+            return false;
+        }
+        prevEnd = II.first + II.second.size;
+    }
+
+    bool changed = false;
+    DenseMap<Value*, bool> visited;
+    SmallVector<LoadInst*, 16> remainingLoads;
+    for (int i = 0, e = (int)m_loadInsts.size(); i < e; ++i)
+    {
+        LoadInst* LI = m_loadInsts[i];
+        SymExpr* SE = m_SymEval.getSymExpr(LI->getPointerOperand());
+        auto MI = (SE->SymTerms.size() == 0 && !LI->isVolatile())
+            ? storeMap.find(SE->ConstTerm) : storeMap.end();
+        if (MI == storeMap.end() || !MI->second.valid)
+        {
+            remainingLoads.push_back(LI);
+            continue;
+        }
+
+        Value* storedVal = MI->second.SI->getValueOperand();
+        if (storedVal->getType() != LI->getType() ||
+            !isWorkGroupUniform(storedVal, visited, 0))
+        {
+            remainingLoads.push_back(LI);
+            continue;
+        }
+
+        Instruction* storedInst = dyn_cast<Instruction>(storedVal);
+        if (storedInst && !m_DT->dominates(storedInst, LI))
+        {
+            remainingLoads.push_back(LI);
+            continue;
+        }
+
+        LI->replaceAllUsesWith(storedVal);
+        LI->eraseFromParent();
+        changed = true;
+    }
+
+    if (changed) {
+        m_loadInsts = remainingLoads;
+    }
+    return changed;
+}
+
 bool SLMConstProp::runOnFunction(Function& F)
 {
 #if 0
@@ -1123,8 +1292,10 @@ bool SLMConstProp::runOnFunction(Function& F)
         }
     }
     
+    bool forwardUniform = IGC_IS_FLAG_ENABLED(EnableSLMUniformForwarding);
     if (mayHaveUserFuncCalls || usedByNonLDST ||
-        !hasConstantStore || !barrierInst || m_loadInsts.size() == 0 ) {
+        (!hasConstantStore && !forwardUniform) ||
+        !barrierInst || m_loadInsts.size() == 0 ) {
         return false;
     }
 
@@ -1190,14 +1361,23 @@ bool SLMConstProp::runOnFunction(Function& F)
     Module* M = m_F->getParent();
     m_DL = & M->getDataLayout();
 
+    bool changed = false;
+    if (forwardUniform) {
+        changed = forwardUniformStores();
+    }
+
+    if (!hasConstantStore || m_loadInsts.size() == 0) {
+        return changed;
+    }
+
     // Analyze the constant stores and see if they have a particular pattern
     if (!analyzeConstantStores()) {
-        return false;
+        return changed;
     }
 
     // Analyze the loads and apply const prop if available.
     if (!performConstProp()) {
-        return false;
+        return changed;
     }
 
 #if 0
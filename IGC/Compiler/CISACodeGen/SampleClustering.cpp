@@ -0,0 +1,174 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#include "common/LLVMUtils.h"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/IR/Instructions.h>
+#include <llvm/Pass.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include "Compiler/CISACodeGen/ShaderCodeGen.hpp"
+#include "Compiler/CISACodeGen/LivenessAnalysis.hpp"
+#include "Compiler/CISACodeGen/RegisterEstimator.hpp"
+#include "Compiler/IGCPassSupport.h"
+#include "Compiler/CISACodeGen/SampleClustering.h"
+#include "GenISAIntrinsics/GenIntrinsicInst.h"
+
+using namespace llvm;
+using namespace IGC;
+
+// Cluster independent sampler messages of a block so that they are issued
+// back to back and their results are consumed afterwards:
+//
+//   %a = sample ...                  %a = sample ...
+//   %x = fmul %a, ...                %b = sample ...
+//   %b = sample ...          ==>     %c = ld ...
+//   %y = fadd %x, %b                 %x = fmul %a, ...
+//   %c = ld ...                      %y = fadd %x, %b
+//
+// A message is moved up to the end of the current cluster only when none of
+// its operands is computed in between and nothing in between writes memory
+// or has side effects. Every hoisted result stays live across the code it
+// jumps over, so a cluster is closed once the estimated GRF pressure at its
+// start plus the hoisted results exceeds SampleClusteringRegPressureThreshold.
+
+namespace {
+
+class SampleClustering : public FunctionPass {
+  RegisterEstimator *RPE;
+  unsigned Threshold;
+
+public:
+  static char ID;
+
+  SampleClustering() : FunctionPass(ID), RPE(nullptr), Threshold(0) {
+    initializeSampleClusteringPass(*PassRegistry::getPassRegistry());
+  }
+
+  bool runOnFunction(Function &F) override;
+
+  StringRef getPassName() const override { return "Sample Clustering"; }
+
+private:
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.setPreservesCFG();
+    AU.addRequired<CodeGenContextWrapper>();
+    AU.addRequired<LivenessAnalysis>();
+    AU.addRequired<RegisterEstimator>();
+  }
+
+  bool clusterBlock(BasicBlock *BB);
+
+  static bool isSamplerMessage(const Instruction *I) {
+    return isa<SampleIntrinsic>(I) || isa<SamplerLoadIntrinsic>(I) ||
+           isa<SamplerGatherIntrinsic>(I);
+  }
+
+  // Check if I may be moved up to be right after Pos.
+  static bool canMoveAfter(Instruction *I, Instruction *Pos);
+};
+
+char SampleClustering::ID = 0;
+
+} // End anonymous namespace
+
+FunctionPass *IGC::createSampleClusteringPass() {
+  return new SampleClustering();
+}
+
+#define PASS_FLAG     "igc-sample-clustering"
+#define PASS_DESC     "Cluster independent sampler messages"
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS false
+namespace IGC {
+IGC_INITIALIZE_PASS_BEGIN(SampleClustering, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+IGC_INITIALIZE_PASS_DEPENDENCY(LivenessAnalysis)
+IGC_INITIALIZE_PASS_DEPENDENCY(RegisterEstimator)
+IGC_INITIALIZE_PASS_END(SampleClustering, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+} // End namespace IGC
+
+bool SampleClustering::runOnFunction(Function &F) {
+  RPE = &getAnalysis<RegisterEstimator>();
+  RPE->calculate(true);
+  Threshold = IGC_GET_FLAG_VALUE(SampleClusteringRegPressureThreshold);
+
+  bool Changed = false;
+  for (auto &BB : F)
+    Changed |= clusterBlock(&BB);
+
+  if (Changed) {
+    CodeGenContext *Ctx =
+        getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+    DumpLLVMIR(Ctx, "AfterSampleClustering");
+  }
+  return Changed;
+}
+
+bool SampleClustering::canMoveAfter(Instruction *I, Instruction *Pos) {
+  for (auto It = std::next(Pos->getIterator()); &*It != I; ++It) {
+    Instruction *J = &*It;
+    if (J->mayWriteToMemory() || J->mayHaveSideEffects())
+      return false;
+    // Operands defined before Pos are already available there.
+    for (Value *Op : I->operands())
+      if (Op == J)
+        return false;
+  }
+  return true;
+}
+
+bool SampleClustering::clusterBlock(BasicBlock *BB) {
+  SmallVector<Instruction *, 16> Messages;
+  for (auto &I : *BB)
+    if (isSamplerMessage(&I))
+      Messages.push_back(&I);
+  if (Messages.size() < 2)
+    return false;
+
+  bool Changed = false;
+  Instruction *ClusterEnd = Messages[0];
+  unsigned Pressure = RPE->getNumLiveGRFAtInst(ClusterEnd);
+  for (unsigned i = 1, e = Messages.size(); i != e; ++i) {
+    Instruction *I = Messages[i];
+    if (ClusterEnd->getNextNode() == I) {
+      ClusterEnd = I;
+      continue;
+    }
+    unsigned Extra = RPE->getNumGRFOfValue(I);
+    if (Pressure + Extra <= Threshold && canMoveAfter(I, ClusterEnd)) {
+      I->moveAfter(ClusterEnd);
+      ClusterEnd = I;
+      Pressure += Extra;
+      Changed = true;
+      continue;
+    }
+    // Start a new cluster from this message.
+    ClusterEnd = I;
+    Pressure = RPE->getNumLiveGRFAtInst(I);
+  }
+  return Changed;
+}
@@ -37,6 +37,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "Compiler/CISACodeGen/AdvCodeMotion.h"
 #include "Compiler/CISACodeGen/AdvMemOpt.h"
+#include "Compiler/CISACodeGen/BarrierElision.h"
 #include "Compiler/CISACodeGen/Emu64OpsPass.h"
 #include "Compiler/CISACodeGen/PullConstantHeuristics.hpp"
 #include "Compiler/CISACodeGen/PushAnalysis.hpp"
@@ -53,16 +54,21 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/CISACodeGen/GenIRLowering.h"
 #include "Compiler/CISACodeGen/GenSimplification.h"
 #include "Compiler/CISACodeGen/LoopDCE.h"
+#include "Compiler/CISACodeGen/LoopLoadPipelining.h"
+#include "Compiler/CISACodeGen/SampleClustering.h"
+#include "Compiler/CISACodeGen/SubGroupBlockAccess.h"
 #include "Compiler/CISACodeGen/LowerGSInterface.h"
 #include "Compiler/CISACodeGen/LdShrink.h"
 #include "Compiler/CISACodeGen/MemOpt.h"
 #include "Compiler/CISACodeGen/MemOpt2.h"
 #include "Compiler/CISACodeGen/PreRARematFlag.h"
 #include "Compiler/CISACodeGen/PreRAScheduler.hpp"
+#include "Compiler/CISACodeGen/ReleaseKernelIR.hpp"
 #include "Compiler/CISACodeGen/ResolveGAS.h"
 #include "Compiler/CISACodeGen/ResolvePredefinedConstant.h"
 #include "Compiler/CISACodeGen/Simd32Profitability.hpp"
 #include "Compiler/CISACodeGen/SimplifyConstant.h"
+#include "Compiler/CISACodeGen/SpillPredictor.hpp"
 #include "Compiler/CISACodeGen/TypeDemote.h"
 #include "Compiler/Optimizer/LinkMultiRateShaders.hpp"
 #include "Compiler/CISACodeGen/MergeURBWrites.hpp"
@@ -120,6 +126,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "common/LLVMWarningsPush.hpp"
 #include "llvm/ADT/PostOrderIterator.h"
+#include <llvm/ADT/SetVector.h>
+#include <llvm/IR/InstIterator.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Verifier.h>
 #include <llvm/Analysis/CFGPrinter.h>
@@ -138,6 +146,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/IRReader/IRReader.h>
 #include <llvm/Support/MathExtras.h>
 #include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/ThreadPool.h>
+#include <llvm/Support/Threading.h>
 #include <llvm/Support/ErrorHandling.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Transforms/IPO/FunctionAttrs.h>
@@ -251,6 +261,22 @@ inline void AddAnalysisPasses(CodeGenContext &ctx, const CShaderProgram::KernelS
     // Also need to understand the performance benefit better.
     mpm.add(new CodeSinking(true));
 
+    // Software-pipeline loads of innermost loops once code motion is done,
+    // so that nothing moves them back next to their uses.
+    if (ctx.m_instrTypes.hasLoop && !isOptDisabled &&
+        IGC_IS_FLAG_ENABLED(EnableLoopLoadPipelining))
+    {
+        mpm.add(createLoopLoadPipeliningPass());
+    }
+
+    // Cluster sampler messages after code sinking so they are not sunk back
+    // next to their uses.
+    if ((ctx.type == ShaderType::PIXEL_SHADER || ctx.type == ShaderType::COMPUTE_SHADER) &&
+        !isOptDisabled && IGC_IS_FLAG_ENABLED(EnableSampleClustering))
+    {
+        mpm.add(createSampleClusteringPass());
+    }
+
     if (ctx.type == ShaderType::PIXEL_SHADER)
         mpm.add(new PixelShaderAddMask());
 
@@ -275,6 +301,14 @@ inline void AddAnalysisPasses(CodeGenContext &ctx, const CShaderProgram::KernelS
     mpm.add(createExtractValuePairFixupPass());
 
     mpm.add(new Layout());
+
+    // Predict spills after the last IR change so that EmitPass can skip
+    // SIMD widths that are going to spill anyway.
+    if (ctx.type == ShaderType::OPENCL_SHADER &&
+        (IGC_IS_FLAG_ENABLED(EnableSpillPredictor) || IGC_IS_FLAG_ENABLED(LogSpillPrediction)))
+    {
+        mpm.add(new SpillPredictor());
+    }
 }
 
 static void UpdateInstTypeHint(CodeGenContext& ctx)
@@ -448,6 +482,9 @@ inline void AddLegalizationPasses(CodeGenContext &ctx, const CShaderProgram::Ker
     // Resolving private memory allocas
     mpm.add(CreatePrivateMemoryResolution());
 
+    if (!isOptDisabled && IGC_IS_FLAG_ENABLED(EnableBarrierElision))
+        mpm.add(createBarrierElisionPass());
+
     // Run MemOpt
     if (!isOptDisabled &&
         ctx.m_instrTypes.hasLoadStore && IGC_IS_FLAG_DISABLED(DisableMemOpt)) {
@@ -468,6 +505,17 @@ inline void AddLegalizationPasses(CodeGenContext &ctx, const CShaderProgram::Ker
         mpm.add(new StatelessToStatefull(hasBufOff));
     }
 
+    // Turn lane-consecutive accesses into sub-group block messages. Runs after
+    // the stateful promotion so that bounds-checked reads need no alignment.
+    if (!isOptDisabled &&
+        ctx.type == ShaderType::OPENCL_SHADER &&
+        ctx.m_instrTypes.hasLoadStore &&
+        IGC_IS_FLAG_ENABLED(EnableSubGroupBlockAccess))
+    {
+        mpm.add(createBreakCriticalEdgesPass());
+        mpm.add(createSubGroupBlockAccessPass());
+    }
+
     // Light cleanup for subroutines after cloning. Note that the constant
     // propogation order is reversed, compared to the opt sequence in
     // OptimizeIR. There is a substantial gain with CFG simplification after
@@ -519,6 +567,11 @@ inline void AddLegalizationPasses(CodeGenContext &ctx, const CShaderProgram::Ker
         mpm.add(createGVNPass());
         mpm.add(createDeadCodeEliminationPass());
     }
+    else if(ctx.platform.supportFP16() && IGC_IS_FLAG_ENABLED(EnableHalfMathPromotion))
+    {
+        mpm.add(new HalfPromotion(true));
+        mpm.add(createDeadCodeEliminationPass());
+    }
 
     // Run type demotion if it's beneficial.
     if (ctx.m_DriverInfo.benefitFromTypeDemotion() &&
@@ -863,11 +916,102 @@ void CodeGen(ContextType* ctx, CShaderProgram::KernelShaderMap &shaders)
 }
 
 
+// Run the vISA compiles that EmitPass left pending on a worker pool. The
+// results are then published in the same order as the sequential pipeline
+// (kernels in module order, SIMD32, SIMD16, SIMD8 within a kernel) and only
+// the widest variant that compiled is kept, which is what the sequential
+// pipeline produces by skipping narrower widths.
+static void CompileDeferredVISA(OpenCLProgramContext *ctx, CShaderProgram::KernelShaderMap &kernels)
+{
+    const SIMDMode simdModes[] = { SIMDMode::SIMD32, SIMDMode::SIMD16, SIMDMode::SIMD8 };
+
+    std::vector<CShader*> pending;
+    for (auto &k : kernels)
+    {
+        for (SIMDMode mode : simdModes)
+        {
+            CShader* shader = k.second->GetShader(mode);
+            if (shader && shader->GetEncoder().HasVISABuilder())
+            {
+                pending.push_back(shader);
+            }
+        }
+    }
+
+    COMPILER_TIME_START(ctx, TIME_CG_vISACompile);
+    {
+        unsigned numThreads = IGC_GET_FLAG_VALUE(ParallelSIMDCompileThreads);
+        if (numThreads == 0)
+        {
+            numThreads = llvm::heavyweight_hardware_concurrency();
+        }
+        llvm::ThreadPool pool(std::min<unsigned>(numThreads, pending.size()));
+        for (CShader* shader : pending)
+        {
+            pool.async([shader]() { shader->GetEncoder().CompileVISAOnWorkerThread(); });
+        }
+        pool.wait();
+    }
+    COMPILER_TIME_END(ctx, TIME_CG_vISACompile);
+
+    for (auto &k : kernels)
+    {
+        bool hasProgram = false;
+        for (SIMDMode mode : simdModes)
+        {
+            CShader* shader = k.second->GetShader(mode);
+            if (!shader || !shader->GetEncoder().HasVISABuilder())
+            {
+                continue;
+            }
+            CEncoder& encoder = shader->GetEncoder();
+            encoder.FinishCompile();
+            encoder.DestroyVISABuilder();
+
+            SProgramOutput* pOutput = shader->ProgramOutput();
+            if (pOutput->m_programSize == 0)
+            {
+                continue;
+            }
+            if (hasProgram)
+            {
+                // a wider SIMD variant of this kernel already compiled
+                pOutput->Destroy();
+                pOutput->m_programBin = nullptr;
+                pOutput->m_debugDataVISA = nullptr;
+                pOutput->m_debugDataGenISA = nullptr;
+                pOutput->m_programSize = 0;
+                continue;
+            }
+            hasProgram = true;
+            if (shader->HasStackCalls())
+            {
+                pOutput->m_scratchSpaceUsedBySpills =
+                    MAX(pOutput->m_scratchSpaceUsedBySpills, 32 * 1024);
+            }
+            shader->CheckMidThreadPreemption();
+        }
+    }
+}
+
 template<>
 void CodeGen(OpenCLProgramContext *ctx, CShaderProgram::KernelShaderMap &kernels)
 {
     COMPILER_TIME_START(ctx, TIME_CodeGen);
 
+    // Multiple SIMD mode needs the result of the narrower width before the
+    // wider one is attempted, so it always compiles sequentially.
+    ctx->m_deferVISACompile =
+        IGC_IS_FLAG_ENABLED(EnableParallelSIMDCompile) &&
+        !ctx->m_DriverInfo.sendMultipleSIMDModes() &&
+        ctx->getModuleMetaData()->csInfo.forcedSIMDSize == 0 &&
+        !ctx->m_instrTypes.hasDebugInfo;
+    // Kernels with a single candidate SIMD width can always be finalized
+    // concurrently with the rest of the program.
+    ctx->m_deferFixedSIMDVISACompile =
+        IGC_IS_FLAG_ENABLED(EnableParallelKernelCompile) &&
+        !ctx->m_instrTypes.hasDebugInfo;
+
     IGCPassManager Passes(ctx, "CG");
 
     AddLegalizationPasses(*ctx, kernels, Passes);
@@ -889,8 +1033,32 @@ void CodeGen(OpenCLProgramContext *ctx, CShaderProgram::KernelShaderMap &kernels
         AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD16, (ctx->getModuleMetaData()->csInfo.forcedSIMDSize != 16));
         AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD8, false);
     }
-    Passes.add(new DebugInfoPass(kernels));
-    Passes.run(*(ctx->getModule()));
+
+    // Deferred vISA compiles and debug info still need the IR after EmitPass.
+    if (IGC_IS_FLAG_ENABLED(EnableStreamingCodeGen) &&
+        !ctx->m_deferVISACompile &&
+        !ctx->m_deferFixedSIMDVISACompile &&
+        !ctx->m_instrTypes.hasDebugInfo)
+    {
+        Passes.add(new ReleaseKernelIRPass(kernels));
+    }
+
+    if (ctx->m_deferVISACompile || ctx->m_deferFixedSIMDVISACompile)
+    {
+        Passes.run(*(ctx->getModule()));
+        CompileDeferredVISA(ctx, kernels);
+        ctx->m_deferVISACompile = false;
+        ctx->m_deferFixedSIMDVISACompile = false;
+
+        IGCPassManager DIPass(ctx, "DI");
+        DIPass.add(new DebugInfoPass(kernels));
+        DIPass.run(*(ctx->getModule()));
+    }
+    else
+    {
+        Passes.add(new DebugInfoPass(kernels));
+        Passes.run(*(ctx->getModule()));
+    }
     COMPILER_TIME_END(ctx, TIME_CodeGen);
     DumpLLVMIR(ctx, "codegen");
 }
@@ -901,6 +1069,7 @@ void destroyShaderMap(CShaderProgram::KernelShaderMap &shaders)
     {
         CShaderProgram *shader = i.second;
         COMPILER_SHADER_STATS_PRINT(shader->m_shaderStats, shader->GetContext()->type, shader->GetContext()->hash, "");
+        COMPILER_SHADER_STATS_PRINT_JSONL(shader->m_shaderStats, shader->GetContext(), "");
         COMPILER_SHADER_STATS_SUM(shader->GetContext()->m_sumShaderStats, shader->m_shaderStats, shader->GetContext()->type);
         COMPILER_SHADER_STATS_DEL(shader->m_shaderStats);
         delete shader;
@@ -980,6 +1149,10 @@ void unify_opt_PreProcess(CodeGenContext* pContext)
     if (pContext->isPOSH())
     {
         mpm.add(createRemoveNonPositionOutputPass());
+        if (IGC_IS_FLAG_ENABLED(EnablePOSHPositionSlice))
+        {
+            mpm.add(createPositionOnlySlicePass());
+        }
     }
 
     mpm.run(*pContext->getModule());
@@ -1041,13 +1214,84 @@ static void purgeInlineAttribute(CodeGenContext *pContext, bool NoOpt)
     }
 }
 
+// On an OCL retry only the kernels in kernelSet are compiled again. Drop the
+// other kernels, and the subroutines that only they call, so that the passes
+// of the retry only visit functions whose code can still change.
+static void dropCompiledKernels(CodeGenContext *pContext)
+{
+    MetaDataUtils *pMdUtils = pContext->getMetaDataUtils();
+    ModuleMetaData *modMD = pContext->getModuleMetaData();
+    const auto &kernelSet = pContext->m_retryManager.kernelSet;
+
+    std::vector<Function*> worklist;
+    for (auto &F : pContext->getModule()->getFunctionList())
+    {
+        if (isEntryFunc(pMdUtils, &F) && !F.isDeclaration() && F.use_empty() &&
+            kernelSet.count(F.getName().str()) == 0)
+        {
+            worklist.push_back(&F);
+        }
+    }
+
+    bool changed = !worklist.empty();
+    while (!worklist.empty())
+    {
+        Function *F = worklist.back();
+        worklist.pop_back();
+
+        SmallSetVector<Function*, 8> callees;
+        for (auto &I : instructions(F))
+        {
+            if (CallInst *CI = dyn_cast<CallInst>(&I))
+            {
+                Function *Callee = CI->getCalledFunction();
+                if (Callee && Callee != F && !Callee->isDeclaration())
+                {
+                    callees.insert(Callee);
+                }
+            }
+        }
+
+        auto Iter = pMdUtils->findFunctionsInfoItem(F);
+        if (Iter != pMdUtils->end_FunctionsInfo())
+        {
+            pMdUtils->eraseFunctionsInfoItem(Iter);
+        }
+        modMD->FuncMD.erase(F);
+
+        F->eraseFromParent();
+
+        for (Function *Callee : callees)
+        {
+            if (Callee->use_empty() && !isEntryFunc(pMdUtils, Callee))
+            {
+                worklist.push_back(Callee);
+            }
+        }
+    }
+
+    if (changed)
+    {
+        pMdUtils->save(*pContext->getLLVMContext());
+    }
+}
+
 void OptimizeIR(CodeGenContext* pContext)
 {
     MetaDataUtils *pMdUtils = pContext->getMetaDataUtils();
     bool NoOpt = pContext->getModuleMetaData()->compOpt.OptDisable;
+    // The fast compile tier skips the loop, GVN and jump threading passes.
+    bool FastCompile = pContext->getModuleMetaData()->compOpt.FastCompile;
     pContext->m_highPsRegisterPressure = (pContext->type == ShaderType::PIXEL_SHADER && 
                                           ((pContext->m_inputCount + pContext->m_ConstantBufferCount/8 + pContext->m_tempCount) > 60));
 
+    if (pContext->type == ShaderType::OPENCL_SHADER &&
+        !pContext->m_retryManager.kernelSet.empty() &&
+        IGC_IS_FLAG_ENABLED(EnableRetryKernelPruning))
+    {
+        dropCompiledKernels(pContext);
+    }
+
     // Remove inline attribute if subroutine is enabled.
     purgeInlineAttribute(pContext, NoOpt);
     if (NoOpt)
@@ -1171,7 +1415,7 @@ void OptimizeIR(CodeGenContext* pContext)
         if(pContext->m_instrTypes.hasMultipleBB)
         {
             // disable loop unroll for excessive large shaders
-            if(pContext->m_instrTypes.hasLoop)
+            if(pContext->m_instrTypes.hasLoop && !FastCompile)
             {
                 mpm.add(createLoopDeadCodeEliminationPass());
                 mpm.add(createLoopCanonicalization());
@@ -1197,6 +1441,13 @@ void OptimizeIR(CodeGenContext* pContext)
                     mpm.add(new CustomLoopVersioning());
                 }
 
+                if(IGC_IS_FLAG_ENABLED(EnableOpenCLLoopVersioning) &&
+                    pContext->type == ShaderType::OPENCL_SHADER &&
+                    pContext->m_retryManager.AllowUnroll())
+                {
+                    mpm.add(createOpenCLLoopVersioningPass());
+                }
+
                 mpm.add(createIGCInstructionCombiningPass());
                 if(IGC_IS_FLAG_ENABLED(EnableAdvCodeMotion) &&
                     pContext->type == ShaderType::OPENCL_SHADER &&
@@ -1250,7 +1501,7 @@ void OptimizeIR(CodeGenContext* pContext)
                 mpm.add(createReassociatePass());
             }
 
-            if(IGC_IS_FLAG_ENABLED(EnableGVN))
+            if(IGC_IS_FLAG_ENABLED(EnableGVN) && !FastCompile)
             {
                 mpm.add(llvm::createGVNPass());
             }
@@ -1272,7 +1523,7 @@ void OptimizeIR(CodeGenContext* pContext)
 
             mpm.add(new GenUpdateCB());
 
-            if(!pContext->m_instrTypes.hasAtomics)
+            if(!pContext->m_instrTypes.hasAtomics && !FastCompile)
             {
                 // jump threading currently causes the atomic_flag test from c11 conformance to fail.  Right now,
                 // only do jump threading if we don't have atomics as using atomics as locks seems to be the most common
@@ -1346,6 +1597,16 @@ void OptimizeIR(CodeGenContext* pContext)
             {
                 mpm.add(createEstimateFunctionSizePass(EstimateFunctionSize::AL_Kernel));
                 mpm.add(createSubroutineInlinerPass());
+
+                // Inline the early-exit prefix of the remaining subroutines and keep
+                // their cold bodies as outlined subroutines.
+                if (IGC_IS_FLAG_ENABLED(EnablePartialInlining))
+                {
+                    mpm.add(createPartialInliningPass());
+                    mpm.add(createOutlinedSubroutineMetaDataPass());
+                    mpm.add(createAlwaysInlinerLegacyPass());
+                    mpm.add(createGlobalDCEPass());
+                }
             }
             else
             {
@@ -84,12 +84,19 @@ public:
     CShader(llvm::Function*, CShaderProgram* pProgram);
     virtual ~CShader();
     void        Destroy();
+    void        ReleaseCodeGenState();
     virtual void InitEncoder(SIMDMode simdMode, bool canAbortOnSpill, ShaderDispatchMode shaderMode = ShaderDispatchMode::NOT_APPLICABLE);
     virtual void PreCompile() {}
     virtual void ParseShaderSpecificOpcode(llvm::Instruction* inst) {}
+    // Takes the ParseShaderSpecificOpcode() results of another SIMD variant
+    // of the same program instead of scanning the IR again. Returns false if
+    // the shader type does not support it.
+    virtual bool CopyShaderSpecificOpcodeInfo(CShader* pSibling) { return false; }
     virtual void AllocatePayload() {}
     virtual void AddPrologue() {}
     void PreAnalysisPass();
+    void CheckMidThreadPreemption();
+    bool HasStackCalls();
     virtual void ExtractGlobalVariables() {}
     void         EmitEOTURBWrite();
     void         EOTRenderTarget();
@@ -108,6 +115,7 @@ public:
     virtual QuadEltUnit GetFinalGlobalOffet(QuadEltUnit globalOffset) { return QuadEltUnit(0); }
     virtual bool hasReadWriteImage(llvm::Function &F) { return false; }
     virtual bool CompileSIMDSize(SIMDMode simdMode, EmitPass &EP, llvm::Function &F) { return true; }
+    virtual bool HasFixedSIMDSize(llvm::Function &F) { return false; }
     CVariable*  LazyCreateCCTupleBackingVariable(
         CoalescingEngine::CCTuple* ccTuple,
         VISA_Type baseType = ISA_TYPE_UD);
@@ -251,6 +259,10 @@ public:
     uint m_staticCycle;
     unsigned m_spillSize = 0;
     float m_spillCost = 0;          // num weighted spill inst / total inst
+    // Spill prediction made before emitting vISA (-1 if none was made) and
+    // the GRF estimate it was based on. Used by LogSpillPrediction.
+    int m_spillPrediction = -1;
+    uint32_t m_spillPredictionGRF = 0;
 
 	std::vector<llvm::Value*> m_argListCache;
 
@@ -468,6 +480,8 @@ protected:
 
     bool m_HasGlobalAtomics = false;
 
+    // Set once ParseShaderSpecificOpcode() results are available.
+    bool m_ParsedShaderSpecificOpcodes = false;
 
 };
 
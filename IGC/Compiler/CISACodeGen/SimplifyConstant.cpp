@@ -257,10 +257,12 @@ FunctionPass *IGC::createPromoteConstantPass() { return new PromoteConstant(); }
 // Check uses. Within this function, this GV must be used and only used by
 // in-bound GEPs each of which is also only used by loads.
 //
-// We only promote when there is load of GV inside loops.
+// We only promote when there is load of GV inside loops, or at least
+// ConstantPromotionMinLoads loads of it when that is set.
 //
 static bool checkUses(GlobalVariable *GV, const Function *F, LoopInfo &LI) {
   bool LoadInLoop = false;
+  unsigned NumLoads = 0;
   for (auto U : GV->users()) {
     auto Inst = dyn_cast<Instruction>(U);
     if (!Inst)
@@ -280,10 +282,12 @@ static bool checkUses(GlobalVariable *GV, const Function *F, LoopInfo &LI) {
         return false;
       if (LI.getLoopFor(Inst->getParent()) != nullptr)
         LoadInLoop = true;
+      ++NumLoads;
     }
   }
 
-  return LoadInLoop;
+  unsigned MinLoads = IGC_GET_FLAG_VALUE(ConstantPromotionMinLoads);
+  return LoadInLoop || (MinLoads != 0 && NumLoads >= MinLoads);
 }
 
 // IGC only allows the following vector sizes:
@@ -0,0 +1,134 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#include "Compiler/CISACodeGen/SpillPredictor.hpp"
+#include "Compiler/CISACodeGen/helper.h"
+#include "Compiler/IGCPassSupport.h"
+#include "common/igc_regkeys.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/IR/InstIterator.h>
+#include "common/LLVMWarningsPop.hpp"
+
+using namespace llvm;
+using namespace IGC;
+
+// Register pass to igc-opt
+#define PASS_FLAG "spill-predictor"
+#define PASS_DESCRIPTION "Predict spills of a kernel per SIMD width"
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS true
+IGC_INITIALIZE_PASS_BEGIN(SpillPredictor, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_DEPENDENCY(RegisterEstimator)
+IGC_INITIALIZE_PASS_DEPENDENCY(WIAnalysis)
+IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+IGC_INITIALIZE_PASS_END(SpillPredictor, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+
+char SpillPredictor::ID = 0;
+
+static unsigned simdIndex(SIMDMode simdMode)
+{
+    switch (simdMode)
+    {
+    case SIMDMode::SIMD8:   return 0;
+    case SIMDMode::SIMD16:  return 1;
+    case SIMDMode::SIMD32:  return 2;
+    default:
+        assert(false && "Unexpected SIMD mode");
+        return 0;
+    }
+}
+
+SpillPredictor::SpillPredictor() :
+    FunctionPass(ID), m_sendDensity(0), m_GRFLimit(0)
+{
+    memset(m_maxLiveGRF, 0, sizeof(m_maxLiveGRF));
+    memset(m_payloadGRF, 0, sizeof(m_payloadGRF));
+    initializeSpillPredictorPass(*PassRegistry::getPassRegistry());
+}
+
+bool SpillPredictor::runOnFunction(Function &F)
+{
+    CodeGenContext *pCtx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+    RegisterEstimator &RPE = getAnalysis<RegisterEstimator>();
+    WIAnalysis &WI = getAnalysis<WIAnalysis>();
+    const DataLayout &DL = F.getParent()->getDataLayout();
+
+    m_GRFLimit = pCtx->getNumGRFPerThread() * IGC_GET_FLAG_VALUE(SpillPredictorThreshold) / 100;
+
+    const uint16_t simdSizes[] = { 8, 16, 32 };
+
+    memset(m_maxLiveGRF, 0, sizeof(m_maxLiveGRF));
+    if (!RPE.hasNoGRFPressure())
+    {
+        RPE.calculate();
+        for (auto &BB : F)
+        {
+            for (unsigned i = 0; i < 3; ++i)
+            {
+                m_maxLiveGRF[i] = std::max(m_maxLiveGRF[i], RPE.getMaxLiveGRFAtBB(&BB, simdSizes[i]));
+            }
+        }
+    }
+
+    // Arguments (explicit and implicit) are delivered in the payload: uniform
+    // ones once, the others once per lane. r0 is always there.
+    uint64_t uniformBytes = 0;
+    uint64_t perLaneBytes = 0;
+    for (auto &Arg : F.args())
+    {
+        if (!Arg.getType()->isSized())
+            continue;
+        uint64_t bytes = DL.getTypeAllocSize(Arg.getType());
+        if (WI.whichDepend(&Arg) == WIAnalysis::UNIFORM)
+            uniformBytes += bytes;
+        else
+            perLaneBytes += bytes;
+    }
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        uint64_t bytes = uniformBytes + perLaneBytes * simdSizes[i];
+        m_payloadGRF[i] = 1 + (uint32_t)((bytes + SIZE_GRF - 1) / SIZE_GRF);
+    }
+
+    uint32_t numInsts = 0;
+    uint32_t numSends = 0;
+    for (auto &I : instructions(F))
+    {
+        ++numInsts;
+        if (I.mayReadOrWriteMemory())
+            ++numSends;
+    }
+    m_sendDensity = numInsts ? numSends * 100 / numInsts : 0;
+
+    return false;
+}
+
+uint32_t SpillPredictor::getEstimatedGRF(SIMDMode simdMode) const
+{
+    unsigned i = simdIndex(simdMode);
+    uint32_t estimate = m_maxLiveGRF[i] + m_payloadGRF[i];
+    return estimate * (100 + m_sendDensity * IGC_GET_FLAG_VALUE(SpillPredictorSendWeight) / 100) / 100;
+}
@@ -0,0 +1,90 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#pragma once
+
+#include "Compiler/CodeGenPublic.h"
+#include "Compiler/CodeGenContextWrapper.hpp"
+#include "Compiler/CISACodeGen/RegisterEstimator.hpp"
+#include "Compiler/CISACodeGen/WIAnalysis.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Pass.h>
+#include "common/LLVMWarningsPop.hpp"
+
+namespace IGC
+{
+    /// @brief  Predicts whether a kernel spills at a given SIMD width before any
+    ///         vISA is emitted for it, so that doomed SIMD32/SIMD16 attempts can
+    ///         be skipped.
+    ///
+    /// The estimate is the maximum number of live GRFs from RegisterEstimator
+    /// plus the thread payload, inflated by the density of send instructions
+    /// (each send needs contiguous payload registers, which fragments the
+    /// register file). A spill is predicted when the estimate goes above
+    /// SpillPredictorThreshold percent of the GRFs of a thread. The weights
+    /// are regkeys so they can be tuned with LogSpillPrediction.
+    class SpillPredictor : public llvm::FunctionPass
+    {
+    public:
+        static char ID;
+
+        SpillPredictor();
+
+        virtual llvm::StringRef getPassName() const override
+        {
+            return "SpillPredictor";
+        }
+
+        virtual bool runOnFunction(llvm::Function &F) override;
+
+        virtual void getAnalysisUsage(llvm::AnalysisUsage &AU) const override
+        {
+            AU.setPreservesAll();
+            AU.addRequired<RegisterEstimator>();
+            AU.addRequired<WIAnalysis>();
+            AU.addRequired<CodeGenContextWrapper>();
+        }
+
+        /// Estimated number of GRFs the kernel needs at this SIMD width.
+        uint32_t getEstimatedGRF(SIMDMode simdMode) const;
+        /// The estimate above which a spill is predicted.
+        uint32_t getGRFLimit() const { return m_GRFLimit; }
+
+        bool isSpillPredicted(SIMDMode simdMode) const
+        {
+            return getEstimatedGRF(simdMode) > m_GRFLimit;
+        }
+
+    private:
+        // Indexed by SIMD8, SIMD16, SIMD32
+        uint32_t m_maxLiveGRF[3];
+        uint32_t m_payloadGRF[3];
+        // Send instructions per 100 instructions
+        uint32_t m_sendDensity;
+        uint32_t m_GRFLimit;
+    };
+
+} // namespace IGC
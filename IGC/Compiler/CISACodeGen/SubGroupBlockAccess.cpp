@@ -0,0 +1,336 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/Pass.h>
+#include <llvm/Transforms/Utils/Local.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include "Compiler/CISACodeGen/ShaderCodeGen.hpp"
+#include "Compiler/CISACodeGen/WIAnalysis.hpp"
+#include "Compiler/CISACodeGen/helper.h"
+#include "Compiler/MetaDataApi/IGCMetaDataHelper.h"
+#include "Compiler/MetaDataUtilsWrapper.h"
+#include "Compiler/Optimizer/OpenCLPasses/AlignmentAnalysis/AlignmentAnalysis.hpp"
+#include "Compiler/IGCPassSupport.h"
+#include "Compiler/CISACodeGen/SubGroupBlockAccess.h"
+#include "GenISAIntrinsics/GenIntrinsicInst.h"
+
+using namespace llvm;
+using namespace IGC;
+using namespace IGC::IGCMD;
+
+// Rewrite lane-consecutive scalar accesses into sub-group block messages:
+//
+//   %lid = call i16 @llvm.genx.GenISA.simdLaneId()
+//   %e   = zext i16 %lid to i32
+//   %i   = add i32 %base, %e                ; %base uniform
+//   %p   = getelementptr i32, i32 addrspace(1)* %buf, i32 %i
+//   %v   = load i32, i32 addrspace(1)* %p
+// ==>
+//   %q   = getelementptr i32, i32 addrspace(1)* %buf, i32 %base
+//   %v   = call i32 @llvm.genx.GenISA.simdBlockRead(i32 addrspace(1)* %q)
+//
+// Block messages move every lane of the sub-group regardless of the
+// execution mask, so an access is only rewritten when the extra lanes are
+// harmless:
+//  - stateful reads are bounds-checked by the surface and use the unaligned
+//    OWord block read, so they are always safe;
+//  - any other access needs an OWord-aligned block address (proven by
+//    AlignmentAnalysis), must not be under divergent control flow, and the
+//    kernel must have a required work-group size that fills every sub-group
+//    at any SIMD width.
+
+namespace {
+
+// Largest SIMD width a kernel may be compiled to.
+const unsigned MAX_SUB_GROUP_SIZE = 32;
+
+// Block address alignment required by OWord block messages.
+const unsigned BLOCK_MSG_ALIGNMENT = 16;
+
+class SubGroupBlockAccess : public FunctionPass {
+  const DataLayout *DL;
+  CodeGenContext *Ctx;
+  WIAnalysis *WI;
+  AlignmentAnalysis *AA;
+  bool HasFullSubGroups;
+
+public:
+  static char ID;
+
+  SubGroupBlockAccess()
+      : FunctionPass(ID), DL(nullptr), Ctx(nullptr), WI(nullptr), AA(nullptr),
+        HasFullSubGroups(false) {
+    initializeSubGroupBlockAccessPass(*PassRegistry::getPassRegistry());
+  }
+
+  bool runOnFunction(Function &F) override;
+
+  StringRef getPassName() const override { return "SubGroupBlockAccess"; }
+
+private:
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.setPreservesCFG();
+    // AlignmentAnalysis does not preserve WIAnalysis, so it has to be
+    // scheduled first.
+    AU.addRequired<AlignmentAnalysis>();
+    AU.addRequired<WIAnalysis>();
+    AU.addRequired<MetaDataUtilsWrapper>();
+    AU.addRequired<CodeGenContextWrapper>();
+  }
+
+  // The lane-consecutive address of a candidate access, split into the
+  // uniform block address parts.
+  struct BlockAddress {
+    Value *Base;          // uniform pointer the lane index is applied to
+    Value *Offset;        // uniform element offset, or null
+    Instruction::CastOps OffsetExt; // extension of Offset to the GEP index type
+    Type *IdxTy;
+  };
+
+  bool isLaneId(Value *V) const;
+  bool isUniform(Value *V) const {
+    return WI->whichDepend(V) == WIAnalysis::UNIFORM;
+  }
+  bool getBlockAddress(Value *Ptr, Type *AccessTy, BlockAddress &BA) const;
+  bool isLegal(Instruction *I, Value *Ptr, const BlockAddress &BA,
+               unsigned EltSize) const;
+  bool isSupportedType(Type *Ty) const;
+  Value *buildBlockPtr(IRBuilder<> &IRB, const BlockAddress &BA,
+                       Type *AccessTy, unsigned AS) const;
+  void rewriteLoad(LoadInst *LI, const BlockAddress &BA);
+  void rewriteStore(StoreInst *SI, const BlockAddress &BA);
+};
+
+char SubGroupBlockAccess::ID = 0;
+
+} // End anonymous namespace
+
+FunctionPass *IGC::createSubGroupBlockAccessPass() {
+  return new SubGroupBlockAccess();
+}
+
+#define PASS_FLAG     "igc-subgroup-block-access"
+#define PASS_DESC     "Use sub-group block messages for lane-consecutive accesses"
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS false
+namespace IGC {
+IGC_INITIALIZE_PASS_BEGIN(SubGroupBlockAccess, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_DEPENDENCY(AlignmentAnalysis)
+IGC_INITIALIZE_PASS_DEPENDENCY(WIAnalysis)
+IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
+IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+IGC_INITIALIZE_PASS_END(SubGroupBlockAccess, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+} // End namespace IGC
+
+bool SubGroupBlockAccess::runOnFunction(Function &F) {
+  Ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+  if (Ctx->type != ShaderType::OPENCL_SHADER)
+    return false;
+
+  DL = &F.getParent()->getDataLayout();
+  AA = &getAnalysis<AlignmentAnalysis>();
+  WI = &getAnalysis<WIAnalysis>();
+
+  MetaDataUtils *MDUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+  HasFullSubGroups = false;
+  if (MDUtils->findFunctionsInfoItem(&F) != MDUtils->end_FunctionsInfo()) {
+    uint32_t GroupSize = IGCMetaDataHelper::getThreadGroupSize(*MDUtils, &F);
+    HasFullSubGroups = GroupSize != 0 && GroupSize % MAX_SUB_GROUP_SIZE == 0;
+  }
+
+  SmallVector<std::pair<Instruction *, BlockAddress>, 16> Candidates;
+  for (auto II = inst_begin(F), IE = inst_end(F); II != IE; ++II) {
+    Instruction *I = &*II;
+    BlockAddress BA;
+    if (auto LI = dyn_cast<LoadInst>(I)) {
+      if (!LI->isSimple() || !isSupportedType(LI->getType()))
+        continue;
+      Value *Ptr = LI->getPointerOperand();
+      if (!getBlockAddress(Ptr, LI->getType(), BA) ||
+          !isLegal(LI, Ptr, BA, unsigned(DL->getTypeStoreSize(LI->getType()))))
+        continue;
+      Candidates.push_back(std::make_pair(I, BA));
+    } else if (auto SI = dyn_cast<StoreInst>(I)) {
+      Type *Ty = SI->getValueOperand()->getType();
+      if (!SI->isSimple() || !isSupportedType(Ty))
+        continue;
+      Value *Ptr = SI->getPointerOperand();
+      if (!getBlockAddress(Ptr, Ty, BA) ||
+          !isLegal(SI, Ptr, BA, unsigned(DL->getTypeStoreSize(Ty))))
+        continue;
+      Candidates.push_back(std::make_pair(I, BA));
+    }
+  }
+
+  for (auto &C : Candidates) {
+    Instruction *I = C.first;
+    Value *Ptr = nullptr;
+    if (auto LI = dyn_cast<LoadInst>(I)) {
+      Ptr = LI->getPointerOperand();
+      rewriteLoad(LI, C.second);
+    } else {
+      Ptr = cast<StoreInst>(I)->getPointerOperand();
+      rewriteStore(cast<StoreInst>(I), C.second);
+    }
+    RecursivelyDeleteTriviallyDeadInstructions(Ptr);
+  }
+
+  return !Candidates.empty();
+}
+
+bool SubGroupBlockAccess::isSupportedType(Type *Ty) const {
+  if (!Ty->isIntegerTy() && !Ty->isFloatingPointTy())
+    return false;
+  unsigned Bits = Ty->getPrimitiveSizeInBits();
+  return Bits == 16 || Bits == 32 || Bits == 64;
+}
+
+bool SubGroupBlockAccess::isLaneId(Value *V) const {
+  if (isa<ZExtInst>(V) || isa<SExtInst>(V))
+    V = cast<CastInst>(V)->getOperand(0);
+  auto GII = dyn_cast<GenIntrinsicInst>(V);
+  return GII && GII->getIntrinsicID() == GenISAIntrinsic::GenISA_simdLaneId;
+}
+
+bool SubGroupBlockAccess::getBlockAddress(Value *Ptr, Type *AccessTy,
+                                          BlockAddress &BA) const {
+  auto GEP = dyn_cast<GetElementPtrInst>(Ptr);
+  if (!GEP || GEP->getNumIndices() != 1)
+    return false;
+  // One lane step has to be exactly one element.
+  if (DL->getTypeAllocSize(GEP->getResultElementType()) !=
+      DL->getTypeStoreSize(AccessTy))
+    return false;
+
+  BA.Base = GEP->getPointerOperand();
+  BA.Offset = nullptr;
+  BA.OffsetExt = Instruction::CastOpsEnd;
+  Value *Idx = GEP->getOperand(1);
+  BA.IdxTy = Idx->getType();
+  if (!isUniform(BA.Base))
+    return false;
+  if (isLaneId(Idx))
+    return true;
+
+  // The extension can only be pushed onto the uniform operand if the add
+  // cannot wrap in the narrow type.
+  Value *Inner = Idx;
+  if (auto SE = dyn_cast<SExtInst>(Idx)) {
+    Inner = SE->getOperand(0);
+    BA.OffsetExt = Instruction::SExt;
+  } else if (auto ZE = dyn_cast<ZExtInst>(Idx)) {
+    Inner = ZE->getOperand(0);
+    BA.OffsetExt = Instruction::ZExt;
+  }
+  auto Add = dyn_cast<BinaryOperator>(Inner);
+  if (!Add || Add->getOpcode() != Instruction::Add)
+    return false;
+  if ((BA.OffsetExt == Instruction::SExt && !Add->hasNoSignedWrap()) ||
+      (BA.OffsetExt == Instruction::ZExt && !Add->hasNoUnsignedWrap()))
+    return false;
+
+  for (unsigned i = 0; i < 2; ++i) {
+    Value *Lane = Add->getOperand(i);
+    Value *Other = Add->getOperand(1 - i);
+    if (isLaneId(Lane) && isUniform(Other)) {
+      BA.Offset = Other;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool SubGroupBlockAccess::isLegal(Instruction *I, Value *Ptr,
+                                  const BlockAddress &BA,
+                                  unsigned EltSize) const {
+  unsigned AS = Ptr->getType()->getPointerAddressSpace();
+  if (AS == ADDRESS_SPACE_PRIVATE || AS == ADDRESS_SPACE_LOCAL ||
+      AS == ADDRESS_SPACE_GENERIC || AS == ADDRESS_SPACE_GLOBAL_OR_PRIVATE)
+    return false;
+
+  // Block messages are NoMask and write every lane of their destination,
+  // so they are only safe when all lanes are active.
+  if (!HasFullSubGroups || WI->insideDivergentCF(I))
+    return false;
+
+  if (isa<LoadInst>(I) && AS >= ADDRESS_SPACE_NUM_ADDRESSES) {
+    bool DirectIdx = false;
+    unsigned BufId = 0;
+    if (DecodeAS4GFXResource(AS, DirectIdx, BufId) == UAV)
+      return true;
+  }
+
+  uint64_t Align = AA->getAlignment(BA.Base);
+  if (BA.Offset)
+    Align = std::min<uint64_t>(Align, uint64_t(AA->getAlignment(BA.Offset)) * EltSize);
+  return Align >= BLOCK_MSG_ALIGNMENT;
+}
+
+Value *SubGroupBlockAccess::buildBlockPtr(IRBuilder<> &IRB,
+                                          const BlockAddress &BA,
+                                          Type *AccessTy, unsigned AS) const {
+  Value *Ptr = BA.Base;
+  if (BA.Offset) {
+    Value *Offset = BA.Offset;
+    if (BA.OffsetExt != Instruction::CastOpsEnd)
+      Offset = IRB.CreateCast(BA.OffsetExt, Offset, BA.IdxTy);
+    Ptr = IRB.CreateGEP(Ptr, Offset);
+  }
+  // The block intrinsics take an integer pointer of the element width.
+  Type *IntPtrTy = IRB.getIntNTy(AccessTy->getPrimitiveSizeInBits())->getPointerTo(AS);
+  return IRB.CreateBitCast(Ptr, IntPtrTy);
+}
+
+void SubGroupBlockAccess::rewriteLoad(LoadInst *LI, const BlockAddress &BA) {
+  IRBuilder<> IRB(LI);
+  unsigned AS = LI->getPointerAddressSpace();
+  Value *Ptr = buildBlockPtr(IRB, BA, LI->getType(), AS);
+  Type *Tys[] = { LI->getType(), Ptr->getType() };
+  Function *BlockRead = GenISAIntrinsic::getDeclaration(
+      LI->getModule(), GenISAIntrinsic::GenISA_simdBlockRead, Tys);
+  Value *V = IRB.CreateCall(BlockRead, Ptr);
+  V->takeName(LI);
+  LI->replaceAllUsesWith(V);
+  LI->eraseFromParent();
+}
+
+void SubGroupBlockAccess::rewriteStore(StoreInst *SI, const BlockAddress &BA) {
+  IRBuilder<> IRB(SI);
+  unsigned AS = SI->getPointerAddressSpace();
+  Value *Val = SI->getValueOperand();
+  Value *Ptr = buildBlockPtr(IRB, BA, Val->getType(), AS);
+  Type *Tys[] = { Ptr->getType(), Val->getType() };
+  Function *BlockWrite = GenISAIntrinsic::getDeclaration(
+      SI->getModule(), GenISAIntrinsic::GenISA_simdBlockWrite, Tys);
+  Value *Args[] = { Ptr, Val };
+  IRB.CreateCall(BlockWrite, Args);
+  SI->eraseFromParent();
+}
@@ -34,11 +34,14 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/ADT/PostOrderIterator.h>
+#include <llvm/Analysis/ValueTracking.h>
 #include <llvm/IR/IRBuilder.h>
+#include <llvm/Support/KnownBits.h>
 #include <llvm/Pass.h>
 #include "common/LLVMWarningsPop.hpp"
 
 #include "GenISAIntrinsics/GenIntrinsics.h"
+#include "common/igc_regkeys.hpp"
 
 using namespace llvm;
 using namespace IGC;
@@ -69,6 +72,9 @@ namespace {
     bool demoteOnBasicBlock(BasicBlock *) const;
 
     Value *getDemotedValue(Value *V, Type *DemotedTy, bool Unsigned) const;
+
+    bool demoteByRange(Function *) const;
+    Value *getNarrowedOperand(Value *V, IntegerType *NarrowTy) const;
   };
 
 } // End anonymous namespace
@@ -99,9 +105,92 @@ bool TypeDemote::runOnFunction(Function &F) {
     Changed |= LocalChanged;
   } while (LocalChanged);
 
+  if (IGC_IS_FLAG_ENABLED(EnableRangeTypeDemotion))
+    Changed |= demoteByRange(&F);
+
   return Changed;
 }
 
+/// Narrow i32 arithmetic to i16 and i64 to i32 when known bits prove the
+/// result fits the narrow type as an unsigned value. The low bits of add,
+/// sub, mul and bitwise operations only depend on the low bits of their
+/// operands, so computing them narrow and zero extending back is exact.
+/// Operands are only taken when they are narrow for free, i.e. constants or
+/// zero extensions, so that chains such as loop counters, tile indices or
+/// unpacked bytes narrow together without adding truncations.
+bool TypeDemote::demoteByRange(Function *F) const {
+  const DataLayout &DL = F->getParent()->getDataLayout();
+  bool Changed = false;
+
+  ReversePostOrderTraversal<Function *> RPOT(F);
+  for (auto &BB : RPOT) {
+    for (auto BI = BB->begin(), BE = BB->end(); BI != BE; /* EMPTY */) {
+      BinaryOperator *BO = dyn_cast<BinaryOperator>(&*BI++);
+      if (!BO)
+        continue;
+      switch (BO->getOpcode()) {
+      default:
+        continue;
+      case Instruction::Add:
+      case Instruction::Sub:
+      case Instruction::Mul:
+      case Instruction::And:
+      case Instruction::Or:
+      case Instruction::Xor:
+        break;
+      }
+      IntegerType *OriginTy = dyn_cast<IntegerType>(BO->getType());
+      if (!OriginTy)
+        continue;
+      unsigned Width = OriginTy->getBitWidth();
+      if (Width != 32 && Width != 64)
+        continue;
+      IntegerType *NarrowTy = IRB->getIntNTy(Width / 2);
+
+      KnownBits Known = computeKnownBits(BO, DL);
+      if (Known.countMinLeadingZeros() < Width / 2)
+        continue;
+
+      BuilderType::InsertPointGuard Guard(*IRB);
+      IRB->SetInsertPoint(BO);
+      Value *LHS = getNarrowedOperand(BO->getOperand(0), NarrowTy);
+      if (!LHS)
+        continue;
+      Value *RHS = getNarrowedOperand(BO->getOperand(1), NarrowTy);
+      if (!RHS)
+        continue;
+
+      Value *Narrow = IRB->CreateBinOp(BO->getOpcode(), LHS, RHS, BO->getName() + ".narrow");
+      Value *V = IRB->CreateZExt(Narrow, OriginTy, ".demoted.zext");
+      BO->replaceAllUsesWith(V);
+      BO->eraseFromParent();
+      Changed = true;
+    }
+  }
+
+  return Changed;
+}
+
+Value *TypeDemote::getNarrowedOperand(Value *V, IntegerType *NarrowTy) const {
+  if (ConstantInt *CI = dyn_cast<ConstantInt>(V)) {
+    if (!CI->getValue().isIntN(NarrowTy->getBitWidth()))
+      return nullptr;
+    return IRB->CreateTrunc(V, NarrowTy);
+  }
+
+  if (ZExtInst *ZEI = dyn_cast<ZExtInst>(V)) {
+    Value *Src = ZEI->getOperand(0);
+    unsigned SrcWidth = Src->getType()->getIntegerBitWidth();
+    if (SrcWidth > NarrowTy->getBitWidth())
+      return nullptr;
+    if (SrcWidth == NarrowTy->getBitWidth())
+      return Src;
+    return IRB->CreateZExt(Src, NarrowTy);
+  }
+
+  return nullptr;
+}
+
 bool TypeDemote::demoteOnFunction(Function *F) const {
   bool Changed = false;
 
@@ -188,10 +188,18 @@ bool VariableReuseAnalysis::checkDefInst(Instruction *DefInst,
     }
   }
 
-  // This is a block level reuse.
+  // This is a block level reuse, unless the def reaches the use from
+  // another block and dies there (see isCrossBlockReuseLegal).
   BasicBlock *CurBB = UseInst->getParent();
-  if (DefInst->getParent() != CurBB || DefInst->isUsedOutsideOfBlock(CurBB))
-    return false;
+  if (DefInst->getParent() != CurBB || DefInst->isUsedOutsideOfBlock(CurBB)) {
+    if (!isCrossBlockReuseLegal(DefInst, UseInst, LV))
+      return false;
+
+    // Sharing storage cannot lengthen the def's live range here, as the
+    // def is live up to this use anyway; no distance check.
+    Instruction *LastUse = LV->getLVInfo(DefInst).findKill(CurBB);
+    return LastUse == UseInst;
+  }
 
   // Check whether UseInst is the last use of DefInst. If not, this source
   // variable cannot be reused.
@@ -210,6 +218,38 @@ bool VariableReuseAnalysis::checkDefInst(Instruction *DefInst,
   return UseLoc <= DefLoc + FarDefDistance;
 }
 
+// Let DInst be defined in some other block than UInst (or used outside of
+// UInst's block). Reusing DInst's storage for UInst is legal if
+//   - DInst dies in UInst's block (not live-out), so no later path, including
+//     a loop back edge, reads it after UInst has overwritten it;
+//   - DInst is its own congruent class, so no phi shares its storage; and
+//   - DInst is not uniform. Non-uniform writes are predicated on the
+//     execution mask, hence lanes that have not reached UInst yet (divergent
+//     control flow) keep their DInst value.
+// UInst itself is required to be block-local by checkUseInst.
+bool VariableReuseAnalysis::isCrossBlockReuseLegal(Instruction *DefInst,
+                                                   Instruction *UseInst,
+                                                   LiveVars *LV) {
+  if (IGC_IS_FLAG_DISABLED(EnableCrossBlockVariableReuse))
+    return false;
+
+  BasicBlock *CurBB = UseInst->getParent();
+  if (LV->isLiveOut(DefInst, *CurBB))
+    return false;
+
+  if (m_WIA && m_WIA->whichDepend(DefInst) == WIAnalysis::UNIFORM)
+    return false;
+
+  if (m_DeSSA && getCongruentClassSize(DefInst) != 1)
+    return false;
+
+  for (auto U : DefInst->users()) {
+    if (isa<PHINode>(U))
+      return false;
+  }
+  return true;
+}
+
 bool VariableReuseAnalysis::isAliaser(Value* V)
 {
     return m_ValueAliasMap.count(V) > 0;
@@ -156,6 +156,10 @@ public:
   bool checkDefInst(llvm::Instruction *DInst, llvm::Instruction *UInst,
                     LiveVars *LV);
 
+  // Check whether a def living in another block may share storage with UInst.
+  bool isCrossBlockReuseLegal(llvm::Instruction *DInst, llvm::Instruction *UInst,
+                              LiveVars *LV);
+
   bool isLocalValue(llvm::Value* V);
  
   bool aliasHasInterference(llvm::Value* Aliaser, llvm::Value* Aliasee);
@@ -38,6 +38,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/InstIterator.h>
 #include <llvm/Support/MathExtras.h>
+#include <llvm/Transforms/Utils/Local.h>
 #include "common/LLVMWarningsPop.hpp"
 
 using namespace llvm;
@@ -170,6 +171,7 @@ namespace
     private:
         bool reLayoutLoadStore(Instruction *Inst);
         bool optimizeBitCast(BitCastInst *BC);
+        bool raiseAlignment(Instruction *Inst);
 
      private:
         const DataLayout *m_DL;
@@ -195,6 +197,46 @@ FunctionPass *IGC::createVectorProcessPass()
     return new VectorProcess();
 }
 
+// Set the alignment of a load/store to the alignment provable from its
+// address if the latter is larger. Front-ends often emit the alignment of
+// the element type only (e.g. 4 for float4 accessed through a float*),
+// which makes VectorMessage fall back to narrower, more numerous messages.
+bool VectorProcess::raiseAlignment(Instruction* Inst)
+{
+    LoadInst  *LI = dyn_cast<LoadInst>(Inst);
+    StoreInst *SI = dyn_cast<StoreInst>(Inst);
+    if (!LI && !SI)
+    {
+        return false;
+    }
+
+    Value *Ptr = LI ? LI->getPointerOperand() : SI->getPointerOperand();
+    Type  *Ty = LI ? LI->getType() : SI->getValueOperand()->getType();
+    uint32_t TBytes = int_cast<uint32_t>(m_DL->getTypeStoreSize(Ty));
+    uint32_t align = LI ? LI->getAlignment() : SI->getAlignment();
+    if (TBytes < 4 || align >= std::min(TBytes, 16U))
+    {
+        return false;
+    }
+
+    // No message benefits from an alignment beyond 16 bytes.
+    uint32_t knownAlign = std::min(getKnownAlignment(Ptr, *m_DL, Inst), 16U);
+    if (knownAlign <= align)
+    {
+        return false;
+    }
+
+    if (LI)
+    {
+        LI->setAlignment(knownAlign);
+    }
+    else
+    {
+        SI->setAlignment(knownAlign);
+    }
+    return true;
+}
+
 bool VectorProcess::reLayoutLoadStore(Instruction* Inst)
 {
     LoadInst  *LI = dyn_cast<LoadInst>(Inst);
@@ -561,8 +603,15 @@ bool VectorProcess::runOnFunction(Function& F)
         }
     }
 
+    bool raiseAlign = IGC_IS_FLAG_ENABLED(EnableWideVectorMessages);
     for( unsigned i=0; i < m_WorkList.size(); ++i )
     {
+        // Raise the alignment first so that both the re-layout here and
+        // VectorMessage at emit time can pick the widest message.
+        if( raiseAlign && raiseAlignment(m_WorkList[i]) )
+        {
+            changed = true;
+        }
         if( reLayoutLoadStore(m_WorkList[i]) )
         {
             changed = true;
@@ -694,14 +743,19 @@ void VectorMessage::getInfo(Type *Ty, uint32_t Align, bool useA32,
             ? MESSAGE_A32_UNTYPED_SURFACE_RW
             : MESSAGE_A64_SCATTERED_RW;
 
+        bool allowQWMessage = !useA32 && eltSize == 8 && Align >= 8U;
+
+        // A64 QW scattered supports 4 blocks per lane under SIMD8 on all
+        // platforms, so a QW vector does not need the 8DW message for that.
+        bool wideQWMessage = allowQWMessage && SM == SIMDMode::SIMD8 &&
+            IGC_IS_FLAG_ENABLED(EnableWideVectorMessages);
+
         MB = useA32
             ? A32_UNTYPED_MAX_BYTES
-            : ((has_8DW_A64_SM && SM == SIMDMode::SIMD8)
+            : (((has_8DW_A64_SM || wideQWMessage) && SM == SIMDMode::SIMD8)
                 ? A64_SCATTERED_MAX_BYTES_8DW_SIMD8
                 : A64_SCATTERED_MAX_BYTES_4DW);
 
-        bool allowQWMessage = !useA32 && eltSize == 8 && Align >= 8U;
-
         defaultDataType = (eltSize == 8) ? ISA_TYPE_UQ : ISA_TYPE_UD;
 
         //To make sure that send returns the correct layout for vector.
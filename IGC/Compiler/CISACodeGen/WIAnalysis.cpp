@@ -242,6 +242,7 @@ bool WIAnalysis::runOnFunction(Function &F) {
 
   m_changed1.clear();
   m_changed2.clear();
+  m_changedNewSet.clear();
   m_pChangedNew = &m_changed1;
   m_pChangedOld = &m_changed2;
   m_ctrlBranches.clear();
@@ -290,6 +291,7 @@ void WIAnalysis::updateDeps()
     // clear the newChanged set so it will be filled with the users of 
     // instruction which their WI-dep canged during the current iteration
     m_pChangedNew->clear();
+    m_changedNewSet.clear();
 
    // update all changed values
     std::vector<const Value*>::iterator it = m_pChangedOld->begin();
@@ -778,6 +780,16 @@ void WIAnalysis::updatePHIDepAtJoin(BasicBlock *blk, BranchInfo *brInfo)
   }
 }
 
+void WIAnalysis::addToChanged(const Value* val)
+{
+  // Several operands of a value can change in the same iteration; queue it
+  // only once so each iteration visits every affected user a single time.
+  if (m_changedNewSet.insert(val).second)
+  {
+    m_pChangedNew->push_back(val);
+  }
+}
+
 void WIAnalysis::updateDepMap(const Instruction *inst, WIAnalysis::WIDependancy dep)
 {
   // Save the new value of this instruction
@@ -788,14 +800,14 @@ void WIAnalysis::updateDepMap(const Instruction *inst, WIAnalysis::WIDependancy
   Value::const_user_iterator e  = inst->user_end();
   for (; it != e; ++it)
   {
-    m_pChangedNew->push_back(*it);
+    addToChanged(*it);
   }
   if(const StoreInst* st = dyn_cast<StoreInst>(inst))
   {
       auto it = m_storeDepMap.find(st);
       if(it != m_storeDepMap.end())
       {
-          m_pChangedNew->push_back(it->second);
+          addToChanged(it->second);
       }
   }
   // accumulate work-list for backward adjustment
@@ -833,7 +845,7 @@ void WIAnalysis::updateInsertElements(const InsertElementInst *inst)
         Value::user_iterator e = curInst->user_end();
         for (; it != e; ++it)
         {
-            m_pChangedNew->push_back(*it);
+            addToChanged(*it);
         }
     }
 }
@@ -174,6 +174,7 @@ public:
       m_depMap.clear();
       m_changed1.clear();
       m_changed2.clear();
+      m_changedNewSet.clear();
       m_ctrlBranches.clear();
       m_backwardList.clear();
     }
@@ -228,6 +229,9 @@ private:
 
     void updateDepMap(const llvm::Instruction *inst, WIAnalysis::WIDependancy dep);
 
+    /// @brief queue val for re-calculation in the next iteration, at most once
+    void addToChanged(const llvm::Value* val);
+
     /// @brief Provide known dependency type for requested value
     /// @param val llvm::Value to examine
     /// @return Dependency type. Returns Uniform for unknown type
@@ -295,6 +299,8 @@ private:
     /// ptr to m_changed1, m_changed2 
     std::vector<const llvm::Value*> *m_pChangedOld;
     std::vector<const llvm::Value*> *m_pChangedNew;
+    /// values already queued in *m_pChangedNew
+    llvm::DenseSet<const llvm::Value*> m_changedNewSet;
 
     std::vector<const llvm::Instruction*> m_backwardList;
 
@@ -319,6 +319,19 @@ inline float GetThreadOccupancyPerSubslice(SIMDMode simdMode, unsigned threadGro
     return occupancy;
 }
 
+// Fraction of the lanes of the threads dispatched for a thread group that
+// carry a work item, e.g. 0.75 for a group of 24 at SIMD16.
+inline float GetLaneUtilization(SIMDMode simdMode, unsigned threadGroupSize)
+{
+    unsigned simdWidth = numLanes(simdMode);
+    unsigned nThreadsPerTG = (threadGroupSize + simdWidth - 1) / simdWidth;
+    if (nThreadsPerTG == 0)
+    {
+        return 1.0f;
+    }
+    return float(threadGroupSize) / float(nThreadsPerTG * simdWidth);
+}
+
 // Duplicate of the LLVM function in llvm/Transforms/Utils/ModuleUtils.h
 // Global can now be any pointer type that uses addrspace
 void appendToUsed(llvm::Module &M, llvm::ArrayRef<llvm::GlobalValue *> Values);
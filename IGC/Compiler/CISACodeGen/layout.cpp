@@ -32,6 +32,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/debug/Dump.hpp"
 #include "common/MemStats.h"
 #include "common/LLVMUtils.h"
+#include "common/igc_regkeys.hpp"
 
 #include <vector>
 #include <set>
@@ -63,11 +64,12 @@ using namespace IGC;
 IGC_INITIALIZE_PASS_BEGIN(Layout, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
 IGC_INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
 IGC_INITIALIZE_PASS_DEPENDENCY(PostDominatorTreeWrapperPass)
+IGC_INITIALIZE_PASS_DEPENDENCY(BranchProbabilityInfoWrapperPass)
 IGC_INITIALIZE_PASS_END(Layout, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
 
 char IGC::Layout::ID = 0;
 
-Layout::Layout() : FunctionPass(ID), m_PDT(nullptr)
+Layout::Layout() : FunctionPass(ID), m_PDT(nullptr), m_BPI(nullptr)
 {
     initializeLayoutPass(*PassRegistry::getPassRegistry());
 }
@@ -78,12 +80,18 @@ void Layout::getAnalysisUsage(llvm::AnalysisUsage &AU) const
     AU.setPreservesAll();
     AU.addRequired<llvm::LoopInfoWrapperPass>();
 	AU.addRequired<llvm::PostDominatorTreeWrapperPass>();
+    if (IGC_IS_FLAG_ENABLED(EnableFrequencyLayout))
+    {
+        AU.addRequired<llvm::BranchProbabilityInfoWrapperPass>();
+    }
 }
 
 bool Layout::runOnFunction( Function& func )
 {
 	m_PDT = &getAnalysis<PostDominatorTreeWrapperPass>().getPostDomTree();
     LoopInfo& LI = getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
+    m_BPI = IGC_IS_FLAG_ENABLED(EnableFrequencyLayout) ?
+        &getAnalysis<BranchProbabilityInfoWrapperPass>().getBPI() : nullptr;
     if (LI.empty())
     {
         LayoutBlocks( func );
@@ -208,6 +216,50 @@ BasicBlock* Layout::selectSucc(
 	return S0;
 }
 
+//
+// selectColdSucc: select the least likely unvisited successor of CurrBlk.
+//
+// Blocks are laid out backward: a successor visited first by the DFS ends
+// up further away from CurrBlk, and the successor visited last becomes its
+// fall-through. Visiting the cold successor first therefore keeps the hot
+// path falling through and sinks the cold one (error checks, printf, paths
+// ending in unreachable, ...) past it, while the result stays topologically
+// ordered so that the vISA structurizer still recognizes if/else and loops.
+//
+// If SelectAnySizeBlk is false, only non-empty blocks are considered.
+// Returns nullptr if m_BPI is not available or no candidate exists.
+//
+BasicBlock* Layout::selectColdSucc(
+	BasicBlock *CurrBlk,
+	bool SelectAnySizeBlk,
+	const std::set<BasicBlock*>& VisitSet)
+{
+	if (!m_BPI)
+	{
+		return nullptr;
+	}
+
+	BasicBlock *ColdSucc = nullptr;
+	BranchProbability ColdProb = BranchProbability::getOne();
+	for (succ_iterator SI = succ_begin(CurrBlk), SE = succ_end(CurrBlk);
+		SI != SE; ++SI)
+	{
+		BasicBlock *succ = *SI;
+		if (VisitSet.count(succ) || (!SelectAnySizeBlk && succ->size() <= 1))
+		{
+			continue;
+		}
+		// ties keep the first one in the succ list, as PUSHSUCC does
+		BranchProbability Prob = m_BPI->getEdgeProbability(CurrBlk, succ);
+		if (!ColdSucc || Prob < ColdProb)
+		{
+			ColdSucc = succ;
+			ColdProb = Prob;
+		}
+	}
+	return ColdSucc;
+}
+
 void Layout::LayoutBlocks(Function &func, LoopInfo &LI)
 {
 	std::vector<llvm::BasicBlock*> visitVec;
@@ -245,6 +297,12 @@ void Layout::LayoutBlocks(Function &func, LoopInfo &LI)
 		else
 		{
 			// push: time for DFS visit
+			if (BasicBlock *aBlk = selectColdSucc(blk, false, visitSet))
+			{
+				visitVec.push_back(aBlk);
+				visitSet.insert(aBlk);
+				continue;
+			}
 			PUSHSUCC(blk, SUCCANYLOOP, SUCCHASINST);
 			if (blk != visitVec.back())
 				continue;
@@ -402,7 +460,13 @@ void Layout::LayoutBlocks( Function &func )
 		PUSHSUCC(blk, SUCCANYLOOP, SUCCNOINST);
 		if (blk != visitVec.back())
 			continue;
-        // push in all the same-loop successors 
+        // push in all the same-loop successors, the cold one first
+        if (BasicBlock *aBlk = selectColdSucc(blk, true, visitSet))
+        {
+            visitVec.push_back(aBlk);
+            visitSet.insert(aBlk);
+            continue;
+        }
         PUSHSUCC(blk, SUCCANYLOOP, SUCCSZANY);
         // pop
         if (blk == visitVec.back())
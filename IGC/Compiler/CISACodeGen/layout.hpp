@@ -29,6 +29,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/Pass.h>
 #include <llvm/Analysis/LoopInfo.h>
 #include <llvm/Analysis/PostDominators.h>
+#include <llvm/Analysis/BranchProbabilityInfo.h>
 #include "common/LLVMWarningsPop.hpp"
 
 namespace IGC
@@ -63,9 +64,15 @@ private:
 		bool SelectNoInstBlk,
 		const llvm::LoopInfo& LI,
 		const std::set<llvm::BasicBlock*>& VisitSet);
+	llvm::BasicBlock *selectColdSucc(
+		llvm::BasicBlock *CurrBlk,
+		bool SelectAnySizeBlk,
+		const std::set<llvm::BasicBlock*>& VisitSet);
 
 
 	llvm::PostDominatorTree *m_PDT;
+	/// Only set when EnableFrequencyLayout is on
+	llvm::BranchProbabilityInfo *m_BPI;
 };
 
 }
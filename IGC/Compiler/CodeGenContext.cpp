@@ -30,6 +30,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/CISACodeGen/ComputeShaderCodeGen.hpp"
 #include "Compiler/CISACodeGen/ShaderCodeGen.hpp"
 #include "Compiler/CodeGenPublic.h"
+#include <iStdLib/Timestamp.h>
+#include <sstream>
 
 namespace IGC
 {
@@ -50,6 +52,69 @@ static const RetryState RetryTable[] = {
     { false, false, true, true, false, false, false, 500 }
 };
 
+typedef struct BudgetStep {
+    unsigned thresholdPct;
+    const char* description;
+} BudgetStep;
+
+static const BudgetStep BudgetStepTable[CompileTimeBudget::STEP_COUNT] = {
+    { 50, "skipped spill retries" },
+    { 50, "disabled pre-RA scheduling" },
+    { 75, "compiled SIMD8 only" },
+    { 75, "used fast spill register allocation" },
+    { 90, "disabled the vISA CFG structurizer" },
+    { 90, "disabled post-RA scheduling" },
+};
+
+CompileTimeBudget::CompileTimeBudget() : m_budgetMS(0), m_start(0), m_freq(1)
+{
+    memset(m_takenAtMS, 0, sizeof(m_takenAtMS));
+    memset(m_taken, 0, sizeof(m_taken));
+}
+
+void CompileTimeBudget::Start(unsigned budgetMS)
+{
+    m_budgetMS = budgetMS;
+    m_start = iSTD::GetTimestampCounter();
+    m_freq = iSTD::GetTimestampFrequency();
+}
+
+bool CompileTimeBudget::Degrade(Step step)
+{
+    assert(step < STEP_COUNT);
+    if (!IsEnabled())
+    {
+        return false;
+    }
+    if (m_taken[step])
+    {
+        return true;
+    }
+    uint64_t elapsedMS = (iSTD::GetTimestampCounter() - m_start) * 1000 / m_freq;
+    if (elapsedMS * 100 < (uint64_t)m_budgetMS * BudgetStepTable[step].thresholdPct)
+    {
+        return false;
+    }
+    m_taken[step] = true;
+    m_takenAtMS[step] = elapsedMS;
+    return true;
+}
+
+std::string CompileTimeBudget::GetReport() const
+{
+    std::stringstream report;
+    for (unsigned i = 0; i < STEP_COUNT; i++)
+    {
+        if (m_taken[i])
+        {
+            report << "warning: compile-time budget of " << m_budgetMS << "ms: "
+                   << BudgetStepTable[i].description << " after "
+                   << m_takenAtMS[i] << "ms\n";
+        }
+    }
+    return report.str();
+}
+
 RetryManager::RetryManager() : stateId(0), enabled(false)
 {
     memset(m_simdEntries, 0, sizeof(m_simdEntries));
@@ -243,6 +308,16 @@ CShader* RetryManager::PickCSEntryEarly(SIMDMode& simdMode,
     float occu16 = cgCtx->GetThreadOccupancy(SIMDMode::SIMD16);
     float occu32 = cgCtx->GetThreadOccupancy(SIMDMode::SIMD32);
 
+    // Occupancy counts partially filled threads as busy; weigh it by the
+    // share of lanes that actually carry a work item.
+    if (IGC_IS_FLAG_ENABLED(EnableLaneUtilizationSIMDSelection))
+    {
+        unsigned threadGroupSize = cgCtx->GetThreadGroupSize();
+        occu8 *= GetLaneUtilization(SIMDMode::SIMD8, threadGroupSize);
+        occu16 *= GetLaneUtilization(SIMDMode::SIMD16, threadGroupSize);
+        occu32 *= GetLaneUtilization(SIMDMode::SIMD32, threadGroupSize);
+    }
+
     bool simd32NoSpill = m_simdEntries[2] && m_simdEntries[2]->m_spillCost <= spillThreshold;
     bool simd16NoSpill = m_simdEntries[1] && m_simdEntries[1]->m_spillCost <= spillThreshold;
     bool simd8NoSpill = m_simdEntries[0] && m_simdEntries[0]->m_spillCost <= spillThreshold;
@@ -404,7 +479,18 @@ bool RetryManager::PickupCS(ComputeShaderContext* cgCtx)
     return false;
 }
 
+namespace {
+    // Per-thread slot holding the context of the last finished compile.
+    struct LLVMContextPool
+    {
+        LLVMContextWrapper* context = nullptr;
+        ~LLVMContextPool() { delete context; }
+    };
+    thread_local LLVMContextPool g_llvmContextPool;
+}
+
 LLVMContextWrapper::LLVMContextWrapper(bool createResourceDimTypes)
+    : m_hasResourceDimTypes(createResourceDimTypes)
 {
     if(createResourceDimTypes)
     {
@@ -412,6 +498,18 @@ LLVMContextWrapper::LLVMContextWrapper(bool createResourceDimTypes)
     }
 }
 
+LLVMContextWrapper* LLVMContextWrapper::Create(bool createResourceDimTypes)
+{
+    LLVMContextWrapper* pooled = g_llvmContextPool.context;
+    if (pooled && pooled->m_hasResourceDimTypes == createResourceDimTypes)
+    {
+        g_llvmContextPool.context = nullptr;
+        pooled->m_reuseCount++;
+        return pooled;
+    }
+    return new LLVMContextWrapper(createResourceDimTypes);
+}
+
 void LLVMContextWrapper::AddRef()
 {
     refCount++;
@@ -422,10 +520,51 @@ void LLVMContextWrapper::Release()
     refCount--;
     if(refCount == 0)
     {
+        if (IGC_IS_FLAG_ENABLED(EnableLLVMContextPool) &&
+            m_recyclable &&
+            m_reuseCount < IGC_GET_FLAG_VALUE(LLVMContextPoolMaxReuse) &&
+            g_llvmContextPool.context == nullptr)
+        {
+            g_llvmContextPool.context = this;
+            return;
+        }
         delete this;
     }
 }
 
+// Named struct types stay in the context after their module is gone, so
+// recycling a context whose module defined some would rename the types of
+// the next module. The resource dimension types are created by the wrapper
+// itself and are expected to be shared.
+static void markContextIfNotRecyclable(LLVMContextWrapper* ctx, llvm::Module* module)
+{
+    if (!ctx || !module || !ctx->m_recyclable)
+    {
+        return;
+    }
+    for (llvm::StructType* ST : module->getIdentifiedStructTypes())
+    {
+        if (!ST->hasName())
+        {
+            continue;
+        }
+        bool isResourceDimType = false;
+        for (unsigned int i = 0; i < RESOURCE_DIMENSION_TYPE::NUM_RESOURCE_DIMENSION_TYPES; i++)
+        {
+            if (ST->getName() == ResourceDimensionTypeName[i])
+            {
+                isResourceDimType = true;
+                break;
+            }
+        }
+        if (!isResourceDimType)
+        {
+            ctx->m_recyclable = false;
+            return;
+        }
+    }
+}
+
 /** get shader's thread group size */
 unsigned ComputeShaderContext::GetThreadGroupSize()
 {
@@ -544,7 +683,7 @@ uint32_t OpenCLProgramContext::getNumGRFPerThread() const
 
 void CodeGenContext::initLLVMContextWrapper(bool createResourceDimTypes)
 {
-    llvmCtxWrapper = new LLVMContextWrapper(createResourceDimTypes);
+    llvmCtxWrapper = LLVMContextWrapper::Create(createResourceDimTypes);
     llvmCtxWrapper->AddRef();
 }
 
@@ -584,6 +723,7 @@ void CodeGenContext::setModule(llvm::Module *m)
 // delete in order to prevent deleting dangling pointers happening.
 void CodeGenContext::deleteModule()
 {
+    markContextIfNotRecyclable(llvmCtxWrapper, module);
     delete m_pMdUtils;
     delete modMD;
     delete module;
@@ -660,6 +800,7 @@ void CodeGenContext::clear()
     modMD = nullptr;
     m_pMdUtils = nullptr;
 
+    markContextIfNotRecyclable(llvmCtxWrapper, module);
     delete module;
     llvmCtxWrapper->Release();
     module = nullptr;
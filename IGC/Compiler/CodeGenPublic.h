@@ -99,6 +99,14 @@ namespace IGC
         unsigned int    m_InstructionCount;
         void*           m_gtpinBuffer;              // Will be populated by VISA only when special switch is passed by gtpin
         unsigned int    m_gtpinBufferSize;
+        unsigned int    m_peakVISAIRMemoryKB;       //<! peak vISA arena memory while building/optimizing the vISA IR
+        unsigned int    m_peakVISARAMemoryKB;       //<! peak vISA arena memory during register allocation
+        unsigned int    m_peakVISAPostRAMemoryKB;   //<! peak vISA arena memory from after RA through encoding
+        unsigned int    m_numGRFUsed;               //<! number of GRFs allocated by the finalizer
+        unsigned int    m_numSamplerSends;          //<! sends to the sampler
+        unsigned int    m_numDataPortSends;         //<! sends to the data ports, including spill/fill
+        unsigned int    m_numOtherSends;            //<! sends to all other shared functions
+        unsigned int    m_numEstimatedCycles;       //<! static cycle estimate weighted by loop nesting, 0 if not computed
 
         void Destroy()
         {
@@ -465,6 +473,25 @@ namespace IGC
 
         iOpenCL::KernelTypeProgramBinaryInfo m_kernelTypeInfo;
 
+        // Bitcode of the host-evaluated program producing the kernel's
+        // DATA_PARAMETER_PRECOMPUTED_VALUE entries (see PrecomputedArgsAnalysis)
+        std::vector<char>             m_precomputedArgsProgram;
+        unsigned int                  m_numPrecomputedArgs = 0;
+
+        // Explicit args whose value would simplify the kernel (see
+        // FindInterestingConstants), and the ones this variant was
+        // specialized for. The runtime must use the generic variant when an
+        // enqueued value differs from a specialized one.
+        struct SInterestingArgument
+        {
+            unsigned int ArgumentNumber;
+            unsigned int Size;
+            bool         AnyValue;
+            uint32_t     Value;
+        };
+        std::vector<SInterestingArgument>                   m_interestingArgs;
+        std::map<unsigned int, uint32_t>                    m_specializedArgs;
+
         SKernelProgram                m_kernelProgram;
     };
 
@@ -527,6 +554,44 @@ namespace IGC
         USC::SShaderStageBTLayout* getModifiableLayout();
     };
 
+    /// Compile-time budget governor, set with
+    /// -cl-intel-compile-time-budget=<ms>. Compile phases ask it between
+    /// each other whether a degradation step is due. Once the elapsed share
+    /// of the budget passes the step's threshold, the step stays on for the
+    /// rest of the compilation and is reported in the build log.
+    class CompileTimeBudget
+    {
+    public:
+        enum Step
+        {
+            STEP_SKIP_RETRY,                // 50%
+            STEP_NO_PRERA_SCHEDULING,       // 50%
+            STEP_SIMD8_ONLY,                // 75%
+            STEP_FAST_RA,                   // 75%
+            STEP_NO_STRUCTURIZER,           // 90%
+            STEP_NO_POSTRA_SCHEDULING,      // 90%
+            STEP_COUNT
+        };
+
+        CompileTimeBudget();
+
+        void Start(unsigned budgetMS);
+        bool IsEnabled() const { return m_budgetMS != 0; }
+
+        /// Return true if STEP has been or now is taken.
+        bool Degrade(Step step);
+
+        /// Build log describing the steps taken, empty if none.
+        std::string GetReport() const;
+
+    private:
+        unsigned m_budgetMS;
+        uint64_t m_start;
+        uint64_t m_freq;
+        uint64_t m_takenAtMS[STEP_COUNT];   //!< 0 if the step isn't taken
+        bool     m_taken[STEP_COUNT];
+    };
+
     class RetryManager
     {
     public:
@@ -595,14 +660,25 @@ namespace IGC
 
     public:
         LLVMContextWrapper(bool createResourceDimTypes = true);
+        /// Returns a context for a new compile. With EnableLLVMContextPool the
+        /// context released last on this thread is handed out again, with its
+        /// types, constants and intrinsic cache still populated.
+        static LLVMContextWrapper* Create(bool createResourceDimTypes = true);
         /// ref count the LLVMContext as now CodeGenContext owns it
         unsigned int refCount = 0;
         /// IntrinsicIDCache - Cache of intrinsic pointer to numeric ID mappings
         /// requested in this context
         typedef llvm::ValueMap<const llvm::Function*, unsigned> SafeIntrinsicIDCacheTy;
         SafeIntrinsicIDCacheTy m_SafeIntrinsicIDCache;
+        /// Cleared once a module defining its own named struct types used this
+        /// context: a later module would get those names uniqued (".N"), so
+        /// such a context is never recycled.
+        bool m_recyclable = true;
         void AddRef();
         void Release();
+    private:
+        bool m_hasResourceDimTypes;
+        unsigned int m_reuseCount = 0;
     };
 
     class CodeGenContext
@@ -629,6 +705,13 @@ namespace IGC
         /// Module level flag. This flag is false either there is an indirect call
         /// in the module or the kernel sizes are small even with complete inlining.
         bool m_enableSubroutine = false;
+        /// Set by the OCL codegen when EnableParallelSIMDCompile is on: EmitPass
+        /// then leaves the vISA compile of every SIMD variant to CodeGen so that
+        /// the variants can be finalized concurrently.
+        bool m_deferVISACompile = false;
+        /// Same as m_deferVISACompile but restricted to kernels that compile a
+        /// single SIMD width (EnableParallelKernelCompile).
+        bool m_deferFixedSIMDVISACompile = false;
 
         llvm::AssemblyAnnotationWriter* annotater = nullptr;
 
@@ -644,6 +727,11 @@ namespace IGC
         std::vector<unsigned> m_indexableTempSize;
         bool         m_highPsRegisterPressure = 0;
 
+        /// Per-block IR hashes recorded when IGCInstCombiner last reached a fixed
+        /// point, used by EnableIncrementalInstCombine to only revisit the blocks
+        /// changed since then.
+        llvm::DenseMap<const llvm::BasicBlock*, size_t> m_instCombineBlockHashes;
+
         // For IR dump after pass
         unsigned     m_numPasses = 0;
         bool m_threadCombiningOptDone = false;
@@ -929,6 +1017,41 @@ namespace IGC
 				{
 					PromoteStatelessToBindless = true;
 				}
+                if (strstr(options, "-cl-intel-trim-local-ids"))
+                {
+                    TrimLocalIDs = true;
+                }
+                if (strstr(options, "-cl-intel-fast-compile"))
+                {
+                    FastCompile = true;
+                }
+                if (strstr(options, "-cl-intel-buffers-not-aliased"))
+                {
+                    BuffersNotAliased = true;
+                }
+                if (const char *budget = strstr(options, "-cl-intel-compile-time-budget="))
+                {
+                    CompileTimeBudgetMS = (unsigned)atoi(budget + strlen("-cl-intel-compile-time-budget="));
+                }
+                // -cl-intel-specialize-arg=<kernel>:<arg number>:<value>, once per folded argument
+                const char* specializeOption = "-cl-intel-specialize-arg=";
+                for (const char *arg = strstr(options, specializeOption); arg; arg = strstr(arg, specializeOption))
+                {
+                    arg += strlen(specializeOption);
+                    const char *nameEnd = strchr(arg, ':');
+                    if (!nameEnd)
+                    {
+                        continue;
+                    }
+                    char *numEnd = nullptr;
+                    unsigned argNo = (unsigned)strtoul(nameEnd + 1, &numEnd, 10);
+                    if (*numEnd != ':')
+                    {
+                        continue;
+                    }
+                    uint32_t value = (uint32_t)strtoul(numEnd + 1, nullptr, 0);
+                    SpecializedArgs[std::string(arg, nameEnd)][argNo] = value;
+                }
             }
 
 
@@ -943,6 +1066,14 @@ namespace IGC
             bool replaceGlobalOffsetsByZero = false;
             bool IntelEnablePreRAScheduling = true;
 			bool PromoteStatelessToBindless = false;
+            bool TrimLocalIDs = false;
+            bool FastCompile = false;
+            // the runtime only enqueues this build with non-overlapping buffers
+            bool BuffersNotAliased = false;
+            unsigned CompileTimeBudgetMS = 0;
+            // Values the runtime observed for the interesting args of each
+            // kernel, folded into a specialized variant of it.
+            std::map<std::string, std::map<unsigned int, uint32_t>> SpecializedArgs;
 
         };
 
@@ -984,6 +1115,31 @@ namespace IGC
         bool isSpirV;
         float m_ProfilingTimerResolution;
         bool m_ShouldUseNonCoherentStatelessBTI;
+        // Kernels identical to another kernel of the program up to their
+        // name, mapped to the kernel that is compiled for both of them.
+        std::map<std::string, std::string> m_duplicateKernels;
+        // Build inputs other than the module (options and platform) hashed
+        // into the kernel binary cache keys; empty if the cache is not used.
+        std::string m_kernelBinaryCacheBuildKey;
+        // Cache keys of the kernels compiled by this build, and the binaries
+        // and their metrics of the kernels found in the cache instead, keyed
+        // by kernel name.
+        std::map<std::string, std::string> m_kernelBinaryCacheKeys;
+        std::map<std::string, std::vector<std::string>> m_cachedKernelBinaries;
+        std::map<std::string, std::vector<TC::STB_KernelMetrics>> m_cachedKernelMetrics;
+        CompileTimeBudget m_compileTimeBudget;
+        // Host-evaluated programs of the argument-only uniform values hoisted
+        // out of each kernel by PrecomputedArgsAnalysis, keyed by kernel name.
+        struct PrecomputedArgsProgram
+        {
+            std::vector<char> bitcode;
+            unsigned int numValues = 0;
+        };
+        std::map<std::string, PrecomputedArgsProgram> m_precomputedArgsPrograms;
+        // Interesting args found for each kernel, and the args actually folded
+        // from InternalOptions::SpecializedArgs, keyed by kernel name.
+        std::map<std::string, std::vector<SOpenCLKernelInfo::SInterestingArgument>> m_interestingArgs;
+        std::map<std::string, std::map<unsigned int, uint32_t>> m_specializedArgs;
 
 		OpenCLProgramContext(
 			const COCLBTILayout& btiLayout,
@@ -1000,6 +1156,7 @@ namespace IGC
             isSpirV(false),
 			m_ShouldUseNonCoherentStatelessBTI(shouldUseNonCoherentStatelessBTI)
         {
+            m_compileTimeBudget.Start(m_InternalOptions.CompileTimeBudgetMS);
         }
         bool isSPIRV() const;
         void setAsSPIRV();
@@ -34,6 +34,13 @@ enum HullShaderDispatchModes: signed int
     EIGHT_PATCH_DISPATCH_MODE,
 };
 
+// Why the HS dispatch mode was chosen, reported in the shader stats
+enum HullShaderDispatchReasons: signed int
+{
+    HS_DISPATCH_REASON_DEFAULT,        // platform, workaround and regkey criteria
+    HS_DISPATCH_REASON_PAYLOAD,        // eight-patch payload over HSEightPatchMaxPayloadGRFs
+};
+
 enum DomainShaderDispatchModes: signed int
 {
     DS_SIMD4x2_DISPATCH_MODE                     = 0x0,
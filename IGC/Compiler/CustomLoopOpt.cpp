@@ -28,6 +28,9 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/Transforms/Utils/Cloning.h>
 #include <llvm/Transforms/Utils/BasicBlockUtils.h>
 #include <llvm/Transforms/Utils/LoopUtils.h>
+#include <llvm/Transforms/Utils/LoopVersioning.h>
+#include <llvm/Analysis/LoopAccessAnalysis.h>
+#include <llvm/Analysis/ScalarEvolution.h>
 #include "common/LLVMWarningsPop.hpp"
 
 #include "common/LLVMUtils.h"
@@ -922,3 +925,129 @@ FunctionPass* createLoopCanonicalization()
 }
 }
 
+class OpenCLLoopVersioning : public llvm::FunctionPass
+{
+public:
+    static char ID;
+
+    OpenCLLoopVersioning();
+
+    void getAnalysisUsage(llvm::AnalysisUsage& AU) const
+    {
+        AU.addRequired<llvm::LoopInfoWrapperPass>();
+        AU.addRequired<llvm::DominatorTreeWrapperPass>();
+        AU.addRequired<llvm::ScalarEvolutionWrapperPass>();
+        AU.addRequired<llvm::LoopAccessLegacyAnalysis>();
+        AU.addRequiredID(llvm::LCSSAID);
+        AU.addRequiredID(llvm::LoopSimplifyID);
+    }
+
+    bool runOnFunction(Function& F);
+
+    llvm::StringRef getPassName() const
+    {
+        return "IGC OpenCL loop versioning";
+    }
+
+private:
+    bool canVersionLoop(Loop* L, const LoopAccessInfo& LAI) const;
+};
+#undef PASS_FLAG
+#undef PASS_DESC
+#undef PASS_CFG_ONLY
+#undef PASS_ANALYSIS
+#define PASS_FLAG     "igc-ocl-loop-versioning"
+#define PASS_DESC     "IGC OpenCL loop versioning"
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS false
+IGC_INITIALIZE_PASS_BEGIN(OpenCLLoopVersioning, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass);
+IGC_INITIALIZE_PASS_DEPENDENCY(DominatorTreeWrapperPass);
+IGC_INITIALIZE_PASS_DEPENDENCY(ScalarEvolutionWrapperPass);
+IGC_INITIALIZE_PASS_DEPENDENCY(LoopAccessLegacyAnalysis);
+IGC_INITIALIZE_PASS_DEPENDENCY(LCSSAWrapperPass)
+IGC_INITIALIZE_PASS_DEPENDENCY(LoopSimplify)
+IGC_INITIALIZE_PASS_END(OpenCLLoopVersioning, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+
+char OpenCLLoopVersioning::ID = 0;
+
+OpenCLLoopVersioning::OpenCLLoopVersioning() : FunctionPass(ID)
+{
+    initializeOpenCLLoopVersioningPass(*PassRegistry::getPassRegistry());
+}
+
+bool OpenCLLoopVersioning::canVersionLoop(Loop* L, const LoopAccessInfo& LAI) const
+{
+    if (!L->isLoopSimplifyForm() || !L->getExitBlock() || !L->getExitingBlock())
+    {
+        return false;
+    }
+
+    // Memory accesses must be analyzable and only blocked by possible
+    // overlaps that a runtime check can rule out.
+    unsigned numChecks = LAI.getNumRuntimePointerChecks();
+    if (!LAI.canVectorizeMemory() || numChecks == 0 ||
+        numChecks > IGC_GET_FLAG_VALUE(OpenCLLoopVersioningMaxChecks))
+    {
+        return false;
+    }
+
+    for (BasicBlock* BB : L->blocks())
+    {
+        for (Instruction& I : *BB)
+        {
+            // Duplicating barriers under a possibly divergent check is not legal.
+            if (CallInst* CI = dyn_cast<CallInst>(&I))
+            {
+                if (CI->isConvergent() || CI->cannotDuplicate())
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool OpenCLLoopVersioning::runOnFunction(Function& F)
+{
+    LoopInfo* LI = &getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
+    DominatorTree* DT = &getAnalysis<DominatorTreeWrapperPass>().getDomTree();
+    ScalarEvolution* SE = &getAnalysis<ScalarEvolutionWrapperPass>().getSE();
+    LoopAccessLegacyAnalysis* LAA = &getAnalysis<LoopAccessLegacyAnalysis>();
+
+    // Versioning adds loops, so collect the innermost loops first.
+    SmallVector<Loop*, 8> worklist;
+    for (Loop* L : LI->getLoopsInPreorder())
+    {
+        if (L->empty())
+        {
+            worklist.push_back(L);
+        }
+    }
+
+    bool changed = false;
+    for (Loop* L : worklist)
+    {
+        const LoopAccessInfo& LAI = LAA->getInfo(L);
+        if (!canVersionLoop(L, LAI))
+        {
+            continue;
+        }
+
+        LoopVersioning LVer(LAI, L, LI, DT, SE);
+        LVer.versionLoop();
+        LVer.annotateLoopWithNoAlias();
+        changed = true;
+    }
+    return changed;
+}
+
+namespace IGC
+{
+FunctionPass* createOpenCLLoopVersioningPass()
+{
+    return new OpenCLLoopVersioning();
+}
+}
+
@@ -49,6 +49,12 @@ namespace IGC
 /// in case of barriers being used and it may cause extra SIMD divergence causing 
 /// performance degradation
 llvm::FunctionPass* createLoopCanonicalization();
+
+///////////////////////////////////////////////////////////////////////////
+/// Version innermost OpenCL loops on a runtime no-overlap check of the
+/// pointers they access. The fast copy is annotated with noalias scopes so
+/// later passes can hoist, merge and unroll its memory accesses.
+llvm::FunctionPass* createOpenCLLoopVersioningPass();
 /**
  * Custom loop versioning.
  * Break loop into segments to expose loop invirants.
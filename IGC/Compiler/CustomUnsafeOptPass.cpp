@@ -69,6 +69,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/Intrinsics.h>
 #include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/Local.h>
 #include <llvm/Pass.h>
 #include <llvm/IR/InstVisitor.h>
 #include <llvm/IR/PatternMatch.h>
@@ -77,6 +78,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/LLVMWarningsPop.hpp"
 
 #include <set>
+#include <algorithm>
 
 using namespace llvm;
 using namespace IGC;
@@ -166,6 +168,11 @@ bool CustomUnsafeOptPass::runOnFunction(Function &F)
     // Do reassociate to emit more mad.
     reassociateMulAdd(F);
 
+    if (IGC_IS_FLAG_ENABLED(EnableFPChainBalancing))
+    {
+        balanceFPChains(F);
+    }
+
     return true;
 }
 
@@ -2315,6 +2322,149 @@ void CustomUnsafeOptPass::reassociateMulAdd(Function &F)
     }
 }
 
+// Returns true if I is an interior node of an fadd/fmul chain, i.e. it is
+// only used by the same operation in the same block and can be reassociated.
+static bool isFPChainNode(CodeGenContext* ctx, Value* V, unsigned opcode, BasicBlock* BB)
+{
+    BinaryOperator* BO = dyn_cast<BinaryOperator>(V);
+    return BO && BO->getOpcode() == opcode && BO->getParent() == BB &&
+        BO->hasOneUse() && allowUnsafeMathOpt(ctx, *BO);
+}
+
+// Flatten the chain rooted at root into its leaves and return the depth of
+// the chain.
+static unsigned collectFPChainLeaves(CodeGenContext* ctx, BinaryOperator* root,
+    SmallVectorImpl<Value*>& leaves)
+{
+    unsigned depth = 0;
+    for (Value* op : root->operands())
+    {
+        if (isFPChainNode(ctx, op, root->getOpcode(), root->getParent()))
+        {
+            depth = std::max(depth, collectFPChainLeaves(ctx, cast<BinaryOperator>(op), leaves));
+        }
+        else
+        {
+            leaves.push_back(op);
+        }
+    }
+    return depth + 1;
+}
+
+// Rebalance long fast-math fadd/fmul chains to shorten the dependence chain.
+// E.g.
+//
+// ((((a * b + c) + d * e) + f * g) + h * i) + j * k
+//
+// is a chain of depth 5. With a chain length of 3 it becomes
+//
+// ((a * b + c) + d * e) + ((f * g + h * i) + j * k)
+//
+// Sums are split into a few independent partial sums, each a linear chain so
+// that the products still fold into mad, and the partial sums are then added
+// as a balanced tree. Products are fully balanced.
+//
+void CustomUnsafeOptPass::balanceFPChains(Function &F)
+{
+    if (m_disableReorderingOpt)
+    {
+        return;
+    }
+
+    SmallVector<BinaryOperator*, 32> roots;
+    for (auto &BB : F)
+    {
+        for (auto &I : BB)
+        {
+            BinaryOperator* BO = dyn_cast<BinaryOperator>(&I);
+            if (!BO || (BO->getOpcode() != Instruction::FAdd && BO->getOpcode() != Instruction::FMul))
+            {
+                continue;
+            }
+            if (!allowUnsafeMathOpt(m_ctx, *BO))
+            {
+                continue;
+            }
+            // only start from the last node of a chain
+            BinaryOperator* user = BO->hasOneUse() ? dyn_cast<BinaryOperator>(BO->user_back()) : nullptr;
+            if (user && user->getOpcode() == BO->getOpcode() && allowUnsafeMathOpt(m_ctx, *user) &&
+                isFPChainNode(m_ctx, BO, BO->getOpcode(), user->getParent()))
+            {
+                continue;
+            }
+            roots.push_back(BO);
+        }
+    }
+
+    for (BinaryOperator* root : roots)
+    {
+        m_isChanged |= balanceFPChain(root);
+    }
+}
+
+bool CustomUnsafeOptPass::balanceFPChain(BinaryOperator* root)
+{
+    SmallVector<Value*, 16> leaves;
+    unsigned depth = collectFPChainLeaves(m_ctx, root, leaves);
+    unsigned numLeaves = leaves.size();
+    if (numLeaves < 4)
+    {
+        return false;
+    }
+
+    auto opcode = BinaryOperator::BinaryOps(root->getOpcode());
+    bool isAdd = opcode == Instruction::FAdd;
+
+    // For fadd each partial sum is a chain of chainLength leaves; fmul is
+    // balanced as a plain tree.
+    unsigned chainLength = isAdd ? std::max(1u, (unsigned)IGC_GET_FLAG_VALUE(FPChainBalancingLength)) : 1;
+    unsigned numChains = (numLeaves + chainLength - 1) / chainLength;
+    unsigned newDepth = (chainLength - 1) + Log2_32_Ceil(numChains);
+    if (newDepth >= depth)
+    {
+        return false;
+    }
+
+    // Start each partial sum with a value that is not a product so that all
+    // the products can fold into mad.
+    if (isAdd)
+    {
+        std::stable_partition(leaves.begin(), leaves.end(), [](Value* V)
+        {
+            BinaryOperator* BO = dyn_cast<BinaryOperator>(V);
+            return !(BO && BO->getOpcode() == Instruction::FMul && BO->hasOneUse());
+        });
+    }
+
+    IRBuilder<> builder(root);
+    builder.setFastMathFlags(root->getFastMathFlags());
+
+    SmallVector<Value*, 8> partials(numChains, nullptr);
+    for (unsigned i = 0; i < numLeaves; ++i)
+    {
+        Value*& acc = partials[i % numChains];
+        acc = acc ? builder.CreateBinOp(opcode, acc, leaves[i], root->getName()) : leaves[i];
+    }
+
+    while (partials.size() > 1)
+    {
+        SmallVector<Value*, 8> next;
+        for (unsigned i = 0; i + 1 < partials.size(); i += 2)
+        {
+            next.push_back(builder.CreateBinOp(opcode, partials[i], partials[i + 1], root->getName()));
+        }
+        if (partials.size() % 2)
+        {
+            next.push_back(partials.back());
+        }
+        partials.swap(next);
+    }
+
+    root->replaceAllUsesWith(partials[0]);
+    RecursivelyDeleteTriviallyDeadInstructions(root);
+    return true;
+}
+
 // This pass looks for potential patterns where, if some value evaluates
 // to zero, then a long chain of computation will be zero as well and
 // we can just skip it (a so called 'early out').  For example:
@@ -104,6 +104,8 @@ private:
     }
 
     void reassociateMulAdd(llvm::Function &F);
+    void balanceFPChains(llvm::Function &F);
+    bool balanceFPChain(llvm::BinaryOperator* root);
 
     void strengthReducePow(llvm::IntrinsicInst* intrin,
         llvm::Value* exponent);
@@ -1368,12 +1368,19 @@ void DwarfDebug::beginFunction(const Function *MF, IGC::VISAModule* v)
     // Assumes in correct section after the entry point.
     Asm->EmitLabel(FunctionBeginSym);
 
+    // In line-tables-only mode variable locations are not emitted, so there is
+    // no need to track DBG_VALUE history or request labels for it.
+    const bool lineTablesOnly = IGC_IS_FLAG_ENABLED(EnableDebugLineTablesOnly);
+
     for (auto II = m_pModule->begin(), IE = m_pModule->end(); II != IE; ++II)
     {
         const Instruction *MI = *II;
 
         if (m_pModule->IsDebugValue(MI))
         {
+            if (lineTablesOnly)
+                continue;
+
             assert(MI->getNumOperands() > 1 && "Invalid machine instruction!");
 
             // Keep track of user variables.
@@ -1505,8 +1512,13 @@ void DwarfDebug::endFunction(const Function *MF)
     // Set DwarfCompileUnitID in MCContext to default value.
     Asm->SetDwarfCompileUnitID(0);
 
+    const bool lineTablesOnly = IGC_IS_FLAG_ENABLED(EnableDebugLineTablesOnly);
+
     SmallPtrSet<const MDNode *, 16> ProcessedVars;
-    collectVariableInfo(MF, ProcessedVars);
+    if (!lineTablesOnly)
+    {
+        collectVariableInfo(MF, ProcessedVars);
+    }
 
     LexicalScope *FnScope = LScopes.getCurrentFunctionScope();
     CompileUnit *TheCU = SPMap.lookup(FnScope->getScopeNode());
@@ -1518,7 +1530,7 @@ void DwarfDebug::endFunction(const Function *MF)
     {
         LexicalScope *AScope = AList[i];
         const DISubprogram* SP = cast_or_null<DISubprogram>(AScope->getScopeNode());
-        if (SP)
+        if (SP && !lineTablesOnly)
         {
             // Collect info for variables that were optimized out.
 #if LLVM_VERSION_MAJOR == 4 
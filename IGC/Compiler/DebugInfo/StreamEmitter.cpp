@@ -56,6 +56,9 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "llvm/MC/MCValue.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/SourceMgr.h"
+#if LLVM_VERSION_MAJOR >= 7
+#include "llvm/Support/Compression.h"
+#endif
 #include "common/LLVMWarningsPop.hpp"
 
 using namespace llvm;
@@ -487,7 +490,8 @@ class VISAMCCodeEmitter : public MCCodeEmitter
 
 } // namespace IGC
 
-StreamEmitter::StreamEmitter(raw_pwrite_stream& outStream, const std::string& dataLayout, const std::string& targetTriple) :
+StreamEmitter::StreamEmitter(raw_pwrite_stream& outStream, const std::string& dataLayout, const std::string& targetTriple,
+    bool compressDebugSections) :
     m_targetTriple(targetTriple), m_setCounter(0)
 {
 #if LLVM_VERSION_MAJOR == 4
@@ -522,6 +526,12 @@ StreamEmitter::StreamEmitter(raw_pwrite_stream& outStream, const std::string& da
 	m_pDataLayout = new DataLayout(dataLayout);
 	m_pSrcMgr = new SourceMgr();
 	m_pAsmInfo = new VISAMCAsmInfo(GetPointerSize());
+	if (compressDebugSections && zlib::isAvailable())
+	{
+		// The ELF object writer compresses every .debug_* section and tags it
+		// with SHF_COMPRESSED; consumers inflate it on load.
+		m_pAsmInfo->setCompressDebugSections(DebugCompressionType::Z);
+	}
 	m_pObjFileInfo = new MCObjectFileInfo();
 
 	MCRegisterInfo *regInfo = nullptr;
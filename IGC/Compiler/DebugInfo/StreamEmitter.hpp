@@ -65,7 +65,9 @@ public:
     /// @param raw_ostream instance of raw_ostream to emit all bitcode into.
     /// @param dataLayout data layout string.
     /// @param targetTriple target triple string.
-    StreamEmitter(llvm::raw_pwrite_stream&, const std::string& dataLayout, const std::string& targetTriple);
+    /// @param compressDebugSections compress .debug_* sections with zlib when available.
+    StreamEmitter(llvm::raw_pwrite_stream&, const std::string& dataLayout, const std::string& targetTriple,
+        bool compressDebugSections = false);
 
     /// @brief Destructor.
     ~StreamEmitter();
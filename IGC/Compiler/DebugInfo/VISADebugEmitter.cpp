@@ -173,7 +173,8 @@ void DebugEmitter::Initialize(CShader* pShader, bool debugEnabled)
     }
 
     std::string dataLayout = m_pVISAModule->GetDataLayout();
-    m_pStreamEmitter = new StreamEmitter(m_outStream, dataLayout, m_pVISAModule->GetTargetTriple());
+    m_pStreamEmitter = new StreamEmitter(m_outStream, dataLayout, m_pVISAModule->GetTargetTriple(),
+        IGC_IS_FLAG_ENABLED(EnableCompressedDebugSections));
     m_pDwarfDebug = new DwarfDebug(m_pStreamEmitter, m_pVISAModule);
 }
 
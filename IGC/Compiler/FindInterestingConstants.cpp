@@ -27,9 +27,15 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/IGCPassSupport.h"
 #include "Compiler/InitializePasses.h"
 #include "Compiler/CodeGenPublic.h"
+#include "Compiler/MetaDataUtilsWrapper.h"
+#include "AdaptorCommon/ImplicitArgs.hpp"
 #include "common/secure_mem.h"
 #include "FindInterestingConstants.h"
 
+#include "common/LLVMWarningsPush.hpp"
+#include <llvmWrapper/IR/Function.h>
+#include "common/LLVMWarningsPop.hpp"
+
 using namespace llvm;
 using namespace IGC;
 
@@ -39,6 +45,7 @@ using namespace IGC;
 #define PASS_CFG_ONLY false
 #define PASS_ANALYSIS false
 IGC_INITIALIZE_PASS_BEGIN(FindInterestingConstants, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
 IGC_INITIALIZE_PASS_END(FindInterestingConstants, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
 
 char FindInterestingConstants::ID = 0;
@@ -50,7 +57,7 @@ FindInterestingConstants::FindInterestingConstants() : FunctionPass(ID)
     initializeFindInterestingConstantsPass(*PassRegistry::getPassRegistry());
 }
 
-bool FindInterestingConstants::FoldsToConst(Instruction* inst, Instruction* use, bool &propagate)
+bool FindInterestingConstants::FoldsToConst(Value* inst, Instruction* use, bool &propagate)
 {
     propagate = false;
 
@@ -85,7 +92,7 @@ bool FindInterestingConstants::FoldsToConst(Instruction* inst, Instruction* use,
     return true;
 }
 
-void FindInterestingConstants::FoldsToConstPropagate(llvm::Instruction* I)
+void FindInterestingConstants::FoldsToConstPropagate(llvm::Value* I)
 {
     bool propagate = false;
     // if instruction count that can be folded to zero reached threshold, dont loop through 
@@ -97,7 +104,8 @@ void FindInterestingConstants::FoldsToConstPropagate(llvm::Instruction* I)
 
         if (Instruction* useInst = dyn_cast<Instruction>(*UI))
         {
-            if (useInst->getParent() == I->getParent())	// TBD Do we need this
+            Instruction* inst = dyn_cast<Instruction>(I);
+            if (!inst || useInst->getParent() == inst->getParent())	// TBD Do we need this
             {
                 if (FoldsToConst(I, useInst, propagate))
                 {
@@ -110,7 +118,7 @@ void FindInterestingConstants::FoldsToConstPropagate(llvm::Instruction* I)
     }
 }
 
-bool FindInterestingConstants::FoldsToZero(Instruction* inst, Instruction* use)
+bool FindInterestingConstants::FoldsToZero(Value* inst, Instruction* use)
 {
     bool propagate = false;
     if (BranchInst* brInst = dyn_cast<BranchInst>(use))
@@ -139,7 +147,7 @@ bool FindInterestingConstants::FoldsToZero(Instruction* inst, Instruction* use)
     return false;
 }
 
-void FindInterestingConstants::FoldsToZeroPropagate(llvm::Instruction* I)
+void FindInterestingConstants::FoldsToZeroPropagate(llvm::Value* I)
 {
     for (auto UI = I->user_begin(), UE = I->user_end(); (UI != UE); ++UI)
     {
@@ -157,7 +165,7 @@ void FindInterestingConstants::FoldsToZeroPropagate(llvm::Instruction* I)
     }
 }
 
-bool FindInterestingConstants::FoldsToSource(llvm::Instruction* inst, llvm::Instruction* use)
+bool FindInterestingConstants::FoldsToSource(llvm::Value* inst, llvm::Instruction* use)
 {
     if (BinaryOperator *binInst = dyn_cast<BinaryOperator>(use))
     {
@@ -174,7 +182,7 @@ bool FindInterestingConstants::FoldsToSource(llvm::Instruction* inst, llvm::Inst
     return false;
 }
 
-void FindInterestingConstants::FoldsToSourcePropagate(llvm::Instruction* I)
+void FindInterestingConstants::FoldsToSourcePropagate(llvm::Value* I)
 {
     for (auto UI = I->user_begin(), UE = I->user_end(); UI != UE; ++UI)
     {
@@ -262,68 +270,118 @@ void FindInterestingConstants::addInterestingConstant(CodeGenContext* ctx, unsig
     }
 }
 
-void FindInterestingConstants::visitLoadInst(llvm::LoadInst &I)
+template<typename AddFn>
+void FindInterestingConstants::checkInterestingValue(llvm::Value* V, AddFn addInteresting)
 {
-    CodeGenContext* ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
-    unsigned bufId;
-    unsigned eltId;
-    int size_in_bytes;
-
     m_foldsToZero = 0;
     m_foldsToConst = 0;
     m_foldsToSource = 0;
     m_constFoldBranch = false;
-    if(getConstantAddress(I, bufId, eltId, size_in_bytes))
+
+    /*
+    This value is interesting, if the use instruction:
+    is branch
+    or subsequent Instructions get folded to constant if the value is known
+    or subsequent Instructions get folded to zero if the value is 0
+    or subsequent Instructions get folded to its source if the value is 1 (mul/div by 1 scenarios)
+    */
+    FoldsToConstPropagate(V);
+    // If m_foldsToConst is greater than threshold or some branch instruction gets simplified because of this value
+    if ((m_constFoldBranch) || (m_foldsToConst >= IGC_GET_FLAG_VALUE(FoldsToConstPropThreshold)))
+    {
+        addInteresting(true, 0);
+    }
+    else
     {
-        /*
-        This Constant is interesting, if the use instruction:
-        is branch
-        or subsequent Instructions get folded to constant if the constant value is known
-        or subsequent Instructions get folded to zero if the constant value is 0
-        or subsequent Instructions get folded to its source if the constant value is 1 (mul/div by 1 scenarios)
-        */
-        FoldsToConstPropagate(&I);
-        // If m_foldsToConst is greater than threshold or some branch instruction gets simplified because of this constant
-        if ((m_constFoldBranch) || (m_foldsToConst >= IGC_GET_FLAG_VALUE(FoldsToConstPropThreshold)))
+        m_foldsToConst = 0;     // Reset FoldsToConst count to zero. We can keep looking for this case when FoldsToZero cannot be propagated further
+        FoldsToZeroPropagate(V);
+        // If m_foldsToZero is greater than threshold or some branch instruction gets simplified because of this value
+        if ((m_constFoldBranch) ||
+            ((m_foldsToZero + m_foldsToConst) >= IGC_GET_FLAG_VALUE(FoldsToZeroPropThreshold)))
         {
-            // Get the ConstantAddress from LoadInst and log it in interesting constants
-            addInterestingConstant(ctx, bufId, eltId, size_in_bytes, true);
+            // Zero value is interesting
+            addInteresting(false, 0);
+            // Continue finding if ONE_VALUE is beneficial for this value
         }
-        else
+
+        FoldsToSourcePropagate(V);
+        if (m_foldsToSource >= IGC_GET_FLAG_VALUE(FoldsToSourceThreshold))
         {
-            m_foldsToConst = 0;     // Reset FoldsToConst count to zero. We can keep looking for this case when FoldsToZero cannot be propagated further
-            FoldsToZeroPropagate(&I);
-            // If m_foldsToZero is greater than threshold or some branch instruction gets simplified because of this constant
-            if ((m_constFoldBranch) ||
-                ((m_foldsToZero + m_foldsToConst) >= IGC_GET_FLAG_VALUE(FoldsToZeroPropThreshold)))
+            // One value is interesting
+            if (V->getType()->isIntegerTy())
             {
-                // Zero value for this constant is interesting
-                // Get the ConstantAddress from LoadInst and log it in interesting constants
-                addInterestingConstant(ctx, bufId, eltId, size_in_bytes, false, 0);
-                // Continue finding if ONE_VALUE is beneficial for this constant
+                addInteresting(false, 1);
             }
-
-            FoldsToSourcePropagate(&I);
-            if (m_foldsToSource >= IGC_GET_FLAG_VALUE(FoldsToSourceThreshold))
+            else if (V->getType()->isFloatTy())
             {
-                // One value for this constant is interesting
-                // Get the ConstantAddress from LoadInst and log it in interesting constants
-                if (I.getType()->isIntegerTy())
-                {
-                    addInterestingConstant(ctx, bufId, eltId, size_in_bytes, false, 1);
-                }
-                else if (I.getType()->isFloatTy())
-                {
-                    uint32_t value;
-                    float floatValue = 1.0;
-                    memcpy_s(&value, sizeof(uint32_t), &floatValue, sizeof(float));
-                    addInterestingConstant(ctx, bufId, eltId, size_in_bytes, false, value);
-                }
+                uint32_t value;
+                float floatValue = 1.0;
+                memcpy_s(&value, sizeof(uint32_t), &floatValue, sizeof(float));
+                addInteresting(false, value);
             }
         }
     }
 }
 
+void FindInterestingConstants::visitLoadInst(llvm::LoadInst &I)
+{
+    CodeGenContext* ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+    unsigned bufId;
+    unsigned eltId;
+    int size_in_bytes;
+
+    if(getConstantAddress(I, bufId, eltId, size_in_bytes))
+    {
+        // Log the ConstantAddress from LoadInst in interesting constants
+        checkInterestingValue(&I, [&](bool anyValue, uint32_t value)
+        {
+            addInterestingConstant(ctx, bufId, eltId, size_in_bytes, anyValue, value);
+        });
+    }
+}
+
+void FindInterestingConstants::findInterestingArgs(llvm::Function &F)
+{
+    IGCMD::MetaDataUtils* pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+    if (!isEntryFunc(pMdUtils, &F))
+    {
+        return;
+    }
+
+    // Implicit args are appended after the explicit ones.
+    ImplicitArgs implicitArgs(F, pMdUtils);
+    unsigned int numExplicitArgs = IGCLLVM::GetFuncArgSize(F) - implicitArgs.size();
+
+    std::vector<SOpenCLKernelInfo::SInterestingArgument> interestingArgs;
+    for (Argument& arg : F.args())
+    {
+        unsigned int argNo = arg.getArgNo();
+        Type* type = arg.getType();
+        unsigned int size_in_bytes = type->getPrimitiveSizeInBits() / 8;
+        if (argNo >= numExplicitArgs ||
+            !(type->isIntegerTy() || type->isFloatTy()) ||
+            size_in_bytes == 0 || size_in_bytes > 4)
+        {
+            continue;
+        }
+
+        checkInterestingValue(&arg, [&](bool anyValue, uint32_t value)
+        {
+            SOpenCLKernelInfo::SInterestingArgument interesting;
+            interesting.ArgumentNumber = argNo;
+            interesting.Size = size_in_bytes;
+            interesting.AnyValue = anyValue;
+            interesting.Value = value;
+            interestingArgs.push_back(interesting);
+        });
+    }
+
+    if (!interestingArgs.empty())
+    {
+        m_InterestingArgs[F.getName().str()] = std::move(interestingArgs);
+    }
+}
+
 template<typename ContextT>
 void FindInterestingConstants::copyInterestingConstants(ContextT* pShaderCtx)
 {
@@ -338,6 +396,17 @@ bool FindInterestingConstants::doFinalization(llvm::Module &M)
 {
     CodeGenContext* ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
 
+    if (ctx->type == ShaderType::OPENCL_SHADER)
+    {
+        OpenCLProgramContext* pOclCtx = static_cast<OpenCLProgramContext*>(ctx);
+        for (auto& kernelArgs : m_InterestingArgs)
+        {
+            pOclCtx->m_interestingArgs[kernelArgs.first] = std::move(kernelArgs.second);
+        }
+        m_InterestingArgs.clear();
+        return false;
+    }
+
     if (m_InterestingConstants.size() != 0)
     {
         if (ctx->type == ShaderType::PIXEL_SHADER)
@@ -376,6 +445,14 @@ bool FindInterestingConstants::doFinalization(llvm::Module &M)
 
 bool FindInterestingConstants::runOnFunction(Function &F)
 {
+    CodeGenContext* ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+    if (ctx->type == ShaderType::OPENCL_SHADER)
+    {
+        // OpenCL kernels take by-value args rather than constant buffers.
+        findInterestingArgs(F);
+        return false;
+    }
+
     visit(F);
     return false;
 }
@@ -26,6 +26,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 #include "Compiler/CodeGenContextWrapper.hpp"
+#include "Compiler/CodeGenPublic.h"
+#include "Compiler/MetaDataUtilsWrapper.h"
 
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/Pass.h>
@@ -60,6 +62,7 @@ namespace IGC
         virtual void getAnalysisUsage(llvm::AnalysisUsage &AU) const override
         {
             AU.addRequired<CodeGenContextWrapper>();
+            AU.addRequired<MetaDataUtilsWrapper>();
         }
 
         virtual bool runOnFunction(llvm::Function &F) override;
@@ -72,15 +75,20 @@ namespace IGC
         unsigned int m_foldsToSource;
         bool m_constFoldBranch;
         std::vector<USC::ConstantAddrValue> m_InterestingConstants;
+        // Per kernel name, for OpenCL
+        std::map<std::string, std::vector<SOpenCLKernelInfo::SInterestingArgument>> m_InterestingArgs;
 
         // Helper functions
         bool getConstantAddress(llvm::LoadInst &I, unsigned &bufId, unsigned &eltId, int &size_in_bytes);
-        bool FoldsToConst(llvm::Instruction* inst, llvm::Instruction* use, bool &propagate);
-        bool FoldsToZero(llvm::Instruction* inst, llvm::Instruction* use);
-        bool FoldsToSource(llvm::Instruction* inst, llvm::Instruction* use);
-        void FoldsToConstPropagate(llvm::Instruction* I);
-        void FoldsToZeroPropagate(llvm::Instruction* I);
-        void FoldsToSourcePropagate(llvm::Instruction* I);
+        bool FoldsToConst(llvm::Value* inst, llvm::Instruction* use, bool &propagate);
+        bool FoldsToZero(llvm::Value* inst, llvm::Instruction* use);
+        bool FoldsToSource(llvm::Value* inst, llvm::Instruction* use);
+        void FoldsToConstPropagate(llvm::Value* I);
+        void FoldsToZeroPropagate(llvm::Value* I);
+        void FoldsToSourcePropagate(llvm::Value* I);
+        template<typename AddFn>
+        void checkInterestingValue(llvm::Value* V, AddFn addInteresting);
+        void findInterestingArgs(llvm::Function &F);
         void addInterestingConstant(CodeGenContext* ctx, unsigned bufId, unsigned eltId, int size_in_bytes, bool anyValue, uint32_t value);
         template<typename ContextT>
         void copyInterestingConstants(ContextT* pShaderCtx);
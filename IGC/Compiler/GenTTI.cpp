@@ -120,9 +120,132 @@ unsigned countTotalInstructions(const Function *F, bool CheckSendMsg = true) {
     return EstimatedInstCnt;
 }
 
-void GenIntrinsicsTTIImpl::getUnrollingPreferences(Loop *L, 
+void GenIntrinsicsTTIImpl::getUnrollingPreferences(Loop *L,
 #if LLVM_VERSION_MAJOR >= 7
-	ScalarEvolution &SE, 
+	ScalarEvolution &SE,
+#endif
+	TTI::UnrollingPreferences &UP)
+{
+    getInstCountUnrollingPreferences(L,
+#if LLVM_VERSION_MAJOR >= 7
+        SE,
+#endif
+        UP);
+
+    if (IGC_IS_FLAG_ENABLED(EnableRegPressureUnrollLimit))
+    {
+        limitUnrollingByRegPressure(L, UP);
+    }
+}
+
+// Estimates the GRFs the loop needs the way RegisterEstimator does, without
+// uniform analysis: values defined outside and used inside the loop stay live
+// across all unrolled copies, while the peak of the values live within a loop
+// block is paid once per copy.
+void GenIntrinsicsTTIImpl::limitUnrollingByRegPressure(Loop *L, TTI::UnrollingPreferences &UP)
+{
+    // unrolling runs before the SIMD size is chosen, assume SIMD16
+    const unsigned simdSize = 16;
+    const unsigned grfBytes = 32;
+    const DataLayout &DL = L->getHeader()->getModule()->getDataLayout();
+    auto numGRF = [&](Value *V) -> unsigned
+    {
+        Type *Ty = V->getType();
+        if (Ty->isVoidTy() || Ty->isLabelTy() || Ty->getScalarType()->isIntegerTy(1))
+        {
+            return 0;
+        }
+        unsigned bytes = (unsigned)DL.getTypeAllocSize(Ty) * simdSize;
+        return (bytes + grfBytes - 1) / grfBytes;
+    };
+
+    SmallPtrSet<Value*, 32> invariants;
+    unsigned invariantGRF = 0;
+    unsigned bodyGRF = 0;
+    for (BasicBlock *BB : L->blocks())
+    {
+        // values used after this block are live at its end
+        SmallPtrSet<Value*, 32> live;
+        unsigned liveGRF = 0;
+        for (Instruction &I : *BB)
+        {
+            for (User *U : I.users())
+            {
+                if (cast<Instruction>(U)->getParent() != BB || isa<PHINode>(U))
+                {
+                    if (live.insert(&I).second)
+                    {
+                        liveGRF += numGRF(&I);
+                    }
+                    break;
+                }
+            }
+        }
+        unsigned maxGRF = liveGRF;
+        for (auto II = BB->rbegin(), IE = BB->rend(); II != IE; ++II)
+        {
+            Instruction *I = &*II;
+            if (live.erase(I))
+            {
+                liveGRF -= numGRF(I);
+            }
+            if (isa<PHINode>(I))
+            {
+                continue;
+            }
+            for (Value *Op : I->operands())
+            {
+                if (!isa<Instruction>(Op) && !isa<Argument>(Op))
+                {
+                    continue;
+                }
+                Instruction *OpInst = dyn_cast<Instruction>(Op);
+                if (!OpInst || !L->contains(OpInst))
+                {
+                    if (invariants.insert(Op).second)
+                    {
+                        invariantGRF += numGRF(Op);
+                    }
+                }
+                else if (live.insert(Op).second)
+                {
+                    liveGRF += numGRF(Op);
+                }
+            }
+            maxGRF = std::max(maxGRF, liveGRF);
+        }
+        bodyGRF = std::max(bodyGRF, maxGRF);
+    }
+
+    if (bodyGRF == 0)
+    {
+        return;
+    }
+
+    unsigned budget = ctx->getNumGRFPerThread();
+    unsigned maxCount = budget > invariantGRF + bodyGRF ?
+        (budget - invariantGRF) / bodyGRF : 1;
+
+    if (maxCount <= 1)
+    {
+        UP.Count = 1;
+        UP.MaxCount = 1;
+        UP.FullUnrollMaxCount = 1;
+        UP.Partial = false;
+        UP.Runtime = false;
+        return;
+    }
+    UP.MaxCount = std::min(UP.MaxCount, maxCount);
+    UP.FullUnrollMaxCount = std::min(UP.FullUnrollMaxCount, maxCount);
+    if (UP.Count > maxCount)
+    {
+        UP.Count = maxCount;
+    }
+}
+
+void GenIntrinsicsTTIImpl::getInstCountUnrollingPreferences(Loop *L,
+#if LLVM_VERSION_MAJOR >= 7
+	ScalarEvolution &SE,
 #endif
 	TTI::UnrollingPreferences &UP)
 {
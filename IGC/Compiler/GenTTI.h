@@ -70,6 +70,18 @@ namespace llvm
 
          using BaseT::getCallCost;
          unsigned getCallCost(const Function *F, ArrayRef<const Value *> Args);
+
+     private:
+         // Preferences derived from the instruction and send message counts
+         void getInstCountUnrollingPreferences(Loop *L,
+#if LLVM_VERSION_MAJOR >= 7
+         ScalarEvolution &SE,
+#endif
+         TTI::UnrollingPreferences &UP);
+
+         // Cap the unroll count so that the copies of the loop body still fit
+         // in the GRF budget
+         void limitUnrollingByRegPressure(Loop *L, TTI::UnrollingPreferences &UP);
     };
 
 }
\ No newline at end of file
@@ -67,6 +67,7 @@ void initializeGenXFunctionGroupAnalysisPass(llvm::PassRegistry&);
 void initializeGenXCodeGenModulePass(llvm::PassRegistry&);
 void initializeEstimateFunctionSizePass(llvm::PassRegistry&);
 void initializeSubroutineInlinerPass(llvm::PassRegistry&);
+void initializeOutlinedSubroutineMetaDataPass(llvm::PassRegistry&);
 void initializeHandleLoadStoreInstructionsPass(llvm::PassRegistry&);
 void initializeIGCConstPropPass(llvm::PassRegistry&);
 void initializeGatingSimilarSamplesPass(llvm::PassRegistry&);
@@ -74,6 +75,7 @@ void initializeImageFuncResolutionPass(llvm::PassRegistry&);
 void initializeImageFuncsAnalysisPass(llvm::PassRegistry&);
 void initializeImplicitGlobalIdPass(llvm::PassRegistry&);
 void initializeInlineLocalsResolutionPass(llvm::PassRegistry&);
+void initializeKernelArgSpecializationPass(llvm::PassRegistry&);
 void initializeLegalizationPass(llvm::PassRegistry&);
 void initializeLegalizeResourcePointerPass(llvm::PassRegistry&);
 void initializeLiveVarsAnalysisPass(llvm::PassRegistry&);
@@ -84,6 +86,8 @@ void initializeMetaDataUtilsWrapperPass(llvm::PassRegistry&);
 void initializeOpenCLPrintfAnalysisPass(llvm::PassRegistry&);
 void initializeOpenCLPrintfResolutionPass(llvm::PassRegistry&);
 void initializePositionDepAnalysisPass( llvm::PassRegistry& );
+void initializePrecomputedArgsAnalysisPass(llvm::PassRegistry&);
+void initializePrecomputedArgsResolutionPass(llvm::PassRegistry&);
 void initializePrivateMemoryResolutionPass(llvm::PassRegistry&);
 void initializePrivateMemoryUsageAnalysisPass(llvm::PassRegistry&);
 void initializeProcessFuncAttributesPass(llvm::PassRegistry&);
@@ -123,9 +127,11 @@ void initializeMemOptPass(llvm::PassRegistry&);
 void initializePreRASchedulerPass(llvm::PassRegistry&);
 void initializeBIFTransformsPass(llvm::PassRegistry&);
 void initializeThreadCombiningPass(llvm::PassRegistry&);
+void initializeOpenCLThreadCombiningPass(llvm::PassRegistry&);
 void initializeRegisterPressureEstimatePass(llvm::PassRegistry&);
 void initializeLivenessAnalysisPass(llvm::PassRegistry&);
 void initializeRegisterEstimatorPass(llvm::PassRegistry&);
+void initializeSpillPredictorPass(llvm::PassRegistry&);
 void initializeVariableReuseAnalysisPass(llvm::PassRegistry&);
 void initializeTransformBlocksPass(llvm::PassRegistry&);
 void initializeTranslationTablePass(llvm::PassRegistry&);
@@ -484,6 +484,7 @@ public:
     {
         lazyLoad();
         m_data.clear();
+        m_unloaded.clear();
         m_isDirty = true;
     }
 
@@ -502,6 +503,7 @@ public:
     iterator begin()
     {
         lazyLoad();
+        loadAllItems();
         return m_data.begin();
     }
 
@@ -513,6 +515,7 @@ public:
     const_iterator begin() const
     {
         lazyLoad();
+        loadAllItems();
         return m_data.begin();
     }
 
@@ -549,6 +552,7 @@ public:
     void setItem(const key_type& key, const item_type& item)
     {
         lazyLoad();
+        m_unloaded.erase(key);
         m_data[key] = item;
         m_isDirty = true;
     }
@@ -562,24 +566,28 @@ public:
     item_type& operator[]( const key_type& key )
     {
         lazyLoad();
+        loadItem(key);
         return &m_data[key];
     }
 
     const item_type& operator[]( const key_type& key ) const
     {
         lazyLoad();
+        loadItem(key);
         return &m_data[key];
     }
 
     iterator find(const key_type& key) const
     {
         lazyLoad();
+        loadItem(key);
         return m_data.find(key);
     }
 
     void erase(iterator where)
     {
         lazyLoad();
+        m_unloaded.erase((*where).first);
         m_data.erase(where);
         m_isDirty = true;
     }
@@ -591,12 +599,35 @@ public:
 
         assert(m_isLoaded && "Collection should be loaded at this point (since it is dirty)");
 
+        // nothing was added, erased or reordered: only regenerate the entries
+        // whose value changed and leave every other operand alone
+        if( !m_isDirty && pNode->getNumOperands() == m_data.size() )
+        {
+            unsigned int index = 0;
+            for( const_iterator i = m_data.begin(), e = m_data.end(); i != e; ++i, ++index )
+            {
+                if( m_unloaded.count((*i).first) ||
+                    !(KeyTraits::dirty((*i).first) || ValTraits::dirty((*i).second)) )
+                {
+                    continue;
+                }
+                llvm::SmallVector<llvm::Metadata*, 2> args;
+                args.push_back(KeyTraits::generateValue(context, (*i).first));
+                args.push_back(ValTraits::generateValue(context, (*i).second));
+                pNode->setOperand(index, llvm::MDNode::get(context, args));
+            }
+            return;
+        }
+
+        // the old operands are about to be dropped, build what is still pending first
+        loadAllItems();
+
         pNode->dropAllReferences();
 
         meta_iterator mi(pNode,0);
         meta_iterator me(pNode);
-        const_iterator i = begin();
-        const_iterator e = end();
+        const_iterator i = m_data.begin();
+        const_iterator e = m_data.end();
 
         while( i != e || mi != me )
         {
@@ -623,6 +654,10 @@ public:
 
         for( const_iterator i = m_data.begin(), e = m_data.end(); i != e; ++i )
         {
+            if( m_unloaded.count((*i).first) )
+            {
+                continue;
+            }
             if( KeyTraits::dirty((*i).first) || ValTraits::dirty((*i).second) )
                 return true;
         }
@@ -643,6 +678,10 @@ public:
 
         for( iterator i = m_data.begin(), e = m_data.end(); i != e; ++i )
         {
+            if( m_unloaded.count((*i).first) )
+            {
+                continue;
+            }
             KeyTraits::discardChanges((key_type&)((*i).first));
             ValTraits::discardChanges((item_type&)((*i).second));
         }
@@ -651,6 +690,8 @@ public:
     }
 private:
 
+    // Only the keys are read up front, in node order so that save can match
+    // entries to operands; each value is built on first access.
     void lazyLoad() const
     {
         if( m_isLoaded || NULL == m_pNode )
@@ -663,16 +704,39 @@ private:
             llvm::MDNode *node = i.get();
             assert(node->getNumOperands() == 2 && "MetaDataMap node assumed to have exactly two operands");
             key_type key = KeyTraits::load(node->getOperand(0));
-            item_type val = ValTraits::load(node->getOperand(1));
-            m_data[key] = val;
+            m_data[key] = item_type();
+            m_unloaded[key] = node->getOperand(1);
         }
 
         m_isLoaded = true;
     }
 
+    void loadItem(const key_type& key) const
+    {
+        typename std::map<key_type, llvm::Metadata*>::iterator it = m_unloaded.find(key);
+        if( it == m_unloaded.end() )
+        {
+            return;
+        }
+        m_data[key] = ValTraits::load(it->second);
+        m_unloaded.erase(it);
+    }
+
+    void loadAllItems() const
+    {
+        for( typename std::map<key_type, llvm::Metadata*>::iterator it = m_unloaded.begin(),
+            e = m_unloaded.end(); it != e; ++it )
+        {
+            m_data[it->first] = ValTraits::load(it->second);
+        }
+        m_unloaded.clear();
+    }
+
 private:
     const llvm::NamedMDNode* m_pNode;
     mutable MapImplType m_data;
+    // values of loaded keys that have not been built yet
+    mutable std::map<key_type, llvm::Metadata*> m_unloaded;
     bool m_isDirty;
     mutable bool m_isLoaded;
 };
@@ -0,0 +1,81 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#include "Compiler/Optimizer/BiFCallGraphSummary.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/SmallVector.h>
+#include "common/LLVMWarningsPop.hpp"
+
+using namespace llvm;
+using namespace IGC;
+
+bool BiFCallGraphSummary::parse(StringRef Data)
+{
+    m_callees.clear();
+
+    SmallVector<StringRef, 16> Names;
+    while (!Data.empty())
+    {
+        StringRef Line;
+        std::tie(Line, Data) = Data.split('\n');
+        Line = Line.trim();
+        if (Line.empty())
+        {
+            continue;
+        }
+
+        Names.clear();
+        Line.split(Names, ' ', -1, false);
+
+        m_callees[Names.front()].assign(Names.begin() + 1, Names.end());
+    }
+    return !m_callees.empty();
+}
+
+void BiFCallGraphSummary::getClosure(
+    ArrayRef<const BiFCallGraphSummary*> Summaries,
+    ArrayRef<StringRef> Roots,
+    StringSet<>& Closure)
+{
+    SmallVector<StringRef, 64> Worklist(Roots.begin(), Roots.end());
+    while (!Worklist.empty())
+    {
+        StringRef Name = Worklist.pop_back_val();
+        if (!Closure.insert(Name).second)
+        {
+            continue;
+        }
+        // Several summaries may list the same function; follow all of them.
+        for (auto* Summary : Summaries)
+        {
+            auto It = Summary->m_callees.find(Name);
+            if (It != Summary->m_callees.end())
+            {
+                Worklist.append(It->second.begin(), It->second.end());
+            }
+        }
+    }
+}
@@ -0,0 +1,65 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#pragma once
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/ADT/StringSet.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <vector>
+
+namespace IGC
+{
+    /// Direct call graph of a builtin (BiF) module.
+    ///
+    /// The summary is produced at build time by BiFModule/callgraph_summary.py
+    /// and embedded next to the BiF bitcode. It lets BIImport compute the set of
+    /// builtins a kernel needs without materializing them first. The text
+    /// format has one line per defined function: the function name followed
+    /// by the names of the functions it calls directly, separated by spaces.
+    class BiFCallGraphSummary
+    {
+    public:
+        /// Parse a summary. Data must outlive this object; names are not
+        /// copied. Returns false if the summary lists no functions.
+        bool parse(llvm::StringRef Data);
+
+        bool empty() const { return m_callees.empty(); }
+
+        /// Add to Closure the roots and every function reachable from them
+        /// through the given summaries. Names no summary lists are leaves.
+        static void getClosure(
+            llvm::ArrayRef<const BiFCallGraphSummary*> Summaries,
+            llvm::ArrayRef<llvm::StringRef> Roots,
+            llvm::StringSet<>& Closure);
+
+    private:
+        llvm::StringMap<std::vector<llvm::StringRef>> m_callees;
+    };
+}
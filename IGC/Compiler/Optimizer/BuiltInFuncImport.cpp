@@ -63,10 +63,16 @@ IGC_INITIALIZE_PASS_END(BIImport, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PA
 
 char BIImport::ID = 0;
 
-BIImport::BIImport(std::unique_ptr<Module> pGenericModule, std::unique_ptr<Module> pSizeModule) :
+BIImport::BIImport(
+    std::unique_ptr<Module> pGenericModule,
+    std::unique_ptr<Module> pSizeModule,
+    const BiFCallGraphSummary* pGenericCallGraph,
+    const BiFCallGraphSummary* pSizeCallGraph) :
     ModulePass(ID),
     m_GenericModule(std::move(pGenericModule)),
-    m_SizeModule(std::move(pSizeModule))
+    m_SizeModule(std::move(pSizeModule)),
+    m_GenericCallGraph(pGenericCallGraph),
+    m_SizeCallGraph(pSizeCallGraph)
 {
     initializeBIImportPass(*PassRegistry::getPassRegistry());
 }
@@ -565,9 +571,20 @@ bool BIImport::runOnModule(Module &M)
         }
     };
 
-    for (auto &func : M)
+    bool useCallGraph =
+        IGC_IS_FLAG_ENABLED(EnableBiFCallGraphSummary) &&
+        m_GenericCallGraph && (!m_SizeModule || m_SizeCallGraph);
+
+    if (useCallGraph)
     {
-        Explore(&func);
+        MaterializeFromCallGraph(M);
+    }
+    else
+    {
+        for (auto &func : M)
+        {
+            Explore(&func);
+        }
     }
 
     // nuke the unused functions so we can materializeAll() quickly
@@ -672,6 +689,48 @@ void BIImport::GetCalledFunctions(const Function* pFunc, TFunctionsVec& calledFu
     }
 }
 
+void BIImport::MaterializeFromCallGraph(Module &M)
+{
+    // The roots are the builtins the kernel module calls; the summaries give
+    // everything they reach, so no builtin body has to be walked.
+    std::vector<StringRef> roots;
+    for (auto &func : M)
+    {
+        if (func.isDeclaration()) continue;
+
+        TFunctionsVec calledFuncs;
+        GetCalledFunctions(&func, calledFuncs);
+        for (auto *pCallee : calledFuncs)
+        {
+            if (pCallee->isDeclaration())
+            {
+                roots.push_back(pCallee->getName());
+            }
+        }
+    }
+
+    const BiFCallGraphSummary* summaries[] = { m_GenericCallGraph, m_SizeCallGraph };
+    StringSet<> closure;
+    BiFCallGraphSummary::getClosure(
+        makeArrayRef(summaries, m_SizeModule ? 2 : 1), roots, closure);
+
+    for (auto &entry : closure)
+    {
+        Function* pFunc = GetBuiltinFunction2(entry.getKey());
+        if (!pFunc || !pFunc->isMaterializable()) continue;
+
+        if (Error Err = pFunc->materialize()) {
+            handleAllErrors(std::move(Err), [&](ErrorInfoBase &EIB) {
+                errs() << "===> Materialize Failure: " << EIB.message().c_str() << '\n';
+            });
+            assert(0 && "Failed to materialize Global Variables");
+        }
+        else {
+            pFunc->addAttribute(IGCLLVM::AttributeSet::FunctionIndex, llvm::Attribute::Builtin);
+        }
+    }
+}
+
 void BIImport::removeFunctionBitcasts(Module &M)
 {
     std::vector<Instruction*> list_delete;
@@ -793,6 +852,8 @@ void BIImport::InitializeBIFlags(Module &M)
     initializeVarWithValue("__FastRelaxedMath", MD.compOpt.RelaxedBuiltins ? 1 : 0);
     initializeVarWithValue("__UseNative64BitSubgroupBuiltin",
         pCtx->platform.hasNo64BitInst() ? 0 : 1);
+    initializeVarWithValue("__UseNativeWorkGroupReduceScan",
+        IGC_IS_FLAG_ENABLED(EnableNativeWorkGroupReduceScan) ? 1 : 0);
     initializeVarWithValue("__CRMacros",
         pCtx->platform.hasCorrectlyRoundedMacros() ? 1 : 0);
 
@@ -818,9 +879,12 @@ void BIImport::InitializeBIFlags(Module &M)
 
 extern "C" llvm::ModulePass *createBuiltInImportPass(
     std::unique_ptr<Module> pGenericModule,
-    std::unique_ptr<Module> pSizeModule)
+    std::unique_ptr<Module> pSizeModule,
+    const BiFCallGraphSummary* pGenericCallGraph,
+    const BiFCallGraphSummary* pSizeCallGraph)
 {
-    return new BIImport(std::move(pGenericModule), std::move(pSizeModule));
+    return new BIImport(std::move(pGenericModule), std::move(pSizeModule),
+        pGenericCallGraph, pSizeCallGraph);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
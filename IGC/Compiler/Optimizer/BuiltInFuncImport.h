@@ -33,6 +33,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/LLVMWarningsPop.hpp"
 
 #include "AdaptorOCL/CLElfLib/ElfReader.h"
+#include "Compiler/Optimizer/BiFCallGraphSummary.hpp"
 
 #include <vector>
 #include <set>
@@ -52,8 +53,12 @@ namespace IGC
         static char ID;
 
         /// @brief Constructor
+        /// The call graph summaries are optional. When present for every given
+        /// module, the import set is resolved from them in one go.
         BIImport(std::unique_ptr<llvm::Module> pGenericModule = nullptr,
-            std::unique_ptr<llvm::Module> pSizeModule = nullptr);
+            std::unique_ptr<llvm::Module> pSizeModule = nullptr,
+            const BiFCallGraphSummary* pGenericCallGraph = nullptr,
+            const BiFCallGraphSummary* pSizeCallGraph = nullptr);
 
         /// @brief analyses used
         virtual void getAnalysisUsage(llvm::AnalysisUsage &AU) const override
@@ -81,6 +86,10 @@ namespace IGC
         /// @param [OUT] calledFuncs The list of all functions called by pFunc.
         static void GetCalledFunctions(const llvm::Function* pFunc, TFunctionsVec& calledFuncs);
 
+        /// @brief  Materialize every builtin reachable from M, using the call graph
+        ///         summaries instead of exploring the materialized bodies.
+        void MaterializeFromCallGraph(llvm::Module &M);
+
         /// @brief  Remove function bitcasts that sometimes may appear due to the changed in the way
         ///         the BiFs are linked. We can remove this code once llvm implements typeless pointers.
         void removeFunctionBitcasts(llvm::Module &M);
@@ -101,12 +110,16 @@ namespace IGC
         /// Builtin module - contains the source function definition to import
 		std::unique_ptr<llvm::Module> m_GenericModule;
         std::unique_ptr<llvm::Module> m_SizeModule;
+        const BiFCallGraphSummary* m_GenericCallGraph;
+        const BiFCallGraphSummary* m_SizeCallGraph;
     };
 
 } // namespace IGC
 
 extern "C" llvm::ModulePass *createBuiltInImportPass(
-    std::unique_ptr<llvm::Module> pGenericModule, std::unique_ptr<llvm::Module> pSizeModule);
+    std::unique_ptr<llvm::Module> pGenericModule, std::unique_ptr<llvm::Module> pSizeModule,
+    const IGC::BiFCallGraphSummary* pGenericCallGraph = nullptr,
+    const IGC::BiFCallGraphSummary* pSizeCallGraph = nullptr);
 
 namespace IGC
 {
@@ -70,6 +70,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //===----------------------------------------------------------------------===//
 
 #include "Compiler/IGCPassSupport.h"
+#include "Compiler/CodeGenContextWrapper.hpp"
+#include "common/igc_regkeys.hpp"
 
 #include "common/LLVMWarningsPush.hpp"
 #include "../IGCInstructionCombining.hpp"
@@ -80,6 +82,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "llvm/ADT/APInt.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/None.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
@@ -3289,11 +3292,56 @@ static bool prepareICWorklistFromFunction(Function &F, const DataLayout &DL,
   return MadeIRChange;
 }
 
+/// Hash the contents of a block: opcodes, types, operands and flags of its
+/// instructions. Used to detect blocks changed since the last fixed point.
+static size_t hashBlock(const BasicBlock &BB) {
+  hash_code H = hash_value(&BB);
+  for (const Instruction &I : BB) {
+    H = hash_combine(H, I.getOpcode(), I.getType(),
+                     I.getRawSubclassOptionalData());
+    if (auto *CI = dyn_cast<CmpInst>(&I))
+      H = hash_combine(H, CI->getPredicate());
+    for (const Use &U : I.operands())
+      H = hash_combine(H, U.get());
+  }
+  return H;
+}
+
+/// Populate the IC worklist only with the instructions of the blocks that
+/// changed since the last fixed point, and with their users. Returns false if
+/// nothing changed.
+static bool prepareICWorklistIncremental(
+    Function &F, const DenseMap<const BasicBlock *, size_t> &BlockHashes,
+    InstCombineWorklist &ICWorklist) {
+  SmallPtrSet<Instruction *, 128> Seen;
+  SmallVector<Instruction *, 128> InstrsForInstCombineWorklist;
+  for (BasicBlock &BB : F) {
+    auto It = BlockHashes.find(&BB);
+    if (It != BlockHashes.end() && It->second == hashBlock(BB))
+      continue;
+    for (Instruction &I : BB) {
+      if (!isa<DbgInfoIntrinsic>(I) && Seen.insert(&I).second)
+        InstrsForInstCombineWorklist.push_back(&I);
+      for (User *U : I.users()) {
+        auto *UI = dyn_cast<Instruction>(U);
+        if (UI && !isa<DbgInfoIntrinsic>(UI) && Seen.insert(UI).second)
+          InstrsForInstCombineWorklist.push_back(UI);
+      }
+    }
+  }
+  if (InstrsForInstCombineWorklist.empty())
+    return false;
+
+  ICWorklist.AddInitialGroup(InstrsForInstCombineWorklist);
+  return true;
+}
+
 static bool combineInstructionsOverFunction(
     Function &F, InstCombineWorklist &Worklist, AliasAnalysis *AA,
     AssumptionCache &AC, TargetLibraryInfo &TLI, DominatorTree &DT,
     OptimizationRemarkEmitter &ORE, bool ExpensiveCombines = true,
-    LoopInfo *LI = nullptr) {
+    LoopInfo *LI = nullptr,
+    DenseMap<const BasicBlock *, size_t> *BlockHashes = nullptr) {
   auto &DL = F.getParent()->getDataLayout();
   ExpensiveCombines |= EnableExpensiveCombines;
 
@@ -3313,6 +3361,10 @@ static bool combineInstructionsOverFunction(
   if (ShouldLowerDbgDeclare)
     MadeIRChange = LowerDbgDeclare(F);
 
+  // Only the first run over a function needs to look at all of it, later
+  // runs start from the blocks changed since the previous fixed point.
+  bool Incremental = BlockHashes && BlockHashes->count(&F.getEntryBlock());
+
   // Iterate while there is work to do.
   int Iteration = 0;
   while (true) {
@@ -3320,7 +3372,12 @@ static bool combineInstructionsOverFunction(
     LLVM_DEBUG(dbgs() << "\n\nINSTCOMBINE ITERATION #" << Iteration << " on "
                       << F.getName() << "\n");
 
-    MadeIRChange |= prepareICWorklistFromFunction(F, DL, &TLI, Worklist);
+    if (Incremental) {
+      if (!prepareICWorklistIncremental(F, *BlockHashes, Worklist))
+        break;
+    } else {
+      MadeIRChange |= prepareICWorklistFromFunction(F, DL, &TLI, Worklist);
+    }
 
     InstCombiner IC(Worklist, Builder, F.optForMinSize(), ExpensiveCombines, AA,
                     AC, TLI, DT, ORE, DL, LI);
@@ -3330,6 +3387,11 @@ static bool combineInstructionsOverFunction(
       break;
   }
 
+  if (BlockHashes) {
+    for (BasicBlock &BB : F)
+      (*BlockHashes)[&BB] = hashBlock(BB);
+  }
+
   return MadeIRChange || Iteration > 1;
 }
 
@@ -3360,8 +3422,13 @@ namespace IGC {
         // Optional analyses.
         auto *LIWP = getAnalysisIfAvailable<LoopInfoWrapperPass>();
         auto *LI = LIWP ? &LIWP->getLoopInfo() : nullptr;
+        DenseMap<const BasicBlock *, size_t> *BlockHashes = nullptr;
+        if (IGC_IS_FLAG_ENABLED(EnableIncrementalInstCombine)) {
+            if (auto *CGCW = getAnalysisIfAvailable<CodeGenContextWrapper>())
+                BlockHashes = &CGCW->getCodeGenContext()->m_instCombineBlockHashes;
+        }
         return combineInstructionsOverFunction(F, Worklist, AA, AC, TLI, DT,
-            ORE, ExpensiveCombines, LI);
+            ORE, ExpensiveCombines, LI, BlockHashes);
     }
 
     char IGCInstructionCombiningPass::ID = 0;
@@ -29,6 +29,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/CodeGenPublic.h"
 #include "Compiler/WorkaroundAnalysisPass.h"
 #include "Compiler/CISACodeGen/ShaderCodeGen.hpp"
+#include "Compiler/CISACodeGen/RegisterEstimator.hpp"
 
 #include <set>
 
@@ -59,6 +60,10 @@ public:
     void getAnalysisUsage(llvm::AnalysisUsage &AU) const
     {
         AU.addRequired<CodeGenContextWrapper>();
+        if (IGC_IS_FLAG_ENABLED(EnableLd2dmsClubbingCostModel))
+        {
+            AU.addRequired<RegisterEstimator>();
+        }
     }
     virtual llvm::StringRef getPassName() const
     {
@@ -69,6 +74,14 @@ public:
     bool m_changed;
 
 private:
+    // GRF pressure of each block before any of them is split
+    llvm::DenseMap<llvm::BasicBlock*, uint32_t> m_BBPressure;
+
+    int getClubbingThreshold(
+        llvm::BasicBlock* BB,
+        const std::vector<LdmsInstrinsic*>& ldmsInstsToMove,
+        CodeGenContext* ctx) const;
+
     bool shaderSamplesCompressedSurfaces(CodeGenContext *ctx)
     {
         ModuleMetaData *modMD = ctx->getModuleMetaData();
@@ -94,10 +107,48 @@ bool MCSOptimization::runOnFunction(Function &F)
         return false;
     }
     m_changed = false;
+    m_BBPressure.clear();
+    if (IGC_IS_FLAG_ENABLED(EnableLd2dmsClubbingCostModel))
+    {
+        // the estimate is stale as soon as blocks get split, so record it upfront
+        RegisterEstimator* RPE = &getAnalysis<RegisterEstimator>();
+        RPE->calculate();
+        for (auto& BB : F)
+        {
+            m_BBPressure[&BB] = RPE->getMaxLiveGRFAtBB(&BB);
+        }
+    }
     visit(F);
     return m_changed;
 }
 
+/// Number of ld2dms to put under one MCS != 0 branch. When MCS is zero all
+/// samples hold the same value and only the first ld2dms is fetched, so the
+/// fewer branches the samples are split into, the more messages the fast
+/// path skips. But every ld2dms moved into the branch stays live from there
+/// to the join, so the group only grows as far as the free GRFs allow.
+int MCSOptimization::getClubbingThreshold(
+    BasicBlock* BB,
+    const std::vector<LdmsInstrinsic*>& ldmsInstsToMove,
+    CodeGenContext* ctx) const
+{
+    if (IGC_IS_FLAG_DISABLED(EnableLd2dmsClubbingCostModel) || ldmsInstsToMove.empty())
+    {
+        return IGC_GET_FLAG_VALUE(ld2dmsInstsClubbingThreshold);
+    }
+
+    RegisterEstimator* RPE = &getAnalysis<RegisterEstimator>();
+    auto PI = m_BBPressure.find(BB);
+    uint32_t pressure = PI != m_BBPressure.end() ? PI->second : 0;
+    uint32_t numGRF = ctx->getNumGRFPerThread();
+    uint32_t freeGRF = numGRF > pressure ? numGRF - pressure : 0;
+    uint32_t ldmsGRF = std::max<uint32_t>(1, RPE->getNumGRFOfValue(ldmsInstsToMove[0]));
+
+    int numSamples = static_cast<int>(ldmsInstsToMove.size());
+    int threshold = static_cast<int>(freeGRF / ldmsGRF);
+    return std::max(1, std::min(threshold, numSamples));
+}
+
 void MCSOptimization::visitCallInst(llvm::CallInst &I)
 {
     Function* F = I.getParent()->getParent();
@@ -216,7 +267,7 @@ void MCSOptimization::visitCallInst(llvm::CallInst &I)
 
                 //this is added because clubbing all ld2dms into a single then block
                 //increases register pressure and causes spilling
-                int instClubThreshold = IGC_GET_FLAG_VALUE(ld2dmsInstsClubbingThreshold); //# ld2dms insts that can be moved into the then block
+                int instClubThreshold = getClubbingThreshold(BB, ldmsInstsToMove, ctx); //# ld2dms insts that can be moved into the then block
                 //int instClubThreshold = 2;
                 bool allInstsWillBeMoved = false;
 
@@ -294,6 +345,8 @@ namespace IGC {
 #define PASS_CFG_ONLY false
 #define PASS_ANALYSIS true
     IGC_INITIALIZE_PASS_BEGIN(MCSOptimization, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+    IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+    IGC_INITIALIZE_PASS_DEPENDENCY(RegisterEstimator)
     IGC_INITIALIZE_PASS_END(MCSOptimization, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
 
 FunctionPass* CreateMCSOptimization()
@@ -49,7 +49,7 @@ IGC_INITIALIZE_PASS_END(BuiltinsConverter, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG
 char BuiltinsConverter::ID = 0;
 
 
-BuiltinsConverter::BuiltinsConverter(void) : FunctionPass(ID)
+BuiltinsConverter::BuiltinsConverter(void) : FunctionPass(ID), m_nextSampler(0)
 {
     initializeBuiltinsConverterPass(*PassRegistry::getPassRegistry());
 }
@@ -110,8 +110,11 @@ bool BuiltinsConverter::runOnFunction(Function &F)
     if (!fillIndexMap(F))
         return false;
     
-    CBuiltinsResolver resolve(&m_argIndexMap, &m_inlineIndexMap, &m_nextSampler, ctx);
-    m_pResolve = &resolve;
+    if (!m_pResolve || m_pResolveModule != F.getParent())
+    {
+        m_pResolve.reset(new CBuiltinsResolver(&m_argIndexMap, &m_inlineIndexMap, &m_nextSampler, ctx));
+        m_pResolveModule = F.getParent();
+    }
     visit(F);
     return true;
 }
@@ -72,7 +72,10 @@ namespace IGC
         CImagesBI::InlineMap m_inlineIndexMap;
         int m_nextSampler;
 
-        CBuiltinsResolver* m_pResolve;
+        // Built on the first kernel of a module and reused for the others;
+        // the commands only keep pointers to the per-kernel maps above.
+        std::unique_ptr<CBuiltinsResolver> m_pResolve;
+        llvm::Module* m_pResolveModule = nullptr;
     };
 
 } // namespace IGC
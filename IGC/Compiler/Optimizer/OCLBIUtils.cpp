@@ -28,6 +28,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/CISACodeGen/helper.h"
 #include "Compiler/MetaDataApi/MetaDataApi.h"
 #include "Compiler/DebugInfo/DebugInfoUtils.hpp"
+#include "common/igc_regkeys.hpp"
 
 #include "common/LLVMWarningsPush.hpp"
 
@@ -199,6 +200,8 @@ void CImagesBI::verifiyCommand(CodeGenContext* context)
     if(m_IncorrectBti)
     {
         context->EmitError("Inconsistent use of image!");
+        // The command is reused for the other calls of the module.
+        m_IncorrectBti = false;
     }
 }
 
@@ -707,7 +710,7 @@ bool CImagesBI::derivedFromInt(const Value * pVal)
 class COCL_sample : public CImagesBI
 {
 public:
-    COCL_sample(ParamMap* paramMap, InlineMap* inlineMap, int* nextSampler, Dimension Dim, MetaDataUtils* pMdUtils) : CImagesBI(paramMap, inlineMap, nextSampler, Dim), m_pMdUtils(pMdUtils) {}
+    COCL_sample(ParamMap* paramMap, InlineMap* inlineMap, int* nextSampler, Dimension Dim, MetaDataUtils* pMdUtils, ModuleMetaData* pModMD) : CImagesBI(paramMap, inlineMap, nextSampler, Dim), m_pMdUtils(pMdUtils), m_pModMD(pModMD) {}
 
     ConstantInt* getSamplerIndex(void)
     {
@@ -978,6 +981,7 @@ public:
 
 protected:
     MetaDataUtils *m_pMdUtils;
+    ModuleMetaData *m_pModMD;
     Value* m_gradXX;
     Value* m_gradXY;
     Value* m_gradXZ;
@@ -989,10 +993,15 @@ protected:
 class COCL_sample_l: public COCL_sample 
 {
 public:
-	COCL_sample_l(ParamMap* paramMap, InlineMap* inlineMap, int* nextSampler, Dimension Dim, MetaDataUtils* pMdUtils) : COCL_sample(paramMap, inlineMap, nextSampler, Dim, pMdUtils) {}
+	COCL_sample_l(ParamMap* paramMap, InlineMap* inlineMap, int* nextSampler, Dimension Dim, MetaDataUtils* pMdUtils, ModuleMetaData* pModMD) : COCL_sample(paramMap, inlineMap, nextSampler, Dim, pMdUtils, pModMD) {}
 
     void createIntrinsic()
     {
+        if (IGC_IS_FLAG_ENABLED(EnableSamplerFreeImageReads) && tryLowerToLoad())
+        {
+            return;
+        }
+
         Value* Coord = m_pCallInst->getOperand(2);
         m_args.push_back(m_pCallInst->getOperand(3)); // lod
         prepareCoords(m_dim, Coord, m_pFloatZero);
@@ -1006,12 +1015,132 @@ public:
         Type* types[] = {m_pCallInst->getType(), m_pFloatType, m_args[5]->getType(), m_args[6]->getType() };
         replaceGenISACallInst(GenISAIntrinsic::GenISA_sampleLptr, types);
     }
+
+private:
+    /// @brief  Replaces the sample with an ld when the inline sampler makes them
+    ///         equivalent: unnormalized coordinates, nearest filtering, lod 0 and
+    ///         either no address mode or clamp-to-edge on an image whose extents
+    ///         the runtime fixed at compile time.
+    /// @returns true if the call was lowered
+    bool tryLowerToLoad()
+    {
+        // array layers are rounded to the nearest index rather than floored
+        if (m_dim != DIM_1D && m_dim != DIM_2D && m_dim != DIM_3D)
+        {
+            return false;
+        }
+
+        ConstantFP* lod = dyn_cast<ConstantFP>(m_pCallInst->getOperand(3));
+        ConstantInt* sampler = dyn_cast_or_null<ConstantInt>(
+            CImagesBI::CImagesUtils::traceImageOrSamplerArgument(m_pCallInst, 1, m_pMdUtils));
+        if (!lod || !lod->isZero() || !sampler)
+        {
+            return false;
+        }
+
+        InlineSamplerMetaDataHandle samplerMD = InlineSamplerMetaDataHandle(InlineSamplerMetaData::get());
+        CreateInlineSamplerAnnotations(samplerMD, int_cast<int>(sampler->getZExtValue()));
+        if (samplerMD->getNormalizedCoords() != LEGACY_CLK_NORMALIZED_COORDS_FALSE ||
+            samplerMD->getMinFilterType() != iOpenCL::SAMPLER_MAPFILTER_POINT ||
+            samplerMD->getMagFilterType() != iOpenCL::SAMPLER_MAPFILTER_POINT)
+        {
+            return false;
+        }
+
+        // ld returns zero out of bounds, so clamp-to-edge is only equivalent
+        // once the coordinates are clamped to the image
+        const ImageQueryInfoMD* extents = nullptr;
+        if (samplerMD->getAddressMode() == LEGACY_CLK_ADDRESS_CLAMP_TO_EDGE)
+        {
+            extents = getKnownImageExtents();
+            if (!extents)
+            {
+                return false;
+            }
+        }
+        else if (samplerMD->getAddressMode() != LEGACY_CLK_ADDRESS_NONE)
+        {
+            return false;
+        }
+
+        prepareCoords(m_dim, m_pCallInst->getOperand(2), m_pFloatZero);
+        m_args.push_back(getTexelCoord(CoordX, extents ? extents->width : 0));
+        m_args.push_back(getTexelCoord(CoordY, extents ? extents->height : 0));
+        m_args.push_back(m_pIntZero); // LOD
+        m_args.push_back(getTexelCoord(CoordZ, extents ? extents->depth : 0));
+        Value* pDstBuffer = createGetBufferPtr();
+        prepareZeroOffsets();
+        Type* types[] = { m_pCallInst->getType(), pDstBuffer->getType() };
+        replaceGenISACallInst(GenISAIntrinsic::GenISA_ldptr, types);
+        return true;
+    }
+
+    /// @brief  Returns the runtime-provided extents of the sampled image, if all
+    ///         the dimensions this read uses are known.
+    const ImageQueryInfoMD* getKnownImageExtents()
+    {
+        Argument* image = dyn_cast_or_null<Argument>(
+            CImagesBI::CImagesUtils::traceImageOrSamplerArgument(m_pCallInst, 0));
+        if (!image || !m_pModMD)
+        {
+            return nullptr;
+        }
+        auto funcMD = m_pModMD->FuncMD.find(m_pFunc);
+        if (funcMD == m_pModMD->FuncMD.end())
+        {
+            return nullptr;
+        }
+        auto info = funcMD->second.knownImageQueries.find(image->getArgNo());
+        if (info == funcMD->second.knownImageQueries.end())
+        {
+            return nullptr;
+        }
+        const ImageQueryInfoMD& extents = info->second;
+        bool known = extents.width > 0 &&
+            (m_dim == DIM_1D || extents.height > 0) &&
+            (m_dim != DIM_3D || extents.depth > 0);
+        return known ? &extents : nullptr;
+    }
+
+    /// @brief  Converts an unnormalized float coordinate to the texel nearest
+    ///         filtering picks, clamped to [0, size) when size is non-zero.
+    Value* getTexelCoord(Value* coord, int size)
+    {
+        if (coord == m_pFloatZero)
+        {
+            return m_pIntZero;
+        }
+
+        IGCLLVM::IRBuilder<> builder(m_pCallInst);
+        builder.SetCurrentDebugLocation(m_DL);
+        Value* texel = nullptr;
+        if (SIToFPInst* intCoord = dyn_cast<SIToFPInst>(coord))
+        {
+            if (intCoord->getSrcTy() == m_pIntType)
+            {
+                // read_image with integer coordinates: no rounding to undo
+                texel = intCoord->getOperand(0);
+            }
+        }
+        if (!texel)
+        {
+            Value* floor = builder.CreateCall(getFunctionDeclaration(Intrinsic::floor, m_pFloatType), coord);
+            texel = builder.CreateFPToSI(floor, m_pIntType);
+        }
+        if (size > 0)
+        {
+            Value* maxTexel = ConstantInt::get(m_pIntType, size - 1);
+            texel = builder.CreateSelect(builder.CreateICmpSGT(texel, maxTexel), maxTexel, texel);
+            texel = builder.CreateSelect(builder.CreateICmpSLT(texel, m_pIntZero), m_pIntZero, texel);
+        }
+        return texel;
+    }
 };
 
 class COCL_sample_d: public COCL_sample 
 {
 public:
-	COCL_sample_d(ParamMap* paramMap, InlineMap* inlineMap, int* nextSampler, Dimension Dim, MetaDataUtils* pMdUtils) : COCL_sample(paramMap, inlineMap, nextSampler, Dim, pMdUtils) {}
+	COCL_sample_d(ParamMap* paramMap, InlineMap* inlineMap, int* nextSampler, Dimension Dim, MetaDataUtils* pMdUtils, ModuleMetaData* pModMD) : COCL_sample(paramMap, inlineMap, nextSampler, Dim, pMdUtils, pModMD) {}
 
     void createIntrinsic()
     {
@@ -1490,14 +1619,15 @@ std::unique_ptr<T> initImageClass(CImagesBI::ParamMap* paramMap, CImagesBI::Inli
 
 template <typename T>
 std::unique_ptr<T> initSamplerClass(CImagesBI::ParamMap* paramMap, CImagesBI::InlineMap* inlineMap, 
-                                  int* nextSampler, CImagesBI::Dimension dim, MetaDataUtils* pMdUtils)
+                                  int* nextSampler, CImagesBI::Dimension dim, MetaDataUtils* pMdUtils, ModuleMetaData* modMD)
 {
-    return std::unique_ptr<T>(new T(paramMap, inlineMap, nextSampler, dim, pMdUtils));
+    return std::unique_ptr<T>(new T(paramMap, inlineMap, nextSampler, dim, pMdUtils, modMD));
 }
 
 CBuiltinsResolver::CBuiltinsResolver(CImagesBI::ParamMap* paramMap, CImagesBI::InlineMap* inlineMap, int* nextSampler, CodeGenContext* ctx) : m_CodeGenContext(ctx)
 {
     MetaDataUtils* pMdUtils = ctx->getMetaDataUtils();
+    ModuleMetaData* modMD = ctx->getModuleMetaData();
     // Images Built-ins
     // Read_Image builtins
     m_CommandMap["__builtin_IB_OCL_1d_ldui"]        = initImageClass<COCL_ldui>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_1D);
@@ -1516,26 +1646,26 @@ CBuiltinsResolver::CBuiltinsResolver(CImagesBI::ParamMap* paramMap, CImagesBI::I
     m_CommandMap["__builtin_IB_OCL_2darr_ld2dms"]   = initImageClass<COCL_ld2dms>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_2D_ARRAY);
     m_CommandMap["__builtin_IB_OCL_2d_ld2dmsui"]    = initImageClass<COCL_ld2dmsui>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_2D);
     m_CommandMap["__builtin_IB_OCL_2darr_ld2dmsui"] = initImageClass<COCL_ld2dmsui>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_2D_ARRAY);
-	m_CommandMap["__builtin_IB_OCL_1d_sample_l"] = initSamplerClass<COCL_sample_l>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_1D, pMdUtils);
-    m_CommandMap["__builtin_IB_OCL_1darr_sample_l"] = initSamplerClass<COCL_sample_l>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_1D_ARRAY, pMdUtils);
-	m_CommandMap["__builtin_IB_OCL_2d_sample_l"] = initSamplerClass<COCL_sample_l>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_2D, pMdUtils);
-    m_CommandMap["__builtin_IB_OCL_2darr_sample_l"] = initSamplerClass<COCL_sample_l>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_2D_ARRAY, pMdUtils);
-	m_CommandMap["__builtin_IB_OCL_3d_sample_l"] = initSamplerClass<COCL_sample_l>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_3D, pMdUtils);
-	m_CommandMap["__builtin_IB_OCL_1d_sample_d"] = initSamplerClass<COCL_sample_d>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_1D, pMdUtils);
-    m_CommandMap["__builtin_IB_OCL_1darr_sample_d"] = initSamplerClass<COCL_sample_d>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_1D_ARRAY, pMdUtils);
-	m_CommandMap["__builtin_IB_OCL_2d_sample_d"] = initSamplerClass<COCL_sample_d>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_2D, pMdUtils);
-    m_CommandMap["__builtin_IB_OCL_2darr_sample_d"] = initSamplerClass<COCL_sample_d>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_2D_ARRAY, pMdUtils);
-	m_CommandMap["__builtin_IB_OCL_3d_sample_d"] = initSamplerClass<COCL_sample_d>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_3D, pMdUtils);
-    m_CommandMap["__builtin_IB_OCL_1d_sample_lui"] = initSamplerClass<COCL_sample_l>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_1D, pMdUtils);
-    m_CommandMap["__builtin_IB_OCL_1darr_sample_lui"] = initSamplerClass<COCL_sample_l>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_1D_ARRAY, pMdUtils);
-    m_CommandMap["__builtin_IB_OCL_2d_sample_lui"] = initSamplerClass<COCL_sample_l>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_2D, pMdUtils);
-    m_CommandMap["__builtin_IB_OCL_2darr_sample_lui"] = initSamplerClass<COCL_sample_l>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_2D_ARRAY, pMdUtils);
-    m_CommandMap["__builtin_IB_OCL_3d_sample_lui"] = initSamplerClass<COCL_sample_l>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_3D, pMdUtils);
-    m_CommandMap["__builtin_IB_OCL_1d_sample_dui"] = initSamplerClass<COCL_sample_d>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_1D, pMdUtils);
-    m_CommandMap["__builtin_IB_OCL_1darr_sample_dui"] = initSamplerClass<COCL_sample_d>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_1D_ARRAY, pMdUtils);
-    m_CommandMap["__builtin_IB_OCL_2d_sample_dui"] = initSamplerClass<COCL_sample_d>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_2D, pMdUtils);
-    m_CommandMap["__builtin_IB_OCL_2darr_sample_dui"] = initSamplerClass<COCL_sample_d>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_2D_ARRAY, pMdUtils);
-    m_CommandMap["__builtin_IB_OCL_3d_sample_dui"] = initSamplerClass<COCL_sample_d>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_3D, pMdUtils);
+	m_CommandMap["__builtin_IB_OCL_1d_sample_l"] = initSamplerClass<COCL_sample_l>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_1D, pMdUtils, modMD);
+    m_CommandMap["__builtin_IB_OCL_1darr_sample_l"] = initSamplerClass<COCL_sample_l>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_1D_ARRAY, pMdUtils, modMD);
+	m_CommandMap["__builtin_IB_OCL_2d_sample_l"] = initSamplerClass<COCL_sample_l>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_2D, pMdUtils, modMD);
+    m_CommandMap["__builtin_IB_OCL_2darr_sample_l"] = initSamplerClass<COCL_sample_l>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_2D_ARRAY, pMdUtils, modMD);
+	m_CommandMap["__builtin_IB_OCL_3d_sample_l"] = initSamplerClass<COCL_sample_l>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_3D, pMdUtils, modMD);
+	m_CommandMap["__builtin_IB_OCL_1d_sample_d"] = initSamplerClass<COCL_sample_d>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_1D, pMdUtils, modMD);
+    m_CommandMap["__builtin_IB_OCL_1darr_sample_d"] = initSamplerClass<COCL_sample_d>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_1D_ARRAY, pMdUtils, modMD);
+	m_CommandMap["__builtin_IB_OCL_2d_sample_d"] = initSamplerClass<COCL_sample_d>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_2D, pMdUtils, modMD);
+    m_CommandMap["__builtin_IB_OCL_2darr_sample_d"] = initSamplerClass<COCL_sample_d>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_2D_ARRAY, pMdUtils, modMD);
+	m_CommandMap["__builtin_IB_OCL_3d_sample_d"] = initSamplerClass<COCL_sample_d>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_3D, pMdUtils, modMD);
+    m_CommandMap["__builtin_IB_OCL_1d_sample_lui"] = initSamplerClass<COCL_sample_l>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_1D, pMdUtils, modMD);
+    m_CommandMap["__builtin_IB_OCL_1darr_sample_lui"] = initSamplerClass<COCL_sample_l>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_1D_ARRAY, pMdUtils, modMD);
+    m_CommandMap["__builtin_IB_OCL_2d_sample_lui"] = initSamplerClass<COCL_sample_l>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_2D, pMdUtils, modMD);
+    m_CommandMap["__builtin_IB_OCL_2darr_sample_lui"] = initSamplerClass<COCL_sample_l>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_2D_ARRAY, pMdUtils, modMD);
+    m_CommandMap["__builtin_IB_OCL_3d_sample_lui"] = initSamplerClass<COCL_sample_l>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_3D, pMdUtils, modMD);
+    m_CommandMap["__builtin_IB_OCL_1d_sample_dui"] = initSamplerClass<COCL_sample_d>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_1D, pMdUtils, modMD);
+    m_CommandMap["__builtin_IB_OCL_1darr_sample_dui"] = initSamplerClass<COCL_sample_d>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_1D_ARRAY, pMdUtils, modMD);
+    m_CommandMap["__builtin_IB_OCL_2d_sample_dui"] = initSamplerClass<COCL_sample_d>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_2D, pMdUtils, modMD);
+    m_CommandMap["__builtin_IB_OCL_2darr_sample_dui"] = initSamplerClass<COCL_sample_d>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_2D_ARRAY, pMdUtils, modMD);
+    m_CommandMap["__builtin_IB_OCL_3d_sample_dui"] = initSamplerClass<COCL_sample_d>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_3D, pMdUtils, modMD);
 
     // Write Image
     m_CommandMap["__builtin_IB_write_1d_ui"]    = initImageClass<CWrite>(paramMap, inlineMap, nextSampler, CImagesBI::Dimension::DIM_1D);
@@ -1837,13 +1967,19 @@ bool CBuiltinsResolver::resolveBI(CallInst* Inst)
 {
     Function* callee = Inst->getCalledFunction();
     StringRef calleeName = callee->getName();
+    // Every builtin in the map is an external __builtin_IB_* declaration.
+    if (!callee->isDeclaration() || !calleeName.startswith("__builtin_IB_"))
+    {
+        return false;
+    }
     //Check if it exists in the map.
-    if(!m_CommandMap.count(calleeName))
+    auto it = m_CommandMap.find(calleeName);
+    if (it == m_CommandMap.end())
     {
         return false;
     }
-    m_CommandMap[calleeName]->execute(Inst);
-    m_CommandMap[calleeName]->verifiyCommand(m_CodeGenContext);
+    it->second->execute(Inst);
+    it->second->verifiyCommand(m_CodeGenContext);
 
     return true;
 }
@@ -31,6 +31,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/ADT/StringRef.h>
+#include <llvm/ADT/StringMap.h>
 #include "common/LLVMWarningsPop.hpp"
 #include "GenISAIntrinsics/GenIntrinsics.h"
 #include <map>
@@ -255,7 +256,7 @@ namespace IGC
     class CBuiltinsResolver
     {
     private:
-        std::map<llvm::StringRef, std::unique_ptr<CCommand>> m_CommandMap;
+        llvm::StringMap<std::unique_ptr<CCommand>> m_CommandMap;
 
         // the list of known builtins not to be resolved
         std::vector<llvm::StringRef> m_KnownBuiltins;
@@ -26,9 +26,12 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "Compiler/Optimizer/OpenCLPasses/AggregateArguments/AggregateArguments.hpp"
 #include "Compiler/IGCPassSupport.h"
+#include "common/igc_regkeys.hpp"
 
 #include "common/LLVMWarningsPush.hpp"
 #include "llvmWrapper/IR/Function.h"
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Operator.h>
 #include "common/LLVMWarningsPop.hpp"
 
 using namespace llvm;
@@ -109,6 +112,13 @@ bool AggregateArgumentsAnalysis::runOnFunction(Function &F)
 
         Type* type = arg->getType()->getPointerElementType();
         assert(m_pDL->getStructLayout(cast<StructType>(type))->getSizeInBytes() < UINT_MAX);
+
+        // When every use of the argument is a load at a known offset, fields
+        // that are never read need not be passed in the payload at all.
+        m_accessedRanges.clear();
+        m_pruneFields = IGC_IS_FLAG_ENABLED(EnableAggregateArgPruning) &&
+            collectAccessedRanges(arg, 0);
+
         addImplictArgs(type, 0);
         ImplicitArgs::addStructArgs(F, arg, m_argList, getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils());
         changed = true;
@@ -202,10 +212,76 @@ void AggregateArgumentsAnalysis::addImplictArgs(Type* type, uint64_t baseAllocaO
             break;
         };
 
+        if (!isAccessed(baseAllocaOffset, m_pDL->getTypeStoreSize(type)))
+        {
+            // never read by the kernel, leave it out of the payload
+            return;
+        }
+
         m_argList.push_back(ImplicitArg::StructArgElement(implicitArgType, static_cast<unsigned int>(baseAllocaOffset)));
     }
 }
 
+// Records the byte ranges of the struct argument read through ptr, which
+// points at the given offset inside the struct.  Returns false if some use
+// cannot be analyzed, in which case all fields must be kept.
+bool AggregateArgumentsAnalysis::collectAccessedRanges(Value* ptr, int64_t offset)
+{
+    for (User* user : ptr->users())
+    {
+        if (LoadInst* load = dyn_cast<LoadInst>(user))
+        {
+            if (load->isVolatile())
+            {
+                return false;
+            }
+            int64_t size = m_pDL->getTypeStoreSize(load->getType());
+            m_accessedRanges.push_back(std::make_pair(offset, offset + size));
+        }
+        else if (GEPOperator* gep = dyn_cast<GEPOperator>(user))
+        {
+            APInt gepOffset(m_pDL->getPointerSizeInBits(gep->getPointerAddressSpace()), 0);
+            if (gep->getPointerOperand() != ptr ||
+                !gep->accumulateConstantOffset(*m_pDL, gepOffset) ||
+                !collectAccessedRanges(gep, offset + gepOffset.getSExtValue()))
+            {
+                return false;
+            }
+        }
+        else if (BitCastOperator* bitcast = dyn_cast<BitCastOperator>(user))
+        {
+            if (!collectAccessedRanges(bitcast, offset))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            // stores, calls, memcpy, pointer escapes...
+            return false;
+        }
+    }
+    return true;
+}
+
+bool AggregateArgumentsAnalysis::isAccessed(uint64_t offset, uint64_t size) const
+{
+    if (!m_pruneFields)
+    {
+        return true;
+    }
+    int64_t start = static_cast<int64_t>(offset);
+    int64_t end = static_cast<int64_t>(offset + size);
+    for (auto& range : m_accessedRanges)
+    {
+        if (range.first < end && start < range.second)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 ResolveAggregateArguments::ResolveAggregateArguments() : FunctionPass(ID)
 {
     initializeResolveAggregateArgumentsPass(*PassRegistry::getPassRegistry());
@@ -32,6 +32,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/Pass.h>
 #include <llvm/IR/DataLayout.h>
 #include <llvm/IR/IRBuilder.h>
+#include <llvm/ADT/SmallVector.h>
 #include "common/LLVMWarningsPop.hpp"
 
 namespace IGC
@@ -62,11 +63,18 @@ namespace IGC
 
     private:
         void addImplictArgs(llvm::Type* type, uint64_t baseAllocaOffset);
+        bool collectAccessedRanges(llvm::Value* ptr, int64_t offset);
+        bool isAccessed(uint64_t offset, uint64_t size) const;
 
     private:
         const llvm::DataLayout* m_pDL;
         ImplicitArg::StructArgList m_argList;
 
+        // Byte ranges [first, second) of the current struct argument read by
+        // the kernel, only valid when m_pruneFields is set.
+        llvm::SmallVector<std::pair<int64_t, int64_t>, 16> m_accessedRanges;
+        bool m_pruneFields = false;
+
     };
 
     class ResolveAggregateArguments : public llvm::FunctionPass
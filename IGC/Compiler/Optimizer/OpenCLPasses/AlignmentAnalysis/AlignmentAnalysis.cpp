@@ -32,6 +32,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/IR/InstIterator.h>
 #include <llvm/Support/MathExtras.h>
 #include <llvm/IR/GetElementPtrTypeIterator.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/PatternMatch.h>
 #include "common/LLVMWarningsPop.hpp"
 
 #include <deque>
@@ -39,6 +41,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 using namespace llvm;
 using namespace IGC;
+using namespace llvm::PatternMatch;
 
 // Register pass to igc-opt
 #define PASS_FLAG "igc-fix-alignment"
@@ -58,6 +61,7 @@ AlignmentAnalysis::AlignmentAnalysis() : FunctionPass(ID)
 bool AlignmentAnalysis::runOnFunction(Function &F)
 {
     m_DL = &F.getParent()->getDataLayout();
+    collectAssumedAlignments(F);
 
     // The work-list queue for the data flow algorithm
     std::deque<Instruction*> workList;
@@ -129,6 +133,7 @@ bool AlignmentAnalysis::processInstruction(llvm::Instruction* I)
     {
         newAlign = visit(I);
     }
+    newAlign = iSTD::Max(newAlign, getAssumedAlignment(I));
 
     // The new alignment may not be better than the current one,
     // since we're only allowed to go in one direction in the lattice.
@@ -194,6 +199,79 @@ unsigned int AlignmentAnalysis::visitPHINode(PHINode &I)
     return newAlign;
 }
 
+void AlignmentAnalysis::collectAssumedAlignments(Function &F)
+{
+    m_assumedAlignMap.clear();
+    if( IGC_IS_FLAG_DISABLED(EnableUserAssumptions) || F.empty() )
+    {
+        return;
+    }
+
+    // The analysis is flow-insensitive, so an assumption is only taken when it
+    // covers every use of the pointer: it must sit in the entry block, and the
+    // pointer must not have been used before it (other than to test it).
+    std::set<Value*> usedBefore;
+    for( auto& I : F.getEntryBlock() )
+    {
+        Value* ptr = nullptr;
+        ConstantInt* mask = nullptr;
+        ICmpInst::Predicate pred;
+        auto* intrin = dyn_cast<IntrinsicInst>(&I);
+        if( intrin && intrin->getIntrinsicID() == Intrinsic::assume &&
+            match(intrin->getArgOperand(0),
+                m_ICmp(pred, m_And(m_PtrToInt(m_Value(ptr)), m_ConstantInt(mask)), m_Zero())) &&
+            pred == ICmpInst::ICMP_EQ &&
+            usedBefore.count(ptr) == 0 )
+        {
+            // (ptrtoint(p) & (A - 1)) == 0 states that p is A-aligned.
+            uint64_t maskVal = mask->getZExtValue();
+            if( isPowerOf2_64(maskVal + 1) )
+            {
+                unsigned int align = (unsigned int)iSTD::Min<uint64_t>(maskVal + 1, Value::MaximumAlignment);
+                m_assumedAlignMap[ptr] = iSTD::Max(m_assumedAlignMap[ptr], align);
+            }
+            continue;
+        }
+
+        if( isa<PtrToIntInst>(I) )
+        {
+            continue;
+        }
+        for( auto& op : I.operands() )
+        {
+            if( op->getType()->isPointerTy() )
+            {
+                usedBefore.insert(op);
+            }
+        }
+    }
+}
+
+unsigned int AlignmentAnalysis::getAssumedAlignment(Value *V) const
+{
+    if( IGC_IS_FLAG_DISABLED(EnableUserAssumptions) )
+    {
+        return 0;
+    }
+
+    unsigned int align = 0;
+    if( Argument* arg = dyn_cast<Argument>(V) )
+    {
+        // An 'align' attribute on a pointer argument is a promise of the source.
+        if( arg->getType()->isPointerTy() )
+        {
+            align = arg->getParamAlignment();
+        }
+    }
+
+    auto iter = m_assumedAlignMap.find(V);
+    if( iter != m_assumedAlignMap.end() )
+    {
+        align = iSTD::Max(align, iter->second);
+    }
+    return align;
+}
+
 void AlignmentAnalysis::SetInstAlignment(llvm::Instruction &I)
 {
     if(isa<LoadInst>(I))
@@ -511,7 +589,7 @@ unsigned int AlignmentAnalysis::getAlignValue(Value *V) const
             Type* pointedTo = arg->getType()->getPointerElementType();
             if( pointedTo->isSized() )
             {
-                return m_DL->getABITypeAlignment(pointedTo);
+                return iSTD::Max(m_DL->getABITypeAlignment(pointedTo), getAssumedAlignment(arg));
             }
             else
             {
@@ -519,7 +597,7 @@ unsigned int AlignmentAnalysis::getAlignValue(Value *V) const
                 // this is used to pass things like images around.
                 // Apparently, DataLayout being asked about the ABI alignment of opaque types.
                 // So, we don't.
-                return MinimumAlignment;
+                return iSTD::Max(MinimumAlignment, getAssumedAlignment(arg));
             }
         }
         else
@@ -94,6 +94,13 @@ namespace IGC
         void SetInstAlignment(llvm::MemCpyInst &I);
         void SetInstAlignment(llvm::MemMoveInst &I);
 
+        /// @brief Returns the alignment computed for V by the last run.
+        ///        Only valid for values that existed when the pass ran.
+        unsigned int getAlignment(llvm::Value *V) const
+        {
+            return getAlignValue(V);
+        }
+
     protected:
         /// @breif Evaluates the alignment of I based on its operands.
         ///        For Load and Store instructions, also sets the alignment
@@ -111,6 +118,17 @@ namespace IGC
         ///        except when C is 0, when it is the max alignment
         unsigned int getConstantAlignment(uint64_t C) const;
 
+        /// @brief Collects the alignment facts the user stated through
+        ///        llvm.assume (e.g. __builtin_assume_aligned) in the entry block.
+        void collectAssumedAlignments(llvm::Function &F);
+
+        /// @brief Returns the alignment promised for V by the source
+        ///        (an assumption or an 'align' parameter attribute), or 0.
+        unsigned int getAssumedAlignment(llvm::Value *V) const;
+
+        /// @brief Alignments promised by llvm.assume, keyed by pointer.
+        std::map<llvm::Value*, unsigned int> m_assumedAlignMap;
+
         /// @brief This map stores the known alignment of every value.
         std::map<llvm::Value*, unsigned int> m_alignmentMap;
 
@@ -39,6 +39,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/CodeGenPublicEnums.h"
 #include "Compiler/CISACodeGen/helper.h"
 #include "Compiler/CodeGenPublic.h"
+#include "common/igc_regkeys.hpp"
 
 #include "common/LLVMWarningsPush.hpp"
 
@@ -2530,6 +2531,41 @@ namespace //Anonymous
         uint64_t dispatcherArgIdx = 0;
         StoreInstBuilder storeBuilder(builder);
 
+        // The pointer and object argument mappings only depend on the block
+        // signature, so they can be precomputed and written with a single
+        // store each instead of one store per captured value.
+        const bool constMappings = IGC_IS_FLAG_ENABLED(EnableDeviceEnqueueConstDescriptor);
+        if (constMappings)
+        {
+            SmallVector<uint32_t, 8> ptrMap;
+            SmallVector<uint32_t, 8> objectMap;
+            uint32_t argIdx = 0;
+            for (auto& capturedValue : capturedValues)
+            {
+                if (capturedValue.kind == CaptureKind::POINTER &&
+                    !KindQuery::isQueueType(capturedValue.value->getType()))
+                {
+                    ptrMap.push_back(argIdx);
+                }
+                else if (capturedValue.kind == CaptureKind::IMAGE ||
+                    capturedValue.kind == CaptureKind::SAMPLER)
+                {
+                    objectMap.push_back(argIdx);
+                }
+                argIdx++;
+            }
+            if (!ptrMap.empty())
+            {
+                builder.CreateStore(ConstantDataArray::get(context, ptrMap), ptrMapBuf);
+            }
+            if (!objectMap.empty())
+            {
+                auto indicesType = ArrayType::get(int32ty, objectsNum)->getPointerTo();
+                builder.CreateStore(ConstantDataArray::get(context, objectMap),
+                    builder.CreatePointerCast(objectMapBuf, indicesType, "object_map_indices"));
+            }
+        }
+
         for (auto& capturedValue : capturedValues)
         {
             switch (capturedValue.kind)
@@ -2548,9 +2584,16 @@ namespace //Anonymous
                     auto storedSize = storeBuilder.Store(pointersBuf, capturedValue.value, pointersBufOffset, false);
                     pointersBufOffset += sizeInBlocks(storedSize, int64ty);
 
-                    auto dispatcherArgIdxValue = llvm::ConstantInt::get(int32ty, dispatcherArgIdx);
-                    storedSize = storeBuilder.Store(ptrMapBuf, dispatcherArgIdxValue, ptrMapBufOffset);
-                    ptrMapBufOffset += sizeInBlocks(storedSize, int32ty);
+                    if (constMappings)
+                    {
+                        ptrMapBufOffset++;
+                    }
+                    else
+                    {
+                        auto dispatcherArgIdxValue = llvm::ConstantInt::get(int32ty, dispatcherArgIdx);
+                        storedSize = storeBuilder.Store(ptrMapBuf, dispatcherArgIdxValue, ptrMapBufOffset);
+                        ptrMapBufOffset += sizeInBlocks(storedSize, int32ty);
+                    }
                 }
                 break;
 
@@ -2563,9 +2606,16 @@ namespace //Anonymous
                 auto objIdValue = builder.CreateCall(getObjIDFunc, objArgNumValue, "obj_id");
                 storeBuilder.Store(objectMapBuf, objIdValue, objectMapBufOffset + objectsNum);
 
-                auto dispatcherArgIdxValue = llvm::ConstantInt::get(int32ty, dispatcherArgIdx);
-                auto storedSize = storeBuilder.Store(objectMapBuf, dispatcherArgIdxValue, objectMapBufOffset);
-                objectMapBufOffset += sizeInBlocks(storedSize, int32ty);
+                if (constMappings)
+                {
+                    objectMapBufOffset++;
+                }
+                else
+                {
+                    auto dispatcherArgIdxValue = llvm::ConstantInt::get(int32ty, dispatcherArgIdx);
+                    auto storedSize = storeBuilder.Store(objectMapBuf, dispatcherArgIdxValue, objectMapBufOffset);
+                    objectMapBufOffset += sizeInBlocks(storedSize, int32ty);
+                }
             }
             break;
             // omit "default" to prevent compilation if not all cases are covered
@@ -136,50 +136,42 @@ void ImageFuncResolution::visitCallInst(CallInst &CI)
 
 Value* ImageFuncResolution::getImageHeight(CallInst &CI) 
 {
-    Argument* arg = getImplicitImageArg(CI, ImplicitArg::IMAGE_HEIGHT);
-    return arg;
+    return getImageQuery(CI, ImplicitArg::IMAGE_HEIGHT);
 }
 
 Value* ImageFuncResolution::getImageWidth(CallInst &CI) 
 {
-    Argument* arg = getImplicitImageArg(CI, ImplicitArg::IMAGE_WIDTH);
-    return arg;
+    return getImageQuery(CI, ImplicitArg::IMAGE_WIDTH);
 }
 
 Value* ImageFuncResolution::getImageDepth(CallInst &CI) 
 {
-    Argument* arg = getImplicitImageArg(CI, ImplicitArg::IMAGE_DEPTH);
-    return arg;
+    return getImageQuery(CI, ImplicitArg::IMAGE_DEPTH);
 }
 
 Value* ImageFuncResolution::getImageNumMipLevels(CallInst &CI) 
 {
-    Argument* arg = getImplicitImageArg(CI, ImplicitArg::IMAGE_NUM_MIP_LEVELS);
-    return arg;
+    return getImageQuery(CI, ImplicitArg::IMAGE_NUM_MIP_LEVELS);
 }
 
 Value* ImageFuncResolution::getImageChannelDataType(CallInst &CI) 
 {
-    Argument* arg = getImplicitImageArg(CI, ImplicitArg::IMAGE_CHANNEL_DATA_TYPE);
-    return arg;
+    return getImageQuery(CI, ImplicitArg::IMAGE_CHANNEL_DATA_TYPE);
 }
 
 Value* ImageFuncResolution::getImageChannelOrder(CallInst &CI) 
 {
-    Argument* arg = getImplicitImageArg(CI, ImplicitArg::IMAGE_CHANNEL_ORDER);
-    return arg;
+    return getImageQuery(CI, ImplicitArg::IMAGE_CHANNEL_ORDER);
 }
 
 Value* ImageFuncResolution::getImageArraySize(CallInst &CI) 
 {
-    Argument* arg = getImplicitImageArg(CI, ImplicitArg::IMAGE_ARRAY_SIZE);
-    return arg;
+    return getImageQuery(CI, ImplicitArg::IMAGE_ARRAY_SIZE);
 }
 
 Value* ImageFuncResolution::getImageNumSamples(CallInst &CI)
 {
-    Argument* arg = getImplicitImageArg(CI, ImplicitArg::IMAGE_NUM_SAMPLES);
-    return arg;
+    return getImageQuery(CI, ImplicitArg::IMAGE_NUM_SAMPLES);
 }
 
 Value* ImageFuncResolution::getSamplerAddressMode(CallInst &CI)
@@ -299,6 +291,18 @@ Value* ImageFuncResolution::getSamplerSnapWARequired(CallInst &CI)
     }
 }
 
+Value* ImageFuncResolution::getImageQuery(CallInst &CI, ImplicitArg::ArgType argType)
+{
+    Argument* image = cast<Argument>(CImagesBI::CImagesUtils::traceImageOrSamplerArgument(&CI, 0));
+    ModuleMetaData* modMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
+    int known = ImageFuncsAnalysis::getKnownImageQuery(modMD, CI.getParent()->getParent(), image->getArgNo(), argType);
+    if (known >= 0)
+    {
+        return ConstantInt::get(CI.getType(), known);
+    }
+    return getImplicitImageArg(CI, argType);
+}
+
 Argument* ImageFuncResolution::getImplicitImageArg(CallInst &CI, ImplicitArg::ArgType argType) {
     // Only images that are arguments are supported!
     Argument* image = cast<Argument>(CImagesBI::CImagesUtils::traceImageOrSamplerArgument(&CI, 0));
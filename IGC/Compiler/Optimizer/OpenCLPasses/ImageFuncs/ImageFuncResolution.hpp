@@ -143,6 +143,13 @@ namespace IGC
         ///         which may either be a ConstantInt or an Argument
         llvm::Value* getSamplerSnapWARequired(llvm::CallInst &CI);
 
+        /// @brief  Resolves an image query to the value the runtime fixed for this
+        ///         image if there is one, and to its implicit argument otherwise
+        /// @param  CI       The call instruction.
+        /// @param  argType  The implicit image argument type.
+        /// @return A ConstantInt or the function argument associated with the query
+        llvm::Value* getImageQuery(llvm::CallInst &CI, ImplicitArg::ArgType argType);
+
         /// @brief  Returns the appropriate implicit argument of the function
         ///         containing the given call instruction, based on the given implicit image 
         ///         argument type
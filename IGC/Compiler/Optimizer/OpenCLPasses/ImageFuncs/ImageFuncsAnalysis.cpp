@@ -101,54 +101,67 @@ void ImageFuncsAnalysis::visitCallInst(CallInst &CI)
 
     // Check for OpenCL image dimension function calls
     std::set<int>* imageFunc = nullptr;
+    ImplicitArg::ArgType argType = ImplicitArg::NUM_IMPLICIT_ARGS;
 
     if(funcName == GET_IMAGE_HEIGHT) 
     {
         imageFunc = &m_argMap[ImplicitArg::IMAGE_HEIGHT];
+        argType = ImplicitArg::IMAGE_HEIGHT;
     }
     else if(funcName == GET_IMAGE_WIDTH)
     {
         imageFunc = &m_argMap[ImplicitArg::IMAGE_WIDTH];
+        argType = ImplicitArg::IMAGE_WIDTH;
     }
     else if(funcName == GET_IMAGE_DEPTH)
     {
         imageFunc = &m_argMap[ImplicitArg::IMAGE_DEPTH];
+        argType = ImplicitArg::IMAGE_DEPTH;
     }
     else if(funcName == GET_IMAGE_NUM_MIP_LEVELS)
     {
         imageFunc = &m_argMap[ImplicitArg::IMAGE_NUM_MIP_LEVELS];
+        argType = ImplicitArg::IMAGE_NUM_MIP_LEVELS;
     }
     else if(funcName == GET_IMAGE_CHANNEL_DATA_TYPE)
     {
         imageFunc = &m_argMap[ImplicitArg::IMAGE_CHANNEL_DATA_TYPE];
+        argType = ImplicitArg::IMAGE_CHANNEL_DATA_TYPE;
     }
     else if(funcName == GET_IMAGE_CHANNEL_ORDER)
     {
         imageFunc = &m_argMap[ImplicitArg::IMAGE_CHANNEL_ORDER];
+        argType = ImplicitArg::IMAGE_CHANNEL_ORDER;
     }
     else if(funcName == GET_IMAGE_SRGB_CHANNEL_ORDER)
     {
         imageFunc = &m_argMap[ImplicitArg::IMAGE_SRGB_CHANNEL_ORDER];
+        argType = ImplicitArg::IMAGE_SRGB_CHANNEL_ORDER;
     }
     else if(funcName == GET_IMAGE_ARRAY_SIZE)
     {
         imageFunc = &m_argMap[ImplicitArg::IMAGE_ARRAY_SIZE];
+        argType = ImplicitArg::IMAGE_ARRAY_SIZE;
     }
     else if (funcName == GET_IMAGE_NUM_SAMPLES)
     {
         imageFunc = &m_argMap[ImplicitArg::IMAGE_NUM_SAMPLES];
+        argType = ImplicitArg::IMAGE_NUM_SAMPLES;
     }
     else if(funcName == GET_SAMPLER_ADDRESS_MODE)
     {
         imageFunc = &m_argMap[ImplicitArg::SAMPLER_ADDRESS];
+        argType = ImplicitArg::SAMPLER_ADDRESS;
     }
     else if(funcName == GET_SAMPLER_NORMALIZED_COORDS)
     {
         imageFunc = &m_argMap[ImplicitArg::SAMPLER_NORMALIZED];
+        argType = ImplicitArg::SAMPLER_NORMALIZED;
     }
     else if(funcName == GET_SAMPLER_SNAP_WA_REQUIRED)
     {
         imageFunc = &m_argMap[ImplicitArg::SAMPLER_SNAP_WA];
+        argType = ImplicitArg::SAMPLER_SNAP_WA;
     }
     else 
     {
@@ -171,7 +184,13 @@ void ImageFuncsAnalysis::visitCallInst(CallInst &CI)
     {
         if (Argument* arg = dyn_cast<Argument>(callArg))
         {
-            imageFunc->insert(arg->getArgNo());
+            // Queries the runtime fixed at compile time are folded by
+            // ImageFuncResolution and need no implicit argument
+            ModuleMetaData* modMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
+            if (getKnownImageQuery(modMD, CI.getParent()->getParent(), arg->getArgNo(), argType) < 0)
+            {
+                imageFunc->insert(arg->getArgNo());
+            }
         }
     }
     else
@@ -180,3 +199,33 @@ void ImageFuncsAnalysis::visitCallInst(CallInst &CI)
         assert(funcName == GET_SAMPLER_NORMALIZED_COORDS || funcName == GET_SAMPLER_SNAP_WA_REQUIRED);
     }
 }
+
+int ImageFuncsAnalysis::getKnownImageQuery(const ModuleMetaData* modMD, Function* F, unsigned int argNo, ImplicitArg::ArgType argType)
+{
+    auto funcMD = modMD->FuncMD.find(F);
+    if (funcMD == modMD->FuncMD.end())
+    {
+        return -1;
+    }
+    auto info = funcMD->second.knownImageQueries.find(argNo);
+    if (info == funcMD->second.knownImageQueries.end())
+    {
+        return -1;
+    }
+
+    const ImageQueryInfoMD& queries = info->second;
+    switch (argType)
+    {
+    case ImplicitArg::IMAGE_HEIGHT:              return queries.height;
+    case ImplicitArg::IMAGE_WIDTH:               return queries.width;
+    case ImplicitArg::IMAGE_DEPTH:               return queries.depth;
+    case ImplicitArg::IMAGE_NUM_MIP_LEVELS:      return queries.numMipLevels;
+    case ImplicitArg::IMAGE_CHANNEL_DATA_TYPE:   return queries.channelDataType;
+    case ImplicitArg::IMAGE_CHANNEL_ORDER:       return queries.channelOrder;
+    case ImplicitArg::IMAGE_ARRAY_SIZE:          return queries.arraySize;
+    case ImplicitArg::IMAGE_NUM_SAMPLES:         return queries.numSamples;
+    default:
+        // sampler state and the sRGB channel order are never specialized
+        return -1;
+    }
+}
@@ -83,6 +83,14 @@ namespace IGC
         /// @param  CI The call instruction.
         void visitCallInst(llvm::CallInst &CI);
 
+        /// @brief  Returns the value the runtime fixed for an image query on the given
+        ///         image argument (FunctionMetaData::knownImageQueries), or -1 if unknown.
+        /// @param  modMD    The module metadata.
+        /// @param  F        The function the image is an argument of.
+        /// @param  argNo    The image argument number.
+        /// @param  argType  The implicit image argument type of the query.
+        static int getKnownImageQuery(const ModuleMetaData* modMD, llvm::Function* F, unsigned int argNo, ImplicitArg::ArgType argType);
+
 
         // All image functions needed resolved by implicit arguments
         static const llvm::StringRef GET_IMAGE_HEIGHT;
@@ -0,0 +1,254 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2019 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+// vim:ts=2:sw=2:et:
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Pass.h>
+#include <llvm/ADT/SetVector.h>
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Instructions.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include "Compiler/CISACodeGen/ShaderCodeGen.hpp"
+#include "Compiler/IGCPassSupport.h"
+#include "Compiler/MetaDataUtilsWrapper.h"
+#include "common/igc_regkeys.hpp"
+
+using namespace llvm;
+using namespace IGC;
+using namespace IGC::IGCMD;
+
+// Indirect calls force stack calls and an indirect 'fcall' for every call
+// site, even though the whole program is available at this point and the
+// set of functions a pointer may refer to is usually tiny.
+//
+// This pass resolves the possible targets of each indirect call, either
+// from the called value itself (casts, selects and phis of functions) or,
+// failing that, from the whole program: a function pointer can only hold
+// the address of a function whose address is taken in this module, and a
+// well-defined call only reaches one with the same type. A call with a
+// single possible target becomes a direct call; a call with a few targets
+// becomes a compare-and-call chain, e.g.
+//
+//   %r = call i32 %fp(i32 %x)
+//
+// becomes
+//
+//   %c0 = icmp eq i32 (i32)* %fp, @f0
+//   br i1 %c0, label %devirt.call, label %devirt.check
+// devirt.call:
+//   %r0 = call i32 @f0(i32 %x)
+//   br label %devirt.tail
+// devirt.check:
+//   %r1 = call i32 @f1(i32 %x)
+//   br label %devirt.tail
+// devirt.tail:
+//   %r = phi i32 [ %r0, %devirt.call ], [ %r1, %devirt.check ]
+//
+// after which the direct calls are subject to the regular inlining.
+//
+
+namespace {
+class IndirectCallDevirtualization : public ModulePass {
+public:
+  static char ID;
+
+  IndirectCallDevirtualization() : ModulePass(ID) {
+    initializeIndirectCallDevirtualizationPass(*PassRegistry::getPassRegistry());
+  }
+
+  bool runOnModule(Module &) override;
+
+  StringRef getPassName() const override {
+    return "IndirectCallDevirtualization";
+  }
+
+private:
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.addRequired<CodeGenContextWrapper>();
+    AU.addRequired<MetaDataUtilsWrapper>();
+  }
+
+  typedef SmallSetVector<Function *, 4> TargetSet;
+
+  bool getKnownTargets(Value *V, TargetSet &Targets,
+                       SmallPtrSetImpl<Value *> &Visited) const;
+  bool getTargets(CallInst *CI, TargetSet &Targets) const;
+  void devirtualize(CallInst *CI, TargetSet &Targets) const;
+
+  MetaDataUtils *MDU = nullptr;
+  // Address-taken functions, by type.
+  DenseMap<FunctionType *, TargetSet> AddressTaken;
+  unsigned MaxTargets = 0;
+};
+
+} // End anonymous namespace
+
+namespace IGC {
+
+ModulePass *createIndirectCallDevirtualizationPass() {
+  return new IndirectCallDevirtualization();
+}
+
+#define PASS_FLAG "igc-indirect-call-devirtualization"
+#define PASS_DESC "Turn indirect calls into direct calls."
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS false
+IGC_INITIALIZE_PASS_BEGIN(IndirectCallDevirtualization, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
+IGC_INITIALIZE_PASS_END(IndirectCallDevirtualization, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+
+} // End IGC namespace
+
+char IndirectCallDevirtualization::ID = 0;
+
+// Collect the functions V may evaluate to, looking through casts, selects
+// and phis. Return false if any leaf isn't a function.
+bool IndirectCallDevirtualization::getKnownTargets(
+    Value *V, TargetSet &Targets, SmallPtrSetImpl<Value *> &Visited) const {
+  V = V->stripPointerCasts();
+  if (!Visited.insert(V).second)
+    return true;
+  if (auto *F = dyn_cast<Function>(V)) {
+    Targets.insert(F);
+    return Targets.size() <= MaxTargets;
+  }
+  if (auto *SI = dyn_cast<SelectInst>(V))
+    return getKnownTargets(SI->getTrueValue(), Targets, Visited) &&
+           getKnownTargets(SI->getFalseValue(), Targets, Visited);
+  if (auto *PN = dyn_cast<PHINode>(V)) {
+    for (Value *In : PN->incoming_values())
+      if (!getKnownTargets(In, Targets, Visited))
+        return false;
+    return true;
+  }
+  return false;
+}
+
+bool IndirectCallDevirtualization::getTargets(CallInst *CI,
+                                              TargetSet &Targets) const {
+  SmallPtrSet<Value *, 8> Visited;
+  if (!getKnownTargets(CI->getCalledValue(), Targets, Visited)) {
+    // Fall back to every address-taken function of the call's type.
+    Targets.clear();
+    auto I = AddressTaken.find(CI->getFunctionType());
+    if (I == AddressTaken.end())
+      return false;
+    Targets = I->second;
+  }
+  if (Targets.empty() || Targets.size() > MaxTargets)
+    return false;
+
+  for (auto *F : Targets) {
+    // Calling a kernel (or through a mismatched prototype) is left alone.
+    if (F->getFunctionType() != CI->getFunctionType() || isEntryFunc(MDU, F))
+      return false;
+  }
+  return true;
+}
+
+void IndirectCallDevirtualization::devirtualize(CallInst *CI,
+                                                TargetSet &Targets) const {
+  if (Targets.size() == 1) {
+    CI->setCalledFunction(Targets[0]);
+    return;
+  }
+
+  Value *Callee = CI->getCalledValue();
+  BasicBlock *BB = CI->getParent();
+  Function *F = BB->getParent();
+  LLVMContext &Ctx = F->getContext();
+
+  BasicBlock *Tail = BB->splitBasicBlock(CI->getIterator(), "devirt.tail");
+  BB->getTerminator()->eraseFromParent();
+
+  PHINode *PN = nullptr;
+  if (!CI->getType()->isVoidTy())
+    PN = PHINode::Create(CI->getType(), Targets.size(), "", &Tail->front());
+
+  IRBuilder<> IRB(BB);
+  IRB.SetCurrentDebugLocation(CI->getDebugLoc());
+  for (unsigned i = 0, e = Targets.size(); i != e; ++i) {
+    Function *Target = Targets[i];
+    BasicBlock *CallBB = IRB.GetInsertBlock();
+    if (i + 1 != e) {
+      // The last target needs no check: the set is complete.
+      CallBB = BasicBlock::Create(Ctx, "devirt.call", F, Tail);
+      BasicBlock *NextBB = BasicBlock::Create(Ctx, "devirt.check", F, Tail);
+      Value *Cmp = IRB.CreateICmpEQ(
+          Callee, ConstantExpr::getBitCast(Target, Callee->getType()));
+      IRB.CreateCondBr(Cmp, CallBB, NextBB);
+      IRB.SetInsertPoint(CallBB);
+    }
+    auto *NewCI = cast<CallInst>(CI->clone());
+    NewCI->setCalledFunction(Target);
+    IRB.Insert(NewCI);
+    IRB.CreateBr(Tail);
+    if (PN)
+      PN->addIncoming(NewCI, CallBB);
+    if (i + 1 != e)
+      IRB.SetInsertPoint(CallBB->getNextNode());
+  }
+
+  if (PN)
+    CI->replaceAllUsesWith(PN);
+  CI->eraseFromParent();
+}
+
+bool IndirectCallDevirtualization::runOnModule(Module &M) {
+  if (IGC_IS_FLAG_DISABLED(EnableIndirectCallDevirtualization))
+    return false;
+
+  MDU = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+  MaxTargets = IGC_GET_FLAG_VALUE(DevirtualizationMaxTargets);
+
+  SmallVector<CallInst *, 8> IndirectCalls;
+  for (auto &F : M) {
+    if (F.hasAddressTaken())
+      AddressTaken[F.getFunctionType()].insert(&F);
+    for (auto &BB : F)
+      for (auto &I : BB)
+        if (auto *CI = dyn_cast<CallInst>(&I))
+          if (!CI->getCalledFunction() && !CI->isInlineAsm())
+            IndirectCalls.push_back(CI);
+  }
+
+  bool Changed = false;
+  for (auto *CI : IndirectCalls) {
+    TargetSet Targets;
+    if (!getTargets(CI, Targets))
+      continue;
+    devirtualize(CI, Targets);
+    Changed = true;
+  }
+
+  AddressTaken.clear();
+  return Changed;
+}
@@ -0,0 +1,111 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+
+#include "Compiler/Optimizer/OpenCLPasses/KernelArgSpecialization/KernelArgSpecialization.hpp"
+#include "Compiler/CodeGenPublic.h"
+#include "Compiler/CISACodeGen/helper.h"
+#include "Compiler/IGCPassSupport.h"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Module.h>
+#include "common/LLVMWarningsPop.hpp"
+
+using namespace llvm;
+using namespace IGC;
+
+// Register pass to igc-opt
+#define PASS_FLAG "igc-kernel-arg-specialization"
+#define PASS_DESCRIPTION "Folds kernel args to the values given by the runtime"
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS false
+IGC_INITIALIZE_PASS_BEGIN(KernelArgSpecialization, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
+IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+IGC_INITIALIZE_PASS_END(KernelArgSpecialization, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+
+char KernelArgSpecialization::ID = 0;
+
+KernelArgSpecialization::KernelArgSpecialization() : ModulePass(ID)
+{
+    initializeKernelArgSpecializationPass(*PassRegistry::getPassRegistry());
+}
+
+bool KernelArgSpecialization::runOnModule(Module &M)
+{
+    OpenCLProgramContext* ctx = static_cast<OpenCLProgramContext*>(
+        getAnalysis<CodeGenContextWrapper>().getCodeGenContext());
+    IGCMD::MetaDataUtils* pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+    const auto& specializedArgs = ctx->m_InternalOptions.SpecializedArgs;
+
+    bool changed = false;
+    for (Function& F : M)
+    {
+        if (F.isDeclaration() || !isEntryFunc(pMdUtils, &F))
+        {
+            continue;
+        }
+
+        auto kernelArgs = specializedArgs.find(F.getName().str());
+        if (kernelArgs == specializedArgs.end())
+        {
+            continue;
+        }
+
+        for (Argument& arg : F.args())
+        {
+            auto argValue = kernelArgs->second.find(arg.getArgNo());
+            if (argValue == kernelArgs->second.end())
+            {
+                continue;
+            }
+
+            // Same restriction as the reported args: scalars of up to a dword.
+            Type* type = arg.getType();
+            Constant* value = nullptr;
+            if (type->isIntegerTy() && type->getPrimitiveSizeInBits() <= 32)
+            {
+                value = ConstantInt::get(type, argValue->second);
+            }
+            else if (type->isFloatTy())
+            {
+                value = ConstantExpr::getBitCast(
+                    ConstantInt::get(Type::getInt32Ty(M.getContext()), argValue->second), type);
+            }
+
+            if (!value)
+            {
+                continue;
+            }
+
+            // Record the arg even when it has no use, the binary is still
+            // only correct for that value from the runtime's point of view.
+            arg.replaceAllUsesWith(value);
+            ctx->m_specializedArgs[F.getName().str()][arg.getArgNo()] = argValue->second;
+            changed = true;
+        }
+    }
+    return changed;
+}
@@ -0,0 +1,66 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#pragma once
+
+#include "Compiler/MetaDataUtilsWrapper.h"
+#include "Compiler/CodeGenContextWrapper.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Pass.h>
+#include "common/LLVMWarningsPop.hpp"
+
+namespace IGC
+{
+
+/// @brief  KernelArgSpecialization folds the by-value kernel args listed with
+///         -cl-intel-specialize-arg to the value the runtime observed for them,
+///         typically ones FindInterestingConstants reported as interesting.
+///         The folded args are recorded so that the binary can be tagged as a
+///         variant only valid for those values.
+class KernelArgSpecialization : public llvm::ModulePass
+{
+public:
+    static char ID;
+
+    KernelArgSpecialization();
+
+    ~KernelArgSpecialization() {}
+
+    virtual llvm::StringRef getPassName() const override
+    {
+        return "KernelArgSpecialization";
+    }
+
+    virtual void getAnalysisUsage(llvm::AnalysisUsage &AU) const override
+    {
+        AU.setPreservesCFG();
+        AU.addRequired<MetaDataUtilsWrapper>();
+        AU.addRequired<CodeGenContextWrapper>();
+    }
+
+    virtual bool runOnModule(llvm::Module &M) override;
+};
+
+}
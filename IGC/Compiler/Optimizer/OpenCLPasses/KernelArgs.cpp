@@ -36,6 +36,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/IR/Module.h>
 #include "common/LLVMWarningsPop.hpp"
 
+#include <algorithm>
+
 using namespace IGC;
 using namespace IGC::IGCMD;
 using namespace llvm;
@@ -332,6 +334,9 @@ KernelArg::ArgType KernelArg::calcArgType(const ImplicitArg& arg) const
     case ImplicitArg::PRIVATE_MEMORY_STATELESS_SIZE:
         return KernelArg::ArgType::IMPLICIT_PRIVATE_MEMORY_STATELESS_SIZE;
 
+    case ImplicitArg::PRECOMPUTED_VALUE:
+        return KernelArg::ArgType::IMPLICIT_PRECOMPUTED_VALUE;
+
     default:
         return KernelArg::ArgType::NOT_TO_ALLOCATE;
     }
@@ -360,7 +365,8 @@ unsigned int KernelArg::calcAssociatedArgNo(const ImplicitArg& implicitArg, cons
           (argType <= ImplicitArg::CONSTANT_REG_BYTE)) ||
          (argType == ImplicitArg::GET_OBJECT_ID) ||
          (argType == ImplicitArg::GET_BLOCK_SIMD_SIZE) ||
-         (argType == ImplicitArg::BUFFER_OFFSET)
+         (argType == ImplicitArg::BUFFER_OFFSET) ||
+         (argType == ImplicitArg::PRECOMPUTED_VALUE)
        )
     {
         // For implicit image and sampler and struct arguments and buffer offset,
@@ -698,7 +704,8 @@ std::map<KernelArg::ArgType, iOpenCL::DATA_PARAMETER_TOKEN> initArgTypeTokenMap(
        { KernelArg::ArgType::IMPLICIT_LOCAL_MEMORY_STATELESS_WINDOW_START_ADDRESS, iOpenCL::DATA_PARAMETER_LOCAL_MEMORY_STATELESS_WINDOW_START_ADDRESS },
        { KernelArg::ArgType::IMPLICIT_LOCAL_MEMORY_STATELESS_WINDOW_SIZE, iOpenCL::DATA_PARAMETER_LOCAL_MEMORY_STATELESS_WINDOW_SIZE },
        { KernelArg::ArgType::IMPLICIT_PRIVATE_MEMORY_STATELESS_SIZE, iOpenCL::DATA_PARAMETER_PRIVATE_MEMORY_STATELESS_SIZE },
-       { KernelArg::ArgType::IMPLICIT_BUFFER_OFFSET, iOpenCL::DATA_PARAMETER_BUFFER_OFFSET }
+       { KernelArg::ArgType::IMPLICIT_BUFFER_OFFSET, iOpenCL::DATA_PARAMETER_BUFFER_OFFSET },
+       { KernelArg::ArgType::IMPLICIT_PRECOMPUTED_VALUE, iOpenCL::DATA_PARAMETER_PRECOMPUTED_VALUE }
     };
     return map;
 }
@@ -797,6 +804,7 @@ KernelArgsOrder::KernelArgsOrder(InputType layout)
             KernelArg::ArgType::IMPLICIT_LOCAL_MEMORY_STATELESS_WINDOW_START_ADDRESS,
             KernelArg::ArgType::IMPLICIT_LOCAL_MEMORY_STATELESS_WINDOW_SIZE,
             KernelArg::ArgType::IMPLICIT_PRIVATE_MEMORY_STATELESS_SIZE,
+            KernelArg::ArgType::IMPLICIT_PRECOMPUTED_VALUE,
 
             KernelArg::ArgType::R1,
             KernelArg::ArgType::IMPLICIT_LOCAL_IDS,
@@ -907,6 +915,7 @@ KernelArgsOrder::KernelArgsOrder(InputType layout)
             KernelArg::ArgType::IMPLICIT_LOCAL_MEMORY_STATELESS_WINDOW_START_ADDRESS,
             KernelArg::ArgType::IMPLICIT_LOCAL_MEMORY_STATELESS_WINDOW_SIZE,
             KernelArg::ArgType::IMPLICIT_PRIVATE_MEMORY_STATELESS_SIZE,
+            KernelArg::ArgType::IMPLICIT_PRECOMPUTED_VALUE,
 
             KernelArg::ArgType::STRUCT,
             KernelArg::ArgType::SAMPLER,
@@ -1107,6 +1116,36 @@ KernelArgs::const_iterator KernelArgs::end()
     return const_iterator(m_args.end(), m_args.end(), (*(--m_args.end())).second.end());
 }
 
+void KernelArgs::sortByUses()
+{
+    // Only explicit arguments are reordered. The relative order of implicit
+    // arguments (e.g. runtime values feeding the NOS buffer) is kept.
+    const KernelArg::ArgType sortedTypes[] =
+    {
+        KernelArg::ArgType::Default,
+        KernelArg::ArgType::PTR_LOCAL,
+        KernelArg::ArgType::PTR_GLOBAL,
+        KernelArg::ArgType::PTR_CONSTANT,
+    };
+
+    for (KernelArg::ArgType argType : sortedTypes)
+    {
+        auto it = m_args.find(argType);
+        if (it == m_args.end())
+        {
+            continue;
+        }
+
+        std::stable_sort(it->second.begin(), it->second.end(),
+            [](const KernelArg& lhs, const KernelArg& rhs)
+        {
+            unsigned int lhsUses = lhs.getArg() ? lhs.getArg()->getNumUses() : 0;
+            unsigned int rhsUses = rhs.getArg() ? rhs.getArg()->getNumUses() : 0;
+            return lhsUses > rhsUses;
+        });
+    }
+}
+
 void KernelArgs::checkForZeroPerThreadData()
 {
 
@@ -123,6 +123,9 @@ namespace IGC
             IMPLICIT_STAGE_IN_GRID_ORIGIN,
             IMPLICIT_STAGE_IN_GRID_SIZE,
 
+            // Host-evaluated argument-only uniform values
+            IMPLICIT_PRECOMPUTED_VALUE,
+
             // Argument types that shouldn't be allocated
             NOT_TO_ALLOCATE,
             SAMPLER = NOT_TO_ALLOCATE,
@@ -462,6 +465,10 @@ namespace IGC
         /// @return A constant iterator to the end of the kernel arguments
         const_iterator end();
 
+        /// @brief  Reorders explicit arguments of the same type so that the most used
+        ///         ones are allocated first.
+        void sortByUses();
+
         /// #brief Check if we need to insert dummy per-thread data for OpenCL 
         ///
         void checkForZeroPerThreadData();
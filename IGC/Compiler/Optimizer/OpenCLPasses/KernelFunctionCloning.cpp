@@ -75,6 +75,12 @@ using namespace IGC::IGCMD;
 // This pass is added to clone a kernel function to a user function if it's
 // called.
 //
+// None of the kernel-specific handling above has happened yet when this pass
+// runs, so a called kernel whose every use is a direct call can instead be
+// inlined into its callers straight away. With EnableKernelFunctionSharing
+// such call sites are marked always-inline and the kernel is not cloned,
+// which avoids carrying a second copy of its body until the inliner runs.
+//
 
 namespace {
 class KernelFunctionCloning : public ModulePass {
@@ -86,6 +92,8 @@ public:
   bool runOnModule(Module &) override;
 
 private:
+  bool canShareWithCallers(Function &F) const;
+
   void getAnalysisUsage(AnalysisUsage &AU) const override {
     AU.setPreservesCFG();
     AU.addRequired<CodeGenContextWrapper>();
@@ -114,8 +122,35 @@ IGC_INITIALIZE_PASS_END(KernelFunctionCloning, PASS_FLAG, PASS_DESC, PASS_CFG_ON
 
 char KernelFunctionCloning::ID = 0;
 
+// Check whether every use of kernel F is a direct call the inliner can fold,
+// in which case F never has to exist as a user function.
+bool KernelFunctionCloning::canShareWithCallers(Function &F) const {
+  if (IGC_IS_FLAG_DISABLED(EnableKernelFunctionSharing))
+    return false;
+  // Subroutine and stack call modes keep calls as calls.
+  if (IGC_GET_FLAG_VALUE(FunctionControl) != FLAG_FCALL_DEFAULT &&
+      IGC_GET_FLAG_VALUE(FunctionControl) != FLAG_FCALL_FORCE_INLINE)
+    return false;
+  if (F.isVarArg())
+    return false;
+
+  for (auto &Use : F.uses()) {
+    ImmutableCallSite CS(Use.getUser());
+    if (!CS || !CS.isCallee(&Use))
+      return false;
+    // Recursion cannot be inlined away.
+    if (CS.getInstruction()->getFunction() == &F)
+      return false;
+  }
+  return true;
+}
+
 bool KernelFunctionCloning::runOnModule(Module &M) {
   MetaDataUtils *MDU = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+  CodeGenContext *Ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+  // The debugger expects kernel prologs that only exist in the kernel itself.
+  bool KernelDebug = Ctx->type == ShaderType::OPENCL_SHADER &&
+    static_cast<OpenCLProgramContext *>(Ctx)->m_InternalOptions.KernelDebugEnable;
 
   // Collect kernel functions being called.
   SmallVector<Function *, 8> KernelsToClone;
@@ -136,6 +171,14 @@ bool KernelFunctionCloning::runOnModule(Module &M) {
   // Clone it
   bool Changed = false;
   for (auto *F : KernelsToClone) {
+    if (!KernelDebug && canShareWithCallers(*F)) {
+      for (auto *U : F->users()) {
+        CallSite CS(U);
+        CS.addAttribute(AttributeList::FunctionIndex, Attribute::AlwaysInline);
+      }
+      Changed = true;
+      continue;
+    }
     ValueToValueMapTy VMap;
     auto *NewF = CloneFunction(F, VMap);
     NewF->setLinkage(GlobalValue::InternalLinkage);
@@ -34,6 +34,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Instructions.h>
+#include <llvm/IR/Operator.h>
+#include <llvm/Support/MathExtras.h>
 #include "common/LLVMWarningsPop.hpp"
 
 using namespace llvm;
@@ -116,6 +118,10 @@ bool InlineLocalsResolution::runOnModule(Module &M)
     // Compute the offset of each inline local in the kernel,
     // and their total size.
     std::map<Function*, unsigned int> sizeMap;
+    if (IGC_IS_FLAG_ENABLED(EnableSLMPadding))
+    {
+        padSharedLocalArrays(M);
+    }
     collectInfoOnSharedLocalMem(M);
     computeOffsetList(M, sizeMap);
 
@@ -213,6 +219,324 @@ bool InlineLocalsResolution::runOnModule(Module &M)
     return true;
 }
 
+// SLM is interleaved over 16 banks of 4 bytes each. Lanes of one access that
+// hit the same bank at different addresses are serialized.
+static const unsigned SLM_BANK_COUNT = 16;
+static const unsigned SLM_BANK_WIDTH = 4;
+// 64-bit data always spans two banks, so a 2-way conflict is not worth padding
+// for or reporting.
+static const unsigned SLM_MAX_CONFLICT_DEGREE = 2;
+
+// Number of lanes that land on the same bank when consecutive lanes access
+// SLM with the given byte stride.
+static unsigned getBankConflictDegree(uint64_t stride)
+{
+    if (stride == 0)
+    {
+        return 1;
+    }
+    uint64_t g = GreatestCommonDivisor64(stride, SLM_BANK_COUNT * SLM_BANK_WIDTH);
+    return std::max(1u, unsigned(g / SLM_BANK_WIDTH));
+}
+
+// Return the constant factor a varying index is scaled by, e.g. 32 for
+// "lid * 32 + k", or 0 if the index is a constant.
+static uint64_t getIndexScale(Value *V, unsigned depth = 0)
+{
+    if (isa<Constant>(V))
+    {
+        return 0;
+    }
+    if (depth > 4)
+    {
+        return 1;
+    }
+    if (isa<SExtInst>(V) || isa<ZExtInst>(V) || isa<TruncInst>(V))
+    {
+        return getIndexScale(cast<CastInst>(V)->getOperand(0), depth + 1);
+    }
+    BinaryOperator *BO = dyn_cast<BinaryOperator>(V);
+    if (!BO)
+    {
+        return 1;
+    }
+    Value *Op0 = BO->getOperand(0);
+    Value *Op1 = BO->getOperand(1);
+    switch (BO->getOpcode())
+    {
+    case Instruction::Mul:
+        if (ConstantInt *C = dyn_cast<ConstantInt>(Op1))
+            return C->getZExtValue() * getIndexScale(Op0, depth + 1);
+        if (ConstantInt *C = dyn_cast<ConstantInt>(Op0))
+            return C->getZExtValue() * getIndexScale(Op1, depth + 1);
+        break;
+    case Instruction::Shl:
+        if (ConstantInt *C = dyn_cast<ConstantInt>(Op1))
+            return getIndexScale(Op0, depth + 1) << C->getZExtValue();
+        break;
+    case Instruction::Add:
+    case Instruction::Sub:
+    case Instruction::Or:
+        return std::max(getIndexScale(Op0, depth + 1), getIndexScale(Op1, depth + 1));
+    default:
+        break;
+    }
+    return 1;
+}
+
+namespace {
+    // A load or store of a local array, with the deepest array level that is
+    // indexed by a varying value. Consecutive lanes are assumed to step along
+    // that index.
+    struct SLMAccess
+    {
+        Instruction *inst = nullptr;
+        unsigned depth = 0;
+        uint64_t scale = 0;
+    };
+}
+
+// Collect the loads and stores reached from Ptr, which points to an object at
+// the given depth of the local array type. Returns false if the layout of the
+// array is observable (the pointer escapes, is cast or is used as a whole), so
+// that the array must not be padded.
+static bool collectSLMAccesses(Value *Ptr, unsigned depth, SLMAccess cur,
+    SmallVectorImpl<SLMAccess> &accesses)
+{
+    bool layoutPrivate = true;
+    for (User *U : Ptr->users())
+    {
+        if (GEPOperator *GEP = dyn_cast<GEPOperator>(U))
+        {
+            if (GEP->getPointerOperand() != Ptr)
+            {
+                layoutPrivate = false;
+                continue;
+            }
+            SLMAccess next = cur;
+            unsigned d = depth;
+            for (auto I = GEP->idx_begin(), E = GEP->idx_end(); I != E; ++I, ++d)
+            {
+                if (uint64_t scale = getIndexScale(*I))
+                {
+                    next.depth = d;
+                    next.scale = scale;
+                }
+            }
+            layoutPrivate &= collectSLMAccesses(GEP, d - 1, next, accesses);
+        }
+        else if (LoadInst *LI = dyn_cast<LoadInst>(U))
+        {
+            cur.inst = LI;
+            accesses.push_back(cur);
+            layoutPrivate &= !LI->getType()->isArrayTy();
+        }
+        else if (StoreInst *SI = dyn_cast<StoreInst>(U))
+        {
+            cur.inst = SI;
+            accesses.push_back(cur);
+            layoutPrivate &= SI->getValueOperand() != Ptr &&
+                !SI->getValueOperand()->getType()->isArrayTy();
+        }
+        else
+        {
+            layoutPrivate = false;
+        }
+    }
+    return layoutPrivate;
+}
+
+// Sizes of the nested array types of a local array, outermost first, with the
+// size of the innermost element last.
+static void getLevelSizes(const DataLayout &DL, Type *Ty, SmallVectorImpl<uint64_t> &sizes)
+{
+    sizes.push_back(DL.getTypeAllocSize(Ty));
+    while (ArrayType *ATy = dyn_cast<ArrayType>(Ty))
+    {
+        Ty = ATy->getElementType();
+        sizes.push_back(DL.getTypeAllocSize(Ty));
+    }
+}
+
+// Return the bank conflict degree of an access, 1 when it has none.
+static unsigned getBankConflictDegree(const SLMAccess &access, ArrayRef<uint64_t> sizes)
+{
+    // Depth 0 steps over the whole array, and indices deeper than the
+    // innermost element go into a vector or struct: neither is modeled.
+    if (access.scale == 0 || access.depth == 0 || access.depth >= sizes.size())
+    {
+        return 1;
+    }
+    return getBankConflictDegree(access.scale * sizes[access.depth]);
+}
+
+// Return Ty with its innermost array dimension grown by pad elements.
+static Type *getPaddedType(Type *Ty, unsigned pad)
+{
+    ArrayType *ATy = cast<ArrayType>(Ty);
+    Type *ElemTy = ATy->getElementType();
+    if (ElemTy->isArrayTy())
+    {
+        return ArrayType::get(getPaddedType(ElemTy, pad), ATy->getNumElements());
+    }
+    return ArrayType::get(ElemTy, ATy->getNumElements() + pad);
+}
+
+// Rebuild the users of OldPtr on top of NewPtr, which points into the padded
+// array. The replaced GEP instructions are collected in deadInsts.
+static void rewriteSLMUses(Value *OldPtr, Value *NewPtr, SmallVectorImpl<Instruction*> &deadInsts)
+{
+    SmallVector<User*, 8> users(OldPtr->user_begin(), OldPtr->user_end());
+    for (User *U : users)
+    {
+        if (GetElementPtrInst *GEP = dyn_cast<GetElementPtrInst>(U))
+        {
+            SmallVector<Value*, 4> indices(GEP->idx_begin(), GEP->idx_end());
+            GetElementPtrInst *NewGEP = GetElementPtrInst::Create(nullptr, NewPtr, indices, "", GEP);
+            NewGEP->setIsInBounds(GEP->isInBounds());
+            NewGEP->setDebugLoc(GEP->getDebugLoc());
+            NewGEP->takeName(GEP);
+            rewriteSLMUses(GEP, NewGEP, deadInsts);
+            deadInsts.push_back(GEP);
+        }
+        else if (GEPOperator *GEP = dyn_cast<GEPOperator>(U))
+        {
+            SmallVector<Constant*, 4> indices;
+            for (auto I = GEP->idx_begin(), E = GEP->idx_end(); I != E; ++I)
+            {
+                indices.push_back(cast<Constant>(*I));
+            }
+            Constant *NewCE = ConstantExpr::getGetElementPtr(
+                nullptr, cast<Constant>(NewPtr), indices, GEP->isInBounds());
+            rewriteSLMUses(GEP, NewCE, deadInsts);
+        }
+        else if (LoadInst *LI = dyn_cast<LoadInst>(U))
+        {
+            LI->setOperand(LI->getPointerOperandIndex(), NewPtr);
+        }
+        else
+        {
+            StoreInst *SI = cast<StoreInst>(U);
+            SI->setOperand(SI->getPointerOperandIndex(), NewPtr);
+        }
+    }
+}
+
+// Look for local arrays whose rows are accessed column-wise with a stride
+// that maps many lanes to one SLM bank, as in transposes and stencils. When
+// the layout of the array cannot be observed by the kernel, pad its rows so
+// that the stride is spread over the banks. Conflicts that remain are counted
+// per function and reported in the shader stats.
+void InlineLocalsResolution::padSharedLocalArrays(Module& M)
+{
+    ModuleMetaData *modMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
+    const DataLayout &DL = M.getDataLayout();
+    // Debug info describes the original array type.
+    const bool canPad = M.getNamedMetadata("llvm.dbg.cu") == nullptr;
+
+    SmallVector<GlobalVariable*, 8> localArrays;
+    for (GlobalVariable &G : M.globals())
+    {
+        if (G.getType()->getAddressSpace() == ADDRESS_SPACE_LOCAL &&
+            G.getValueType()->isArrayTy())
+        {
+            localArrays.push_back(&G);
+        }
+    }
+
+    for (GlobalVariable *G : localArrays)
+    {
+        SmallVector<SLMAccess, 16> accesses;
+        bool layoutPrivate = collectSLMAccesses(G, 0, SLMAccess(), accesses);
+
+        SmallVector<uint64_t, 4> sizes;
+        getLevelSizes(DL, G->getValueType(), sizes);
+
+        auto getWorstDegree = [&accesses](ArrayRef<uint64_t> levelSizes) {
+            unsigned worst = 1;
+            for (auto &access : accesses)
+            {
+                worst = std::max(worst, getBankConflictDegree(access, levelSizes));
+            }
+            return worst;
+        };
+
+        unsigned worst = getWorstDegree(sizes);
+        if (worst <= SLM_MAX_CONFLICT_DEGREE)
+        {
+            continue;
+        }
+
+        // Only multi-dimensional arrays have rows to pad, and only an undef or
+        // zero initializer can be rebuilt for the padded type.
+        Type *padTy = nullptr;
+        bool paddable = canPad && layoutPrivate &&
+            G->getValueType()->getArrayElementType()->isArrayTy() &&
+            (!G->hasInitializer() || isa<UndefValue>(G->getInitializer()) ||
+             isa<ConstantAggregateZero>(G->getInitializer()));
+        if (paddable)
+        {
+            // Pick the smallest padding of the innermost dimension that gives
+            // the fewest conflicts, without growing the array past 64KB.
+            for (unsigned pad = 1; pad <= SLM_BANK_COUNT; ++pad)
+            {
+                Type *Ty = getPaddedType(G->getValueType(), pad);
+                if (DL.getTypeAllocSize(Ty) > 64 * 1024)
+                {
+                    break;
+                }
+                SmallVector<uint64_t, 4> paddedSizes;
+                getLevelSizes(DL, Ty, paddedSizes);
+                unsigned degree = getWorstDegree(paddedSizes);
+                if (degree < worst)
+                {
+                    worst = degree;
+                    padTy = Ty;
+                    sizes.swap(paddedSizes);
+                }
+                if (worst == 1)
+                {
+                    break;
+                }
+            }
+        }
+
+        if (padTy)
+        {
+            Constant *init = nullptr;
+            if (G->hasInitializer())
+            {
+                init = isa<UndefValue>(G->getInitializer()) ?
+                    (Constant*)UndefValue::get(padTy) : ConstantAggregateZero::get(padTy);
+            }
+            GlobalVariable *NewG = new GlobalVariable(M, padTy, G->isConstant(),
+                G->getLinkage(), init, "", G,
+                G->getThreadLocalMode(), ADDRESS_SPACE_LOCAL);
+            NewG->setAlignment(G->getAlignment());
+            NewG->takeName(G);
+
+            SmallVector<Instruction*, 16> deadInsts;
+            rewriteSLMUses(G, NewG, deadInsts);
+            for (Instruction *I : deadInsts)
+            {
+                I->eraseFromParent();
+            }
+            G->removeDeadConstantUsers();
+            assert(G->use_empty() && "padded local array still in use");
+            G->eraseFromParent();
+        }
+
+        // Report whatever padding could not fix.
+        for (auto &access : accesses)
+        {
+            if (getBankConflictDegree(access, sizes) > SLM_MAX_CONFLICT_DEGREE)
+            {
+                modMD->FuncMD[access.inst->getParent()->getParent()].slmBankConflicts++;
+            }
+        }
+    }
+}
+
 void InlineLocalsResolution::collectInfoOnSharedLocalMem(Module& M)
 {
 
@@ -84,6 +84,7 @@ namespace IGC
 
     protected:
 
+        void padSharedLocalArrays(llvm::Module&);
         void collectInfoOnSharedLocalMem(llvm::Module&);
         void computeOffsetList(llvm::Module&, std::map<llvm::Function*, unsigned int>&);
         void traveseCGN(llvm::CallGraphNode&);
@@ -468,51 +468,56 @@ void OpenCLPrintfResolution::expandPrintfCall(CallInst &printfCall, Function &F)
     // write_offset += 4;
     Value *constVal4 = ConstantInt::get(m_ptrSizeIntType, 4);
     
-    for(size_t i = 0, size = m_argDescriptors.size(); i < size; ++i)
+    // Write the whole record with a few wide stores when possible.
+    if (IGC_IS_FLAG_DISABLED(EnablePrintfPackedStores) ||
+        !genPackedStores(writeOffset, bblockTrue))
     {
-        SPrintfArgDescriptor *argDesc = &m_argDescriptors[i];
-        Value *printfArg = argDesc->value;
-        SHADER_PRINTF_TYPE dataType = argDesc->argType;
-
-        // We don't store the dataType for format string (which is the first entry in m_argDescriptors).
-        if (i != 0)
+        for(size_t i = 0, size = m_argDescriptors.size(); i < size; ++i)
         {
-            // *write_offset = argument[i].dataType
-            Value *argTypeVal = ConstantInt::get(m_int32Type, (unsigned int)dataType);
-            writeOffsetPtr = CastInst::Create(Instruction::CastOps::IntToPtr, writeOffset,
-                m_int32Type->getPointerTo(ADDRESS_SPACE_GLOBAL), "write_offset_ptr", bblockTrue);
-            writeOffsetPtr->setDebugLoc(m_DL);
-            genStoreInternal(argTypeVal, writeOffsetPtr, bblockTrue, m_DL);
-
-            // write_offset += 4            
-            writeOffset = BinaryOperator::CreateAdd(writeOffset, constVal4, "write_offset", bblockTrue);
-            writeOffset->setDebugLoc(m_DL);
+            SPrintfArgDescriptor *argDesc = &m_argDescriptors[i];
+            Value *printfArg = argDesc->value;
+            SHADER_PRINTF_TYPE dataType = argDesc->argType;
 
-            // For vector arguments, add vector size after type ID.
-            if (argDesc->vecSize > 0) {
-                Value *vecSizeVal = ConstantInt::get(m_int32Type, argDesc->vecSize);
+            // We don't store the dataType for format string (which is the first entry in m_argDescriptors).
+            if (i != 0)
+            {
+                // *write_offset = argument[i].dataType
+                Value *argTypeVal = ConstantInt::get(m_int32Type, (unsigned int)dataType);
                 writeOffsetPtr = CastInst::Create(Instruction::CastOps::IntToPtr, writeOffset,
                     m_int32Type->getPointerTo(ADDRESS_SPACE_GLOBAL), "write_offset_ptr", bblockTrue);
                 writeOffsetPtr->setDebugLoc(m_DL);
-                genStoreInternal(vecSizeVal, writeOffsetPtr, bblockTrue, m_DL);
+                genStoreInternal(argTypeVal, writeOffsetPtr, bblockTrue, m_DL);
 
                 // write_offset += 4            
                 writeOffset = BinaryOperator::CreateAdd(writeOffset, constVal4, "write_offset", bblockTrue);
                 writeOffset->setDebugLoc(m_DL);
+
+                // For vector arguments, add vector size after type ID.
+                if (argDesc->vecSize > 0) {
+                    Value *vecSizeVal = ConstantInt::get(m_int32Type, argDesc->vecSize);
+                    writeOffsetPtr = CastInst::Create(Instruction::CastOps::IntToPtr, writeOffset,
+                        m_int32Type->getPointerTo(ADDRESS_SPACE_GLOBAL), "write_offset_ptr", bblockTrue);
+                    writeOffsetPtr->setDebugLoc(m_DL);
+                    genStoreInternal(vecSizeVal, writeOffsetPtr, bblockTrue, m_DL);
+
+                    // write_offset += 4            
+                    writeOffset = BinaryOperator::CreateAdd(writeOffset, constVal4, "write_offset", bblockTrue);
+                    writeOffset->setDebugLoc(m_DL);
+                }
             }
-        }
          
-        writeOffsetPtr = generateCastToPtr(argDesc, writeOffset, bblockTrue);
-        writeOffsetPtr->setDebugLoc(m_DL);
+            writeOffsetPtr = generateCastToPtr(argDesc, writeOffset, bblockTrue);
+            writeOffsetPtr->setDebugLoc(m_DL);
 
-        // *write_offset = argument[i].value
-        genStoreInternal(printfArg, writeOffsetPtr , bblockTrue, m_DL);
+            // *write_offset = argument[i].value
+            genStoreInternal(printfArg, writeOffsetPtr , bblockTrue, m_DL);
 
-        // write_offset += argument[i].size
-        Value* offsetInc = ConstantInt::get(m_ptrSizeIntType, getArgTypeSize(dataType, argDesc->vecSize));
-        writeOffset = BinaryOperator::CreateAdd(writeOffset, offsetInc, "write_offset", bblockTrue);
-        writeOffset->setDebugLoc(m_DL);
-    } // for (SPrintfArgDescriptor *argDesc : m_argDescriptors)
+            // write_offset += argument[i].size
+            Value* offsetInc = ConstantInt::get(m_ptrSizeIntType, getArgTypeSize(dataType, argDesc->vecSize));
+            writeOffset = BinaryOperator::CreateAdd(writeOffset, offsetInc, "write_offset", bblockTrue);
+            writeOffset->setDebugLoc(m_DL);
+        } // for (SPrintfArgDescriptor *argDesc : m_argDescriptors)
+    }
 
     brInst = BranchInst::Create(bblockJoin, bblockTrue);
     brInst->setDebugLoc(m_DL);
@@ -692,6 +697,93 @@ CallInst* OpenCLPrintfResolution::genAtomicAdd(Value *outputBufferPtr,
     return CallInst::Create(m_atomicAddFunc, args, name, &printfCall);
 }
 
+bool OpenCLPrintfResolution::genPackedStores(Value *writeOffset, BasicBlock *bblock)
+{
+    // Gather the record as a sequence of dwords. Only records where every
+    // argument is stored with exactly its reserved size are packed, so the
+    // buffer contents are identical to the per-argument stores.
+    SmallVector<Value*, 32> dwords;
+    std::vector<std::pair<Value*, unsigned>> argParts;
+    for (size_t i = 0, size = m_argDescriptors.size(); i < size; ++i)
+    {
+        SPrintfArgDescriptor *argDesc = &m_argDescriptors[i];
+        Type *argType = argDesc->value->getType();
+        unsigned argSize = (i == 0) ? 4 : getArgTypeSize(argDesc->argType, argDesc->vecSize);
+        if (argType->getPrimitiveSizeInBits() != argSize * 8)
+        {
+            return false;
+        }
+        argParts.push_back(std::make_pair(argDesc->value, argSize / 4));
+    }
+
+    for (size_t i = 0, size = argParts.size(); i < size; ++i)
+    {
+        SPrintfArgDescriptor *argDesc = &m_argDescriptors[i];
+        if (i != 0)
+        {
+            dwords.push_back(ConstantInt::get(m_int32Type, (unsigned int)argDesc->argType));
+            if (argDesc->vecSize > 0)
+            {
+                dwords.push_back(ConstantInt::get(m_int32Type, argDesc->vecSize));
+            }
+        }
+
+        Value *arg = argParts[i].first;
+        unsigned numDwords = argParts[i].second;
+        if (numDwords == 1)
+        {
+            if (arg->getType() != m_int32Type)
+            {
+                arg = CastInst::Create(Instruction::CastOps::BitCast, arg, m_int32Type, "", bblock);
+                cast<Instruction>(arg)->setDebugLoc(m_DL);
+            }
+            dwords.push_back(arg);
+            continue;
+        }
+        Instruction *vec = CastInst::Create(Instruction::CastOps::BitCast, arg,
+            VectorType::get(m_int32Type, numDwords), "", bblock);
+        vec->setDebugLoc(m_DL);
+        for (unsigned j = 0; j < numDwords; ++j)
+        {
+            Instruction *elt = ExtractElementInst::Create(vec, ConstantInt::get(m_int32Type, j), "", bblock);
+            elt->setDebugLoc(m_DL);
+            dwords.push_back(elt);
+        }
+    }
+
+    // Store up to 4 dwords at a time.
+    const unsigned maxDwordsPerStore = 4;
+    for (unsigned i = 0, size = dwords.size(); i < size; i += maxDwordsPerStore)
+    {
+        unsigned numDwords = std::min(maxDwordsPerStore, size - i);
+        Value *storeVal = dwords[i];
+        if (numDwords > 1)
+        {
+            storeVal = UndefValue::get(VectorType::get(m_int32Type, numDwords));
+            for (unsigned j = 0; j < numDwords; ++j)
+            {
+                Instruction *ins = InsertElementInst::Create(storeVal, dwords[i + j],
+                    ConstantInt::get(m_int32Type, j), "", bblock);
+                ins->setDebugLoc(m_DL);
+                storeVal = ins;
+            }
+        }
+
+        Value *addr = writeOffset;
+        if (i > 0)
+        {
+            addr = BinaryOperator::CreateAdd(writeOffset,
+                ConstantInt::get(m_ptrSizeIntType, i * 4), "write_offset", bblock);
+            cast<Instruction>(addr)->setDebugLoc(m_DL);
+        }
+        Instruction *ptr = CastInst::Create(Instruction::CastOps::IntToPtr, addr,
+            storeVal->getType()->getPointerTo(ADDRESS_SPACE_GLOBAL), "write_offset_ptr", bblock);
+        ptr->setDebugLoc(m_DL);
+        genStoreInternal(storeVal, ptr, bblock, m_DL);
+    }
+    return true;
+}
+
 unsigned int OpenCLPrintfResolution::getArgTypeSize(SHADER_PRINTF_TYPE argType, uint vecSize)
 {
     switch (argType) {
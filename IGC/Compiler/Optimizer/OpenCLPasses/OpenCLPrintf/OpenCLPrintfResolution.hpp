@@ -123,6 +123,11 @@ namespace IGC
         llvm::CallInst* genAtomicAdd(llvm::Value *outputBufferPtr, llvm::Value *dataSize,
                                      llvm::CallInst &printfCall, llvm::StringRef name);
 
+        // Stores the whole printf record at writeOffset using stores of up to
+        // 4 dwords. Returns false, without generating anything, if some
+        // argument is not stored with exactly its reserved size.
+        bool genPackedStores(llvm::Value *writeOffset, llvm::BasicBlock *bblock);
+
         // Computes the total size of output buffer space that is necessary
         // to keep the printf arguments.
         unsigned int getTotalDataSize();
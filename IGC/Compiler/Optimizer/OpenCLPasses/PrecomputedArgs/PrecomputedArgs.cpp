@@ -0,0 +1,406 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+
+#include "Compiler/Optimizer/OpenCLPasses/PrecomputedArgs/PrecomputedArgs.hpp"
+#include "Compiler/CodeGenPublic.h"
+#include "Compiler/CISACodeGen/helper.h"
+#include "Compiler/IGCPassSupport.h"
+
+#include "common/LLVMWarningsPush.hpp"
+#include "llvmWrapper/Bitcode/BitcodeWriter.h"
+#include <llvm/ADT/PostOrderIterator.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/Intrinsics.h>
+#include <llvm/Support/raw_ostream.h>
+#include "common/LLVMWarningsPop.hpp"
+
+using namespace llvm;
+using namespace IGC;
+using namespace IGC::IGCMD;
+
+// Register pass to igc-opt
+#define PASS_FLAG "igc-precomputed-args-analysis"
+#define PASS_DESCRIPTION "Hoists argument-only uniform values into a host-evaluated program"
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS false
+IGC_INITIALIZE_PASS_BEGIN(PrecomputedArgsAnalysis, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
+IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+IGC_INITIALIZE_PASS_END(PrecomputedArgsAnalysis, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+
+// Register pass to igc-opt
+#define PASS_FLAG2 "igc-precomputed-args-resolution"
+#define PASS_DESCRIPTION2 "Resolves host-evaluated argument-only uniform values"
+#define PASS_CFG_ONLY2 false
+#define PASS_ANALYSIS2 false
+IGC_INITIALIZE_PASS_BEGIN(PrecomputedArgsResolution, PASS_FLAG2, PASS_DESCRIPTION2, PASS_CFG_ONLY2, PASS_ANALYSIS2)
+IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
+IGC_INITIALIZE_PASS_END(PrecomputedArgsResolution, PASS_FLAG2, PASS_DESCRIPTION2, PASS_CFG_ONLY2, PASS_ANALYSIS2)
+
+const llvm::StringRef GET_PRECOMPUTED_VALUE = "__builtin_IB_get_precomputed_value";
+const llvm::StringRef PRECOMPUTE_ARGS_ENTRY = "PrecomputeArgs";
+
+char PrecomputedArgsAnalysis::ID = 0;
+
+PrecomputedArgsAnalysis::PrecomputedArgsAnalysis() : ModulePass(ID)
+{
+    initializePrecomputedArgsAnalysisPass(*PassRegistry::getPassRegistry());
+}
+
+bool PrecomputedArgsAnalysis::runOnModule(Module &M)
+{
+    if (IGC_IS_FLAG_DISABLED(EnablePrecomputedArgs))
+    {
+        return false;
+    }
+
+    m_pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+
+    bool changed = false;
+    for (Function& F : M)
+    {
+        if (F.isDeclaration() || !isEntryFunc(m_pMdUtils, &F))
+        {
+            continue;
+        }
+        changed |= runOnFunction(F);
+    }
+    return changed;
+}
+
+bool PrecomputedArgsAnalysis::isAllowedInst(const Instruction* inst) const
+{
+    Type* type = inst->getType();
+    if (type->isVectorTy() || type->isPointerTy() || type->isAggregateType())
+    {
+        return false;
+    }
+
+    if (const BinaryOperator* binOp = dyn_cast<BinaryOperator>(inst))
+    {
+        switch (binOp->getOpcode())
+        {
+        case Instruction::UDiv:
+        case Instruction::URem:
+        case Instruction::SDiv:
+        case Instruction::SRem:
+        {
+            // The host evaluates the value even when the kernel would not, so
+            // only keep divisions that cannot trap.
+            const ConstantInt* divisor = dyn_cast<ConstantInt>(binOp->getOperand(1));
+            if (!divisor || divisor->isZero())
+            {
+                return false;
+            }
+            bool isSigned = binOp->getOpcode() == Instruction::SDiv ||
+                binOp->getOpcode() == Instruction::SRem;
+            return !(isSigned && divisor->isMinusOne());
+        }
+        default:
+            return true;
+        }
+    }
+
+    if (const CastInst* cast = dyn_cast<CastInst>(inst))
+    {
+        Type* srcType = cast->getSrcTy();
+        return !srcType->isVectorTy() && !srcType->isPointerTy();
+    }
+
+    if (isa<CmpInst>(inst) || isa<SelectInst>(inst))
+    {
+        return !inst->getOperand(0)->getType()->isVectorTy();
+    }
+
+    if (const IntrinsicInst* intrin = dyn_cast<IntrinsicInst>(inst))
+    {
+        switch (intrin->getIntrinsicID())
+        {
+        case Intrinsic::sqrt:
+        case Intrinsic::fabs:
+        case Intrinsic::floor:
+        case Intrinsic::ceil:
+        case Intrinsic::minnum:
+        case Intrinsic::maxnum:
+        case Intrinsic::fma:
+        case Intrinsic::fmuladd:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    return false;
+}
+
+bool PrecomputedArgsAnalysis::isRoot(const Instruction* inst) const
+{
+    // Values are pushed as one dword of cross-thread data each.
+    Type* type = inst->getType();
+    if (!type->isFloatTy() && !type->isIntegerTy(32))
+    {
+        return false;
+    }
+
+    // A cast of an argument is not worth a slot of its own.
+    if (isa<CastInst>(inst) && isa<Argument>(inst->getOperand(0)))
+    {
+        return false;
+    }
+
+    for (const User* user : inst->users())
+    {
+        if (m_argOnlyValues.count(const_cast<User*>(user)) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+Value* PrecomputedArgsAnalysis::cloneTree(Value* val, Instruction* pos, Module* M)
+{
+    auto mapped = m_vmap.find(val);
+    if (mapped != m_vmap.end())
+    {
+        return mapped->second;
+    }
+
+    if (isa<Constant>(val))
+    {
+        return val;
+    }
+
+    Instruction* inst = cast<Instruction>(val);
+    Instruction* clone = inst->clone();
+    for (unsigned i = 0, e = inst->getNumOperands(); i < e; ++i)
+    {
+        if (isa<Function>(inst->getOperand(i)))
+        {
+            continue;
+        }
+        clone->setOperand(i, cloneTree(inst->getOperand(i), pos, M));
+    }
+
+    if (IntrinsicInst* intrin = dyn_cast<IntrinsicInst>(inst))
+    {
+        Function* decl = Intrinsic::getDeclaration(M, intrin->getIntrinsicID(), inst->getType());
+        cast<CallInst>(clone)->setCalledFunction(decl);
+    }
+
+    clone->insertBefore(pos);
+    m_vmap[inst] = clone;
+    return clone;
+}
+
+bool PrecomputedArgsAnalysis::runOnFunction(Function &F)
+{
+    m_argOnlyValues.clear();
+    m_vmap.clear();
+
+    for (Argument& arg : F.args())
+    {
+        Type* type = arg.getType();
+        if (type->isIntegerTy() || type->isFloatingPointTy())
+        {
+            m_argOnlyValues.insert(&arg);
+        }
+    }
+
+    if (m_argOnlyValues.empty())
+    {
+        return false;
+    }
+
+    // Definitions come before their uses in reverse post order, so a single
+    // walk marks every value computed only from the arguments and constants.
+    ReversePostOrderTraversal<Function*> RPOT(&F);
+    for (BasicBlock* BB : RPOT)
+    {
+        for (Instruction& inst : *BB)
+        {
+            if (!isAllowedInst(&inst))
+            {
+                continue;
+            }
+
+            bool argOnly = true;
+            bool allConstant = true;
+            for (Value* op : inst.operands())
+            {
+                if (isa<Function>(op))
+                {
+                    continue;
+                }
+                if (m_argOnlyValues.count(op) != 0)
+                {
+                    allConstant = false;
+                }
+                else if (!isa<Constant>(op))
+                {
+                    argOnly = false;
+                    break;
+                }
+            }
+
+            if (argOnly && !allConstant)
+            {
+                m_argOnlyValues.insert(&inst);
+            }
+        }
+    }
+
+    SmallVector<Instruction*, m_maxPrecomputedValues> roots;
+    for (Value* val : m_argOnlyValues)
+    {
+        Instruction* inst = dyn_cast<Instruction>(val);
+        if (inst && isRoot(inst))
+        {
+            roots.push_back(inst);
+            if (roots.size() == m_maxPrecomputedValues)
+            {
+                break;
+            }
+        }
+    }
+
+    if (roots.empty())
+    {
+        return false;
+    }
+
+    // Clone all the trees before rewriting the kernel, as a root may feed
+    // another one.
+    LLVMContext& C = F.getContext();
+    std::unique_ptr<Module> program(new Module("PrecomputedArgs", C));
+    program->setDataLayout(F.getParent()->getDataLayout());
+
+    SmallVector<Type*, 8> argTypes;
+    for (Argument& arg : F.args())
+    {
+        argTypes.push_back(arg.getType());
+    }
+    argTypes.push_back(Type::getInt32PtrTy(C));
+    Function* entry = Function::Create(
+        FunctionType::get(Type::getVoidTy(C), argTypes, false),
+        GlobalValue::ExternalLinkage,
+        PRECOMPUTE_ARGS_ENTRY,
+        program.get());
+
+    Function::arg_iterator entryArg = entry->arg_begin();
+    for (Argument& arg : F.args())
+    {
+        m_vmap[&arg] = &(*entryArg++);
+    }
+    Value* results = &(*entryArg);
+
+    IRBuilder<> builder(BasicBlock::Create(C, "entry", entry));
+    Instruction* ret = builder.CreateRetVoid();
+    builder.SetInsertPoint(ret);
+
+    for (unsigned int slot = 0; slot < roots.size(); ++slot)
+    {
+        Value* value = cloneTree(roots[slot], ret, program.get());
+        if (value->getType()->isFloatTy())
+        {
+            value = builder.CreateBitCast(value, builder.getInt32Ty());
+        }
+        builder.CreateStore(value, builder.CreateConstGEP1_32(results, slot));
+    }
+
+    // Read the values back from the implicit args added for them.
+    Module* M = F.getParent();
+    Function* getValue = cast<Function>(M->getOrInsertFunction(
+        GET_PRECOMPUTED_VALUE, Type::getInt32Ty(C), Type::getInt32Ty(C)));
+
+    ImplicitArg::ArgMap numberedArgs;
+    for (unsigned int slot = 0; slot < roots.size(); ++slot)
+    {
+        Instruction* root = roots[slot];
+        IRBuilder<> kernelBuilder(root);
+        Value* value = kernelBuilder.CreateCall(getValue, kernelBuilder.getInt32(slot));
+        if (root->getType()->isFloatTy())
+        {
+            value = kernelBuilder.CreateBitCast(value, root->getType());
+        }
+        root->replaceAllUsesWith(value);
+        numberedArgs[ImplicitArg::PRECOMPUTED_VALUE].insert(slot);
+    }
+
+    ImplicitArgs::addNumberedArgs(F, numberedArgs, m_pMdUtils);
+
+    SmallVector<char, 1024> bitcode;
+    raw_svector_ostream bitcodeStream(bitcode);
+    IGCLLVM::WriteBitcodeToFile(program.get(), bitcodeStream);
+
+    OpenCLProgramContext* ctx = static_cast<OpenCLProgramContext*>(
+        getAnalysis<CodeGenContextWrapper>().getCodeGenContext());
+    auto& precomputed = ctx->m_precomputedArgsPrograms[F.getName().str()];
+    precomputed.bitcode.assign(bitcode.begin(), bitcode.end());
+    precomputed.numValues = roots.size();
+
+    return true;
+}
+
+char PrecomputedArgsResolution::ID = 0;
+
+PrecomputedArgsResolution::PrecomputedArgsResolution() : FunctionPass(ID)
+{
+    initializePrecomputedArgsResolutionPass(*PassRegistry::getPassRegistry());
+}
+
+bool PrecomputedArgsResolution::runOnFunction(Function &F)
+{
+    m_calls.clear();
+
+    visit(F);
+
+    if (m_calls.empty())
+    {
+        return false;
+    }
+
+    ImplicitArgs implicitArgs(F, getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils());
+    for (CallInst* CI : m_calls)
+    {
+        int slot = (int)(cast<ConstantInt>(CI->getArgOperand(0))->getZExtValue());
+        Argument* value = implicitArgs.getNumberedImplicitArg(F, ImplicitArg::PRECOMPUTED_VALUE, slot);
+        assert(value != nullptr);
+
+        CI->replaceAllUsesWith(value);
+        CI->eraseFromParent();
+    }
+
+    return true;
+}
+
+void PrecomputedArgsResolution::visitCallInst(CallInst &CI)
+{
+    if (CI.getCalledFunction() && CI.getCalledFunction()->getName() == GET_PRECOMPUTED_VALUE)
+    {
+        m_calls.push_back(&CI);
+    }
+}
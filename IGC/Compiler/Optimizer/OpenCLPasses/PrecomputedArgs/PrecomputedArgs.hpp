@@ -0,0 +1,115 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#pragma once
+
+#include "AdaptorCommon/ImplicitArgs.hpp"
+#include "Compiler/MetaDataUtilsWrapper.h"
+#include "Compiler/CodeGenContextWrapper.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Pass.h>
+#include <llvm/ADT/SetVector.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/InstVisitor.h>
+#include <llvm/Transforms/Utils/ValueMapper.h>
+#include "common/LLVMWarningsPop.hpp"
+
+namespace IGC
+{
+
+/// @brief  PrecomputedArgsAnalysis finds the uniform values of each kernel that
+///         only depend on its by-value scalar arguments (scale factors, strides,
+///         reciprocal sizes...). Their expression trees are cloned into a small
+///         module that the runtime evaluates once per enqueue, and the values are
+///         read back from numbered PRECOMPUTED_VALUE implicit args instead of
+///         being recomputed by every thread.
+class PrecomputedArgsAnalysis : public llvm::ModulePass
+{
+public:
+    static char ID;
+
+    PrecomputedArgsAnalysis();
+
+    ~PrecomputedArgsAnalysis() {}
+
+    virtual llvm::StringRef getPassName() const override
+    {
+        return "PrecomputedArgsAnalysis";
+    }
+
+    virtual void getAnalysisUsage(llvm::AnalysisUsage &AU) const override
+    {
+        AU.setPreservesCFG();
+        AU.addRequired<MetaDataUtilsWrapper>();
+        AU.addRequired<CodeGenContextWrapper>();
+    }
+
+    virtual bool runOnModule(llvm::Module &M) override;
+
+    bool runOnFunction(llvm::Function &F);
+
+private:
+    bool isAllowedInst(const llvm::Instruction* inst) const;
+    bool isRoot(const llvm::Instruction* inst) const;
+    llvm::Value* cloneTree(llvm::Value* val, llvm::Instruction* pos, llvm::Module* M);
+
+    llvm::SetVector<llvm::Value*> m_argOnlyValues;
+    llvm::ValueToValueMapTy m_vmap;
+    IGCMD::MetaDataUtils* m_pMdUtils = nullptr;
+
+    static const unsigned int m_maxPrecomputedValues = 16;
+};
+
+/// @brief  PrecomputedArgsResolution replaces the placeholder calls left by
+///         PrecomputedArgsAnalysis with the matching PRECOMPUTED_VALUE implicit arg.
+class PrecomputedArgsResolution : public llvm::FunctionPass, public llvm::InstVisitor<PrecomputedArgsResolution>
+{
+public:
+    static char ID;
+
+    PrecomputedArgsResolution();
+
+    ~PrecomputedArgsResolution() {}
+
+    virtual llvm::StringRef getPassName() const override
+    {
+        return "PrecomputedArgsResolution";
+    }
+
+    virtual void getAnalysisUsage(llvm::AnalysisUsage &AU) const override
+    {
+        AU.setPreservesCFG();
+        AU.addRequired<MetaDataUtilsWrapper>();
+    }
+
+    virtual bool runOnFunction(llvm::Function &F) override;
+
+    void visitCallInst(llvm::CallInst &CI);
+
+private:
+    llvm::SmallVector<llvm::CallInst*, 16> m_calls;
+};
+
+}
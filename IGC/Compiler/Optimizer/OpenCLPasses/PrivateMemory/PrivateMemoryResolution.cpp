@@ -813,9 +813,11 @@ bool PrivateMemoryResolution::resolveAllocaInstuctions(bool stackCall)
             // Get buffer information from the analysis
             unsigned int scalarBufferOffset = m_ModAllocaInfo->getBufferOffset(pAI);
             
-            // If we can use SOA layout transpose the memory
+            // If we can use SOA layout transpose the memory, unless the lanes
+            // index the buffer divergently (see LowerGEPForPrivMem)
             Type* pTypeOfAccessedObject = nullptr;
-            bool TransposeMemLayout = CanUseSOALayout(pAI, pTypeOfAccessedObject);
+            bool TransposeMemLayout = !pAI->getMetadata("divergent_index") &&
+                CanUseSOALayout(pAI, pTypeOfAccessedObject);
 
             unsigned int bufferSize = 0;
             if (TransposeMemLayout)
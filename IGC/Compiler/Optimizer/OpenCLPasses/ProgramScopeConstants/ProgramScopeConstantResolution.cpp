@@ -33,6 +33,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvmWrapper/IR/Function.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Instructions.h>
+#include <llvm/Analysis/ConstantFolding.h>
+#include <llvm/ADT/SmallPtrSet.h>
 #include "common/LLVMWarningsPop.hpp"
 
 #include <vector>
@@ -74,6 +76,74 @@ static bool needRunConservatively(const Module &M) {
     return false;
 }
 
+// Replaces loads from a program scope constant at a constant offset with the
+// data itself; once the constant is lowered they would be stateless loads from
+// the constant buffer. The unification passes fold most of them, but unrolling
+// and constant propagation in the codegen pipeline expose more.
+static bool foldConstantOffsetLoads(GlobalVariable* GV, const DataLayout& DL)
+{
+    if (!GV->isConstant() || !GV->hasDefinitiveInitializer())
+    {
+        return false;
+    }
+
+    SmallVector<LoadInst*, 8> loads;
+    SmallVector<Value*, 8> worklist(GV->user_begin(), GV->user_end());
+    SmallPtrSet<Value*, 16> visited;
+    while (!worklist.empty())
+    {
+        Value* V = worklist.pop_back_val();
+        if (!visited.insert(V).second)
+        {
+            continue;
+        }
+        if (LoadInst* LI = dyn_cast<LoadInst>(V))
+        {
+            if (!LI->isVolatile())
+            {
+                loads.push_back(LI);
+            }
+        }
+        else if (isa<GetElementPtrInst>(V) || isa<BitCastInst>(V))
+        {
+            worklist.append(V->user_begin(), V->user_end());
+        }
+    }
+
+    LLVMContext& C = GV->getContext();
+    const unsigned AS = GV->getType()->getAddressSpace();
+    bool changed = false;
+    for (LoadInst* LI : loads)
+    {
+        Type* scalarTy = LI->getType()->getScalarType();
+        if (!scalarTy->isIntegerTy() && !scalarTy->isFloatingPointTy())
+        {
+            continue;
+        }
+
+        APInt offset(DL.getPointerSizeInBits(AS), 0);
+        if (LI->getPointerOperand()->stripAndAccumulateInBoundsConstantOffsets(DL, offset) != GV)
+        {
+            continue;
+        }
+
+        Constant* ptr = ConstantExpr::getBitCast(GV, Type::getInt8PtrTy(C, AS));
+        ptr = ConstantExpr::getGetElementPtr(Type::getInt8Ty(C), ptr, ConstantInt::get(C, offset));
+        ptr = ConstantExpr::getBitCast(ptr, LI->getPointerOperandType());
+        Constant* val = ConstantFoldLoadFromConstPtr(ptr, LI->getType(), DL);
+        // Constant expressions are not handled by the resolution below.
+        if (val && !val->containsConstantExpression())
+        {
+            LI->replaceAllUsesWith(val);
+            LI->eraseFromParent();
+            changed = true;
+        }
+    }
+    // Drop the constant expressions built above.
+    GV->removeDeadConstantUsers();
+    return changed;
+}
+
 bool ProgramScopeConstantResolution::runOnModule(Module &M)
 {
     LLVMContext& C = M.getContext();
@@ -137,6 +207,11 @@ bool ProgramScopeConstantResolution::runOnModule(Module &M)
             continue;
         }
 
+        if (!RunCautiously && IGC_IS_FLAG_ENABLED(EnableProgramScopeConstantFolding))
+        {
+            foldConstantOffsetLoads(pGlobalVar, M.getDataLayout());
+        }
+
         // Get the offset of this constant from the base.
         int offset = -1;
 
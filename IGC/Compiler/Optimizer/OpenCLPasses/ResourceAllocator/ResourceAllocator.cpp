@@ -28,11 +28,16 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/MetaDataApi/MetaDataApi.h"
 #include "Compiler/MetaDataApi/IGCMetaDataDefs.h"
 #include "Compiler/IGCPassSupport.h"
+#include "GenISAIntrinsics/GenIntrinsicInst.h"
+#include "common/debug/Dump.hpp"
 
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/IR/Module.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/ADT/SmallPtrSet.h>
 #include "common/LLVMWarningsPop.hpp"
 
+#include <algorithm>
 #include <vector>
 
 using namespace llvm;
@@ -47,10 +52,73 @@ using namespace IGC::IGCMD;
 IGC_INITIALIZE_PASS_BEGIN(ResourceAllocator, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
 IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
 IGC_INITIALIZE_PASS_DEPENDENCY(ExtensionArgAnalysis)
+IGC_INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
 IGC_INITIALIZE_PASS_END(ResourceAllocator, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
 
 char ResourceAllocator::ID = 0;
 
+// Each loop level an access is nested in makes it count this many times more
+// (as a power of two) when ranking buffers for a BTI.
+static const unsigned LOOP_ACCESS_WEIGHT_SHIFT = 3;
+static const unsigned MAX_LOOP_ACCESS_DEPTH = 4;
+
+/// @brief  Estimates how much a buffer argument gains from stateful access: the number
+///         of loads, stores and block reads/writes addressed through it, weighted by
+///         loop depth. These are the accesses StatelessToStatefull can promote.
+static uint64_t getStatefulAccessScore(const Argument* arg, const LoopInfo& LI)
+{
+    uint64_t score = 0;
+    SmallPtrSet<const Value*, 16> visited;
+    SmallVector<const Value*, 16> worklist;
+    worklist.push_back(arg);
+    while (!worklist.empty())
+    {
+        const Value* V = worklist.pop_back_val();
+        if (!visited.insert(V).second)
+        {
+            continue;
+        }
+        for (const User* U : V->users())
+        {
+            const Instruction* I = dyn_cast<Instruction>(U);
+            if (!I)
+            {
+                continue;
+            }
+
+            const Value* ptr = nullptr;
+            if (const LoadInst* LD = dyn_cast<LoadInst>(I))
+            {
+                ptr = LD->getPointerOperand();
+            }
+            else if (const StoreInst* SI = dyn_cast<StoreInst>(I))
+            {
+                ptr = SI->getPointerOperand();
+            }
+            else if (const GenIntrinsicInst* GII = dyn_cast<GenIntrinsicInst>(I))
+            {
+                if (GII->getIntrinsicID() == GenISAIntrinsic::GenISA_simdBlockRead ||
+                    GII->getIntrinsicID() == GenISAIntrinsic::GenISA_simdBlockWrite)
+                {
+                    ptr = GII->getOperand(0);
+                }
+            }
+
+            if (ptr == V)
+            {
+                unsigned depth = std::min(LI.getLoopDepth(I->getParent()), MAX_LOOP_ACCESS_DEPTH);
+                score += uint64_t(1) << (LOOP_ACCESS_WEIGHT_SHIFT * depth);
+            }
+            else if (isa<GetElementPtrInst>(I) || isa<BitCastInst>(I) ||
+                isa<PHINode>(I) || isa<SelectInst>(I))
+            {
+                worklist.push_back(I);
+            }
+        }
+    }
+    return score;
+}
+
 ResourceAllocator::ResourceAllocator() : ModulePass(ID)
 {
     initializeResourceAllocatorPass(*PassRegistry::getPassRegistry());
@@ -188,6 +256,14 @@ bool ResourceAllocator::runOnFunction(llvm::Function &F)
         paramAllocations[arg.getAssociatedArgNo()] = argAlloc;
     }
 
+    // In selective mode explicit buffers only get a BTI when StatelessToStatefull
+    // can make use of it, and the most accessed ones win when the binding table
+    // cannot hold all of them. The others are only ever accessed stateless.
+    const bool selectiveBTIs =
+        IGC_IS_FLAG_ENABLED(EnableSelectiveBTIAllocation) &&
+        IGC_IS_FLAG_ENABLED(EnableStatelessToStatefull);
+    std::vector<KernelArg> bufferArgs;
+
     for( auto arg : kernelArgs )
     {
         auto argAlloc = ArgAllocMetaDataHandle(ArgAllocMetaData::get());
@@ -243,6 +319,17 @@ bool ResourceAllocator::runOnFunction(llvm::Function &F)
 
         case KernelArg::ArgType::PTR_GLOBAL:
         case KernelArg::ArgType::PTR_CONSTANT:
+            if (selectiveBTIs)
+            {
+                // Gets its BTI, if any, once all other BT entries are known.
+                bufferArgs.push_back(arg);
+                continue;
+            }
+            argAlloc->setType(ResourceTypeEnum::UAVResourceType);
+            argAlloc->setIndex(numUAVs);
+            numUAVs++;
+            break;
+
         case KernelArg::ArgType::PTR_DEVICE_QUEUE:
         case KernelArg::ArgType::IMPLICIT_CONSTANT_BASE:
         case KernelArg::ArgType::IMPLICIT_GLOBAL_BASE:
@@ -293,6 +380,11 @@ bool ResourceAllocator::runOnFunction(llvm::Function &F)
         paramAllocations[arg.getAssociatedArgNo()] = argAlloc;
     }
     
+    if (selectiveBTIs)
+    {
+        allocateBufferBTIs(F, bufferArgs, unsigned(numUAVs + numResources), numUAVs, paramAllocations);
+    }
+
     // Param allocations must be inserted to the Metadata Utils in order.
     MetaDataUtils *pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
     auto funcResourceAllocInfo = pMdUtils->getFunctionsInfoItem(&F)->getResourceAlloc();
@@ -309,3 +401,82 @@ bool ResourceAllocator::runOnFunction(llvm::Function &F)
     
     return true;
 }
+
+void ResourceAllocator::allocateBufferBTIs(
+    llvm::Function &F,
+    const std::vector<KernelArg>& bufferArgs,
+    unsigned numOtherEntries,
+    int& numUAVs,
+    std::vector<ArgAllocMetaDataHandle>& paramAllocations)
+{
+    const LoopInfo& LI = getAnalysis<LoopInfoWrapperPass>(F).getLoopInfo();
+
+    std::vector<uint64_t> scores(bufferArgs.size());
+    std::vector<unsigned> order(bufferArgs.size());
+    for (unsigned i = 0; i < bufferArgs.size(); ++i)
+    {
+        scores[i] = getStatefulAccessScore(bufferArgs[i].getArg(), LI);
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&scores](unsigned a, unsigned b)
+    {
+        return scores[a] > scores[b];
+    });
+
+    unsigned maxEntries = IGC_GET_FLAG_VALUE(SelectiveBTIMaxEntries);
+    unsigned budget = maxEntries > numOtherEntries ? maxEntries - numOtherEntries : 0;
+    std::vector<bool> getsBTI(bufferArgs.size(), false);
+    for (unsigned i = 0; i < order.size() && i < budget; ++i)
+    {
+        getsBTI[order[i]] = scores[order[i]] != 0;
+    }
+
+    // UAV indices follow the argument order, after all other UAVs.
+    std::vector<int> uavIndex(bufferArgs.size(), -1);
+    for (unsigned i = 0; i < bufferArgs.size(); ++i)
+    {
+        auto argAlloc = ArgAllocMetaDataHandle(ArgAllocMetaData::get());
+        if (getsBTI[i])
+        {
+            uavIndex[i] = numUAVs;
+            argAlloc->setType(ResourceTypeEnum::UAVResourceType);
+            argAlloc->setIndex(numUAVs);
+            numUAVs++;
+        }
+        else
+        {
+            argAlloc->setType(ResourceTypeEnum::OtherResourceType);
+        }
+        paramAllocations[bufferArgs[i].getAssociatedArgNo()] = argAlloc;
+    }
+
+    if (IGC_IS_FLAG_ENABLED(DumpResourceAllocation))
+    {
+        CodeGenContext* ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+        auto name =
+            Debug::DumpName(Debug::GetShaderOutputName())
+            .Hash(ctx->hash)
+            .Type(ctx->type)
+            .Pass("ResourceAllocation")
+            .PostFix(F.getName())
+            .Extension("txt");
+        Debug::Dump dump(name, Debug::DumpType::DBG_MSG_TEXT);
+        auto& OS = dump.stream();
+        OS << "Kernel " << F.getName() << ": " << numOtherEntries
+            << " BT entries for other resources, budget " << budget << " for buffers\n";
+        for (unsigned i = 0; i < bufferArgs.size(); ++i)
+        {
+            const Argument* arg = bufferArgs[i].getArg();
+            OS << "  arg " << bufferArgs[i].getAssociatedArgNo() << " " << arg->getName()
+                << ": score " << scores[i] << ", ";
+            if (uavIndex[i] >= 0)
+            {
+                OS << "stateful, UAV " << uavIndex[i] << "\n";
+            }
+            else
+            {
+                OS << (scores[i] == 0 ? "stateless (no promotable accesses)" : "stateless (over budget)") << "\n";
+            }
+        }
+    }
+}
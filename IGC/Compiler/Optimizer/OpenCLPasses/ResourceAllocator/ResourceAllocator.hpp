@@ -28,12 +28,17 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/MetaDataUtilsWrapper.h"
 #include "Compiler/CodeGenContextWrapper.hpp"
 #include "Compiler/Optimizer/OpenCLPasses/ExtenstionFuncs/ExtensionArgAnalysis.hpp"
+#include "Compiler/Optimizer/OpenCLPasses/KernelArgs.hpp"
+#include "Compiler/MetaDataApi/MetaDataApi.h"
 
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/Pass.h>
 #include <llvm/IR/DataLayout.h>
+#include <llvm/Analysis/LoopInfo.h>
 #include "common/LLVMWarningsPop.hpp"
 
+#include <vector>
+
 namespace IGC
 {
     /// @brief This pass allocates UAV and SRV numbers to kernel arguments.
@@ -61,6 +66,7 @@ namespace IGC
             AU.addRequired<MetaDataUtilsWrapper>();
             AU.addRequired<ExtensionArgAnalysis>();
             AU.addRequired<CodeGenContextWrapper>();
+            AU.addRequired<llvm::LoopInfoWrapperPass>();
         }
 
         /// @brief  Main entry point.
@@ -70,6 +76,19 @@ namespace IGC
     protected:
 
         bool runOnFunction(llvm::Function &F);
+
+        /// @brief  Selective BTI allocation: gives UAV numbers to the explicit buffer
+        ///         arguments that benefit from stateful access most, as far as the
+        ///         binding table allows, and leaves the rest stateless.
+        /// @param  bufferArgs       The explicit global and constant buffer arguments.
+        /// @param  numOtherEntries  BT entries already taken by other resources.
+        /// @param  numUAVs          Number of UAVs so far; updated.
+        void allocateBufferBTIs(
+            llvm::Function &F,
+            const std::vector<KernelArg>& bufferArgs,
+            unsigned numOtherEntries,
+            int& numUAVs,
+            std::vector<IGCMD::ArgAllocMetaDataHandle>& paramAllocations);
     };
 
 } // namespace IGC
@@ -193,6 +193,7 @@ bool StatelessToStatefull::runOnFunction(llvm::Function &F)
 	m_pKernelArgs = new KernelArgs(F, &(F.getParent()->getDataLayout()), pMdUtils);
 
     visit(F);
+    m_phiSelectOffsets.clear();
 
 	finalizeArgInitialValue(&F);
     delete m_pImplicitArgs;
@@ -232,28 +233,45 @@ bool StatelessToStatefull::getOffsetFromGEP(
     Function* F, SmallVector<GetElementPtrInst*, 4> GEPs,
     uint32_t argNumber, bool isImplicitArg, Value*& offset)
 {
-    Module* M = F->getParent();
-    const DataLayout* DL = &M->getDataLayout();
-    Type* int32Ty = Type::getInt32Ty(M->getContext());
+    Value *PointerValue = getArgBaseOffset(F, argNumber, isImplicitArg);
+    if (PointerValue == nullptr)
+    {
+        // Sanity check
+        return false;
+    }
+    offset = addGEPOffsets(F, GEPs, PointerValue);
+    return true;
+}
 
-    Value *PointerValue;
+//
+// Return the offset of a kernel argument relative to its surface, which is
+// its BUFFER_OFFSET when present, or zero. Return nullptr if BUFFER_OFFSET
+// is expected but missing.
+//
+Value* StatelessToStatefull::getArgBaseOffset(
+    Function* F, uint32_t argNumber, bool isImplicitArg)
+{
     // When SToSProducesPositivePointer is set, BUFFER_OFFSET are assumed to be zero,
     // so is that for any implicit argument 
     if (m_hasBufferOffsetArg && !isImplicitArg &&
         IGC_IS_FLAG_DISABLED(SToSProducesPositivePointer))
     {
-        PointerValue = getBufferOffsetArg(F, argNumber);
-        if (PointerValue == nullptr)
-        {
-            // Sanity check
-            return false;
-        }
-    }
-    else
-    {
-        // BUFFER_OFFSET are zero.
-        PointerValue = ConstantInt::get(int32Ty, 0);
+        return getBufferOffsetArg(F, argNumber);
     }
+    // BUFFER_OFFSET are zero.
+    return ConstantInt::get(Type::getInt32Ty(F->getContext()), 0);
+}
+
+//
+// Add the byte offsets of GEPs (in the reverse order of execution) to
+// PointerValue, and return the final offset.
+//
+Value* StatelessToStatefull::addGEPOffsets(
+    Function* F, const SmallVector<GetElementPtrInst*, 4>& GEPs, Value* PointerValue)
+{
+    Module* M = F->getParent();
+    const DataLayout* DL = &M->getDataLayout();
+    Type* int32Ty = Type::getInt32Ty(M->getContext());
 
     const int nGEPs = GEPs.size();
 
@@ -322,8 +340,7 @@ bool StatelessToStatefull::getOffsetFromGEP(
             }
         }
     }
-    offset = PointerValue;
-    return true;
+    return PointerValue;
 }
 
 bool StatelessToStatefull::pointerIsPositiveOffsetFromKernelArgument(
@@ -355,7 +372,8 @@ bool StatelessToStatefull::pointerIsPositiveOffsetFromKernelArgument(
     // the original one. Also, if base is still instruction, skip.
     if (gep && cast<PointerType>(base->getType())->getAddressSpace() == ptrAS && !isa<Instruction>(base))
     {
-        if (const KernelArg* arg = getKernelArg(base))
+        const KernelArg* arg = getKernelArg(base);
+        if (arg && hasBindingTableIndex(F, arg))
         {
             // base is the argument!
             argNumber = arg->getAssociatedArgNo();
@@ -396,10 +414,190 @@ bool StatelessToStatefull::pointerIsPositiveOffsetFromKernelArgument(
             }
         }
     }
+
+    if (IGC_IS_FLAG_ENABLED(EnableStatelessToStatefullPhiSelect) &&
+        (isa<PHINode>(base) || isa<SelectInst>(base)))
+    {
+        return pointerIsPositiveOffsetThroughPhiOrSelect(F, V, offset, argNumber);
+    }
    
     return false;
 }
 
+//
+// Handle pointers that reach a kernel argument through phis and selects,
+// such as pointers bumped in a loop:
+//
+//   loop:
+//     %p = phi float addrspace(1)* [ %arg, %entry ], [ %p.next, %loop ]
+//     ... load float, float addrspace(1)* %p
+//     %p.next = getelementptr float, float addrspace(1)* %p, i64 %stride
+//
+// All paths must lead to the same argument. The offset is non-negative by
+// induction if every GEP index on every path is: an incoming value of a phi
+// that loops back to the phi itself only adds non-negative amounts to it.
+// Offsets are rebuilt with i32 phis and selects that mirror the pointer ones.
+//
+bool StatelessToStatefull::pointerIsPositiveOffsetThroughPhiOrSelect(
+    Function* F, Value* V, Value*& offset, unsigned int& argNumber)
+{
+    const KernelArg* arg = nullptr;
+    bool isPositive = true;
+    SmallPtrSet<Value*, 16> visited;
+    unsigned AS = cast<PointerType>(V->getType())->getAddressSpace();
+    if (!tracePointerToKernelArg(F, V, AS, arg, isPositive, visited) || arg == nullptr ||
+        !hasBindingTableIndex(F, arg))
+    {
+        return false;
+    }
+
+    argNumber = arg->getAssociatedArgNo();
+    if (!arg->isImplicitArg() &&
+        (!m_hasBufferOffsetArg || m_hasOptionalBufferOffsetArg) &&
+        IGC_IS_FLAG_DISABLED(SToSProducesPositivePointer))
+    {
+        if (m_hasOptionalBufferOffsetArg)
+        {
+            updateArgInfo(arg, isPositive);
+        }
+    }
+    else
+    {
+        isPositive = true;
+    }
+
+    if ((!isPositive && !m_hasBufferOffsetArg) ||
+        getArgBaseOffset(F, argNumber, arg->isImplicitArg()) == nullptr)
+    {
+        return false;
+    }
+
+    offset = buildOffset(F, V, arg);
+    return true;
+}
+
+//
+// Check that all paths of V through GEPs, phis and selects reach the same
+// kernel argument (returned in arg), and whether all GEP indices on them are
+// non-negative. A phi already being visited is assumed to be non-negative.
+//
+bool StatelessToStatefull::tracePointerToKernelArg(
+    Function* F, Value* V, unsigned AS, const KernelArg*& arg, bool& isPositive,
+    SmallPtrSetImpl<Value*>& visited)
+{
+    const DataLayout* DL = &F->getParent()->getDataLayout();
+    AssumptionCache* AC = getAC(F);
+
+    Value* base = V->stripPointerCasts();
+    while (GetElementPtrInst* gep = dyn_cast<GetElementPtrInst>(base))
+    {
+        for (auto U = gep->idx_begin(), E = gep->idx_end(); U != E; ++U)
+        {
+            isPositive &= valueIsPositive(U->get(), DL, AC);
+        }
+        base = gep->getPointerOperand()->stripPointerCasts();
+    }
+
+    if (cast<PointerType>(base->getType())->getAddressSpace() != AS)
+    {
+        return false;
+    }
+
+    if (isa<PHINode>(base) || isa<SelectInst>(base))
+    {
+        if (!visited.insert(base).second)
+        {
+            return true;
+        }
+        if (visited.size() > MaxTracedPhiSelects)
+        {
+            return false;
+        }
+        if (SelectInst* SI = dyn_cast<SelectInst>(base))
+        {
+            return tracePointerToKernelArg(F, SI->getTrueValue(), AS, arg, isPositive, visited) &&
+                   tracePointerToKernelArg(F, SI->getFalseValue(), AS, arg, isPositive, visited);
+        }
+        PHINode* PN = cast<PHINode>(base);
+        for (unsigned i = 0, e = PN->getNumIncomingValues(); i != e; ++i)
+        {
+            if (!tracePointerToKernelArg(F, PN->getIncomingValue(i), AS, arg, isPositive, visited))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    if (isa<Instruction>(base))
+    {
+        return false;
+    }
+
+    const KernelArg* KA = getKernelArg(base);
+    if (KA == nullptr || (arg != nullptr && arg != KA))
+    {
+        return false;
+    }
+    arg = KA;
+    return true;
+}
+
+//
+// Build the offset of V from the surface of arg. V has been checked by
+// tracePointerToKernelArg(), so this cannot fail. Offsets of phis and selects are cached so that
+// all accesses share them.
+//
+Value* StatelessToStatefull::buildOffset(Function* F, Value* V, const KernelArg* arg)
+{
+    SmallVector<GetElementPtrInst*, 4> GEPs;
+    Value* base = V->stripPointerCasts();
+    while (GetElementPtrInst* gep = dyn_cast<GetElementPtrInst>(base))
+    {
+        GEPs.push_back(gep);
+        base = gep->getPointerOperand()->stripPointerCasts();
+    }
+
+    Type* int32Ty = Type::getInt32Ty(F->getContext());
+    Value* baseOffset = nullptr;
+    auto II = m_phiSelectOffsets.find(base);
+    if (II != m_phiSelectOffsets.end())
+    {
+        baseOffset = II->second;
+    }
+    else if (PHINode* PN = dyn_cast<PHINode>(base))
+    {
+        PHINode* newPN = PHINode::Create(int32Ty, PN->getNumIncomingValues(), "",
+            PN->getParent()->getFirstNonPHI());
+        newPN->setDebugLoc(PN->getDebugLoc());
+        // Cache it first as incoming values may loop back to this phi.
+        m_phiSelectOffsets[PN] = newPN;
+        for (unsigned i = 0, e = PN->getNumIncomingValues(); i != e; ++i)
+        {
+            Value* incoming = buildOffset(F, PN->getIncomingValue(i), arg);
+            newPN->addIncoming(incoming, PN->getIncomingBlock(i));
+        }
+        baseOffset = newPN;
+    }
+    else if (SelectInst* SI = dyn_cast<SelectInst>(base))
+    {
+        Value* trueOffset = buildOffset(F, SI->getTrueValue(), arg);
+        Value* falseOffset = buildOffset(F, SI->getFalseValue(), arg);
+        SelectInst* newSI = SelectInst::Create(SI->getCondition(), trueOffset, falseOffset, "", SI);
+        newSI->setDebugLoc(SI->getDebugLoc());
+        m_phiSelectOffsets[SI] = newSI;
+        baseOffset = newSI;
+    }
+    else
+    {
+        // Checked in pointerIsPositiveOffsetThroughPhiOrSelect().
+        baseOffset = getArgBaseOffset(F, arg->getAssociatedArgNo(), arg->isImplicitArg());
+        assert(baseOffset && "Missing BufferOffset arg!");
+    }
+
+    return addGEPOffsets(F, GEPs, baseOffset);
+}
+
 void StatelessToStatefull::visitCallInst(CallInst &I) 
 {
 	if (auto Inst = dyn_cast<GenIntrinsicInst>(&I))
@@ -581,6 +779,17 @@ CallInst* StatelessToStatefull::createBufferPtr(unsigned addrSpace, Constant* ar
     return pBufferPtrInst;
 }
 
+// ResourceAllocator may leave buffers without a BTI (EnableSelectiveBTIAllocation);
+// their accesses have to stay stateless.
+bool StatelessToStatefull::hasBindingTableIndex(Function* F, const KernelArg* arg)
+{
+    MetaDataUtils *pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+    ResourceAllocMetaDataHandle resAllocMD = pMdUtils->getFunctionsInfoItem(F)->getResourceAlloc();
+    assert(resAllocMD->hasValue() && "Resource Allocation Information not present");
+    ArgAllocMetaDataHandle argInfo = resAllocMD->getArgAllocsItem(arg->getAssociatedArgNo());
+    return argInfo->getType() == ResourceTypeEnum::UAVResourceType;
+}
+
 // This is used to set the size for a pointer to a given addrspace, which is created
 // and used by and within IGC. As this is a new address space,  all the existing ones
 // will not be affected by this at all.  (And it definitely does not change any existing
@@ -31,6 +31,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/Pass.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallPtrSet.h>
 #include <llvm/IR/InstVisitor.h>
 #include <llvm/IR/Instruction.h>
 #include <llvm/Analysis/AssumptionCache.h>
@@ -75,7 +77,18 @@ namespace IGC
         bool getOffsetFromGEP(
             llvm::Function* F, llvm::SmallVector<llvm::GetElementPtrInst*, 4> GEPs,
             uint32_t argNumber, bool isImplicitArg, llvm::Value*& offset);
+        llvm::Value* getArgBaseOffset(llvm::Function* F, uint32_t argNumber, bool isImplicitArg);
+        llvm::Value* addGEPOffsets(
+            llvm::Function* F, const llvm::SmallVector<llvm::GetElementPtrInst*, 4>& GEPs,
+            llvm::Value* PointerValue);
+        bool pointerIsPositiveOffsetThroughPhiOrSelect(
+            llvm::Function* F, llvm::Value* V, llvm::Value*& offset, unsigned int& argNumber);
+        bool tracePointerToKernelArg(
+            llvm::Function* F, llvm::Value* V, unsigned AS, const KernelArg*& arg,
+            bool& isPositive, llvm::SmallPtrSetImpl<llvm::Value*>& visited);
+        llvm::Value* buildOffset(llvm::Function* F, llvm::Value* V, const KernelArg* arg);
         llvm::Argument* getBufferOffsetArg(llvm::Function* F, uint32_t ArgNumber);
+        bool hasBindingTableIndex(llvm::Function* F, const KernelArg* arg);
         void setPointerSizeTo32bit(int32_t AddrSpace, llvm::Module* M);
 
 		void updateArgInfo(const KernelArg *KA, bool IsPositive);
@@ -122,6 +135,12 @@ namespace IGC
 		KernelArgs   *m_pKernelArgs;
 		ArgInfoMap   m_argsInfo;
         bool m_changed;
+
+        // Offsets built for pointer phis and selects in the current function.
+        llvm::DenseMap<llvm::Value*, llvm::Value*> m_phiSelectOffsets;
+
+        // Limit on the phis and selects traced for one pointer.
+        static const unsigned MaxTracedPhiSelects = 16;
     };
 
 }
@@ -83,6 +83,8 @@ bool WIFuncsAnalysis::runOnFunction(Function &F)
 {
     // Processing new function
     m_hasLocalID           = false;
+    m_hasLocalIDY          = false;
+    m_hasLocalIDZ          = false;
     m_hasGlobalSize        = false;
     m_hasLocalSize         = false;
     m_hasWorkDim           = false;
@@ -120,9 +122,18 @@ bool WIFuncsAnalysis::runOnFunction(Function &F)
     }
     if ( m_hasLocalID )
     {
+        // Local ids are delivered as consecutive channels (x, y, z), so only
+        // trailing unused ones can be left out of the per-thread payload.
+        bool trimLocalIDs = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData()->compOpt.TrimLocalIDs;
         implicitArgs.push_back(ImplicitArg::LOCAL_ID_X);
-        implicitArgs.push_back(ImplicitArg::LOCAL_ID_Y);
-        implicitArgs.push_back(ImplicitArg::LOCAL_ID_Z);
+        if (!trimLocalIDs || m_hasLocalIDY || m_hasLocalIDZ)
+        {
+            implicitArgs.push_back(ImplicitArg::LOCAL_ID_Y);
+        }
+        if (!trimLocalIDs || m_hasLocalIDZ)
+        {
+            implicitArgs.push_back(ImplicitArg::LOCAL_ID_Z);
+        }
     }
     if ( m_hasEnqueuedLocalSize )
     {
@@ -157,6 +168,8 @@ void WIFuncsAnalysis::visitCallInst(CallInst &CI)
         funcName.equals(GET_LOCAL_ID_Z) )
     {
         m_hasLocalID = true;
+        m_hasLocalIDY |= funcName.equals(GET_LOCAL_ID_Y);
+        m_hasLocalIDZ |= funcName.equals(GET_LOCAL_ID_Z);
     }
     else if( funcName.equals(GET_GLOBAL_SIZE) )
     {
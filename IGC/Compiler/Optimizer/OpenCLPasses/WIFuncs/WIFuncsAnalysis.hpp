@@ -98,6 +98,9 @@ namespace IGC
 
         /// @brief  Marks whether local id is needed by the current function
         bool m_hasLocalID;
+        /// @brief  Marks whether local id y/z is needed by the current function
+        bool m_hasLocalIDY;
+        bool m_hasLocalIDZ;
         /// @brief  Marks whether global size is needed by the current function
         bool m_hasGlobalSize;
         /// @brief  Marks whether local size is needed by the current function
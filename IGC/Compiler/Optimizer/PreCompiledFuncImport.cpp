@@ -334,6 +334,101 @@ bool PreCompiledFuncImport::preProcessDouble()
     return (toBeDeleted.size() > 0);
 }
 
+// This function rewrites double divisions into multiplications where that is
+// allowed, as an emulated dp_mul is much cheaper than an emulated dp_div:
+//   1. x / C, where C has an exact inverse  --> x * (1/C)
+//   2. x / C with 'arcp'                    --> x * (1/C), 1/C rounded
+//   3. x_i / y with 'arcp', y shared by two or more of such divisions
+//                                           --> r = 1/y; x_i * r
+bool PreCompiledFuncImport::preProcessDivide()
+{
+    SmallVector<BinaryOperator *, 8> toBeDeleted;
+    for (auto II = m_pModule->begin(), IE = m_pModule->end(); II != IE; ++II)
+    {
+        Function *Func = &(*II);
+        SmallVector<BinaryOperator *, 8> rcpDivs;
+        DenseMap<Value *, unsigned> numRcpDivs;
+        for (inst_iterator i = inst_begin(Func), e = inst_end(Func);
+             i != e; ++i)
+        {
+            BinaryOperator *BO = dyn_cast<BinaryOperator>(&*i);
+            if (!BO || BO->getOpcode() != Instruction::FDiv ||
+                !BO->getType()->isDoubleTy())
+            {
+                continue;
+            }
+
+            Value *divisor = BO->getOperand(1);
+            if (ConstantFP *C = dyn_cast<ConstantFP>(divisor))
+            {
+                APFloat inverse(0.0);
+                if (!C->getValueAPF().getExactInverse(&inverse))
+                {
+                    if (!BO->hasAllowReciprocal() || C->isZero())
+                        continue;
+                    inverse = APFloat(1.0);
+                    inverse.divide(C->getValueAPF(), APFloat::rmNearestTiesToEven);
+                }
+                Instruction *mul = BinaryOperator::Create(Instruction::FMul,
+                    BO->getOperand(0), ConstantFP::get(BO->getType(), inverse), "", BO);
+                mul->copyIRFlags(BO);
+                mul->setDebugLoc(BO->getDebugLoc());
+                mul->takeName(BO);
+                BO->replaceAllUsesWith(mul);
+                toBeDeleted.push_back(BO);
+            }
+            else if (BO->hasAllowReciprocal() &&
+                     (isa<Instruction>(divisor) || isa<Argument>(divisor)))
+            {
+                rcpDivs.push_back(BO);
+                ++numRcpDivs[divisor];
+            }
+        }
+
+        // Only share reciprocals which save at least one division.
+        DenseMap<Value *, Instruction *> rcps;
+        for (auto BO : rcpDivs)
+        {
+            Value *divisor = BO->getOperand(1);
+            if (numRcpDivs[divisor] < 2)
+                continue;
+
+            Instruction *&rcp = rcps[divisor];
+            if (!rcp)
+            {
+                Instruction *insertPt;
+                if (Instruction *DI = dyn_cast<Instruction>(divisor))
+                {
+                    insertPt = isa<PHINode>(DI) ?
+                        &*DI->getParent()->getFirstInsertionPt() : DI->getNextNode();
+                }
+                else
+                {
+                    insertPt = &*Func->getEntryBlock().getFirstInsertionPt();
+                }
+                rcp = BinaryOperator::Create(Instruction::FDiv,
+                    ConstantFP::get(BO->getType(), 1.0), divisor, "DPEmuRcp", insertPt);
+                rcp->copyIRFlags(BO);
+                rcp->setDebugLoc(BO->getDebugLoc());
+            }
+            Instruction *mul = BinaryOperator::Create(Instruction::FMul,
+                BO->getOperand(0), rcp, "", BO);
+            mul->copyIRFlags(BO);
+            mul->setDebugLoc(BO->getDebugLoc());
+            mul->takeName(BO);
+            BO->replaceAllUsesWith(mul);
+            toBeDeleted.push_back(BO);
+        }
+    }
+
+    for (auto BO : toBeDeleted)
+    {
+        BO->eraseFromParent();
+    }
+
+    return (toBeDeleted.size() > 0);
+}
+
 inline bool isPrecompiledEmulationFunction(Function* func)
 {
     return func->getName().contains("precompiled_s32divrem") ||
@@ -373,6 +468,11 @@ bool PreCompiledFuncImport::runOnModule(Module &M)
     {
         m_changed = true;
     }
+
+    if (isDPEmu() && IGC_IS_FLAG_ENABLED(EnableDPEmuDivRewrite) && preProcessDivide())
+    {
+        m_changed = true;
+    }
  
     unsigned int count = 0;
     while (count < 2)
@@ -461,11 +561,12 @@ bool PreCompiledFuncImport::runOnModule(Module &M)
 			Func->removeFnAttr(llvm::Attribute::AlwaysInline);
 
 			// Inline all conv functions. And for others, inline
-			// only those that have less than 4 uses. If ForceSubroutine
+			// only those that have less than DPEmuSubroutineUseThreshold
+			// (4 by default) uses. If ForceSubroutine
             // is set, do not inline any of them.
 			if (m_enableSubroutineCallForEmulation &&
                 (IGC_IS_FLAG_ENABLED(ForceSubroutineForEmulation) ||
-				 (Func->hasNUsesOrMore(4) && !isDPConvFunc(Func) && !isPrecompiledEmulationFunction(Func))))
+				 (Func->hasNUsesOrMore(IGC_GET_FLAG_VALUE(DPEmuSubroutineUseThreshold)) && !isDPConvFunc(Func) && !isPrecompiledEmulationFunction(Func))))
 			{
 				Func->addFnAttr(llvm::Attribute::NoInline);
 			}
@@ -179,6 +179,7 @@ namespace IGC
 		ImplicitArgs* getImplicitArgs(llvm::Function *F);
 
         bool preProcessDouble();
+        bool preProcessDivide();
         void eraseFunction(llvm::Module* M, llvm::Function *F) {
             M->getFunctionList().remove(F);
             delete F;
@@ -115,6 +115,12 @@ bool ScalarizeFunction::runOnFunction(Function &F)
     m_SCM.clear();
     releaseAllSCMEntries();
     m_DRL.clear();
+    m_keptVectorInsts.clear();
+
+    if (IGC_IS_FLAG_ENABLED(EnableSelectiveScalarization))
+    {
+        collectKeptVectorInsts();
+    }
 
     // Scalarization. Iterate over all the instructions
     // Always hold the iterator at the instruction following the one being scalarized (so the
@@ -165,6 +171,13 @@ void ScalarizeFunction::dispatchInstructionToScalarize(Instruction *I)
         return;
     }
 
+    if (m_keptVectorInsts.count(I))
+    {
+        V_PRINT(scalarizer, "\tInstruction only feeds sends or stores. Kept as vector..\n");
+        recoverNonScalarizableInst(I);
+        return;
+    }
+
     switch (I->getOpcode())
     {
         case Instruction::Add :
@@ -243,6 +256,55 @@ void ScalarizeFunction::dispatchInstructionToScalarize(Instruction *I)
     }
 }
 
+void ScalarizeFunction::collectKeptVectorInsts()
+{
+    // Walk backwards so that users are usually visited before their
+    // definitions. Values reaching a use through a PHI are not kept.
+    auto isVectorProducer = [](Value *V)
+    {
+        return isa<LoadInst>(V) || isa<InsertElementInst>(V) || isa<ShuffleVectorInst>(V);
+    };
+    for (auto BI = m_currFunc->getBasicBlockList().rbegin(),
+        BE = m_currFunc->getBasicBlockList().rend(); BI != BE; ++BI)
+    {
+        for (auto II = BI->rbegin(), IE = BI->rend(); II != IE; ++II)
+        {
+            Instruction *I = &*II;
+            if (StoreInst *SI = dyn_cast<StoreInst>(I))
+            {
+                // a vector store of a loaded or built vector stays a block write
+                if (isa<VectorType>(SI->getValueOperand()->getType()) &&
+                    isVectorProducer(SI->getValueOperand()))
+                {
+                    m_keptVectorInsts.insert(SI);
+                }
+                continue;
+            }
+            if (!isa<VectorType>(I->getType()) || !isVectorProducer(I) || I->use_empty())
+            {
+                continue;
+            }
+            bool onlyFeedsSends = true;
+            for (User *U : I->users())
+            {
+                Instruction *UI = cast<Instruction>(U);
+                bool isSink = isa<CallInst>(UI) ||
+                    (isa<StoreInst>(UI) && m_keptVectorInsts.count(UI)) ||
+                    (isVectorProducer(UI) && !isa<LoadInst>(UI) && m_keptVectorInsts.count(UI));
+                if (!isSink)
+                {
+                    onlyFeedsSends = false;
+                    break;
+                }
+            }
+            if (onlyFeedsSends)
+            {
+                m_keptVectorInsts.insert(I);
+            }
+        }
+    }
+}
+
 void ScalarizeFunction::recoverNonScalarizableInst(Instruction *Inst)
 {
     V_PRINT(scalarizer, "\t\tInstruction is not scalarizable.\n");
@@ -94,6 +94,10 @@ namespace IGC
         /// @param Inst instruction to work on
         void recoverNonScalarizableInst(llvm::Instruction *Inst);
 
+        /// @brief Find the vector loads, stores and payload building instructions
+        ///  whose values only flow into sends or stores, and keep them as vectors
+        void collectKeptVectorInsts();
+
         /*! \name Scalarizarion Functions
          *  \{ */
         /// @brief Scalarize an instruction
@@ -160,6 +164,8 @@ namespace IGC
 
         /// @brief Set containing all the removed instructions in the function.
         llvm::SmallDenseSet<llvm::Instruction*, ESTIMATED_INST_NUM> m_removedInsts;
+        /// @brief Set containing the vector instructions which are not scalarized
+        llvm::SmallPtrSet<llvm::Instruction*, 32> m_keptVectorInsts;
         /// @brief Counters for "transpose" statistics
         int m_transposeCtr[llvm::Instruction::OtherOpsEnd];
 
@@ -26,6 +26,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "GenISAIntrinsics/GenIntrinsicInst.h"
 #include "ThreadCombining.hpp"
 #include "Compiler/IGCPassSupport.h"
+#include "Compiler/CISACodeGen/helper.h"
+#include "Compiler/Optimizer/OpenCLPasses/WIFuncs/WIFuncsAnalysis.hpp"
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/Transforms/Utils/BasicBlockUtils.h>
 #include "common/LLVMWarningsPop.hpp"
@@ -719,3 +721,195 @@ bool ThreadCombining::runOnModule(llvm::Module& M)
 
     return true;
 }
+
+char IGC::OpenCLThreadCombining::ID = 0;
+
+#undef PASS_FLAG
+#undef PASS_DESCRIPTION
+#undef PASS_CFG_ONLY
+#undef PASS_ANALYSIS
+#define PASS_FLAG "igc-ocl-threadcombining"
+#define PASS_DESCRIPTION "Combine the logical work groups of OpenCL kernels with a tiny required work group size"
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS false
+IGC_INITIALIZE_PASS_BEGIN(OpenCLThreadCombining, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
+IGC_INITIALIZE_PASS_END(OpenCLThreadCombining, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+
+bool OpenCLThreadCombining::canCombine(Function& F) const
+{
+    // Kernel arguments pointing to SLM are shared by the whole hardware group
+    for (auto& arg : F.args())
+    {
+        PointerType* PTy = dyn_cast<PointerType>(arg.getType());
+        if (PTy && PTy->getAddressSpace() == ADDRESS_SPACE_LOCAL)
+        {
+            return false;
+        }
+    }
+
+    for (auto& BB : F)
+    {
+        for (auto& I : BB)
+        {
+            for (unsigned int i = 0; i < I.getNumOperands(); ++i)
+            {
+                GlobalVariable* GV = dyn_cast<GlobalVariable>(I.getOperand(i));
+                if (GV && GV->getType()->getAddressSpace() == ADDRESS_SPACE_LOCAL)
+                {
+                    return false;
+                }
+            }
+
+            CallInst* CI = dyn_cast<CallInst>(&I);
+            if (!CI)
+            {
+                continue;
+            }
+            Function* callee = CI->getCalledFunction();
+            // The id rewrite only sees the kernel body, so give up on anything
+            // that is not a builtin declaration.
+            if (!callee || !callee->isDeclaration())
+            {
+                return false;
+            }
+            StringRef name = callee->getName();
+            if (name.contains("barrier") ||
+                name.contains("sub_group") ||
+                name.contains("simd") ||
+                name.contains("work_group") ||
+                name.contains("enqueue"))
+            {
+                return false;
+            }
+            if (name.equals(WIFuncsAnalysis::GET_GROUP_ID) &&
+                !isa<ConstantInt>(CI->getArgOperand(0)))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// Rewrites the kernel for a hardware group of (sizeX * factor, 1, 1):
+///   hwLocalId = get_local_id_x(), hwGroupId = get_group_id(0)
+///   local_id_x  -> hwLocalId % sizeX
+///   group_id(0) -> hwGroupId * factor + hwLocalId / sizeX
+/// and lanes belonging to a logical group past get_num_groups(0) return early.
+void OpenCLThreadCombining::combine(Function& F, unsigned int sizeX, unsigned int factor)
+{
+    Module* M = F.getParent();
+    IRBuilder<> builder(M->getContext());
+
+    std::vector<CallInst*> localIdCalls;
+    std::vector<CallInst*> groupIdCalls;
+    for (auto& BB : F)
+    {
+        for (auto& I : BB)
+        {
+            CallInst* CI = dyn_cast<CallInst>(&I);
+            if (!CI || !CI->getCalledFunction())
+            {
+                continue;
+            }
+            StringRef name = CI->getCalledFunction()->getName();
+            if (name.equals(WIFuncsAnalysis::GET_LOCAL_ID_X))
+            {
+                localIdCalls.push_back(CI);
+            }
+            else if (name.equals(WIFuncsAnalysis::GET_GROUP_ID) &&
+                cast<ConstantInt>(CI->getArgOperand(0))->isZero())
+            {
+                groupIdCalls.push_back(CI);
+            }
+        }
+    }
+
+    Type* int32Ty = builder.getInt32Ty();
+    Function* localIdFn = cast<Function>(M->getOrInsertFunction(
+        WIFuncsAnalysis::GET_LOCAL_ID_X, FunctionType::get(int32Ty, false)));
+    Function* groupIdFn = cast<Function>(M->getOrInsertFunction(
+        WIFuncsAnalysis::GET_GROUP_ID, FunctionType::get(int32Ty, int32Ty, false)));
+    Function* numGroupsFn = cast<Function>(M->getOrInsertFunction(
+        WIFuncsAnalysis::GET_NUM_GROUPS, FunctionType::get(int32Ty, int32Ty, false)));
+
+    BasicBlock* entry = &F.getEntryBlock();
+    BasicBlock::iterator insertPt = entry->getFirstInsertionPt();
+    while (isa<AllocaInst>(&*insertPt))
+    {
+        ++insertPt;
+    }
+    BasicBlock* body = entry->splitBasicBlock(insertPt, "combined.body");
+    BasicBlock* exit = BasicBlock::Create(M->getContext(), "combined.exit", &F, body);
+    ReturnInst::Create(M->getContext(), exit);
+
+    builder.SetInsertPoint(entry->getTerminator());
+    Value* hwLocalId = builder.CreateCall(localIdFn);
+    Value* hwGroupId = builder.CreateCall(groupIdFn, builder.getInt32(0));
+    Value* localId = builder.CreateURem(hwLocalId, builder.getInt32(sizeX));
+    Value* groupId = builder.CreateAdd(
+        builder.CreateMul(hwGroupId, builder.getInt32(factor)),
+        builder.CreateUDiv(hwLocalId, builder.getInt32(sizeX)));
+    Value* numGroups = builder.CreateCall(numGroupsFn, builder.getInt32(0));
+    Value* outOfRange = builder.CreateICmpUGE(groupId, numGroups);
+    builder.CreateCondBr(outOfRange, exit, body);
+    entry->getTerminator()->eraseFromParent();
+
+    for (auto CI : localIdCalls)
+    {
+        CI->replaceAllUsesWith(localId);
+        CI->eraseFromParent();
+    }
+    for (auto CI : groupIdCalls)
+    {
+        CI->replaceAllUsesWith(groupId);
+        CI->eraseFromParent();
+    }
+}
+
+bool OpenCLThreadCombining::runOnModule(Module& M)
+{
+    CodeGenContext* context = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+    IGCMD::MetaDataUtils* pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+    ModuleMetaData* modMD = context->getModuleMetaData();
+
+    // Smallest hardware thread group worth filling: one SIMD8 thread.
+    const unsigned int combinedSize = 8;
+
+    bool changed = false;
+    for (auto& F : M)
+    {
+        if (F.isDeclaration() || !isEntryFunc(pMdUtils, &F))
+        {
+            continue;
+        }
+
+        IGCMD::ThreadGroupSizeMetaDataHandle tgMD =
+            pMdUtils->getFunctionsInfoItem(&F)->getThreadGroupSize();
+        if (!tgMD->hasValue() ||
+            tgMD->getYDim() != 1 ||
+            tgMD->getZDim() != 1)
+        {
+            continue;
+        }
+        unsigned int sizeX = tgMD->getXDim();
+        if (sizeX == 0 || sizeX >= combinedSize || combinedSize % sizeX != 0)
+        {
+            continue;
+        }
+
+        auto subGroupSize = pMdUtils->getFunctionsInfoItem(&F)->getSubGroupSize();
+        if (subGroupSize->hasValue() || !canCombine(F))
+        {
+            continue;
+        }
+
+        unsigned int factor = combinedSize / sizeX;
+        combine(F, sizeX, factor);
+        modMD->FuncMD[&F].workGroupCombineFactor = factor;
+        changed = true;
+    }
+    return changed;
+}
@@ -37,6 +37,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/CISACodeGen/ShaderCodeGen.hpp"
 
 void initializeThreadCombiningPass(llvm::PassRegistry &);
+void initializeOpenCLThreadCombiningPass(llvm::PassRegistry &);
 
 namespace IGC
 {
@@ -103,4 +104,43 @@ namespace IGC
         bool canDoOptimization(llvm::Function* m_kernel, llvm::Module& M);
         void FindRegistersAliveAcrossBarriers(llvm::Function* m_kernel, llvm::Module& M);
     };
+
+    /// @brief  Packs several logical work groups of an OpenCL kernel with a tiny
+    ///         required work group size into one hardware thread group so the
+    ///         SIMD lanes are not left idle. The kernel is dispatched with a local
+    ///         size of (X * factor, 1, 1) and ceil(numGroups / factor) groups while
+    ///         all the implicit arguments keep their NDRange values; the local and
+    ///         group id computations are rewritten to recover the logical ids.
+    ///         Only kernels without barriers, SLM, sub group or work group
+    ///         functions are combined, as those would observe the packing.
+    class OpenCLThreadCombining : public llvm::ModulePass
+    {
+    public:
+        static char ID;
+
+        OpenCLThreadCombining()
+            : ModulePass(ID)
+        {
+            initializeOpenCLThreadCombiningPass(*llvm::PassRegistry::getPassRegistry());
+        }
+
+        ~OpenCLThreadCombining() {}
+
+        virtual llvm::StringRef getPassName() const override
+        {
+            return "OpenCLThreadCombining";
+        }
+
+        bool runOnModule(llvm::Module& M) override;
+
+        virtual void getAnalysisUsage(llvm::AnalysisUsage& AU) const override
+        {
+            AU.addRequired<CodeGenContextWrapper>();
+            AU.addRequired<MetaDataUtilsWrapper>();
+        }
+
+    private:
+        bool canCombine(llvm::Function& F) const;
+        void combine(llvm::Function& F, unsigned int sizeX, unsigned int factor);
+    };
 }
\ No newline at end of file
@@ -56,6 +56,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "../AdaptorOCL/OCL/LoadBuffer.h"
 
+#include <cstring>
 #include <string>
 #include <list>
 #include <fstream>
@@ -469,14 +470,20 @@ int main(int argc, char *argv[])
 			OS_sizet64.str().size());
 	}
 	
-	//Now to add all of the sections in the file
-	for (auto elf_iterator : ElfMap) 
+	//Now to add all of the sections in the file. Their data stays alive in
+	//ElfMap, so only reserve the space and write it once the layout is known.
+	std::vector<unsigned int> ElfMapSections;
+	for (auto &elf_iterator : ElfMap) 
 	{
-		CreateElfSection(pWriter,
-			sectionNode,
-			elf_iterator.first,
-			const_cast<char*>(elf_iterator.second.data()),
-			elf_iterator.second.size());
+		sectionNode.Name = elf_iterator.first;
+		sectionNode.pData = NULL;
+		sectionNode.DataSize = elf_iterator.second.size();
+		sectionNode.Flags = 0;
+		sectionNode.Type = SH_TYPE_PROG_BITS;
+
+		unsigned int sectionIndex = 0;
+		pWriter->ReserveSection(&sectionNode, sectionIndex);
+		ElfMapSections.push_back(sectionIndex);
 	}
 
 	// Resolve size of ELF blob
@@ -490,6 +497,14 @@ int main(int argc, char *argv[])
 	}
 	pWriter->ResolveBinary(ElfBlob, dataSize);
 
+	auto sectionIt = ElfMapSections.begin();
+	for (auto &elf_iterator : ElfMap)
+	{
+		memcpy(pWriter->GetSectionData(ElfBlob, *sectionIt++),
+			elf_iterator.second.data(),
+			elf_iterator.second.size());
+	}
+
 	// Write ELF file to disk
 	std::ofstream ofs(OutputPath, std::ifstream::binary);
 	ofs.write(ElfBlob, dataSize);
@@ -559,27 +559,21 @@ void GenISAIntrinsic::getIntrinsicInfoTableEntries(GenISAIntrinsic::ID id,
 }
 
 GenISAIntrinsic::ID GenISAIntrinsic::getIntrinsicID(const Function *F) {
-    IGC::LLVMContextWrapper::SafeIntrinsicIDCacheTy* safeIntrinsicIDCache =
-        &(static_cast<IGC::LLVMContextWrapper*>(&F->getContext())->m_SafeIntrinsicIDCache);
-    
-    //If you do not find the function ptr as key corresponding to the GenISAIntrinsic::ID add the new key
-    auto it = (*safeIntrinsicIDCache).find(F);
-    if (it == (*safeIntrinsicIDCache).end()) {
-        const ValueName *valueName = F->getValueName();
-        GenISAIntrinsic::ID Id = no_intrinsic;
-        llvm::StringRef prefix = getGenIntrinsicPrefix();
-        llvm::StringRef Name = valueName->getKey();
-        assert(Name.size()>prefix.size() && Name.startswith(prefix) && "Not a valid gen intrinsic name signature\n");
-        Id = lookupGenIntrinsicID(Name.data(), Name.size());
-        (*safeIntrinsicIDCache)[F] = Id;
-        return Id;
-    }
-    else
-    {
-        // If you have an entry for the function ptr corresponding to the GenISAIntrinsic::ID return it back,
-        //instead of going through a lengthy look-up.
-        return (static_cast<GenISAIntrinsic::ID>(it->second)); 
+    IGC::LLVMContextWrapper::SafeIntrinsicIDCacheTy &safeIntrinsicIDCache =
+        static_cast<IGC::LLVMContextWrapper*>(&F->getContext())->m_SafeIntrinsicIDCache;
+
+    // The first query resolves the name through the generated perfect hash; later ones
+    // are a single pointer lookup. The ValueMap drops the entry if F is deleted or RAUW'd.
+    auto it = safeIntrinsicIDCache.find(F);
+    if (it != safeIntrinsicIDCache.end()) {
+        return static_cast<GenISAIntrinsic::ID>(it->second);
     }
+    llvm::StringRef Name = F->getName();
+    assert(Name.size() > strlen(getGenIntrinsicPrefix()) && Name.startswith(getGenIntrinsicPrefix()) &&
+        "Not a valid gen intrinsic name signature\n");
+    GenISAIntrinsic::ID Id = lookupGenIntrinsicID(Name.data(), int_cast<unsigned int>(Name.size()));
+    safeIntrinsicIDCache.insert(std::make_pair(F, (unsigned)Id));
+    return Id;
 }
 
 GenISAIntrinsic::ID GenISAIntrinsic::lookupGenIntrinsicID(const char *Name, unsigned int Len)
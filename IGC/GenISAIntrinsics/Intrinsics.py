@@ -144,114 +144,102 @@ def generateIDArray():
     f.write("#endif\n\n")
     f.close()
 
-def numberofCharacterMatches(array_of_strings):
-    other_array = []
-    if isinstance(array_of_strings,list):
-        for i in range(len(array_of_strings)):
-            final_num = 0
-            char_string = str()
-            for j in range(len(array_of_strings[i])):
-                char_string += array_of_strings[i][j]
-                matching = [s for s in array_of_strings if char_string == s[:len(char_string)]]
-                if len(matching) <= 1:
-                    break
-                else:
-                    final_num += 1
-            other_array.append([final_num-7,array_of_strings[i][7:]]) #Subtract 7 because of GenISA_
-    return other_array
-
-
-def sortedIntrinsicsOnLenth():
-    final_array = []
-    special_array = numberofCharacterMatches(ID_array)
-    for i in range(len(special_array)):
-        pair = [special_array[i][1] + "@","GenISAIntrinsic::GenISA_"+special_array[i][1]]
-        final_array.append([special_array[i][0],pair])
+def hashIntrinsicName(seed, name):
+    # 32-bit FNV-1a, must match the hash in the GET_FUNCTION_RECOGNIZER body
+    h = seed
+    for c in name:
+        h = ((h ^ ord(c)) * 0x01000193) & 0xffffffff
+    return h
+
+def createPerfectHash(keys):
+    """
+    Builds a minimal perfect hash for keys using hash-and-displace: keys are
+    first bucketed with the base seed, then every multi-key bucket gets the
+    first seed that places all of its keys in free slots. Single-key buckets
+    store their slot directly as -(slot + 1).
+    """
+    size = len(keys)
+    buckets = [[] for i in range(size)]
+    for key in keys:
+        buckets[hashIntrinsicName(0x811C9DC5, key) % size].append(key)
+    buckets.sort(key=len, reverse=True)
+    displacement = [0] * size
+    slots = [None] * size
+    for bucket in buckets:
+        if len(bucket) <= 1:
+            break
+        seed = 1
+        item = 0
+        taken = []
+        while item < len(bucket):
+            slot = hashIntrinsicName(seed, bucket[item]) % size
+            if slots[slot] is not None or slot in taken:
+                seed += 1
+                item = 0
+                taken = []
+            else:
+                taken.append(slot)
+                item += 1
+        displacement[hashIntrinsicName(0x811C9DC5, bucket[0]) % size] = seed
+        for i in range(len(bucket)):
+            slots[taken[i]] = bucket[i]
+    free = [i for i in range(size) if slots[i] is None]
+    for bucket in buckets:
+        if len(bucket) != 1:
+            continue
+        slot = free.pop()
+        displacement[hashIntrinsicName(0x811C9DC5, bucket[0]) % size] = -slot - 1
+        slots[slot] = bucket[0]
+    return displacement, slots
+
+def createPerfectHashRecognizer():
+    names = [ID_array[i].replace("_",".") for i in range(len(ID_array))]
+    ids = dict(zip(names, ID_array))
+    displacement, slots = createPerfectHash(names)
+    size = str(len(names))
 
     f = open(outputFile,"a")
-    f.write("// Sorted by length table\n"
+    f.write("// Perfect hash of intrinsic names without the llvm.genx. prefix\n"
             "#ifdef GET_FUNCTION_RECOGNIZER\n\n"
             "struct IntrinsicEntry\n"
             "{\n"
-            "   unsigned num;\n"
-            "   GenISAIntrinsic::ID id;\n"
-            "   const char* str;\n};\n\n"
-            "static const std::array<IntrinsicEntry,"+str(len(final_array))+"> LengthTable = {{\n")
-    for i in range(len(final_array)):
-        #Go through and write each element
-        f.write("{ "+str(final_array[i][0])+", "+str(final_array[i][1][1])+", \""+str(final_array[i][1][0])+"\"}")
-        if i != len(final_array) - 1:
-            f.write(", ")
-        if i%2 == 0:
-            f.write("\n")
-    f.write("}};\n\n")
-
-    #Now to write the algorithm to search
-    f.write("std::string input_name(Name);\n"
-            "unsigned start = 0;\n"
-            "unsigned end = "+str(len(final_array))+";\n"
-            "unsigned initial_size = end;\n"
-            "unsigned cur_pos = (start + end) / 2;\n"
-            "char letter;\n"
-            "char input_letter;\n"
-            "bool isError = false;\n"
-            "bool bump = false;\n"
-            "unsigned start_index = std::string(\"llvm.genx.GenISA.\").size();\n"
-            "for (unsigned i = 0; i < Len; i++)\n"
+            "   const char* str;\n"
+            "   unsigned len;\n"
+            "   GenISAIntrinsic::ID id;\n};\n\n"
+            "static const int IntrinsicHashDisplacement["+size+"] = {\n")
+    for i in range(len(displacement)):
+        f.write(str(displacement[i]) + ",")
+        f.write("\n" if i % 16 == 15 else " ")
+    f.write("};\n\n"
+            "static const IntrinsicEntry IntrinsicHashTable["+size+"] = {\n")
+    for name in slots:
+        f.write("{ \"" + name + "\", " + str(len(name)) + ", GenISAIntrinsic::" + ids[name] + " },\n")
+    f.write("};\n\n")
+
+    #Overloaded intrinsics carry '.'-separated type suffixes, so the lookup
+    #retries with the next shorter '.'-delimited prefix until one matches.
+    f.write("auto hashName = [](uint32_t h, StringRef s)\n"
+            "{\n"
+            "    for (char c : s)\n"
+            "        h = (h ^ (unsigned char)c) * 0x01000193u;\n"
+            "    return h;\n"
+            "};\n"
+            "StringRef name(Name, Len);\n"
+            "StringRef prefix = getGenIntrinsicPrefix();\n"
+            "if (!name.startswith(prefix))\n"
+            "    return no_intrinsic;\n"
+            "name = name.drop_front(prefix.size());\n"
+            "while (!name.empty())\n"
             "{\n"
-            "    input_letter = input_name[start_index + i];\n"
-            "    unsigned counter = 0;\n"
-            "    while (1)\n"
-            "    {\n"
-            "        if (counter == initial_size || cur_pos >= initial_size)\n"
-            "        {\n"
-            "            isError = true;\n"
-            "            break;\n"
-            "        }\n"
-            "        counter++;\n"
-            "        letter = LengthTable[cur_pos].str[i];\n"
-            "        if (letter == input_letter)\n"
-            "        {\n"
-            "            if (LengthTable[cur_pos].num == i)\n"
-            "                return LengthTable[cur_pos].id;\n"
-            "            bump = true;\n"
-            "            break;\n"
-            "        }\n"
-            "        else if (input_letter == '\\0' && letter == '@')\n"
-            "            return LengthTable[cur_pos].id;\n"
-            "        else if (input_letter == '.' && letter == '_')\n"
-            "            break;\n"
-            "        else if (input_letter == '.' && letter == '@')\n"
-            "        {\n"
-            "            unsigned original_cur_pos = cur_pos;\n"
-            "            while (1)\n"
-            "            {\n"
-            "                if (cur_pos >= initial_size || LengthTable[cur_pos].num < i)\n"
-            "                    return LengthTable[original_cur_pos].id;\n"
-            "                if (LengthTable[cur_pos].str[i] == '_')\n"
-            "                    break;\n"
-            "                cur_pos += 1;\n"
-            "            }\n"
-            "            break;\n"
-            "        }\n"
-            "        else if ((bump && letter < input_letter) || letter == '@')\n"
-            "        {\n"
-            "            cur_pos += 1;\n"
-            "            continue;\n"
-            "        }\n"
-            "        else if (bump && letter > input_letter)\n"
-            "        {\n"
-            "            cur_pos -= 1;\n"
-            "            continue;\n"
-            "        }\n"
-            "        else if (letter < input_letter)\n"
-            "            start = cur_pos;\n"
-            "        else\n"
-            "            end = cur_pos;\n"
-            "        cur_pos = (start + end) / 2;\n"
-            "    }\n"
-            "    if (isError)\n"
+            "    int d = IntrinsicHashDisplacement[hashName(0x811C9DC5u, name) % "+size+"];\n"
+            "    unsigned slot = d < 0 ? (unsigned)(-d - 1) : hashName((uint32_t)d, name) % "+size+";\n"
+            "    const IntrinsicEntry &entry = IntrinsicHashTable[slot];\n"
+            "    if (name.size() == entry.len && memcmp(name.data(), entry.str, entry.len) == 0)\n"
+            "        return entry.id;\n"
+            "    size_t dot = name.rfind('.');\n"
+            "    if (dot == StringRef::npos)\n"
             "        break;\n"
+            "    name = name.take_front(dot);\n"
             "}\n")
     f.write("\n#endif\n\n")
     f.close()
@@ -458,7 +446,7 @@ emitPrefix()
 generateEnums()
 generateIDArray()
 createOverloadTable()
-sortedIntrinsicsOnLenth()
+createPerfectHashRecognizer()
 createTypeTable()
 createAttributeTable()
 emitSuffix()
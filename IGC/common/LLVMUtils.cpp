@@ -41,7 +41,21 @@ using namespace llvm;
 
 void IGCPassManager::add(Pass *P)
 {
-    PassManager::add(P);
+    if (IGC_IS_FLAG_ENABLED(ShaderPassStats))
+    {
+        // Wrap the pass between two module passes, which also ends any function
+        // pass sequence it belongs to: the timings are for the pass alone.
+        std::string passName = P->getPassName().str();
+        auto before = std::make_shared<PassIRStats::Snapshot>();
+        PassManager::add(new PassIRStats(m_pContext, m_name, m_numStatPasses, before, true));
+        PassManager::add(P);
+        PassManager::add(new PassIRStats(m_pContext, m_name, m_numStatPasses, before, false));
+        m_numStatPasses++;
+    }
+    else
+    {
+        PassManager::add(P);
+    }
     if(IGC_IS_FLAG_ENABLED(ShaderDumpEnableAll))
     {
         std::string passName = m_name + '_' + std::string(P->getPassName());
@@ -1,15 +1,19 @@
 #include "MDFrameWork.h"
+#include "common/igc_regkeys.hpp"
 
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Constants.h>
 #include <llvm/ADT/StringRef.h>
+#include <llvm/ADT/DenseMap.h>
 #include <llvm/Support/Casting.h>
 #include <llvm/ADT/StringSwitch.h>
 #include "common/LLVMWarningsPop.hpp"
 
 #include <iostream>
 #include <assert.h>
+#include <cstring>
+#include <type_traits>
 
 using namespace llvm;
 
@@ -52,6 +56,178 @@ void readNode(std::map<Key, Value> &funcMD, MDNode* node);
 template<typename T>
 void readNode(T &t, MDNode* node, StringRef name);
 
+// Binary encoding of ModuleMetaData. The whole structure is flattened into a
+// single MDString in host byte order; llvm::Value references are stored as
+// indices into a side tuple of ValueAsMetadata so they still track RAUW.
+// Blob layout: format version, layout hash of MDFrameWork.h, then fields in
+// declaration order. Containers are prefixed with their element count.
+static const uint32_t MDBlobFormatVersion = 1;
+static const uint32_t MDBlobNullValue = 0xFFFFFFFF;
+
+class MDBlobWriter
+{
+public:
+    explicit MDBlobWriter(Module* module) : m_module(module) {}
+
+    template<typename T>
+    void writePOD(const T &v)
+    {
+        m_data.append(reinterpret_cast<const char*>(&v), sizeof(T));
+    }
+
+    void writeBytes(const void* p, size_t size)
+    {
+        m_data.append(static_cast<const char*>(p), size);
+    }
+
+    void writeValue(Value* v)
+    {
+        uint32_t id = MDBlobNullValue;
+        if (v)
+        {
+            auto it = m_valueIds.find(v);
+            if (it == m_valueIds.end())
+            {
+                id = (uint32_t)m_values.size();
+                m_valueIds[v] = id;
+                m_values.push_back(ValueAsMetadata::get(v));
+            }
+            else
+            {
+                id = it->second;
+            }
+        }
+        writePOD(id);
+    }
+
+    const std::string& data() const { return m_data; }
+
+    MDNode* finalize(StringRef name)
+    {
+        LLVMContext &context = m_module->getContext();
+        Metadata* v[] =
+        {
+            MDString::get(context, name),
+            MDString::get(context, m_data),
+            MDNode::get(context, m_values),
+        };
+        return MDNode::get(context, v);
+    }
+
+private:
+    Module* m_module;
+    std::string m_data;
+    std::vector<Metadata*> m_values;
+    DenseMap<Value*, uint32_t> m_valueIds;
+};
+
+class MDBlobReader
+{
+public:
+    MDBlobReader(StringRef data, MDNode* values) :
+        m_cur(data.begin()), m_end(data.end()), m_values(values), m_failed(false) {}
+
+    bool failed() const { return m_failed; }
+
+    template<typename T>
+    void readPOD(T &v)
+    {
+        if (!reserve(sizeof(T)))
+        {
+            v = T();
+            return;
+        }
+        memcpy(&v, m_cur, sizeof(T));
+        m_cur += sizeof(T);
+    }
+
+    void readBytes(void* p, size_t size)
+    {
+        if (!reserve(size))
+        {
+            return;
+        }
+        memcpy(p, m_cur, size);
+        m_cur += size;
+    }
+
+    // Every encoded element takes at least one byte, so a count larger than
+    // the remaining data can only come from a corrupted blob.
+    uint32_t readCount()
+    {
+        uint32_t count = 0;
+        readPOD(count);
+        if (count > (size_t)(m_end - m_cur))
+        {
+            m_failed = true;
+            m_cur = m_end;
+            return 0;
+        }
+        return count;
+    }
+
+    Value* readValue()
+    {
+        uint32_t id = MDBlobNullValue;
+        readPOD(id);
+        if (id == MDBlobNullValue)
+        {
+            return nullptr;
+        }
+        if (id >= m_values->getNumOperands())
+        {
+            m_failed = true;
+            return nullptr;
+        }
+        ValueAsMetadata* pVal = dyn_cast_or_null<ValueAsMetadata>(m_values->getOperand(id));
+        return pVal ? pVal->getValue() : nullptr;
+    }
+
+private:
+    bool reserve(size_t size)
+    {
+        if (m_failed || size > (size_t)(m_end - m_cur))
+        {
+            m_failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    const char* m_cur;
+    const char* m_end;
+    MDNode* m_values;
+    bool m_failed;
+};
+
+template<typename T>
+void writeBlob(const T &v, MDBlobWriter& w, typename std::enable_if<std::is_arithmetic<T>::value>::type* = nullptr);
+void writeBlob(const std::string &s, MDBlobWriter& w);
+void writeBlob(const std::vector<char> &vec, MDBlobWriter& w);
+void writeBlob(const std::vector<unsigned char> &vec, MDBlobWriter& w);
+template<typename T>
+void writeBlob(const std::vector<T> &vec, MDBlobWriter& w);
+template<typename T, size_t s>
+void writeBlob(const std::array<T, s> &arr, MDBlobWriter& w);
+template<typename Key, typename Value>
+void writeBlob(const std::map<Key, Value> &keyMD, MDBlobWriter& w);
+void writeBlob(Function* funcPtr, MDBlobWriter& w);
+void writeBlob(GlobalVariable* globalVar, MDBlobWriter& w);
+
+template<typename T>
+void readBlob(T &v, MDBlobReader& r, typename std::enable_if<std::is_arithmetic<T>::value>::type* = nullptr);
+void readBlob(std::string &s, MDBlobReader& r);
+void readBlob(std::vector<char> &vec, MDBlobReader& r);
+void readBlob(std::vector<unsigned char> &vec, MDBlobReader& r);
+template<typename T>
+void readBlob(std::vector<T> &vec, MDBlobReader& r);
+template<typename T, size_t s>
+void readBlob(std::array<T, s> &arr, MDBlobReader& r);
+template<typename Key, typename Value>
+void readBlob(std::map<Key, Value> &keyMD, MDBlobReader& r);
+void readBlob(Function* &funcPtr, MDBlobReader& r);
+void readBlob(GlobalVariable* &globalVar, MDBlobReader& r);
+
 //including auto-generated functions
 #include "MDNodeFunctions.gen"
 namespace IGC 
@@ -335,6 +511,160 @@ void readNode(T &t, MDNode* node, StringRef name)
     }
 }
 
+template<typename T>
+void writeBlob(const T &v, MDBlobWriter& w, typename std::enable_if<std::is_arithmetic<T>::value>::type*)
+{
+    w.writePOD(v);
+}
+
+void writeBlob(const std::string &s, MDBlobWriter& w)
+{
+    w.writePOD((uint32_t)s.size());
+    w.writeBytes(s.data(), s.size());
+}
+
+void writeBlob(const std::vector<char> &vec, MDBlobWriter& w)
+{
+    w.writePOD((uint32_t)vec.size());
+    w.writeBytes(vec.data(), vec.size());
+}
+
+void writeBlob(const std::vector<unsigned char> &vec, MDBlobWriter& w)
+{
+    w.writePOD((uint32_t)vec.size());
+    w.writeBytes(vec.data(), vec.size());
+}
+
+template<typename T>
+void writeBlob(const std::vector<T> &vec, MDBlobWriter& w)
+{
+    w.writePOD((uint32_t)vec.size());
+    for (auto it = vec.begin(); it != vec.end(); ++it)
+    {
+        writeBlob(*it, w);
+    }
+}
+
+template<typename T, size_t s>
+void writeBlob(const std::array<T, s> &arr, MDBlobWriter& w)
+{
+    for (unsigned int i = 0; i < s; i++)
+    {
+        writeBlob(arr[i], w);
+    }
+}
+
+template<typename Key, typename Value>
+void writeBlob(const std::map<Key, Value> &keyMD, MDBlobWriter& w)
+{
+    w.writePOD((uint32_t)keyMD.size());
+    for (auto it = keyMD.begin(); it != keyMD.end(); ++it)
+    {
+        writeBlob(it->first, w);
+        writeBlob(it->second, w);
+    }
+}
+
+void writeBlob(Function* funcPtr, MDBlobWriter& w)
+{
+    w.writeValue(funcPtr);
+}
+
+void writeBlob(GlobalVariable* globalVar, MDBlobWriter& w)
+{
+    w.writeValue(globalVar);
+}
+
+template<typename T>
+void readBlob(T &v, MDBlobReader& r, typename std::enable_if<std::is_arithmetic<T>::value>::type*)
+{
+    r.readPOD(v);
+}
+
+void readBlob(std::string &s, MDBlobReader& r)
+{
+    s.resize(r.readCount());
+    r.readBytes(&s[0], s.size());
+}
+
+void readBlob(std::vector<char> &vec, MDBlobReader& r)
+{
+    vec.resize(r.readCount());
+    r.readBytes(vec.data(), vec.size());
+}
+
+void readBlob(std::vector<unsigned char> &vec, MDBlobReader& r)
+{
+    vec.resize(r.readCount());
+    r.readBytes(vec.data(), vec.size());
+}
+
+template<typename T>
+void readBlob(std::vector<T> &vec, MDBlobReader& r)
+{
+    vec.resize(r.readCount());
+    for (auto it = vec.begin(); it != vec.end(); ++it)
+    {
+        readBlob(*it, r);
+    }
+}
+
+template<typename T, size_t s>
+void readBlob(std::array<T, s> &arr, MDBlobReader& r)
+{
+    for (unsigned int i = 0; i < s; i++)
+    {
+        readBlob(arr[i], r);
+    }
+}
+
+template<typename Key, typename Value>
+void readBlob(std::map<Key, Value> &keyMD, MDBlobReader& r)
+{
+    uint32_t count = r.readCount();
+    for (uint32_t i = 0; i < count && !r.failed(); i++)
+    {
+        std::pair<Key, Value> p;
+        readBlob(p.first, r);
+        readBlob(p.second, r);
+        keyMD.insert(std::move(p));
+    }
+}
+
+void readBlob(Function* &funcPtr, MDBlobReader& r)
+{
+    funcPtr = cast_or_null<Function>(r.readValue());
+}
+
+void readBlob(GlobalVariable* &globalVar, MDBlobReader& r)
+{
+    globalVar = cast_or_null<GlobalVariable>(r.readValue());
+}
+
+static bool readModuleMDBlob(IGC::ModuleMetaData &deserializeMD, MDNode* moduleRoot)
+{
+    if (moduleRoot->getNumOperands() != 3)
+    {
+        return false;
+    }
+    MDString* data = dyn_cast_or_null<MDString>(moduleRoot->getOperand(1));
+    MDNode* values = dyn_cast_or_null<MDNode>(moduleRoot->getOperand(2));
+    if (!data || !values)
+    {
+        return false;
+    }
+    MDBlobReader r(data->getString(), values);
+    uint32_t version = 0, layoutHash = 0;
+    r.readPOD(version);
+    r.readPOD(layoutHash);
+    if (version != MDBlobFormatVersion || layoutHash != MDBlobLayoutHash)
+    {
+        return false;
+    }
+    readBlob(deserializeMD, r);
+    return !r.failed();
+}
+
 void IGC::deserialize(IGC::ModuleMetaData &deserializeMD, const Module* module)
 {
 	IGC::ModuleMetaData temp;
@@ -342,6 +672,16 @@ void IGC::deserialize(IGC::ModuleMetaData &deserializeMD, const Module* module)
     NamedMDNode* root = module->getNamedMetadata("IGCMetadata");
     if (!root) { return; } //module has not been serialized with IGCMetadata yet
     MDNode* moduleRoot = root->getOperand(0);
+    MDString* rootName = dyn_cast_or_null<MDString>(moduleRoot->getOperand(0));
+    if (rootName && rootName->getString() == "ModuleMDBlob")
+    {
+        if (!readModuleMDBlob(deserializeMD, moduleRoot))
+        {
+            assert(0 && "stale or corrupted ModuleMetaData blob");
+            deserializeMD = temp;
+        }
+        return;
+    }
     readNode(deserializeMD, moduleRoot);
 }
 
@@ -354,6 +694,48 @@ void IGC::serialize(const IGC::ModuleMetaData &moduleMD, Module* module)
         LLVMMetadata->dropAllReferences();
     }
     LLVMMetadata = module->getOrInsertNamedMetadata("IGCMetadata");
-    auto node = CreateNode(moduleMD, module, "ModuleMD");
+    MDNode* node = nullptr;
+    if (IGC_IS_FLAG_ENABLED(DumpModuleMDAsNodes))
+    {
+        // readable tree of MDNodes, mainly for LLVM IR dumps
+        node = CreateNode(moduleMD, module, "ModuleMD");
+    }
+    else
+    {
+        MDBlobWriter w(module);
+        w.writePOD(MDBlobFormatVersion);
+        w.writePOD(MDBlobLayoutHash);
+        writeBlob(moduleMD, w);
+        node = w.finalize("ModuleMDBlob");
+    }
     LLVMMetadata->addOperand(node);
 }
+
+bool IGC::isEqual(const IGC::FunctionMetaData &funcMD0, const IGC::FunctionMetaData &funcMD1, Module* module)
+{
+    MDBlobWriter w0(module), w1(module);
+    writeBlob(funcMD0, w0);
+    writeBlob(funcMD1, w1);
+    return w0.data() == w1.data();
+}
+
+std::string IGC::getBlob(const IGC::FunctionMetaData &funcMD, Module* module)
+{
+    MDBlobWriter w(module);
+    writeBlob(funcMD, w);
+    return w.data();
+}
+
+std::string IGC::getBlob(const IGC::CompOptions &compOpt, Module* module)
+{
+    MDBlobWriter w(module);
+    writeBlob(compOpt, w);
+    return w.data();
+}
+
+std::string IGC::getBlob(const IGC::ComputeShaderInfo &csInfo, Module* module)
+{
+    MDBlobWriter w(module);
+    writeBlob(csInfo, w);
+    return w.data();
+}
@@ -53,6 +53,20 @@ namespace IGC
         int dim2 = 0;
     };
 
+    // Image properties fixed by the runtime for a specialized compile of a
+    // kernel; -1 means unknown and the implicit argument is read instead
+    struct ImageQueryInfoMD
+    {
+        int width = -1;
+        int height = -1;
+        int depth = -1;
+        int arraySize = -1;
+        int numMipLevels = -1;
+        int numSamples = -1;
+        int channelDataType = -1;
+        int channelOrder = -1;
+    };
+
     //to hold metadata of every function
     struct FunctionMetaData
     {
@@ -65,10 +79,14 @@ namespace IGC
         bool isCloned = false;
         bool hasInlineVmeSamplers = false;
         int localSize = 0;
+        unsigned slmBankConflicts = 0;
         bool globalIDPresent = false;
         bool localIDPresent = false;
         bool groupIDPresent = false;
         int privateMemoryPerWI = 0;
+        unsigned workGroupCombineFactor = 1;
+        // keyed by the explicit argument number of the image
+        std::map<unsigned int, ImageQueryInfoMD> knownImageQueries;
     };
 
     // isCloned member is added to mark whether a function is clone
@@ -102,6 +120,9 @@ namespace IGC
         bool PushConstantsEnable                        = true;
         bool HasBufferOffsetArg                         = false;
         bool replaceGlobalOffsetsByZero                 = false;
+        bool TrimLocalIDs                               = false;
+        bool FastCompile                                = false;
+        bool KernelBuffersNotAliased                    = false;
         unsigned forcePixelShaderSIMDMode               = 0;
         bool pixelShaderDoNotAbortOnSpill               = false;
     };
@@ -252,4 +273,10 @@ namespace IGC
     };
     void serialize(const IGC::ModuleMetaData &moduleMD, llvm::Module* module);
     void deserialize(IGC::ModuleMetaData &deserializedMD, const llvm::Module* module);
+    // true if both entries have the same serialized form
+    bool isEqual(const IGC::FunctionMetaData &funcMD0, const IGC::FunctionMetaData &funcMD1, llvm::Module* module);
+    // serialized form of a single entry, e.g. to build a cache key from it
+    std::string getBlob(const IGC::FunctionMetaData &funcMD, llvm::Module* module);
+    std::string getBlob(const IGC::CompOptions &compOpt, llvm::Module* module);
+    std::string getBlob(const IGC::ComputeShaderInfo &csInfo, llvm::Module* module);
 }
@@ -40,6 +40,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/secure_string.h"
 #include <fstream>
 #include <algorithm> 
+#include <limits>
 #include <iomanip>
 #include <sstream>
 #include <iostream>
@@ -50,6 +51,9 @@ extern "C" int64_t getTimerTicks(unsigned int idx);
 extern "C" double getTimerCounts(unsigned int idx);
 extern "C" void getTimerNames(char* timerName, unsigned int idx);
 extern "C" unsigned int getTotalTimers();
+extern "C" void enableTimerTrace(bool enable);
+extern "C" unsigned int getNumTimerTraceEvents();
+extern "C" bool getTimerTraceEvent(unsigned int idx, unsigned int* timer, int64_t* startNS, int64_t* endNS);
 #endif
 
 namespace {
@@ -214,6 +218,58 @@ void ShaderStats::printShaderStats( ShaderHash hash, ShaderType shaderType, cons
     fclose(fileName);
 }
 
+void ShaderStats::printShaderStatsJSONL(ShaderHash hash, ShaderType shaderType, const std::string &postFix,
+    unsigned retryId, const TimeStats* timeStats)
+{
+    const std::string outputFilePath = IGC::Debug::GetShaderOutputFolder() + std::string("\\SQM\\") + IGC::Debug::GetShaderCorpusName() + "ShaderStats.jsonl";
+    FILE* fp = fopen(outputFilePath.c_str(), "a");
+    if (!fp)
+    {
+        return;
+    }
+
+    std::string asmFileName =
+        IGC::Debug::DumpName(IGC::Debug::GetShaderOutputName())
+        .Type(shaderType)
+        .Hash(hash)
+        .Extension("asm")
+        .str();
+    if (asmFileName.find_last_of("\\") != std::string::npos)
+    {
+        asmFileName = asmFileName.substr(asmFileName.find_last_of("\\") + 1, asmFileName.size());
+    }
+
+    fprintf(fp, "{\"shader\":\"%s\",\"kernel\":\"%s\",\"retry\":%u,\"stats\":{",
+        asmFileName.c_str(), postFix.c_str(), retryId);
+    for (int i = 0; i < STATS_MAX_SHADER_STATS_ITEMS; i++)
+    {
+        fprintf(fp, "%s\"%s\":%d", i ? "," : "", g_cShaderStatItems[i], m_CompileShaderStats[i]);
+    }
+    fprintf(fp, "}");
+#if GET_TIME_STATS
+    // the timers belong to the compile context, so kernels compiled together
+    // from one module report the same accumulated phase times
+    if (timeStats)
+    {
+        fprintf(fp, ",\"timeMS\":{");
+        bool first = true;
+        for (int i = 0; i < MAX_COMPILE_TIME_INTERVALS; i++)
+        {
+            COMPILE_TIME_INTERVALS cti = static_cast<COMPILE_TIME_INTERVALS>(i);
+            if (isCoarseTimer(cti) && timeStats->getCompileHit(cti) > 0)
+            {
+                fprintf(fp, "%s\"%s\":%.3f", first ? "" : ",", g_cCompTimeIntervals[i],
+                    timeStats->getCompileTimeNS(cti) / 1000000.0);
+                first = false;
+            }
+        }
+        fprintf(fp, "}");
+    }
+#endif
+    fprintf(fp, "}\n");
+    fclose(fp);
+}
+
 void ShaderStats::printOpcodeStats(ShaderHash hash, ShaderType shaderType, const std::string &postFix)
 {
     /*const std::string opcodeFilePath = IGC::Debug::GetShaderOutputFolder() + std::string("\\SQM\\") + IGC::Debug::GetShaderCorpusName() + "OpcodeShaderStats.csv";
@@ -555,6 +611,8 @@ int parentIntervalDepth( COMPILE_TIME_INTERVALS cti )
 TimeStats::TimeStats()
     : m_isPostProcessed(false)
     , m_totalShaderCount(0)
+    , m_traceEnabled(IGC_IS_FLAG_ENABLED(DumpTimeTrace))
+    , m_currentTraceScope(-1)
 {
     std::fill(std::begin(m_wallclockStart), std::end(m_wallclockStart), 0);
     std::fill(std::begin(m_elapsedTime),    std::end(m_elapsedTime),    0);
@@ -569,6 +627,60 @@ void TimeStats::recordVISATimers()
     {
         m_elapsedTime[TIME_VISA_Total+i] += getTimerTicks(i);
     }
+
+    if( m_traceEnabled )
+    {
+        // vISA uses its own clock; place its spans at the start of the
+        // enclosing vISACompile span.
+        unsigned int numEvents = getNumTimerTraceEvents();
+        int64_t visaBase = std::numeric_limits<int64_t>::max();
+        for( unsigned int i = 0; i < numEvents; ++i )
+        {
+            unsigned int timer;
+            int64_t startNS, endNS;
+            if( getTimerTraceEvent( i, &timer, &startNS, &endNS ) )
+            {
+                visaBase = std::min( visaBase, startNS );
+            }
+        }
+
+        const uint64_t base = m_wallclockStart[ TIME_CG_vISACompile ];
+        for( unsigned int i = 0; i < numEvents; ++i )
+        {
+            unsigned int timer;
+            int64_t startNS, endNS;
+            if( !getTimerTraceEvent( i, &timer, &startNS, &endNS ) ||
+                TIME_VISA_Total + timer >= MAX_COMPILE_TIME_INTERVALS )
+            {
+                continue;
+            }
+            TraceSpan span;
+            span.interval = static_cast<COMPILE_TIME_INTERVALS>( TIME_VISA_Total + timer );
+            span.start = base + uint64_t( ( startNS - visaBase ) * (double)m_freq / 1000000000.0 );
+            span.end = base + uint64_t( ( endNS - visaBase ) * (double)m_freq / 1000000000.0 );
+            span.scope = m_currentTraceScope;
+            m_traceSpans.push_back( span );
+        }
+        enableTimerTrace( false );
+    }
+}
+
+void TimeStats::recordVISATimers( const std::vector<int64_t>& ticks )
+{
+    for( unsigned int i = 0; i < ticks.size() && TIME_VISA_Total + i < MAX_COMPILE_TIME_INTERVALS; ++i )
+    {
+        m_elapsedTime[TIME_VISA_Total+i] += ticks[i];
+    }
+}
+
+std::vector<int64_t> TimeStats::getVISATimerTicks()
+{
+    std::vector<int64_t> ticks( getTotalTimers() );
+    for( unsigned int i = 0; i < ticks.size(); ++i )
+    {
+        ticks[i] = getTimerTicks(i);
+    }
+    return ticks;
 }
 
 void TimeStats::recordTimerStart( COMPILE_TIME_INTERVALS compileInterval )
@@ -580,8 +692,30 @@ void TimeStats::recordTimerStart( COMPILE_TIME_INTERVALS compileInterval )
 void TimeStats::recordTimerEnd( COMPILE_TIME_INTERVALS compileInterval )
 {
     assert( compileInterval >= 0 && compileInterval < MAX_COMPILE_TIME_INTERVALS );
-    m_elapsedTime[ compileInterval ] += iSTD::GetTimestampCounter() - m_wallclockStart[ compileInterval ];
+    uint64_t end = iSTD::GetTimestampCounter();
+    m_elapsedTime[ compileInterval ] += end - m_wallclockStart[ compileInterval ];
     m_hitCount[ compileInterval ]++;
+
+    if( m_traceEnabled )
+    {
+        TraceSpan span = { compileInterval, m_wallclockStart[ compileInterval ], end, m_currentTraceScope };
+        m_traceSpans.push_back( span );
+    }
+}
+
+void TimeStats::setTraceScope( std::string const& kernelName, unsigned simd, unsigned retryId )
+{
+    if( !m_traceEnabled )
+    {
+        return;
+    }
+
+    TraceScope scope = { kernelName, simd, retryId };
+    m_traceScopes.push_back( scope );
+    m_currentTraceScope = int( m_traceScopes.size() ) - 1;
+
+    // Start collecting the vISA spans of this compile.
+    enableTimerTrace( true );
 }
 
 uint64_t TimeStats::getCompileTime( COMPILE_TIME_INTERVALS compileInterval ) const
@@ -608,6 +742,65 @@ void TimeStats::sumWith( const TimeStats* pOther )
     m_totalShaderCount++;
 }
 
+void TimeStats::printTrace( ShaderType type, ShaderHash hash ) const
+{
+    if( m_traceSpans.empty() )
+    {
+        return;
+    }
+
+    std::string fileName = IGC::Debug::DumpName(IGC::Debug::GetShaderOutputName())
+        .Type(type).Hash(hash).PostFix("trace").Extension("json").str();
+    std::ofstream os( fileName );
+    if( !os )
+    {
+        return;
+    }
+
+    auto escape = []( std::string const& str )
+    {
+        std::string out;
+        for( char c : str )
+        {
+            if( c == '"' || c == '\\' )
+            {
+                out += '\\';
+            }
+            out += c;
+        }
+        return out;
+    };
+
+    // Chrome trace-event "complete" events, timestamps in microseconds.
+    // Spans are sorted by start so that viewers nest them by containment.
+    std::vector<TraceSpan> spans = m_traceSpans;
+    std::stable_sort( spans.begin(), spans.end(),
+        []( TraceSpan const& a, TraceSpan const& b ) { return a.start < b.start; } );
+
+    const uint64_t base = spans.front().start;
+    const double usPerTick = 1000000.0 / (double)m_freq;
+    os << "{\"traceEvents\":[\n";
+    for( size_t i = 0; i < spans.size(); ++i )
+    {
+        TraceSpan const& span = spans[ i ];
+        os << ( i ? ",\n" : "" )
+           << "{\"name\":\"" << g_cCompTimeIntervals[ span.interval ]
+           << "\",\"cat\":\"" << ( isVISATimer( span.interval ) ? "vISA" : "IGC" )
+           << "\",\"ph\":\"X\",\"pid\":0,\"tid\":0"
+           << ",\"ts\":" << std::fixed << std::setprecision( 3 ) << ( span.start - base ) * usPerTick
+           << ",\"dur\":" << ( span.end - span.start ) * usPerTick;
+        if( span.scope >= 0 )
+        {
+            TraceScope const& scope = m_traceScopes[ span.scope ];
+            os << ",\"args\":{\"kernel\":\"" << escape( scope.kernelName )
+               << "\",\"simd\":" << scope.simd
+               << ",\"retry\":" << scope.retryId << "}";
+        }
+        os << "}";
+    }
+    os << "\n]}\n";
+}
+
 void TimeStats::printTime( ShaderType type, ShaderHash hash ) const
 {
     TimeStats pp = postProcess();
@@ -903,6 +1096,72 @@ TimeStats TimeStats::postProcess() const
 
 #endif // GET_TIME_STATS
 
+StatsTotals& StatsTotals::get()
+{
+    static StatsTotals totals;
+    return totals;
+}
+
+StatsTotals::StatsTotals()
+{
+    for (int i = 0; i < MAX_COMPILE_TIME_INTERVALS; i++)
+    {
+        m_timeNS[i].store(0, std::memory_order_relaxed);
+        m_hitCount[i].store(0, std::memory_order_relaxed);
+    }
+    for (int i = 0; i < STATS_MAX_SHADER_STATS_ITEMS; i++)
+    {
+        m_shaderStats[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void StatsTotals::addTimeStats( const TimeStats* pStats )
+{
+#if GET_TIME_STATS
+    // Only counts are shared, so nothing has to be ordered with them.
+    for (int i = 0; i < MAX_COMPILE_TIME_INTERVALS; i++)
+    {
+        COMPILE_TIME_INTERVALS interval = static_cast<COMPILE_TIME_INTERVALS>(i);
+        m_timeNS[i].fetch_add(pStats->getCompileTimeNS(interval), std::memory_order_relaxed);
+        m_hitCount[i].fetch_add(pStats->getCompileHit(interval), std::memory_order_relaxed);
+    }
+#endif // GET_TIME_STATS
+}
+
+void StatsTotals::addShaderStats( ShaderStats* pStats )
+{
+#if GET_SHADER_STATS
+    for (int i = 0; i < STATS_MAX_SHADER_STATS_ITEMS; i++)
+    {
+        m_shaderStats[i].fetch_add(
+            pStats->getShaderStats(static_cast<SHADER_STATS_ITEMS>(i)), std::memory_order_relaxed);
+    }
+#endif // GET_SHADER_STATS
+}
+
+void StatsTotals::snapshotTimes( uint64_t* pTimesNS, uint64_t* pHits, uint32_t count ) const
+{
+    for (uint32_t i = 0; i < count && i < MAX_COMPILE_TIME_INTERVALS; i++)
+    {
+        if (pTimesNS)
+        {
+            pTimesNS[i] = m_timeNS[i].load(std::memory_order_relaxed);
+        }
+        if (pHits)
+        {
+            pHits[i] = m_hitCount[i].load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void StatsTotals::snapshotShaderStats( int64_t* pValues, uint32_t count ) const
+{
+    for (uint32_t i = 0; pValues && i < count && i < STATS_MAX_SHADER_STATS_ITEMS; i++)
+    {
+        pValues[i] = m_shaderStats[i].load(std::memory_order_relaxed);
+    }
+}
+
 #if GET_MEM_STATS
 
 void CMemoryReport::CreateMemStatsFiles()
@@ -1018,6 +1277,90 @@ void CMemoryReport::DumpMemoryStats( ShaderType type, ShaderHash hash )
     }
 }
 
+/*****************************************************************************\
+
+Function: CMemoryReport::DumpMemoryStatsJSON
+
+Description:
+    Writes the per-phase peak memory of the current compile, including the
+    vISA arena peaks of each finalizer invocation, as a JSON file next to the
+    other shader dumps.
+
+Input:
+    ShaderType type
+    ShaderHash hash
+
+Output:
+    None
+
+\*****************************************************************************/
+void CMemoryReport::DumpMemoryStatsJSON( ShaderType type, ShaderHash hash )
+{
+    if( !IGC::Debug::GetDebugFlag(IGC::Debug::DebugFlag::MEM_STATS ) )
+    {
+        return;
+    }
+
+    std::string fileName = IGC::Debug::DumpName(IGC::Debug::GetShaderOutputName())
+        .Type(type).Hash(hash).PostFix("memstats").Extension("json").str();
+    FILE* fp = fopen( fileName.c_str(), "w" );
+    if( !fp )
+    {
+        return;
+    }
+
+    fprintf( fp, "{\n  \"heapPeakKB\": %u,\n  \"phases\": [", m_Stat.HeapUsedPeak / 1024 );
+    bool first = true;
+    for( int i = 0; i < IGC::MAX_SHADER_MEMORY_SNAPSHOT; i++ )
+    {
+        if( m_GrabDetailed || IGC::g_cShaderMemorySnapshot[ i ].IsMilestone )
+        {
+            fprintf( fp, "%s\n    { \"name\": \"%s\", \"peakKB\": %u, \"heapUsedKB\": %d }",
+                first ? "" : ",",
+                IGC::g_cShaderMemorySnapshot[ i ].Name,
+                m_Snapshots[ i ].SnapHeapUsedAbsolutePeak / 1024,
+                m_Snapshots[ i ].HeapUsed / 1024 );
+            first = false;
+        }
+    }
+    fprintf( fp, "\n  ],\n  \"finalizer\": [" );
+    first = true;
+    for( auto const& peaks : m_FinalizerPeaks )
+    {
+        fprintf( fp, "%s\n    { \"simd\": %u, \"irKB\": %u, \"raKB\": %u, \"postRAKB\": %u }",
+            first ? "" : ",", peaks.SIMD, peaks.IR, peaks.RA, peaks.PostRA );
+        first = false;
+    }
+    fprintf( fp, "\n  ]\n}\n" );
+    fclose( fp );
+}
+
+/*****************************************************************************\
+
+Function: CMemoryReport::RecordFinalizerPeaks
+
+Description:
+    Records the vISA arena peaks reported by one finalizer invocation.
+
+Input:
+    unsigned simd     - SIMD width of the compiled kernel
+    unsigned irKB     - peak while building and optimizing the vISA IR
+    unsigned raKB     - peak during register allocation
+    unsigned postRAKB - peak from the end of RA through encoding
+
+Output:
+    None
+
+\*****************************************************************************/
+void CMemoryReport::RecordFinalizerPeaks( unsigned simd, unsigned irKB, unsigned raKB, unsigned postRAKB )
+{
+    if( IGC::Debug::GetDebugFlag(IGC::Debug::DebugFlag::MEM_STATS ) )
+    {
+        FinalizerPeaks peaks = { simd, irKB, raKB, postRAKB };
+        m_FinalizerPeaks.push_back( peaks );
+    }
+}
+
 CMemoryReport g_MemoryReport;
 
 /*****************************************************************************\
@@ -1177,6 +1520,7 @@ void CMemoryReport::UsageReset()
 
         memset( m_Snapshots, 0, sizeof( *m_Snapshots ) * IGC::MAX_SHADER_MEMORY_SNAPSHOT );
         m_SnapCnt = 1;   // reserve [0] for 0-based deltas
+        m_FinalizerPeaks.clear();
     }
 }
 
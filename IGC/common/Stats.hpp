@@ -43,7 +43,9 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <3d/common/iStdLib/utility.h>
 
+#include <atomic>
 #include <string>
+#include <vector>
 
 namespace llvm
 {
@@ -85,6 +87,8 @@ public:
 
 	void printShaderStats(ShaderHash hash, ShaderType shaderType, const std::string &postFix);
 	void printOpcodeStats(ShaderHash hash, ShaderType shaderType, const std::string &postFix);
+	void printShaderStatsJSONL(ShaderHash hash, ShaderType shaderType, const std::string &postFix,
+	    unsigned retryId, const TimeStats* timeStats);
 	void parseIsaShader(ShaderHash hash, ShaderType shaderType, SIMDMode simd);
 	int  getShaderStats(SHADER_STATS_ITEMS compileInterval);
 	void sumShaderStat(SHADER_STATS_ITEMS compileInterval, int count);
@@ -129,6 +133,18 @@ private:
     do { } while (0)
 #endif
 
+// Appends one JSON object per compiled shader to <corpus>ShaderStats.jsonl,
+// so that records of many compiles can be concatenated and aggregated.
+#define COMPILER_SHADER_STATS_PRINT_JSONL( shaderStats, ctx, postFix ) \
+    do \
+    { \
+        if( (shaderStats) && IGC_IS_FLAG_ENABLED(ShaderStatsJSONL) ) \
+        { \
+            (shaderStats)->printShaderStatsJSONL( (ctx)->hash, (ctx)->type, postFix, \
+                (ctx)->m_retryManager.GetRetryId(), (ctx)->m_compilerTimeStats ); \
+        } \
+    } while (0)
+
 #define COMPILER_SHADER_STATS_SET( shaderStats, compileInterval, isacount ) \
     do \
     { \
@@ -141,6 +157,10 @@ private:
 #define COMPILER_SHADER_STATS_SUM( sumShaderStats, shaderStats, shaderType ) \
     do \
     { \
+        if( (shaderStats) && IGC_IS_FLAG_ENABLED(EnableStatsTotals) ) \
+        { \
+            StatsTotals::get().addShaderStats( shaderStats ); \
+        } \
     if( (sumShaderStats) && (shaderStats) ) \
         { \
             (sumShaderStats)->m_shaderType = shaderType; \
@@ -188,6 +208,7 @@ private:
 #   define COMPILER_SHADER_STATS_SUM( sumShaderStats, shaderStats, shaderType ) do { } while (0)
 #   define COMPILER_SHADER_STATS_SET( shaderStats, compileInterval, isacount ) do { } while (0)
 #   define COMPILER_SHADER_STATS_PRINT( shaderStats, shaderType, hash, postFix ) do { } while (0)
+#   define COMPILER_SHADER_STATS_PRINT_JSONL( shaderStats, ctx, postFix ) do { } while (0)
 #   define COMPILER_SHADER_STATS_PRINT_SUM( sumShaderStats ) do { } while (0)
 #   define COMPILER_SHADER_STATS_INIT( shaderStats ) do { } while (0)
 #   define COMPILER_SHADER_STATS_DEL( shaderStats ) do { } while (0)
@@ -223,6 +244,10 @@ public:
 
     /// Capture the VISA timer values for the most recent call to VISABuilder::compile()
     void recordVISATimers();
+    /// Add VISA timer values measured on another thread, see getVISATimerTicks()
+    void recordVISATimers( const std::vector<int64_t>& ticks );
+    /// Get the current VISA timer values of the calling thread
+    static std::vector<int64_t> getVISATimerTicks();
 
     /// Mark that a particular timer has started timing
     void recordTimerStart( COMPILE_TIME_INTERVALS compileInterval );
@@ -242,6 +267,11 @@ public:
     /// Add other's statistics to this
     void sumWith( const TimeStats* pOther );
 
+    /// Attach the kernel name, SIMD width and retry ID to subsequently traced spans
+    void setTraceScope( std::string const& kernelName, unsigned simd, unsigned retryId );
+    /// Print the traced spans of a single shader as Chrome trace-event JSON
+    void printTrace( ShaderType type, ShaderHash hash ) const;
+
     /// Get the time elapsed in nanoseconds
     uint64_t getCompileTimeNS(COMPILE_TIME_INTERVALS compileInterval) const
     {
@@ -269,6 +299,24 @@ private:
     uint64_t m_elapsedTime[MAX_COMPILE_TIME_INTERVALS];      //!< Running total of time measured by the timer
     uint64_t m_hitCount[MAX_COMPILE_TIME_INTERVALS];         //!< Number of times a timer was started
     uint64_t m_freq;
+
+    struct TraceScope
+    {
+        std::string kernelName;
+        unsigned simd;
+        unsigned retryId;
+    };
+    struct TraceSpan
+    {
+        COMPILE_TIME_INTERVALS interval;
+        uint64_t start;
+        uint64_t end;
+        int scope;                                        //!< Index into m_traceScopes, or -1
+    };
+    bool m_traceEnabled;                                  //!< Record a timeline of every timer span
+    int  m_currentTraceScope;
+    std::vector<TraceScope> m_traceScopes;
+    std::vector<TraceSpan>  m_traceSpans;
 };
 
 #define COMPILER_TIME_GETNS(pointer, timerName) \
@@ -292,6 +340,15 @@ private:
         } \
     } while (0)
 
+#define COMPILER_TIME_TRACE_SCOPE( pointer, kernelName, simd, retryId ) \
+    do \
+    { \
+        if( (pointer) && (pointer)->m_compilerTimeStats ) \
+        { \
+            (pointer)->m_compilerTimeStats->setTraceScope( kernelName, simd, retryId ); \
+        } \
+    } while (0)
+
 #define COMPILER_TIME_SUM( pointerDst, pointerSrc ) \
     do \
     { \
@@ -348,6 +405,15 @@ private:
         (pointer)->statName = nullptr; \
     } while (0)
 
+#define COMPILER_TIME_SNAPSHOT( pointer, timesNS ) \
+    do \
+    { \
+        for( int i = 0; i < MAX_COMPILE_TIME_INTERVALS; i++ ) \
+        { \
+            (timesNS)[i] = COMPILER_TIME_GETNS( pointer, (COMPILE_TIME_INTERVALS)i ); \
+        } \
+    } while (0)
+
 #define COMPILER_TIME_PRINT( pointer, shaderType, shaderHash ) \
     do \
     { \
@@ -358,6 +424,7 @@ private:
                 (pointer)->m_compilerTimeStats->printTime( \
                     shaderType, shaderHash ); \
             } \
+            (pointer)->m_compilerTimeStats->printTrace( shaderType, shaderHash ); \
         } \
     } while (0)
 
@@ -365,7 +432,9 @@ private:
 
 #   define COMPILER_TIME_START( pointer, value ) do { } while (0)
 #   define COMPILER_TIME_END( pointer, value ) do { } while (0)
+#   define COMPILER_TIME_TRACE_SCOPE( pointer, kernelName, simd, retryId ) do { } while (0)
 #   define COMPILER_TIME_PRINT( pointer, shaderType, shaderhash ) do { } while (0)
+#   define COMPILER_TIME_SNAPSHOT( pointer, timesNS ) do { } while (0)
 #   define COMPILER_TIME_SUM( pointerDst, pointerSrc ) do { } while (0)
 #   define COMPILER_TIME_SUM2( pointerDst, pointerSrc ) do { } while (0)
 #   define COMPILER_TIME_SUM_PRINT( pointer ) do { } while (0)
@@ -375,6 +444,48 @@ private:
 
 #endif // GET_TIME_STATS
 
+// *******************************************************//
+//                 PROCESS-WIDE STATS TOTALS
+// *******************************************************//
+
+/// Totals of the time and shader stats of every compile of the process
+/// (EnableStatsTotals). Each compile keeps collecting into its own TimeStats
+/// and ShaderStats, which only its thread touches, and adds them here once,
+/// with relaxed atomic additions, so concurrent compiles never wait on each
+/// other. A snapshot may be taken at any time; each counter in it is exact,
+/// but a compile that is being added may be seen in some counters only.
+class StatsTotals
+{
+public:
+    static StatsTotals& get();
+
+    /// Add the times and hit counts of one compile
+    void addTimeStats( const TimeStats* pStats );
+    /// Add the stats of one compiled shader
+    void addShaderStats( ShaderStats* pStats );
+
+    /// Get the total time in nanoseconds and the total hit count of each timer
+    void snapshotTimes( uint64_t* pTimesNS, uint64_t* pHits, uint32_t count ) const;
+    /// Get the total of each shader stat item
+    void snapshotShaderStats( int64_t* pValues, uint32_t count ) const;
+
+private:
+    StatsTotals();
+
+    std::atomic<uint64_t> m_timeNS[MAX_COMPILE_TIME_INTERVALS];
+    std::atomic<uint64_t> m_hitCount[MAX_COMPILE_TIME_INTERVALS];
+    std::atomic<int64_t>  m_shaderStats[STATS_MAX_SHADER_STATS_ITEMS];
+};
+
+#define COMPILER_TIME_ADD_TOTALS( pointer ) \
+    do \
+    { \
+        if( (pointer) && (pointer)->m_compilerTimeStats && IGC_IS_FLAG_ENABLED(EnableStatsTotals) ) \
+        { \
+            StatsTotals::get().addTimeStats( (pointer)->m_compilerTimeStats ); \
+        } \
+    } while (0)
+
 #if GET_MEM_STATS
 #include <list>
 #include <algorithm>
@@ -422,6 +533,8 @@ public:
     void UsageSnapshot( IGC::SHADER_MEMORY_SNAPSHOT phase );
     void CreateMemStatsFiles();
     void DumpMemoryStats( ShaderType type, ShaderHash hash );
+    void DumpMemoryStatsJSON( ShaderType type, ShaderHash hash );
+    void RecordFinalizerPeaks( unsigned simd, unsigned irKB, unsigned raKB, unsigned postRAKB );
     void DumpStats( const char *shaderName );
     void SetDetailed( bool Enable );
     void CopyToSummary();
@@ -439,6 +552,16 @@ public:
     MemStat m_Stat;
     MemStat m_Snapshots[ IGC::MAX_SHADER_MEMORY_SNAPSHOT ];
 
+    // Peak vISA arena memory of each finalizer invocation, in KB.
+    struct FinalizerPeaks
+    {
+        unsigned SIMD;
+        unsigned IR;
+        unsigned RA;
+        unsigned PostRA;
+    };
+    std::vector<FinalizerPeaks> m_FinalizerPeaks;
+
 protected:
     int m_SnapCnt;
     int m_LastSnapHeapUsed;
@@ -457,6 +580,8 @@ void UsageReset();
 #   define MEM_USAGERESET           g_MemoryReport.UsageReset()
 #   define MEM_INIT                 g_MemoryReport.CreateMemStatsFiles()
 #   define MEM_DUMP( type, hash )   g_MemoryReport.DumpMemoryStats( type, hash )
+#   define MEM_DUMP_JSON( type, hash ) g_MemoryReport.DumpMemoryStatsJSON( type, hash )
+#   define MEM_FINALIZER_PEAKS( simd, ir, ra, postRA ) g_MemoryReport.RecordFinalizerPeaks( simd, ir, ra, postRA )
 #   define MEM_DUMP_SUMMARY         g_MemoryReport.DumpSummaryStats()
 
 #else
@@ -465,5 +590,7 @@ void UsageReset();
 #   define MEM_USAGERESET           do { } while (0)
 #   define MEM_INIT                 do { } while (0)
 #   define MEM_DUMP( type, hash )   do { } while (0)
+#   define MEM_DUMP_JSON( type, hash ) do { } while (0)
+#   define MEM_FINALIZER_PEAKS( simd, ir, ra, postRA ) do { } while (0)
 #   define MEM_DUMP_SUMMARY         do { } while (0)
 #endif
@@ -29,6 +29,7 @@
 import os
 import sys
 import errno
+import zlib
 
 # usage: autogen.py <path_to_MDFrameWork.h> <path_to_MDNodeFuncs.gen>
 __MDFrameWorkFile__ = sys.argv[1]
@@ -49,6 +50,7 @@ inputFile = open(__MDFrameWorkFile__, 'r')
 enumNames = []
 structureNames = []
 structDataMembers = []
+structBlobMembers = []
 
 with inputFile as file:
     insideIGCNameSpace = False
@@ -234,6 +236,7 @@ def genCode():
                                     line = next(file, None)
                                 line = line.split("//")[0]
                             printCalls(item)
+                            structBlobMembers.append((item, list(structDataMembers)))
                             del structDataMembers[:]
                             foundStruct = False
                             insideStruct = False
@@ -313,4 +316,41 @@ def genCode():
                             insideStruct = False
         output.write("}\n\n")
 
+def genLayoutHash():
+    # Any change to MDFrameWork.h (ignoring comments and whitespace) changes the
+    # hash, so blobs written against an older layout are rejected when read.
+    crc = 0
+    with open(__MDFrameWorkFile__, 'r') as file:
+        for line in file:
+            line = "".join(line.split("//")[0].split())
+            crc = zlib.crc32(line.encode('utf-8'), crc)
+    output.write("static const uint32_t MDBlobLayoutHash = 0x%08x;\n\n" % (crc & 0xffffffff))
+
+def genBlobCode():
+    genLayoutHash()
+    for item in enumNames:
+        output.write("void writeBlob(IGC::" + item + " " + item + "Var, MDBlobWriter& w)\n")
+        output.write("{\n")
+        output.write("    w.writePOD((uint32_t)" + item + "Var);\n")
+        output.write("}\n\n")
+        output.write("void readBlob(IGC::" + item + " &" + item + "Var, MDBlobReader& r)\n")
+        output.write("{\n")
+        output.write("    uint32_t val = 0;\n")
+        output.write("    r.readPOD(val);\n")
+        output.write("    " + item + "Var = (IGC::" + item + ")val;\n")
+        output.write("}\n\n")
+
+    for (item, members) in structBlobMembers:
+        output.write("void writeBlob(const IGC::" + item + "& " + item + "Var, MDBlobWriter& w)\n")
+        output.write("{\n")
+        for member in members:
+            output.write("    writeBlob(" + item + "Var." + member[:-1] + ", w);\n")
+        output.write("}\n\n")
+        output.write("void readBlob(IGC::" + item + " &" + item + "Var, MDBlobReader& r)\n")
+        output.write("{\n")
+        for member in members:
+            output.write("    readBlob(" + item + "Var." + member[:-1] + ", r);\n")
+        output.write("}\n\n")
+
 genCode()
+genBlobCode()
@@ -277,12 +277,12 @@ namespace {
 
 void RegisterErrHandlers()
 {
-    static bool executed = false;
-    if (!executed)
-    {
+    // install_fatal_error_handler asserts if a handler is already installed,
+    // so concurrent first compiles must not both get here.
+    static std::once_flag executed;
+    std::call_once(executed, []() {
         install_fatal_error_handler( FatalErrorHandler, nullptr );
-        executed = true;
-    }
+    });
 }
 
 void RegisterComputeErrHandlers(LLVMContext &C)
@@ -26,6 +26,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/debug/Dump.hpp"
 
 #include "common/debug/TeeOutputStream.hpp"
+#include "common/debug/DumpWriter.hpp"
 
 #include "AdaptorCommon/customApi.hpp"
 #include "Compiler/CodeGenPublic.h"
@@ -539,14 +540,11 @@ Dump::Dump( DumpName const& dumpName, DumpType type )
 
 Dump::~Dump()
 {
-    std::ofstream asmFile(m_name.str());
-
     // Delete the stream first to flush all data to the underlying m_string.
     delete m_pStream;
     m_pStream = nullptr;
 
-    asmFile << m_string;
-    asmFile.close();
+    WriteDumpFile(m_name.str(), std::move(m_string));
 }
 
 llvm::raw_ostream& Dump::stream() const
@@ -0,0 +1,235 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#include "common/debug/DumpWriter.hpp"
+
+#include "AdaptorCommon/customApi.hpp"
+#include "common/igc_regkeys.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Config/llvm-config.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/Compression.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+// Archive layout: the 8 byte magic "IGCDUMP1", then one record per dump:
+//   uint32_t flags        bit 0 set if the data is zlib compressed
+//   uint32_t pathSize
+//   uint64_t rawSize      size of the dump once uncompressed
+//   uint64_t storedSize   size of the data that follows the path
+//   char     path[pathSize]
+//   char     data[storedSize]
+// All fields are in host byte order.
+
+namespace IGC
+{
+namespace Debug
+{
+
+namespace
+{
+    const char ARCHIVE_MAGIC[8] = { 'I', 'G', 'C', 'D', 'U', 'M', 'P', '1' };
+    const uint32_t ARCHIVE_FLAG_ZLIB = 1;
+
+    class DumpWriter
+    {
+    public:
+        static DumpWriter& get()
+        {
+            static DumpWriter writer;
+            return writer;
+        }
+
+        void write(const std::string& path, std::string data)
+        {
+            if (IGC_IS_FLAG_DISABLED(EnableAsyncShaderDump))
+            {
+                std::lock_guard<std::mutex> lock(m_writeMutex);
+                writeNow(path, data);
+                return;
+            }
+
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            if (!m_thread.joinable())
+            {
+                m_thread = std::thread(&DumpWriter::run, this);
+            }
+
+            // A single dump larger than the limit still goes through once
+            // the queue is empty.
+            const size_t maxBytes = (size_t)IGC_GET_FLAG_VALUE(AsyncShaderDumpQueueMaxMB) * 1024 * 1024;
+            m_spaceAvailable.wait(lock, [&]() {
+                return m_queuedBytes == 0 || m_queuedBytes + data.size() <= maxBytes;
+            });
+
+            m_queuedBytes += data.size();
+            m_queue.emplace_back(path, std::move(data));
+            m_workAvailable.notify_one();
+        }
+
+        void flush()
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_idle.wait(lock, [&]() { return m_queue.empty() && !m_writing; });
+        }
+
+        ~DumpWriter()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_queueMutex);
+                m_stop = true;
+                m_workAvailable.notify_one();
+            }
+            if (m_thread.joinable())
+            {
+                m_thread.join();
+            }
+        }
+
+    private:
+        DumpWriter() = default;
+        DumpWriter(const DumpWriter&) = delete;
+        DumpWriter& operator=(const DumpWriter&) = delete;
+
+        void run()
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            while (true)
+            {
+                m_workAvailable.wait(lock, [&]() { return m_stop || !m_queue.empty(); });
+                if (m_queue.empty())
+                {
+                    // m_stop is set and everything is written.
+                    return;
+                }
+
+                std::pair<std::string, std::string> item = std::move(m_queue.front());
+                m_queue.pop_front();
+                m_writing = true;
+                lock.unlock();
+
+                {
+                    std::lock_guard<std::mutex> writeLock(m_writeMutex);
+                    writeNow(item.first, item.second);
+                }
+
+                lock.lock();
+                m_writing = false;
+                m_queuedBytes -= item.second.size();
+                m_spaceAvailable.notify_all();
+                if (m_queue.empty())
+                {
+                    m_idle.notify_all();
+                }
+            }
+        }
+
+        // Callers hold m_writeMutex.
+        void writeNow(const std::string& path, const std::string& data)
+        {
+            if (IGC_IS_FLAG_ENABLED(ShaderDumpArchive))
+            {
+                appendToArchive(path, data);
+                return;
+            }
+            std::ofstream file(path, std::ios::out | std::ios::binary);
+            file.write(data.data(), data.size());
+        }
+
+        void appendToArchive(const std::string& path, const std::string& data)
+        {
+            if (!m_archive.is_open())
+            {
+                std::string archivePath = std::string(GetShaderOutputFolder()) + "dumps.igcdump";
+                m_archive.open(archivePath, std::ios::out | std::ios::binary | std::ios::trunc);
+                m_archive.write(ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+            }
+
+            uint32_t flags = 0;
+            llvm::StringRef stored(data);
+            llvm::SmallVector<char, 0> compressed;
+#if LLVM_VERSION_MAJOR >= 7
+            if (llvm::zlib::isAvailable())
+            {
+                if (llvm::Error E = llvm::zlib::compress(data, compressed))
+                {
+                    llvm::consumeError(std::move(E));
+                }
+                else
+                {
+                    flags |= ARCHIVE_FLAG_ZLIB;
+                    stored = llvm::StringRef(compressed.data(), compressed.size());
+                }
+            }
+#endif
+
+            uint32_t pathSize = (uint32_t)path.size();
+            uint64_t rawSize = data.size();
+            uint64_t storedSize = stored.size();
+            m_archive.write(reinterpret_cast<const char*>(&flags), sizeof(flags));
+            m_archive.write(reinterpret_cast<const char*>(&pathSize), sizeof(pathSize));
+            m_archive.write(reinterpret_cast<const char*>(&rawSize), sizeof(rawSize));
+            m_archive.write(reinterpret_cast<const char*>(&storedSize), sizeof(storedSize));
+            m_archive.write(path.data(), pathSize);
+            m_archive.write(stored.data(), storedSize);
+            m_archive.flush();
+        }
+
+        std::mutex m_queueMutex;
+        std::condition_variable m_workAvailable;
+        std::condition_variable m_spaceAvailable;
+        std::condition_variable m_idle;
+        std::deque<std::pair<std::string, std::string>> m_queue;
+        size_t m_queuedBytes = 0;
+        bool m_writing = false;
+        bool m_stop = false;
+        std::thread m_thread;
+
+        std::mutex m_writeMutex;
+        std::ofstream m_archive;
+    };
+}
+
+void WriteDumpFile(const std::string& path, std::string data)
+{
+    DumpWriter::get().write(path, std::move(data));
+}
+
+void FlushDumpFiles()
+{
+    DumpWriter::get().flush();
+}
+
+} // namespace Debug
+} // namespace IGC
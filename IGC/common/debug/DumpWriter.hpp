@@ -0,0 +1,49 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#pragma once
+
+#include <string>
+
+namespace IGC
+{
+namespace Debug
+{
+
+/// Writes a finished dump file.
+///
+/// With EnableAsyncShaderDump the data is handed to a background writer
+/// thread and the call returns right away, unless the queue already holds
+/// more than AsyncShaderDumpQueueMaxMB; then the caller waits until the
+/// writer catches up. With ShaderDumpArchive every dump of the process is
+/// appended to a single archive in the shader dump folder instead of
+/// getting its own file (see DumpWriter.cpp for the layout).
+void WriteDumpFile(const std::string& path, std::string data);
+
+/// Blocks until every queued dump has been written.
+void FlushDumpFiles();
+
+} // namespace Debug
+} // namespace IGC
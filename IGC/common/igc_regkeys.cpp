@@ -36,6 +36,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <string>
 #include <cassert>
 #include <utility>
+#include <map>
+#include <memory>
 #include <fstream>
 #include <sstream>
 #include <mutex>
@@ -418,6 +420,84 @@ void SetCurrentDebugHash(unsigned long long hash)
 	g_CurrentShaderHash = hash;
 }
 
+thread_local SRegKeysList* g_pThreadRegKeyList = nullptr;
+
+// Makes the regkeys of the calling thread a copy of g_RegKeyList with the
+// settings applied, given in the syntax of Options.txt lines
+// ("Name=Value,Name=Value") and valid for all shaders. NULL or an empty
+// string returns the thread to g_RegKeyList.
+void SetThreadRegKeyOverrides(const char* pSettings)
+{
+    static thread_local std::unique_ptr<SRegKeysList> threadRegKeyList;
+
+    g_pThreadRegKeyList = nullptr;
+    if (pSettings == nullptr || pSettings[0] == '\0')
+    {
+        threadRegKeyList.reset();
+        return;
+    }
+
+    threadRegKeyList.reset(new SRegKeysList(g_RegKeyList));
+    std::string line(pSettings);
+    std::vector<HashRange> hashes;
+#define DECLARE_IGC_REGKEY(dataType, regkeyName, defaultValue, description)                 \
+{                                                                                           \
+    declareIGCKey(line, #dataType, #regkeyName, hashes, &(threadRegKeyList->regkeyName));   \
+}
+#include "igc_regkeys.def"
+#undef DECLARE_IGC_REGKEY
+
+    // As in LoadRegistryKeys, a forced SIMD width only leaves its own
+    // EnableOCLSIMD<N> on.
+    if (line.find("ForceOCLSIMDWidth") != std::string::npos)
+    {
+        unsigned simdWidth = threadRegKeyList->ForceOCLSIMDWidth.m_Value;
+        threadRegKeyList->EnableOCLSIMD32.m_Value = (simdWidth == 32);
+        threadRegKeyList->EnableOCLSIMD16.m_Value = (simdWidth == 16);
+        if (simdWidth != 8 && simdWidth != 16 && simdWidth != 32)
+        {
+            threadRegKeyList->ForceOCLSIMDWidth.m_Value = 0;
+            threadRegKeyList->EnableOCLSIMD32.m_Value = g_RegKeyList.EnableOCLSIMD32.m_Value;
+            threadRegKeyList->EnableOCLSIMD16.m_Value = g_RegKeyList.EnableOCLSIMD16.m_Value;
+        }
+    }
+    g_pThreadRegKeyList = threadRegKeyList.get();
+}
+
+// Settings of the TuningDatabase keyed by ShaderHash. Written only by
+// LoadRegistryKeys, read-only afterwards.
+static std::map<unsigned long long, std::string> g_TuningDatabase;
+
+// parses lines of this syntax, '#' starts a comment line:
+// abcdabcdabcdabcd Name=Value,Name=Value
+static void LoadTuningDatabase()
+{
+    const char* pFileName = IGC_GET_REGKEYSTRING(TuningDatabase);
+    if (pFileName[0] == '\0')
+    {
+        return;
+    }
+
+    std::ifstream input(pFileName);
+    std::string line;
+    while (std::getline(input, line))
+    {
+        std::stringstream sline(line);
+        std::string hash, settings;
+        if (!(sline >> hash >> settings) || hash[0] == '#')
+        {
+            continue;
+        }
+        g_TuningDatabase[std::stoull(hash, nullptr, 16)] = settings;
+    }
+}
+
+const char* GetTunedRegKeySettings(unsigned long long hash)
+{
+    auto it = g_TuningDatabase.find(hash);
+    return it == g_TuningDatabase.end() ? nullptr : it->second.c_str();
+}
+
 /*****************************************************************************\
 
 Function:
@@ -446,6 +526,7 @@ void LoadRegistryKeys( void )
 		DumpIGCRegistryKeyDefinitions();
 		LoadDebugFlagsFromFile();
 		LoadFromRegKeyOrEnvVar();
+		LoadTuningDatabase();
 
 		if(IGC_IS_FLAG_ENABLED(LLVMCommandLine))
 		{
@@ -94,20 +94,27 @@ struct SRegKeysList
 #undef DECLARE_IGC_REGKEY
 bool CheckHashRange(const std::vector<HashRange>&);
 extern SRegKeysList g_RegKeyList;
+// Regkeys of the calling thread while SetThreadRegKeyOverrides is in effect.
+extern thread_local SRegKeysList* g_pThreadRegKeyList;
+#define IGC_REGKEY_LIST                            ( g_pThreadRegKeyList ? *g_pThreadRegKeyList : g_RegKeyList )
 #define IGC_GET_FLAG_VALUE( name )                 \
-( CheckHashRange(g_RegKeyList.name.hashes) ? g_RegKeyList.name.m_Value : g_RegKeyList.name.GetDefault())
+( CheckHashRange(IGC_REGKEY_LIST.name.hashes) ? IGC_REGKEY_LIST.name.m_Value : IGC_REGKEY_LIST.name.GetDefault())
 #define IGC_IS_FLAG_ENABLED( name )                ( IGC_GET_FLAG_VALUE(name) != 0 )
 #define IGC_IS_FLAG_DISABLED( name )               ( !IGC_IS_FLAG_ENABLED(name) )
-#define IGC_SET_FLAG_VALUE( name, regkeyValue )    ( g_RegKeyList.name.m_Value = regkeyValue )
+#define IGC_SET_FLAG_VALUE( name, regkeyValue )    ( IGC_REGKEY_LIST.name.m_Value = regkeyValue )
 #define IGC_GET_REGKEYSTRING( name )               \
-( CheckHashRange(g_RegKeyList.name.hashes) ? g_RegKeyList.name.m_string : "" )
+( CheckHashRange(IGC_REGKEY_LIST.name.hashes) ? IGC_REGKEY_LIST.name.m_string : "" )
 
 void DumpIGCRegistryKeyDefinitions();
 void LoadRegistryKeys();
 void SetCurrentDebugHash(unsigned long long hash);
+void SetThreadRegKeyOverrides(const char* pSettings);
+const char* GetTunedRegKeySettings(unsigned long long hash);
 #else
 static inline void SetCurrentDebugHash(unsigned long long hash) {}
 static inline void LoadRegistryKeys() {}
+static inline void SetThreadRegKeyOverrides(const char* pSettings) {}
+static inline const char* GetTunedRegKeySettings(unsigned long long hash) { return nullptr; }
 #define IGC_SET_FLAG_VALUE( name, regkeyValue ) ;
 #define DECLARE_IGC_REGKEY(dataType, regkeyName, defaultValue, description) \
     static const unsigned int regkeyName##default = (unsigned int)defaultValue;
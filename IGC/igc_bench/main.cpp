@@ -0,0 +1,1138 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+// igc_bench: compile-time benchmark over a corpus of OpenCL kernels.
+//
+// Every .spv/.bc file of the input directory is compiled N times per
+// platform through the translation block interface (the same path the
+// runtime takes), and per-phase medians from TimeStats are reported together
+// with peak memory, allocation count and a checksum of the generated binary.
+// Build options are taken from -options or from <name>_options.txt and
+// <name>_internal_options.txt next to the input, which is the layout produced
+// by ShaderDumpEnable.
+//
+// The static code metrics of every kernel (instruction count, sends by
+// target, spill bytes, GRF use and selected SIMD) can be written to a baseline
+// file with -write-baseline and compared against one with -baseline; metrics
+// that grow by more than -tolerance percent, or a changed SIMD, are reported
+// as regressions and make the exit code nonzero.
+//
+// With -tune, each input is instead compiled across a search space of regkey
+// settings (one knob per line of the file: its name and candidate values).
+// Knobs are tuned one at a time, keeping the best value of the others, until
+// no change improves the score: the summed static cycle estimate of the
+// kernels, or the number printed by the -measure command run on the binary.
+// The best settings that beat the defaults are written to the -tuning-db file
+// under the ShaderHash of the input; setting the TuningDatabase regkey to it
+// makes later builds of that input use them. This needs regkeys, i.e. a debug
+// or internal build of the compiler.
+
+#include "AdaptorOCL/TranslationBlock.h"
+#include "AdaptorOCL/GlobalData.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <dirent.h>
+#endif
+
+using namespace TC;
+
+// Every operator new that resolves to this executable is counted. On Linux
+// this includes the allocations of libigc; on Windows only the allocations of
+// the benchmark itself are seen, since the DLL has its own CRT.
+static std::atomic<uint64_t> g_numAllocations(0);
+
+void* operator new(size_t size)
+{
+    g_numAllocations++;
+    if (void* p = malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    free(p);
+}
+
+namespace
+{
+
+struct BenchPlatform
+{
+    const char*    name;
+    PRODUCT_FAMILY productFamily;
+    GFXCORE_FAMILY coreFamily;
+};
+
+const BenchPlatform g_cPlatforms[] =
+{
+    { "bdw",   IGFX_BROADWELL,  IGFX_GEN8_CORE  },
+    { "skl",   IGFX_SKYLAKE,    IGFX_GEN9_CORE  },
+    { "kbl",   IGFX_KABYLAKE,   IGFX_GEN9_CORE  },
+    { "cfl",   IGFX_COFFEELAKE, IGFX_GEN9_CORE  },
+    { "bxt",   IGFX_BROXTON,    IGFX_GEN9_CORE  },
+    { "glk",   IGFX_GEMINILAKE, IGFX_GEN9_CORE  },
+    { "icllp", IGFX_ICELAKE_LP, IGFX_GEN11_CORE },
+    { "lkf",   IGFX_LAKEFIELD,  IGFX_GEN11_CORE },
+};
+
+struct BenchOptions
+{
+    std::string              inputDir;
+    std::vector<std::string> platforms;
+    std::string              options;
+    std::string              internalOptions;
+    std::string              csvFile;
+    std::string              baselineFile;
+    std::string              writeBaselineFile;
+    double                   tolerancePct = 0.0;
+    unsigned                 iterations = 5;
+    bool                     printPhases = false;
+    std::string              tuneFile;
+    std::string              tuningDbFile;
+    std::string              measureCmd;
+};
+
+// A compiler knob and the values tried for it by -tune.
+struct TuningKnob
+{
+    std::string              name;
+    std::vector<std::string> values;
+};
+
+// Knob settings keyed by knob name; knobs not present keep their default.
+typedef std::map<std::string, std::string> TuningSettings;
+
+struct BenchInput
+{
+    std::string       name;
+    TB_DATA_FORMAT    format;
+    std::vector<char> data;
+    std::string       options;
+    std::string       internalOptions;
+};
+
+struct KernelMetrics
+{
+    std::string kernel;
+    uint32_t    simd = 0;
+    uint32_t    instructions = 0;
+    uint32_t    samplerSends = 0;
+    uint32_t    dataPortSends = 0;
+    uint32_t    otherSends = 0;
+    uint32_t    spillBytes = 0;
+    uint32_t    grfUsed = 0;
+};
+
+// Baseline metrics keyed by input, platform and kernel name.
+typedef std::map<std::string, KernelMetrics> Baseline;
+
+struct BenchResult
+{
+    std::string                        input;
+    std::string                        platform;
+    bool                               success = false;
+    bool                               deterministic = true;
+    std::vector<std::vector<uint64_t>> phaseNS;      // [interval][iteration]
+    std::vector<uint64_t>              wallNS;       // [iteration]
+    uint64_t                           allocations = 0;
+    uint64_t                           peakKB = 0;
+    uint32_t                           binarySize = 0;
+    uint64_t                           checksum = 0;
+    std::vector<KernelMetrics>         kernels;
+};
+
+void PrintUsage(const char* exe)
+{
+    fprintf(stderr,
+        "Usage: %s [options] <input dir>\n"
+        "  -platform <list>          comma separated list of platforms (default skl)\n"
+        "  -iterations <N>           compiles per input and platform (default 5)\n"
+        "  -options <str>            build options for inputs without an _options.txt\n"
+        "  -internal_options <str>   internal options for inputs without an _internal_options.txt\n"
+        "  -phases                   print per-phase medians of every input\n"
+        "  -csv <file>               write per-input, per-phase medians as CSV\n"
+        "  -write-baseline <file>    write the static code metrics of every kernel\n"
+        "  -baseline <file>          compare static code metrics against a baseline\n"
+        "  -tolerance <pct>          allowed growth of a metric over the baseline (default 0)\n"
+        "  -tune <file>              tune each input over the knobs of file (\"Name value value ...\" lines)\n"
+        "  -tuning-db <file>         tuning database updated by -tune (default igc_tuning.txt)\n"
+        "  -measure <cmd>            score variants by the number \"cmd <binary file>\" prints (lower is better)\n"
+        "                            instead of the static cycle estimate\n"
+        "Platforms:",
+        exe);
+    for (const BenchPlatform& platform : g_cPlatforms)
+    {
+        fprintf(stderr, " %s", platform.name);
+    }
+    fprintf(stderr, "\n");
+}
+
+bool ParseArgs(int argc, char* argv[], BenchOptions& opts)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-platform" && hasValue)
+        {
+            std::stringstream list(argv[++i]);
+            std::string name;
+            while (std::getline(list, name, ','))
+            {
+                opts.platforms.push_back(name);
+            }
+        }
+        else if (arg == "-iterations" && hasValue)
+        {
+            opts.iterations = std::max(1, atoi(argv[++i]));
+        }
+        else if (arg == "-options" && hasValue)
+        {
+            opts.options = argv[++i];
+        }
+        else if (arg == "-internal_options" && hasValue)
+        {
+            opts.internalOptions = argv[++i];
+        }
+        else if (arg == "-csv" && hasValue)
+        {
+            opts.csvFile = argv[++i];
+        }
+        else if (arg == "-baseline" && hasValue)
+        {
+            opts.baselineFile = argv[++i];
+        }
+        else if (arg == "-write-baseline" && hasValue)
+        {
+            opts.writeBaselineFile = argv[++i];
+        }
+        else if (arg == "-tolerance" && hasValue)
+        {
+            opts.tolerancePct = std::max(0.0, atof(argv[++i]));
+        }
+        else if (arg == "-tune" && hasValue)
+        {
+            opts.tuneFile = argv[++i];
+        }
+        else if (arg == "-tuning-db" && hasValue)
+        {
+            opts.tuningDbFile = argv[++i];
+        }
+        else if (arg == "-measure" && hasValue)
+        {
+            opts.measureCmd = argv[++i];
+        }
+        else if (arg == "-phases")
+        {
+            opts.printPhases = true;
+        }
+        else if (arg[0] != '-' && opts.inputDir.empty())
+        {
+            opts.inputDir = arg;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    if (opts.platforms.empty())
+    {
+        opts.platforms.push_back("skl");
+    }
+    if (opts.tuningDbFile.empty())
+    {
+        opts.tuningDbFile = "igc_tuning.txt";
+    }
+    return !opts.inputDir.empty();
+}
+
+const BenchPlatform* FindPlatform(const std::string& name)
+{
+    for (const BenchPlatform& platform : g_cPlatforms)
+    {
+        if (name == platform.name)
+        {
+            return &platform;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<std::string> ListDirectory(const std::string& dir)
+{
+    std::vector<std::string> files;
+#if defined(_WIN32)
+    WIN32_FIND_DATAA findData;
+    HANDLE hFind = FindFirstFileA((dir + "\\*").c_str(), &findData);
+    if (hFind != INVALID_HANDLE_VALUE)
+    {
+        do
+        {
+            if (!(findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+            {
+                files.push_back(findData.cFileName);
+            }
+        } while (FindNextFileA(hFind, &findData));
+        FindClose(hFind);
+    }
+#else
+    if (DIR* pDir = opendir(dir.c_str()))
+    {
+        while (dirent* pEntry = readdir(pDir))
+        {
+            if (pEntry->d_name[0] != '.')
+            {
+                files.push_back(pEntry->d_name);
+            }
+        }
+        closedir(pDir);
+    }
+#endif
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+bool ReadFile(const std::string& path, std::vector<char>& data)
+{
+    std::ifstream is(path.c_str(), std::ios::binary);
+    if (!is)
+    {
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+    return true;
+}
+
+std::string ReadOptionsFile(const std::string& path, const std::string& fallback)
+{
+    std::vector<char> data;
+    if (!ReadFile(path, data))
+    {
+        return fallback;
+    }
+    // Dumped option files may carry the terminating null of the original string.
+    while (!data.empty() && (data.back() == '\0' || data.back() == '\n'))
+    {
+        data.pop_back();
+    }
+    return std::string(data.begin(), data.end());
+}
+
+bool EndsWith(const std::string& str, const std::string& suffix)
+{
+    return str.size() >= suffix.size() &&
+        str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+std::vector<BenchInput> LoadCorpus(const BenchOptions& opts)
+{
+    std::vector<BenchInput> corpus;
+    for (const std::string& file : ListDirectory(opts.inputDir))
+    {
+        BenchInput input;
+        if (EndsWith(file, ".spv"))
+        {
+            input.format = TB_DATA_FORMAT_SPIR_V;
+        }
+        else if (EndsWith(file, ".bc"))
+        {
+            input.format = TB_DATA_FORMAT_LLVM_BINARY;
+        }
+        else
+        {
+            continue;
+        }
+
+        std::string path = opts.inputDir + "/" + file;
+        std::string base = path.substr(0, path.rfind('.'));
+        if (!ReadFile(path, input.data) || input.data.empty())
+        {
+            fprintf(stderr, "igc_bench: cannot read %s\n", path.c_str());
+            continue;
+        }
+        input.name = file;
+        input.options = ReadOptionsFile(base + "_options.txt", opts.options);
+        input.internalOptions = ReadOptionsFile(base + "_internal_options.txt", opts.internalOptions);
+        corpus.push_back(input);
+    }
+    return corpus;
+}
+
+// Resets the peak resident set so the next reading covers only the work
+// done in between. Only Linux allows this; elsewhere the peak is process-wide.
+void ResetPeakMemory()
+{
+#if !defined(_WIN32)
+    if (FILE* fp = fopen("/proc/self/clear_refs", "w"))
+    {
+        fputs("5", fp);
+        fclose(fp);
+    }
+#endif
+}
+
+uint64_t GetPeakMemoryKB()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return counters.PeakWorkingSetSize / 1024;
+    }
+#else
+    if (FILE* fp = fopen("/proc/self/status", "r"))
+    {
+        char line[256];
+        unsigned long long peakKB = 0;
+        while (fgets(line, sizeof(line), fp))
+        {
+            if (sscanf(line, "VmHWM: %llu kB", &peakKB) == 1)
+            {
+                break;
+            }
+        }
+        fclose(fp);
+        return peakKB;
+    }
+#endif
+    return 0;
+}
+
+// FNV-1a
+uint64_t Checksum(const char* pData, uint32_t size)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (uint32_t i = 0; i < size; i++)
+    {
+        hash ^= (unsigned char)pData[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+uint64_t Median(std::vector<uint64_t> values)
+{
+    if (values.empty())
+    {
+        return 0;
+    }
+    std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+    return values[values.size() / 2];
+}
+
+double ToMS(uint64_t ns)
+{
+    return ns / 1000000.0;
+}
+
+CTranslationBlock* CreateTranslationBlock(
+    const BenchPlatform& benchPlatform,
+    TB_DATA_FORMAT inputFormat)
+{
+    PLATFORM platform;
+    memset(&platform, 0, sizeof(platform));
+    platform.eProductFamily = benchPlatform.productFamily;
+    platform.eDisplayCoreFamily = benchPlatform.coreFamily;
+    platform.eRenderCoreFamily = benchPlatform.coreFamily;
+
+    SKU_FEATURE_TABLE skuTable;
+    memset(&skuTable, 0, sizeof(skuTable));
+    WA_TABLE waTable;
+    memset(&waTable, 0, sizeof(waTable));
+
+    // A GT2 configuration; the compiler only uses it for thread count heuristics.
+    GT_SYSTEM_INFO sysInfo;
+    memset(&sysInfo, 0, sizeof(sysInfo));
+    sysInfo.EUCount = 24;
+    sysInfo.ThreadCount = 24 * 7;
+    sysInfo.SliceCount = 1;
+    sysInfo.SubSliceCount = 3;
+
+    SGlobalData globalData;
+    globalData.pPlatform = &platform;
+    globalData.pSkuTable = &skuTable;
+    globalData.pWaTable = &waTable;
+    globalData.pSysInfo = &sysInfo;
+    globalData.ProfilingTimerResolution = 83.333f;
+
+    // Initialize() copies the platform description, so stack storage is fine.
+    STB_CreateArgs createArgs;
+    createArgs.TranslationCode.Type.Input = inputFormat;
+    createArgs.TranslationCode.Type.Output = TB_DATA_FORMAT_DEVICE_BINARY;
+    createArgs.pCreateData = &globalData;
+    return Create(&createArgs);
+}
+
+BenchResult RunInput(
+    const BenchOptions& opts,
+    const BenchPlatform& platform,
+    const BenchInput& input)
+{
+    BenchResult result;
+    result.input = input.name;
+    result.platform = platform.name;
+
+    CTranslationBlock* pTranslationBlock = CreateTranslationBlock(platform, input.format);
+    if (!pTranslationBlock)
+    {
+        return result;
+    }
+
+    uint32_t numIntervals = GetLastCompileTimes(nullptr, nullptr, 0);
+    result.phaseNS.resize(numIntervals);
+    std::vector<uint64_t> timesNS(numIntervals);
+
+    STB_TranslateInputArgs inputArgs;
+    inputArgs.pInput = const_cast<char*>(input.data.data());
+    inputArgs.InputSize = (uint32_t)input.data.size();
+    inputArgs.pOptions = input.options.c_str();
+    inputArgs.OptionsSize = (uint32_t)input.options.size();
+    inputArgs.pInternalOptions = input.internalOptions.c_str();
+    inputArgs.InternalOptionsSize = (uint32_t)input.internalOptions.size();
+    // Also keeps the binary cache out of the measurement.
+    inputArgs.CompileTimeStatisticsEnable = true;
+
+    ResetPeakMemory();
+    uint64_t allocationsBefore = g_numAllocations;
+
+    result.success = true;
+    for (unsigned iter = 0; iter < opts.iterations && result.success; iter++)
+    {
+        STB_TranslateOutputArgs outputArgs;
+
+        auto start = std::chrono::steady_clock::now();
+        result.success = pTranslationBlock->Translate(&inputArgs, &outputArgs);
+        auto end = std::chrono::steady_clock::now();
+
+        if (result.success)
+        {
+            result.wallNS.push_back(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+            GetLastCompileTimes(nullptr, timesNS.data(), numIntervals);
+            for (uint32_t i = 0; i < numIntervals; i++)
+            {
+                result.phaseNS[i].push_back(timesNS[i]);
+            }
+
+            uint64_t checksum = Checksum(outputArgs.pOutput, outputArgs.OutputSize);
+            if (iter == 0)
+            {
+                result.binarySize = outputArgs.OutputSize;
+                result.checksum = checksum;
+
+                std::vector<STB_KernelMetrics> metrics(GetLastKernelMetrics(nullptr, 0));
+                GetLastKernelMetrics(metrics.data(), (uint32_t)metrics.size());
+                for (const STB_KernelMetrics& kernelMetrics : metrics)
+                {
+                    KernelMetrics kernel;
+                    kernel.kernel = kernelMetrics.pKernelName;
+                    kernel.simd = kernelMetrics.SIMDSize;
+                    kernel.instructions = kernelMetrics.InstructionCount;
+                    kernel.samplerSends = kernelMetrics.SamplerSends;
+                    kernel.dataPortSends = kernelMetrics.DataPortSends;
+                    kernel.otherSends = kernelMetrics.OtherSends;
+                    kernel.spillBytes = kernelMetrics.SpillBytes;
+                    kernel.grfUsed = kernelMetrics.GRFUsed;
+                    result.kernels.push_back(kernel);
+                }
+            }
+            result.deterministic &= checksum == result.checksum;
+        }
+        else if (outputArgs.pErrorString)
+        {
+            fprintf(stderr, "igc_bench: %s (%s): %s\n",
+                input.name.c_str(), platform.name, outputArgs.pErrorString);
+        }
+
+        pTranslationBlock->FreeAllocations(&outputArgs);
+    }
+
+    result.allocations = (g_numAllocations - allocationsBefore) / opts.iterations;
+    result.peakKB = GetPeakMemoryKB();
+
+    Delete(pTranslationBlock);
+    return result;
+}
+
+std::string BaselineKey(
+    const std::string& input,
+    const std::string& platform,
+    const std::string& kernel)
+{
+    return input + "," + platform + "," + kernel;
+}
+
+const char* const g_cBaselineHeader =
+    "input,platform,kernel,simd,instructions,sampler_sends,dataport_sends,other_sends,spill_bytes,grf_used";
+
+bool ReadBaseline(const std::string& path, Baseline& baseline)
+{
+    std::ifstream is(path.c_str());
+    if (!is)
+    {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(is, line))
+    {
+        if (line.empty() || line == g_cBaselineHeader)
+        {
+            continue;
+        }
+
+        std::stringstream fields(line);
+        std::string input, platform, value;
+        KernelMetrics kernel;
+        std::getline(fields, input, ',');
+        std::getline(fields, platform, ',');
+        std::getline(fields, kernel.kernel, ',');
+        uint32_t* values[] = {
+            &kernel.simd, &kernel.instructions, &kernel.samplerSends, &kernel.dataPortSends,
+            &kernel.otherSends, &kernel.spillBytes, &kernel.grfUsed };
+        for (uint32_t* pValue : values)
+        {
+            std::getline(fields, value, ',');
+            *pValue = (uint32_t)strtoul(value.c_str(), nullptr, 10);
+        }
+        baseline[BaselineKey(input, platform, kernel.kernel)] = kernel;
+    }
+    return true;
+}
+
+void WriteBaseline(FILE* fp, const BenchResult& result)
+{
+    for (const KernelMetrics& kernel : result.kernels)
+    {
+        fprintf(fp, "%s,%s,%s,%u,%u,%u,%u,%u,%u,%u\n",
+            result.input.c_str(), result.platform.c_str(), kernel.kernel.c_str(),
+            kernel.simd, kernel.instructions, kernel.samplerSends, kernel.dataPortSends,
+            kernel.otherSends, kernel.spillBytes, kernel.grfUsed);
+    }
+}
+
+// Prints every metric of the result that regressed against the baseline and
+// returns the number of regressions. Kernels missing from the baseline are new
+// and not checked.
+unsigned CompareBaseline(
+    const BenchOptions& opts,
+    const Baseline& baseline,
+    const BenchResult& result)
+{
+    unsigned numRegressions = 0;
+    for (const KernelMetrics& kernel : result.kernels)
+    {
+        auto it = baseline.find(BaselineKey(result.input, result.platform, kernel.kernel));
+        if (it == baseline.end())
+        {
+            continue;
+        }
+        const KernelMetrics& base = it->second;
+
+        auto check = [&](const char* metric, uint32_t baseValue, uint32_t value)
+        {
+            if (value > baseValue * (1.0 + opts.tolerancePct / 100.0))
+            {
+                printf("    REGRESSION %s: %s %u -> %u\n", kernel.kernel.c_str(), metric, baseValue, value);
+                numRegressions++;
+            }
+        };
+
+        if (kernel.simd != base.simd)
+        {
+            printf("    REGRESSION %s: simd %u -> %u\n", kernel.kernel.c_str(), base.simd, kernel.simd);
+            numRegressions++;
+        }
+        check("instructions", base.instructions, kernel.instructions);
+        check("sampler sends", base.samplerSends, kernel.samplerSends);
+        check("dataport sends", base.dataPortSends, kernel.dataPortSends);
+        check("other sends", base.otherSends, kernel.otherSends);
+        check("spill bytes", base.spillBytes, kernel.spillBytes);
+        check("grf used", base.grfUsed, kernel.grfUsed);
+    }
+    return numRegressions;
+}
+
+void PrintPhases(
+    const std::vector<const char*>& names,
+    const std::vector<uint64_t>& mediansNS,
+    const char* indent)
+{
+    for (size_t i = 0; i < mediansNS.size(); i++)
+    {
+        if (mediansNS[i] != 0)
+        {
+            printf("%s%-40s %10.3f ms\n", indent, names[i], ToMS(mediansNS[i]));
+        }
+    }
+}
+
+bool ReadTuningKnobs(const std::string& path, std::vector<TuningKnob>& knobs)
+{
+    std::ifstream is(path.c_str());
+    if (!is)
+    {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(is, line))
+    {
+        std::stringstream fields(line);
+        TuningKnob knob;
+        if (!(fields >> knob.name) || knob.name[0] == '#')
+        {
+            continue;
+        }
+        std::string value;
+        while (fields >> value)
+        {
+            knob.values.push_back(value);
+        }
+        if (!knob.values.empty())
+        {
+            knobs.push_back(knob);
+        }
+    }
+    return true;
+}
+
+// The settings in regkey option syntax: "Name=Value,Name=Value".
+std::string FormatSettings(const TuningSettings& settings)
+{
+    std::string str;
+    for (const auto& setting : settings)
+    {
+        str += (str.empty() ? "" : ",") + setting.first + "=" + setting.second;
+    }
+    return str;
+}
+
+// Runs the -measure command on the binary and returns the first number it
+// prints, or false if it fails.
+bool MeasureBinary(
+    const BenchOptions& opts,
+    const BenchInput& input,
+    const STB_TranslateOutputArgs& outputArgs,
+    double& score)
+{
+    std::string path = input.name + ".tune.bin";
+    {
+        std::ofstream os(path.c_str(), std::ios::binary);
+        os.write(outputArgs.pOutput, outputArgs.OutputSize);
+        if (!os)
+        {
+            return false;
+        }
+    }
+
+    std::string cmd = opts.measureCmd + " \"" + path + "\"";
+#if defined(_WIN32)
+    FILE* fp = _popen(cmd.c_str(), "r");
+#else
+    FILE* fp = popen(cmd.c_str(), "r");
+#endif
+    if (!fp)
+    {
+        return false;
+    }
+    bool success = fscanf(fp, "%lf", &score) == 1;
+#if defined(_WIN32)
+    success &= _pclose(fp) == 0;
+#else
+    success &= pclose(fp) == 0;
+#endif
+    remove(path.c_str());
+    return success;
+}
+
+// Compiles the input once with the settings and scores the result; lower is
+// better.
+bool EvaluateSettings(
+    const BenchOptions& opts,
+    CTranslationBlock* pTranslationBlock,
+    const BenchInput& input,
+    const TuningSettings& settings,
+    double& score)
+{
+    TuningSettings compileSettings = settings;
+    if (opts.measureCmd.empty())
+    {
+        compileSettings["EnableStaticCycleEstimate"] = "1";
+    }
+    std::string overrides = FormatSettings(compileSettings);
+    SetRegKeyOverrides(overrides.c_str());
+
+    STB_TranslateInputArgs inputArgs;
+    inputArgs.pInput = const_cast<char*>(input.data.data());
+    inputArgs.InputSize = (uint32_t)input.data.size();
+    inputArgs.pOptions = input.options.c_str();
+    inputArgs.OptionsSize = (uint32_t)input.options.size();
+    inputArgs.pInternalOptions = input.internalOptions.c_str();
+    inputArgs.InternalOptionsSize = (uint32_t)input.internalOptions.size();
+    // Keeps the binary cache from returning another variant.
+    inputArgs.CompileTimeStatisticsEnable = true;
+
+    STB_TranslateOutputArgs outputArgs;
+    bool success = pTranslationBlock->Translate(&inputArgs, &outputArgs);
+    if (success)
+    {
+        if (!opts.measureCmd.empty())
+        {
+            success = MeasureBinary(opts, input, outputArgs, score);
+        }
+        else
+        {
+            std::vector<STB_KernelMetrics> metrics(GetLastKernelMetrics(nullptr, 0));
+            GetLastKernelMetrics(metrics.data(), (uint32_t)metrics.size());
+            score = 0;
+            for (const STB_KernelMetrics& kernelMetrics : metrics)
+            {
+                score += kernelMetrics.EstimatedCycles;
+            }
+            // Kernels reused from the kernel binary cache have no metrics.
+            success = score > 0;
+        }
+    }
+    pTranslationBlock->FreeAllocations(&outputArgs);
+    return success;
+}
+
+// Tunes every input of the corpus and updates the tuning database; returns
+// the number of inputs that could not be compiled.
+unsigned RunTuning(
+    const BenchOptions& opts,
+    const BenchPlatform& platform,
+    const std::vector<BenchInput>& corpus,
+    const std::vector<TuningKnob>& knobs)
+{
+    // Entries of other shaders are kept.
+    std::map<std::string, std::string> database;
+    {
+        std::ifstream is(opts.tuningDbFile.c_str());
+        std::string line;
+        while (std::getline(is, line))
+        {
+            std::stringstream fields(line);
+            std::string hash, settings;
+            if ((fields >> hash >> settings) && hash[0] != '#')
+            {
+                database[hash] = settings;
+            }
+        }
+    }
+
+    printf("%-32s %-18s %12s %12s %8s  %s\n",
+        "input", "hash", "default", "tuned", "variants", "settings");
+
+    unsigned numFailures = 0;
+    for (const BenchInput& input : corpus)
+    {
+        CTranslationBlock* pTranslationBlock = CreateTranslationBlock(platform, input.format);
+        double defaultScore = 0;
+        if (!pTranslationBlock ||
+            !EvaluateSettings(opts, pTranslationBlock, input, TuningSettings(), defaultScore))
+        {
+            printf("%-32s FAILED\n", input.name.c_str());
+            numFailures++;
+            if (pTranslationBlock)
+            {
+                Delete(pTranslationBlock);
+            }
+            continue;
+        }
+        char hash[32];
+        snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)GetLastShaderHash());
+
+        TuningSettings best;
+        double bestScore = defaultScore;
+        unsigned numVariants = 1;
+        bool improved = true;
+        while (improved)
+        {
+            improved = false;
+            for (const TuningKnob& knob : knobs)
+            {
+                for (const std::string& value : knob.values)
+                {
+                    auto it = best.find(knob.name);
+                    if (it != best.end() && it->second == value)
+                    {
+                        continue;
+                    }
+                    TuningSettings trial = best;
+                    trial[knob.name] = value;
+                    double score = 0;
+                    numVariants++;
+                    if (EvaluateSettings(opts, pTranslationBlock, input, trial, score) &&
+                        score < bestScore)
+                    {
+                        best = trial;
+                        bestScore = score;
+                        improved = true;
+                    }
+                }
+            }
+        }
+        Delete(pTranslationBlock);
+
+        std::string settings = FormatSettings(best);
+        printf("%-32s 0x%s %12.0f %12.0f %8u  %s\n", input.name.c_str(), hash,
+            defaultScore, bestScore, numVariants, settings.empty() ? "(default)" : settings.c_str());
+        if (settings.empty())
+        {
+            database.erase(hash);
+        }
+        else
+        {
+            database[hash] = settings;
+        }
+    }
+    SetRegKeyOverrides(nullptr);
+
+    FILE* fp = fopen(opts.tuningDbFile.c_str(), "w");
+    if (!fp)
+    {
+        fprintf(stderr, "igc_bench: cannot open %s\n", opts.tuningDbFile.c_str());
+        return numFailures + 1;
+    }
+    fprintf(fp, "# ShaderHash regkey settings, written by igc_bench -tune for %s\n", platform.name);
+    for (const auto& entry : database)
+    {
+        fprintf(fp, "%s %s\n", entry.first.c_str(), entry.second.c_str());
+    }
+    fclose(fp);
+    return numFailures;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    BenchOptions opts;
+    if (!ParseArgs(argc, argv, opts))
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<const BenchPlatform*> platforms;
+    for (const std::string& name : opts.platforms)
+    {
+        const BenchPlatform* pPlatform = FindPlatform(name);
+        if (!pPlatform)
+        {
+            fprintf(stderr, "igc_bench: unknown platform %s\n", name.c_str());
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        platforms.push_back(pPlatform);
+    }
+
+    std::vector<BenchInput> corpus = LoadCorpus(opts);
+    if (corpus.empty())
+    {
+        fprintf(stderr, "igc_bench: no .spv or .bc inputs in %s\n", opts.inputDir.c_str());
+        return 1;
+    }
+
+    if (!opts.tuneFile.empty())
+    {
+        std::vector<TuningKnob> knobs;
+        if (!ReadTuningKnobs(opts.tuneFile, knobs) || knobs.empty())
+        {
+            fprintf(stderr, "igc_bench: no knobs in %s\n", opts.tuneFile.c_str());
+            return 1;
+        }
+        if (!SetRegKeyOverrides(nullptr))
+        {
+            fprintf(stderr, "igc_bench: -tune needs a compiler built with regkeys\n");
+            return 1;
+        }
+        if (platforms.size() > 1)
+        {
+            fprintf(stderr, "igc_bench: tuning for %s only\n", platforms[0]->name);
+        }
+        return RunTuning(opts, *platforms[0], corpus, knobs) ? 1 : 0;
+    }
+
+    uint32_t numIntervals = GetLastCompileTimes(nullptr, nullptr, 0);
+    std::vector<const char*> names(numIntervals);
+    GetLastCompileTimes(names.data(), nullptr, numIntervals);
+
+    FILE* csv = nullptr;
+    if (!opts.csvFile.empty())
+    {
+        csv = fopen(opts.csvFile.c_str(), "w");
+        if (!csv)
+        {
+            fprintf(stderr, "igc_bench: cannot open %s\n", opts.csvFile.c_str());
+            return 1;
+        }
+        fprintf(csv, "input,platform,phase,median_ms\n");
+    }
+
+    Baseline baseline;
+    if (!opts.baselineFile.empty() && !ReadBaseline(opts.baselineFile, baseline))
+    {
+        fprintf(stderr, "igc_bench: cannot read %s\n", opts.baselineFile.c_str());
+        return 1;
+    }
+
+    FILE* baselineOut = nullptr;
+    if (!opts.writeBaselineFile.empty())
+    {
+        baselineOut = fopen(opts.writeBaselineFile.c_str(), "w");
+        if (!baselineOut)
+        {
+            fprintf(stderr, "igc_bench: cannot open %s\n", opts.writeBaselineFile.c_str());
+            return 1;
+        }
+        fprintf(baselineOut, "%s\n", g_cBaselineHeader);
+    }
+
+    printf("%-32s %-6s %10s %10s %10s %12s %10s %18s\n",
+        "input", "plat", "total ms", "wall ms", "peak KB", "allocs", "bytes", "checksum");
+
+    unsigned numFailures = 0;
+    unsigned numRegressions = 0;
+    for (const BenchPlatform* pPlatform : platforms)
+    {
+        std::vector<uint64_t> corpusNS(numIntervals, 0);
+        uint64_t corpusWallNS = 0;
+
+        for (const BenchInput& input : corpus)
+        {
+            BenchResult result = RunInput(opts, *pPlatform, input);
+            if (!result.success)
+            {
+                printf("%-32s %-6s FAILED\n", result.input.c_str(), result.platform.c_str());
+                numFailures++;
+                continue;
+            }
+
+            std::vector<uint64_t> mediansNS(numIntervals);
+            for (uint32_t i = 0; i < numIntervals; i++)
+            {
+                mediansNS[i] = Median(result.phaseNS[i]);
+                corpusNS[i] += mediansNS[i];
+            }
+            uint64_t wallNS = Median(result.wallNS);
+            corpusWallNS += wallNS;
+
+            // The first interval is TIME_TOTAL.
+            printf("%-32s %-6s %10.3f %10.3f %10llu %12llu %10u 0x%016llx%s\n",
+                result.input.c_str(), result.platform.c_str(),
+                ToMS(mediansNS[0]), ToMS(wallNS),
+                (unsigned long long)result.peakKB,
+                (unsigned long long)result.allocations,
+                result.binarySize,
+                (unsigned long long)result.checksum,
+                result.deterministic ? "" : " (nondeterministic)");
+
+            if (opts.printPhases)
+            {
+                PrintPhases(names, mediansNS, "    ");
+            }
+
+            if (!baseline.empty())
+            {
+                numRegressions += CompareBaseline(opts, baseline, result);
+            }
+
+            if (baselineOut)
+            {
+                WriteBaseline(baselineOut, result);
+            }
+
+            if (csv)
+            {
+                for (uint32_t i = 0; i < numIntervals; i++)
+                {
+                    if (mediansNS[i] != 0)
+                    {
+                        fprintf(csv, "%s,%s,%s,%.3f\n", result.input.c_str(),
+                            result.platform.c_str(), names[i], ToMS(mediansNS[i]));
+                    }
+                }
+            }
+        }
+
+        printf("\n%s: sum of per-input medians over %u inputs, %u iterations each (wall %.3f ms)\n",
+            pPlatform->name, (unsigned)corpus.size(), opts.iterations, ToMS(corpusWallNS));
+        PrintPhases(names, corpusNS, "  ");
+        printf("\n");
+    }
+
+    if (csv)
+    {
+        fclose(csv);
+    }
+
+    if (baselineOut)
+    {
+        fclose(baselineOut);
+    }
+
+    if (!baseline.empty())
+    {
+        printf("%u code quality regressions against %s (tolerance %.1f%%)\n",
+            numRegressions, opts.baselineFile.c_str(), opts.tolerancePct);
+    }
+
+    return (numFailures || numRegressions) ? 1 : 0;
+}
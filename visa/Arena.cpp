@@ -65,15 +65,149 @@ ArenaHeader::AllocSpace (size_t size)
 void
 ArenaManager::FreeArenas()
 {
+	ArenaPool* pool = ArenaPool::get();
 	while (_arenas)
 	{
 #ifdef COLLECT_ALLOCATION_STATS
         currentMallocSize -= _arenas->size;
 #endif
 		unsigned char* killed = (unsigned char*) _arenas;
+		size_t killedSize = _arenas->size;
 		_arenas = _arenas->_nextArena;
-		delete [] killed;
+		if (pool)
+		{
+			pool->Release(killed, killedSize);
+		}
+		else
+		{
+			delete [] killed;
+		}
 	}
 
 	_arenas = 0;
+	ArenaUsage::Sub(_reservedBytes);
+	_reservedBytes = 0;
+}
+
+namespace
+{
+    // The pool is destroyed with its thread, possibly before Mem_Managers
+    // with static storage are; after that chunks go straight back to the heap.
+    thread_local bool arenaPoolDestroyed = false;
+}
+
+namespace
+{
+    thread_local size_t arenaUsageBytes = 0;
+    thread_local size_t arenaUsagePeak = 0;
+}
+
+void
+ArenaUsage::Add(size_t bytes)
+{
+	arenaUsageBytes += bytes;
+	if (arenaUsageBytes > arenaUsagePeak)
+	{
+		arenaUsagePeak = arenaUsageBytes;
+	}
+}
+
+void
+ArenaUsage::Sub(size_t bytes)
+{
+	arenaUsageBytes = bytes > arenaUsageBytes ? 0 : arenaUsageBytes - bytes;
+}
+
+size_t
+ArenaUsage::Current()
+{
+	return arenaUsageBytes;
+}
+
+size_t
+ArenaUsage::TakePeak()
+{
+	size_t peak = arenaUsagePeak;
+	arenaUsagePeak = arenaUsageBytes;
+	return peak;
+}
+
+ArenaPool*
+ArenaPool::get()
+{
+	if (arenaPoolDestroyed)
+	{
+		return nullptr;
+	}
+	static thread_local ArenaPool pool;
+	return &pool;
+}
+
+size_t
+ArenaPool::RoundToSizeClass(size_t dataSize)
+{
+	// Rounding large chunks to a power of two could waste almost half of them.
+	if (dataSize > MAX_SIZE_CLASS)
+	{
+		return ArenaHeader::WordAlign(dataSize);
+	}
+	size_t sizeClass = 256;
+	while (sizeClass < dataSize)
+	{
+		sizeClass <<= 1;
+	}
+	return sizeClass;
+}
+
+static unsigned
+SizeClassIndex(size_t sizeClass)
+{
+	unsigned index = 0;
+	while (((size_t)1 << index) < sizeClass)
+	{
+		index++;
+	}
+	return index;
+}
+
+unsigned char*
+ArenaPool::Acquire(size_t dataSize)
+{
+	if (dataSize > MAX_SIZE_CLASS)
+	{
+		return new unsigned char[ArenaHeader::GetArenaSize(dataSize)];
+	}
+	std::vector<unsigned char*>& chunks = _freeChunks[SizeClassIndex(dataSize)];
+	if (!chunks.empty())
+	{
+		unsigned char* chunk = chunks.back();
+		chunks.pop_back();
+		_pooledBytes -= dataSize;
+		return chunk;
+	}
+	return new unsigned char[ArenaHeader::GetArenaSize(dataSize)];
+}
+
+void
+ArenaPool::Release(unsigned char* chunk, size_t dataSize)
+{
+	if (dataSize > MAX_SIZE_CLASS || _pooledBytes + dataSize > MAX_POOLED_BYTES)
+	{
+		delete [] chunk;
+		return;
+	}
+	_freeChunks[SizeClassIndex(dataSize)].push_back(chunk);
+	_pooledBytes += dataSize;
+}
+
+ArenaPool::~ArenaPool()
+{
+	for (auto& chunks : _freeChunks)
+	{
+		for (auto chunk : chunks)
+		{
+			delete [] chunk;
+		}
+	}
+	arenaPoolDestroyed = true;
 }
@@ -34,6 +34,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <assert.h>
 #include <stdlib.h>
 #include <iostream>
+#include <vector>
 
 #include "Option.h"
 
@@ -52,6 +53,52 @@ extern int currentMallocSize;
 namespace vISA
 {
     class Mem_Manager;
+
+    // A per-thread cache of arena chunks. ArenaManagers return their chunks
+    // here instead of freeing them, so a process compiling many kernels keeps
+    // reusing the same memory rather than going through malloc/free for every
+    // kernel and RA iteration. Chunk data sizes up to MAX_SIZE_CLASS are
+    // rounded up to powers of two so that chunks can be shared by managers
+    // with different default sizes; larger chunks are only word aligned and
+    // bypass the pool.
+    class ArenaPool
+    {
+    public:
+        // Returns nullptr once the calling thread's pool has been destroyed.
+        static ArenaPool* get();
+
+        static size_t RoundToSizeClass(size_t dataSize);
+
+        // Chunks are handed out and taken back by data size, which must be
+        // the result of RoundToSizeClass.
+        unsigned char* Acquire(size_t dataSize);
+        void Release(unsigned char* chunk, size_t dataSize);
+
+        ~ArenaPool();
+
+    private:
+        static const size_t MAX_SIZE_CLASS = 64 * 1024;
+        static const unsigned NUM_SIZE_CLASSES = 17; // up to 1 << 16
+        // Chunks beyond this are freed rather than kept for reuse.
+        static const size_t MAX_POOLED_BYTES = 8 * 1024 * 1024;
+
+        std::vector<unsigned char*> _freeChunks[NUM_SIZE_CLASSES];
+        size_t _pooledBytes = 0;
+    };
+
+    // Per-thread totals of the memory held in arenas, used to report the
+    // finalizer's peak footprint for each compilation phase.
+    class ArenaUsage
+    {
+    public:
+        static void Add(size_t bytes);
+        static void Sub(size_t bytes);
+        static size_t Current();
+        // Return the peak since the previous call and restart peak
+        // tracking from the current usage.
+        static size_t TakePeak();
+    };
+
     class ArenaHeader
     {
         friend class ArenaManager;
@@ -126,6 +173,35 @@ namespace vISA
             CreateArena(_defaultArenaSize);
         }
 
+        // Hand all arenas back to the pool and start over with a single
+        // default sized arena. Peak statistics are kept.
+        void Reset()
+        {
+            FreeArenas();
+            _allocatedBytes = 0;
+            CreateArena(_defaultArenaSize);
+        }
+
+        // Size new arenas for roughly expectedBytes of allocations. If
+        // nothing has been allocated yet the current arena is replaced too.
+        void SetSizeHint(size_t expectedBytes)
+        {
+            const size_t maxHintedArenaSize = 1024 * 1024;
+            size_t hinted = ArenaPool::RoundToSizeClass(expectedBytes);
+            hinted = hinted > maxHintedArenaSize ? maxHintedArenaSize : hinted;
+            if (hinted <= _defaultArenaSize)
+            {
+                return;
+            }
+
+            _defaultArenaSize = hinted;
+            if (_allocatedBytes == 0 && _arenas != NULL && _arenas->_nextArena == NULL)
+            {
+                FreeArenas();
+                CreateArena(_defaultArenaSize);
+            }
+        }
+
         ~ArenaManager()
         {
             FreeArenas();
@@ -151,6 +227,12 @@ namespace vISA
                 }
 
                 assert(space);
+
+                _allocatedBytes += ArenaHeader::WordAlign(size);
+                if (_allocatedBytes > _peakAllocatedBytes)
+                {
+                    _peakAllocatedBytes = _allocatedBytes;
+                }
             }
 
 #ifdef COLLECT_ALLOCATION_STATS
@@ -164,10 +246,18 @@ namespace vISA
         ArenaHeader* CreateArena(size_t size)
         {
             size_t arenaDataSize = (size > _defaultArenaSize) ? size : _defaultArenaSize;
-            arenaDataSize = ArenaHeader::WordAlign(arenaDataSize);
-            unsigned char * arena =
+            arenaDataSize = ArenaPool::RoundToSizeClass(arenaDataSize);
+            ArenaPool* pool = ArenaPool::get();
+            unsigned char * arena = pool ? pool->Acquire(arenaDataSize) :
                 new unsigned char[ArenaHeader::GetArenaSize(arenaDataSize)];
 
+            _reservedBytes += arenaDataSize;
+            ArenaUsage::Add(arenaDataSize);
+            if (_reservedBytes > _peakReservedBytes)
+            {
+                _peakReservedBytes = _reservedBytes;
+            }
+
             ArenaHeader* newArena = new (arena)ArenaHeader(arenaDataSize, _arenas);
             // Add new arena to the head of queue
             if (_arenas != NULL)
@@ -205,7 +295,14 @@ namespace vISA
         // Data
 
         ArenaHeader * _arenas;
-        const size_t  _defaultArenaSize;
+        size_t        _defaultArenaSize;
+
+        // Statistics: bytes handed out by AllocDataSpace and bytes held in
+        // arenas, currently and at their high-water marks.
+        size_t        _allocatedBytes = 0;
+        size_t        _peakAllocatedBytes = 0;
+        size_t        _reservedBytes = 0;
+        size_t        _peakReservedBytes = 0;
     };
 }
 #endif
@@ -168,6 +168,10 @@ int CBinaryCISAEmitter::Emit(VISAKernelImpl * cisa_kernel, unsigned int& binaryS
         }
     }
 
+    MUST_BE_TRUE(status != CM_SUCCESS || cisa_kernel->getBytesWritten() == cisa_kernel->getCisaBinarySize(),
+        "vISA binary size does not match the size computed by finalizeKernel");
+    binarySize = (unsigned int)cisa_kernel->getBytesWritten();
+
     return status;
 }
 
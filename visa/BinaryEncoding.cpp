@@ -2951,6 +2951,7 @@ inline BinaryEncoding::Status BinaryEncoding::ProduceBinaryInstructions()
         } // for inst
     } // for bb
     kernel.setAsmCount(globalInstNum);
+    kernel.setCompactedCount(numCompactedInst);
     SetInstCounts((uint32_t)globalHalfInstNum);
 
     EncodingHelper::dumpOptReport(globalInstNum, numCompactedInst, numCompacted3SrcInst, kernel);
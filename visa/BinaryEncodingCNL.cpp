@@ -2573,6 +2573,7 @@ void BinaryEncodingCNL::DoAll()
     } // for bb
 
 	kernel.setAsmCount(globalInstNum);
+	kernel.setCompactedCount(numCompactedInst);
 	SetInstCounts((uint32_t)globalHalfInstNum);
 
     EncodingHelper::dumpOptReport(globalInstNum, numCompactedInst, numCompacted3SrcInst, kernel);
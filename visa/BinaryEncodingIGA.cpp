@@ -25,6 +25,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 ======================= end_copyright_notice ==================================*/
 
 #include "BinaryEncodingIGA.h"
+#include "Common_BinaryEncoding.h"
 #include "GTGPU_RT_ASM_Interface.h"
 #include "iga/IGALibrary/api/igaEncoderWrapper.hpp"
 #include "Timer.h"
@@ -66,8 +67,21 @@ Platform BinaryEncodingIGA::getIGAInternalPlatform(TARGET_PLATFORM genxPlatform)
 BinaryEncodingIGA::BinaryEncodingIGA(vISA::Mem_Manager &m, vISA::G4_Kernel& k, std::string fname) :
 mem(m), kernel(k), fileName(fname), m_kernelBuffer(nullptr), m_kernelBufferSize(0)
 {
+    // the IGA models are immutable static tables, so every encoder (on any
+    // thread) shares the platform's model; only the kernel IR is per encoder
     platformModel = iga::Model::LookupModel(getIGAInternalPlatform(getGenxPlatform()));
-    IGAKernel = new iga::Kernel(*platformModel);
+
+    // size the IGA arena for the whole kernel up front instead of growing
+    // it 4KB at a time
+    numG4Insts = 0;
+    for (auto bb : kernel.fg.BBs)
+    {
+        numG4Insts += bb->size();
+    }
+    const size_t maxChunkSize = 1024 * 1024;
+    size_t chunkSize = std::min(maxChunkSize,
+        std::max<size_t>(4096, numG4Insts * sizeof(iga::Instruction)));
+    IGAKernel = new iga::Kernel(*platformModel, chunkSize);
 }
 
 void BinaryEncodingIGA::FixInst()
@@ -436,7 +450,8 @@ void BinaryEncodingIGA::DoAll()
         IGAKernel->appendBlock(currBB);
     }
 
-    std::list<std::pair<Instruction*, G4_INST*>> encodedInsts;
+    std::vector<std::pair<Instruction*, G4_INST*>> encodedInsts;
+    encodedInsts.reserve(numG4Insts);
     iga::Block *bbNew = nullptr;
     for (auto bb : this->kernel.fg.BBs)
     {
@@ -769,10 +784,29 @@ void BinaryEncodingIGA::DoAll()
     memcpy_s(m_kernelBuffer, m_kernelBufferSize, encoder.getBinary(), m_kernelBufferSize);
 
     // encodedPC is available after encoding
+    int numCompactedInst = 0;
+    int numCompacted3SrcInst = 0;
     for (auto&& inst : encodedInsts)
     {
         inst.second->setGenOffset(inst.first->getPC());
+        if (inst.first->hasInstOpt(InstOpt::COMPACTED))
+        {
+            numCompactedInst++;
+            if (inst.second->getNumSrc() == 3)
+            {
+                numCompacted3SrcInst++;
+            }
+        }
     }
+    kernel.setCompactedCount(numCompactedInst);
+    EncodingHelper::dumpOptReport((int)kernel.getAsmCount(), numCompactedInst, numCompacted3SrcInst, kernel);
+
+    // The binary and the gen offsets are all that is needed from here on;
+    // drop the IGA IR now rather than keeping a second copy of the kernel
+    // alive through FC patching and debug info emission.
+    labelToBlockMap.clear();
+    delete IGAKernel;
+    IGAKernel = nullptr;
 }
 
 SendDescArg BinaryEncodingIGA::getIGASendDescArg(G4_INST* sendInst) const
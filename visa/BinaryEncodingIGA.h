@@ -47,6 +47,7 @@ class BinaryEncodingIGA
     std::string fileName;
     iga::Kernel*    IGAKernel;
     const iga::Model* platformModel;
+    size_t          numG4Insts;
 
 public:
     BinaryEncodingIGA(vISA::Mem_Manager &m, vISA::G4_Kernel& k, std::string fname);
@@ -363,6 +364,11 @@ private:
         {
             options.add(iga::InstOpt::SWITCH);
         }
+        if (inst->isCall() && kernel.getOption(vISA_LinkStackFuncs))
+        {
+            // the JIP of a call may be patched at link time
+            options.add(iga::InstOpt::NOCOMPACT);
+        }
         if (inst->isSend())
         {
             if (inst->isEOT())
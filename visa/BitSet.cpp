@@ -156,6 +156,32 @@ void vector_minus(T *__restrict__ p1, const T *const p2, unsigned n)
     }
 }
 
+template <typename T>
+bool vector_or_changed(T *__restrict__ p1, const T *const p2, unsigned n)
+{
+    T diff = 0;
+    for (unsigned i = 0; i < n; ++i)
+    {
+        T value = p1[i] | p2[i];
+        diff |= value ^ p1[i];
+        p1[i] = value;
+    }
+    return diff != 0;
+}
+
+template <typename T>
+bool vector_transfer_changed(T *__restrict__ p, const T *const gen, const T *const out, const T *const kill, unsigned n)
+{
+    T diff = 0;
+    for (unsigned i = 0; i < n; ++i)
+    {
+        T value = gen[i] | (out[i] & ~kill[i]);
+        diff |= value ^ p[i];
+        p[i] = value;
+    }
+    return diff != 0;
+}
+
 BitSet& BitSet::operator|=( const BitSet& other )
 {
     unsigned size = other.m_Size;
@@ -198,3 +224,38 @@ BitSet& BitSet::operator&= ( const BitSet &other )
 
     return *this;
 }
+
+bool BitSet::unionWith( const BitSet& other )
+{
+    //grow the set to the size of the other set if necessary
+    if( m_Size < other.m_Size )
+    {
+        create( other.m_Size );
+    }
+
+    unsigned arraySize = ( other.m_Size + NUM_BITS_PER_ELT - 1 ) / NUM_BITS_PER_ELT;
+    return vector_or_changed(m_BitSetArray, other.m_BitSetArray, arraySize);
+}
+
+bool BitSet::setToGenUnionOutMinusKill( const BitSet& gen, const BitSet& out, const BitSet& kill )
+{
+    if( gen.m_Size != out.m_Size || kill.m_Size != out.m_Size )
+    {
+        BitSet old( *this );
+        *this = out;
+        *this -= kill;
+        *this |= gen;
+        return old != *this;
+    }
+
+    bool changed = false;
+    if( m_Size != out.m_Size )
+    {
+        create( out.m_Size );
+        changed = true;
+    }
+
+    unsigned arraySize = ( m_Size + NUM_BITS_PER_ELT - 1 ) / NUM_BITS_PER_ELT;
+    changed |= vector_transfer_changed(m_BitSetArray, gen.m_BitSetArray, out.m_BitSetArray, kill.m_BitSetArray, arraySize);
+    return changed;
+}
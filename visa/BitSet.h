@@ -30,11 +30,38 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Mem_Manager.h"
 #include <cstdlib>
 #include <cstring>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 // Array-based bitset implementation where each element occupies a single bit.
 // Inside each array element, bits are stored and indexed from lsb to msb.
 typedef unsigned int BITSET_ARRAY_TYPE;
 
+// Index of the lowest set bit of a non-zero element.
+inline unsigned lowestSetBit(BITSET_ARRAY_TYPE elt)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, elt);
+    return (unsigned)index;
+#else
+    return (unsigned)__builtin_ctz(elt);
+#endif
+}
+
+// Invoke f on the bit index of every set bit of elt, from lsb to msb;
+// base is added to each index.
+template <typename F>
+inline void forEachSetBit(BITSET_ARRAY_TYPE elt, unsigned base, F f)
+{
+    while (elt != 0)
+    {
+        f(base + lowestSetBit(elt));
+        elt &= elt - 1;
+    }
+}
+
 class BitSet
 {
 #define BITS_PER_BYTE  8
@@ -346,6 +373,26 @@ public:
     BitSet &operator&=(const BitSet &other);
     BitSet &operator-=(const BitSet &other);
 
+    // Same as |=, but returns whether any bit was added. This saves the copy
+    // and compare that dataflow iterations otherwise need to detect a change.
+    bool unionWith(const BitSet &other);
+
+    // *this = gen | (out - kill), the liveness transfer function, in a single
+    // pass when all three sets have the same size. Returns whether *this
+    // changed.
+    bool setToGenUnionOutMinusKill(const BitSet &gen, const BitSet &out, const BitSet &kill);
+
+    // Invoke f on the index of every set bit, in increasing order.
+    template <typename F>
+    void forEach(F f) const
+    {
+        unsigned arraySize = (m_Size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT;
+        for (unsigned i = 0; i < arraySize; i++)
+        {
+            forEachSetBit(m_BitSetArray[i], i * NUM_BITS_PER_ELT, f);
+        }
+    }
+
     void *operator new(size_t sz, vISA::
         Mem_Manager &m) { return m.alloc(sz); }
 
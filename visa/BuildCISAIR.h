@@ -776,6 +776,7 @@ public:
     void InitVisaWaTable(TARGET_PLATFORM platform, Stepping step);
 
     void setTestName(std::string name) { testName = name; }
+    void setBenchmarkIteration(unsigned iter) { benchmarkIteration = iter; }
 
     Options m_options;
 
@@ -819,6 +820,9 @@ private:
     void emitFCPatchFile();
 
     std::string testName;
+    unsigned benchmarkIteration = 0;
+
+    void dumpBenchmarkResults(std::map<VISAKernelImpl*, std::vector<double>>& kernelTimesUS);
 
     PVISA_WA_TABLE m_pWaTable;
 
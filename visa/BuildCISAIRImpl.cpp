@@ -29,6 +29,10 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <sstream>
 #include <fstream>
 #include <list>
+#include <functional>
+#include <vector>
+#include <atomic>
+#include <thread>
 
 #include "visa_igc_common_header.h"
 #include "Common_ISA.h"
@@ -49,10 +53,13 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "FlowGraph.h"
 #include "BuildIR.h"
 #include "DebugInfo.h"
+#include "BinaryEncodingIGA.h"
+#include "iga/IGALibrary/api/igaEncoderWrapper.hpp"
 
 using namespace std;
 using namespace vISA;
 extern "C" int64_t getTimerTicks(unsigned int idx);
+extern "C" void freeBlock(void* ptr);
 
 #define IS_GEN_PATH  (mBuildOption == CM_CISA_BUILDER_GEN)
 #define IS_BOTH_PATH  (mBuildOption == CM_CISA_BUILDER_BOTH)
@@ -707,6 +714,286 @@ void Stitch_Compiled_Units( common_isa_header header, std::list<G4_Kernel*>& com
     }
 }
 
+// With -linkStackFuncs every stack call function is encoded once as its own
+// unit instead of being stitched into and re-encoded with each calling kernel.
+// A direct call targets the entry label of its callee, which is not part of the
+// unit being encoded, so the encoder leaves its JIP unresolved; Link_Compiled_Units
+// places the callee binaries after the kernel and patches the JIPs.
+typedef struct linkCall
+{
+    G4_INST* callInst;
+    G4_Operand* opnd0;
+    G4_Operand* opnd1;
+    int calleeId;
+} linkCall;
+
+typedef struct linkState
+{
+    std::vector<linkCall> calls;
+    std::vector<G4_INST*> rets;
+} linkState;
+
+static bool Can_Link_Compiled_Units(Options& options, std::list<VISAKernelImpl*>& units)
+{
+    if (!options.getOption(vISA_LinkStackFuncs) ||
+        !options.getOption(vISA_IGAEncoder) ||
+        options.getOption(vISA_GenerateDebugInfo) ||
+        options.getOption(vISA_AddKernelID))
+    {
+        return false;
+    }
+
+    for (auto unit : units)
+    {
+        // indirect calls and function addresses are resolved against the stitched binary
+        if (unit->getKernel()->hasIndirectCall() || unit->getKernel()->hasRelocations() ||
+            unit->isFCCallableKernel() || unit->isFCCallerKernel())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Turn fcall/fret into call/ret for separate encoding of the compilation unit.
+static void Convert_FCalls_For_Link(common_isa_header header, G4_Kernel* unit,
+    std::list<G4_Kernel*>& compilation_units, linkState& state)
+{
+    for (G4_BB* cur : unit->fg.BBs)
+    {
+        if (cur->size() == 0)
+        {
+            continue;
+        }
+
+        G4_INST* last = cur->back();
+        if (cur->isEndWithFCall())
+        {
+            int calleeIndex = last->asCFInst()->getCalleeIndex();
+            G4_Kernel* callee = Get_Resolved_Compilation_Unit(header, compilation_units, calleeIndex);
+            G4_INST* calleeLabel = callee->fg.getEntryBB()->front();
+            ASSERT_USER(calleeLabel->isLabel() == true, "Entry inst is not label");
+
+            linkCall call;
+            call.callInst = last;
+            call.opnd0 = last->getSrc(0);
+            call.opnd1 = last->getSrc(1);
+            call.calleeId = calleeIndex;
+            state.calls.push_back(call);
+
+            last->setSrc(last->getSrc(0), 1);
+            last->setSrc(calleeLabel->getSrc(0), 0);
+            last->setOpcode(G4_call);
+        }
+        else if (cur->isEndWithFRet())
+        {
+            state.rets.push_back(last);
+            last->setOpcode(G4_return);
+            last->setDest(unit->fg.builder->createNullDst(Type_UD));
+        }
+    }
+}
+
+static void Restore_FCalls_After_Link(linkState& state)
+{
+    for (auto&& call : state.calls)
+    {
+        call.callInst->setSrc(call.opnd0, 0);
+        call.callInst->setSrc(call.opnd1, 1);
+        call.callInst->setOpcode(G4_pseudo_fcall);
+    }
+    for (auto ret : state.rets)
+    {
+        ret->setOpcode(G4_pseudo_fret);
+        ret->setDest(NULL);
+    }
+    state.calls.clear();
+    state.rets.clear();
+}
+
+// Encode compilation units that are linked rather than stitched on up to
+// numThreads threads. After RA every such unit owns its IR, memory pools and
+// binary, and inter-unit JIPs are left for Link_Compiled_Units, so the units
+// only share read-only state. The first unit is encoded on the calling thread
+// so that lazily built encoder tables exist before the workers start.
+static void Encode_Compiled_Units(CISA_IR_Builder* builder,
+    std::vector<VISAKernelImpl*>& units, unsigned numThreads)
+{
+    auto encode = [](VISAKernelImpl* unit)
+    {
+        unsigned int genxBufferSize = 0;
+        void* genxBuffer = unit->compilePostOptimize(genxBufferSize);
+        unit->setGenxBinaryBuffer(genxBuffer, genxBufferSize);
+    };
+
+    if (units.empty())
+    {
+        return;
+    }
+    encode(units[0]);
+
+    numThreads = (unsigned)std::min<size_t>(numThreads, units.size() - 1);
+    std::atomic<size_t> next(1);
+    auto worker = [&]()
+    {
+        // asm emission reads options through the thread's builder
+        pCisaBuilder = builder;
+        for (size_t i = next++; i < units.size(); i = next++)
+        {
+            encode(units[i]);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < numThreads; t++)
+    {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+}
+
+// Lay out the encoded kernel followed by the binaries of all functions it
+// (transitively) calls and patch every call in the copy to its callee's entry.
+// On success the kernel's binary buffer is replaced by the linked one.
+static int Link_Compiled_Units(common_isa_header header, VISAKernelImpl* kernel,
+    std::list<G4_Kernel*>& compilation_units, std::vector<VISAKernelImpl*>& funcById,
+    std::map<G4_Kernel*, linkState>& linkStates)
+{
+    G4_Kernel* k = kernel->getKernel();
+    std::list<int> callee_index;
+    Enumerate_Callees(header, k, compilation_units, callee_index);
+    callee_index.sort();
+    callee_index.unique();
+
+    // unit -> offset of its binary in the linked kernel
+    std::vector<std::pair<VISAKernelImpl*, uint32_t>> layout;
+    std::map<int, uint32_t> entryOffset;
+    uint32_t linkedSize = kernel->getGenxBinarySize();
+    layout.push_back(std::make_pair(kernel, 0));
+    for (auto calleeId : callee_index)
+    {
+        VISAKernelImpl* func = funcById[calleeId];
+        G4_Kernel* callee = func->getKernel();
+        propagateCalleeInfo(k, callee);
+        k->addCallee(calleeId, callee);
+        k->fg.builder->getJitInfo()->numAsmCount += callee->fg.builder->getJitInfo()->numAsmCount;
+        k->fg.builder->getJitInfo()->numCompactedInst += callee->fg.builder->getJitInfo()->numCompactedInst;
+        k->fg.builder->getJitInfo()->numSamplerSends += callee->fg.builder->getJitInfo()->numSamplerSends;
+        k->fg.builder->getJitInfo()->numDataPortSends += callee->fg.builder->getJitInfo()->numDataPortSends;
+        k->fg.builder->getJitInfo()->numOtherSends += callee->fg.builder->getJitInfo()->numOtherSends;
+        k->fg.builder->getJitInfo()->numEstimatedCycles = (unsigned int)std::min<uint64_t>(UINT_MAX,
+            (uint64_t)k->fg.builder->getJitInfo()->numEstimatedCycles + callee->fg.builder->getJitInfo()->numEstimatedCycles);
+
+        G4_INST* firstInst = callee->getFirstNonLabelInst();
+        entryOffset[calleeId] = linkedSize + (firstInst ? (uint32_t)firstInst->getGenOffset() : 0);
+        layout.push_back(std::make_pair(func, linkedSize));
+        linkedSize += func->getGenxBinarySize();
+    }
+
+    char* linked = (char*)allocCodeBlock(linkedSize);
+    for (auto&& unit : layout)
+    {
+        memcpy_s(linked + unit.second, linkedSize - unit.second,
+            unit.first->getGenxBinaryBuffer(), unit.first->getGenxBinarySize());
+    }
+
+    const iga::Model* model = iga::Model::LookupModel(BinaryEncodingIGA::getIGAInternalPlatform(getGenxPlatform()));
+    for (auto&& unit : layout)
+    {
+        for (auto&& call : linkStates[unit.first->getKernel()].calls)
+        {
+            uint32_t callOffset = unit.second + (uint32_t)call.callInst->getGenOffset();
+            int32_t jip = (int32_t)entryOffset[call.calleeId] - (int32_t)callOffset;
+            if (!KernelEncoder::patchJipValue(*model, (unsigned char*)linked + callOffset, jip))
+            {
+                freeBlock(linked);
+                return CM_FAILURE;
+            }
+        }
+    }
+
+    freeBlock(kernel->getGenxBinaryBuffer());
+    kernel->setGenxBinaryBuffer(linked, linkedSize);
+    return CM_SUCCESS;
+}
+
+static void snapshotTimersUS(std::vector<double>& timesUS)
+{
+    timesUS.resize(TIMER_NUM_TIMERS);
+    for (unsigned int i = 0; i < TIMER_NUM_TIMERS; i++)
+    {
+        timesUS[i] = getTimerUS(i);
+    }
+}
+
+static void addTimerDeltasUS(const std::vector<double>& beforeUS, std::vector<double>& sumUS)
+{
+    sumUS.resize(TIMER_NUM_TIMERS, 0.0);
+    for (unsigned int i = 0; i < TIMER_NUM_TIMERS; i++)
+    {
+        sumUS[i] += getTimerUS(i) - beforeUS[i];
+    }
+}
+
+// Append one CSV row per kernel and metric to the -benchmark file:
+//   input,kernel,iteration,metric,value
+// Timer values are in microseconds, memory in KB and binary size in bytes.
+void CISA_IR_Builder::dumpBenchmarkResults(std::map<VISAKernelImpl*, std::vector<double>>& kernelTimesUS)
+{
+    const char* fileName = m_options.getOptionCstr(vISA_BenchmarkFile);
+    bool writeHeader = false;
+    {
+        std::ifstream existing(fileName);
+        writeHeader = !existing.good() || existing.peek() == std::ifstream::traits_type::eof();
+    }
+
+    std::ofstream os(fileName, std::ios_base::app);
+    if (!os)
+    {
+        std::cerr << "Unable to open benchmark output file " << fileName << "\n";
+        return;
+    }
+    if (writeHeader)
+    {
+        os << "input,kernel,iteration,metric,value\n";
+    }
+
+    // m_kernels keeps the input order, which the map does not
+    for (VISAKernelImpl* kernel : m_kernels)
+    {
+        auto it = kernelTimesUS.find(kernel);
+        if (it == kernelTimesUS.end())
+        {
+            continue;
+        }
+
+        std::string prefix = testName + "," + kernel->getName() + "," + std::to_string(benchmarkIteration) + ",";
+        for (unsigned int i = 0; i < TIMER_NUM_TIMERS; i++)
+        {
+            if (it->second[i] > 0.0)
+            {
+                os << prefix << getTimerName(i) << "," << it->second[i] << "\n";
+            }
+        }
+
+        FINALIZER_INFO* jitInfo = nullptr;
+        kernel->GetJitInfo(jitInfo);
+        if (jitInfo)
+        {
+            os << prefix << "peakIRArenaKB," << jitInfo->peakIRArenaKB << "\n";
+            os << prefix << "peakRAArenaKB," << jitInfo->peakRAArenaKB << "\n";
+            os << prefix << "peakPostRAArenaKB," << jitInfo->peakPostRAArenaKB << "\n";
+            os << prefix << "numGRFSpillFill," << jitInfo->numGRFSpillFill << "\n";
+        }
+        if (kernel->getIsKernel())
+        {
+            os << prefix << "binarySize," << kernel->getGenxBinarySize() << "\n";
+        }
+    }
+}
 
 // default size of the kernel mem manager in bytes
 #define KERNEL_MEM_SIZE    (4*1024*1024)
@@ -792,6 +1079,11 @@ int CISA_IR_Builder::Compile( const char* nameInput)
 
         pseudoHeader.functions = (function_info_t*)mem.alloc(sizeof(function_info_t) * pseudoHeader.num_functions);
 
+        // per-kernel timer deltas for -benchmark
+        bool benchmark = m_options.getOptionCstr(vISA_BenchmarkFile) != nullptr;
+        std::map<VISAKernelImpl*, std::vector<double>> benchTimesUS;
+        std::vector<double> timesBeforeUS;
+
         int i;
         unsigned int k = 0;
         std::list<G4_Kernel*> compilationUnits;
@@ -826,17 +1118,134 @@ int CISA_IR_Builder::Compile( const char* nameInput)
             {
                 kernels.push_back(kernel);
             }
+        }
+
+        // With IPA caller save, functions are compiled bottom-up over the direct call
+        // graph so that every caller sees the clobber sets of its callees. Functions on a
+        // recursive cycle see a callee without a clobber set and keep the ABI behavior.
+        std::vector<VISAKernelImpl*> compileOrder(m_kernels.begin(), m_kernels.end());
+        bool ipaCallerSave = m_options.getOption(vISA_IPACallerSave);
+        std::vector<VISAKernelImpl*> funcById(functions.begin(), functions.end());
+        if (ipaCallerSave)
+        {
+            compileOrder.clear();
+            std::vector<bool> visited(funcById.size(), false);
+            std::function<void(VISAKernelImpl*)> visitCallees = [&](VISAKernelImpl* caller)
+            {
+                for (int funcId : caller->getIRBuilder()->callees)
+                {
+                    if (funcId >= 0 && funcId < (int)funcById.size() && !visited[funcId])
+                    {
+                        visited[funcId] = true;
+                        visitCallees(funcById[funcId]);
+                        compileOrder.push_back(funcById[funcId]);
+                    }
+                }
+            };
+            for (unsigned int funcId = 0; funcId < funcById.size(); funcId++)
+            {
+                if (!visited[funcId])
+                {
+                    visited[funcId] = true;
+                    visitCallees(funcById[funcId]);
+                    compileOrder.push_back(funcById[funcId]);
+                }
+            }
+            compileOrder.insert(compileOrder.end(), kernels.begin(), kernels.end());
+        }
+
+        for (VISAKernelImpl* kernel : compileOrder)
+        {
+            if (ipaCallerSave)
+            {
+                for (int funcId : kernel->getIRBuilder()->callees)
+                {
+                    if (funcId >= 0 && funcId < (int)funcById.size())
+                    {
+                        const std::vector<bool>& regs = funcById[funcId]->getKernel()->getClobberedGRFs();
+                        if (!regs.empty())
+                        {
+                            kernel->getKernel()->setCalleeClobberedGRFs(funcId, regs);
+                        }
+                    }
+                }
+            }
 
             m_currentKernel = kernel;
 
+            if (benchmark)
+            {
+                snapshotTimersUS(timesBeforeUS);
+            }
             int status =  kernel->compileFastPath();
+            if (benchmark)
+            {
+                addTimerDeltasUS(timesBeforeUS, benchTimesUS[kernel]);
+            }
 			if (status != CM_SUCCESS)
 			{
                 stopTimer(TIMER_TOTAL);
 				return status;
             }
+
+            if (ipaCallerSave && !kernel->getIsKernel())
+            {
+                kernel->getKernel()->computeClobberedGRFs();
+            }
         }
 
+        // encode each function once when its binary can be linked into the kernels
+        bool linkStackFuncs = Can_Link_Compiled_Units(m_options, m_kernels);
+        std::map<G4_Kernel*, linkState> linkStates;
+        // linked units are independent until link time and may be encoded in
+        // parallel, unless they write to the shared opt report or name labels
+        // after the current kernel
+        unsigned encodeThreads = m_options.getuInt32Option(vISA_EncodeThreads);
+        bool parallelEncode = linkStackFuncs && encodeThreads > 1 &&
+            !m_options.getOption(vISA_OptReport) &&
+            !m_options.getOption(vISA_UniqueLabels);
+        if (linkStackFuncs)
+        {
+            for (VISAKernelImpl* function : functions)
+            {
+                m_currentKernel = function;
+                Convert_FCalls_For_Link(pseudoHeader, function->getKernel(), compilationUnits,
+                    linkStates[function->getKernel()]);
+
+                if (!parallelEncode)
+                {
+                    unsigned int genxBufferSize = 0;
+                    void* genxBuffer = function->compilePostOptimize(genxBufferSize);
+                    function->setGenxBinaryBuffer(genxBuffer, genxBufferSize);
+                }
+            }
+        }
+        if (parallelEncode)
+        {
+            std::vector<VISAKernelImpl*> units(functions.begin(), functions.end());
+            for (VISAKernelImpl* kernel : kernels)
+            {
+                std::list<G4_Kernel*> kernelUnits;
+                kernelUnits.push_back(kernel->getKernel());
+                for (VISAKernelImpl* function : functions)
+                {
+                    kernelUnits.push_back(function->getKernel());
+                }
+                m_currentKernel = kernel;
+                Convert_FCalls_For_Link(pseudoHeader, kernel->getKernel(), kernelUnits,
+                    linkStates[kernel->getKernel()]);
+                units.push_back(kernel);
+            }
+            Encode_Compiled_Units(this, units, encodeThreads);
+        }
+
+        // a stitched kernel shares BBs and instruction list nodes with the functions,
+        // so its IR can only go early when nothing was stitched into it
+        bool streamFinalize = m_options.getOption(vISA_StreamFinalize) &&
+            (functions.empty() || linkStackFuncs) &&
+            !m_options.getOption(vISA_GenerateDebugInfo) &&
+            !m_options.getOption(vISA_GetFreeGRFInfo);
+
         savedFCallStates savedFCallState;
 
         for(std::list<VISAKernelImpl*>::iterator kernel_it = kernels.begin();
@@ -878,12 +1287,44 @@ int CISA_IR_Builder::Compile( const char* nameInput)
                 }
             }
 
-            unsigned int genxBufferSize = 0;
-
-            Stitch_Compiled_Units(pseudoHeader, compilationUnits);
+            if (linkStackFuncs)
+            {
+                // with parallel encoding this was done before encoding all units
+                if (!parallelEncode)
+                {
+                    Convert_FCalls_For_Link(pseudoHeader, kernel->getKernel(), compilationUnits,
+                        linkStates[kernel->getKernel()]);
+                }
+            }
+            else
+            {
+                Stitch_Compiled_Units(pseudoHeader, compilationUnits);
+            }
 
-            void* genxBuffer = kernel->compilePostOptimize(genxBufferSize);
-            kernel->setGenxBinaryBuffer(genxBuffer, genxBufferSize);
+            if (benchmark)
+            {
+                snapshotTimersUS(timesBeforeUS);
+            }
+            if (!parallelEncode)
+            {
+                unsigned int genxBufferSize = 0;
+                void* genxBuffer = kernel->compilePostOptimize(genxBufferSize);
+                kernel->setGenxBinaryBuffer(genxBuffer, genxBufferSize);
+            }
+            if (linkStackFuncs)
+            {
+                int linkStatus = Link_Compiled_Units(pseudoHeader, kernel, compilationUnits, funcById, linkStates);
+                Restore_FCalls_After_Link(linkStates[kernel->getKernel()]);
+                if (linkStatus != CM_SUCCESS)
+                {
+                    stopTimer(TIMER_TOTAL);
+                    return linkStatus;
+                }
+            }
+            if (benchmark)
+            {
+                addTimerDeltasUS(timesBeforeUS, benchTimesUS[kernel]);
+            }
 
             if(m_options.getOption(vISA_GenerateDebugInfo))
             {
@@ -900,11 +1341,33 @@ int CISA_IR_Builder::Compile( const char* nameInput)
             }
 #endif
 
-            restoreFCallState( kernel->getKernel(), savedFCallState );
+            if (!linkStackFuncs)
+            {
+                restoreFCallState( kernel->getKernel(), savedFCallState );
+            }
 
+            if (streamFinalize && !kernel->getKernel()->hasGTPinInit())
+            {
+                // nothing reads this kernel's IR past this point
+                kernel->releaseG4IR();
+            }
+        }
 
+        if (linkStackFuncs)
+        {
+            // the function binaries now only live in the kernels they were linked into
+            for (VISAKernelImpl* function : functions)
+            {
+                Restore_FCalls_After_Link(linkStates[function->getKernel()]);
+                freeBlock(function->getGenxBinaryBuffer());
+                function->setGenxBinaryBuffer(NULL, 0);
+            }
         }
 
+        if (benchmark)
+        {
+            dumpBenchmarkResults(benchTimesUS);
+        }
 
     }
 
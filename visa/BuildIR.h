@@ -227,7 +227,9 @@ public:
 class RegionPool
 {
     Mem_Manager& mem;
-    std::vector<RegionDesc*> rgnlist;
+    // regions are immutable once created, so they are hash-consed on
+    // <vstride, width, hstride>
+    std::unordered_map<uint64_t, RegionDesc*> rgnTable;
 public:
     RegionPool(Mem_Manager& m) : mem(m) {}
     RegionDesc* createRegion(uint16_t vstride, uint16_t width, uint16_t hstride);
@@ -854,6 +856,11 @@ public:
 
     void initBuiltinSLMSpillAddr(int perThreadSLMSize);
 
+    // Spilling to SLM gives each hardware thread of a subslice its own
+    // slice of the subslice's SLM, placed above the kernel's own SLM.
+    static const int numSLMSpillThreadsPerSS = 56;
+    static const int maxSLMSizePerSS = 64 * 1024;
+
     IR_Builder(INST_LIST_NODE_ALLOCATOR &alloc, PhyRegPool &pregs, G4_Kernel &k,
         Mem_Manager &m, Options *options, bool isFESP64Bits,
         FINALIZER_INFO *jitInfo = NULL, PVISA_WA_TABLE pWaTable = NULL)
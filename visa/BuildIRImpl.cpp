@@ -95,22 +95,15 @@ G4_Label* OperandHashTable::createLabel(const char* lab)
 //
 RegionDesc* RegionPool::createRegion(uint16_t vstride, uint16_t width, uint16_t hstride)
 {
-
-    for (unsigned i = 0, size = (unsigned) rgnlist.size(); i < size; i++)
+    uint64_t key = ((uint64_t) vstride << 32) | ((uint64_t) width << 16) | hstride;
+    RegionDesc*& rd = rgnTable[key];
+    if (rd == NULL)
     {
-        RegionDesc* region = rgnlist[i];
-        if (region->vertStride == vstride &&
-            region->width == width &&
-            region->horzStride == hstride)
-        {
-            return region; // exist
-        }
+        //
+        // create one
+        //
+        rd = new (mem) RegionDesc(vstride, width, hstride);
     }
-    //
-    // create one
-    //
-    RegionDesc* rd = new (mem) RegionDesc(vstride, width, hstride);
-    rgnlist.push_back(rd);
     return rd;
 }
 
@@ -1579,7 +1572,7 @@ void IR_Builder::initBuiltinSLMSpillAddr(int perThreadSLMSize)
     // EU_id = sr0.0[4:7]
     // tid = sr0.0[0:2]
     //
-    const int numThreadPerSS = 56;
+    const int numThreadPerSS = numSLMSpillThreadsPerSS;
     const int numThreadPerEU = 7;
     G4_Declare* SSID = createTempVar(1, Type_UW, Either, Four_Word); // SSID may also be used as mad dst
     G4_Declare* EUID = createTempVar(1, Type_UW, Either, Any);
@@ -1679,6 +1672,15 @@ void IR_Builder::initBuiltinSLMSpillAddr(int perThreadSLMSize)
     G4_DstRegRegion* mulDst = Create_Dst_Opnd_From_Dcl(perThreadSLMStart, 1);
     instBuffer.push_back(createInternalInst(nullptr, G4_mul, nullptr, false, 1, mulDst, mulSrc0, mulSrc1, InstOpt_WriteEnable));
 
+    // the spill area starts after the SLM the kernel uses itself
+    if (kernel.getSLMSize() != 0)
+    {
+        G4_SrcRegRegion* addSrc0 = Create_Src_Opnd_From_Dcl(perThreadSLMStart, getRegionScalar());
+        G4_Imm* addSrc1 = createImm(kernel.getSLMSize(), Type_UD);
+        G4_DstRegRegion* addDst = Create_Dst_Opnd_From_Dcl(perThreadSLMStart, 1);
+        instBuffer.push_back(createInternalInst(nullptr, G4_add, nullptr, false, 1, addDst, addSrc0, addSrc1, InstOpt_WriteEnable));
+    }
+
     // add to entryBB:
     // (W) mov (8) immVec4.0<1>:uw 0x76543210:uv
     // (W) mov (8) immVec.8<1>:uw 0xFEDCBA98:uv
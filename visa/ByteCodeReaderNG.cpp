@@ -78,7 +78,8 @@ struct RoutineContainer
         labelVarDecls(NULL),     labelVarsCount(0),
         inputVarDecls(NULL),     inputVarsCount(0),
         majorVersion(0),
-        minorVersion(0) { }
+        minorVersion(0),
+        skipsFunctions(false) { }
 
     ~RoutineContainer()
     {
@@ -94,13 +95,17 @@ struct RoutineContainer
     VISA_LabelOpnd**      labelVarDecls; unsigned     labelVarsCount;
     CISA_GEN_VAR**        inputVarDecls; unsigned     inputVarsCount;
 
-    vector<string> stringPool;
+    // points directly into the byte code buffer, which outlives the reader
+    vector<const char*> stringPool;
 
     CISA_IR_Builder* builder;
     VISAKernel*      kernelBuilder;
     uint8_t majorVersion;
     uint8_t minorVersion;
 
+    // true if unreferenced functions are not read, in which case the vISA
+    // function ids are renumbered and indirect calls can not be resolved
+    bool skipsFunctions;
 };
 
 /// Assumming buf is start of the CISA byte code.
@@ -1230,6 +1235,7 @@ static void readInstructionControlFlow(unsigned& bytePos, const char* buf, ISA_O
         readExecSizeNG(bytePos, buf, esize, emask, container);
         VISA_PredOpnd* pred = hasPredicate(opcode) ? readPredicateOperandNG(bytePos, buf, container) : nullptr;
 
+        ASSERT_USER(!container.skipsFunctions, "indirect call is not supported when skipping unreferenced functions");
         VISA_VectorOpnd* funcAddr = readVectorOperandNG(bytePos, buf, container, false);
         uint8_t argSize = readPrimitiveOperandNG<uint8_t>(bytePos, buf);
         uint8_t retSize = readPrimitiveOperandNG<uint8_t>(bytePos, buf);
@@ -1238,6 +1244,7 @@ static void readInstructionControlFlow(unsigned& bytePos, const char* buf, ISA_O
     }
     case ISA_FADDR:
     {
+        ASSERT_USER(!container.skipsFunctions, "function address is not supported when skipping unreferenced functions");
         uint16_t funcId = readPrimitiveOperandNG<uint16_t>(bytePos, buf);
         VISA_VectorOpnd* dst = readVectorOperandNG(bytePos, buf, container, true);
         kernelBuilder->AppendVISACFFuncAddrInst(funcId, dst);
@@ -1278,7 +1285,7 @@ static void readInstructionMisc(unsigned& bytePos, const char* buf, ISA_Opcode o
             bool is3Dot4Plus = versionInt >= getVersionAsInt(3, 4);
             uint32_t filenameIndex = is3Dot4Plus ? readPrimitiveOperandNG<uint32_t>(bytePos, buf) :
                 readPrimitiveOperandNG<uint16_t>(bytePos, buf);
-            const char* filename = container.stringPool[filenameIndex].c_str();
+            const char* filename = container.stringPool[filenameIndex];
             kernelBuilder->AppendVISAMiscFileInst((char*)filename);
             break;
         }
@@ -2242,14 +2249,15 @@ static void readRoutineNG(unsigned& bytePos, const char* buf, vISA::Mem_Manager&
     container.stringPool.resize(header.string_count);
     for (unsigned i = 0; i < header.string_count; i++)
     {
-        char* str = (char*)mem.alloc(STRING_LEN);
+        // strings are NUL-terminated in the byte code, so refer to them in place
+        const char* str = &buf[bytePos];
         unsigned j = 0;
         while (buf[bytePos] != '\0' && j < STRING_LEN)
         {
-            str[j++] = buf[bytePos++];
+            j++;
+            bytePos++;
         }
         ASSERT_USER(j < STRING_LEN, "string exceeds the maximum length allowed");
-        str[j] = '\0';
         bytePos++;
         header.strings[i] = str;
         container.stringPool[i] = str;
@@ -2652,6 +2660,56 @@ static void readRoutineNG(unsigned& bytePos, const char* buf, vISA::Mem_Manager&
     }
 }
 
+
+// Marks in referenced every function reachable from the given function
+// relocation table, following the tables of the functions it resolves to.
+static void markReferencedFunctions(const reloc_symtab& symtab, const common_isa_header& isaHeader, vector<bool>& referenced)
+{
+    for (int i = 0; i < symtab.num_syms; i++)
+    {
+        unsigned funcIndex = symtab.reloc_syms[i].resolved_index;
+        if (funcIndex < isaHeader.num_functions && !referenced[funcIndex])
+        {
+            referenced[funcIndex] = true;
+            markReferencedFunctions(isaHeader.functions[funcIndex].function_reloc_symtab, isaHeader, referenced);
+        }
+    }
+}
+
+// Computes the id each vISA function is built with. With
+// vISA_SkipUnreferencedFunctions, functions that none of the kernels being
+// read can reach get -1 and are never decoded, and the remaining ones are
+// renumbered densely in their original order.
+// Returns true if any function is skipped.
+static bool computeFunctionIds(const common_isa_header& isaHeader, int kernelIndex, bool skipUnreferenced, vector<int>& funcIds)
+{
+    vector<bool> referenced(isaHeader.num_functions, !skipUnreferenced);
+    if (skipUnreferenced)
+    {
+        for (unsigned k = 0; k < isaHeader.num_kernels; k++)
+        {
+            if (kernelIndex == -1 || kernelIndex == (int)k)
+            {
+                markReferencedFunctions(isaHeader.kernels[k].function_reloc_symtab, isaHeader, referenced);
+            }
+        }
+    }
+
+    int numFuncs = 0;
+    funcIds.resize(isaHeader.num_functions);
+    for (unsigned i = 0; i < isaHeader.num_functions; i++)
+    {
+        funcIds[i] = referenced[i] ? numFuncs++ : -1;
+    }
+    return numFuncs != (int)isaHeader.num_functions;
+}
+
+static unsigned short getFunctionId(const vector<int>& funcIds, unsigned short resolvedIndex)
+{
+    return resolvedIndex < funcIds.size() && funcIds[resolvedIndex] != -1 ?
+        (unsigned short)funcIds[resolvedIndex] : resolvedIndex;
+}
+
 //
 // buf -- vISA binary to be processed.  For offline compile it's always the entire vISA object.
 //     For JIT mode it's the entire isa file for 3.0, the kernel isa only for 2.x
@@ -2714,6 +2772,10 @@ extern bool readIsaBinaryNG(const char* buf, CISA_IR_Builder* builder, vector<VI
             return false;
         }
 
+        vector<int> funcIds;
+        bool skipsFunctions = computeFunctionIds(isaHeader, kernelIndex,
+            builder->m_options.getOption(vISA_SkipUnreferencedFunctions), funcIds);
+
         bytePos = isaHeader.kernels[kernelIndex].offset;
 
         RoutineContainer container;
@@ -2723,6 +2785,7 @@ extern bool readIsaBinaryNG(const char* buf, CISA_IR_Builder* builder, vector<VI
         container.kernelBuilder = NULL;
         container.majorVersion = isaHeader.major_version;
         container.minorVersion = isaHeader.minor_version;
+        container.skipsFunctions = skipsFunctions;
 
         builder->AddKernel(container.kernelBuilder, isaHeader.kernels[kernelIndex].name);
 
@@ -2735,7 +2798,7 @@ extern bool readIsaBinaryNG(const char* buf, CISA_IR_Builder* builder, vector<VI
         for (int i = 0; i < isaHeader.kernels[kernelIndex].function_reloc_symtab.num_syms; i++)
         {
             reloc_sym& funcRelocSym = isaHeader.kernels[kernelIndex].function_reloc_symtab.reloc_syms[i];
-            ((VISAKernelImpl*)container.kernelBuilder)->addFuncRelocEntry(funcRelocSym.symbolic_index, funcRelocSym.resolved_index);
+            ((VISAKernelImpl*)container.kernelBuilder)->addFuncRelocEntry(funcRelocSym.symbolic_index, getFunctionId(funcIds, funcRelocSym.resolved_index));
         }
 
         ((VISAKernelImpl*)container.kernelBuilder)->setupRelocTable();
@@ -2748,6 +2811,11 @@ extern bool readIsaBinaryNG(const char* buf, CISA_IR_Builder* builder, vector<VI
 
         for (unsigned int i = 0; i < isaHeader.num_functions; i++)
         {
+            if (funcIds[i] == -1)
+            {
+                continue;
+            }
+
             bytePos = isaHeader.functions[i].offset;
 
             VISAFunction* funcPtr = NULL;
@@ -2764,7 +2832,7 @@ extern bool readIsaBinaryNG(const char* buf, CISA_IR_Builder* builder, vector<VI
             for (int m = 0; m < isaHeader.functions[i].function_reloc_symtab.num_syms; m++)
             {
                 reloc_sym& funcRelocSym = isaHeader.functions[i].function_reloc_symtab.reloc_syms[m];
-                ((VISAKernelImpl*)container.kernelBuilder)->addFuncRelocEntry(funcRelocSym.symbolic_index, funcRelocSym.resolved_index);
+                ((VISAKernelImpl*)container.kernelBuilder)->addFuncRelocEntry(funcRelocSym.symbolic_index, getFunctionId(funcIds, funcRelocSym.resolved_index));
             }
 
             // Setup relocation table in IR_Builder if one exists
@@ -2778,6 +2846,10 @@ extern bool readIsaBinaryNG(const char* buf, CISA_IR_Builder* builder, vector<VI
     }
     else
     {
+        vector<int> funcIds;
+        bool skipsFunctions = computeFunctionIds(isaHeader, -1,
+            builder->m_options.getOption(vISA_SkipUnreferencedFunctions), funcIds);
+
         for( unsigned int k = 0; k < isaHeader.num_kernels; k++ )
         {
             bytePos = isaHeader.kernels[k].offset;
@@ -2789,6 +2861,7 @@ extern bool readIsaBinaryNG(const char* buf, CISA_IR_Builder* builder, vector<VI
             container.kernelBuilder = NULL;
             container.majorVersion = isaHeader.major_version;
             container.minorVersion = isaHeader.minor_version;
+            container.skipsFunctions = skipsFunctions;
 
             builder->AddKernel(container.kernelBuilder, isaHeader.kernels[k].name);
 
@@ -2801,7 +2874,7 @@ extern bool readIsaBinaryNG(const char* buf, CISA_IR_Builder* builder, vector<VI
             for (int i = 0; i < isaHeader.kernels[k].function_reloc_symtab.num_syms; i++)
             {
                 reloc_sym& funcRelocSym = isaHeader.kernels[k].function_reloc_symtab.reloc_syms[i];
-                ((VISAKernelImpl*)container.kernelBuilder)->addFuncRelocEntry(funcRelocSym.symbolic_index, funcRelocSym.resolved_index);
+                ((VISAKernelImpl*)container.kernelBuilder)->addFuncRelocEntry(funcRelocSym.symbolic_index, getFunctionId(funcIds, funcRelocSym.resolved_index));
             }
 
             // Setup relocation table in IR_Builder if one exists
@@ -2815,6 +2888,11 @@ extern bool readIsaBinaryNG(const char* buf, CISA_IR_Builder* builder, vector<VI
 
         for (unsigned int i = 0; i < isaHeader.num_functions; i++)
             {
+                if (funcIds[i] == -1)
+                {
+                    continue;
+                }
+
                 RoutineContainer container;
 
                 container.builder = builder;
@@ -2822,6 +2900,7 @@ extern bool readIsaBinaryNG(const char* buf, CISA_IR_Builder* builder, vector<VI
                 container.fileVarsCount = fileVarsCount;
                 container.majorVersion = isaHeader.major_version;
                 container.minorVersion = isaHeader.minor_version;
+                container.skipsFunctions = skipsFunctions;
 
                 bytePos = isaHeader.functions[i].offset;
 
@@ -2839,7 +2918,7 @@ extern bool readIsaBinaryNG(const char* buf, CISA_IR_Builder* builder, vector<VI
                 for( int m = 0; m < isaHeader.functions[i].function_reloc_symtab.num_syms; m++ )
                 {
                     reloc_sym& funcRelocSym = isaHeader.functions[i].function_reloc_symtab.reloc_syms[m];
-                    ((VISAKernelImpl*)container.kernelBuilder)->addFuncRelocEntry( funcRelocSym.symbolic_index, funcRelocSym.resolved_index );
+                    ((VISAKernelImpl*)container.kernelBuilder)->addFuncRelocEntry( funcRelocSym.symbolic_index, getFunctionId(funcIds, funcRelocSym.resolved_index) );
                 }
 
                 // Setup relocation table in IR_Builder if one exists
@@ -1477,6 +1477,14 @@ namespace vISA
 
         bool compactOneInstruction(G4_INST *);
         bool BDWcompactOneInstruction(G4_INST *);
+        bool BDWfindCompactIndices(const bool source_immediate[2],
+            uint32_t bits_033_032, uint32_t bits_031_031, uint32_t bits_023_012,
+            uint32_t bits_010_009, uint32_t bits_034_034, uint32_t bits_008_008,
+            uint32_t bits_063_061, uint32_t bits_094_089, uint32_t bits_046_035,
+            uint32_t bits_100_096, uint32_t bits_068_064, uint32_t bits_052_048,
+            uint32_t bits_088_077, uint32_t bits_120_109,
+            uint32_t& controlIndex, uint32_t& dataTypeIndex, uint32_t& subRegIndex,
+            uint32_t& src0Index, uint32_t& src1Index);
         bool BDWcompactOneInstruction3Src(G4_INST *);
         bool CHVcompactOneInstruction3Src(G4_INST *);
         bool uncompactOneInstruction(G4_INST *);
@@ -1508,6 +1516,32 @@ namespace vISA
 
         uint32_t        instCounts;
 
+        // Memoized results of the 2-src compaction table lookups, keyed by the
+        // uncompacted fields the tables match on. The tables are filled once
+        // per encoder for its platform, so the memo stays valid for the whole
+        // kernel. Value is the packed 5-bit control/datatype/subreg/src0/src1
+        // indices, or NOT_COMPACTABLE.
+        struct CompactionKey
+        {
+            uint64_t ctrlAndType;
+            uint64_t operands;
+            bool operator==(const CompactionKey& other) const
+            {
+                return ctrlAndType == other.ctrlAndType && operands == other.operands;
+            }
+        };
+
+        struct CompactionKeyHash
+        {
+            std::size_t operator()(const CompactionKey& key) const
+            {
+                return std::hash<uint64_t>()(key.ctrlAndType * 31 + key.operands);
+            }
+        };
+
+        static const uint32_t NOT_COMPACTABLE = 0xFFFFFFFF;
+        std::unordered_map<CompactionKey, uint32_t, CompactionKeyHash> compactionMemo;
+
     public:
         // all platform specific bit locations are initialized here
         static void InitPlatform()
@@ -2444,46 +2478,19 @@ namespace vISA
         return true;
     }
 
-    inline bool BinaryEncodingBase::BDWcompactOneInstruction(G4_INST *inst)
+    // Looks up the control/datatype/subreg/source table indices for the given
+    // uncompacted fields. Returns false if any of the tables has no match.
+    // src1Index is only meaningful if neither source is an immediate.
+    inline bool BinaryEncodingBase::BDWfindCompactIndices(const bool source_immediate[2],
+        uint32_t bits_033_032, uint32_t bits_031_031, uint32_t bits_023_012,
+        uint32_t bits_010_009, uint32_t bits_034_034, uint32_t bits_008_008,
+        uint32_t bits_063_061, uint32_t bits_094_089, uint32_t bits_046_035,
+        uint32_t bits_100_096, uint32_t bits_068_064, uint32_t bits_052_048,
+        uint32_t bits_088_077, uint32_t bits_120_109,
+        uint32_t& controlIndex, uint32_t& dataTypeIndex, uint32_t& subRegIndex,
+        uint32_t& src0Index, uint32_t& src1Index)
     {
-        BinInst *mybin = inst->getBinInst();
-
-        if (mybin->GetIs3Src())
-        {
-            if (getGenxPlatform() == GENX_BDW)
-            {
-                return BDWcompactOneInstruction3Src(inst);
-            }
-            else if (getGenxPlatform() >= GENX_CHV)
-            {
-                // CHV and SKL are using the same compaction table for 3src
-                return CHVcompactOneInstruction3Src(inst);
-            }
-            else
-            {
-                // other platforms not handled yet
-                return false;
-            }
-        }
-
-        if (getGenxPlatform() >= GENX_CHV && inst->isSend())
-        {
-            return false;
-        }
-
-        bool source_immediate[2];
-        source_immediate[0] = (RegFile(GetSrc0RegFile(mybin)) == REG_FILE_I);
-        source_immediate[1] = (RegFile(GetSrc1RegFile(mybin)) == REG_FILE_I);
-
         // Check control table...
-        uint32_t controlIndex;
-        uint32_t bits_033_032 = mybin->GetBits(33, 32);
-        uint32_t bits_031_031 = mybin->GetBits(31, 31);
-        uint32_t bits_023_012 = mybin->GetBits(23, 12);
-        uint32_t bits_010_009 = mybin->GetBits(10, 9);
-        uint32_t bits_034_034 = mybin->GetBits(34, 34);
-        uint32_t bits_008_008 = mybin->GetBits(8, 8);
-        bool mustCompact = !(mybin->GetMustCompactFlag());
         if (!BDWCompactControlTable.FindIndex(controlIndex,
             bits_033_032,
             bits_031_031,
@@ -2492,41 +2499,25 @@ namespace vISA
             bits_034_034,
             bits_008_008))
         {
-            MUST_BE_TRUE(mustCompact, "Compaction failure for control table");
-            // Can't compact...
             return false;
         }
 
-
         // Check data type table
-        uint32_t dataTypeIndex;
-        uint32_t bits_063_061 = mybin->GetBits(63, 61);
-        uint32_t bits_094_089 = mybin->GetBits(94, 89);
-        uint32_t bits_046_035 = mybin->GetBits(46, 35);
         if (!BDWCompactDataTypeTableStr.FindIndex(dataTypeIndex,
             bits_063_061,
             bits_094_089,
             bits_046_035))
         {
-            MUST_BE_TRUE(mustCompact, "Compaction failure for data type table");
-            // Can't compact...
             return false;
         }
 
         // Check sub-register table...
-        uint32_t subRegIndex;
-        uint32_t bits_100_096 = mybin->GetBits(100, 96);
-        uint32_t bits_068_064 = mybin->GetBits(68, 64);
-        uint32_t bits_052_048 = mybin->GetBits(52, 48);
-
         // If source 0 is an immediate, we only check destination
         // sub-register info for compaction restrictions.
         if (source_immediate[0])
         {
             if (!BDWCompactSubRegTable.FindIndex1(subRegIndex, bits_052_048))
             {
-                MUST_BE_TRUE(mustCompact, "Compaction failure for sub reg table");
-                // Can't compact...
                 return false;
             }
         }
@@ -2536,8 +2527,6 @@ namespace vISA
         {
             if (!BDWCompactSubRegTable.FindIndex2(subRegIndex, bits_068_064, bits_052_048))
             {
-                MUST_BE_TRUE(mustCompact, "Compaction failure for sub reg table");
-                // Can't compact...
                 return false;
             }
         }
@@ -2545,22 +2534,15 @@ namespace vISA
         else if (!BDWCompactSubRegTable.FindIndex(subRegIndex,
             bits_100_096, bits_068_064, bits_052_048))
         {
-            MUST_BE_TRUE(mustCompact, "Compaction failure for sub reg table");
-            // Can't compact...
             return false;
         }
 
         // Check source 0 table...
-        uint32_t src0Index;
-        uint32_t bits_088_077 = mybin->GetBits(88, 77);
-
         // If source 0 is not immediate data, we need to check source 0 info
         if (!source_immediate[0])
         {
             if (!BDWCompactSourceTable.FindIndex(src0Index, bits_088_077))
             {
-                MUST_BE_TRUE(mustCompact, "Compaction failure for source table");
-                // Can't compact...
                 return false;
             }
         }
@@ -2571,20 +2553,126 @@ namespace vISA
         }
 
         // Check source 1 table...
-        uint32_t src1Index;
-        uint32_t bits_120_109 = mybin->GetBits(120, 109);
-
         // If both source 0 and source 1 are not immediate data,
         // we need to cehck source 1 information
+        src1Index = 0;
         if (!source_immediate[0] && !source_immediate[1])
         {
             if (!BDWCompactSourceTable.FindIndex(src1Index, bits_120_109))
             {
-                MUST_BE_TRUE(mustCompact, "Compact should be set to false");
-                // Can't compact...
                 return false;
             }
         }
+
+        return true;
+    }
+
+    inline bool BinaryEncodingBase::BDWcompactOneInstruction(G4_INST *inst)
+    {
+        BinInst *mybin = inst->getBinInst();
+
+        if (mybin->GetIs3Src())
+        {
+            if (getGenxPlatform() == GENX_BDW)
+            {
+                return BDWcompactOneInstruction3Src(inst);
+            }
+            else if (getGenxPlatform() >= GENX_CHV)
+            {
+                // CHV and SKL are using the same compaction table for 3src
+                return CHVcompactOneInstruction3Src(inst);
+            }
+            else
+            {
+                // other platforms not handled yet
+                return false;
+            }
+        }
+
+        if (getGenxPlatform() >= GENX_CHV && inst->isSend())
+        {
+            return false;
+        }
+
+        bool source_immediate[2];
+        source_immediate[0] = (RegFile(GetSrc0RegFile(mybin)) == REG_FILE_I);
+        source_immediate[1] = (RegFile(GetSrc1RegFile(mybin)) == REG_FILE_I);
+
+        uint32_t bits_033_032 = mybin->GetBits(33, 32);
+        uint32_t bits_031_031 = mybin->GetBits(31, 31);
+        uint32_t bits_023_012 = mybin->GetBits(23, 12);
+        uint32_t bits_010_009 = mybin->GetBits(10, 9);
+        uint32_t bits_034_034 = mybin->GetBits(34, 34);
+        uint32_t bits_008_008 = mybin->GetBits(8, 8);
+        uint32_t bits_063_061 = mybin->GetBits(63, 61);
+        uint32_t bits_094_089 = mybin->GetBits(94, 89);
+        uint32_t bits_046_035 = mybin->GetBits(46, 35);
+        uint32_t bits_100_096 = mybin->GetBits(100, 96);
+        uint32_t bits_068_064 = mybin->GetBits(68, 64);
+        uint32_t bits_052_048 = mybin->GetBits(52, 48);
+        uint32_t bits_088_077 = mybin->GetBits(88, 77);
+        uint32_t bits_120_109 = mybin->GetBits(120, 109);
+        bool mustCompact = !(mybin->GetMustCompactFlag());
+
+        // Fields the tables do not look at for this operand mix are left out
+        // of the key, so e.g. all "op dst, src0, imm" forms sharing dst/src0
+        // layouts hit the same entry.
+        CompactionKey key;
+        key.ctrlAndType = (uint64_t)(bits_008_008 |
+            (bits_034_034 << 1) |
+            (bits_010_009 << 2) |
+            (bits_023_012 << 4) |
+            (bits_031_031 << 16) |
+            (bits_033_032 << 17)) |
+            ((uint64_t)(bits_046_035 |
+            (bits_094_089 << 12) |
+            (bits_063_061 << 18)) << 32);
+        key.operands = (uint64_t)bits_052_048 |
+            ((uint64_t)source_immediate[0] << 62) |
+            ((uint64_t)source_immediate[1] << 63);
+        if (!source_immediate[0])
+        {
+            key.operands |= ((uint64_t)bits_068_064 << 5) |
+                ((uint64_t)bits_088_077 << 20);
+            if (!source_immediate[1])
+            {
+                key.operands |= ((uint64_t)bits_100_096 << 10) |
+                    ((uint64_t)bits_120_109 << 32);
+            }
+        }
+
+        uint32_t controlIndex, dataTypeIndex, subRegIndex, src0Index, src1Index;
+        auto memo = compactionMemo.find(key);
+        if (memo == compactionMemo.end())
+        {
+            uint32_t packed = NOT_COMPACTABLE;
+            if (BDWfindCompactIndices(source_immediate,
+                bits_033_032, bits_031_031, bits_023_012, bits_010_009, bits_034_034, bits_008_008,
+                bits_063_061, bits_094_089, bits_046_035,
+                bits_100_096, bits_068_064, bits_052_048,
+                bits_088_077, bits_120_109,
+                controlIndex, dataTypeIndex, subRegIndex, src0Index, src1Index))
+            {
+                packed = controlIndex | (dataTypeIndex << 5) | (subRegIndex << 10) |
+                    (src0Index << 15) | (src1Index << 20);
+            }
+            memo = compactionMemo.emplace(key, packed).first;
+        }
+
+        if (memo->second == NOT_COMPACTABLE)
+        {
+            MUST_BE_TRUE(mustCompact, "Compaction failure for compaction tables");
+            // Can't compact...
+            return false;
+        }
+        controlIndex = memo->second & 0x1F;
+        dataTypeIndex = (memo->second >> 5) & 0x1F;
+        subRegIndex = (memo->second >> 10) & 0x1F;
+        src0Index = (memo->second >> 15) & 0x1F;
+        if (!source_immediate[0] && !source_immediate[1])
+        {
+            src1Index = (memo->second >> 20) & 0x1F;
+        }
         else
         {
             src1Index = mybin->GetBits(127, 104);
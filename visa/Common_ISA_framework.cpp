@@ -380,21 +380,39 @@ int CisaBinary::dumpToFile(std::string binFileName)
         std::cerr<<"Could not open %s"<< binFileName.c_str()<<std::endl;
         return CM_FAILURE;
     }
-    os.write(this->m_header_buffer, this->m_header_size);
-
-    for(int i = 0; i< m_header.num_kernels; i++)
+    for (const Segment& seg : getSegments())
     {
-        os.write(m_header.kernels[i].cisa_binary_buffer, m_header.kernels[i].size);
-        os.write(m_header.kernels[i].genx_binary_buffer, m_header.kernels[i].binary_size);
+        os.write(seg.data, seg.size);
     }
+    os.close();
+    return CM_SUCCESS;
+}
+
+std::vector<CisaBinary::Segment> CisaBinary::getSegments() const
+{
+    std::vector<Segment> segments;
+    segments.reserve(1 + 2 * (m_header.num_kernels + m_header.num_functions));
+
+    auto addSegment = [&segments](const char* data, size_t size)
+    {
+        if (size > 0)
+        {
+            segments.push_back({ data, size });
+        }
+    };
 
+    addSegment(m_header_buffer, m_header_size);
+    for (int i = 0; i < m_header.num_kernels; i++)
+    {
+        addSegment(m_header.kernels[i].cisa_binary_buffer, m_header.kernels[i].size);
+        addSegment(m_header.kernels[i].genx_binary_buffer, m_header.kernels[i].binary_size);
+    }
     for (int i = 0; i < m_header.num_functions; i++)
     {
-        os.write(m_header.functions[i].cisa_binary_buffer, m_header.functions[i].size);
-        os.write(m_header.functions[i].genx_binary_buffer, m_header.functions[i].binary_size);
+        addSegment(m_header.functions[i].cisa_binary_buffer, m_header.functions[i].size);
+        addSegment(m_header.functions[i].genx_binary_buffer, m_header.functions[i].binary_size);
     }
-    os.close();
-    return CM_SUCCESS;
+    return segments;
 }
 
 int CisaBinary::setFileScopeVar(VISA_FileVar * temp_info)
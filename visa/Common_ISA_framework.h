@@ -260,6 +260,19 @@ public:
     int finalizeCisaFileScopeVars();
     void finalizeRelocationTables();
     int dumpToFile(std::string binFileName);
+
+    // One contiguous piece of the finalized vISA object. The data is owned by
+    // the CisaBinary or the kernel it belongs to.
+    struct Segment
+    {
+        const char* data;
+        size_t size;
+    };
+    // Returns, in file order, the buffers making up the vISA object so it can
+    // be dumped or cached without first being copied into one buffer.
+    // Only valid after finalizeCisaBinary().
+    std::vector<Segment> getSegments() const;
+    unsigned long getTotalSize() const { return m_total_size; }
     int setFileScopeVar(VISA_FileVar * info);
 
     unsigned       getInstId() const { return m_instId; }
@@ -45,6 +45,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "DebugInfo.h"
 #include <random>
 #include <chrono>
+#include <atomic>
 
 #include "BinaryEncodingIGA.h"
 #include "iga/IGALibrary/api/iga.h"
@@ -438,7 +439,8 @@ G4_BB* FlowGraph::createNewBB(bool insertInFG)
     return bb;
 }
 
-static int globalCount = 1;
+// shared by all kernels compiled in the process, possibly concurrently
+static std::atomic<int> globalCount(1);
 int64_t FlowGraph::insertDummyUUIDMov()
 {
     // Here when -addKernelId is passed
@@ -456,8 +458,7 @@ int64_t FlowGraph::insertDummyUUIDMov()
         for (auto bb : BBs)
         {
             uint32_t seed = (uint32_t)std::chrono::high_resolution_clock::now().time_since_epoch().count();
-            std::mt19937 mt_rand(seed * globalCount);
-            globalCount++;
+            std::mt19937 mt_rand(seed * globalCount++);
 
             G4_DstRegRegion* nullDst = builder->createNullDst(Type_UD);
             int64_t uuID = (int64_t)mt_rand();
@@ -1082,7 +1083,11 @@ void FlowGraph::constructFlowGraph(INST_LIST& instlist)
     setPhysicalPredSucc();
     if (hasGoto)
     {
-        if (builder->getOption(vISA_EnableStructurizer))
+        // Structurizing very large CFGs can dominate compile time; past the
+        // budget, fall back to unstructured goto/join. 0 means no limit.
+        uint32_t structurizerMaxBBs = builder->getOptions()->getuInt32Option(vISA_StructurizerMaxBBs);
+        bool withinStructurizerBudget = structurizerMaxBBs == 0 || getNumBB() <= structurizerMaxBBs;
+        if (builder->getOption(vISA_EnableStructurizer) && withinStructurizerBudget)
         {
             if (builder->getOption(vISA_DumpDotAll))
             {
@@ -3966,6 +3971,7 @@ void G4_Kernel::emit_asm(std::ostream& output, bool beforeRegAlloc, void * binar
             << "." << (unsigned int)minor_version;
         output << "\n" << "//.options " << m_options->getArgString().str();
         output << "\n" << "//.instCount " << asmInstCount;
+        output << "\n" << "//.compactedCount " << compactedInstCount;
         output << "\n//.RA type\t" << RATypeString[RAType];
 
         if (auto jitInfo = fg.builder->getJitInfo())
@@ -5799,6 +5805,91 @@ unsigned int G4_Kernel::getNumCalleeSaveRegs()
     return totalGRFs - calleeSaveStart() - getNumScratchRegs();
 }
 
+//
+// Record the caller-save GRFs this stack call function may write, including the ones
+// written by its callees, so callers can skip saving registers that survive the call.
+// Indirect calls, indirect destinations and callees without a known set leave the set empty,
+// which makes callers fall back to the ABI caller-save partition.
+//
+void G4_Kernel::computeClobberedGRFs()
+{
+    clobberedGRFs.clear();
+    if (hasIndirectCall())
+    {
+        return;
+    }
+
+    unsigned int callerSaveNumGRF = getCallerSaveLastGRF() + 1;
+    std::vector<bool> regs(callerSaveNumGRF, false);
+
+    for (int funcId : fg.builder->callees)
+    {
+        const std::vector<bool>* calleeRegs = getCalleeClobberedGRFs(funcId);
+        if (!calleeRegs || calleeRegs->size() != callerSaveNumGRF)
+        {
+            return;
+        }
+        for (unsigned int i = 0; i < callerSaveNumGRF; i++)
+        {
+            regs[i] = regs[i] || (*calleeRegs)[i];
+        }
+    }
+
+    auto markDst = [&](G4_DstRegRegion* opnd)
+    {
+        if (!opnd || !opnd->isRegRegion() || !opnd->isGreg())
+        {
+            return true;
+        }
+        if (opnd->getRegAccess() != Direct)
+        {
+            return false;
+        }
+
+        unsigned int startReg = 0, endReg = 0;
+        G4_Declare* topDcl = opnd->getTopDcl();
+        if (topDcl && topDcl->getRegVar()->isPhyRegAssigned())
+        {
+            // conservatively take the whole root variable
+            G4_VarBase* phyReg = topDcl->getRegVar()->getPhyReg();
+            if (!phyReg->isGreg())
+            {
+                return true;
+            }
+            startReg = phyReg->asGreg()->getRegNum();
+            endReg = startReg + topDcl->getNumRows();
+        }
+        else if (opnd->getBase()->isPhyGreg())
+        {
+            startReg = opnd->getBase()->asGreg()->getRegNum();
+            endReg = startReg + opnd->getRightBound() / G4_GRF_REG_NBYTES + 2;
+        }
+        else
+        {
+            return false;
+        }
+
+        for (unsigned int i = startReg; i < endReg && i < callerSaveNumGRF; i++)
+        {
+            regs[i] = true;
+        }
+        return true;
+    };
+
+    for (auto bb : fg.BBs)
+    {
+        for (auto inst : *bb)
+        {
+            if (!markDst(inst->getDst()))
+            {
+                return;
+            }
+        }
+    }
+
+    clobberedGRFs.swap(regs);
+}
+
 void RelocationEntry::doRelocation(const G4_Kernel& kernel, void* binary, uint32_t binarySize)
 {
     uint32_t instOffset = (uint32_t)inst->getGenOffset();
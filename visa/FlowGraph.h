@@ -1265,6 +1265,7 @@ class G4_Kernel
     gtPinData* gtPinInfo = nullptr;
 
     uint32_t asmInstCount;
+    uint32_t compactedInstCount;
     uint64_t kernelID;
     uint32_t tokenInstructionCount;
     uint32_t tokenReuseCount;
@@ -1285,6 +1286,9 @@ class G4_Kernel
 
     bool m_hasIndirectCall = false;
 
+    // SLM bytes the kernel allocates for itself (SLMSize attribute)
+    uint32_t slmSize = 0;
+
     // stores all relocations to be performed after binary encoding
     std::vector<RelocationEntry> relocationTable;
 
@@ -1294,6 +1298,13 @@ class G4_Kernel
     // this is populated for kernel only 
     std::unordered_map<uint32_t, G4_Kernel*> allCallees;
 
+    // caller-save GRFs written by this stack call function and everything it calls;
+    // empty if not known. Only computed with vISA_IPACallerSave.
+    std::vector<bool> clobberedGRFs;
+
+    // funcId -> clobber set of each direct callee that was compiled before this unit
+    std::unordered_map<uint32_t, std::vector<bool>> calleeClobberedGRFs;
+
 public:
     FlowGraph fg;
     DECLARE_LIST           Declares;
@@ -1304,7 +1315,7 @@ public:
     G4_Kernel(INST_LIST_NODE_ALLOCATOR& alloc,
               Mem_Manager &m, Options *options, unsigned char major, unsigned char minor)
               : m_options(options), RAType(RA_Type::UNKNOWN_RA), fg(alloc, this, m), 
-              major_version(major), minor_version(minor), asmInstCount(0), kernelID(0), 
+              major_version(major), minor_version(minor), asmInstCount(0), compactedInstCount(0), kernelID(0), 
               tokenInstructionCount(0), tokenReuseCount(0), AWTokenReuseCount(0),
               ARTokenReuseCount(0), AATokenReuseCount(0), mathInstCount(0), syncInstCount(0),mathReuseCount(0),
               ARSyncInstCount(0), AWSyncInstCount(0),
@@ -1344,6 +1355,8 @@ public:
 
     void setAsmCount(int count) { asmInstCount = count; }
     uint32_t getAsmCount() const { return asmInstCount; }
+    void setCompactedCount(int count) { compactedInstCount = count; }
+    uint32_t getCompactedCount() const { return compactedInstCount; }
 
     void setTokenInstructionCount(int count) {tokenInstructionCount = count; }
     uint32_t getTokenInstructionCount() {return tokenInstructionCount; }
@@ -1392,6 +1405,9 @@ public:
     void calculateSimdSize();
     unsigned int getSimdSize() { return simdSize; }
 
+    void setSLMSize(uint32_t size) { slmSize = size; }
+    uint32_t getSLMSize() const { return slmSize; }
+
     void setHasAddrTaken(bool val) { hasAddrTaken = val; }
     bool getHasAddrTaken() { return hasAddrTaken;  }
 
@@ -1470,6 +1486,11 @@ public:
         relocationTable.push_back(entry);
     }
 
+    bool hasRelocations() const
+    {
+        return !relocationTable.empty();
+    }
+
     void doRelocation(void* binary, uint32_t binarySize);
 
     void addCallee(uint32_t funcId, G4_Kernel* function) { allCallees.emplace(funcId, function); }
@@ -1485,6 +1506,19 @@ public:
     }
 
 
+    void computeClobberedGRFs();
+    const std::vector<bool>& getClobberedGRFs() const { return clobberedGRFs; }
+
+    void setCalleeClobberedGRFs(uint32_t funcId, const std::vector<bool>& regs)
+    {
+        calleeClobberedGRFs[funcId] = regs;
+    }
+    const std::vector<bool>* getCalleeClobberedGRFs(uint32_t funcId) const
+    {
+        auto iter = calleeClobberedGRFs.find(funcId);
+        return iter != calleeClobberedGRFs.end() ? &iter->second : nullptr;
+    }
+
     G4_INST* getFirstNonLabelInst() const;
 
 };
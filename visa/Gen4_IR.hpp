@@ -55,11 +55,47 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 namespace vISA
 {
+    // Free lists of released single-object blocks, shared by all allocators
+    // (including rebound ones) built on the same Mem_Manager. Arena memory is
+    // never returned, so recycling erased list nodes keeps heavily spliced
+    // lists such as INST_LIST from growing the arena and keeps their nodes
+    // close together.
+    class ArenaNodeFreeList
+    {
+        static const size_t MaxNodeSize = 64;
+        static const size_t NumClasses = MaxNodeSize / sizeof(void*);
+        void* heads[NumClasses] = {};
+
+        static size_t classOf(size_t size) { return (size + sizeof(void*) - 1) / sizeof(void*) - 1; }
+
+    public:
+        static bool isRecyclable(size_t size) { return size >= sizeof(void*) && size <= MaxNodeSize; }
+
+        void* pop(size_t size)
+        {
+            void*& head = heads[classOf(size)];
+            void* p = head;
+            if (p)
+            {
+                head = *(void**)p;
+            }
+            return p;
+        }
+
+        void push(void* p, size_t size)
+        {
+            void*& head = heads[classOf(size)];
+            *(void**)p = head;
+            head = p;
+        }
+    };
+
     template <class T>
     class std_arena_based_allocator
     {
     protected:
     std::shared_ptr<Mem_Manager> mem_manager_ptr;
+    std::shared_ptr<ArenaNodeFreeList> free_list_ptr;
 
     public:
 
@@ -73,7 +109,7 @@ namespace vISA
         typedef T              value_type;
 
     explicit std_arena_based_allocator(std::shared_ptr<Mem_Manager> _other_ptr)
-            :mem_manager_ptr(_other_ptr)
+            :mem_manager_ptr(_other_ptr), free_list_ptr(std::make_shared<ArenaNodeFreeList>())
         {
         }
 
@@ -82,22 +118,24 @@ namespace vISA
         {
             //This implicitly calls Mem_manager constructor.
         mem_manager_ptr = std::make_shared<Mem_Manager>(4096);
+        free_list_ptr = std::make_shared<ArenaNodeFreeList>();
         }
 
         explicit std_arena_based_allocator(const std_arena_based_allocator& other)
-            : mem_manager_ptr(other.mem_manager_ptr)
+            : mem_manager_ptr(other.mem_manager_ptr), free_list_ptr(other.free_list_ptr)
         {}
 
 
         template <class U>
         std_arena_based_allocator(const std_arena_based_allocator<U>& other)
-            : mem_manager_ptr(other.mem_manager_ptr)
+            : mem_manager_ptr(other.mem_manager_ptr), free_list_ptr(other.free_list_ptr)
         {}
 
         template <class U>
         std_arena_based_allocator& operator=(const std_arena_based_allocator<U>& other)
         {
             mem_manager_ptr = other.mem_manager_ptr;
+            free_list_ptr = other.free_list_ptr;
             return *this;
         }
 
@@ -108,13 +146,25 @@ namespace vISA
 
         pointer allocate(size_type n, const void * = 0)
         {
+            if (n == 1 && ArenaNodeFreeList::isRecyclable(sizeof(T)))
+            {
+                if (void* p = free_list_ptr->pop(sizeof(T)))
+                {
+                    return (T*)p;
+                }
+            }
             T* t = (T*)mem_manager_ptr->alloc(n * sizeof(T));
             return t;
         }
 
-        void deallocate(void* p, size_type)
+        void deallocate(void* p, size_type n)
         {
-            //No deallocation for arena allocator.
+            // Arena memory is released all at once; only single nodes
+            // (e.g., std::list nodes) are kept for reuse.
+            if (p && n == 1 && ArenaNodeFreeList::isRecyclable(sizeof(T)))
+            {
+                free_list_ptr->push(p, sizeof(T));
+            }
         }
 
         pointer           address(reference x) const { return &x; }
@@ -664,16 +714,33 @@ class G4_INST
     friend class IR_Builder;
 
 protected:
+    // Hot fields, read by nearly every pass, come first and are packed so
+    // that they share the first cache lines of the object.
     G4_opcode        op;
+    unsigned int     option;     // inst option
     G4_Operand*      srcs[G4_MAX_SRCS];
     G4_DstRegRegion* dst;
     G4_Predicate*    predicate;
     G4_CondMod*      mod;
-    unsigned int     option;     // inst option
     G4_SendMsgDescriptor*   msgDesc;
     G4_Operand*             implAccSrc;
     G4_DstRegRegion*        implAccDst;
 
+    // instruction's id in BB. Each optimization should re-initialize before using
+    int32_t   local_id;
+    uint32_t global_id = (uint32_t) -1;
+
+    //WARNING: if adding new options, please make sure that bitfield does not
+    //overflow.
+    unsigned short sat : 1;
+    // during optimization, an inst may become redundant and be marked dead
+    unsigned short dead : 1;
+    unsigned short scratch : 1;
+    unsigned short evenlySplitInst : 1;
+    unsigned char    execSize; 
+
+    int srcCISAoff; // record CISA inst offset that resulted in this instruction
+
     // def-use chain: list of <inst, opndPos> such that this[dst/condMod] defines inst[opndPos]
     // opndNum must be one of src0, src1, src2, pred, implAccSrc
     USE_EDGE_LIST useInstList;
@@ -681,11 +748,6 @@ protected:
     // use-def chain: list of <inst, opndPos> such that inst[dst/condMod] defines this[opndPos]
     DEF_EDGE_LIST defInstList;
 
-    // instruction's id in BB. Each optimization should re-initialize before using
-    int32_t   local_id;
-
-    int srcCISAoff; // record CISA inst offset that resulted in this instruction
-
     MDLocation* location;
 
 #define UNDEFINED_GEN_OFFSET -1
@@ -693,20 +755,10 @@ protected:
 
     void emit_options(std::ostream& output);
 
-    //WARNING: if adding new options, please make sure that bitfield does not
-    //overflow.
-    unsigned short sat : 1;
-    // during optimization, an inst may become redundant and be marked dead
-    unsigned short dead : 1;
-    unsigned short scratch : 1;
-    unsigned short evenlySplitInst : 1;
-    unsigned char    execSize; 
-
     BinInst *bin;
 
     // make it private so only the IR_Builder can create new instructions
     void *operator new(size_t sz, Mem_Manager& m){ return m.alloc(sz); }
-    uint32_t global_id = (uint32_t) -1;
 
     const IR_Builder& builder;  // link to builder to access the various compilation options
 
@@ -40,6 +40,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "SpillCleanup.h"
 #include "Rematerialization.h"
 #include "RPE.h"
+#include "RegPressureReport.h"
 #include "Optimizer.h"
 #include <cmath>  // sqrt
 
@@ -359,8 +360,8 @@ void BankConflictPass::setupBankConflictsForDecls(G4_Declare * dcl_1, G4_Declare
         bank2RegNum += regNum2;
     }
 
-    gra.setBankConflict(dcl_1, bank1);
-    gra.setBankConflict(dcl_2, bank2);
+    setBank(dcl_1, bank1);
+    setBank(dcl_2, bank2);
 
     return;
 }
@@ -397,8 +398,8 @@ void BankConflictPass::setupEvenOddBankConflictsForDecls(G4_Declare * dcl_1, G4_
         }
     }
 
-    gra.setBankConflict(dcl_1, bank1);
-    gra.setBankConflict(dcl_2, bank2);
+    setBank(dcl_1, bank1);
+    setBank(dcl_2, bank2);
 
     return;
 }
@@ -471,7 +472,7 @@ void BankConflictPass::setupBankConflictsOneGRFOld(G4_INST* inst, int &bank1RegN
             {
                 bank2RegNum += regNum[i];
             }
-            gra.setBankConflict(dcls[i], srcBC[i]);
+            setBank(dcls[i], srcBC[i]);
         }
         else if (srcBC[i] != BANK_CONFLICT_NONE)
         {
@@ -502,7 +503,7 @@ void BankConflictPass::setupBankConflictsOneGRFOld(G4_INST* inst, int &bank1RegN
     {
         BankConflict bank1 = ((bank1RegNum * GRFRatio) > bank2RegNum) ? BANK_CONFLICT_SECOND_HALF_EVEN : BANK_CONFLICT_FIRST_HALF_EVEN;
 
-        gra.setBankConflict(dcls[1], bank1);
+        setBank(dcls[1], bank1);
         srcBC[1] = bank1;
         srcBC[2] = bank1;
         bank_num += bank1 * 2;
@@ -578,8 +579,8 @@ void BankConflictPass::setupBankConflictsOneGRFOld(G4_INST* inst, int &bank1RegN
             bank2RegNum += regNum[2];
         }
 
-        gra.setBankConflict(dcls[1], bank1);
-        gra.setBankConflict(dcls[2], bank2);
+        setBank(dcls[1], bank1);
+        setBank(dcls[2], bank2);
     }
     else
     {
@@ -589,7 +590,7 @@ void BankConflictPass::setupBankConflictsOneGRFOld(G4_INST* inst, int &bank1RegN
             if (srcBC[2] == BANK_CONFLICT_NONE)
             {
                 srcBC[2] = setupBankAccordingToSiblingOperand(srcBC[1], offset[2], true);
-                gra.setBankConflict(dcls[2], srcBC[2]);
+                setBank(dcls[2], srcBC[2]);
 
                 if (srcBC[2] < BANK_CONFLICT_SECOND_HALF_EVEN)
                     bank1RegNum += regNum[2];
@@ -599,7 +600,7 @@ void BankConflictPass::setupBankConflictsOneGRFOld(G4_INST* inst, int &bank1RegN
             else
             {
                 srcBC[1] = setupBankAccordingToSiblingOperand(srcBC[2], offset[1], true);
-                gra.setBankConflict(dcls[1], srcBC[1]);
+                setBank(dcls[1], srcBC[1]);
                 if (srcBC[1] < BANK_CONFLICT_SECOND_HALF_EVEN)
                     bank1RegNum += regNum[1];
                 else
@@ -784,7 +785,7 @@ void BankConflictPass::setupBankForSrc0(G4_INST* inst, G4_INST* prevInst)
                 srcBC[0] = offset[0] % 2 ? BANK_CONFLICT_SECOND_HALF_ODD : BANK_CONFLICT_FIRST_HALF_EVEN;
             }
 
-            gra.setBankConflict(dcls[0], srcBC[0]);
+            setBank(dcls[0], srcBC[0]);
         }
     }
 
@@ -828,7 +829,7 @@ void BankConflictPass::setupBankConflictsforTwoGRFs(G4_INST* inst)
         {
             unsigned int reg = src->getBase()->asRegVar()->getPhyReg()->asGreg()->getRegNum();
             srcBC[i] = ((reg + offset[i]) % 2) ? BANK_CONFLICT_SECOND_HALF_ODD : BANK_CONFLICT_FIRST_HALF_EVEN;
-            gra.setBankConflict(dcls[i], srcBC[i]);
+            setBank(dcls[i], srcBC[i]);
         }
         else if (srcBC[i] != BANK_CONFLICT_NONE)
         {
@@ -874,7 +875,7 @@ void BankConflictPass::setupBankConflictsforTwoGRFs(G4_INST* inst)
             if (execSize[i] > 32)
             {
                 srcBC[i] = offset[i] % 2 ? BANK_CONFLICT_SECOND_HALF_ODD : BANK_CONFLICT_FIRST_HALF_EVEN;
-                gra.setBankConflict(dcls[i], srcBC[i]);
+                setBank(dcls[i], srcBC[i]);
             }
         }
     }
@@ -900,7 +901,7 @@ void BankConflictPass::setupBankConflictsforTwoGRFs(G4_INST* inst)
             {
                 srcBC[2] = (srcBC[2] == BANK_CONFLICT_FIRST_HALF_EVEN) ? BANK_CONFLICT_SECOND_HALF_ODD : BANK_CONFLICT_FIRST_HALF_EVEN;
             }
-            gra.setBankConflict(dcls[2], srcBC[2]);
+            setBank(dcls[2], srcBC[2]);
         }
         else
         {
@@ -909,7 +910,7 @@ void BankConflictPass::setupBankConflictsforTwoGRFs(G4_INST* inst)
             {
                 srcBC[1] = (srcBC[1] == BANK_CONFLICT_FIRST_HALF_EVEN) ? BANK_CONFLICT_SECOND_HALF_ODD : BANK_CONFLICT_FIRST_HALF_EVEN;
             }
-            gra.setBankConflict(dcls[1], srcBC[1]);
+            setBank(dcls[1], srcBC[1]);
         }
     }
 
@@ -994,6 +995,37 @@ void BankConflictPass::setupBankConflictsForBB(G4_BB* bb,
     }
 }
 
+void BankConflictPass::setBank(G4_Declare* dcl, BankConflict bc)
+{
+    gra.setBankConflict(dcl, bc);
+    if (useBankVotes && bc != BANK_CONFLICT_NONE)
+    {
+        auto& votes = bankVotes[dcl];
+        votes[bc] += curBBWeight;
+    }
+}
+
+// Give each declare the bank most of its (weighted) 3-src uses asked for.
+// A tie keeps the bank chosen last.
+void BankConflictPass::resolveBankVotes()
+{
+    for (auto& dclVotes : bankVotes)
+    {
+        G4_Declare* dcl = dclVotes.first;
+        auto& votes = dclVotes.second;
+        BankConflict best = gra.getBankConflict(dcl);
+        for (int bc = BANK_CONFLICT_FIRST_HALF_EVEN; bc <= BANK_CONFLICT_SECOND_HALF_ODD; bc++)
+        {
+            if (votes[bc] > votes[best])
+            {
+                best = (BankConflict)bc;
+            }
+        }
+        gra.setBankConflict(dcl, best);
+    }
+    bankVotes.clear();
+}
+
 //Use for BB sorting according to the loop nest level and the BB size.
 bool compareBBLoopLevel(G4_BB* bb1, G4_BB* bb2)
 {
@@ -1032,6 +1064,8 @@ bool BankConflictPass::setupBankConflictsForKernel(G4_Kernel& kernel, bool doLoc
     }
     orderedBBs.sort(compareBBLoopLevel);
 
+    useBankVotes = kernel.getOption(vISA_GlobalBankVotes);
+
     for (BB_LIST_ITER it = orderedBBs.begin();
         it != orderedBBs.end();
         it++)
@@ -1044,6 +1078,7 @@ bool BankConflictPass::setupBankConflictsForKernel(G4_Kernel& kernel, bool doLoc
         G4_BB* bb = (*it);
         unsigned int loopNestLevel = 0;
 
+        curBBWeight = gra.getBBRefCount(bb);
         setupBankConflictsForBB(bb, threeSourceInstNum, sendInstNum,
         	                                    numRegLRA, conflicts);
         loopNestLevel = bb->getNestLevel() + 1;
@@ -1062,6 +1097,11 @@ bool BankConflictPass::setupBankConflictsForKernel(G4_Kernel& kernel, bool doLoc
         }
     }
 
+    if (useBankVotes)
+    {
+        resolveBankVotes();
+    }
+
     if (!threeSourceInstNumInKernel ||
         (float)threeSourceInstNumInKernel / instNumInKernel < BANK_CONFLICT_HEURISTIC_INST)
     {
@@ -1495,8 +1535,7 @@ bool Interference::interfereBetween(unsigned v1, unsigned v2) const
     }
     else
     {
-        auto&& set = sparseMatrix[v1];
-        return set.find(v2) != set.end();
+        return sparseMatrix[v1].isSet(v2);
     }
 }
 
@@ -1556,6 +1595,11 @@ inline void Interference::filterSplitDclares(unsigned startIdx, unsigned endIdx,
 //
 void Interference::buildInterferenceWithLive(BitSet& live, unsigned i)
 {
+    if (reuseBBIntf)
+    {
+        return;
+    }
+
     bool is_partial = lrs[i]->getIsPartialDcl();
     bool is_splitted = lrs[i]->getIsSplittedDcl();
     unsigned numDwords = 0;
@@ -1600,14 +1644,10 @@ void Interference::buildInterferenceWithLive(BitSet& live, unsigned i)
                 filterSplitDclares(start_idx, end_idx, n, k, elt, is_partial);
             }
 
-            for (unsigned int j = 0; j < BITS_DWORD; j++)
+            forEachSetBit(elt, k * BITS_DWORD, [&](unsigned curPos)
             {
-                if (elt & BitMask[j])
-                {
-                    unsigned curPos = j + (k*BITS_DWORD);
-                    safeSetInterference(curPos, i);
-                }
-            }
+                safeSetInterference(curPos, i);
+            });
         }
     }
 
@@ -1616,17 +1656,13 @@ void Interference::buildInterferenceWithLive(BitSet& live, unsigned i)
     //checkAndSetIntf gaurantee partial and splitted cases
     if (elt != 0)
     {
-        for (unsigned int j = 0; j < BITS_DWORD; j++)
+        forEachSetBit(elt, colEnd * BITS_DWORD, [&](unsigned curPos)
         {
-            if (elt & BitMask[j])
+            if (!varSplitCheckBeforeIntf(i, curPos))
             {
-                unsigned curPos = j + (colEnd*BITS_DWORD);
-                if (!varSplitCheckBeforeIntf(i, curPos))
-                {
-                    checkAndSetIntf(i, curPos);
-                }
+                checkAndSetIntf(i, curPos);
             }
-        }
+        });
     }
 
     colEnd++;
@@ -1888,12 +1924,74 @@ uint32_t GlobalRA::getRefCount(int loopNestLevel)
     return (uint32_t)std::pow(IN_LOOP_REFERENCE_COUNT_FACTOR, std::min(loopNestLevel, 8));
 }
 
+// Reference count weight of one access in bb. A profiled block is weighted by
+// its execution count relative to the entry block, expressed as the loop nest
+// level that would give the same weight; other blocks use the static nesting.
+uint32_t GlobalRA::getBBRefCount(G4_BB* bb) const
+{
+    auto it = bbProfileLevel.find(bb->getId());
+    if (it != bbProfileLevel.end())
+    {
+        return getRefCount(it->second);
+    }
+    return getRefCount(kernel.getOption(vISA_ConsiderLoopInfoInRA) ? bb->getNestLevel() : 0);
+}
+
+void GlobalRA::loadProfileFeedback(const char* fileName)
+{
+    std::ifstream profile(fileName);
+    if (!profile)
+    {
+        return;
+    }
+
+    std::map<unsigned, uint64_t> counts;
+    unsigned bbId = 0;
+    uint64_t count = 0;
+    while (profile >> bbId >> count)
+    {
+        counts[bbId] = count;
+    }
+
+    // Normalize to the entry block; fall back to the coldest block with a
+    // non-zero count if the entry was not instrumented.
+    uint64_t baseCount = 0;
+    auto entryIt = counts.find(kernel.fg.getEntryBB()->getId());
+    if (entryIt != counts.end())
+    {
+        baseCount = entryIt->second;
+    }
+    if (baseCount == 0)
+    {
+        for (auto& c : counts)
+        {
+            if (c.second != 0 && (baseCount == 0 || c.second < baseCount))
+            {
+                baseCount = c.second;
+            }
+        }
+    }
+    if (baseCount == 0)
+    {
+        return;
+    }
+
+    for (auto& c : counts)
+    {
+        int level = 0;
+        if (c.second > baseCount)
+        {
+            level = (int)(std::log((double)c.second / baseCount) / std::log((double)IN_LOOP_REFERENCE_COUNT_FACTOR));
+        }
+        bbProfileLevel[c.first] = std::min(level, 8);
+    }
+}
+
 // handle return value interference for fcall
 void Interference::buildInterferenceForFcall(G4_BB* bb, BitSet& live, G4_INST* inst, std::list<G4_INST*>::reverse_iterator i, G4_VarBase* regVar)
 {
     assert(inst->opcode() == G4_pseudo_fcall && "expect fcall inst");
-    unsigned refCount = GlobalRA::getRefCount(kernel.getOption(vISA_ConsiderLoopInfoInRA) ?
-        bb->getNestLevel() : 0);
+    unsigned refCount = gra.getBBRefCount(bb);
 
     if (regVar->isRegAllocPartaker())
     {
@@ -1914,8 +2012,7 @@ bool GlobalRA::isReRAPass()
 
 void Interference::buildInterferenceForDst(G4_BB* bb, BitSet& live, G4_INST* inst, std::list<G4_INST*>::reverse_iterator i, G4_DstRegRegion* dst)
 {
-    unsigned refCount = GlobalRA::getRefCount(kernel.getOption(vISA_ConsiderLoopInfoInRA) ?
-        bb->getNestLevel() : 0);
+    unsigned refCount = gra.getBBRefCount(bb);
 
     if (dst->getBase()->isRegAllocPartaker())
     {
@@ -2131,8 +2228,7 @@ void Interference::buildInterferenceForDst(G4_BB* bb, BitSet& live, G4_INST* ins
 void Interference::buildInterferenceWithinBB(G4_BB* bb, BitSet& live, G4_Declare* arg, G4_Declare* ret)
 {
     DebugInfoState state(kernel.fg.mem);
-    unsigned refCount = GlobalRA::getRefCount(kernel.getOption(vISA_ConsiderLoopInfoInRA) ?
-        bb->getNestLevel() : 0);
+    unsigned refCount = gra.getBBRefCount(bb);
 
     for (std::list<G4_INST*>::reverse_iterator i = bb->rbegin();
         i != bb->rend();
@@ -2348,8 +2444,20 @@ void Interference::computeInterference()
     G4_Declare* arg = kernel.fg.builder->getStackCallArg();
     G4_Declare* ret = kernel.fg.builder->getStackCallRet();
 
+    // Start from the interference of the previous RA iteration if there is one;
+    // only the basic blocks changed by its spill code need to be walked for
+    // interference again.
+    std::vector<bool> reuseBB;
+    IntfSnapshot& snap = gra.getIntfSnapshot();
+    if (snap.valid)
+    {
+        seedFromSnapshot(snap, reuseBB);
+        snap.clear();
+    }
+
     for (BB_LIST_ITER it = kernel.fg.BBs.begin(); it != kernel.fg.BBs.end(); it++)
     {
+        reuseBBIntf = !reuseBB.empty() && reuseBB[(*it)->getId()];
         //
         // mark all live ranges dead
         //
@@ -2364,6 +2472,7 @@ void Interference::computeInterference()
 
         buildInterferenceWithinBB((*it), live, arg, ret);
     }
+    reuseBBIntf = false;
 
     if (kernel.fg.getHasStackCalls() == true)
     {
@@ -2429,6 +2538,177 @@ void Interference::computeInterference()
     generateSparseIntfGraph();
 }
 
+//
+// Record the interference graph, with spilled variables removed, so that the
+// next RA iteration can reuse it for the code that spilling leaves untouched.
+//
+void Interference::saveSnapshot(IntfSnapshot& snap, const LIVERANGE_LIST& spilledLRs) const
+{
+    snap.clear();
+
+    unsigned numVars = (unsigned)sparseIntf.size();
+    snap.dcls.resize(numVars);
+    for (unsigned i = 0; i < numVars; i++)
+    {
+        snap.dcls[i] = lrs[i]->getDcl();
+    }
+    for (auto lr : spilledLRs)
+    {
+        snap.dcls[lr->getVar()->getId()] = nullptr;
+    }
+
+    for (unsigned v1 = 0; v1 < numVars; v1++)
+    {
+        if (snap.dcls[v1] == nullptr)
+        {
+            continue;
+        }
+        for (unsigned v2 : sparseIntf[v1])
+        {
+            if (v1 < v2 && snap.dcls[v2] != nullptr)
+            {
+                snap.edges.emplace_back(v1, v2);
+            }
+        }
+    }
+
+    unsigned numBB = kernel.fg.getNumBB();
+    snap.liveAtExit.resize(numBB);
+    snap.numLiveAtExit.resize(numBB, 0);
+    for (auto bb : kernel.fg.BBs)
+    {
+        unsigned bbId = bb->getId();
+        BitSet& live = snap.liveAtExit[bbId];
+        live = liveAnalysis->use_out[bbId];
+        live &= liveAnalysis->def_out[bbId];
+
+        unsigned count = 0;
+        live.forEach([&](unsigned id)
+        {
+            if (id < numVars && snap.dcls[id] != nullptr)
+            {
+                count++;
+            }
+        });
+        snap.numLiveAtExit[bbId] = count;
+    }
+
+    snap.valid = true;
+}
+
+//
+// A basic block keeps the interference it had in the snapshot if it references
+// no variable created or spilled since, and the variables live at its exit are
+// the same, except for the spilled ones.
+//
+bool Interference::isBBUnchanged(G4_BB* bb, const IntfSnapshot& snap, const std::vector<unsigned>& newToOld) const
+{
+    auto isNewVar = [&newToOld](G4_VarBase* base)
+    {
+        return base->isRegAllocPartaker() && newToOld[base->asRegVar()->getId()] == UINT_MAX;
+    };
+
+    for (auto inst : *bb)
+    {
+        G4_DstRegRegion* dst = inst->getDst();
+        if (dst && isNewVar(dst->getBase()))
+        {
+            return false;
+        }
+        for (unsigned j = 0; j < G4_MAX_SRCS; j++)
+        {
+            G4_Operand* src = inst->getSrc(j);
+            if (src && src->isSrcRegRegion() && isNewVar(src->asSrcRegRegion()->getBase()))
+            {
+                return false;
+            }
+        }
+    }
+
+    unsigned bbId = bb->getId();
+    const BitSet& oldLive = snap.liveAtExit[bbId];
+    const BitSet& useOut = liveAnalysis->use_out[bbId];
+    const BitSet& defOut = liveAnalysis->def_out[bbId];
+    unsigned count = 0;
+    bool same = true;
+    for (unsigned i = 0; i < maxId && same; i += BITS_DWORD)
+    {
+        unsigned elt = useOut.getElt(i / BITS_DWORD) & defOut.getElt(i / BITS_DWORD);
+        forEachSetBit(elt, i, [&](unsigned id)
+        {
+            unsigned oldId = id < maxId ? newToOld[id] : UINT_MAX;
+            if (oldId == UINT_MAX || !oldLive.isSet(oldId))
+            {
+                same = false;
+            }
+            count++;
+        });
+    }
+
+    return same && count == snap.numLiveAtExit[bbId];
+}
+
+//
+// Set the edges of the snapshot among the variables that still exist, and
+// compute for each basic block whether walking it can be skipped.
+//
+void Interference::seedFromSnapshot(const IntfSnapshot& snap, std::vector<bool>& reuseBB)
+{
+    if (!liveAnalysis->livenessClass(G4_GRF) ||
+        snap.liveAtExit.size() != kernel.fg.getNumBB())
+    {
+        return;
+    }
+
+    std::unordered_map<G4_Declare*, unsigned> oldIds;
+    oldIds.reserve(snap.dcls.size());
+    for (unsigned i = 0, e = (unsigned)snap.dcls.size(); i < e; i++)
+    {
+        if (snap.dcls[i] != nullptr)
+        {
+            oldIds[snap.dcls[i]] = i;
+        }
+    }
+
+    std::vector<unsigned> newToOld(maxId, UINT_MAX);
+    std::vector<unsigned> oldToNew(snap.dcls.size(), UINT_MAX);
+    for (unsigned i = 0; i < maxId; i++)
+    {
+        auto it = oldIds.find(lrs[i]->getDcl());
+        if (it != oldIds.end())
+        {
+            newToOld[i] = it->second;
+            oldToNew[it->second] = i;
+        }
+    }
+
+    for (auto& edge : snap.edges)
+    {
+        unsigned v1 = oldToNew[edge.first];
+        unsigned v2 = oldToNew[edge.second];
+        if (v1 != UINT_MAX && v2 != UINT_MAX)
+        {
+            checkAndSetIntf(v1, v2);
+        }
+    }
+
+    unsigned numReused = 0;
+    reuseBB.resize(kernel.fg.getNumBB(), false);
+    for (auto bb : kernel.fg.BBs)
+    {
+        if (isBBUnchanged(bb, snap, newToOld))
+        {
+            reuseBB[bb->getId()] = true;
+            numReused++;
+        }
+    }
+
+    if (builder.getOption(vISA_RATrace))
+    {
+        std::cout << "\t--reused interference of " << numReused << " of " << kernel.fg.BBs.size() << " BBs\n";
+    }
+}
+
 #define SPARSE_INTF_VEC_SIZE 64
 
 void Interference::generateSparseIntfGraph()
@@ -2438,13 +2718,13 @@ void Interference::generateSparseIntfGraph()
 
     sparseIntf.resize(numVars);
 
-    for (unsigned int row = 0; row < numVars; row++)
-    {
-        sparseIntf[row].reserve(SPARSE_INTF_VEC_SIZE);
-    }
-
     if (useDenseMatrix())
     {
+        for (unsigned int row = 0; row < numVars; row++)
+        {
+            sparseIntf[row].reserve(SPARSE_INTF_VEC_SIZE);
+        }
+
         // Iterate over intf graph matrix
         for (unsigned int row = 0; row < numVars; row++)
         {
@@ -2453,34 +2733,43 @@ void Interference::generateSparseIntfGraph()
             for (unsigned int j = colStart; j < getRowSize(); j++)
             {
                 unsigned int intfBlk = getInterferenceBlk(rowOffset + j);
-                if (intfBlk != 0)
+                forEachSetBit(intfBlk, j * BITS_DWORD, [&](unsigned int v2)
                 {
-                    for (unsigned k = 0; k < BITS_DWORD; k++)
+                    if (v2 != row)
                     {
-                        if (intfBlk & BitMask[k])
-                        {
-                            unsigned int v2 = (j*BITS_DWORD) + k;
-                            if (v2 != row)
-                            {
-                                sparseIntf[v2].push_back(row);
-                                sparseIntf[row].push_back(v2);
-                            }
-                        }
+                        sparseIntf[v2].push_back(row);
+                        sparseIntf[row].push_back(v2);
                     }
-                }
+                });
             }
         }
     }
     else
     {
+        // Count the degrees first so that each neighbor list is allocated
+        // once at its exact size; this graph is only built for very large
+        // kernels where over-reserving adds up.
+        std::vector<uint32_t> degree(numVars, 0);
+        for (uint32_t v1 = 0; v1 < maxId; ++v1)
+        {
+            sparseMatrix[v1].forEach([&](uint32_t v2)
+            {
+                ++degree[v1];
+                ++degree[v2];
+            });
+        }
+        for (unsigned int row = 0; row < numVars; row++)
+        {
+            sparseIntf[row].reserve(degree[row]);
+        }
+
         for (uint32_t v1 = 0; v1 < maxId; ++v1)
         {
-            auto&& intfSet = sparseMatrix[v1];
-            for (uint32_t v2 : intfSet)
+            sparseMatrix[v1].forEach([&](uint32_t v2)
             {
                 sparseIntf[v1].push_back(v2);
                 sparseIntf[v2].push_back(v1);
-            }
+            });
         }
     }
 
@@ -5017,6 +5306,8 @@ GraphColor::GraphColor(LivenessAnalysis& live, unsigned totalGRF, bool hybrid, b
     evenTotalRegNum = 1;
     oddMaxRegNum = 1;
     evenMaxRegNum = 1;
+    // live ranges are the bulk of what is allocated here
+    mem.setSizeHint(numVar * (sizeof(LiveRange) + sizeof(LiveRange*)));
     spAddrRegSig = (unsigned*)mem.alloc(getNumAddrRegisters() * sizeof(unsigned));
     m_options = builder.getOptions();
 }
@@ -5154,11 +5445,93 @@ void GraphColor::computeDegreeForARF()
     }
 }
 
+//
+// Mark the live ranges whose value remat can recompute at the uses without
+// extending any other live range: a single def computed only from immediates
+// and input (payload) registers, e.g., constants, address arithmetic on thread
+// payload and sampler headers built from r0, with few enough uses to make
+// recomputation cheaper than a scratch fill at each of them.
+//
+void GraphColor::computeCheapRemat()
+{
+    cheapRemat.assign(numVar, false);
+    std::vector<unsigned> numDefs(numVar, 0);
+    std::vector<unsigned> numUses(numVar, 0);
+
+    auto isCheapDef = [](G4_INST* inst)
+    {
+        if (inst->isSend() || inst->isMath() || inst->isFlowControl() ||
+            inst->getPredicate() || inst->getCondMod() ||
+            inst->isAccDstInst() || inst->isAccSrcInst() ||
+            inst->getImplAccDst() || inst->getImplAccSrc())
+        {
+            return false;
+        }
+
+        for (unsigned i = 0; i < G4_MAX_SRCS; i++)
+        {
+            G4_Operand* src = inst->getSrc(i);
+            if (!src || src->isImm() || src->isNullReg())
+            {
+                continue;
+            }
+
+            G4_Declare* srcDcl = src->isSrcRegRegion() ? src->getTopDcl() : nullptr;
+            if (!srcDcl || !srcDcl->isInput() || srcDcl->getAddressed() ||
+                src->asSrcRegRegion()->isIndirect())
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    for (auto bb : kernel.fg.BBs)
+    {
+        for (auto inst : *bb)
+        {
+            if (inst->isPseudoKill() || inst->isLifeTimeEnd())
+            {
+                continue;
+            }
+
+            for (unsigned i = 0; i < G4_MAX_SRCS; i++)
+            {
+                G4_Operand* src = inst->getSrc(i);
+                G4_Declare* srcDcl = (src && src->isSrcRegRegion()) ? src->getTopDcl() : nullptr;
+                if (srcDcl && srcDcl->getRegVar()->isRegAllocPartaker())
+                {
+                    numUses[srcDcl->getRegVar()->getId()]++;
+                }
+            }
+
+            G4_DstRegRegion* dst = inst->getDst();
+            G4_Declare* dstDcl = dst ? dst->getTopDcl() : nullptr;
+            if (dstDcl && dstDcl->getRegVar()->isRegAllocPartaker())
+            {
+                unsigned id = dstDcl->getRegVar()->getId();
+                cheapRemat[id] = ++numDefs[id] == 1 && !dstDcl->getAddressed() &&
+                    !dst->isIndirect() && isCheapDef(inst);
+            }
+        }
+    }
+
+    for (unsigned i = 0; i < numVar; i++)
+    {
+        cheapRemat[i] = cheapRemat[i] && numUses[i] <= MAX_USES_REMAT;
+    }
+}
+
 void GraphColor::computeSpillCosts(bool useSplitLLRHeuristic)
 {
     std::vector <LiveRange *> addressSensitiveVars;
     float maxNormalCost = 0.0f;
 
+    if (rematAwareSpillCost && cheapRemat.empty())
+    {
+        computeCheapRemat();
+    }
+
     for (unsigned i = 0; i < numVar; i++)
     {
         G4_Declare* dcl = lrs[i]->getDcl();
@@ -5242,6 +5615,12 @@ void GraphColor::computeSpillCosts(bool useSplitLLRHeuristic)
                     lrs[i]->getDegree() : 1.0f*lrs[i]->getRefCount()*lrs[i]->getRefCount() / (lrs[i]->getDegree() + 1);
             }
 
+            // Remat will recompute this range at its uses instead of filling it.
+            if (rematAwareSpillCost && cheapRemat[i])
+            {
+                spillCost *= REMATSPILLCOSTSCALE;
+            }
+
             lrs[i]->setSpillCost(spillCost);
 
             // Track address sensitive live range.
@@ -5549,6 +5928,68 @@ void PhyRegUsage::updateRegUsage(LiveRange* lr)
     }
 }
 
+//
+// Record the variable pairs connected by a raw mov whose dst and src are at
+// the same offset in their declares. If both get the same registers, the mov
+// is removed by removeRedundMov after RA.
+//
+void GraphColor::computeCopyPartners()
+{
+    copyPartners.resize(numVar);
+    std::vector<std::map<unsigned, unsigned>> numCopies(numVar);
+
+    auto getVarId = [](G4_Operand* opnd) -> int
+    {
+        G4_Declare* dcl = opnd->getTopDcl();
+        if (dcl && dcl->getRegFile() == G4_GRF && !dcl->getAddressed() &&
+            dcl->getRegVar()->isRegAllocPartaker())
+        {
+            return (int)dcl->getRegVar()->getId();
+        }
+        return -1;
+    };
+
+    for (auto bb : kernel.fg.BBs)
+    {
+        for (auto inst : *bb)
+        {
+            if (!inst->isRawMov() || !inst->getSrc(0)->isSrcRegRegion())
+            {
+                continue;
+            }
+
+            G4_DstRegRegion* dst = inst->getDst();
+            G4_SrcRegRegion* src = inst->getSrc(0)->asSrcRegRegion();
+            if (dst->isIndirect() || src->isIndirect() ||
+                dst->getLeftBound() != src->getLeftBound())
+            {
+                continue;
+            }
+
+            int dstId = getVarId(dst);
+            int srcId = getVarId(src);
+            if (dstId < 0 || srcId < 0 || dstId == srcId ||
+                lrs[dstId]->getIsPartialDcl() || lrs[srcId]->getIsPartialDcl())
+            {
+                continue;
+            }
+
+            numCopies[dstId][srcId]++;
+            numCopies[srcId][dstId]++;
+        }
+    }
+
+    for (unsigned i = 0; i < numVar; i++)
+    {
+        for (auto& copy : numCopies[i])
+        {
+            copyPartners[i].push_back(copy.first);
+        }
+        std::stable_sort(copyPartners[i].begin(), copyPartners[i].end(),
+            [&](unsigned p1, unsigned p2) { return numCopies[i][p1] > numCopies[i][p2]; });
+    }
+}
+
 bool GraphColor::assignColors(ColorHeuristic colorHeuristicGRF, bool doBankConflict, bool highInternalConflict)
 {
     if (builder.getOption(vISA_RATrace))
@@ -5602,6 +6043,13 @@ bool GraphColor::assignColors(ColorHeuristic colorHeuristicGRF, bool doBankConfl
         doBankConflict, availableGregs, availableSubRegs, availableAddrs, availableFlags, weakEdgeUsage);
     bool noIndirForceSpills = builder.getOption(vISA_NoIndirectForceSpills);
 
+    bool useCopyBias = rFile == G4_GRF && !allocFromBanks &&
+        builder.getOption(vISA_CopyCoalesceBias);
+    if (useCopyBias && copyPartners.empty())
+    {
+        computeCopyPartners();
+    }
+
     // colorOrder is in reverse order (unconstrained at front)
     for (auto iter = colorOrder.rbegin(), iterEnd = colorOrder.rend(); iter != iterEnd; ++iter)
     {
@@ -5722,8 +6170,30 @@ bool GraphColor::assignColors(ColorHeuristic colorHeuristicGRF, bool doBankConfl
                 }
                 else
                 {
-                    failed_alloc |= !regUsage.assignRegs(highInternalConflict, lr, lr->getForbidden(),
-                        lrVar->getAlignment(), lrVar->getSubRegAlignment(), heuristic, lr->getSpillCost());
+                    // Biased coloring: take the registers of a copy partner if
+                    // they are free.
+                    bool assigned = false;
+                    if (useCopyBias && lr->getRegKind() == G4_GRF)
+                    {
+                        for (auto partner : copyPartners[lr_id])
+                        {
+                            LiveRange* partnerLR = lrs[partner];
+                            G4_VarBase* partnerReg = partnerLR->getPhyReg();
+                            if (partnerReg && partnerReg->isGreg() && partnerLR->getPhyRegOff() == 0 &&
+                                regUsage.assignPreferredGRF(lr, lr->getForbidden(), lrVar->getAlignment(),
+                                    partnerReg->asGreg()->getRegNum()))
+                            {
+                                assigned = true;
+                                break;
+                            }
+                        }
+                    }
+
+                    if (!assigned)
+                    {
+                        failed_alloc |= !regUsage.assignRegs(highInternalConflict, lr, lr->getForbidden(),
+                            lrVar->getAlignment(), lrVar->getSubRegAlignment(), heuristic, lr->getSpillCost());
+                    }
                 }
             }
 
@@ -7088,6 +7558,18 @@ void GraphColor::addCallerSaveRestoreCode()
             ASSERT_USER((*it)->Succs.size() == 1, "fcall basic block cannot have more than 1 successor");
             G4_BB* afterFCallBB = (*it)->Succs.front();
 
+            // with IPA caller save, a direct callee compiled earlier tells us which
+            // caller-save GRFs it really writes; the rest survive the call untouched
+            const std::vector<bool>* calleeClobbers = nullptr;
+            if (m_options->getOption(vISA_IPACallerSave) && !callInst->asCFInst()->isIndirectCall())
+            {
+                calleeClobbers = kernel.getCalleeClobberedGRFs(callInst->asCFInst()->getCalleeIndex());
+                if (calleeClobbers && calleeClobbers->size() != callerSaveNumGRF)
+                {
+                    calleeClobbers = nullptr;
+                }
+            }
+
             for (unsigned i = 0; i < numVar; i++)
             {
                 if (i != pseudoVCAId &&
@@ -7114,7 +7596,7 @@ void GraphColor::addCallerSaveRestoreCode()
                                     retRegs[j] = true;
                                 }
                             }
-                            else
+                            else if (!calleeClobbers || (*calleeClobbers)[j])
                             {
                                 if (callerSaveRegs[j] == false)
                                 {
@@ -8884,6 +9366,195 @@ void VarSplit::globalSplit(IR_Builder& builder, G4_Kernel &kernel)
     return;
 }
 
+//
+// Split variables that are live through a loop but not referenced in it at
+// the loop boundary: copy the variable to a new one in the preheader and back
+// at each loop exit. The copy is live only across the loop and has its only
+// references outside of it, so it is a cheap spill candidate; spilling it
+// costs one spill before and one fill after the loop while the registers it
+// held become available to the values used inside the loop.
+// Only loops that reference a variable spilled by the failed coloring are
+// considered, and each variable is split at most once, around the outermost
+// such loop. Returns true if the IR was changed.
+//
+bool VarSplit::loopSplit(IR_Builder& builder, const LivenessAnalysis& liveAnalysis, const LIVERANGE_LIST& spilledLRs)
+{
+    unsigned numVar = (unsigned)liveAnalysis.vars.size();
+    std::vector<bool> isSpilled(numVar, false);
+    for (auto lr : spilledLRs)
+    {
+        isSpilled[lr->getVar()->getId()] = true;
+    }
+
+    // Outer loops first so a variable is split around the largest loop it
+    // lives through.
+    std::vector<std::pair<G4_BB*, const std::set<G4_BB*>*>> loops;
+    for (auto& loop : kernel.fg.naturalLoops)
+    {
+        loops.push_back(std::make_pair(loop.first.second, &loop.second));
+    }
+    std::sort(loops.begin(), loops.end(),
+        [](const std::pair<G4_BB*, const std::set<G4_BB*>*>& l1, const std::pair<G4_BB*, const std::set<G4_BB*>*>& l2)
+    {
+        return l1.second->size() != l2.second->size() ?
+            l1.second->size() > l2.second->size() : l1.first->getId() < l2.first->getId();
+    });
+
+    auto getId = [](G4_Operand* opnd) -> int
+    {
+        G4_Declare* dcl = opnd ? opnd->getTopDcl() : nullptr;
+        if (dcl && dcl->getRegVar()->isRegAllocPartaker())
+        {
+            return (int)dcl->getRegVar()->getId();
+        }
+        return -1;
+    };
+
+    std::vector<bool> isSplit(numVar, false);
+    bool changed = false;
+    for (auto& loop : loops)
+    {
+        G4_BB* header = loop.first;
+        const std::set<G4_BB*>& loopBBs = *loop.second;
+
+        // Need a preheader to copy out in and exits that are only reached
+        // from the loop to copy back in.
+        G4_BB* preheader = nullptr;
+        for (auto pred : header->Preds)
+        {
+            if (loopBBs.find(pred) == loopBBs.end())
+            {
+                preheader = preheader ? nullptr : pred;
+                if (!preheader)
+                {
+                    break;
+                }
+            }
+        }
+        if (!preheader || preheader->Succs.size() != 1)
+        {
+            continue;
+        }
+
+        std::vector<G4_BB*> exits;
+        bool dedicatedExits = true;
+        for (auto bb : loopBBs)
+        {
+            for (auto succ : bb->Succs)
+            {
+                if (loopBBs.find(succ) != loopBBs.end() ||
+                    std::find(exits.begin(), exits.end(), succ) != exits.end())
+                {
+                    continue;
+                }
+                for (auto pred : succ->Preds)
+                {
+                    dedicatedExits &= loopBBs.find(pred) != loopBBs.end();
+                }
+                exits.push_back(succ);
+            }
+        }
+        if (!dedicatedExits || exits.empty())
+        {
+            continue;
+        }
+
+        std::vector<bool> refInLoop(numVar, false);
+        bool hasSpillInLoop = false;
+        for (auto bb : loopBBs)
+        {
+            for (auto inst : *bb)
+            {
+                int id = getId(inst->getDst());
+                if (id >= 0)
+                {
+                    refInLoop[id] = true;
+                    hasSpillInLoop |= isSpilled[id];
+                }
+                for (unsigned i = 0; i < G4_MAX_SRCS; i++)
+                {
+                    G4_Operand* src = inst->getSrc(i);
+                    id = (src && src->isSrcRegRegion()) ? getId(src) : -1;
+                    if (id >= 0)
+                    {
+                        refInLoop[id] = true;
+                        hasSpillInLoop |= isSpilled[id];
+                    }
+                }
+            }
+        }
+        if (!hasSpillInLoop)
+        {
+            continue;
+        }
+
+        for (unsigned id = 0; id < numVar; id++)
+        {
+            G4_RegVar* var = liveAnalysis.vars[id];
+            G4_Declare* dcl = var->getDeclare();
+            unsigned numElems = dcl->getTotalElems();
+            if (isSplit[id] || refInLoop[id] ||
+                !liveAnalysis.isLiveAtEntry(header, id) ||
+                dcl->getAliasDeclare() || dcl->getAddressed() || dcl->isInput() ||
+                dcl->getRegFile() != G4_GRF || dcl->isDoNotSpill() ||
+                var->getPhyReg() || var->isRegVarTransient() || var->isRegVarTmp() ||
+                kernel.fg.isPseudoDcl(dcl) || dcl == builder.getBuiltinR0() ||
+                dcl->getElemSize() > 4 || dcl->getByteSize() > 2 * G4_GRF_REG_NBYTES ||
+                numElems > 16 || (numElems & (numElems - 1)) != 0)
+            {
+                continue;
+            }
+
+            bool liveAtExit = false;
+            for (auto exit : exits)
+            {
+                liveAtExit |= liveAnalysis.isLiveAtEntry(exit, id);
+            }
+            if (!liveAtExit)
+            {
+                continue;
+            }
+
+            const char* name = builder.getNameString(builder.mem, 32, "%s_loopSplit", dcl->getName());
+            G4_Declare* splitDcl = builder.createDeclareNoLookup(name, G4_GRF,
+                dcl->getNumElems(), dcl->getNumRows(), dcl->getElemType());
+            splitDcl->setAlign(dcl->getAlign());
+            splitDcl->setSubRegAlign(dcl->getSubRegAlign());
+
+            auto createCopy = [&](G4_Declare* dstDcl, G4_Declare* srcDcl)
+            {
+                G4_DstRegRegion* dst = builder.Create_Dst_Opnd_From_Dcl(dstDcl, 1);
+                G4_SrcRegRegion* src = builder.Create_Src_Opnd_From_Dcl(srcDcl,
+                    numElems == 1 ? builder.getRegionScalar() : builder.getRegionStride1());
+                return builder.createInternalInst(nullptr, G4_mov, nullptr, false,
+                    (unsigned char)numElems, dst, src, nullptr, InstOpt_WriteEnable);
+            };
+
+            INST_LIST_ITER insertPos = preheader->end();
+            if (!preheader->empty() && preheader->back()->isFlowControl())
+            {
+                --insertPos;
+            }
+            preheader->insert(insertPos, createCopy(splitDcl, dcl));
+
+            for (auto exit : exits)
+            {
+                if (liveAnalysis.isLiveAtEntry(exit, id))
+                {
+                    auto exitPos = std::find_if(exit->begin(), exit->end(),
+                        [](G4_INST* inst) { return !inst->isLabel(); });
+                    exit->insert(exitPos, createCopy(dcl, splitDcl));
+                }
+            }
+
+            isSplit[id] = true;
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
 void VarSplit::localSplit(IR_Builder& builder,
     G4_BB* bb)
 {
@@ -9232,6 +9903,7 @@ void GlobalRA::flagRegAlloc()
 #ifdef DEBUG_VERBOSE_ON
                 printf("FLAG Spill inst count: %d\n", spillFlag.getNumFlagSpillStore());
                 printf("FLAG Fill inst count: %d\n", spillFlag.getNumFlagSpillLoad());
+                printf("FLAG Remat inst count: %d\n", spillFlag.getNumFlagRemat());
                 printf("*************************\n");
 #endif
                 flagSpillId = spillFlag.getNextTempDclId();
@@ -9455,6 +10127,98 @@ bool GlobalRA::hybridRA(bool doBankConflictReduction, bool highInternalConflict,
 //
 // graph coloring entry point.  returns nonzero if RA fails
 //
+//
+// Print how the GRF variables of the kernel split into variables referenced
+// within a single outermost natural loop and variables crossing loop
+// boundaries. Variables local to a loop can only interfere with variables
+// referenced in the same loop, so this is the share of the interference
+// graph that a region-based allocator could color separately per region.
+//
+void GlobalRA::reportRegionLocality()
+{
+    // Map each block to the header of the outermost loop containing it. For
+    // a reducible CFG the outermost loop is the one with the largest body.
+    std::map<G4_BB*, std::pair<size_t, G4_BB*>> outerLoop;
+    for (auto&& loop : kernel.fg.naturalLoops)
+    {
+        G4_BB* head = loop.first.second;
+        for (auto bb : loop.second)
+        {
+            auto it = outerLoop.find(bb);
+            if (it == outerLoop.end() || it->second.first < loop.second.size())
+            {
+                outerLoop[bb] = std::make_pair(loop.second.size(), head);
+            }
+        }
+    }
+
+    // The region of a variable is the loop header of all its references,
+    // nullptr for references outside loops, or crossRegion if they differ.
+    G4_BB* const crossRegion = reinterpret_cast<G4_BB*>(-1);
+    std::map<G4_Declare*, G4_BB*> dclRegion;
+    auto addRef = [&](G4_Operand* opnd, G4_BB* region)
+    {
+        if (!opnd || !opnd->isRegRegion() || !opnd->getBase() ||
+            !opnd->getBase()->isRegAllocPartaker())
+        {
+            return;
+        }
+        G4_Declare* dcl = GetTopDclFromRegRegion(opnd);
+        if (!dcl || dcl->getRegFile() != G4_GRF)
+        {
+            return;
+        }
+        auto it = dclRegion.find(dcl);
+        if (it == dclRegion.end())
+        {
+            dclRegion[dcl] = region;
+        }
+        else if (it->second != region)
+        {
+            it->second = crossRegion;
+        }
+    };
+
+    for (auto bb : kernel.fg.BBs)
+    {
+        auto it = outerLoop.find(bb);
+        G4_BB* region = it == outerLoop.end() ? nullptr : it->second.second;
+        for (auto inst : *bb)
+        {
+            addRef(inst->getDst(), region);
+            for (int i = 0; i < G4_MAX_SRCS; i++)
+            {
+                addRef(inst->getSrc(i), region);
+            }
+        }
+    }
+
+    std::map<G4_BB*, unsigned> numLocals;
+    unsigned numCross = 0, numOutside = 0;
+    for (auto&& dr : dclRegion)
+    {
+        if (dr.second == crossRegion)
+        {
+            numCross++;
+        }
+        else if (dr.second == nullptr)
+        {
+            numOutside++;
+        }
+        else
+        {
+            numLocals[dr.second]++;
+        }
+    }
+
+    std::cout << "\t--region locality: " << dclRegion.size() << " GRF variables, "
+        << numCross << " cross-region, " << numOutside << " outside loops\n";
+    for (auto&& nl : numLocals)
+    {
+        std::cout << "\t\tloop BB" << nl.first->getId() << ": " << nl.second << " local\n";
+    }
+}
+
 int GlobalRA::coloringRegAlloc()
 {
     if (kernel.getOption(vISA_OptReport))
@@ -9527,6 +10291,11 @@ int GlobalRA::coloringRegAlloc()
         }
     }
 
+    if (builder.getOption(vISA_RATrace))
+    {
+        reportRegionLocality();
+    }
+
     startTimer(TIMER_GRF_GLOBAL_RA);
     unsigned maxRAIterations = 10;
     unsigned iterationNo = 0;
@@ -9627,6 +10396,18 @@ int GlobalRA::coloringRegAlloc()
             rpe.run();
             GraphColor coloring(liveAnalysis, kernel.getNumRegTotal(), false, forceSpill);
 
+            bool runRemat = kernel.getOptions()->getTarget() == VISA_CM ? true :
+                kernel.getSimdSize() < 32;
+            // -noremat takes precedence over -forceremat
+            bool rematOff = !kernel.getOption(vISA_Debug) &&
+                (!kernel.getOption(vISA_NoRemat) || kernel.getOption(vISA_FastSpill)) &&
+                (kernel.getOption(vISA_ForceRemat) || runRemat);
+
+            // If this coloring fails, remat runs on its spilled ranges, so let
+            // the spill decision favor ranges remat can recompute.
+            coloring.setRematAwareSpillCost(builder.getOption(vISA_RematSpillCost) &&
+                !rematDone && rematOff && !isReRAPass());
+
             if (builder.getOption(vISA_dumpRPE) && iterationNo == 0 && !rematDone)
             {
                 // dump pressure the first time we enter global RA
@@ -9636,6 +10417,11 @@ int GlobalRA::coloringRegAlloc()
             unsigned spillRegSize = 0;
             unsigned indrSpillRegSize = 0;
             bool isColoringGood = coloring.regAlloc(doBankConflictReduction, highInternalConflict, reserveSpillReg, spillRegSize, indrSpillRegSize, &rpe);
+            if (builder.getOption(vISA_RegPressureReport) && iterationNo == 0 && !rematDone)
+            {
+                // report the pressure the first time we enter global RA, before any spill code
+                emitRegPressureReport(kernel, rpe, coloring.getSpilledLiveRanges());
+            }
             if (isColoringGood == false)
             {
                 if (isReRAPass())
@@ -9644,12 +10430,6 @@ int GlobalRA::coloringRegAlloc()
                     return CM_SPILL;
                 }
 
-                bool runRemat = kernel.getOptions()->getTarget() == VISA_CM ? true : 
-                    kernel.getSimdSize() < 32;
-                // -noremat takes precedence over -forceremat
-                bool rematOff = !kernel.getOption(vISA_Debug) &&
-                    (!kernel.getOption(vISA_NoRemat) || kernel.getOption(vISA_FastSpill)) &&
-                    (kernel.getOption(vISA_ForceRemat) || runRemat);
                 bool rematChange = false;
                 bool globalSplitChange = false;
 
@@ -9701,6 +10481,20 @@ int GlobalRA::coloringRegAlloc()
                     globalSplitChange = true;
                 }
 
+                if (iterationNo == 0 &&
+                    !splitPass.didLoopSplit &&
+                    !rematChange && !globalSplitChange &&
+                    builder.getOption(vISA_LoopVarSplit) &&
+                    !kernel.fg.naturalLoops.empty())
+                {
+                    if (builder.getOption(vISA_RATrace))
+                    {
+                        std::cout << "\t--loop boundary split\n";
+                    }
+                    globalSplitChange = splitPass.loopSplit(builder, liveAnalysis, coloring.getSpilledLiveRanges());
+                    splitPass.didLoopSplit = true;
+                }
+
                 if (iterationNo == 0 &&
                     (rematChange || globalSplitChange))
                 {
@@ -9746,6 +10540,7 @@ int GlobalRA::coloringRegAlloc()
 
                 if (iterationNo == 0 &&
                     enableSpillSpaceCompression &&
+                    !builder.getOption(vISA_SpillSlotColoring) &&
                     kernel.getOptions()->getTarget() == VISA_3D &&
                     !builder.canDoSLMSpill() &&
                     !hasStackCall)
@@ -9762,6 +10557,16 @@ int GlobalRA::coloringRegAlloc()
                     }
                 }
 
+                // Spill code only changes the code around the spilled
+                // variables, so keep this graph for the next iteration.
+                if (builder.getOption(vISA_IncrementalIntf) &&
+                    !hasStackCall &&
+                    !kernel.getHasAddrTaken() &&
+                    !rematChange && !globalSplitChange)
+                {
+                    coloring.getIntf()->saveSnapshot(intfSnapshot, coloring.getSpilledLiveRanges());
+                }
+
                 startTimer(TIMER_SPILL);
                 SpillManagerGMRF spillGMRF(*this,
                     nextSpillOffset,
@@ -9877,6 +10682,8 @@ int GlobalRA::coloringRegAlloc()
         }
     }
 
+    intfSnapshot.clear();
+
     assignRegForAliasDcl();
     computePhyReg();
 
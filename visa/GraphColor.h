@@ -30,7 +30,9 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "RegAlloc.h"
 #include "Gen4_IR.hpp"
 #include "SpillManagerGMRF.h"
+#include <array>
 #include <list>
+#include <unordered_map>
 #include <unordered_set>
 #include <limits>
 #include "RPE.h"
@@ -45,6 +47,8 @@ namespace vISA
 {
     const float MAXSPILLCOST = (std::numeric_limits<float>::max());
     const float MINSPILLCOST = -(std::numeric_limits<float>::max());
+    // Spill cost scale for live ranges that remat can recompute at their uses.
+    const float REMATSPILLCOSTSCALE = 0.25f;
 
     class BankConflictPass
     {
@@ -68,6 +72,15 @@ namespace vISA
         void getBanks(G4_INST* inst, BankConflict *srcBC, G4_Declare **dcls, G4_Declare **opndDcls, unsigned int *offset);
         void getPrevBanks(G4_INST* inst, BankConflict *srcBC, G4_Declare **dcls, G4_Declare **opndDcls, unsigned int *offset);
 
+        // With vISA_GlobalBankVotes every bank choice is also recorded as a vote
+        // weighted by its block's reference count; each declare finally gets the
+        // bank with the heaviest vote instead of the one set last.
+        bool useBankVotes = false;
+        uint32_t curBBWeight = 1;
+        std::unordered_map<G4_Declare*, std::array<uint32_t, BANK_CONFLICT_SECOND_HALF_ODD + 1>> bankVotes;
+        void setBank(G4_Declare* dcl, BankConflict bc);
+        void resolveBankVotes();
+
 
 
     public:
@@ -323,6 +336,97 @@ namespace vISA
         void augmentIntfGraph();
     };
 
+    // One row of the upper-half interference matrix used when the kernel is
+    // too large for the dense matrix. Non-zero 32-bit blocks of the row are
+    // kept sorted by column in two parallel arrays, so a row costs 8 bytes
+    // per non-empty block instead of one hash node per neighbor, and lookups
+    // are a binary search over a contiguous column array.
+    class SparseIntfRow
+    {
+        std::vector<uint32_t> cols;
+        std::vector<uint32_t> blocks;
+
+    public:
+        void setBlock(uint32_t col, uint32_t block)
+        {
+            // Interference is mostly built with increasing columns for a row,
+            // so appending is the common case.
+            if (cols.empty() || cols.back() < col)
+            {
+                cols.push_back(col);
+                blocks.push_back(block);
+                return;
+            }
+
+            auto it = std::lower_bound(cols.begin(), cols.end(), col);
+            size_t idx = it - cols.begin();
+            if (*it == col)
+            {
+                blocks[idx] |= block;
+            }
+            else
+            {
+                cols.insert(it, col);
+                blocks.insert(blocks.begin() + idx, block);
+            }
+        }
+
+        void set(uint32_t v)
+        {
+            setBlock(v / BITS_DWORD, BitMask[v % BITS_DWORD]);
+        }
+
+        bool isSet(uint32_t v) const
+        {
+            uint32_t col = v / BITS_DWORD;
+            auto it = std::lower_bound(cols.begin(), cols.end(), col);
+            return it != cols.end() && *it == col &&
+                (blocks[it - cols.begin()] & BitMask[v % BITS_DWORD]) != 0;
+        }
+
+        // Invoke f on every set bit in increasing order.
+        template <typename F>
+        void forEach(F f) const
+        {
+            for (size_t i = 0, e = cols.size(); i < e; ++i)
+            {
+                forEachSetBit(blocks[i], cols[i] * BITS_DWORD, f);
+            }
+        }
+
+        void clear()
+        {
+            cols.clear();
+            blocks.clear();
+        }
+    };
+
+    // Interference graph of a global RA iteration that spilled. Every
+    // LivenessAnalysis renumbers the variables, so ids here are only
+    // meaningful through dcls. The next iteration seeds its graph with these
+    // edges and only recomputes interference in basic blocks whose code or
+    // exit liveness was changed by the spill/fill code.
+    struct IntfSnapshot
+    {
+        bool valid = false;
+        // id -> declare, nullptr for spilled variables
+        std::vector<G4_Declare*> dcls;
+        // upper-half edges
+        std::vector<std::pair<unsigned, unsigned>> edges;
+        // per BB, variables live at exit and their count excluding spilled ones
+        std::vector<BitSet> liveAtExit;
+        std::vector<unsigned> numLiveAtExit;
+
+        void clear()
+        {
+            valid = false;
+            dcls.clear();
+            edges.clear();
+            liveAtExit.clear();
+            numLiveAtExit.clear();
+        }
+    };
+
     class Interference
     {
         friend class Augmentation;
@@ -351,9 +455,13 @@ namespace vISA
         // we don't directly update spraseIntf to ensure uniqueness
         // like dense matrix, interference is not symmetric (that is, if v1 and v2 interfere and v1 < v2,
         // we insert (v1, v2) but not (v2, v1)) for better cache behavior
-        std::vector<std::unordered_set<uint32_t> > sparseMatrix;
+        std::vector<SparseIntfRow> sparseMatrix;
         const uint32_t denseMatrixLimit = 32768;
 
+        // Set while walking a basic block whose interference was seeded from
+        // the previous RA iteration; other per-BB bookkeeping is still done.
+        bool reuseBBIntf = false;
+
         void updateLiveness(BitSet& live, uint32_t id, bool val)
         {
             live.set(id, val);
@@ -361,6 +469,9 @@ namespace vISA
 
         G4_Declare* getGRFDclForHRA(int GRFNum) const;
 
+        void seedFromSnapshot(const IntfSnapshot& snap, std::vector<bool>& reuseBB);
+        bool isBBUnchanged(G4_BB* bb, const IntfSnapshot& snap, const std::vector<unsigned>& newToOld) const;
+
     public:
         Interference(LivenessAnalysis* l, LiveRange**& lr, unsigned n, unsigned ns, unsigned nm,
             GlobalRA& g);
@@ -442,6 +553,11 @@ namespace vISA
         inline void safeSetInterference(unsigned v1, unsigned v2)
         {
             // Assume v1 < v2
+            if (reuseBBIntf)
+            {
+                return;
+            }
+
             if (useDenseMatrix())
             {
                 unsigned col = v2 / BITS_DWORD;
@@ -449,12 +565,17 @@ namespace vISA
             }
             else
             {
-                sparseMatrix[v1].emplace(v2);
+                sparseMatrix[v1].set(v2);
             }
         }
 
         inline void setBlockInterferencesOneWay(unsigned v1, unsigned col, unsigned block)
         {
+            if (reuseBBIntf)
+            {
+                return;
+            }
+
             if (useDenseMatrix())
             {
 #ifdef _DEBUG
@@ -465,14 +586,9 @@ namespace vISA
             }
             else
             {
-                auto&& intfSet = sparseMatrix[v1];
-                for (int i = 0; i < BITS_DWORD; ++i)
+                if (block != 0)
                 {
-                    if (block & BitMask[i])
-                    {
-                        uint32_t v2 = col * BITS_DWORD + i;
-                        intfSet.emplace(v2);
-                    }
+                    sparseMatrix[v1].setBlock(col, block);
                 }
             }
         }
@@ -514,6 +630,8 @@ namespace vISA
 
         void generateSparseIntfGraph();
         bool isStrongEdgeBetween(G4_Declare*, G4_Declare*);
+
+        void saveSnapshot(IntfSnapshot& snap, const LIVERANGE_LIST& spilledLRs) const;
     };
 
     class GraphColor
@@ -554,6 +672,18 @@ namespace vISA
         LIVERANGE_LIST constrainedWorklist;
         unsigned int numColor = 0;
 
+        // When set, live ranges that remat can cheaply recompute are made
+        // preferred spill candidates, since remat runs on the spilled set
+        // before any spill code is inserted.
+        bool rematAwareSpillCost = false;
+        std::vector<bool> cheapRemat;
+
+        // For each GRF variable, the variables it is copied to or from at
+        // the same offset, most frequently copied first. Coloring tries to
+        // give a variable the registers of one of these so the copy becomes
+        // a redundant mov.
+        std::vector<std::vector<unsigned>> copyPartners;
+
 #define GRAPH_COLOR_MEM_SIZE 16*1024
 
         // This function returns the weight of interference edge lr1--lr2,
@@ -706,6 +836,8 @@ namespace vISA
         void computeDegreeForGRF();
         void computeDegreeForARF();
         void computeSpillCosts(bool useSplitLLRHeuristic);
+        void computeCheapRemat();
+        void computeCopyPartners();
         void determineColorOrdering();
         void removeConstrained();
         void relaxNeighborDegreeGRF(LiveRange* lr);
@@ -726,6 +858,7 @@ namespace vISA
         static const char* StackCallStr;
 
         const Options * getOptions() { return m_options; }
+        void setRematAwareSpillCost(bool val) { rematAwareSpillCost = val; }
 
         bool regAlloc(
             bool doBankConflictReduction,
@@ -890,6 +1023,12 @@ namespace vISA
         // new temps for each reference of spilled address/flag decls 
         std::unordered_set<G4_Declare*> addrFlagSpillDcls;
 
+        // interference of the last GRF RA iteration that spilled
+        IntfSnapshot intfSnapshot;
+
+        // BB id -> loop-nest equivalent of its profiled execution count
+        std::unordered_map<unsigned, int> bbProfileLevel;
+
     public:
         G4_Kernel& kernel;
         IR_Builder& builder;
@@ -907,6 +1046,8 @@ namespace vISA
 
         void setSubRetLoc(G4_BB* bb, unsigned int s) { subretloc[bb] = s; }
 
+        IntfSnapshot& getIntfSnapshot() { return intfSnapshot; }
+
         bool isSubRetLocConflict(G4_BB *bb, std::vector<unsigned> &usedLoc, unsigned stackTop);
         void assignLocForReturnAddr();
         unsigned determineReturnAddrLoc(unsigned entryId, unsigned* retLoc, G4_BB* bb);
@@ -1247,6 +1388,11 @@ namespace vISA
             {
                 verifyAugmentation = new VerifyAugmentation();
             }
+
+            if (kernel.getOptions()->getOptionCstr(vISA_ProfileFeedbackFile))
+            {
+                loadProfileFeedback(kernel.getOptions()->getOptionCstr(vISA_ProfileFeedbackFile));
+            }
         }
 
         ~GlobalRA()
@@ -1258,6 +1404,8 @@ namespace vISA
         void emitFGWithLiveness(LivenessAnalysis& liveAnalysis);
         void reportSpillInfo(LivenessAnalysis& liveness, GraphColor& coloring);
         static uint32_t getRefCount(int loopNestLevel);
+        uint32_t getBBRefCount(G4_BB* bb) const;
+        void loadProfileFeedback(const char* fileName);
         bool isReRAPass();
         void updateSubRegAlignment(unsigned char regFile, G4_SubReg_Align subAlign);
         void updateAlignment(unsigned char regFile, G4_Align align);
@@ -1272,6 +1420,7 @@ namespace vISA
         void addrRegAlloc();
         void flagRegAlloc();
         bool hybridRA(bool doBankConflictReduction, bool highInternalConflict, LocalRA& lra);
+        void reportRegionLocality();
         void assignRegForAliasDcl();
         void removeSplitDecl();
         int coloringRegAlloc();
@@ -1307,9 +1456,11 @@ namespace vISA
     public:
         bool didLocalSplit = false;
         bool didGlobalSplit = false;
+        bool didLoopSplit = false;
 
         void localSplit(IR_Builder& builder, G4_BB* bb);
         void globalSplit(IR_Builder& builder, G4_Kernel &kernel);
+        bool loopSplit(IR_Builder& builder, const LivenessAnalysis& liveAnalysis, const LIVERANGE_LIST& spilledLRs);
         bool canDoGlobalSplit(IR_Builder& builder, G4_Kernel &kernel, uint32_t instNum, uint32_t spillRefCount, uint32_t sendSpillRefCount);
 
         VarSplit(GlobalRA& g) : kernel(g.kernel), gra(g)
@@ -6074,21 +6074,74 @@ bool HWConformity::fixAddcSubb(G4_BB* bb)
     return changed;
 }
 
+// Opcode classes that the BB-wide legalization sweeps in chkHWConformity
+// apply to. Each of those sweeps only ever rewrites instructions of its own
+// class, so a BB without any of them can skip the sweep entirely.
+enum HWConformitySweep
+{
+    SWEEP_ADDC_SUBB = 1 << 0,  // fixAddcSubb
+    SWEEP_MAD       = 1 << 1,  // fixMADInst
+    SWEEP_SADA2     = 1 << 2,  // fixSADA2Inst
+    SWEEP_SEND      = 1 << 3   // fixSendInst
+};
+
+static unsigned getSweepsForBB(G4_BB* bb)
+{
+    unsigned sweeps = 0;
+    for (auto inst : *bb)
+    {
+        switch (inst->opcode())
+        {
+        case G4_addc:
+        case G4_subb:
+            sweeps |= SWEEP_ADDC_SUBB;
+            break;
+        case G4_pseudo_mad:
+            sweeps |= SWEEP_MAD;
+            break;
+        case G4_pseudo_sada2:
+            sweeps |= SWEEP_SADA2;
+            break;
+        default:
+            if (inst->isSend())
+            {
+                sweeps |= SWEEP_SEND;
+            }
+            break;
+        }
+    }
+    return sweeps;
+}
+
 void HWConformity::chkHWConformity()
 {
     fixDataLayout();
 
     for (BB_LIST_ITER it = kernel.fg.BBs.begin(); it != kernel.fg.BBs.end();it++)
     {
+        // None of the sweeps below creates instructions of another sweep's
+        // class, so one scan up front is enough to decide which ones to run.
+        unsigned sweeps = getSweepsForBB(*it);
 #ifdef _DEBUG
         verifyG4Kernel(kernel, Optimizer::PI_HWConformityChk, false);
 #endif
-        fixAddcSubb(*it);
+        if (sweeps & SWEEP_ADDC_SUBB)
+        {
+            fixAddcSubb(*it);
+        }
 #ifdef _DEBUG
         verifyG4Kernel(kernel, Optimizer::PI_HWConformityChk, false);
 #endif
 
-        fixMADInst( it );
+        if (sweeps & SWEEP_MAD)
+        {
+            fixMADInst( it );
+        }
+        else
+        {
+            // accSubstitution relies on the local ids fixMADInst assigns
+            (*it)->resetLocalId();
+        }
 
 #ifdef _DEBUG
         verifyG4Kernel(kernel, Optimizer::PI_HWConformityChk, false);
@@ -6123,13 +6176,19 @@ void HWConformity::chkHWConformity()
 #ifdef _DEBUG
         verifyG4Kernel(kernel, Optimizer::PI_HWConformityChk, false);
 #endif
-        fixSADA2Inst( it );
+        if (sweeps & SWEEP_SADA2)
+        {
+            fixSADA2Inst( it );
+        }
 
 #ifdef _DEBUG
         verifyG4Kernel(kernel, Optimizer::PI_HWConformityChk, false);
 #endif
 
-        fixSendInst( it );
+        if (sweeps & SWEEP_SEND)
+        {
+            fixSendInst( it );
+        }
 
 #ifdef _DEBUG
         verifyG4Kernel(kernel, Optimizer::PI_HWConformityChk, false);
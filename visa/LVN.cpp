@@ -1772,9 +1772,35 @@ bool LVN::isRedundantMovToSelf(LVNItemInfo* lvnItem, G4_INST* inst)
     return isRedundant;
 }
 
+// Keep the values computed so far and number nextBB after the current BB.
+// Only valid when nextBB is entered only from the current BB, so that every
+// value in the table still holds at its start.
+void LVN::continueInBB(G4_BB* nextBB)
+{
+    if (!bb->empty())
+    {
+        localIdBase = bb->back()->getLocalId() + 1;
+    }
+    bb = nextBB;
+    defUse.clear();
+    useDef.clear();
+    activeDefs.clear();
+    duTablePopulated = false;
+    numInstsRemoved = 0;
+}
+
 void LVN::doLVN()
 {
     bb->resetLocalId();
+    if (localIdBase != 0)
+    {
+        // keep ids growing across the BBs sharing the table so that
+        // MaxLVNDistance still applies
+        for (auto inst : *bb)
+        {
+            inst->setLocalId(inst->getLocalId() + localIdBase);
+        }
+    }
     for (INST_LIST_ITER inst_it = bb->begin(), inst_end_it = bb->end();
         inst_it != inst_end_it;
         inst_it++)
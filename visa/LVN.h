@@ -140,6 +140,9 @@ private:
     unsigned int numInstsRemoved;
     bool duTablePopulated;
     PointsToAnalysis& p2a;
+    // first local id of the current BB; non-zero when the value table is
+    // carried over from a predecessor (see continueInBB)
+    int32_t localIdBase = 0;
 
     static const int MaxLVNDistance = 250;
 
@@ -182,6 +185,7 @@ public:
     }
 
     void doLVN();
+    void continueInBB(G4_BB* nextBB);
     unsigned int getNumInstsRemoved() { return numInstsRemoved; }
 };
 }
@@ -2480,32 +2480,12 @@ void LinearScan::run(G4_BB* bb, IR_Builder& builder, LLR_USE_MAP& LLRUseMap)
 
 void LinearScan::updateActiveList(LocalLiveRange* lr)
 {
-    bool done = false;
     unsigned int newlr_end;
 
     lr->getLastRef(newlr_end);
 
-    for (auto active_it = active.begin();
-        active_it != active.end();
-        active_it++)
-    {
-        unsigned int end_idx;
-        LocalLiveRange* active_lr = (*active_it);
-
-        active_lr->getLastRef(end_idx);
-
-        if (end_idx > newlr_end)
-        {
-            active.insert(active_it, lr);
-            done = true;
-            break;
-        }
-
-    }
-
-    if (done == false)
-        active.push_back(lr);
-
+    // Ranges with the same end keep their insertion order
+    active.emplace(newlr_end, lr);
 }
 
 void LinearScan::expireAllActive()
@@ -2513,12 +2493,7 @@ void LinearScan::expireAllActive()
     if (active.size() > 0)
     {
         // Expire any remaining ranges
-        LocalLiveRange* lastActive = active.back();
-        unsigned int endIdx;
-
-        lastActive->getLastRef(endIdx);
-
-        expireRanges(endIdx);
+        expireRanges(active.rbegin()->first);
     }
 }
 
@@ -2526,14 +2501,12 @@ void LinearScan::expireAllActive()
 // The function will expire active ranges that end at or before idx
 void LinearScan::expireRanges(unsigned int idx)
 {
-    //active list is sorted in ascending order of starting index
+    //active list is sorted in ascending order of ending index
 
     while (active.size() > 0)
     {
-        unsigned int endIdx;
-        LocalLiveRange* lr = active.front();
-
-        lr->getLastRef(endIdx);
+        unsigned int endIdx = active.begin()->first;
+        LocalLiveRange* lr = active.begin()->second;
 
         if (endIdx <= idx)
         {
@@ -2565,7 +2538,7 @@ void LinearScan::expireRanges(unsigned int idx)
 #endif
 
             // Remove range from active list
-            active.pop_front();
+            active.erase(active.begin());
         }
         else
         {
@@ -2731,7 +2704,7 @@ bool LinearScan::allocateRegs(LocalLiveRange* lr, G4_BB* bb, IR_Builder& builder
             active_it != active.rend();
             active_it++)
         {
-            LocalLiveRange* activeLR = (*active_it);
+            LocalLiveRange* activeLR = active_it->second;
 
             if (activeLR->getSizeInWords() >= lr->getSizeInWords() &&
                 (!doSplitLLR ||
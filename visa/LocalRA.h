@@ -28,6 +28,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define _INC_LOCALRA_H_
 
 #include <list>
+#include <map>
 #include "G4_Opcode.h"
 #include "FlowGraph.h"
 #include "BuildIR.h"
@@ -456,7 +457,9 @@ private:
     PhyRegsLocalRA& initPregs;
 	std::vector<LocalLiveRange*>& liveIntervals;
     std::list<InputLiveRange*, std_arena_based_allocator<InputLiveRange*>>& inputIntervals;
-	std::list<LocalLiveRange*> active;
+	// active ranges keyed by their last reference index, so expiry and
+	// insertion don't need a linear walk
+	std::multimap<unsigned int, LocalLiveRange*> active;
 	PhyRegSummary* summary;
 
 	void expireRanges( unsigned int );
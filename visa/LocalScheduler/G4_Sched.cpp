@@ -12,6 +12,9 @@ static const unsigned PRESSURE_REDUCTION_MIN_BENEFIT = 5;
 static const unsigned PRESSURE_REDUCTION_THRESHOLD = 110;
 static const unsigned PRESSURE_REDUCTION_THRESHOLD_SIMD32 = 120;
 static const unsigned LATENCY_PRESSURE_THRESHOLD = 100;
+static const unsigned HOIST_REGION_MAX_BLOCKS = 4;
+static const unsigned HOIST_REGION_MAX_INSTS = 256;
+static const unsigned HOIST_JOIN_SCAN_WINDOW = 32;
 
 namespace {
 
@@ -396,17 +399,26 @@ struct SchedConfig
         MASK_LATENCY      = 1U << 1,
         MASK_SETHI_ULLMAN = 1U << 2,
         MASK_CLUSTTERING  = 1U << 3,
+        MASK_MULTI_CANDIDATE = 1U << 4,
+        MASK_GLOBAL_HOISTING = 1U << 5,
+        MASK_FLAG_PRESSURE = 1U << 6,
     };
     unsigned Dump : 1;
     unsigned UseLatency : 1;
     unsigned UseSethiUllman : 1;
     unsigned DoClustering : 1;
+    unsigned UseMultiCandidate : 1;
+    unsigned UseGlobalHoisting : 1;
+    unsigned UseFlagPressure : 1;
 
     explicit SchedConfig(unsigned Config)
         : Dump((Config & MASK_DUMP) != 0)
         , UseLatency((Config & MASK_LATENCY) != 0)
         , UseSethiUllman((Config & MASK_SETHI_ULLMAN) != 0)
         , DoClustering((Config & MASK_CLUSTTERING) != 0)
+        , UseMultiCandidate((Config & MASK_MULTI_CANDIDATE) != 0)
+        , UseGlobalHoisting((Config & MASK_GLOBAL_HOISTING) != 0)
+        , UseFlagPressure((Config & MASK_FLAG_PRESSURE) != 0)
     {
     }
 };
@@ -457,15 +469,78 @@ public:
     // Commit this scheduling if it reduces register pressure.
     bool commitIfBeneficial(unsigned &MaxRPE, bool IsTopDown);
 
+    // Build pressure, latency and hybrid schedules, and commit the one
+    // that hides the most latency within the pressure budget.
+    bool scheduleBlockMultiCandidate(unsigned &MaxRPE);
+
 private:
     void SethiUllmanScheduling();
     void LatencyScheduling();
     bool verifyScheduling();
 
+    // Estimate the issue cycles of an in-order execution of Insts.
+    unsigned estimateCycles(const std::vector<G4_INST*>& Insts);
+
     // Relocate pseudo-kills right before its successors.
     void relocatePseudoKills();
 };
 
+// Move long-latency read messages across short branch regions.
+//
+// A region is the set of blocks strictly between a block ending with a
+// conditional branch (the head) and its immediate post-dominator (the
+// join). When the region is single-entry, single-exit and loop-free, the
+// join is control-equivalent to the head and runs under the same
+// execution mask, so a read message near the top of the join may be
+// issued right before the head's branch instead. Its latency is then
+// hidden behind the region's instructions rather than exposed at the
+// block boundary, which the per-block schedulers cannot do.
+class GlobalSendHoisting {
+    G4_Kernel& kernel;
+
+    // Register pressure estimation, computed before any hoisting.
+    RegisterPressure& rp;
+
+    SchedConfig config;
+
+    // Pressure added to each block, indexed by block id, by the messages
+    // hoisted across it so far.
+    std::vector<unsigned> ExtraPressure;
+
+    // Non-trivial SCC each block belongs to, or -1, indexed by block id.
+    std::vector<int> SCCIndex;
+
+    bool BTIIsRestrict;
+
+public:
+    GlobalSendHoisting(G4_Kernel& kernel, RegisterPressure& rp, SchedConfig config)
+        : kernel(kernel)
+        , rp(rp)
+        , config(config)
+    {
+        BTIIsRestrict = kernel.getOptions()->getOption(vISA_ReorderDPSendToDifferentBti);
+    }
+
+    // Returns true if any instruction was moved.
+    bool run();
+
+private:
+    // Collect the blocks between Head and Join. Returns false if they do
+    // not form a region messages could be hoisted across.
+    bool collectRegion(G4_BB* Head, G4_BB* Join, std::vector<G4_BB*>& Region,
+                       std::vector<G4_INST*>& RegionInsts);
+
+    // Check if Send is a message that could be hoisted.
+    bool isCandidate(G4_INST* Send) const;
+
+    // Check if Send cannot be moved across Inst.
+    bool hasDependency(G4_INST* Send, G4_INST* Inst) const;
+
+    // Hoist candidates from the top of Join to the end of Head.
+    bool hoistFromJoin(G4_BB* Head, G4_BB* Join, std::vector<G4_BB*>& Region,
+                       std::vector<G4_INST*>& RegionInsts);
+};
+
 } // namespace
 
 static unsigned getRPReductionThreshold(Options *m_options, G4_Kernel &kernel)
@@ -494,6 +569,45 @@ static unsigned getLatencyHidingThreshold(Options *m_options)
     return unsigned(LATENCY_PRESSURE_THRESHOLD * Ratio);
 }
 
+// Return the latency of the result produced by Inst.
+static unsigned getResultLatency(G4_INST* Inst)
+{
+    unsigned Latency = IVB_PIPELINE_LENGTH;
+    if (Inst->isSend()) {
+        Latency = 0;
+        if (G4_SendMsgDescriptor* MsgDesc = Inst->getMsgDesc()) {
+            Latency = MsgDesc->getFFLatency();
+            // Lower latency for SLM messages.
+            // TODO: Take into account the GEN target.
+            if (MsgDesc->isSLMMessage())
+                Latency /= 4;
+        }
+    } else if (Inst->isMath()) {
+        Latency = EDGE_LATENCY_MATH;
+        if (Inst->asMathInst()->getMathCtrl() == MATH_FDIV ||
+            Inst->asMathInst()->getMathCtrl() == MATH_POW)
+            Latency = EDGE_LATENCY_MATH_TYPE2;
+    }
+    return Latency;
+}
+
+// Return the number of long latency messages in this block.
+static unsigned getNumHighLatencyInsts(G4_BB* bb)
+{
+    unsigned NumOfHighLatencyInsts = 0;
+    for (auto Inst : *bb) {
+        if (Inst->isSend()) {
+            if (G4_SendMsgDescriptor* MsgDesc = Inst->getMsgDesc()) {
+                if (MsgDesc->isDataPortRead() ||
+                    MsgDesc->isSampler() ||
+                    MsgDesc->isAtomicMessage())
+                    NumOfHighLatencyInsts++;
+            }
+        }
+    }
+    return NumOfHighLatencyInsts;
+}
+
 preRA_Scheduler::preRA_Scheduler(G4_Kernel& k, Mem_Manager& m, RPE* rpe)
     : kernel(k)
     , mem(m)
@@ -517,9 +631,23 @@ bool preRA_Scheduler::run()
     unsigned SchedCtrl = m_options->getuInt32Option(vISA_preRA_ScheduleCtrl);
 
     SchedConfig config(SchedCtrl);
-    RegisterPressure rp(kernel, mem, rpe);
     bool Changed = false;
 
+    // Cross-block hoisting changes liveness, so it runs with its own
+    // pressure estimation before the per-block schedulers compute theirs.
+    if (config.UseGlobalHoisting) {
+        // The pressure estimate is indexed by block id, so blocks have to be
+        // renumbered before it is computed. A caller-provided liveness keeps
+        // its numbering.
+        if (rpe == nullptr)
+            kernel.fg.reassignBlockIDs();
+        RegisterPressure globalRP(kernel, mem, rpe);
+        GlobalSendHoisting GH(kernel, globalRP, config);
+        Changed = GH.run();
+    }
+
+    RegisterPressure rp(kernel, mem, rpe);
+
     for (auto bb : kernel.fg.BBs) {
         if (bb->size() < SMALL_BLOCK_SIZE || bb->size() > LARGE_BLOCK_SIZE) {
             SCHED_DUMP(std::cerr << "Skip block with instructions "
@@ -528,7 +656,14 @@ bool preRA_Scheduler::run()
         }
 
         unsigned MaxPressure = rp.getPressure(bb);
-        if (MaxPressure <= Threshold && !config.UseLatency) {
+        if (MaxPressure <= Threshold && !config.UseLatency &&
+            !config.UseMultiCandidate) {
+            SCHED_DUMP(std::cerr << "Skip block with rp " << MaxPressure << "\n");
+            continue;
+        }
+
+        if (config.UseMultiCandidate && MaxPressure <= Threshold &&
+            getNumHighLatencyInsts(bb) < 2) {
             SCHED_DUMP(std::cerr << "Skip block with rp " << MaxPressure << "\n");
             continue;
         }
@@ -537,6 +672,14 @@ bool preRA_Scheduler::run()
         preDDD ddd(mem, kernel, bb);
         BB_Scheduler S(kernel, ddd, rp, config);
 
+        if (config.UseMultiCandidate) {
+            if (S.scheduleBlockMultiCandidate(MaxPressure)) {
+                SCHED_DUMP(rp.dump(bb, "After multi-candidate scheduling, "));
+                Changed = true;
+            }
+            continue;
+        }
+
         auto tryRPReduction = [=]() {
             if (!config.UseSethiUllman)
                  return false;
@@ -567,19 +710,7 @@ bool preRA_Scheduler::run()
                 return false;
 
             // simple ROI check.
-            unsigned NumOfHighLatencyInsts = 0;
-            for (auto Inst : *bb) {
-                if (Inst->isSend()) {
-                    if (G4_SendMsgDescriptor* MsgDesc = Inst->getMsgDesc()) {
-                        if (MsgDesc->isDataPortRead() ||
-                            MsgDesc->isSampler() ||
-                            MsgDesc->isAtomicMessage())
-                            NumOfHighLatencyInsts++;
-                    }
-                }
-            }
-
-            return NumOfHighLatencyInsts >= 2;
+            return getNumHighLatencyInsts(bb) >= 2;
         };
 
         if (tryLatencyHiding()) {
@@ -677,6 +808,11 @@ class SethiUllmanQueue : public QueueBase {
     // Scheduling in clustering mode.
     bool IsInClusteringMode = false;
 
+    // Flag variables used below the current scheduling point but not yet
+    // defined, and the number of 16-bit flag registers they occupy.
+    std::set<G4_Declare*> LiveFlags;
+    unsigned LiveFlagUnits = 0;
+
 public:
     SethiUllmanQueue(preDDD& ddd, RegisterPressure& rp, SchedConfig config)
         : QueueBase(ddd, rp, config)
@@ -710,6 +846,9 @@ public:
         return Q.empty() && Clusterings.empty();
     }
 
+    // Update live flags after scheduling a node.
+    void updateFlagPressure(preNode* N);
+
 private:
     // Initialize Sethi-Ullman numbers.
     void init();
@@ -725,6 +864,9 @@ private:
 
     // Compute the Sethi-Ullman number for a node.
     unsigned calculateSethiUllmanNumber(preNode* N);
+
+    // The change in live flag registers if this node is scheduled next.
+    int getFlagPressureDelta(preNode* N);
 };
 
 } // namespace
@@ -837,6 +979,15 @@ bool SethiUllmanQueue::compare(preNode* N1, preNode* N2)
         }
     }
 
+    // When flags run out, prefer the node that ends a flag live range over
+    // one that starts a new one, to avoid flag spills.
+    if (config.UseFlagPressure && LiveFlagUnits >= getNumFlagRegisters()) {
+        int Delta1 = getFlagPressureDelta(N1);
+        int Delta2 = getFlagPressureDelta(N2);
+        if (Delta1 != Delta2)
+            return Delta2 < Delta1;
+    }
+
     unsigned SU1 = Numbers[N1->getID()];
     unsigned SU2 = Numbers[N2->getID()];
 
@@ -851,6 +1002,54 @@ bool SethiUllmanQueue::compare(preNode* N1, preNode* N2)
     return N1->getID() > N2->getID();
 }
 
+static unsigned getFlagUnits(G4_Declare* Dcl)
+{
+    return (Dcl->getNumberFlagElements() + 15) / 16;
+}
+
+int SethiUllmanQueue::getFlagPressureDelta(preNode* N)
+{
+    G4_INST* Inst = N->getInst();
+    if (!Inst)
+        return 0;
+
+    int Delta = 0;
+    G4_Declare* DefDcl = nullptr;
+    G4_CondMod* Mod = Inst->getCondMod();
+    if (Mod && Mod->getTopDcl() && !Inst->getPredicate()) {
+        DefDcl = Mod->getTopDcl();
+        if (LiveFlags.count(DefDcl))
+            Delta -= (int)getFlagUnits(DefDcl);
+    }
+    G4_Predicate* Pred = Inst->getPredicate();
+    if (Pred && Pred->getTopDcl()) {
+        G4_Declare* UseDcl = Pred->getTopDcl();
+        if (!LiveFlags.count(UseDcl))
+            Delta += (int)getFlagUnits(UseDcl);
+    }
+    return Delta;
+}
+
+void SethiUllmanQueue::updateFlagPressure(preNode* N)
+{
+    G4_INST* Inst = N->getInst();
+    if (!Inst)
+        return;
+
+    // In bottom-up order, a full flag def ends the live range and a
+    // predicate use starts it.
+    G4_CondMod* Mod = Inst->getCondMod();
+    if (Mod && Mod->getTopDcl() && !Inst->getPredicate()) {
+        if (LiveFlags.erase(Mod->getTopDcl()))
+            LiveFlagUnits -= getFlagUnits(Mod->getTopDcl());
+    }
+    G4_Predicate* Pred = Inst->getPredicate();
+    if (Pred && Pred->getTopDcl()) {
+        if (LiveFlags.insert(Pred->getTopDcl()).second)
+            LiveFlagUnits += getFlagUnits(Pred->getTopDcl());
+    }
+}
+
 preNode* SethiUllmanQueue::scheduleClusteringNode()
 {
     // Clustering does not work well for SIMD32 kernels.
@@ -1023,6 +1222,8 @@ void BB_Scheduler::SethiUllmanScheduling()
     while (!Q.empty()) {
         preNode *N = Q.pop();
         assert(!N->isScheduled && N->NumSuccsLeft == 0);
+        if (config.UseFlagPressure)
+            Q.updateFlagPressure(N);
         if (N->getInst() != nullptr) {
             // std::cerr << "emit: "; N->getInst()->dump();
             if (N->getInst()->isSend() && N->getTupleLead()) {
@@ -1377,22 +1578,7 @@ unsigned LatencyQueue::calculatePriority(preNode* N)
                 // fall through
             case RAW_MEMORY:
             case WAW:
-                if (Inst->isSend()) {
-                    if (G4_SendMsgDescriptor* MsgDesc = Inst->getMsgDesc()) {
-                        Latency = MsgDesc->getFFLatency();
-                        // Lower latency for SLM messages.
-                        // TODO: Take into account the GEN target.
-                        if (MsgDesc->isSLMMessage())
-                            Latency /= 4;
-                    }
-                } else if (Inst->isMath()) {
-                    Latency = EDGE_LATENCY_MATH;
-                    if (Inst->asMathInst()->getMathCtrl() == MATH_FDIV ||
-                        Inst->asMathInst()->getMathCtrl() == MATH_POW)
-                        Latency = EDGE_LATENCY_MATH_TYPE2;
-                } else {
-                    Latency = IVB_PIPELINE_LENGTH;
-                }
+                Latency = getResultLatency(Inst);
                 break;
             default:
                 break;
@@ -1587,25 +1773,147 @@ bool BB_Scheduler::commitIfBeneficial(unsigned& MaxRPE, bool IsTopDown)
     return false;
 }
 
+unsigned BB_Scheduler::estimateCycles(const std::vector<G4_INST*>& Insts)
+{
+    std::unordered_map<G4_INST*, preNode*> NodeMap;
+    for (auto N : ddd.getNodes())
+        if (N->getInst())
+            NodeMap[N->getInst()] = N;
+
+    // Issue one instruction per cycle, stalling on true dependencies
+    // until the producer's result is available.
+    std::unordered_map<G4_INST*, unsigned> IssueCycle;
+    unsigned Cycle = 0;
+    for (auto Inst : Insts) {
+        unsigned Ready = Cycle;
+        auto I = NodeMap.find(Inst);
+        if (I != NodeMap.end()) {
+            for (auto& E : I->second->preds()) {
+                G4_INST* PredInst = E.getNode()->getInst();
+                if (!PredInst || PredInst->isPseudoKill())
+                    continue;
+                if (E.getType() != RAW && E.getType() != RAW_MEMORY)
+                    continue;
+                auto P = IssueCycle.find(PredInst);
+                if (P != IssueCycle.end())
+                    Ready = std::max(Ready, P->second + getResultLatency(PredInst));
+            }
+        }
+        IssueCycle[Inst] = Ready;
+        Cycle = Ready + 1;
+    }
+
+    return Cycle;
+}
+
+// Schedule this block in several ways and keep the best one.
+//
+// Candidates are the original order, the Sethi-Ullman (pressure) order,
+// the latency order, and a hybrid which runs the latency scheduler on top
+// of the pressure order. Among the candidates whose max pressure fits the
+// latency-hiding budget, the one with the fewest estimated cycles wins. If
+// none of them fits, the one with the lowest pressure wins.
+bool BB_Scheduler::scheduleBlockMultiCandidate(unsigned& MaxRPE)
+{
+    struct Candidate {
+        const char* Name;
+        std::vector<G4_INST*> Insts;
+        unsigned RP;
+        unsigned Cycles;
+    };
+
+    INST_LIST& CurInsts = getBB()->getInstList();
+    const std::vector<G4_INST*> Original(CurInsts.begin(), CurInsts.end());
+    std::vector<Candidate> Candidates;
+
+    auto install = [&](const std::vector<G4_INST*>& Insts) {
+        CurInsts.clear();
+        CurInsts.insert(CurInsts.end(), Insts.begin(), Insts.end());
+    };
+
+    auto addCandidate = [&](const char* Name, const std::vector<G4_INST*>& Insts) {
+        if (Insts.size() != Original.size()) {
+            SCHED_DUMP(std::cerr << Name << " schedule dropped due to mischeduling.\n");
+            return;
+        }
+        install(Insts);
+        rp.recompute(getBB());
+        unsigned RP = rp.getPressure(getBB());
+        unsigned Cycles = estimateCycles(Insts);
+        SCHED_DUMP(std::cerr << Name << " schedule: rp " << RP
+                             << ", cycles " << Cycles << "\n");
+        Candidates.push_back({ Name, Insts, RP, Cycles });
+    };
+
+    ddd.reset();
+    Candidates.push_back({ "original", Original, MaxRPE, estimateCycles(Original) });
+
+    // Pressure. The Sethi-Ullman schedule is built bottom-up.
+    SethiUllmanScheduling();
+    std::vector<G4_INST*> PressureOrder(schedule.rbegin(), schedule.rend());
+    addCandidate("pressure", PressureOrder);
+
+    // Latency, from the original order.
+    install(Original);
+    ddd.reset(/*ReassignNodeID*/ true);
+    LatencyScheduling();
+    addCandidate("latency", schedule);
+
+    // Hybrid: latency scheduling from the pressure order.
+    if (PressureOrder.size() == Original.size()) {
+        install(PressureOrder);
+        ddd.reset(/*ReassignNodeID*/ true);
+        LatencyScheduling();
+        addCandidate("hybrid", schedule);
+    }
+
+    unsigned Budget = getLatencyHidingThreshold(kernel.getOptions());
+    const Candidate* Best = nullptr;
+    for (auto& C : Candidates) {
+        if (C.RP <= Budget && (!Best || C.Cycles < Best->Cycles))
+            Best = &C;
+    }
+    if (!Best) {
+        for (auto& C : Candidates) {
+            if (!Best || C.RP < Best->RP ||
+                (C.RP == Best->RP && C.Cycles < Best->Cycles))
+                Best = &C;
+        }
+        // As for a single schedule, only reduce pressure if it pays off.
+        if (Best->RP + PRESSURE_REDUCTION_MIN_BENEFIT > MaxRPE)
+            Best = &Candidates.front();
+    }
+
+    SCHED_DUMP(std::cerr << Best->Name << " schedule committed.\n\n");
+    install(Best->Insts);
+    rp.recompute(getBB());
+    if (Best == &Candidates.front())
+        return false;
+
+    MaxRPE = Best->RP;
+    return true;
+}
+
 // Implementation of preNode.
 preNode::~preNode() {}
 
-void preNode::setBarrier()
+// Check if there is an indirect operand in this instruction.
+static bool hasIndirectOpnd(G4_INST* Inst)
 {
-    // Check if there is an indirect operand in this instruction.
-    auto hasIndirectOpnd = [=](G4_INST* Inst) {
-        G4_DstRegRegion* dst = Inst->getDst();
-        if (dst && dst->isIndirect())
+    G4_DstRegRegion* dst = Inst->getDst();
+    if (dst && dst->isIndirect())
+        return true;
+    for (auto opNum : { Opnd_src0, Opnd_src1, Opnd_src2 }) {
+        G4_Operand* opnd = Inst->getOperand(opNum);
+        if (opnd && opnd->isSrcRegRegion() &&
+            opnd->asSrcRegRegion()->isIndirect())
             return true;
-        for (auto opNum : { Opnd_src0, Opnd_src1, Opnd_src2 }) {
-            G4_Operand* opnd = Inst->getOperand(opNum);
-            if (opnd && opnd->isSrcRegRegion() &&
-                opnd->asSrcRegRegion()->isIndirect())
-                return true;
-        }
-        return false;
-    };
+    }
+    return false;
+}
 
+void preNode::setBarrier()
+{
     if (Inst == nullptr)
         Barrier = DepType::OPT_BARRIER;
     else if (Inst->isLabel())
@@ -2093,3 +2401,307 @@ void preDDD::dumpDagDot()
     ofile << "}\n";
     ofile.close();
 }
+
+bool GlobalSendHoisting::run()
+{
+    FlowGraph& fg = kernel.fg;
+
+    // Post-dominance is computed from the EOT block of a single function.
+    if (fg.getHasStackCalls() || fg.getIsStackCallFunc() ||
+        !fg.funcInfoTable.empty())
+        return false;
+
+    if (fg.BBs.size() < 3 || fg.BBs.back()->empty() ||
+        !fg.BBs.back()->back()->isEOT())
+        return false;
+
+    // SCCIndex, ExtraPressure and the liveness of RP are all indexed by block
+    // id, which must therefore follow the layout.
+    unsigned Id = 0;
+    for (auto BB : fg.BBs)
+        if (BB->getId() != Id++)
+            return false;
+
+    PostDom pdom(kernel);
+    pdom.run();
+
+    SCCAnalysis SCCFinder(fg);
+    SCCFinder.run();
+    SCCIndex.assign(fg.getNumBB(), -1);
+    int Index = 0;
+    for (auto I = SCCFinder.SCC_begin(), E = SCCFinder.SCC_end(); I != E; ++I, ++Index) {
+        if (I->getSize() < 2)
+            continue;
+        for (auto BI = I->body_begin(), BE = I->body_end(); BI != BE; ++BI)
+            SCCIndex[(*BI)->getId()] = Index;
+    }
+
+    ExtraPressure.assign(fg.getNumBB(), 0);
+
+    bool Changed = false;
+    std::vector<G4_BB*> Region;
+    std::vector<G4_INST*> RegionInsts;
+    for (auto Head : fg.BBs) {
+        if (Head->Succs.size() != 2 || Head->empty())
+            continue;
+
+        G4_INST* Term = Head->back();
+        if (!Term->isFlowControl() || Term->isCall() || Term->isFCall() ||
+            Term->isReturn() || Term->isFReturn())
+            continue;
+
+        auto& ImmPostDoms = pdom.getImmPostDom(Head);
+        if (ImmPostDoms.size() < 2)
+            continue;
+        G4_BB* Join = ImmPostDoms[1];
+
+        Region.clear();
+        RegionInsts.clear();
+        if (!collectRegion(Head, Join, Region, RegionInsts))
+            continue;
+
+        Changed |= hoistFromJoin(Head, Join, Region, RegionInsts);
+    }
+
+    return Changed;
+}
+
+bool GlobalSendHoisting::collectRegion(
+    G4_BB* Head, G4_BB* Join, std::vector<G4_BB*>& Region,
+    std::vector<G4_INST*>& RegionInsts)
+{
+    int HeadSCC = SCCIndex[Head->getId()];
+    auto inRegion = [&](G4_BB* BB) {
+        return std::find(Region.begin(), Region.end(), BB) != Region.end();
+    };
+
+    // Walk forward from the head until the join is reached.
+    std::vector<G4_BB*> WorkList(Head->Succs.begin(), Head->Succs.end());
+    while (!WorkList.empty()) {
+        G4_BB* BB = WorkList.back();
+        WorkList.pop_back();
+        if (BB == Join || inRegion(BB))
+            continue;
+        // Loops inside the region make the join run a different number of
+        // times than the messages it would be issuing.
+        if (BB == Head || BB->isSuccBB(BB))
+            return false;
+        int BBSCC = SCCIndex[BB->getId()];
+        if (BBSCC != -1 && BBSCC != HeadSCC)
+            return false;
+        if (BB->empty() || BB->isEndWithCall() || BB->isEndWithFCall() ||
+            BB->isEndWithFRet() || BB->getLastOpcode() == G4_return ||
+            BB->isLastInstEOT())
+            return false;
+
+        Region.push_back(BB);
+        if (Region.size() > HOIST_REGION_MAX_BLOCKS)
+            return false;
+        WorkList.insert(WorkList.end(), BB->Succs.begin(), BB->Succs.end());
+    }
+
+    // Single entry: only the head enters the region, and nothing outside
+    // the region branches to the join, so the join reconverges exactly the
+    // channels active in the head.
+    for (auto BB : Region) {
+        for (auto Pred : BB->Preds)
+            if (Pred != Head && !inRegion(Pred))
+                return false;
+    }
+    for (auto Pred : Join->Preds)
+        if (Pred != Head && !inRegion(Pred))
+            return false;
+    int JoinSCC = SCCIndex[Join->getId()];
+    if (JoinSCC != -1 && JoinSCC != HeadSCC)
+        return false;
+
+    unsigned NumWork = 0;
+    for (auto BB : Region) {
+        for (auto Inst : *BB) {
+            if (Inst->isLabel())
+                continue;
+            if (!Inst->isFlowControl()) {
+                if (CheckBarrier(Inst) != DepType::NODEP ||
+                    hasIndirectOpnd(Inst) || Inst->isFence())
+                    return false;
+                ++NumWork;
+            }
+            RegionInsts.push_back(Inst);
+            if (RegionInsts.size() > HOIST_REGION_MAX_INSTS)
+                return false;
+        }
+    }
+
+    // Nothing to hide the latency behind.
+    return NumWork > 0;
+}
+
+bool GlobalSendHoisting::isCandidate(G4_INST* Send) const
+{
+    if (!Send->isSend() || Send->isSendc() || Send->isEOT() || Send->isFence())
+        return false;
+
+    G4_SendMsgDescriptor* MsgDesc = Send->getMsgDesc();
+    if (!MsgDesc || MsgDesc->ResponseLength() == 0 ||
+        MsgDesc->isDataPortWrite() || MsgDesc->isAtomicMessage() ||
+        MsgDesc->isScratchRW() || MsgDesc->isThreadMessage())
+        return false;
+    if (!MsgDesc->isDataPortRead() && !MsgDesc->isSampler())
+        return false;
+
+    G4_DstRegRegion* Dst = Send->getDst();
+    if (!Dst || Dst->isNullReg() || hasIndirectOpnd(Send) ||
+        CheckBarrier(Send) != DepType::NODEP)
+        return false;
+
+    if (isPhyicallyAllocatedRegVar(Dst))
+        return false;
+    for (auto OpNum : { Opnd_src0, Opnd_src1, Opnd_src2, Opnd_src3, Opnd_pred }) {
+        if (isPhyicallyAllocatedRegVar(Send->getOperand(OpNum)))
+            return false;
+    }
+
+    return true;
+}
+
+bool GlobalSendHoisting::hasDependency(G4_INST* Send, G4_INST* Inst) const
+{
+    if (Inst->isSend()) {
+        G4_SendMsgDescriptor* MsgDesc = Inst->getMsgDesc();
+        if (!MsgDesc || MsgDesc->isScratchRW())
+            return true;
+        if (getDepSend(Send, Inst, kernel.getOptions(), BTIIsRestrict) != DepType::NODEP)
+            return true;
+    }
+
+    static const Gen4_Operand_Number WriteOpnds[] = {
+        Opnd_dst, Opnd_condMod, Opnd_implAccDst
+    };
+    static const Gen4_Operand_Number AllOpnds[] = {
+        Opnd_dst, Opnd_condMod, Opnd_implAccDst, Opnd_src0, Opnd_src1,
+        Opnd_src2, Opnd_src3, Opnd_pred, Opnd_implAccSrc
+    };
+
+    auto isRegOpnd = [](G4_Operand* Opnd) {
+        return Opnd && Opnd->getBase() && !Opnd->isNullReg() &&
+               (Opnd->isDstRegRegion() || Opnd->isSrcRegRegion() ||
+                Opnd->isPredicate() || Opnd->isCondMod());
+    };
+    auto overlaps = [&](G4_Operand* A, G4_Operand* B) {
+        if (!isRegOpnd(A) || !isRegOpnd(B))
+            return false;
+        // Physical registers may alias through different declares.
+        if (isPhyicallyAllocatedRegVar(B))
+            return true;
+        return A->compareOperand(B) != G4_CmpRelation::Rel_disjoint;
+    };
+
+    // RAW and WAW: Inst writes what Send reads or writes.
+    for (auto InstOp : WriteOpnds) {
+        G4_Operand* Opnd = Inst->getOperand(InstOp);
+        for (auto SendOp : AllOpnds) {
+            if (overlaps(Send->getOperand(SendOp), Opnd))
+                return true;
+        }
+    }
+
+    // WAR: Inst reads what Send writes.
+    for (auto InstOp : AllOpnds) {
+        G4_Operand* Opnd = Inst->getOperand(InstOp);
+        if (overlaps(Send->getDst(), Opnd))
+            return true;
+    }
+
+    return false;
+}
+
+bool GlobalSendHoisting::hoistFromJoin(
+    G4_BB* Head, G4_BB* Join, std::vector<G4_BB*>& Region,
+    std::vector<G4_INST*>& RegionInsts)
+{
+    unsigned Threshold = getLatencyHidingThreshold(kernel.getOptions());
+    unsigned RegionPressure = 0;
+    for (auto BB : Region) {
+        unsigned Pressure = rp.getPressure(BB) + ExtraPressure[BB->getId()];
+        RegionPressure = std::max(RegionPressure, Pressure);
+    }
+    if (RegionPressure >= Threshold)
+        return false;
+
+    G4_INST* Term = Head->back();
+    auto InsertPos = std::prev(Head->end());
+
+    // Instructions at the top of the join that stay behind.
+    std::vector<INST_LIST_ITER> Stayed;
+    bool Changed = false;
+    unsigned Scanned = 0;
+    for (auto I = Join->begin(), E = Join->end(); I != E && Scanned < HOIST_JOIN_SCAN_WINDOW; ) {
+        G4_INST* Inst = *I;
+        auto Curr = I++;
+        if (Inst->isLabel())
+            continue;
+        ++Scanned;
+
+        // Reconvergence at the top of the join does not change the mask the
+        // rest of the join runs with, but any other barrier ends the scan.
+        bool IsReconvergence = Inst->opcode() == G4_join || Inst->opcode() == G4_endif;
+        if (!IsReconvergence &&
+            (Inst->isFlowControl() || CheckBarrier(Inst) != DepType::NODEP ||
+             hasIndirectOpnd(Inst) || Inst->isFence()))
+            break;
+
+        if (!isCandidate(Inst)) {
+            Stayed.push_back(Curr);
+            continue;
+        }
+
+        // A pseudo-kill of the message's destination moves along with it.
+        G4_Declare* DstDcl = Inst->getDst()->getTopDcl();
+        std::vector<INST_LIST_ITER> Kills;
+        bool CanHoist = true;
+        for (auto SI : Stayed) {
+            G4_INST* X = *SI;
+            if (X->isPseudoKill() && X->getDst() && X->getDst()->getTopDcl() == DstDcl) {
+                Kills.push_back(SI);
+                continue;
+            }
+            if (hasDependency(Inst, X)) {
+                CanHoist = false;
+                break;
+            }
+        }
+        if (CanHoist && hasDependency(Inst, Term))
+            CanHoist = false;
+        for (auto X : RegionInsts) {
+            if (!CanHoist)
+                break;
+            CanHoist = !hasDependency(Inst, X);
+        }
+
+        unsigned Size = Inst->getMsgDesc()->ResponseLength();
+        if (CanHoist && RegionPressure + Size >= Threshold)
+            CanHoist = false;
+
+        if (!CanHoist) {
+            Stayed.push_back(Curr);
+            continue;
+        }
+
+        SCHED_DUMP(std::cerr << "Hoist from BB" << Join->getId() << " to BB"
+            << Head->getId() << ": "; Inst->dump());
+
+        for (auto KI : Kills) {
+            Head->splice(InsertPos, Join, KI);
+            Stayed.erase(std::find(Stayed.begin(), Stayed.end(), KI));
+        }
+        Head->splice(InsertPos, Join, Curr);
+        Head->setSendInBB(true);
+
+        RegionPressure += Size;
+        for (auto BB : Region)
+            ExtraPressure[BB->getId()] += Size;
+        Changed = true;
+    }
+
+    return Changed;
+}
@@ -38,25 +38,34 @@ namespace vISA
 #undef DEF_MATH_LATENCY
 #undef DEF_SEND_LATENCY
 #define DEF_INSTR_LATENCY(OP, LAT, DEL) InstLatTable[OP] = {LAT, DEL};
-#define DEF_MATH_LATENCY(...)
-#define DEF_SEND_LATENCY(...)
-#include "SKL_latencies.def"
-
-#undef DEF_INSTR_LATENCY
-#undef DEF_MATH_LATENCY
-#undef DEF_SEND_LATENCY
-#define DEF_INSTR_LATENCY(...)
 #define DEF_MATH_LATENCY(OP, LAT, DEL) MathLatTable[OP] = {LAT, DEL};
-#define DEF_SEND_LATENCY(...)
+#define DEF_SEND_LATENCY(OP, LAT, DEL) SendLatTable[OP] = {LAT, DEL};
+            // Gen9 is the baseline; later generations only list the
+            // entries that differ from it.
 #include "SKL_latencies.def"
-
+            switch (getPlatformGeneration(getGenxPlatform())) {
+            case PlatformGen::GEN10:
+#include "CNL_latencies.def"
+                break;
+            case PlatformGen::GEN11:
+#include "ICL_latencies.def"
+                break;
+            default:
+                break;
+            }
 #undef DEF_INSTR_LATENCY
 #undef DEF_MATH_LATENCY
 #undef DEF_SEND_LATENCY
-#define DEF_INSTR_LATENCY(...)
-#define DEF_MATH_LATENCY(...)
-#define DEF_SEND_LATENCY(OP, LAT, DEL) SendLatTable[OP] = {LAT, DEL};
-#include "SKL_latencies.def"
+        }
+
+        // Total latency of a message to the given shared function, or the
+        // default (SFID_NUM) one if the function has no entry.
+        uint32_t getSendLatency(CISA_SHARED_FUNCTION_ID sfid) const {
+            auto it = SendLatTable.find(sfid);
+            if (it == SendLatTable.end()) {
+                it = SendLatTable.find(SFID_NUM);
+            }
+            return it->second.getSumOldStyle();
         }
 
         Latency getLatency(G4_INST *inst) const {
@@ -103,10 +112,8 @@ namespace vISA
                     G4_DstRegRegion *dstRgn = inst->getDst();
                     assert(dstRgn);
                     G4_Type dstType = dstRgn->getType();
-                    G4_Type src1Type
-                        = inst->getSrc(0)->asSrcRegRegion()->getType();
-                    G4_Type src2Type
-                        = inst->getSrc(1)->asSrcRegRegion()->getType();
+                    G4_Type src1Type = inst->getSrc(0)->getType();
+                    G4_Type src2Type = inst->getSrc(1)->getType();
                     uint32_t extraLatency = 0;
                     if (IS_TYPE_INT(dstType)
                         && IS_DTYPE(src1Type)
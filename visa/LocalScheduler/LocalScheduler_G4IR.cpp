@@ -73,11 +73,13 @@ void LocalScheduler::localScheduling()
     LatencyTable LT(m_options);
 
 
+    // mem pool for each BB, reset before scheduling the next one
+    Mem_Manager bbMem(4096);
+
     for (; ib != bend; ++ib)
     {
         unsigned int instCountBefore = (uint32_t)(*ib)->size();
-        // mem pool for each BB
-        Mem_Manager bbMem(4096);
+        bbMem.reset();
 
         if (instCountBefore < SCH_THRESHOLD)
         {
@@ -91,37 +93,48 @@ void LocalScheduler::localScheduling()
             // traversing DAG in list scheduler, stack overflow occurs.
             // So artificially breakup inst list here to reduce size
             // of scheduler problem size.
-            unsigned int count = 0;
-            std::vector<G4_BB*> sections;
-
-            for (INST_LIST_ITER inst_it = (*ib)->begin();
-                ;
-                inst_it++)
+            //
+            // Consecutive windows may overlap: the last schedulerWindowOverlap
+            // instructions of a scheduled window are not committed, but
+            // carried over to the head of the next window so that they can
+            // still be interleaved with the instructions following them.
+            unsigned int overlap = std::min(
+                m_options->getuInt32Option(vISA_SchedulerWindowOverlap),
+                schedulerWindowSize / 2);
+            G4_BB* curBB = *ib;
+            G4_BB* windowBB = fg.createNewBB(false);
+            G4_BB* scheduledBB = fg.createNewBB(false);
+
+            while (!curBB->empty())
             {
-                if (count == schedulerWindowSize ||
-                    inst_it == (*ib)->end())
+                bbMem.reset();
+
+                INST_LIST_ITER windowEnd = curBB->begin();
+                for (size_t count = windowBB->size();
+                    count < schedulerWindowSize && windowEnd != curBB->end();
+                    ++count, ++windowEnd)
+                    ;
+                windowBB->splice(windowBB->end(), curBB, curBB->begin(), windowEnd);
+
                 {
-                    G4_BB* tempBB = fg.createNewBB(false);
-                    sections.push_back(tempBB);
-                    tempBB->splice(tempBB->begin(),
-                        (*ib), (*ib)->begin(), inst_it);
-                    G4_BB_Schedule schedule(fg.getKernel(), bbMem, tempBB, buildDDD, listSch,
+                    G4_BB_Schedule schedule(fg.getKernel(), bbMem, windowBB, buildDDD, listSch,
                         totalCycle, m_options, LT);
-
-                    count = 0;
                 }
-                count++;
 
-                if (inst_it == (*ib)->end())
+                // Commit everything but the overlapping tail.
+                INST_LIST_ITER carryBegin = windowBB->end();
+                if (!curBB->empty())
                 {
-                    break;
+                    for (unsigned int j = 0; j < overlap; j++)
+                    {
+                        --carryBegin;
+                    }
                 }
+                scheduledBB->splice(scheduledBB->end(), windowBB, windowBB->begin(), carryBegin);
             }
 
-            for (unsigned int i = 0; i < sections.size(); i++)
-            {
-                (*ib)->splice((*ib)->end(), sections[i], sections[i]->begin(), sections[i]->end());
-            }
+            MUST_BE_TRUE(windowBB->empty(), ERROR_SCHEDULER);
+            curBB->splice(curBB->end(), scheduledBB, scheduledBB->begin(), scheduledBB->end());
         }
         else
         {
@@ -581,7 +594,29 @@ bool DDD::getBucketDescrs(Node *node, std::vector<BucketDescr>& BDvec)
 }
 
 
+// Return TRUE if OPND_NUM names an operand that only reads its register.
+static inline bool isReadOpnd(Gen4_Operand_Number opnd_num)
+{
+    switch (opnd_num) {
+    case Opnd_src0:
+    case Opnd_src1:
+    case Opnd_src2:
+    case Opnd_src3:
+    case Opnd_implAccSrc:
+    case Opnd_pred:
+        return true;
+    default:
+        return false;
+    }
+}
+
 // This class hides the internals of dependence tracking using buckets
+//
+// Each bucket keeps its live readers and live writers in two separate
+// vectors (slots). Two reads never depend on each other, so a reading
+// instruction only needs to scan the writer slot. Without this split a
+// register read by every instruction of a large block (e.g. a loop invariant
+// in a fully unrolled loop) makes DAG construction quadratic.
 class LiveBuckets
 {
     std::vector<BucketHeadNode> nodeBucketsArray;
@@ -592,6 +627,9 @@ class LiveBuckets
     static const bool ALL_BUCKETS = true;
 
 public:
+    // Map a bucket and an access kind to the slot holding the live nodes.
+    static int getSlot(int bucket, bool isRead) { return bucket * 2 + (isRead ? 1 : 0); }
+
     class BN_iterator
     {
     public:
@@ -663,8 +701,8 @@ public:
     };
 
     LiveBuckets(DDD *Ddd, int GRF_BUCKET, int TOTAL_BUCKETS) {
-        firstBucket = GRF_BUCKET;
-        numOfBuckets = TOTAL_BUCKETS;
+        firstBucket = getSlot(GRF_BUCKET, false);
+        numOfBuckets = getSlot(TOTAL_BUCKETS, false);
         ddd = Ddd;
         nodeBucketsArray.resize(numOfBuckets);
 
@@ -686,16 +724,16 @@ public:
         }
     }
 
-    // Mode 1: Iterate across nodes in BUCKET
-    BN_iterator begin(int bucket) const {
-        return BN_iterator(this, nodeBucketsArray[bucket].bucketVec->begin(),
-            bucket, !ALL_BUCKETS);
+    // Mode 1: Iterate across nodes in SLOT
+    BN_iterator begin(int slot) const {
+        return BN_iterator(this, nodeBucketsArray[slot].bucketVec->begin(),
+            slot, !ALL_BUCKETS);
     }
 
     // Mode 1:
-    BN_iterator end(int bucket) const {
-        return BN_iterator(this, nodeBucketsArray[bucket].bucketVec->end(),
-            bucket, !ALL_BUCKETS);
+    BN_iterator end(int slot) const {
+        return BN_iterator(this, nodeBucketsArray[slot].bucketVec->end(),
+            slot, !ALL_BUCKETS);
     }
 
     // Mode 2: Iterate across all nodes and all buckets
@@ -714,19 +752,19 @@ public:
             numOfBuckets, ALL_BUCKETS);
     }
 
-    void clearLive(int bucket) {
-        BucketHeadNode &BHNode = nodeBucketsArray[bucket];
+    void clearLive(int slot) {
+        BucketHeadNode &BHNode = nodeBucketsArray[slot];
         BHNode.bucketVec->clear();
     }
 
     void clearAllLive() {
-        for (int bucket_i = 0; bucket_i < numOfBuckets; ++bucket_i) {
-            clearLive(bucket_i);
+        for (int slot_i = 0; slot_i < numOfBuckets; ++slot_i) {
+            clearLive(slot_i);
         }
     }
 
-    bool hasLive(const Mask &mask, int bucket) {
-        BucketHeadNode &BHNode = nodeBucketsArray[bucket];
+    bool hasLive(const Mask &mask, int slot) {
+        BucketHeadNode &BHNode = nodeBucketsArray[slot];
         auto BV = BHNode.bucketVec;
         assert(BV != nullptr && "vectors not initialized?");
         return (!BV->empty());
@@ -748,7 +786,7 @@ public:
     // Create a bucket node for NODE using the information in BD
     // and append it to the list of live nodes.
     void add(Node *node, const BucketDescr &BD) {
-        BucketHeadNode &BHNode = nodeBucketsArray[BD.bucket];
+        BucketHeadNode &BHNode = nodeBucketsArray[getSlot(BD.bucket, isReadOpnd(BD.operand))];
         // Append the bucket node to the vector hanging from the header
         assert(BHNode.bucketVec != nullptr);
         BUCKET_VECTOR& nodeVec = *(BHNode.bucketVec);
@@ -905,76 +943,83 @@ DDD::DDD(Mem_Manager &m, G4_BB* bb, const Options *options,
                 const int &curBucket = BD.bucket;
                 const Gen4_Operand_Number &curOpnd = BD.operand;
                 const Mask &curMask = BD.mask;
-                if (!LB.hasLive(curMask, curBucket)) {
-                    continue;
-                }
                 // Kill type 1: When the current destination region completely
                 //              covers the whole register from the first bit
                 //              to the last bit.
                 bool curKillsBucket = curMask.killsBucket(curBucket);
 
-                // For each live curBucket node:
-                // i)  create edge if required
-                // ii) kill bucket node if required
-                for (LiveBuckets::BN_iterator bn_it = LB.begin(curBucket);
-                    bn_it != LB.end(curBucket);) {
-                    BucketNode *liveBN = (*bn_it);
-                    Node *curLiveNode = liveBN->node;
-                    Gen4_Operand_Number liveOpnd = liveBN->opndNum;
-                    Mask &liveMask = liveBN->mask;
-
-                    G4_INST *liveInst = *curLiveNode->getInstructions()->begin();
-                    // Kill type 2: When the current destination region covers
-                    //              the live node's region completely.
-                    bool curKillsLive = curMask.kills(liveMask);
-                    bool hasOverlap = curMask.hasOverlap(liveMask);
-
-                    // 1. Find DEP type
-                    DepType dep = DEPTYPE_MAX;
-                    if (curBucket < ACC_BUCKET) {
-                        dep = getDepForOpnd(curOpnd, liveOpnd);
-                    } else if (curBucket == ACC_BUCKET
-                        || curBucket == A0_BUCKET) {
-                        dep = getDepForOpnd(curOpnd, liveOpnd);
-                        curKillsBucket = false;
-                    } else if (curBucket == SEND_BUCKET) {
-                        dep = getDepSend(curInst, liveInst, m_options, BTIIsRestrict);
-                        hasOverlap = (dep != NODEP);
-                        curKillsBucket = false;
-                        curKillsLive = (dep == WAW_MEMORY || dep == RAW_MEMORY);
-                    } else if (curBucket == SCRATCH_SEND_BUCKET) {
-                        dep = getDepScratchSend(curInst, liveInst);
-                        hasOverlap = (dep != NODEP);
-                        curKillsBucket = false;
-                        curKillsLive = false; // Disable kill
-                    } else if (curBucket == FLAG0_BUCKET
-                        || curBucket == FLAG1_BUCKET) {
-                        dep = getDepForOpnd(curOpnd, liveOpnd);
-                        curKillsBucket = false;
-                    } else if (curBucket == OTHER_ARF_BUCKET) {
-                        dep = getDepForOpnd(curOpnd, liveOpnd);
-                        hasOverlap = (dep != NODEP); // Let's be conservative
-                        curKillsBucket = false;
-                    } else {
-                        assert(0 && "Bad bucket");
+                // A read only depends on live writers; a write depends on
+                // both live writers and live readers.
+                int numSlots = isReadOpnd(curOpnd) ? 1 : 2;
+                for (int slot_i = 0; slot_i < numSlots; ++slot_i) {
+                    int curSlot = LiveBuckets::getSlot(curBucket, slot_i != 0);
+                    if (!LB.hasLive(curMask, curSlot)) {
+                        continue;
                     }
 
-                    // 2. Create Edge if there is overlap and RAW/WAW/WAR
-                    if (dep != NODEP && hasOverlap) {
-                        createAddEdge(node, curLiveNode, dep);
-                        transitiveEdgeToBarrier
-                            |= curLiveNode->hasTransitiveEdgeToBarrier;
-                    }
+                    // For each live curBucket node:
+                    // i)  create edge if required
+                    // ii) kill bucket node if required
+                    for (LiveBuckets::BN_iterator bn_it = LB.begin(curSlot);
+                        bn_it != LB.end(curSlot);) {
+                        BucketNode *liveBN = (*bn_it);
+                        Node *curLiveNode = liveBN->node;
+                        Gen4_Operand_Number liveOpnd = liveBN->opndNum;
+                        Mask &liveMask = liveBN->mask;
+
+                        G4_INST *liveInst = *curLiveNode->getInstructions()->begin();
+                        // Kill type 2: When the current destination region covers
+                        //              the live node's region completely.
+                        bool curKillsLive = curMask.kills(liveMask);
+                        bool hasOverlap = curMask.hasOverlap(liveMask);
+
+                        // 1. Find DEP type
+                        DepType dep = DEPTYPE_MAX;
+                        if (curBucket < ACC_BUCKET) {
+                            dep = getDepForOpnd(curOpnd, liveOpnd);
+                        } else if (curBucket == ACC_BUCKET
+                            || curBucket == A0_BUCKET) {
+                            dep = getDepForOpnd(curOpnd, liveOpnd);
+                            curKillsBucket = false;
+                        } else if (curBucket == SEND_BUCKET) {
+                            dep = getDepSend(curInst, liveInst, m_options, BTIIsRestrict);
+                            hasOverlap = (dep != NODEP);
+                            curKillsBucket = false;
+                            curKillsLive = (dep == WAW_MEMORY || dep == RAW_MEMORY);
+                        } else if (curBucket == SCRATCH_SEND_BUCKET) {
+                            dep = getDepScratchSend(curInst, liveInst);
+                            hasOverlap = (dep != NODEP);
+                            curKillsBucket = false;
+                            curKillsLive = false; // Disable kill
+                        } else if (curBucket == FLAG0_BUCKET
+                            || curBucket == FLAG1_BUCKET) {
+                            dep = getDepForOpnd(curOpnd, liveOpnd);
+                            curKillsBucket = false;
+                        } else if (curBucket == OTHER_ARF_BUCKET) {
+                            dep = getDepForOpnd(curOpnd, liveOpnd);
+                            hasOverlap = (dep != NODEP); // Let's be conservative
+                            curKillsBucket = false;
+                        } else {
+                            assert(0 && "Bad bucket");
+                        }
 
-                    // 3. Kill if required
-                    if ((dep == RAW || dep == RAW_MEMORY
-                        || dep == WAW || dep == WAW_MEMORY)
-                        && (curKillsBucket || curKillsLive)) {
-                        LB.kill(curMask, bn_it);
-                        continue;
+                        // 2. Create Edge if there is overlap and RAW/WAW/WAR
+                        if (dep != NODEP && hasOverlap) {
+                            createAddEdge(node, curLiveNode, dep);
+                            transitiveEdgeToBarrier
+                                |= curLiveNode->hasTransitiveEdgeToBarrier;
+                        }
+
+                        // 3. Kill if required
+                        if ((dep == RAW || dep == RAW_MEMORY
+                            || dep == WAW || dep == WAW_MEMORY)
+                            && (curKillsBucket || curKillsLive)) {
+                            LB.kill(curMask, bn_it);
+                            continue;
+                        }
+                        assert(dep != DEPTYPE_MAX && "dep unassigned?");
+                        ++bn_it;
                     }
-                    assert(dep != DEPTYPE_MAX && "dep unassigned?");
-                    ++bn_it;
                 }
             }
 
@@ -1807,7 +1852,7 @@ uint32_t DDD::getEdgeLatency_old(Node *node, DepType depT)
         G4_SendMsgDescriptor *msgDesc = inst->getMsgDesc();
         if (msgDesc->isDataPortRead())
         {
-            return msgDesc->getFFLatency();
+            return LT.getSendLatency(msgDesc->getFuncId());
         }
     }
 
@@ -1823,7 +1868,7 @@ uint32_t DDD::getEdgeLatency_old(Node *node, DepType depT)
     case RAW_MEMORY:
         if (inst->isSend())
         {
-            latency = G4_SendMsgDescriptor::getDefaultFFLatency();
+            latency = LT.getSendLatency(SFID_NUM);
 
             G4_SendMsgDescriptor *msgDesc = inst->getMsgDesc();
             if (msgDesc)
@@ -1834,32 +1879,19 @@ uint32_t DDD::getEdgeLatency_old(Node *node, DepType depT)
                 {
                     if (!isMemSend(msgDesc))
                     {
-                        latency = msgDesc->getFFLatency();
+                        latency = LT.getSendLatency(msgDesc->getFuncId());
                     }
                 }
                 else
                 {
-                    latency = msgDesc->getFFLatency();
+                    latency = LT.getSendLatency(msgDesc->getFuncId());
                 }
             }
         }
-        else if (inst->isMath())
-        {
-            // Use EdgeLatencyMathType2 for FDIV, FPOW functions.
-            if (inst->asMathInst()->getMathCtrl() == MATH_FDIV ||
-                inst->asMathInst()->getMathCtrl() == MATH_POW)
-            {
-                latency = EDGE_LATENCY_MATH_TYPE2;
-            }
-            // Used EdgeLatencyMath for other functions.
-            else
-            {
-                latency = EDGE_LATENCY_MATH;
-            }
-        }
         else
         {
-            latency = IVB_PIPELINE_LENGTH;
+            // Math and ALU latencies come from the platform's table.
+            latency = LT.getLatency(inst).getSumOldStyle();
         }
         break;
 
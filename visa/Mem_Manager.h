@@ -45,6 +45,23 @@ namespace vISA
             return _arenaManager.AllocDataSpace(size);
         }
 
+        // Release everything allocated so far; the memory is kept in the
+        // thread's arena pool for reuse.
+        void reset()
+        {
+            _arenaManager.Reset();
+        }
+
+        // Size arenas for about expectedBytes of allocations.
+        void setSizeHint(size_t expectedBytes)
+        {
+            _arenaManager.SetSizeHint(expectedBytes);
+        }
+
+        size_t getAllocatedSize() const { return _arenaManager._allocatedBytes; }
+        size_t getPeakAllocatedSize() const { return _arenaManager._peakAllocatedBytes; }
+        size_t getPeakReservedSize() const { return _arenaManager._peakReservedBytes; }
+
     private:
 
         vISA::ArenaManager _arenaManager;
@@ -37,12 +37,43 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <chrono>
 #include "FlowGraph.h"
 #include "SendFusion.h"
+#include "PerfEstimate.h"
+#include "GraphColor.h"
+#include "RPE.h"
 #include "Common_BinaryEncoding.h"
 #include <tuple>
+#include <memory>
 
 using namespace std;
 using namespace vISA;
 
+// bb may reuse the LVN values of pred when control reaches it only from pred
+// and the execution mask is the same: either pred falls through or ends with
+// a scalar jmpi, and bb does not start with SIMD control flow. Calls are
+// excluded since the callee may write anything.
+static bool canExtendLVN(G4_BB* pred, G4_BB* bb)
+{
+    if (bb->Preds.size() != 1 || bb->Preds.front() != pred)
+    {
+        return false;
+    }
+
+    G4_INST* lastInst = pred->empty() ? nullptr : pred->back();
+    if (lastInst && lastInst->isFlowControl() && lastInst->opcode() != G4_jmpi)
+    {
+        return false;
+    }
+    if (lastInst && lastInst->opcode() == G4_jmpi &&
+        lastInst->getSrc(0) && !lastInst->getSrc(0)->isLabel())
+    {
+        // indirect jump
+        return false;
+    }
+
+    G4_INST* firstInst = bb->getFirstInst();
+    return !firstInst || !firstInst->isFlowControl();
+}
+
 void Optimizer::LVN()
 {
     // Run a simple LVN pass that replaces redundant
@@ -53,20 +84,35 @@ void Optimizer::LVN()
     // done by FE generating VISA. This pass catches
     // redundancies that got introduced mainly by HW
     // conformity or due to VISA lowering.
+    //
+    // With vISA_ExtendedLVN the value table of a BB is carried into the next
+    // BB when that BB is entered only from it, so redundant address and
+    // header setups repeated after a uniform branch are removed as well.
     int numInstsRemoved = 0;
     Mem_Manager mem(1024);
     PointsToAnalysis p(kernel.Declares, kernel.fg.getNumBB());
     p.doPointsToAnalysis(kernel.fg);
+    bool extendedLVN = kernel.getOption(vISA_ExtendedLVN);
+    std::unique_ptr<::LVN> lvn;
+    G4_BB* prevBB = nullptr;
     for(BB_LIST_ITER bb_it = kernel.fg.BBs.begin();
         bb_it != kernel.fg.BBs.end();
         bb_it++)
     {
         G4_BB* bb = (*bb_it);
-        ::LVN lvn(fg, bb, mem, *fg.builder, p);
+        if (extendedLVN && lvn && canExtendLVN(prevBB, bb))
+        {
+            lvn->continueInBB(bb);
+        }
+        else
+        {
+            lvn.reset(new ::LVN(fg, bb, mem, *fg.builder, p));
+        }
 
-        lvn.doLVN();
+        lvn->doLVN();
 
-        numInstsRemoved += lvn.getNumInstsRemoved();
+        numInstsRemoved += lvn->getNumInstsRemoved();
+        prevBB = bb;
     }
 
     if(kernel.getOption(vISA_OptReport))
@@ -246,7 +292,10 @@ void Optimizer::regAlloc()
     //
     // assign registers
     //
+    FINALIZER_INFO* jitInfo = builder.getJitInfo();
+    jitInfo->peakIRArenaKB = (unsigned int)(ArenaUsage::TakePeak() / 1024);
     int status = ::regAlloc(builder, builder.phyregpool, kernel);
+    jitInfo->peakRAArenaKB = (unsigned int)(ArenaUsage::TakePeak() / 1024);
     if (status != CM_SUCCESS)
     {
         RAFail = true;
@@ -255,6 +304,12 @@ void Optimizer::regAlloc()
 
 void Optimizer::countBankConflicts()
 {
+    // The conflict count feeds both the opt report and the perf estimate.
+    if (!builder.getOption(vISA_OptReport) && !builder.getOption(vISA_PerfEstimateReport))
+    {
+        return;
+    }
+
     std::list<G4_INST*> conflicts;
     unsigned int numLocals = 0, numGlobals = 0;
     bool isSKLPlus = ( getGenxPlatform() >= GENX_SKL ? true : false );
@@ -386,7 +441,7 @@ void Optimizer::countBankConflicts()
         }
     }
 
-    if(numBankConflicts > 0)
+    if(numBankConflicts > 0 && builder.getOption(vISA_OptReport))
     {
         std::ofstream optreport;
         getOptReportStream( optreport, builder.getOptions() );
@@ -410,6 +465,16 @@ void Optimizer::countBankConflicts()
     }
 }
 
+void Optimizer::emitPerfEstimate()
+{
+    if (!builder.getOption(vISA_PrintRegUsage))
+    {
+        // the report includes the GRF count
+        countGRFUsage();
+    }
+    vISA::emitPerfEstimate(kernel, numBankConflicts);
+}
+
 void Optimizer::insertDummyCompactInst()
 {
     // Only for SKL+ and compaction is enabled.
@@ -597,7 +662,7 @@ void Optimizer::initOptimizations()
     INITIALIZE_PASS(preRA_Schedule,          vISA_preRA_Schedule,          TIMER_PRERA_SCHEDULING);
     INITIALIZE_PASS(regAlloc,                vISA_EnableAlways,            TIMER_TOTAL_RA);
     INITIALIZE_PASS(removeLifetimeOps,       vISA_EnableAlways,            TIMER_MISC_OPTS);
-    INITIALIZE_PASS(countBankConflicts,      vISA_OptReport,               TIMER_MISC_OPTS);
+    INITIALIZE_PASS(countBankConflicts,      vISA_EnableAlways,            TIMER_MISC_OPTS);
     INITIALIZE_PASS(removeRedundMov,         vISA_EnableAlways,            TIMER_MISC_OPTS);
     INITIALIZE_PASS(removeEmptyBlocks,       vISA_EnableAlways,            TIMER_MISC_OPTS);
     INITIALIZE_PASS(insertFallThroughJump,   vISA_EnableAlways,            TIMER_MISC_OPTS);
@@ -623,6 +688,7 @@ void Optimizer::initOptimizations()
     INITIALIZE_PASS(initializePayload,       vISA_InitPayload,             TIMER_NUM_TIMERS);
     INITIALIZE_PASS(cleanupBindless,         vISA_enableCleanupBindless,   TIMER_OPTIMIZER);
     INITIALIZE_PASS(countGRFUsage,           vISA_PrintRegUsage,           TIMER_MISC_OPTS);
+    INITIALIZE_PASS(emitPerfEstimate,        vISA_PerfEstimateReport,      TIMER_MISC_OPTS);
     INITIALIZE_PASS(splitVariables,          vISA_EnableSplitVariables,    TIMER_MISC_OPTS);
     INITIALIZE_PASS(changeMoveType,          vISA_ChangeMoveType,          TIMER_MISC_OPTS);
     INITIALIZE_PASS(reRAPostSchedule,        vISA_ReRAPostSchedule,        TIMER_OPTIMIZER);
@@ -633,6 +699,9 @@ void Optimizer::initOptimizations()
     INITIALIZE_PASS(loadThreadPayload,       vISA_loadThreadPayload,       TIMER_MISC_OPTS);
     INITIALIZE_PASS(insertFenceBeforeEOT,    vISA_EnableAlways,            TIMER_MISC_OPTS);
     INITIALIZE_PASS(insertScratchReadBeforeEOT, vISA_clearScratchWritesBeforeEOT, TIMER_MISC_OPTS);
+    INITIALIZE_PASS(rewriteForCompaction,    vISA_CompactionRewrite,       TIMER_MISC_OPTS);
+    INITIALIZE_PASS(hoistLoopInvariantHeaders, vISA_LICMHeaders,          TIMER_OPTIMIZER);
+    INITIALIZE_PASS(reuseAddressComputations, vISA_ReuseAddr,            TIMER_OPTIMIZER);
 
     // Verify all passes are initialized.
 #ifdef _DEBUG
@@ -1123,6 +1192,12 @@ int Optimizer::optimization()
     // Local Value Numbering
     runPass(PI_LVN);
 
+    // Reuse address registers across indirect accesses with the same base
+    runPass(PI_reuseAddressComputations);
+
+    // Lift loop-invariant header construction out of loops
+    runPass(PI_hoistLoopInvariantHeaders);
+
     runPass(PI_split4GRFVars);
 
     runPass(PI_insertFenceBeforeEOT);
@@ -1208,10 +1283,14 @@ int Optimizer::optimization()
 
     runPass(PI_normalizeRegion);
 
+    runPass(PI_rewriteForCompaction);
+
     runPass(PI_changeMoveType);
 
     runPass(PI_countGRFUsage);
 
+    runPass(PI_emitPerfEstimate);
+
     runPass(PI_dumpPayload);
 
     // this must be the last step of the optimization so as to not violate
@@ -7251,6 +7330,67 @@ public:
         }
     }
 
+    //
+    // rewrite operands that have several equivalent encodings into the one found in the
+    // compaction tables, so that more instructions can be encoded in compacted form:
+    // -- scalar source regions (any <0;w,0>, or any region at exec size 1) become <0;1,0>
+    // -- the destination of an exec size 1 instruction gets horizontal stride 1
+    // Must run after RA and normalizeRegion, once regions are final.
+    //
+    void Optimizer::rewriteForCompaction()
+    {
+        if (!builder.getOption(vISA_Compaction))
+        {
+            return;
+        }
+
+        for (auto bb : fg.BBs)
+        {
+            for (auto inst : *bb)
+            {
+                if (inst->isSend() || inst->isCall() || inst->isReturn() ||
+                    inst->isAligned16Inst() || inst->isLabel())
+                {
+                    continue;
+                }
+
+                int execSize = inst->getExecSize();
+                bool sameTypeSize = true;
+                G4_DstRegRegion* dst = inst->getDst();
+                for (int i = 0; i < inst->getNumSrc(); ++i)
+                {
+                    G4_Operand* src = inst->getSrc(i);
+                    if (src == nullptr || !src->isSrcRegRegion())
+                    {
+                        continue;
+                    }
+                    if (dst && G4_Type_Table[src->getType()].byteSize != G4_Type_Table[dst->getType()].byteSize)
+                    {
+                        sameTypeSize = false;
+                    }
+                    G4_SrcRegRegion* srcRegion = src->asSrcRegRegion();
+                    if (srcRegion->getRegAccess() != Direct || !srcRegion->isGreg())
+                    {
+                        continue;
+                    }
+                    RegionDesc* rd = srcRegion->getRegion();
+                    if ((execSize == 1 || rd->isScalar()) && rd != builder.getRegionScalar())
+                    {
+                        srcRegion->setRegion(builder.getRegionScalar());
+                    }
+                }
+
+                // A wider stride is only meaningful when it packs a smaller type into the
+                // lanes of a larger one, so leave mixed-size instructions alone.
+                if (execSize == 1 && sameTypeSize && dst && !dst->isNullReg() &&
+                    dst->getRegAccess() == Direct && dst->isGreg() && dst->getHorzStride() > 1)
+                {
+                    dst->setHorzStride(1);
+                }
+            }
+        }
+    }
+
     //
     // rewrite source regions to satisfy various HW requirements.  This pass will not modify the instrppuctions otherwise
     // -- rewrite <1;1,0> to <2;2,1> when possible (exec size > 1, width is not used to cross GRF)
@@ -10517,6 +10657,13 @@ namespace {
         bool sameDataType(const BucketDescr &BD) const {
             return dataType == BD.dataType;
         }
+        // Same size and both integer or both floating point, so both
+        // writes go through the same pipeline with the same latency.
+        bool sameTypeClass(const BucketDescr &BD) const {
+            return G4_Type_Table[dataType].byteSize ==
+                       G4_Type_Table[BD.dataType].byteSize &&
+                   IS_TYPE_INT(dataType) == IS_TYPE_INT(BD.dataType);
+        }
         bool hasOverlapWith(const BucketDescr &BD) const {
             return sameReg(BD) && mask.hasOverlapWith(BD.mask);
         }
@@ -10624,7 +10771,10 @@ namespace {
         // Return TRUE if there is a subreg WAW dependence between
         // this and prevBDW
         // This is TRUE only if the data types match.
-        bool hasSubregWAW(const BucketDescrWrapper &prevBDW) const {
+        // With relaxTypes, types of the same size and kind (e.g. :b and :ub
+        // from packed byte writes) are accepted too.
+        bool hasSubregWAW(const BucketDescrWrapper &prevBDW,
+                          bool relaxTypes) const {
             bool noWAW = false;
             for (const auto &prevBD : prevBDW.BDVec) {
                 if (prevBD.type == WRITE) {
@@ -10632,7 +10782,9 @@ namespace {
                         if (currBD.type == WRITE) {
                             if (currBD.sameReg(prevBD)) {
                                 if (! currBD.hasOverlapWith(prevBD)
-                                    && currBD.sameDataType(prevBD)) {
+                                    && (currBD.sameDataType(prevBD)
+                                        || (relaxTypes
+                                            && currBD.sameTypeClass(prevBD)))) {
                                     noWAW = true;
                                 } else {
                                     return false;
@@ -10645,6 +10797,48 @@ namespace {
             return noWAW;
         }
 
+        // Return TRUE if the writes of this instruction all land inside
+        // the single GRF written by prevBDW, at bytes prevBDW also writes
+        // (e.g. overwriting a few dwords of a message header just copied
+        // with a full-GRF mov).
+        bool isCoveredWAW(const BucketDescrWrapper &prevBDW) const {
+            bool covered = false;
+            for (const auto &currBD : BDVec) {
+                if (currBD.type != WRITE) {
+                    continue;
+                }
+                bool found = false;
+                for (const auto &prevBD : prevBDW.BDVec) {
+                    if (prevBD.type == WRITE && currBD.sameReg(prevBD)) {
+                        if (!prevBD.mask.fullyCovers(currBD.mask)) {
+                            return false;
+                        }
+                        found = true;
+                    }
+                }
+                if (!found) {
+                    return false;
+                }
+                covered = true;
+            }
+            return covered;
+        }
+
+        // Return TRUE if this instruction reads or writes any GRF written
+        // by prevBDW.
+        bool touchesWritesOf(const BucketDescrWrapper &prevBDW) const {
+            for (const auto &prevBD : prevBDW.BDVec) {
+                if (prevBD.type == WRITE) {
+                    for (const auto &currBD : BDVec) {
+                        if (currBD.sameReg(prevBD)) {
+                            return true;
+                        }
+                    }
+                }
+            }
+            return false;
+        }
+
         // Return TRUE if writing to more than 1 GRF
         bool touchesManyGRFs(void) const {
             std::set<int> bucketsTouched;
@@ -10694,18 +10888,44 @@ namespace {
     }
 
 
-    bool mustAddNoDD(const BucketDescrWrapper &prevBDW,
-                     const BucketDescrWrapper &currBDW) {
+    bool mustAddNoDD(G4_INST *prevInstr, G4_INST *currInstr,
+                     const BucketDescrWrapper &prevBDW,
+                     const BucketDescrWrapper &currBDW, bool extended) {
         if (currBDW.hasRAW(prevBDW)) {
             return false;
         }
         // This also confirms that the data types are equal
-        if (currBDW.hasSubregWAW(prevBDW)) {
+        if (currBDW.hasSubregWAW(prevBDW, extended)) {
+            return true;
+        }
+        // Header building: a full 'mov' followed by 'mov's patching parts of
+        // it. Both are in-order on the same pipeline with the same latency,
+        // so the later write still lands last.
+        if (extended
+            && prevInstr->opcode() == G4_mov
+            && currInstr->opcode() == G4_mov
+            && prevInstr->getDst()->getType() == currInstr->getDst()->getType()
+            && currBDW.isCoveredWAW(prevBDW)) {
             return true;
         }
         return false;
     }
 
+    // Return TRUE if PREVINSTR and CURRINSTR are the two halves of an
+    // instruction split by exec size (e.g. SIMD32 into two SIMD16), so
+    // they only share the GRF at the boundary.
+    static bool isSplitHalfPair(G4_INST *prevInstr, G4_INST *currInstr) {
+        G4_DstRegRegion *prevDst = prevInstr->getDst();
+        G4_DstRegRegion *currDst = currInstr->getDst();
+        return prevDst && currDst
+            && prevInstr->opcode() == currInstr->opcode()
+            && prevInstr->getExecSize() == currInstr->getExecSize()
+            && prevDst->getType() == currDst->getType()
+            && prevInstr->getMaskOffset() + prevInstr->getExecSize()
+                   == currInstr->getMaskOffset()
+            && prevDst->getLinearizedEnd() < currDst->getLinearizedStart();
+    }
+
     static bool areOnSamePipeline(G4_INST *prevInstr, G4_INST *currInstr) {
         // Forbid different opcodes
         if (prevInstr->opcode() != currInstr->opcode()) {
@@ -10749,8 +10969,13 @@ static bool tryToAddNoDD(G4_INST *currInstr, G4_INST *prevInstr,
     // 1. To be safe, predicated instrs can kill but cannot cover.
     // 2. Must be on same pipeline
     // 3. If subreg WAW and no RAW dep, insert NoDD flags
+    // With -extendedNoDD, split halves may write more than one GRF,
+    // packed writes may mix signedness and header 'mov's may overwrite
+    // parts of the previous one.
+    bool extended = options->getOption(vISA_ExtendedNoDD);
     if (prevInstr
-        && ! prevBDW.touchesManyGRFs()
+        && (! prevBDW.touchesManyGRFs()
+            || (extended && isSplitHalfPair(prevInstr, currInstr)))
         && ! prevBDW.hasIndirW
         && ! prevInstr->isSend()
         && ! currInstr->isSend()
@@ -10759,7 +10984,7 @@ static bool tryToAddNoDD(G4_INST *currInstr, G4_INST *prevInstr,
         && ! prevBDW.accessesARF()
         && ! currBDW.accessesARF()
         && areOnSamePipeline(prevInstr, currInstr)
-        && mustAddNoDD(prevBDW, currBDW)) {
+        && mustAddNoDD(prevInstr, currInstr, prevBDW, currBDW, extended)) {
 
         // Tag the instructions with the NoDD flag
         prevInstr->setOptionOn(InstOpt_NoDDClr);
@@ -10828,8 +11053,16 @@ void Optimizer::NoDD(void) {
             while (! succ && prevIdx < (int)prevInstrs.size()) {
                 G4_INST *prevInstr = prevInstrs[prevIdx];
                 BucketDescrWrapper &prevBDW = prevBDWs[prevIdx];
-                succ = tryToAddNoDD(currInstr, prevInstr,
-                                    prevBDW, currBDW, options);
+                // Once PREVINSTR skips the scoreboard, nothing between it
+                // and CURRINSTR may read or write the GRFs it writes.
+                bool intervening = false;
+                for (int i = 0; i < prevIdx && ! intervening; ++i) {
+                    intervening = prevBDWs[i].touchesWritesOf(prevBDW);
+                }
+                if (! intervening) {
+                    succ = tryToAddNoDD(currInstr, prevInstr,
+                                        prevBDW, currBDW, options);
+                }
                 prevIdx++;
             }
             prevInstrs.insert(prevInstrs.begin(), currInstr);
@@ -10904,6 +11137,472 @@ void Optimizer::dce()
     }
 }
 
+// Check if Inst computes an address variable from an address-taken
+// variable: "mov A &V+off" or "add A &V+off idx", writing all of A.
+static bool isAddrComputation(G4_INST* Inst)
+{
+    if ((Inst->opcode() != G4_mov && Inst->opcode() != G4_add) ||
+        Inst->getPredicate() || Inst->getCondMod() || Inst->getSaturate() ||
+        !Inst->getSrc(0) || !Inst->getSrc(0)->isAddrExp())
+        return false;
+
+    G4_DstRegRegion* Dst = Inst->getDst();
+    if (!Dst || Dst->isIndirect() || !Dst->getBase()->isRegVar() ||
+        Dst->getTopDcl() == nullptr || Dst->getTopDcl()->getRegFile() != G4_ADDRESS ||
+        Dst->getRegOff() != 0 || Dst->getSubRegOff() != 0 || Dst->getHorzStride() != 1)
+        return false;
+
+    G4_Declare* Dcl = Dst->getBase()->asRegVar()->getDeclare();
+    if (Dcl != Dst->getTopDcl() || Dcl->getElemType() != Dst->getType() ||
+        Dcl->getByteSize() != Inst->getExecSize() * getTypeSize(Dst->getType()))
+        return false;
+
+    if (Inst->opcode() == G4_mov)
+        return true;
+
+    // The index has to be a value that can be compared syntactically.
+    G4_Operand* Idx = Inst->getSrc(1);
+    if (Idx->isImm())
+        return !Idx->isRelocImm();
+    return Idx->isSrcRegRegion() && !Idx->asSrcRegRegion()->isIndirect() &&
+           Idx->isGreg() && Idx->getTopDcl() && !Idx->getTopDcl()->getAddressed();
+}
+
+// Reuse address variables across indirect accesses.
+//
+// Every dynamically indexed access to a GRF array gets its own address
+// computation, so a block accessing the same element several times, or its
+// neighbours, computes the same a0 value again and again. When an address
+// A2 is known to be equal to an earlier address A1 of the same block plus a
+// constant, the indirect operands based on A2 are rewritten to use A1 with
+// an immediate address offset, and the computation of A2 is deleted.
+// Both variables must have a single definition, A2 must only be used for
+// indirect accesses in this block, and the offset follows the conditions
+// of FoldAddrImmediate. Reusing A1 extends its live range, so only a few
+// addresses are kept available at a time.
+void Optimizer::reuseAddressComputations()
+{
+    if (fg.getHasStackCalls() || fg.getIsStackCallFunc())
+        return;
+
+    // Number of definitions and other references of each address variable;
+    // pseudo kills are not counted.
+    std::map<G4_Declare*, unsigned> NumDefs, NumRefs;
+    for (auto BB : fg.BBs) {
+        for (auto Inst : *BB) {
+            if (Inst->isPseudoKill())
+                continue;
+            G4_DstRegRegion* Dst = Inst->getDst();
+            if (Dst && Dst->getTopDcl() && Dst->getTopDcl()->getRegFile() == G4_ADDRESS) {
+                if (Dst->isIndirect())
+                    ++NumRefs[Dst->getTopDcl()];
+                else
+                    ++NumDefs[Dst->getTopDcl()];
+            }
+            for (int i = 0, e = Inst->getNumSrc(); i < e; ++i) {
+                G4_Operand* Src = Inst->getSrc(i);
+                if (Src && Src->getTopDcl() && Src->getTopDcl()->getRegFile() == G4_ADDRESS)
+                    ++NumRefs[Src->getTopDcl()];
+            }
+        }
+    }
+
+    auto isSingleDef = [&](G4_Declare* Dcl) {
+        return NumDefs[Dcl] == 1 && !Dcl->isInput() && !Dcl->isOutput() &&
+               !Dcl->getRegVar()->getPhyReg();
+    };
+
+    // Address words kept live by the available computations.
+    const unsigned MaxAvailWords = getNumAddrRegisters() / 2;
+
+    for (auto BB : fg.BBs) {
+        std::list<G4_INST*> Avail;
+        unsigned AvailWords = 0;
+
+        for (auto I = BB->begin(), E = BB->end(); I != E; /*empty*/) {
+            G4_INST* Inst = *I;
+            auto CurI = I++;
+
+            if (isAddrComputation(Inst) && isSingleDef(Inst->getDst()->getTopDcl())) {
+                G4_Declare* Dcl = Inst->getDst()->getTopDcl();
+                G4_AddrExp* AE = Inst->getSrc(0)->asAddrExp();
+
+                // Look for an available address differing by a constant.
+                G4_INST* Match = nullptr;
+                int Diff = 0;
+                for (auto AI : Avail) {
+                    G4_AddrExp* AvailAE = AI->getSrc(0)->asAddrExp();
+                    if (AI->opcode() != Inst->opcode() ||
+                        AI->getExecSize() != Inst->getExecSize() ||
+                        AI->isWriteEnableInst() != Inst->isWriteEnableInst() ||
+                        AI->getMaskOffset() != Inst->getMaskOffset() ||
+                        AI->getDst()->getType() != Inst->getDst()->getType() ||
+                        AvailAE->getRegVar() != AE->getRegVar())
+                        continue;
+                    if (Inst->opcode() == G4_add) {
+                        G4_Operand* Idx = Inst->getSrc(1);
+                        G4_Operand* AvailIdx = AI->getSrc(1);
+                        if (Idx->isImm() != AvailIdx->isImm())
+                            continue;
+                        if (Idx->isImm() ? (Idx->getType() != AvailIdx->getType() ||
+                                            Idx->asImm()->getImm() != AvailIdx->asImm()->getImm())
+                                         : !Idx->asSrcRegRegion()->sameSrcRegRegion(
+                                               *AvailIdx->asSrcRegRegion()))
+                            continue;
+                    }
+                    Diff = AE->getOffset() - AvailAE->getOffset();
+                    if (Diff != 0 && (Inst->getExecSize() != 1 || Diff % 0x20 != 0))
+                        continue;
+                    Match = AI;
+                    break;
+                }
+
+                // All other references must be indirect operands following
+                // the definition and reachable by the new immediate offset.
+                std::vector<std::pair<G4_INST*, int>> Uses;
+                unsigned NumFound = 0;
+                for (auto UI = I; Match && UI != E; ++UI) {
+                    G4_INST* Use = *UI;
+                    if (Use->isPseudoKill())
+                        continue;
+                    // Uses past the end of the matched address cannot be
+                    // rewritten; they are left uncounted and block the reuse.
+                    if (Use->isLifeTimeEnd() && Use->getSrc(0) &&
+                        Use->getSrc(0)->getTopDcl() == Match->getDst()->getTopDcl())
+                        break;
+                    G4_DstRegRegion* Dst = Use->getDst();
+                    if (Dst && Dst->getTopDcl() == Dcl) {
+                        ++NumFound;
+                        short Off = Dst->getAddrImm() + Diff;
+                        if (!Dst->isIndirect() || Dst->getBase()->asRegVar()->getDeclare() != Dcl ||
+                            (Diff != 0 && (Dst->getAddrImm() % 0x20 != 0 || Off < -512 || Off > 511)))
+                            Match = nullptr;
+                        else
+                            Uses.push_back(std::make_pair(Use, -1));
+                    }
+                    for (int i = 0, e = Use->getNumSrc(); Match && i < e; ++i) {
+                        G4_Operand* Src = Use->getSrc(i);
+                        if (!Src || Src->getTopDcl() != Dcl)
+                            continue;
+                        ++NumFound;
+                        if (!Src->isSrcRegRegion() || !Src->asSrcRegRegion()->isIndirect() ||
+                            Src->getBase()->asRegVar()->getDeclare() != Dcl) {
+                            Match = nullptr;
+                            break;
+                        }
+                        short Off = Src->asSrcRegRegion()->getAddrImm() + Diff;
+                        // A VxH region reads several address elements.
+                        RegionDesc* RD = Src->asSrcRegRegion()->getRegion();
+                        if (Diff != 0 && (RD->isRegionWH() ||
+                            Src->asSrcRegRegion()->getAddrImm() % 0x20 != 0 || Off < -512 || Off > 511)) {
+                            Match = nullptr;
+                            break;
+                        }
+                        Uses.push_back(std::make_pair(Use, i));
+                    }
+                }
+
+                if (Match && NumFound == NumRefs[Dcl]) {
+                    G4_RegVar* Base = Match->getDst()->getBase()->asRegVar();
+                    for (auto& Use : Uses) {
+                        if (Use.second < 0) {
+                            G4_DstRegRegion* Dst = Use.first->getDst();
+                            G4_DstRegRegion tmpRgn(*Dst, Base);
+                            tmpRgn.setImmAddrOff(short(Dst->getAddrImm() + Diff));
+                            Use.first->setDest(builder.createDstRegRegion(tmpRgn));
+                        } else {
+                            G4_SrcRegRegion* Src = Use.first->getSrc(Use.second)->asSrcRegRegion();
+                            G4_SrcRegRegion tmpRgn(*Src, Base);
+                            tmpRgn.setImmAddrOff(short(Src->getAddrImm() + Diff));
+                            Use.first->setSrc(builder.createSrcRegRegion(tmpRgn), Use.second);
+                        }
+                    }
+                    Inst->transferUse(Match, /*keepExisting*/true);
+                    Inst->removeAllDefs();
+                    BB->erase(CurI);
+                    continue;
+                }
+
+                if (!Match) {
+                    unsigned Words = Dcl->getNumElems() * Dcl->getElemSize() / 2;
+                    while (!Avail.empty() && AvailWords + Words > MaxAvailWords) {
+                        G4_Declare* Oldest = Avail.front()->getDst()->getTopDcl();
+                        AvailWords -= Oldest->getNumElems() * Oldest->getElemSize() / 2;
+                        Avail.pop_front();
+                    }
+                    if (Words <= MaxAvailWords) {
+                        Avail.push_back(Inst);
+                        AvailWords += Words;
+                        continue;
+                    }
+                }
+            }
+
+            // Anything redefining an index makes its computations unavailable,
+            // and so does the end of the address itself.
+            G4_DstRegRegion* Dst = Inst->getDst();
+            G4_Operand* Ended = Inst->isLifeTimeEnd() ? Inst->getSrc(0) : nullptr;
+            if (((Dst && Dst->getTopDcl()) || Ended) && !Avail.empty()) {
+                for (auto AI = Avail.begin(); AI != Avail.end(); /*empty*/) {
+                    G4_Operand* Idx = (*AI)->getSrc(1);
+                    G4_Declare* AvailDcl = (*AI)->getDst()->getTopDcl();
+                    if ((Dst && Dst->getTopDcl() == AvailDcl) ||
+                        (Ended && Ended->getTopDcl() == AvailDcl) ||
+                        ((*AI)->opcode() == G4_add && Idx->isSrcRegRegion() && Dst &&
+                         Idx->getTopDcl() == Dst->getTopDcl())) {
+                        G4_Declare* Dead = (*AI)->getDst()->getTopDcl();
+                        AvailWords -= Dead->getNumElems() * Dead->getElemSize() / 2;
+                        AI = Avail.erase(AI);
+                    } else {
+                        ++AI;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Check if Inst may be part of the loop-invariant construction of a
+// variable: an unpredicated NoMask move or simple ALU operation writing a
+// GRF variable directly, or the pseudo_kill of that variable.
+static bool isHeaderBuildInst(G4_INST* Inst)
+{
+    if (Inst->isPseudoKill())
+        return true;
+
+    switch (Inst->opcode()) {
+    case G4_mov: case G4_add: case G4_and: case G4_or: case G4_shl: case G4_shr:
+        break;
+    default:
+        return false;
+    }
+
+    if (!Inst->isWriteEnableInst() || Inst->getPredicate() || Inst->getCondMod() ||
+        Inst->getImplAccSrc() || Inst->getImplAccDst())
+        return false;
+
+    G4_DstRegRegion* Dst = Inst->getDst();
+    return Dst && !Dst->isNullReg() && !Dst->isIndirect() && Dst->isGreg() &&
+           Dst->getTopDcl() != nullptr;
+}
+
+// Loop-invariant code motion for message headers and payloads.
+//
+// Headers are built right before each send: the r0 copy, the surface state
+// offset, the sampler state pointer. This happens during EmitVISA and
+// lowering, after LLVM's LICM ran, so in a loop they are rebuilt in every
+// iteration even when they only read values defined outside of it. This
+// pass moves the construction of such a variable to the loop preheader.
+// All definitions of the variable move together, and only if
+// - they are all in one block of the loop and write disjoint bytes,
+// - they satisfy isHeaderBuildInst, and their sources are immediates or
+//   GRF variables not defined in the loop,
+// - the variable is neither referenced outside the loop nor ended by a
+//   pseudo_lifetime_end, and that block does not read it before its last
+//   definition.
+// The variable then stays live across the whole loop, so it is only hoisted
+// while the estimated pressure of the loop stays below 3/4 of the GRFs.
+void Optimizer::hoistLoopInvariantHeaders()
+{
+    if (!fg.isReducible() || fg.getHasStackCalls() || fg.getIsStackCallFunc() ||
+        !fg.funcInfoTable.empty())
+        return;
+
+    fg.reassignBlockIDs();
+    fg.findBackEdges();
+    if (fg.backEdges.empty())
+        return;
+
+    // The natural loop of each back edge, merged per loop head. FlowGraph's
+    // own naturalLoops are left to RA, which also updates the nest levels.
+    std::map<G4_BB*, std::set<G4_BB*>> Loops;
+    for (auto& BackEdge : fg.backEdges) {
+        G4_BB* Head = BackEdge.second;
+        std::set<G4_BB*>& Body = Loops[Head];
+        Body.insert(Head);
+        std::vector<G4_BB*> Worklist(1, BackEdge.first);
+        while (!Worklist.empty()) {
+            G4_BB* BB = Worklist.back();
+            Worklist.pop_back();
+            if (!Body.insert(BB).second)
+                continue;
+            for (auto Pred : BB->Preds)
+                Worklist.push_back(Pred);
+        }
+    }
+
+    // Blocks defining and referencing each variable.
+    std::map<G4_Declare*, std::set<G4_BB*>> DefBBs, RefBBs;
+    std::set<G4_Declare*> EndedDcls;
+    for (auto BB : fg.BBs) {
+        for (auto Inst : *BB) {
+            G4_DstRegRegion* Dst = Inst->getDst();
+            if (Dst && Dst->getTopDcl()) {
+                DefBBs[Dst->getTopDcl()].insert(BB);
+                RefBBs[Dst->getTopDcl()].insert(BB);
+            }
+            for (int i = 0, e = Inst->getNumSrc(); i < e; ++i) {
+                G4_Operand* Src = Inst->getSrc(i);
+                if (Src && Src->getTopDcl()) {
+                    RefBBs[Src->getTopDcl()].insert(BB);
+                    if (Inst->isLifeTimeEnd())
+                        EndedDcls.insert(Src->getTopDcl());
+                }
+            }
+        }
+    }
+
+    PointsToAnalysis P2A(kernel.Declares, fg.getNumBB());
+    P2A.doPointsToAnalysis(fg);
+    GlobalRA GRA(kernel, builder.phyregpool, P2A);
+    GRA.markGraphBlockLocalVars(/*doLocalRA*/false);
+    LivenessAnalysis Liveness(GRA, G4_GRF | G4_ADDRESS | G4_INPUT | G4_FLAG);
+    Liveness.computeLiveness(true);
+    RPE Rpe(GRA, &Liveness);
+    Rpe.run();
+
+    // Pressure of each block, indexed by block id, including the variables
+    // hoisted across it so far.
+    std::vector<unsigned> BlockRP(fg.getNumBB(), 0);
+    for (auto BB : fg.BBs)
+        for (auto Inst : *BB)
+            BlockRP[BB->getId()] = std::max(BlockRP[BB->getId()], Rpe.getRegisterPressure(Inst));
+    const unsigned MaxRP = builder.getOptions()->getuInt32Option(vISA_TotalGRFNum) * 3 / 4;
+
+    // Inner loops first, so that outer loops may hoist their headers again.
+    std::vector<std::pair<G4_BB*, std::set<G4_BB*>*>> Order;
+    for (auto& Loop : Loops)
+        Order.push_back(std::make_pair(Loop.first, &Loop.second));
+    std::stable_sort(Order.begin(), Order.end(),
+        [](const std::pair<G4_BB*, std::set<G4_BB*>*>& A,
+           const std::pair<G4_BB*, std::set<G4_BB*>*>& B) {
+            return A.second->size() < B.second->size();
+        });
+
+    auto isSubset = [](const std::set<G4_BB*>& A, const std::set<G4_BB*>& B) {
+        return std::includes(B.begin(), B.end(), A.begin(), A.end());
+    };
+
+    for (auto& Loop : Order) {
+        G4_BB* Head = Loop.first;
+        const std::set<G4_BB*>& Body = *Loop.second;
+
+        // A single preheader, entering only this loop.
+        G4_BB* Preheader = nullptr;
+        bool Valid = !Body.count(fg.getEntryBB()) || Head == fg.getEntryBB();
+        for (auto Pred : Head->Preds) {
+            if (Body.count(Pred))
+                continue;
+            Valid &= (Preheader == nullptr);
+            Preheader = Pred;
+        }
+        if (!Valid || Preheader == nullptr || Preheader->Succs.size() != 1 ||
+            Preheader->getBBType() != G4_BB_NONE_TYPE)
+            continue;
+        for (auto BB : Body) {
+            Valid &= (BB->getBBType() == G4_BB_NONE_TYPE);
+            for (auto Inst : *BB)
+                Valid &= !Inst->isCall() && !Inst->isFCall() && !Inst->isReturn();
+        }
+        if (!Valid)
+            continue;
+
+        auto InsertPos = Preheader->end();
+        if (!Preheader->empty() && Preheader->back()->isFlowControl())
+            --InsertPos;
+
+        auto isInvariantSrc = [&](G4_Operand* Src, G4_Declare* Dcl) {
+            if (Src == nullptr || Src->isImm())
+                return true;
+            if (!Src->isSrcRegRegion() || Src->asSrcRegRegion()->isIndirect() ||
+                !Src->isGreg() || Src->getTopDcl() == nullptr || Src->getTopDcl() == Dcl)
+                return false;
+            // DefBBs does not see writes through address registers.
+            if (Src->getTopDcl()->getAddressed())
+                return false;
+            for (auto DefBB : DefBBs[Src->getTopDcl()])
+                if (Body.count(DefBB))
+                    return false;
+            return true;
+        };
+
+        unsigned LoopRP = 0;
+        for (auto BB : Body)
+            LoopRP = std::max(LoopRP, BlockRP[BB->getId()]);
+
+        // Hoisting a variable may make the sources of others invariant.
+        bool Changed = true;
+        while (Changed) {
+            Changed = false;
+            for (auto BB : Body) {
+                for (auto Inst : *BB) {
+                    if (Inst->isPseudoKill() || !isHeaderBuildInst(Inst))
+                        continue;
+                    G4_Declare* Dcl = Inst->getDst()->getTopDcl();
+                    if (Dcl->getRegFile() != G4_GRF || Dcl->isInput() || Dcl->isOutput() ||
+                        Dcl->getAddressed() || Dcl->getRegVar()->getPhyReg() ||
+                        EndedDcls.count(Dcl) || DefBBs[Dcl].size() != 1 ||
+                        !isSubset(RefBBs[Dcl], Body) ||
+                        LoopRP + Dcl->getNumRows() > MaxRP)
+                        continue;
+
+                    // Collect the definitions; none may follow a use.
+                    std::vector<INST_LIST_ITER> Defs;
+                    std::vector<std::pair<unsigned, unsigned>> Ranges;
+                    bool Used = false;
+                    for (auto I = BB->begin(), E = BB->end(); I != E && Valid; ++I) {
+                        G4_INST* Def = *I;
+                        for (int i = 0, e = Def->getNumSrc(); i < e; ++i) {
+                            G4_Operand* Src = Def->getSrc(i);
+                            Used |= (Src && Src->getTopDcl() == Dcl);
+                        }
+                        if (Def->getDst() == nullptr || Def->getDst()->getTopDcl() != Dcl)
+                            continue;
+                        Valid = !Used && isHeaderBuildInst(Def);
+                        for (int i = 0, e = Def->getNumSrc(); Valid && !Def->isPseudoKill() && i < e; ++i)
+                            Valid = isInvariantSrc(Def->getSrc(i), Dcl);
+                        if (!Def->isPseudoKill())
+                            Ranges.push_back(std::make_pair(
+                                Def->getDst()->getLeftBound(), Def->getDst()->getRightBound()));
+                        Defs.push_back(I);
+                    }
+                    std::sort(Ranges.begin(), Ranges.end());
+                    for (size_t i = 1; Valid && i < Ranges.size(); ++i)
+                        Valid = Ranges[i].first > Ranges[i - 1].second;
+                    if (!Valid) {
+                        Valid = true;
+                        continue;
+                    }
+
+                    for (auto I : Defs) {
+                        G4_INST* Def = *I;
+                        BB->erase(I);
+                        Preheader->insert(InsertPos, Def);
+                        for (int i = 0, e = Def->getNumSrc(); i < e; ++i) {
+                            G4_Operand* Src = Def->getSrc(i);
+                            if (Src && Src->getTopDcl())
+                                RefBBs[Src->getTopDcl()].insert(Preheader);
+                        }
+                    }
+                    DefBBs[Dcl].clear();
+                    DefBBs[Dcl].insert(Preheader);
+                    RefBBs[Dcl].insert(Preheader);
+
+                    LoopRP += Dcl->getNumRows();
+                    for (auto LoopBB : Body)
+                        BlockRP[LoopBB->getId()] += Dcl->getNumRows();
+                    BlockRP[Preheader->getId()] += Dcl->getNumRows();
+
+                    Changed = true;
+                    break;
+                }
+                if (Changed)
+                    break;
+            }
+        }
+    }
+}
+
 static bool retires(G4_Operand* Opnd, G4_INST* SI)
 {
     assert(Opnd && Opnd->isGreg());
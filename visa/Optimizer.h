@@ -164,6 +164,7 @@ class Optimizer
     void HWWorkaround();
     void NoSrcDepSet();
     void normalizeRegion();
+    void rewriteForCompaction();
     void NoDD();
     void initializePayload();
     void dumpPayload();
@@ -199,6 +200,10 @@ class Optimizer
 
     void dce();
 
+    void hoistLoopInvariantHeaders();
+
+    void reuseAddressComputations();
+
     void accSubPostSchedule();
 
 private:
@@ -225,6 +230,7 @@ private:
 
     void countBankConflicts();
     unsigned int numBankConflicts;
+    void emitPerfEstimate();
 
     bool chkFwdOutputHazard(INST_LIST_ITER &, INST_LIST_ITER&);
     bool chkFwdOutputHazard(G4_INST*, INST_LIST_ITER);
@@ -321,6 +327,7 @@ public:
         PI_initializePayload,
         PI_cleanupBindless,
         PI_countGRFUsage,
+        PI_emitPerfEstimate,
         PI_splitVariables,
         PI_changeMoveType,
         PI_reRAPostSchedule,
@@ -331,6 +338,9 @@ public:
         PI_loadThreadPayload,
         PI_insertFenceBeforeEOT,
         PI_insertScratchReadBeforeEOT,
+        PI_rewriteForCompaction,
+        PI_hoistLoopInvariantHeaders,
+        PI_reuseAddressComputations,
         PI_NUM_PASSES
     };
 
@@ -0,0 +1,228 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#include "PerfEstimate.h"
+#include "FlowGraph.h"
+#include "GraphColor.h"
+#include "LocalScheduler/LatencyTable.h"
+
+#include <fstream>
+#include <map>
+#include <vector>
+
+using namespace vISA;
+
+namespace
+{
+    struct BBEstimate
+    {
+        unsigned int id;
+        unsigned int nestLevel;
+        unsigned int numInsts;
+        uint32_t cycles;
+        uint32_t stallCycles;
+    };
+
+    const char* getSFIDName(CISA_SHARED_FUNCTION_ID sfid)
+    {
+        switch (sfid)
+        {
+        case SFID_NULL:     return "null";
+        case SFID_SAMPLER:  return "sampler";
+        case SFID_GATEWAY:  return "gateway";
+        case SFID_DP_DC2:   return "dc2";
+        case SFID_DP_WRITE: return "render";
+        case SFID_URB:      return "urb";
+        case SFID_SPAWNER:  return "spawner";
+        case SFID_VME:      return "vme";
+        case SFID_DP_CC:    return "constant";
+        case SFID_DP_DC:    return "dc";
+        case SFID_DP_PI:    return "pi";
+        case SFID_DP_DC1:   return "dc1";
+        case SFID_CRE:      return "cre";
+        default:            return "unknown";
+        }
+    }
+
+    // GRF rows covered by opnd, or false if it is not a GRF operand.
+    bool getGRFRows(G4_Operand* opnd, unsigned int& first, unsigned int& last)
+    {
+        if (!opnd || !(opnd->isSrcRegRegion() || opnd->isDstRegRegion()) || !opnd->isGreg())
+        {
+            return false;
+        }
+        first = opnd->getLinearizedStart() / G4_GRF_REG_NBYTES;
+        last = opnd->getLinearizedEnd() / G4_GRF_REG_NBYTES;
+        return true;
+    }
+
+    // In-order issue model of one thread: an instruction issues once its GRF
+    // sources are ready, and occupies the pipe for its occupancy. As in the
+    // local scheduler, waits are assumed to be hidden by the other threads of
+    // the EU, so only 1/threadsPerEU of each wait is counted.
+    BBEstimate estimateBB(G4_BB* bb, const LatencyTable& LT, unsigned int threadsPerEU,
+        std::vector<uint32_t>& readyCycle)
+    {
+        BBEstimate est = { bb->getId(), bb->getNestLevel(), 0, 0, 0 };
+        std::fill(readyCycle.begin(), readyCycle.end(), 0);
+
+        uint32_t issueCycle = 0;
+        for (auto inst : *bb)
+        {
+            if (inst->isLabel())
+            {
+                continue;
+            }
+            est.numInsts++;
+
+            uint32_t startCycle = issueCycle;
+            unsigned int first = 0, last = 0;
+            for (int i = 0, numSrc = inst->getNumSrc(); i < numSrc; ++i)
+            {
+                if (getGRFRows(inst->getSrc(i), first, last))
+                {
+                    for (unsigned int r = first; r <= last && r < readyCycle.size(); ++r)
+                    {
+                        startCycle = std::max(startCycle, readyCycle[r]);
+                    }
+                }
+            }
+
+            if (startCycle > issueCycle)
+            {
+                est.stallCycles += (startCycle - issueCycle + threadsPerEU - 1) / threadsPerEU;
+            }
+
+            LatencyTable::Latency lat = LT.getLatency(inst);
+            uint32_t occupancy = std::max(1u, lat.getOccupancyOnly());
+            est.cycles += occupancy;
+            issueCycle = startCycle + occupancy;
+
+            if (getGRFRows(inst->getDst(), first, last))
+            {
+                for (unsigned int r = first; r <= last && r < readyCycle.size(); ++r)
+                {
+                    readyCycle[r] = startCycle + lat.getSum();
+                }
+            }
+        }
+        est.cycles += est.stallCycles;
+        return est;
+    }
+}
+
+uint64_t vISA::estimateWeightedCycles(G4_Kernel& kernel)
+{
+    const Options* options = kernel.getOptions();
+    LatencyTable LT(options);
+    unsigned int threadsPerEU = std::max(1u, kernel.fg.builder->getHWThreadNumberPerEU());
+    std::vector<uint32_t> readyCycle(options->getuInt32Option(vISA_TotalGRFNum), 0);
+
+    uint64_t weightedCycles = 0;
+    for (auto bb : kernel.fg.BBs)
+    {
+        BBEstimate est = estimateBB(bb, LT, threadsPerEU, readyCycle);
+        weightedCycles += (uint64_t)est.cycles * GlobalRA::getRefCount(est.nestLevel);
+    }
+    return weightedCycles;
+}
+
+void vISA::emitPerfEstimate(G4_Kernel& kernel, unsigned int numBankConflicts)
+{
+    const Options* options = kernel.getOptions();
+    const char* asmName = nullptr;
+    options->getOption(VISA_AsmFileName, asmName);
+    if (asmName == nullptr)
+    {
+        return;
+    }
+
+    char fileName[MAX_OPTION_STR_LENGTH];
+    SNPRINTF(fileName, MAX_OPTION_STR_LENGTH, "%s.perf.json", asmName);
+    std::ofstream report(fileName);
+    if (!report)
+    {
+        return;
+    }
+
+    LatencyTable LT(options);
+    IR_Builder* builder = kernel.fg.builder;
+    unsigned int threadsPerEU = std::max(1u, builder->getHWThreadNumberPerEU());
+    std::vector<uint32_t> readyCycle(options->getuInt32Option(vISA_TotalGRFNum), 0);
+
+    std::vector<BBEstimate> bbs;
+    std::map<CISA_SHARED_FUNCTION_ID, unsigned int> sendCounts;
+    uint64_t weightedCycles = 0;
+    uint64_t weightedSends = 0;
+    for (auto bb : kernel.fg.BBs)
+    {
+        BBEstimate est = estimateBB(bb, LT, threadsPerEU, readyCycle);
+        uint32_t weight = GlobalRA::getRefCount(est.nestLevel);
+        weightedCycles += (uint64_t)est.cycles * weight;
+
+        for (auto inst : *bb)
+        {
+            if (inst->isSend())
+            {
+                sendCounts[inst->getMsgDesc()->getFuncId()]++;
+                weightedSends += weight;
+            }
+        }
+        bbs.push_back(est);
+    }
+
+    FINALIZER_INFO* jitInfo = builder->getJitInfo();
+    report << "{\n";
+    report << "  \"kernel\": \"" << kernel.getName() << "\",\n";
+    report << "  \"simd\": " << kernel.getSimdSize() << ",\n";
+    report << "  \"hwThreadsPerEU\": " << threadsPerEU << ",\n";
+    report << "  \"grfUsed\": " << jitInfo->numGRFUsed << ",\n";
+    report << "  \"spillBytes\": " << jitInfo->spillMemUsed << ",\n";
+    report << "  \"bankConflicts\": " << numBankConflicts << ",\n";
+    report << "  \"weightedCycles\": " << weightedCycles << ",\n";
+    report << "  \"weightedSends\": " << weightedSends << ",\n";
+    report << "  \"sends\": {";
+    bool first = true;
+    for (auto& count : sendCounts)
+    {
+        report << (first ? "" : ",") << " \"" << getSFIDName(count.first) << "\": " << count.second;
+        first = false;
+    }
+    report << " },\n";
+    report << "  \"bbs\": [\n";
+    for (size_t i = 0; i < bbs.size(); ++i)
+    {
+        const BBEstimate& est = bbs[i];
+        report << "    { \"id\": " << est.id <<
+            ", \"nestLevel\": " << est.nestLevel <<
+            ", \"insts\": " << est.numInsts <<
+            ", \"cycles\": " << est.cycles <<
+            ", \"stallCycles\": " << est.stallCycles << " }" <<
+            (i + 1 < bbs.size() ? "," : "") << "\n";
+    }
+    report << "  ]\n";
+    report << "}\n";
+}
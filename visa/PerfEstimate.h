@@ -0,0 +1,47 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#ifndef _PERFESTIMATE_H_
+#define _PERFESTIMATE_H_
+
+#include <cstdint>
+
+namespace vISA
+{
+    class G4_Kernel;
+
+    // Writes a static cost estimate of the scheduled kernel to <asm file>.perf.json:
+    // per-BB cycles from the latency table, send counts per shared function,
+    // spill size, bank conflicts and HW threads per EU. Totals are weighted by the
+    // static loop nest level in the same way as RA reference counts.
+    void emitPerfEstimate(G4_Kernel& kernel, unsigned int numBankConflicts);
+
+    // Sum over all BBs of the estimated cycles, weighted by loop nest level
+    // (the weightedCycles of the report).
+    uint64_t estimateWeightedCycles(G4_Kernel& kernel);
+}
+
+#endif
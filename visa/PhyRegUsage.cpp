@@ -1008,6 +1008,51 @@ bool PhyRegUsage::assignGRFRegsFromBanks(LiveRange*	 varBasis,
 // find registers for intv
 // To support sub-reg alignment
 //
+//
+// Assign varBasis the whole GRFs starting at preferredReg if they are all free.
+// Used to give copy related live ranges the same registers, so that the copy
+// between them is removed as a redundant mov after RA.
+//
+bool PhyRegUsage::assignPreferredGRF(LiveRange* varBasis,
+    const bool* forbidden,
+    G4_Align align,
+    unsigned preferredReg)
+{
+    G4_Declare* decl = varBasis->getDcl();
+    if (decl->getRegFile() != G4_GRF ||
+        canGRFSubRegAlloc(decl) ||
+        varBasis->getEOTSrc() ||
+        varBasis->getCalleeSaveBias())
+    {
+        return false;
+    }
+
+    unsigned numRows = decl->getNumRows();
+    if (preferredReg + numRows > maxGRFCanBeUsed ||
+        (align == Even && preferredReg % 2 != 0) ||
+        (align == Odd && preferredReg % 2 != 1) ||
+        (align != Either && align != Even && align != Odd))
+    {
+        return false;
+    }
+
+    for (unsigned i = preferredReg; i < preferredReg + numRows; i++)
+    {
+        if (!availableGregs[i] || (forbidden && forbidden[i]))
+        {
+            return false;
+        }
+    }
+
+    if (overlapTest && !isOverlapValid(preferredReg, numRows))
+    {
+        return false;
+    }
+
+    varBasis->setPhyReg(regPool.getGreg(preferredReg), 0);
+    return true;
+}
+
 bool PhyRegUsage::assignRegs(bool  highInternalConflict,
     LiveRange*		 varBasis,
     const bool*     forbidden,
@@ -200,6 +200,11 @@ public:
 					ColorHeuristic colorHeuristic,
 					float			 spillCost);
 
+    bool assignPreferredGRF(LiveRange* varBasis,
+                            const bool* forbidden,
+                            G4_Align align,
+                            unsigned preferredReg);
+
     bool assignGRFRegsFromBanks(LiveRange*	 varBasis,
          		             G4_Align  align,
 							 const bool*     forbidden,
@@ -25,6 +25,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 ======================= end_copyright_notice ==================================*/
 
 #include <vector>
+#include <queue>
 #include <limits.h>
 #include "Mem_Manager.h"
 #include "FlowGraph.h"
@@ -1272,30 +1273,54 @@ void LivenessAnalysis::computeLiveness(bool computePseudoKill)
         }
 
 		//
-		// backward flow analysis to propagate uses (locate last uses)
+		// Both passes below are driven by a worklist ordered by layout
+		// position, so a block is only visited again when the flow info of a
+		// neighbor it depends on changed, instead of sweeping the whole CFG
+		// until nothing changes.
 		//
+		std::vector<G4_BB*> layout(fg.BBs.begin(), fg.BBs.end());
+		unsigned numBB = (unsigned)layout.size();
+		std::vector<unsigned> layoutPos(numBBId, 0);
+		for (unsigned i = 0; i < numBB; i++)
+		{
+			layoutPos[layout[i]->getId()] = i;
+		}
 
-        bool change = true;
-
-		while (change)
+		//
+		// backward flow analysis to propagate uses (locate last uses)
+		// blocks are visited in reverse layout order
+		//
 		{
-			change = false;
-			BB_LIST::iterator rit = fg.BBs.end();
-			do
+			std::priority_queue<unsigned, std::vector<unsigned>, std::greater<unsigned>> worklist;
+			std::vector<bool> inWorklist(numBBId, true);
+			for (unsigned i = 0; i < numBB; i++)
 			{
+				worklist.push(i);
+			}
+
+			while (!worklist.empty())
+			{
+				G4_BB* bb = layout[numBB - 1 - worklist.top()];
+				worklist.pop();
+				inWorklist[bb->getId()] = false;
+
 				//
 				// use_out = use_in(s1) + use_in(s2) + ...
 				// where s1 s2 ... are the successors of bb
 				// use_in  = use_gen + (use_out - use_kill)
 				//
-				--rit;
-				if (contextFreeUseAnalyze((*rit)))
+				if (contextFreeUseAnalyze(bb))
 				{
-					change = true;
+					for (auto pred : bb->Preds)
+					{
+						if (!inWorklist[pred->getId()])
+						{
+							inWorklist[pred->getId()] = true;
+							worklist.push(numBB - 1 - layoutPos[pred->getId()]);
+						}
+					}
 				}
-
 			}
-			while (rit != fg.BBs.begin());
 		}
 
 		//
@@ -1306,20 +1331,34 @@ void LivenessAnalysis::computeLiveness(bool computePseudoKill)
 		// initialize entry block with payload input
 		//
 		def_in[fg.getEntryBB()->getId()] = inputDefs;
-		change = true;
-		while (change)
 		{
-			change = false;
-			for (BB_LIST_ITER it = fg.BBs.begin(); it != fg.BBs.end(); it++)
+			std::priority_queue<unsigned, std::vector<unsigned>, std::greater<unsigned>> worklist;
+			std::vector<bool> inWorklist(numBBId, true);
+			for (unsigned i = 0; i < numBB; i++)
+			{
+				worklist.push(i);
+			}
+
+			while (!worklist.empty())
 			{
-				G4_BB* bb = (*it);
+				G4_BB* bb = layout[worklist.top()];
+				worklist.pop();
+				inWorklist[bb->getId()] = false;
+
 				//
 				// def_in   = def_out(p1) + def_out(p2) + ... where p1 p2 ... are the predecessors of bb
 				// def_out |= def_in
 				//
 				if (contextFreeDefAnalyze(bb))
 				{
-					change = true;
+					for (auto succ : bb->Succs)
+					{
+						if (!inWorklist[succ->getId()])
+						{
+							inWorklist[succ->getId()] = true;
+							worklist.push(layoutPos[succ->getId()]);
+						}
+					}
 				}
 			}
 		}
@@ -1480,13 +1519,9 @@ void LivenessAnalysis::useAnalysis(FuncInfo* subroutine)
                 }
             }
 
-            BitSet oldUseIn = use_in[bbid];
-
-            use_in[bbid] = use_out[bbid];
-            use_in[bbid] -= use_kill[bbid];
-            use_in[bbid] |= use_gen[bbid];
+            bool useInChanged = use_in[bbid].setToGenUnionOutMinusKill(use_gen[bbid], use_out[bbid], use_kill[bbid]);
 
-            if (!(bb->getBBType() & G4_BB_INIT_TYPE) && oldUseIn != use_in[bbid])
+            if (!(bb->getBBType() & G4_BB_INIT_TYPE) && useInChanged)
             {
                 changed = true;
             }
@@ -1533,13 +1568,9 @@ void LivenessAnalysis::useAnalysisWithArgRetVal(FuncInfo* subroutine,
                 }
             }
 
-            BitSet oldUseIn = use_in[bbid];
+            bool useInChanged = use_in[bbid].setToGenUnionOutMinusKill(use_gen[bbid], use_out[bbid], use_kill[bbid]);
 
-            use_in[bbid] = use_out[bbid];
-            use_in[bbid] -= use_kill[bbid];
-            use_in[bbid] |= use_gen[bbid];
-
-            if (!(bb->getBBType() & G4_BB_INIT_TYPE) && oldUseIn != use_in[bbid])
+            if (!(bb->getBBType() & G4_BB_INIT_TYPE) && useInChanged)
             {
                 changed = true;
             }
@@ -1565,16 +1596,16 @@ void LivenessAnalysis::defAnalysis(FuncInfo* subroutine)
         for (auto&& bb : subroutine->getBBList())
         {
             uint32_t bbid = bb->getId();
-            BitSet oldDefIn = def_in[bbid];
+            bool defInChanged = false;
             auto phyPredBB = (bb == fg.getEntryBB()) ? nullptr : bb->getPhysicalPred();
             if (phyPredBB && (phyPredBB->getBBType() & G4_BB_CALL_TYPE))
             {
                 // this is the return BB, we take the def_out of the callBB + the predecessors
                 G4_BB* callBB = bb->getPhysicalPred();
-                def_in[bbid] |= def_out[callBB->getId()];
+                defInChanged |= def_in[bbid].unionWith(def_out[callBB->getId()]);
                 for (auto&& pred : bb->Preds)
                 {
-                    def_in[bbid] |= def_out[pred->getId()];
+                    defInChanged |= def_in[bbid].unionWith(def_out[pred->getId()]);
                 }
             }
             else if (bb->getBBType() & G4_BB_INIT_TYPE)
@@ -1585,11 +1616,11 @@ void LivenessAnalysis::defAnalysis(FuncInfo* subroutine)
             {
                 for (auto&& pred : bb->Preds)
                 {
-                    def_in[bbid] |= def_out[pred->getId()];
+                    defInChanged |= def_in[bbid].unionWith(def_out[pred->getId()]);
                 }
             }
 
-            if (def_in[bbid] != oldDefIn)
+            if (defInChanged)
             {
                 changed = true;
             }
@@ -2896,68 +2927,38 @@ bool LivenessAnalysis::contextSensitiveForwardDataAnalyze(
 //
 // use_out = use_in(s1) + use_in(s2) + ... where s1 s2 ... are the successors of bb
 // use_in  = use_gen + (use_out - use_kill)
+// returns true if use_in changed
 //
 bool LivenessAnalysis::contextFreeUseAnalyze(G4_BB* bb)
 {
-	bool changed;
-
 	unsigned bbid = bb->getId();
 
-	if (bb->Succs.empty()) // exit block
-	{
-		changed = false;
-	}
-
-	else
+	for (BB_LIST_ITER it = bb->Succs.begin(); it != bb->Succs.end(); it++)
 	{
-		BitSet old = use_out[bbid];
-
-		for (BB_LIST_ITER it = bb->Succs.begin(); it != bb->Succs.end(); it++)
-		{
-			use_out[bbid] |= use_in[(*it)->getId()];
-		}
-
-		changed = (old != use_out[bbid]);
+		use_out[bbid] |= use_in[(*it)->getId()];
 	}
 
 	//
 	// in = gen + (out - kill)
 	//
-	use_in[bbid] = use_out[bbid];
-    use_in[bbid] -= use_kill[bbid];
-    use_in[bbid] |= use_gen[bbid];
-
-	return changed;
+	return use_in[bbid].setToGenUnionOutMinusKill(use_gen[bbid], use_out[bbid], use_kill[bbid]);
 }
 
 //
 // def_in = def_out(p1) + def_out(p2) + ... where p1 p2 ... are the predecessors of bb
 // def_out |= def_in
+// returns true if def_out changed
 //
 bool LivenessAnalysis::contextFreeDefAnalyze(G4_BB* bb)
 {
-	bool changed  = false;
 	unsigned bbid = bb->getId();
 
-	if (bb->Preds.empty())
-	{
-		changed = false;
-	}
-	else
+	for (BB_LIST_ITER it = bb->Preds.begin(); it != bb->Preds.end(); it++)
 	{
-		BitSet old = def_in[bbid];
-
-		for (BB_LIST_ITER it = bb->Preds.begin(); it != bb->Preds.end(); it++)
-		{
-			def_in[bbid] |= def_out[(*it)->getId()];
-		}
-
-		changed = (old != def_in[bbid]);
+		def_in[bbid] |= def_out[(*it)->getId()];
 	}
 
-	 def_out[bb->getId()] |= def_in[bb->getId()];
-
-	 return changed;
+	return def_out[bbid].unionWith(def_in[bbid]);
 }
 
 void LivenessAnalysis::dump_bb_vector(char* vname, std::list<G4_BB*>& bbs, std::vector<BitSet>& vec)
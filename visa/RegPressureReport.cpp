@@ -0,0 +1,146 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#include "RegPressureReport.h"
+#include "FlowGraph.h"
+#include "LocalRA.h"
+#include "RPE.h"
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+
+using namespace vISA;
+
+namespace
+{
+    struct LineInfo
+    {
+        uint32_t maxPressure = 0;
+        unsigned int numInsts = 0;
+        unsigned int numSpillRefs = 0;
+    };
+
+    std::string escapeJSON(const char* str)
+    {
+        std::string res;
+        for (const char* c = str; *c; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+            {
+                res += '\\';
+            }
+            res += *c;
+        }
+        return res;
+    }
+
+    bool isSpilledRef(G4_Operand* opnd, const std::set<G4_Declare*>& spilled)
+    {
+        if (!opnd || !opnd->isRegRegion())
+        {
+            return false;
+        }
+        G4_Declare* dcl = GetTopDclFromRegRegion(opnd);
+        return dcl && spilled.count(dcl);
+    }
+}
+
+void vISA::emitRegPressureReport(G4_Kernel& kernel, RPE& rpe, const LIVERANGE_LIST& spilledLRs)
+{
+    const Options* options = kernel.getOptions();
+    const char* asmName = nullptr;
+    options->getOption(VISA_AsmFileName, asmName);
+    if (asmName == nullptr)
+    {
+        return;
+    }
+
+    char fileName[MAX_OPTION_STR_LENGTH];
+    SNPRINTF(fileName, MAX_OPTION_STR_LENGTH, "%s.rpe.json", asmName);
+    std::ofstream report(fileName);
+    if (!report)
+    {
+        return;
+    }
+
+    std::set<G4_Declare*> spilled;
+    for (auto lr : spilledLRs)
+    {
+        spilled.insert(lr->getVar()->getDeclare()->getRootDeclare());
+    }
+
+    // Instructions without line info are accounted to line 0 of an unnamed file.
+    std::map<std::pair<std::string, int>, LineInfo> lines;
+    for (auto bb : kernel.fg.BBs)
+    {
+        for (auto inst : *bb)
+        {
+            const char* srcFile = inst->getSrcFilename();
+            LineInfo& info = lines[std::make_pair(std::string(srcFile ? srcFile : ""), inst->getLineNo())];
+            info.maxPressure = std::max(info.maxPressure, rpe.getRegisterPressure(inst));
+            info.numInsts++;
+
+            if (isSpilledRef(inst->getDst(), spilled))
+            {
+                info.numSpillRefs++;
+            }
+            for (int i = 0, numSrc = inst->getNumSrc(); i < numSrc; ++i)
+            {
+                if (isSpilledRef(inst->getSrc(i), spilled))
+                {
+                    info.numSpillRefs++;
+                }
+            }
+        }
+    }
+
+    report << "{\n";
+    report << "  \"kernel\": \"" << escapeJSON(kernel.getName()) << "\",\n";
+    report << "  \"simd\": " << kernel.getSimdSize() << ",\n";
+    report << "  \"maxPressure\": " << rpe.getMaxRP() << ",\n";
+    report << "  \"spilledVars\": [";
+    bool first = true;
+    for (auto dcl : spilled)
+    {
+        report << (first ? "" : ",") << " \"" << escapeJSON(dcl->getName()) << "\"";
+        first = false;
+    }
+    report << " ],\n";
+    report << "  \"lines\": [\n";
+    size_t i = 0;
+    for (auto& line : lines)
+    {
+        report << "    { \"file\": \"" << escapeJSON(line.first.first.c_str()) <<
+            "\", \"line\": " << line.first.second <<
+            ", \"insts\": " << line.second.numInsts <<
+            ", \"maxPressure\": " << line.second.maxPressure <<
+            ", \"spillRefs\": " << line.second.numSpillRefs << " }" <<
+            (++i < lines.size() ? "," : "") << "\n";
+    }
+    report << "  ]\n";
+    report << "}\n";
+}
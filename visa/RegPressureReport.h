@@ -0,0 +1,45 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#ifndef _REGPRESSUREREPORT_H_
+#define _REGPRESSUREREPORT_H_
+
+#include "GraphColor.h"
+
+namespace vISA
+{
+    class RPE;
+
+    // Writes the register pressure of the kernel joined with source line info
+    // to <asm file>.rpe.json: for each source line, the max pressure (in
+    // words) over its vISA instructions and the number of references to
+    // variables spilled by the first global RA iteration, i.e. the places
+    // that get spill/fill code. Lines are only known if the front end emitted
+    // line info.
+    void emitRegPressureReport(G4_Kernel& kernel, RPE& rpe, const LIVERANGE_LIST& spilledLRs);
+}
+
+#endif
@@ -131,6 +131,7 @@ namespace vISA
         uint32_t getFuncCtrlWithSimd16(G4_SendMsgDescriptor* Desc);
         void simplifyMsg(INST_LIST_ITER SendIter);
         bool isAtomicCandidate(G4_SendMsgDescriptor* msgDesc);
+        bool isSamplerCandidate(G4_INST* I, G4_SendMsgDescriptor* msgDesc);
 
 		bool WAce0Read;
 
@@ -218,6 +219,15 @@ uint32_t SendFusion::getFuncCtrlWithSimd16(G4_SendMsgDescriptor* Desc)
             break;
         }
     }
+    else if (funcID == SFID_SAMPLER)
+    {
+        // bit18-17: SIMD Mode[0:1], 2 for SIMD16
+        FC = ((FC & ~0x60000) | (2 << 17));
+    }
+    else
+    {
+        unsupported = true;
+    }
 
     if (unsupported)
     {
@@ -293,6 +303,62 @@ bool SendFusion::isAtomicCandidate(G4_SendMsgDescriptor* msgDesc)
     // Need to check if it is packed half integer/float ?
 }
 
+// Sampler messages are read-only and lay out both their payload and their
+// response one GRF per parameter/channel for each group of 8 lanes, so two
+// SIMD8 messages fuse into a SIMD16 one just like untyped reads. Only
+// messages that do not compute derivatives across lanes are handled.
+bool SendFusion::isSamplerCandidate(G4_INST* I, G4_SendMsgDescriptor* msgDesc)
+{
+    if (!msgDesc->isSampler() || I->getExecSize() != 8)
+    {
+        return false;
+    }
+
+    // Sampler index must be known, as it is folded into the descriptor.
+    G4_Operand* sti = msgDesc->getSti();
+    if (sti && !sti->isImm())
+    {
+        return false;
+    }
+
+    // bit 29: SIMD Mode[2] (16-bit input), bit 30: 16-bit return,
+    // bit 31: CPS LOD compensation. None of them is handled.
+    uint32_t desc = msgDesc->getDesc();
+    if ((desc & 0xE0000000) != 0)
+    {
+        return false;
+    }
+
+    // bit18-17: SIMD Mode[0:1], 1 for SIMD8
+    uint32_t FC = msgDesc->getFuncCtrl();
+    if (((FC >> 17) & 0x3) != 1)
+    {
+        return false;
+    }
+
+    if (2 * msgDesc->MessageLength() > G4_SendMsgDescriptor::MaxMessageLength() ||
+        2 * msgDesc->extMessageLength() > G4_SendMsgDescriptor::MaxMessageLength() ||
+        2 * msgDesc->ResponseLength() > G4_SendMsgDescriptor::MaxResponseLength())
+    {
+        return false;
+    }
+
+    // bit16-12: message type
+    switch ((FC >> 12) & 0x1F)
+    {
+    default:
+        return false;
+    case VISA_3D_SAMPLE_L:
+    case VISA_3D_SAMPLE_L_C:
+    case VISA_3D_LD:
+    case VISA_3D_SAMPLE_LZ:
+    case VISA_3D_SAMPLE_C_LZ:
+    case VISA_3D_LD_LZ:
+        break;
+    }
+    return true;
+}
+
 // We will do send fusion for a few messages. Those messages all
 // have DW-sized address for each lane, thus address payload is
 // 1 GRF for exec_size=8 (no A64 messages for now).
@@ -341,7 +407,9 @@ bool SendFusion::simplifyAndCheckCandidate(INST_LIST_ITER Iter)
     }
 
     G4_SendMsgDescriptor* msgDesc = I->getMsgDesc();
-    if (!msgDesc->isHDC() || msgDesc->isHeaderPresent() || msgDesc->getSti() != nullptr)
+    bool isSampler = msgDesc->isSampler() && Builder->getOption(vISA_EnableSamplerFusion);
+    if ((!msgDesc->isHDC() && !isSampler) || msgDesc->isHeaderPresent() ||
+        (!isSampler && msgDesc->getSti() != nullptr))
     {
         return false;
     }
@@ -440,6 +508,11 @@ bool SendFusion::simplifyAndCheckCandidate(INST_LIST_ITER Iter)
         return true;
     }
 
+    if (isSampler) {
+        // simplifyMsg() may have replaced the descriptor.
+        return isSamplerCandidate(I, I->getMsgDesc());
+    }
+
     uint32_t funcID = msgDesc->getFuncId();
     uint32_t msgType = msgDesc->getMessageType();
     if (funcID == SFID_DP_DC)
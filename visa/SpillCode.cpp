@@ -25,6 +25,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 ======================= end_copyright_notice ==================================*/
 
 #include <vector>
+#include <algorithm>
 #include "Mem_Manager.h"
 #include "FlowGraph.h"
 #include "BuildIR.h"
@@ -442,6 +443,112 @@ void SpillManager::replaceSpilledSrc(G4_BB* bb,
     }
 }
 
+//
+// Try to recompute a spilled predicate into tmpDcl by replaying the cmp that
+// defined it, instead of filling it from its GRF spill location. This is only
+// done when the cmp is close by in the same BB, fully defines the flag under
+// the same execution size and mask as the use, and none of its sources are
+// redefined in between. Return true if the cmp was replayed.
+//
+bool SpillManager::rematSpilledPredicate(G4_BB*         bb,
+                                         INST_LIST_ITER it, // where new insts will be inserted
+                                         G4_INST*       inst,
+                                         G4_Declare*    flagDcl,
+                                         G4_Declare*    tmpDcl)
+{
+    // Replaying the cmp extends its sources' live ranges up to the use,
+    // so only look back a short distance.
+    const unsigned maxRematDist = 16;
+
+    G4_Predicate* predicate = inst->getPredicate();
+    if (predicate->getControl() != PRED_DEFAULT)
+    {
+        // any/all predicates read channels the use doesn't execute
+        return false;
+    }
+
+    G4_Declare* rootDcl = flagDcl->getRootDeclare();
+    G4_INST* defInst = NULL;
+    INST_LIST_ITER defIt = it;
+    unsigned dist = 0;
+    while (defIt != bb->begin() && dist++ < maxRematDist)
+    {
+        --defIt;
+        G4_INST* curInst = *defIt;
+        G4_CondMod* mod = curInst->getCondMod();
+        G4_DstRegRegion* dst = curInst->getDst();
+        if ((mod != NULL && mod->getTopDcl() == rootDcl) ||
+            (dst != NULL && dst->getTopDcl() == rootDcl))
+        {
+            defInst = curInst;
+            break;
+        }
+    }
+
+    if (defInst == NULL ||
+        defInst->opcode() != G4_cmp ||
+        defInst->getPredicate() != NULL ||
+        defInst->getCondMod()->getBase()->asRegVar()->getDeclare() != flagDcl ||
+        defInst->getExecSize() != flagDcl->getNumberFlagElements() ||
+        defInst->getExecSize() != inst->getExecSize() ||
+        defInst->getMaskOption() != inst->getMaskOption())
+    {
+        return false;
+    }
+
+    // Sources must be immediates or direct GRF regions.
+    std::vector<G4_Declare*> srcDcls;
+    for (int i = 0; i < defInst->getNumSrc(); i++)
+    {
+        G4_Operand* src = defInst->getSrc(i);
+        if (src->isImm())
+        {
+            continue;
+        }
+        if (!src->isSrcRegRegion() ||
+            src->asSrcRegRegion()->getRegAccess() != Direct ||
+            src->getTopDcl() == NULL ||
+            src->getTopDcl()->getRegFile() != G4_GRF)
+        {
+            return false;
+        }
+        srcDcls.push_back(src->getTopDcl());
+    }
+
+    // The cmp dst (if any) must not feed its own sources.
+    G4_DstRegRegion* defDst = defInst->getDst();
+    if (defDst != NULL && !defDst->isNullReg() &&
+        std::find(srcDcls.begin(), srcDcls.end(), defDst->getTopDcl()) != srcDcls.end())
+    {
+        return false;
+    }
+
+    // No instruction between the cmp and the use may redefine its sources.
+    for (INST_LIST_ITER iter = std::next(defIt); iter != it; ++iter)
+    {
+        G4_DstRegRegion* dst = (*iter)->getDst();
+        if (dst == NULL || dst->isNullReg())
+        {
+            continue;
+        }
+        if (dst->getRegAccess() != Direct ||
+            std::find(srcDcls.begin(), srcDcls.end(), dst->getTopDcl()) != srcDcls.end())
+        {
+            return false;
+        }
+    }
+
+    G4_opcode op = defInst->opcode();
+    G4_Operand* src0 = builder.duplicateOperand(defInst->getSrc(0));
+    G4_Operand* src1 = builder.duplicateOperand(defInst->getSrc(1));
+    G4_CondMod* newCondMod = builder.createCondMod(defInst->getCondMod()->getMod(), tmpDcl->getRegVar(), 0);
+    G4_DstRegRegion* nullDst = builder.createNullDst(defDst != NULL ? defDst->getType() : Type_UD);
+    G4_INST* rematInst = builder.createInternalInst(NULL, op, newCondMod, false,
+        defInst->getExecSize(), nullDst, src0, src1, defInst->getOption());
+    bb->insert(it, rematInst);
+    return true;
+}
+
 //
 // check if predicate is spilled & insert fill code
 //
@@ -461,13 +568,21 @@ void SpillManager::replaceSpilledPredicate(G4_BB* bb,
         if (spDcl != NULL)
         {
             G4_Declare* tmpDcl = createNewTempFlagDeclare(flagDcl);
-            genRegMov(bb, it,
-                      spDcl->getRegVar(), 0,
-                      tmpDcl->getRegVar(),
-                      tmpDcl->getNumElems());
+            if (builder.getOption(vISA_FlagRemat) &&
+                rematSpilledPredicate(bb, it, inst, flagDcl, tmpDcl))
+            {
+                ++numFlagRemat;
+            }
+            else
+            {
+                genRegMov(bb, it,
+                          spDcl->getRegVar(), 0,
+                          tmpDcl->getRegVar(),
+                          tmpDcl->getNumElems());
+                ++numFlagSpillLoad;
+            }
             G4_Predicate *new_pred = builder.createPredicate(predicate->getState(), tmpDcl->getRegVar(), 0, predicate->getControl());
             inst->setPredicate(new_pred);
-            ++numFlagSpillLoad;
         }
     }
 }
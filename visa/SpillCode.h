@@ -62,6 +62,9 @@ class SpillManager
     // The number of flag spill load inserted.
     unsigned numFlagSpillLoad;
 
+    // The number of flag fills replaced by replaying the defining cmp.
+    unsigned numFlagRemat;
+
     void genRegMov(G4_BB* bb,
                    INST_LIST_ITER it,
                    G4_VarBase*    src,
@@ -92,6 +95,11 @@ class SpillManager
     void replaceSpilledFlagDst(G4_BB*     bb,
                            INST_LIST_ITER it,
                            G4_INST*       inst);
+    bool rematSpilledPredicate(G4_BB*     bb,
+                           INST_LIST_ITER it,
+                           G4_INST*       inst,
+                           G4_Declare*    flagDcl,
+                           G4_Declare*    tmpDcl);
 
     void createSpillLocations(G4_Kernel& kernel);
 
@@ -103,7 +111,7 @@ public:
         gra(g), kernel(g.kernel), pointsToAnalysis(g.pointsToAnalysis)
     {
         tempDclId = startTempDclId;
-        numFlagSpillStore = numFlagSpillLoad = 0;
+        numFlagSpillStore = numFlagSpillLoad = numFlagRemat = 0;
     }
     void insertSpillCode();
     bool isAnyNewTempCreated() const {return getNumTempCreated() != 0;}
@@ -112,6 +120,7 @@ public:
 
     unsigned getNumFlagSpillStore() const { return numFlagSpillStore; }
     unsigned getNumFlagSpillLoad() const { return numFlagSpillLoad; }
+    unsigned getNumFlagRemat() const { return numFlagRemat; }
 };
 }
 #endif // __SPILLCODE_H__
@@ -33,8 +33,10 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "DebugInfo.h"
 
 #include <math.h>
+#include <algorithm>
 #include <sstream>
 #include <fstream>
+#include <unordered_map>
 
 using namespace std;
 using namespace vISA;
@@ -509,7 +511,7 @@ SpillManagerGMRF::calculateSpillDisp (
 	// Locate the blocked locations calculated from the interfering
 	// spilled live ranges and put them into a list in ascending order.
 
-	typedef std::list < G4_RegVar * > LocList;
+	typedef std::vector < G4_RegVar * > LocList;
 	LocList locList;
 	unsigned lrId =
 		(regVar->getId () >= varIdCount_)?
@@ -522,19 +524,14 @@ SpillManagerGMRF::calculateSpillDisp (
 			G4_RegVar * intfRegVar = getRegVar (i);
 			assert (getRegVar (i)->isAliased () == false);
 			if (intfRegVar->isRegVarTransient ()) continue;
-			unsigned iDisp = intfRegVar->getDisp ();
-			if (iDisp == UINT_MAX) continue;
-			LocList::iterator loc;
-			for (loc = locList.begin ();
-				 loc != locList.end () && (*loc)->getDisp () < iDisp;
-				 ++loc);
-			if (loc != locList.end ())
-				locList.insert (loc, intfRegVar);
-			else
-				locList.push_back (intfRegVar);
+			if (intfRegVar->getDisp () == UINT_MAX) continue;
+			locList.push_back (intfRegVar);
 		}
 	}
 
+	std::sort (locList.begin (), locList.end (),
+		[](G4_RegVar* v1, G4_RegVar* v2) { return v1->getDisp () < v2->getDisp (); });
+
 	// Find a spill slot for lRange within the locList.
 	// we always start searching from 0 to facilitate cross-iteration reuse
     unsigned regVarLocDisp = 0;
@@ -677,7 +674,8 @@ G4_RegVar * regVar
             if (canDoSLMSpill())
             {
                 // don't have variables that cross the SLM/scratch boundary, makes our life a bit easier
-                // FIXME: may want to consider spill costs and put the important variables in SLM
+                // insertSpillFillCode() assigns displacements in decreasing ref count order,
+                // so the most referenced variables land in SLM
                 if (spillAreaOffset_ < maxSLMScratchSize &&
                     spillAreaOffset_ + getByteSize(regVar) > maxSLMScratchSize)
                 {
@@ -4115,9 +4113,172 @@ void SpillManagerGMRF::prunePointsTo( G4_Kernel* kernel, PointsToAnalysis& point
 	}
 }
 
+// Assign the spill disps of variables that are referenced within a few
+// instructions of each other next to each other, so that CoalesceSpillFills
+// can merge their fills (spills) into a single block read (write).
+// Variables are laid out greedily: start from the most referenced variable
+// not yet placed and keep appending the unplaced variable that is most often
+// co-used with the last one placed.
+
+void
+SpillManagerGMRF::layoutCoUsedSpills (
+	G4_Kernel * kernel
+)
+{
+    // Must match the window and max payload size of CoalesceSpillFills.
+    const unsigned coUseWindowSize = 10;
+    const unsigned maxCoalescedBytes = 4 * G4_GRF_REG_NBYTES;
+
+    std::vector<G4_RegVar*> vars;
+    std::unordered_map<G4_RegVar*, unsigned> varIndex;
+    for (auto lr : spilledLRs_)
+    {
+        G4_RegVar* var = lr->getVar();
+        if (var->getDisp() == UINT_MAX && !var->isAliased() &&
+            shouldSpillRegister(var) && getRFType(var) == G4_GRF &&
+            getByteSize(var) <= maxCoalescedBytes)
+        {
+            varIndex[var] = (unsigned)vars.size();
+            vars.push_back(var);
+        }
+    }
+
+    if (vars.size() < 2)
+    {
+        return;
+    }
+
+    std::vector<unsigned> numRefs(vars.size(), 0);
+    std::vector<std::unordered_map<unsigned, unsigned>> coUses(vars.size());
+
+    auto getVarIndex = [&](G4_Operand* opnd, unsigned& index)
+    {
+        if (opnd == nullptr || !opnd->getBase() || !opnd->getBase()->isRegVar())
+        {
+            return false;
+        }
+        auto it = varIndex.find(getReprRegVar(opnd->getBase()->asRegVar()));
+        if (it == varIndex.end())
+        {
+            return false;
+        }
+        index = it->second;
+        return true;
+    };
+
+    for (auto bb : kernel->fg.BBs)
+    {
+        // <inst number in BB, var index> of recent references to spilled vars
+        std::vector<std::pair<unsigned, unsigned>> window;
+        unsigned instNum = 0;
+        for (auto inst : *bb)
+        {
+            instNum++;
+            if (inst->isPseudoKill() || inst->isLifeTimeEnd())
+            {
+                continue;
+            }
+
+            window.erase(std::remove_if(window.begin(), window.end(),
+                [&](const std::pair<unsigned, unsigned>& ref) { return instNum - ref.first >= coUseWindowSize; }),
+                window.end());
+
+            auto addRef = [&](G4_Operand* opnd)
+            {
+                unsigned index = 0;
+                if (!getVarIndex(opnd, index))
+                {
+                    return;
+                }
+                numRefs[index]++;
+                for (auto& ref : window)
+                {
+                    if (ref.second != index)
+                    {
+                        coUses[index][ref.second]++;
+                        coUses[ref.second][index]++;
+                    }
+                }
+                window.push_back(std::make_pair(instNum, index));
+            };
+
+            addRef(inst->getDst());
+            for (unsigned i = 0; i < G4_MAX_SRCS; i++)
+            {
+                addRef(inst->getSrc(i));
+            }
+        }
+    }
+
+    std::vector<bool> placed(vars.size(), false);
+    for (unsigned numPlaced = 0; numPlaced < vars.size();)
+    {
+        unsigned last = UINT_MAX;
+        for (unsigned i = 0; i < vars.size(); i++)
+        {
+            if (!placed[i] && (last == UINT_MAX || numRefs[i] > numRefs[last]))
+            {
+                last = i;
+            }
+        }
+
+        while (last != UINT_MAX)
+        {
+            placed[last] = true;
+            numPlaced++;
+            getDisp(vars[last]);
+
+            unsigned next = UINT_MAX;
+            unsigned maxCoUses = 0;
+            for (auto& coUse : coUses[last])
+            {
+                if (!placed[coUse.first] &&
+                    (coUse.second > maxCoUses ||
+                     (coUse.second == maxCoUses && coUse.first < next)))
+                {
+                    next = coUse.first;
+                    maxCoUses = coUse.second;
+                }
+            }
+            last = next;
+        }
+    }
+}
+
 // Insert spill/fill code for all registers that have not been assigned
 // physical registers in the current iteration of the graph coloring
 // allocator.
+// Color the scratch slots of the spilled variables before any spill/fill code
+// asks for them. calculateSpillDisp is a first-fit search over the slots of
+// the interfering spills, so the order in which disps are requested decides
+// how fragmented the compressed spill space becomes. Visiting the largest
+// variables first lets the small ones fill the gaps left between them, which
+// keeps the total scratch size close to the maximum set of simultaneously
+// live spills.
+
+void
+SpillManagerGMRF::colorSpillSlots ()
+{
+    std::vector<G4_RegVar*> vars;
+    for (auto lr : spilledLRs_)
+    {
+        G4_RegVar* var = lr->getVar();
+        if (var->getDisp() == UINT_MAX && !var->isAliased() &&
+            shouldSpillRegister(var) && getRFType(var) == G4_GRF)
+        {
+            vars.push_back(var);
+        }
+    }
+
+    std::stable_sort(vars.begin(), vars.end(),
+        [this](G4_RegVar* v1, G4_RegVar* v2) { return getByteSize(v1) > getByteSize(v2); });
+
+    for (auto var : vars)
+    {
+        getDisp(var);
+    }
+}
+
 // returns false if spill fails somehow
 
 bool
@@ -4175,6 +4336,16 @@ SpillManagerGMRF::insertSpillFillCode (
 		}
 	}
 
+    // SLM placement is by ref count and compressed spill space has its own disps
+    if (!canDoSLMSpill() && !doSpillSpaceCompression)
+    {
+        layoutCoUsedSpills(kernel);
+    }
+    else if (!canDoSLMSpill() && builder_->getOption(vISA_SpillSlotColoring))
+    {
+        colorSpillSlots();
+    }
+
 	// Handle address taken spills
 	bool success = handleAddrTakenSpills( kernel, pointsToAnalysis );
 
@@ -108,6 +108,19 @@ static _THREAD char kernelAsmName[256] = "";
 static _THREAD LARGE_INTEGER proc_freq;
 static _THREAD int numTimers = TIMER_NUM_TIMERS;
 
+// Timeline of timer spans for trace-event export; only recorded
+// once enabled by enableTimerTrace().
+struct TimerTraceEvent {
+    int timer;
+    LONGLONG start;
+    LONGLONG end;
+};
+
+#define MAX_TIMER_TRACE_EVENTS 1024
+static _THREAD TimerTraceEvent traceEvents[MAX_TIMER_TRACE_EVENTS];
+static _THREAD unsigned int numTraceEvents = 0;
+static _THREAD bool traceEnabled = false;
+
 void initTimer() {
 
 #ifdef MEASURE_COMPILATION_TIME
@@ -195,6 +208,13 @@ void stopTimer(int timer)
         QueryPerformanceCounter(&stop);
         timers[timer].time += (stop.QuadPart - timers[timer].currentStart) / (double) proc_freq.QuadPart;
         timers[timer].ticks += (stop.QuadPart - timers[timer].currentStart);
+        if (traceEnabled && numTraceEvents < MAX_TIMER_TRACE_EVENTS)
+        {
+            TimerTraceEvent& event = traceEvents[numTraceEvents++];
+            event.timer = timer;
+            event.start = timers[timer].currentStart;
+            event.end = stop.QuadPart;
+        }
         timers[timer].currentStart = 0;
 #if defined(_DEBUG) && defined(CHECK_TIMER)
         timers[timer].started = false;
@@ -225,11 +245,41 @@ extern "C" int64_t getTimerTicks(unsigned int idx)
     return timers[idx].ticks;
 }
 
+extern "C" void enableTimerTrace(bool enable)
+{
+    traceEnabled = enable;
+    numTraceEvents = 0;
+}
+
+extern "C" unsigned int getNumTimerTraceEvents()
+{
+    return numTraceEvents;
+}
+
+extern "C" bool getTimerTraceEvent(unsigned int idx, unsigned int* timer, int64_t* startNS, int64_t* endNS)
+{
+    if (idx >= numTraceEvents || proc_freq.QuadPart == 0)
+    {
+        return false;
+    }
+    const TimerTraceEvent& event = traceEvents[idx];
+    double nsPerTick = 1000000000.0 / (double)proc_freq.QuadPart;
+    *timer = event.timer;
+    *startNS = (int64_t)(event.start * nsPerTick);
+    *endNS = (int64_t)(event.end * nsPerTick);
+    return true;
+}
+
 double getTimerUS(unsigned int idx)
 {
     return (timers[idx].ticks * 1000000) / (double)proc_freq.QuadPart;
 }
 
+const char* getTimerName(unsigned int idx)
+{
+    return timerNames[idx];
+}
+
 void dumpAllTimers(const char *asmFileName, bool outputTime)
 {
     // This generates output like this:
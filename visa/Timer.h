@@ -57,6 +57,7 @@ void dumpAllTimers(const char *asmFileName, bool outputTime = false);
 void dumpEncoderStats(Options *opt, std::string &asmName);
 void resetPerKernel();
 double getTimerUS(unsigned idx);
+const char* getTimerName(unsigned idx);
 
 #define DEF_TIMER(ENUM, DESCR) ENUM,
 typedef enum TIMERS
@@ -139,7 +139,18 @@ public:
     }
 
     void finalizeKernel();
-    unsigned long writeInToCisaBinaryBuffer(const void * value, int size);
+    // The buffer is sized up front by finalizeKernel(), CBinaryCISAEmitter
+    // streams every field straight into it.
+    unsigned long writeInToCisaBinaryBuffer(const void * value, int size)
+    {
+        MUST_BE_TRUE(m_bytes_written_cisa_buffer + size <= m_cisa_binary_size,
+            "Size of VISA instructions binary buffer is exceeded.");
+
+        memcpy_s(&m_cisa_binary_buffer[m_bytes_written_cisa_buffer], size, value, size);
+        m_bytes_written_cisa_buffer += size;
+
+        return m_bytes_written_cisa_buffer;
+    }
     unsigned long getBytesWritten() { return m_bytes_written_cisa_buffer; }
 
     void setName(const char* n);
@@ -872,11 +883,15 @@ public:
     void computeAndEmitGenRelocs();
     void computeAllRelocs(unsigned int& numRelocs, BasicRelocEntry*& output);
     void emitAllRelocs(unsigned int numRelocs, BasicRelocEntry* relocs);
+    // free the G4 IR once the kernel is finalized; only the binary, jitInfo
+    // and relocations stay available afterwards
+    void releaseG4IR();
 
 private:
     void setDefaultVariableName(Common_ISA_Var_Class Ty, const char *&varName);
     void dumpDebugFormatFile(std::vector<vISA::DebugInfoFormat>& debugSymbols, std::string filename);
     void patchLabels();
+    void collectRelocs(std::vector<BasicRelocEntry>& relocs);
     int InitializeFastPath();
     int predefinedVarRegAssignment();
     int calculateTotalInputSize();
@@ -926,6 +941,8 @@ private:
     unsigned long m_genx_debug_info_size;
     char * m_genx_debug_info_buffer;
     FINALIZER_INFO* m_jitInfo;
+    // relocations kept by releaseG4IR() for GetGenReloc
+    std::vector<BasicRelocEntry> m_releasedRelocs;
 
     unsigned long m_cisa_binary_size;
     char * m_cisa_binary_buffer;
@@ -43,6 +43,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "DebugInfo.h"
 #include "iga/IGALibrary/IR/Instruction.hpp"
 #include "BinaryEncodingIGA.h"
+#include "PerfEstimate.h"
 
 #if defined( _DEBUG ) && ( defined( _WIN32 ) || defined( _WIN64 ) )
 #include <windows.h>
@@ -335,6 +336,7 @@ void* VISAKernelImpl::compilePostOptimize(unsigned int& binarySize)
     {
         RELEASE_MSG("\tKernel " << m_asmName << " : " << m_kernel->getAsmCount() << " asm_count" << std::endl);
     }
+    m_jitInfo->peakPostRAArenaKB = (unsigned int)(ArenaUsage::TakePeak() / 1024);
     stopTimer(TIMER_ENCODE_AND_EMIT);
 
 #if defined( _DEBUG ) && ( defined( _WIN32 ) || defined( _WIN64 ) )
@@ -366,6 +368,42 @@ void* VISAKernelImpl::compilePostOptimize(unsigned int& binarySize)
     if( m_builder->getJitInfo() != NULL )
     {
         m_builder->getJitInfo()->numAsmCount = m_kernel->getAsmCount();
+        m_builder->getJitInfo()->numCompactedInst = m_kernel->getCompactedCount();
+
+        FINALIZER_INFO* jitInfo = m_builder->getJitInfo();
+        jitInfo->numSamplerSends = jitInfo->numDataPortSends = jitInfo->numOtherSends = 0;
+        for (auto bb : m_kernel->fg.BBs)
+        {
+            for (auto inst : *bb)
+            {
+                if (!inst->isSend())
+                {
+                    continue;
+                }
+                switch (inst->getMsgDesc()->getFuncId())
+                {
+                case SFID_SAMPLER:
+                    jitInfo->numSamplerSends++;
+                    break;
+                case SFID_DP_DC:
+                case SFID_DP_DC1:
+                case SFID_DP_DC2:
+                case SFID_DP_CC:
+                case SFID_DP_WRITE:
+                    jitInfo->numDataPortSends++;
+                    break;
+                default:
+                    jitInfo->numOtherSends++;
+                    break;
+                }
+            }
+        }
+
+        if (m_options->getOption(vISA_EstimateCycles))
+        {
+            uint64_t cycles = vISA::estimateWeightedCycles(*m_kernel);
+            jitInfo->numEstimatedCycles = (unsigned int)std::min<uint64_t>(cycles, UINT_MAX);
+        }
     }
 
 
@@ -1115,6 +1153,12 @@ int VISAKernelImpl::AddKernelAttribute(const char* attrName, int size, const voi
         mTargetAttributeSet = true;
     }
 
+    if (strcmp(attrName, "SLMSize") == 0 && attr->isInt)
+    {
+        // SLMSize is in 1KB units
+        m_kernel->setSLMSize(attr->value.intVal * 1024);
+    }
+
     if(strcmp(attrName, "Callable") == 0)
     {
         setFCCallableKernel(true);
@@ -7721,17 +7765,6 @@ void VISAKernelImpl::finalizeKernel()
 
 }
 
-unsigned long VISAKernelImpl::writeInToCisaBinaryBuffer(const void * value, int size)
-{
-    MUST_BE_TRUE( m_bytes_written_cisa_buffer + size <= m_cisa_binary_size,
-        "Size of VISA instructions binary buffer is exceeded." );
-
-    memcpy_s( &m_cisa_binary_buffer[m_bytes_written_cisa_buffer], size, value, size );
-    m_bytes_written_cisa_buffer += size;
-
-    return m_bytes_written_cisa_buffer;
-}
-
 VISA_LabelOpnd* VISAKernelImpl::getLabelOperandFromFunctionName(std::string name)
 {
     std::map<std::string, VISA_LabelOpnd *>::iterator it;
@@ -7915,13 +7948,31 @@ VISAKernelImpl::~VISAKernelImpl()
 
     if (IS_GEN_BOTH_PATH)
     {
-        //need to call destructor even thought it is allocated in memory pool.
-        //so that internal data structures get cleared.
-        m_kernel->~G4_Kernel();
-        m_builder->~IR_Builder();
-        delete m_globalMem;
-        delete m_kernelMem;
+        releaseG4IR();
+    }
+}
+
+void VISAKernelImpl::releaseG4IR()
+{
+    if (m_kernel == NULL)
+    {
+        return;
     }
+
+    // GetGenReloc walks the IR, so keep its entries around
+    m_releasedRelocs.clear();
+    collectRelocs(m_releasedRelocs);
+
+    //need to call destructor even thought it is allocated in memory pool.
+    //so that internal data structures get cleared.
+    m_kernel->~G4_Kernel();
+    m_builder->~IR_Builder();
+    delete m_globalMem;
+    delete m_kernelMem;
+    m_kernel = NULL;
+    m_builder = NULL;
+    m_globalMem = NULL;
+    m_kernelMem = NULL;
 }
 
 int VISAKernelImpl::GetGenxBinary(void *&buffer, int &size)
@@ -7993,7 +8044,7 @@ int VISAKernelImpl::GetGTPinBuffer(void*& buffer, unsigned int& size)
     buffer = nullptr;
     size = 0;
 
-    if (m_kernel->hasGTPinInit())
+    if (m_kernel && m_kernel->hasGTPinInit())
     {
         auto gtpin = m_kernel->getGTPinData();
         if (gtpin)
@@ -8492,10 +8543,8 @@ void VISAKernelImpl::computeAndEmitDebugInfo(std::list<VISAKernelImpl*>& functio
 #endif
 }
 
-void VISAKernelImpl::computeAllRelocs(unsigned int& numRelocs, BasicRelocEntry*& output)
+void VISAKernelImpl::collectRelocs(std::vector<BasicRelocEntry>& relocs)
 {
-    vector<BasicRelocEntry> relocs;
-
     for (auto bbs : getKernel()->fg.BBs)
     {
         for (auto insts : *bbs)
@@ -8517,6 +8566,20 @@ void VISAKernelImpl::computeAllRelocs(unsigned int& numRelocs, BasicRelocEntry*&
             }
         }
     }
+}
+
+void VISAKernelImpl::computeAllRelocs(unsigned int& numRelocs, BasicRelocEntry*& output)
+{
+    vector<BasicRelocEntry> relocs;
+
+    if (m_kernel)
+    {
+        collectRelocs(relocs);
+    }
+    else
+    {
+        relocs = m_releasedRelocs;
+    }
 
     numRelocs = (uint32_t) relocs.size();
     if (numRelocs > 0)
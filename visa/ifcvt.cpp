@@ -24,6 +24,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 ======================= end_copyright_notice ==================================*/
 
+#include <algorithm>
 #include <tuple>
 
 #include "ifcvt.h"
@@ -44,6 +45,14 @@ namespace {
     const unsigned FullyConvertibleMaxInsts = 5;
     const unsigned PartialConvertibleMaxInsts = 3;
 
+    // Cost model (-ifcvtCostModel) weights, in instruction issue slots.
+    // 'if', 'else' and 'endif' (or 'goto' and 'join') each update the channel
+    // enable mask and stall the front-end; a uniform branch becomes a 'jmpi',
+    // which only costs the taken-jump bubble.
+    const unsigned IfEndifCost = 4;
+    const unsigned ElseCost = 2;
+    const unsigned JmpiCost = 2;
+
     enum IfConvertKind {
         FullConvert,
         // Both 'if' and 'else' (if present) branches could be predicated.
@@ -371,13 +380,18 @@ namespace {
         /// getPredictableInsts - Return the total number of instructions if
         /// all instruction in the given BB is predictable. Otherwise, return
         /// 0.
-        unsigned getPredictableInsts(G4_BB *BB, G4_INST *ifInst) const {
+        /// If 'cost' is given, it's set to the summed issue cost of those
+        /// instructions.
+        unsigned getPredictableInsts(G4_BB *BB, G4_INST *ifInst,
+                                     unsigned *cost = nullptr) const {
             ASSERT_USER(ifInst->opcode() == G4_if ||
                         ifInst->opcode() == G4_goto,
                         "Either 'if' or 'goto' is expected!");
 
             bool isGoto = (ifInst->opcode() == G4_goto);
             unsigned sum = 0;
+            if (cost)
+                *cost = 0;
 
             for (auto *I : *BB) {
                 G4_opcode op = I->opcode();
@@ -418,6 +432,8 @@ namespace {
                     return 0;
                 }
                 ++sum;
+                if (cost)
+                    *cost += getInstCost(I);
             }
 
             return sum;
@@ -466,6 +482,58 @@ namespace {
         void fullConvert(IfConvertible &);
         void partialConvert(IfConvertible &);
 
+        /// getInstCost - Issue cost of the given instruction once predicated.
+        /// Instructions whose destination spans two GRFs are issued twice.
+        unsigned getInstCost(G4_INST *I) const {
+            G4_DstRegRegion *dst = I->getDst();
+            if (!dst || dst->isNullReg())
+                return 1;
+            unsigned bytes =
+                I->getExecSize() * G4_Type_Table[dst->getType()].byteSize *
+                dst->getHorzStride();
+            return bytes > GENX_GRF_REG_SIZ ? 2 : 1;
+        }
+
+        /// isUniformBranch - Check whether all channels take the same
+        /// direction on the given 'if' or 'goto', i.e. it has no predicate,
+        /// is scalar, or its predicate groups all channels of the kernel.
+        bool isUniformBranch(G4_INST *ifInst) const {
+            G4_Predicate *pred = ifInst->getPredicate();
+            if (ifInst->getExecSize() == 1 || !pred)
+                return true;
+            return pred->getPredCtrlGroupSize() == fg.getKernel()->getSimdSize();
+        }
+
+        /// isProfitable - Cost model deciding whether predicating both
+        /// branches (with costs c0 and c1) beats keeping the branch.
+        ///
+        /// When the branch diverges, both branches run anyway and the branch
+        /// is pure overhead. When it is coherent, only one side runs (half
+        /// of the total on average). The expected branched cost is weighed by
+        /// the divergence probability (-ifcvtDivergencePct for divergent
+        /// branches, 0 for uniform ones) and compared against the predicated
+        /// cost, which always pays for both sides.
+        bool isProfitable(G4_INST *ifInst, unsigned c0, unsigned c1) const {
+            bool isUniform = isUniformBranch(ifInst);
+            unsigned overhead =
+                isUniform ? JmpiCost : IfEndifCost + (c1 ? ElseCost : 0);
+            unsigned divergencePct = isUniform ? 0 :
+                std::min(100u, fg.builder->getOptions()->getuInt32Option(
+                                   vISA_ifCvtDivergencePct));
+
+            unsigned both = c0 + c1;
+            // Both sides scaled by 200 to stay in integer arithmetic.
+            unsigned branched = overhead * 200 +
+                                divergencePct * 2 * both +
+                                (100 - divergencePct) * both;
+            unsigned predicated = both * 200;
+
+            DEBUG(std::cerr << "ifcvt cost: " << (isUniform ? "uniform" : "divergent")
+                            << " branched " << branched
+                            << " predicated " << predicated << '\n');
+            return predicated <= branched;
+        }
+
     public:
         IfConverter(FlowGraph &g) : fg(g) {}
 
@@ -486,6 +554,8 @@ namespace {
 } // End anonymous namespace
 
 void IfConverter::analyze(std::vector<IfConvertible> &list) {
+    bool useCostModel = fg.builder->getOption(vISA_ifCvtCostModel);
+
     for (auto *BB : fg.BBs) {
         G4_INST *ifInst;
         G4_BB *s0, *s1, *t;
@@ -498,6 +568,20 @@ void IfConverter::analyze(std::vector<IfConvertible> &list) {
 
         G4_Predicate *pred = ifInst->getPredicate();
 
+        if (useCostModel) {
+            unsigned c0 = 0, c1 = 0;
+            if (!getPredictableInsts(s0, ifInst, &c0))
+                continue;
+            if (s1 && !getPredictableInsts(s1, ifInst, &c1))
+                continue;
+            // Partial conversion isn't implemented yet, so only full
+            // conversion is considered.
+            if (isProfitable(ifInst, c0, c1))
+                list.push_back(
+                    IfConvertible(FullConvert, pred, BB, s0, s1, t));
+            continue;
+        }
+
         unsigned n0 = getPredictableInsts(s0, ifInst);
         unsigned n1 = s1 ? getPredictableInsts(s1, ifInst) : 0;
 
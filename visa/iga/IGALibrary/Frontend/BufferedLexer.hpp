@@ -38,14 +38,6 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 // #define DUMP_LEXEMES
 
-#define YY_DECL iga::Lexeme yylex (yyscan_t yyscanner, unsigned int &inp_off)
-#ifndef YY_NO_UNISTD_H
-#define YY_NO_UNISTD_H
-#endif
-#include "lex.yy.hpp"
-
-YY_DECL;
-
 namespace iga {
 
 struct Token {
@@ -110,54 +102,225 @@ class BufferedLexer {
 
     Token               m_eof;
 
+    // character classes for the scanner
+    enum CharClass : uint8_t {
+        CC_OTHER  = 0x0,
+        CC_DIGIT  = 0x1, // [0-9]
+        CC_ALPHA  = 0x2, // [_a-zA-Z]
+        CC_HEX    = 0x4, // [0-9A-Fa-f]
+        CC_SPACE  = 0x8, // [ \t\r]
+    };
+    static uint8_t charClass(char c) {
+        struct Table {
+            uint8_t classes[256];
+            Table() {
+                for (int i = 0; i < 256; i++) {
+                    uint8_t cc = CC_OTHER;
+                    if (i >= '0' && i <= '9')
+                        cc |= CC_DIGIT | CC_HEX;
+                    if ((i >= 'a' && i <= 'z') || (i >= 'A' && i <= 'Z') || i == '_')
+                        cc |= CC_ALPHA;
+                    if ((i >= 'a' && i <= 'f') || (i >= 'A' && i <= 'F'))
+                        cc |= CC_HEX;
+                    if (i == ' ' || i == '\t' || i == '\r')
+                        cc |= CC_SPACE;
+                    classes[i] = cc;
+                }
+            }
+        };
+        static const Table table;
+        return table.classes[(unsigned char)c];
+    }
+    bool is(size_t off, uint8_t cc) const {
+        return off < m_input.size() && (charClass(m_input[off]) & cc) != 0;
+    }
+    size_t skipWhile(size_t off, uint8_t cc) const {
+        while (is(off, cc))
+            off++;
+        return off;
+    }
+
+    // Scans a token starting with a digit. This follows the longest match
+    // rule over the numeric lexemes (earlier patterns win ties):
+    //   INTLIT02:  0[bB][01]+
+    //   INTLIT10:  [0-9]+
+    //   INTLIT16:  0[xX][0-9A-Fa-f]+
+    //   FLTLIT:    [0-9]+\.[0-9]+([eE][-+]?[0-9]+)?
+    //   FLTLIT:    [0-9]+[eE][-+]?[0-9]+
+    //   IDENT:     [0-9]+[_a-zA-Z]+[_a-zA-Z0-9]  (e.g. "128x1")
+    Lexeme scanNumber(size_t off, size_t &len) const {
+        const std::string &s = m_input;
+        auto at = [&] (size_t i) {return i < s.size() ? s[i] : '\0';};
+        auto consider = [&] (Lexeme lxm, size_t end, Lexeme &best) {
+            if (end - off > len) {
+                len = end - off;
+                best = lxm;
+            }
+        };
+        auto exponent = [&] (size_t i) {
+            // matches [eE][-+]?[0-9]+ and returns the end or 0
+            if (at(i) != 'e' && at(i) != 'E')
+                return (size_t)0;
+            i++;
+            if (at(i) == '-' || at(i) == '+')
+                i++;
+            return is(i, CC_DIGIT) ? skipWhile(i, CC_DIGIT) : (size_t)0;
+        };
+
+        Lexeme best = Lexeme::INTLIT10;
+        len = 0;
+        if (at(off) == '0' && (at(off + 1) == 'b' || at(off + 1) == 'B') &&
+            (at(off + 2) == '0' || at(off + 2) == '1'))
+        {
+            size_t i = off + 2;
+            while (at(i) == '0' || at(i) == '1')
+                i++;
+            consider(Lexeme::INTLIT02, i, best);
+        }
+        size_t digEnd = skipWhile(off, CC_DIGIT);
+        consider(Lexeme::INTLIT10, digEnd, best);
+        if (at(off) == '0' && (at(off + 1) == 'x' || at(off + 1) == 'X') &&
+            is(off + 2, CC_HEX))
+        {
+            consider(Lexeme::INTLIT16, skipWhile(off + 2, CC_HEX), best);
+        }
+        if (at(digEnd) == '.' && is(digEnd + 1, CC_DIGIT)) {
+            size_t fracEnd = skipWhile(digEnd + 1, CC_DIGIT);
+            size_t expEnd = exponent(fracEnd);
+            consider(Lexeme::FLTLIT, expEnd ? expEnd : fracEnd, best);
+        }
+        if (size_t expEnd = exponent(digEnd)) {
+            consider(Lexeme::FLTLIT, expEnd, best);
+        }
+        size_t alphaEnd = skipWhile(digEnd, CC_ALPHA);
+        if (alphaEnd > digEnd) {
+            if (is(alphaEnd, CC_DIGIT)) {
+                consider(Lexeme::IDENT, alphaEnd + 1, best);
+            } else if (alphaEnd - digEnd >= 2) {
+                consider(Lexeme::IDENT, alphaEnd, best);
+            }
+        }
+        return best;
+    }
+
+    // A hand-written scanner producing the same tokens as the flex
+    // specification it replaced; it tokenizes the entire input up front
+    // in one linear pass.
+    //   - whitespace ([ \t\r]+), "//" comments, and "/* */" comments are
+    //     skipped; newlines are explicit NEWLINE tokens
+    //   - "(abs)", "(sat)", "<<", and ">>" are single tokens
+    //   - any other unmatched character is a LEXICAL_ERROR
+    void scan() {
+        const std::string &s = m_input;
+        const size_t n = s.size();
+        m_tokens.reserve(n / 4 + 1);
+
+        uint32_t lno = 1;
+        size_t off = 0;
+        size_t lineStart = 0; // offset of the first character of this line
+        size_t bolOff = 0; // offset of the last NEWLINE token
+        auto at = [&] (size_t i) {return i < n ? s[i] : '\0';};
+        auto emit = [&] (Lexeme lxm, size_t len) {
+            uint32_t col = (uint32_t)(off - lineStart + 1);
+            m_tokens.emplace_back(lxm, lno, col, (uint32_t)off, (uint32_t)len);
+            off += len;
+        };
+
+        while (off < n) {
+            char c = s[off];
+            uint8_t cc = charClass(c);
+            if (cc & CC_SPACE) {
+                off = skipWhile(off, CC_SPACE);
+            } else if (c == '\n') {
+                // historically the newline column is relative to the
+                // previous newline token rather than the line start
+                uint32_t col = (uint32_t)(off - bolOff + 1);
+                m_tokens.emplace_back(
+                    Lexeme::NEWLINE, lno, col, (uint32_t)off, 1);
+                bolOff = off;
+                off++;
+                lno++;
+                lineStart = off;
+            } else if (c == '/' && at(off + 1) == '/') {
+                while (off < n && s[off] != '\n')
+                    off++;
+            } else if (c == '/' && at(off + 1) == '*') {
+                off += 2;
+                while (off < n && !(s[off] == '*' && at(off + 1) == '/')) {
+                    if (s[off] == '\n') {
+                        lno++;
+                        lineStart = off + 1;
+                    }
+                    off++;
+                }
+                if (off < n)
+                    off += 2;
+            } else if (cc & CC_DIGIT) {
+                size_t len = 0;
+                Lexeme lxm = scanNumber(off, len);
+                emit(lxm, len);
+            } else if (cc & CC_ALPHA) {
+                emit(Lexeme::IDENT,
+                    skipWhile(off + 1, CC_ALPHA | CC_DIGIT) - off);
+            } else {
+                switch (c) {
+                case '<': emit(at(off + 1) == '<' ?
+                    Lexeme::LSH : Lexeme::LANGLE, at(off + 1) == '<' ? 2 : 1);
+                    break;
+                case '>': emit(at(off + 1) == '>' ?
+                    Lexeme::RSH : Lexeme::RANGLE, at(off + 1) == '>' ? 2 : 1);
+                    break;
+                case '(':
+                    if (s.compare(off, 5, "(abs)") == 0) {
+                        emit(Lexeme::ABS, 5);
+                    } else if (s.compare(off, 5, "(sat)") == 0) {
+                        emit(Lexeme::SAT, 5);
+                    } else {
+                        emit(Lexeme::LPAREN, 1);
+                    }
+                    break;
+                case '[': emit(Lexeme::LBRACK, 1); break;
+                case ']': emit(Lexeme::RBRACK, 1); break;
+                case '{': emit(Lexeme::LBRACE, 1); break;
+                case '}': emit(Lexeme::RBRACE, 1); break;
+                case ')': emit(Lexeme::RPAREN, 1); break;
+                case '$': emit(Lexeme::DOLLAR, 1); break;
+                case '.': emit(Lexeme::DOT, 1); break;
+                case ',': emit(Lexeme::COMMA, 1); break;
+                case ';': emit(Lexeme::SEMI, 1); break;
+                case ':': emit(Lexeme::COLON, 1); break;
+                case '~': emit(Lexeme::TILDE, 1); break;
+                case '!': emit(Lexeme::BANG, 1); break;
+                case '@': emit(Lexeme::AT, 1); break;
+                case '#': emit(Lexeme::HASH, 1); break;
+                case '=': emit(Lexeme::EQ, 1); break;
+                case '%': emit(Lexeme::MOD, 1); break;
+                case '*': emit(Lexeme::MUL, 1); break;
+                case '/': emit(Lexeme::DIV, 1); break;
+                case '+': emit(Lexeme::ADD, 1); break;
+                case '-': emit(Lexeme::SUB, 1); break;
+                case '&': emit(Lexeme::AMP, 1); break;
+                case '^': emit(Lexeme::CIRC, 1); break;
+                case '|': emit(Lexeme::PIPE, 1); break;
+                default:  emit(Lexeme::LEXICAL_ERROR, 1); break;
+                }
+            }
+        }
+
+        // flex reported the end of file as a one character token ending
+        // at the current column; preserve this for diagnostics
+        m_eof = Token(Lexeme::END_OF_FILE,
+            lno, (uint32_t)(off - lineStart), (uint32_t)off, 1);
+        m_tokens.push_back(m_eof);
+    }
+
 public:
     BufferedLexer(const std::string &inp)
         : m_offset(0), m_mark(0)
         , m_input(inp)
         , m_eof(Lexeme::END_OF_FILE, 0, 0, 0, 0)
     {
-        yyscan_t yy;
-
-        yylex_init(&yy);
-        yy_scan_string(inp.c_str(), yy);
-        yyset_lineno(1, yy);
-        yyset_column(1, yy);
-
-        unsigned int inpOff = 0, bolOff = 0;
-
-        Lexeme lxm;
-        while (true) {
-            lxm = yylex(yy, inpOff);
-
-            uint32_t lno = (uint32_t)yyget_lineno(yy);
-            uint32_t len = (uint32_t)yyget_leng(yy);
-            uint32_t col = (uint32_t)yyget_column(yy) - len;
-            uint32_t off = (uint32_t)inpOff;
-            if (lxm == Lexeme::NEWLINE) {
-                // flex increments yylineno and clear's column before this
-                // we fix this by backing up the newline for that case
-                // and inferring the final column from the beginning of
-                // the last line
-                lno--;
-                col = inpOff - bolOff + 1;
-                bolOff = inpOff;
-            }
-            // const char *str = yyget_text(yy);
-            // printf("AT %u.%u(%u:%u:\"%s\"): %s\n",
-            //  lno,col,off,len,str,LexemeString(lxm));
-            // struct Loc loc(lno,col,off,len);
-            // ShowToken(inp,loc,std::cout);
-
-            if (lxm == Lexeme::END_OF_FILE) {
-                m_eof = Token(lxm, lno, col, off, len); // update EOF w/ loc
-                m_tokens.push_back(m_eof);
-                break;
-            }
-            m_tokens.emplace_back(lxm, lno, col, off, len);
-            inpOff += len;
-        }
-
-        yylex_destroy(yy);
+        scan();
     }
     const std::string &GetSource() const {return m_input;}
 
@@ -61,6 +61,8 @@ protected:
     struct ColumnPreferences     cols;
     const Instruction           *currInst;
     const uint8_t               *bits; // optional bits to render
+    // reused for each instruction's EOL comments
+    std::stringstream            eolComments;
 
     void warning(const char *msg) {
         if (currInst) {
@@ -594,7 +596,9 @@ private:
         const Instruction &i,
         const std::string &debugSendDecode)
     {
-        std::stringstream ss;
+        std::stringstream &ss = eolComments;
+        ss.str("");
+        ss.clear();
 
         // separate all comments with a semicolon
         Intercalator semiColon(ss, "; ");
@@ -993,6 +997,54 @@ void FormatKernel(
 }
 
 
+// a stream buffer that appends to a string; positions are the string's
+// length so the formatter's column tracking stays cheap
+class StringAppendBuffer : public std::streambuf
+{
+    std::string &str;
+public:
+    StringAppendBuffer(std::string &s) : str(s) { }
+protected:
+    int_type overflow(int_type c) override {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            str.push_back(traits_type::to_char_type(c));
+        }
+        return traits_type::not_eof(c);
+    }
+    std::streamsize xsputn(const char *s, std::streamsize n) override {
+        str.append(s, (size_t)n);
+        return n;
+    }
+    pos_type seekoff(
+        off_type off,
+        std::ios_base::seekdir dir,
+        std::ios_base::openmode which) override
+    {
+        if (off == 0 && dir == std::ios_base::cur &&
+            (which & std::ios_base::out))
+        {
+            return pos_type((off_type)str.size());
+        }
+        return pos_type(off_type(-1));
+    }
+};
+
+
+void FormatKernel(
+    ErrorHandler& e,
+    std::string& out,
+    const FormatOpts& opts,
+    const Kernel& k,
+    const void *bits)
+{
+    // most instructions fit in this, so we rarely need to regrow
+    out.reserve(out.size() + 128 * k.getInstructionCount());
+    StringAppendBuffer buf(out);
+    std::ostream o(&buf);
+    FormatKernel(e, o, opts, k, bits);
+}
+
+
 void FormatInstruction(
     ErrorHandler& e,
     std::ostream& o,
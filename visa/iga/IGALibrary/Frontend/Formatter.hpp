@@ -32,6 +32,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../IR/Kernel.hpp"
 #include "../strings.hpp"
 
+#include <cstring>
 #include <iomanip>
 #include <ostream>
 #include <string>
@@ -94,6 +95,16 @@ namespace iga {
         const Kernel &k,
         const void *bits = nullptr);
 
+    // Formats by appending to a caller-supplied buffer.  This avoids the
+    // overhead of a std::stringstream for bulk output and lets the caller
+    // reuse the buffer's storage from one kernel to the next.
+    void FormatKernel(
+        ErrorHandler &e,
+        std::string &out,
+        const FormatOpts &opts,
+        const Kernel &k,
+        const void *bits = nullptr);
+
     void FormatInstruction(
         ErrorHandler &e,
         std::ostream &o,
@@ -195,6 +206,41 @@ namespace iga {
 #ifdef TRACE_EMIT
             std::cerr << t;
             std::cerr.flush();
+#endif
+        }
+        // The most common cases bypass the formatted stream insertion and
+        // write straight to the stream buffer.
+        void emit(char c) {
+            o.rdbuf()->sputc(c);
+#ifdef TRACE_EMIT
+            std::cerr << c;
+            std::cerr.flush();
+#endif
+        }
+        void emit(const char *str) {
+            emitChars(str, strlen(str));
+        }
+        void emit(const std::string &str) {
+            emitChars(str.c_str(), str.size());
+        }
+        void emit(int val) {
+            char buf[16];
+            size_t len = 0;
+            unsigned uval = val < 0 ? 0u - (unsigned)val : (unsigned)val;
+            do {
+                buf[sizeof(buf) - 1 - len++] = (char)('0' + uval % 10);
+                uval /= 10;
+            } while (uval != 0);
+            if (val < 0) {
+                buf[sizeof(buf) - 1 - len++] = '-';
+            }
+            emitChars(buf + sizeof(buf) - len, len);
+        }
+        void emitChars(const char *str, size_t len) {
+            o.rdbuf()->sputn(str, (std::streamsize)len);
+#ifdef TRACE_EMIT
+            std::cerr.write(str, len);
+            std::cerr.flush();
 #endif
         }
         template <typename T, typename U>
@@ -212,8 +258,11 @@ namespace iga {
 
 
         void emitSpaces(size_t n) {
-            for (size_t i = 0; i < n; i++) {
-                emit(' ');
+            static const char spaces[] = "                "; // 16
+            while (n > 0) {
+                size_t chunk = std::min<size_t>(n, sizeof(spaces) - 1);
+                emitChars(spaces, chunk);
+                n -= chunk;
             }
         }
 
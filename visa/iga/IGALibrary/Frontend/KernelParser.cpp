@@ -35,6 +35,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <limits>
 #include <map>
+#include <unordered_map>
 #include <string>
 #include <vector>
 
@@ -914,7 +915,7 @@ void GenParser::initSymbolMaps()
 class KernelParser : GenParser
 {
     // maps mnemonics and registers for faster lookup
-    std::map<std::string,const OpSpec*>   opmap;
+    std::unordered_map<std::string,const OpSpec*>   opmap;
 
     ExecSize                       m_defaultExecutionSize;
     Type                           m_defaultRegisterType;
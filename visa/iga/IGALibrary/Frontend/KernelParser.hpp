@@ -35,6 +35,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 // #include <functional>
 #include <map>
+#include <unordered_map>
 #include <string>
 
 namespace iga {
@@ -125,7 +126,7 @@ namespace iga {
         bool tryParseInstOptToken(InstOptSet &instOpts);
     private:
         void initSymbolMaps();
-        std::map<std::string,const RegInfo*>  m_regmap;
+        std::unordered_map<std::string,const RegInfo*>  m_regmap;
     };
 }
 
@@ -117,6 +117,11 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <map>
 #include <sstream>
 #include <string>
+#ifndef DISABLE_ENCODER_EXCEPTIONS
+#include <atomic>
+#include <system_error>
+#include <thread>
+#endif
 
 using namespace iga;
 
@@ -154,6 +159,45 @@ struct BlockState
     BlockState(Block *b) : block(b) { }
 };
 
+// Calls f(0), ..., f(n - 1) spread over up to numThreads threads (0 uses
+// one per hardware thread).  The encoder-only library is built without
+// exceptions and always runs serially.
+template <typename F>
+static void ParallelFor(size_t n, unsigned numThreads, F f)
+{
+#ifndef DISABLE_ENCODER_EXCEPTIONS
+    if (numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    numThreads = (unsigned)std::min<size_t>(numThreads, n);
+    if (numThreads > 1) {
+        std::atomic<size_t> next(0);
+        auto worker = [&]() {
+            for (size_t i = next++; i < n; i = next++) {
+                f(i);
+            }
+        };
+        // the calling thread is one of the workers
+        std::vector<std::thread> threads;
+        for (unsigned t = 1; t < numThreads; t++) {
+            try {
+                threads.emplace_back(worker);
+            } catch (const std::system_error &) {
+                break; // make do with the workers we have
+            }
+        }
+        worker();
+        for (auto &t : threads) {
+            t.join();
+        }
+        return;
+    }
+#endif
+    for (size_t i = 0; i < n; i++) {
+        f(i);
+    }
+}
+
 
 struct DepAnalysisComputer
 {
@@ -162,15 +206,21 @@ struct DepAnalysisComputer
     std::vector<InstDsts>            instDsts;
     std::vector<InstSrcs>            instSrcs;
 
+    unsigned                         numThreads;
+
     // mid-state and then output
     std::vector<BlockState>          blockState;
+    // blocks to compute; the rest keep the state they were seeded with
+    // (see UpdateDepAnalysis)
+    std::vector<bool>                activeBlocks;
 
-    // outputs
-    std::vector<Dep>           liveRangesResult;
+    // outputs (the paths completed in each block)
+    std::vector<std::vector<Dep>>    blockDeps;
 
-    DepAnalysisComputer(Kernel *_k)
+    DepAnalysisComputer(Kernel *_k, unsigned _numThreads)
         : model(_k->getModel())
         , k(_k)
+        , numThreads(_numThreads)
     {
         instSrcs.reserve(k->getInstructionCount());
         instDsts.reserve(k->getInstructionCount());
@@ -241,6 +291,9 @@ struct DepAnalysisComputer
             }
 
         }
+
+        activeBlocks.resize(blockState.size(), true);
+        blockDeps.resize(blockState.size());
     }
 
     void runAnalysis() {
@@ -255,28 +308,60 @@ struct DepAnalysisComputer
         do {
             TRACE("******* STARTING LIVE-IN ITERATION %d\n", itr);
             changed = false;
-            for (BlockState &bs : blockState) {
-                TRACE("  *** BLOCK %d with ...\n", bs.block->getID());
-                EmitPaths(bs.liveIn);
-                changed |= iterateBlockLiveIn(bs, false);
+            if (numThreads == 1) {
+                for (BlockState &bs : blockState) {
+                    if (!activeBlocks[bs.block->getID()])
+                        continue;
+                    TRACE("  *** BLOCK %d with ...\n", bs.block->getID());
+                    EmitPaths(bs.liveIn);
+                    LiveDepMap rLiveDefs;
+                    computeBlockLiveIn(bs, rLiveDefs, nullptr);
+                    changed |= propagateBlockLiveIn(bs, rLiveDefs);
+                }
+            } else {
+                // each block's live-in only depends on its own live-out,
+                // so compute them all in parallel from the previous
+                // iteration's live-outs; then merge the results into the
+                // predecessors' live-outs serially
+                std::vector<LiveDepMap> liveIns(blockState.size());
+                ParallelFor(blockState.size(), numThreads, [&](size_t bIx) {
+                    if (activeBlocks[bIx]) {
+                        computeBlockLiveIn(
+                            blockState[bIx], liveIns[bIx], nullptr);
+                    }
+                });
+                for (size_t bIx = 0; bIx < blockState.size(); bIx++) {
+                    if (activeBlocks[bIx]) {
+                        changed |= propagateBlockLiveIn(
+                            blockState[bIx], liveIns[bIx]);
+                    }
+                }
             }
             itr++;
             TRACE("\n");
         } while (changed);
     }
     void completePaths() {
-        // copy out the data
-        for (BlockState &b : blockState) {
-            iterateBlockLiveIn(b, true);
-        }
+        // copy out the data; the live sets are at a fixed point, so
+        // blocks can be completed independently
+        ParallelFor(blockState.size(), numThreads, [&](size_t bIx) {
+            if (activeBlocks[bIx]) {
+                LiveDepMap rLiveDefs;
+                computeBlockLiveIn(
+                    blockState[bIx], rLiveDefs, &blockDeps[bIx]);
+            }
+        });
     }
 
-    bool iterateBlockLiveIn(
-        BlockState &b,
-        bool copyOut)
+    // Computes the live paths at the top of the block from its live-out.
+    // If copyOut is set, the paths completed in this block are added to it.
+    void computeBlockLiveIn(
+        const BlockState &b,
+        LiveDepMap &rLiveDefs,
+        std::vector<Dep> *copyOut)
     {
         // all the live paths at the end of this block
-        LiveDepMap rLiveDefs = b.liveOut;
+        rLiveDefs = b.liveOut;
 
         // FOR each instruction i
         //   extend paths backwards
@@ -305,7 +390,14 @@ struct DepAnalysisComputer
             startNewDepsBackwards(i, rLiveDefs);
             iItr++;
         }
+    }
 
+    // Updates the block's live-in and joins it into the live-out of
+    // each predecessor; returns true if any predecessor changed.
+    bool propagateBlockLiveIn(
+        BlockState &b,
+        const LiveDepMap &rLiveDefs)
+    {
         bool bLiveInChanged = updateLiveDefs(b.liveIn, rLiveDefs);
         bool changedAnyPred = false;
         if (bLiveInChanged) {
@@ -326,7 +418,7 @@ struct DepAnalysisComputer
         Instruction *i,
         LiveDepMap &rLiveDefs,
         LiveDepMap::iterator &dItr,
-        bool copyOut)
+        std::vector<Dep> *copyOut)
     {
         const InstDsts &iOups = instDsts[i->getID()];
         Dep &d = dItr->second;
@@ -334,8 +426,8 @@ struct DepAnalysisComputer
         RegSet overlap;
         d.live.intersectInto(iOups.unionOf(), overlap);
         if (copyOut && !overlap.empty()) {
-            liveRangesResult.push_back(d);
-            Dep &d = liveRangesResult.back();
+            copyOut->push_back(d);
+            Dep &d = copyOut->back();
             d.def = i;
             d.live = overlap;
         }
@@ -426,9 +518,10 @@ struct DepAnalysisComputer
             LiveDepMap::iterator itr = predOUT.find(lrElem.first);
             if (itr == predOUT.end()) {
                 // clean insertion
-                Dep copy = lrSuccIN;
-                copy.crossesBranch = true;
-                predOUT[lrElem.first] = copy;
+                // (Dep's assignment operator doesn't assign, so this must
+                // copy construct the new entry)
+                auto val = predOUT.emplace(lrElem.first, lrSuccIN);
+                val.first->second.crossesBranch = true;
                 changed = true;
             } else {
                 // mutation of existing path
@@ -453,22 +546,6 @@ struct DepAnalysisComputer
             to = from;
         return changed;
     }
-
-    void addDep(
-        const Dep &lr,
-        Instruction *use,
-        Dep::Type type)
-    {
-        liveRangesResult.push_back(lr);
-        Dep &lr1 = liveRangesResult.back();
-        lr1.use = use;
-        lr1.useType = type;
-
-
-        std::stringstream ss;
-        lr1.str(ss);
-        TRACE("  => %s\n", ss.str().c_str());
-    }
 };
 
 // RAR{@3, #5 <- ?, r13..r14}
@@ -519,41 +596,144 @@ bool iga::Dep::operator==(const Dep &p) const
 }
 
 
-DepAnalysis iga::ComputeDepAnalysis(Kernel *k)
+// filters out any false WAW dependencies
+static bool IsRealDep(const Dep &d)
 {
-    DepAnalysisComputer lac(k);
-    lac.runAnalysis();
+    return d.def != nullptr || d.useType != Dep::WRITE;
+}
 
+// Copies the computer's results out.  The blocks that were not recomputed
+// take their paths from the previous analysis.
+static DepAnalysis CopyOutDepAnalysis(
+    const DepAnalysisComputer &dac,
+    const DepAnalysis *prev)
+{
     DepAnalysis la;
 
     // copy out block information
-    for (const auto &bs : lac.blockState) {
+    for (size_t bIx = 0; bIx < dac.blockState.size(); bIx++) {
+        const BlockState &bs = dac.blockState[bIx];
         TRACE("==== BLOCK %d LIVE-IN ====\n", bs.block->getID());
         EmitPaths(bs.liveIn);
 
         la.blockInfo.emplace_back(bs.block);
         BlockInfo &bi = la.blockInfo.back();
         auto addSet =
-            [] (const LiveDepMap &map, std::vector<Dep> &out) {
+            [] (const LiveDepMap &map,
+                std::vector<Dep> &out,
+                std::vector<Dep> &state)
+            {
                 for (const auto &pair : map) {
                     const Dep &d = pair.second;
-                    if (d.def != nullptr || d.useType != Dep::WRITE) {
-                        // filter out any false WAW dependencies
+                    if (IsRealDep(d)) {
                         out.push_back(d);
                     }
+                    state.push_back(d);
                 }
             };
-        addSet(bs.liveIn, bi.liveDefsIn);
-        addSet(bs.liveOut, bi.liveDefsOut);
-    }
-
-    // copy out the per-instruction live sets
-    for (const Dep &d : lac.liveRangesResult) {
-        if (d.def != nullptr || d.useType != Dep::WRITE) {
-            la.deps.push_back(d);
+        addSet(bs.liveIn, bi.liveDefsIn, bi.liveStateIn);
+        addSet(bs.liveOut, bi.liveDefsOut, bi.liveStateOut);
+
+        // copy out the per-instruction live sets
+        bi.depsBegin = la.deps.size();
+        if (dac.activeBlocks[bIx]) {
+            for (const Dep &d : dac.blockDeps[bIx]) {
+                if (IsRealDep(d)) {
+                    la.deps.push_back(d);
+                }
+            }
+        } else {
+            const BlockInfo &prevBi = prev->blockInfo[bIx];
+            la.deps.insert(la.deps.end(),
+                prev->deps.begin() + prevBi.depsBegin,
+                prev->deps.begin() + prevBi.depsEnd);
         }
+        bi.depsEnd = la.deps.size();
     }
 
     TRACE("=========== END ===========\n");
     return la;
 }
+
+
+DepAnalysis iga::ComputeDepAnalysis(Kernel *k, unsigned numThreads)
+{
+    DepAnalysisComputer lac(k, numThreads);
+    lac.runAnalysis();
+    return CopyOutDepAnalysis(lac, nullptr);
+}
+
+
+void iga::UpdateDepAnalysis(
+    Kernel *k,
+    DepAnalysis &la,
+    const std::vector<const Block *> &changedBlocks,
+    unsigned numThreads)
+{
+    DepAnalysisComputer lac(k, numThreads);
+
+    // the block list itself must be the same to reuse anything
+    bool reusable = la.blockInfo.size() == lac.blockState.size();
+    for (size_t bIx = 0; reusable && bIx < lac.blockState.size(); bIx++) {
+        reusable = la.blockInfo[bIx].block == lac.blockState[bIx].block;
+    }
+    if (!reusable) {
+        lac.runAnalysis();
+        la = CopyOutDepAnalysis(lac, nullptr);
+        return;
+    }
+
+    // Only the changed blocks and the blocks that can reach them can have
+    // different live sets; all other blocks only flow into unaffected
+    // blocks and keep their previous state.
+    std::vector<bool> &affected = lac.activeBlocks;
+    std::fill(affected.begin(), affected.end(), false);
+    std::vector<const BlockState *> worklist;
+    for (const Block *b : changedBlocks) {
+        if (!affected[b->getID()]) {
+            affected[b->getID()] = true;
+            worklist.push_back(&lac.blockState[b->getID()]);
+        }
+    }
+    while (!worklist.empty()) {
+        const BlockState *bs = worklist.back();
+        worklist.pop_back();
+        for (const auto &predEdge : bs->pred) {
+            int predId = predEdge.first->block->getID();
+            if (!affected[predId]) {
+                affected[predId] = true;
+                worklist.push_back(predEdge.first);
+            }
+        }
+    }
+
+    // seed the unaffected blocks from the previous analysis and feed their
+    // live-ins into the affected predecessors
+    auto loadSet = [] (const std::vector<Dep> &state, LiveDepMap &map) {
+        for (const Dep &d : state) {
+            map.emplace(DepKey(d.useType, d.use), d);
+        }
+    };
+    for (size_t bIx = 0; bIx < lac.blockState.size(); bIx++) {
+        if (!affected[bIx]) {
+            BlockState &bs = lac.blockState[bIx];
+            loadSet(la.blockInfo[bIx].liveStateIn, bs.liveIn);
+            loadSet(la.blockInfo[bIx].liveStateOut, bs.liveOut);
+        }
+    }
+    for (size_t bIx = 0; bIx < lac.blockState.size(); bIx++) {
+        if (affected[bIx]) {
+            continue;
+        }
+        BlockState &bs = lac.blockState[bIx];
+        for (auto &predEdge : bs.pred) {
+            if (affected[predEdge.first->block->getID()]) {
+                lac.joinBlocks(
+                    predEdge.first->liveOut, bs.liveIn, predEdge.second);
+            }
+        }
+    }
+
+    lac.runAnalysis();
+    la = CopyOutDepAnalysis(lac, &la);
+}
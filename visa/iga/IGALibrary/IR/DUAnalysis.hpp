@@ -93,6 +93,12 @@ namespace iga
         Block                   *block;
         std::vector<Dep>         liveDefsIn;
         std::vector<Dep>         liveDefsOut;
+        // the range of DepAnalysis::deps completed in this block
+        size_t                   depsBegin = 0, depsEnd = 0;
+        // the complete live sets including the unresolved WAW paths that
+        // liveDefsIn/liveDefsOut omit; UpdateDepAnalysis reuses these
+        std::vector<Dep>         liveStateIn;
+        std::vector<Dep>         liveStateOut;
 
         BlockInfo(Block *blk) : block(blk) { }
         BlockInfo(const BlockInfo &) = default;
@@ -108,7 +114,19 @@ namespace iga
     };
 
     // the primary entry point for the live analysis
-    DepAnalysis ComputeDepAnalysis(Kernel *k);
+    // numThreads allows the per-block work to run in parallel; 0 means one
+    // thread per hardware thread (the results are the same either way)
+    DepAnalysis ComputeDepAnalysis(Kernel *k, unsigned numThreads = 1);
+
+    // recomputes a previous analysis of the same kernel after edits to the
+    // instructions of changedBlocks; only those blocks and the blocks that
+    // can reach them are recomputed (if the block list itself changed, this
+    // falls back to a full analysis)
+    void UpdateDepAnalysis(
+        Kernel *k,
+        DepAnalysis &la,
+        const std::vector<const Block *> &changedBlocks,
+        unsigned numThreads = 1);
 } // namespace IGA
 
 #endif // _IGA_IR_ANALYSIS_HPP
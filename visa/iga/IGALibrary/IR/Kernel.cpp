@@ -28,9 +28,9 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 using namespace iga;
 
-Kernel::Kernel(const Model &model)
+Kernel::Kernel(const Model &model, size_t memChunkSize)
   : m_model(model)
-  , m_mem(4096)
+  , m_mem(memChunkSize)
 {
 }
 
@@ -46,7 +46,9 @@ namespace iga {
     class Kernel
     {
     public:
-        Kernel(const Model &model);
+        // memChunkSize is the arena chunk size; encoders that know the
+        // instruction count up front can size it to avoid many small chunks
+        Kernel(const Model &model, size_t memChunkSize = 4096);
         virtual ~Kernel();
         // disabling copy constructor to prevent problems with
         // shallow copy and mem manager
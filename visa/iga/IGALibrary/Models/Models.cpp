@@ -169,17 +169,53 @@ const OpSpec& Model::lookupOpSpec(Op op) const
     return opsArray[(int)op];
 }
 
+// A dense opcode to OpSpec table; only lookupOpSpecByCode uses this.
+// Models are static const aggregates, so the table lives beside them
+// and each one is built on first use (function-local statics are
+// thread-safe under C++11).  Entries preserve the linear search's
+// semantics: the first valid op in opsArray with a given code wins and
+// unmatched codes map to Op::INVALID.
+struct OpCodeTable {
+    const OpSpec *ops[128];
+
+    OpCodeTable(const Model &m) {
+        for (auto &os : ops) {
+            os = &m.opsArray[static_cast<int>(Op::INVALID)];
+        }
+        // walk backwards so that the lowest index wins a duplicate code
+        for (int i = (int)Op::LAST_OP; i >= (int)Op::FIRST_OP; i--) {
+            const OpSpec &os = m.opsArray[i];
+            if (os.op != Op::INVALID && os.code >= 0 && os.code < 128) {
+                ops[os.code] = &os;
+            }
+        }
+    }
+};
+
+static const OpCodeTable *lookupOpCodeTable(const Model *m)
+{
+    if (m == &MODEL_GEN7P5) {
+        static const OpCodeTable t(MODEL_GEN7P5); return &t;
+    } else if (m == &MODEL_GEN8) {
+        static const OpCodeTable t(MODEL_GEN8); return &t;
+    } else if (m == &MODEL_GEN9) {
+        static const OpCodeTable t(MODEL_GEN9); return &t;
+    } else if (m == &MODEL_GEN10) {
+        static const OpCodeTable t(MODEL_GEN10); return &t;
+    } else if (m == &MODEL_GEN11) {
+        static const OpCodeTable t(MODEL_GEN11); return &t;
+    }
+    return nullptr;
+}
+
 const OpSpec& Model::lookupOpSpecByCode(unsigned opcode) const
 {
-    // if (!opsByCodeValid) {
-    //     for (int i = (int)Op::FIRST_OP; i <= (int)Op::LAST_OP; i++) {
-    //         const OpSpec &os = lookupOpSpec((Op)i);
-    //         if (!os.isSubop()) {
-    //             opsByCode[os.code] = &os;
-    //         }
-    //     }
-    //     opsByCodeValid = true;
-    // }
+    const OpCodeTable *t = lookupOpCodeTable(this);
+    if (t) {
+        return opcode < 128 ?
+            *t->ops[opcode] : opsArray[static_cast<int>(Op::INVALID)];
+    }
+    // a model we don't know about; fall back to a linear search
     for (int i = (int)Op::FIRST_OP; i <= (int)Op::LAST_OP; i++) {
         // FIXME: BXML needs to default invalid fields to -1
         if (opsArray[i].op != Op::INVALID &&
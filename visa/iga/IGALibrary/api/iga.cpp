@@ -14,11 +14,16 @@
 
 // external dependencies
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <ostream>
 #include <sstream>
+#include <system_error>
+#include <thread>
 
 
 using namespace iga;
@@ -151,18 +156,58 @@ private:
     iga_context_options_t           m_opts;
     // the model corresponding to the gen options
     const Model&                    m_model;
-    // a cached copy of the assembled bits
-    // we free this upon destruction
-    void                           *m_assemble_bits;
-    // a cached copy of the last disassembled text
-    // we free this upon destruction
-    char                           *m_disassemble_text;
-    // a reusable empty string to return on errors
-    char                            m_empty_string[4];
-
-    // diagnostics from the last compile
-    bool                            m_errorsValid, m_warningsValid;
-    std::vector<iga_diagnostic_t>   m_errors, m_warnings;
+    // set for the per-platform contexts from iga_context_get_shared;
+    // those live until the process exits and ignore iga_context_release
+    bool                            m_shared;
+    // never reused within the process, unlike the address of the context
+    const uint64_t                  m_id;
+
+    // The results of the last call made from one thread.  The options and
+    // model above never change after construction; everything that a call
+    // produces lives here, one copy per calling thread, so a context can
+    // be used from several threads at once.
+    struct CallState {
+        // a cached copy of the assembled bits
+        void                           *assemble_bits = nullptr;
+        // a cached copy of the last disassembled text
+        char                           *disassemble_text = nullptr;
+        // a reusable empty string to return on errors
+        char                            empty_string[4] = {0};
+
+        // diagnostics from the last compile
+        bool                            errorsValid = false;
+        bool                            warningsValid = false;
+        std::vector<iga_diagnostic_t>   errors, warnings;
+
+        ~CallState() {
+            clearDiagnostics(warnings);
+            clearDiagnostics(errors);
+            free(disassemble_text);
+            free(assemble_bits);
+        }
+    };
+    typedef std::map<uint64_t,std::unique_ptr<CallState>> CallStateMap;
+
+    // The call states of the calling thread keyed by context id.  They are
+    // freed when the thread exits, so a later thread that gets the same
+    // thread id starts out clean.
+    static CallStateMap &threadCallStates() {
+        static thread_local CallStateMap callStates;
+        return callStates;
+    }
+
+    static uint64_t nextContextId() {
+        static std::atomic<uint64_t> nextId(1);
+        return nextId++;
+    }
+
+    CallState &callState() const {
+        std::unique_ptr<CallState> &cs = threadCallStates()[m_id];
+        if (!cs) {
+            cs.reset(new CallState());
+        }
+        return *cs;
+    }
 public:
     static void clearDiagnostics(std::vector<iga_diagnostic_t> &api_ds) {
         for (auto &d : api_ds) {
@@ -198,24 +243,25 @@ public:
     }
 
     iga_status_t translateDiagnostics(const iga::ErrorHandler &err) {
-        clearDiagnostics(m_errors);
-        clearDiagnostics(m_warnings);
-        m_warningsValid = m_errorsValid = false;
+        CallState &cs = callState();
+        clearDiagnostics(cs.errors);
+        clearDiagnostics(cs.warnings);
+        cs.warningsValid = cs.errorsValid = false;
 
-        iga_status_t s1 = translateDiagnosticList(err.getErrors(), m_errors);
+        iga_status_t s1 = translateDiagnosticList(err.getErrors(), cs.errors);
         if (s1 != IGA_SUCCESS) {
-            clearDiagnostics(m_errors);
+            clearDiagnostics(cs.errors);
             return s1;
         }
 
-        iga_status_t s2 = translateDiagnosticList(err.getWarnings(), m_warnings);
+        iga_status_t s2 = translateDiagnosticList(err.getWarnings(), cs.warnings);
         if (s2 != IGA_SUCCESS) {
-            clearDiagnostics(m_warnings);
-            clearDiagnostics(m_errors);
+            clearDiagnostics(cs.warnings);
+            clearDiagnostics(cs.errors);
             return s2;
         }
 
-        m_warningsValid = m_errorsValid = true;
+        cs.warningsValid = cs.errorsValid = true;
         return IGA_SUCCESS;
     }
 
@@ -230,32 +276,20 @@ public:
     static const uint64_t VALID_COOKIE = 0xFEDCBA9876543210ull;
 
 public:
-    IGAContext(iga_context_options_t opts, iga::Platform platf)
+    IGAContext(iga_context_options_t opts, iga::Platform platf, bool shared = false)
         : m_validToken(VALID_COOKIE)
         , m_opts(opts)
         , m_model(convertPlatform(opts.gen))
-        , m_assemble_bits(nullptr)
-        , m_disassemble_text(nullptr)
-        , m_errorsValid(false)
-        , m_warningsValid(false)
+        , m_shared(shared)
+        , m_id(nextContextId())
     {
-        memset(m_empty_string, 0, sizeof(m_empty_string));
     }
 
 
     ~IGAContext() {
         m_validToken = 0xDEADDEADDEADDEADull;
-        clearDiagnostics(m_warnings);
-        clearDiagnostics(m_errors);
-
-        if (m_disassemble_text) {
-            free(m_disassemble_text);
-            m_disassemble_text = nullptr;
-        }
-        if (m_assemble_bits) {
-            free(m_assemble_bits);
-            m_assemble_bits = nullptr;
-        }
+        // other threads free theirs when they exit
+        threadCallStates().erase(m_id);
     }
 
 
@@ -263,6 +297,10 @@ public:
         return m_validToken == VALID_COOKIE;
     }
 
+    bool shared() const {
+        return m_shared;
+    }
+
 
     iga_status_t assemble(
         iga_assemble_options_t &aopts,
@@ -318,9 +356,10 @@ public:
         // 3. Encode the final IR into bits
         //
         // clobber the last assembly's bits
-        if (m_assemble_bits) {
-            free(m_assemble_bits);
-            m_assemble_bits = nullptr;
+        CallState &cs = callState();
+        if (cs.assemble_bits) {
+            free(cs.assemble_bits);
+            cs.assemble_bits = nullptr;
         }
         size_t bitsLen = 0;
         EncoderOpts eopts(
@@ -357,13 +396,13 @@ public:
 
         // 4. Copy out the result
         // encoding succeeded, copy the bits out
-        m_assemble_bits = (void *)malloc(*bitsLen32);
-        if (!m_assemble_bits) {
+        cs.assemble_bits = (void *)malloc(*bitsLen32);
+        if (!cs.assemble_bits) {
             delete kernel;
             return IGA_OUT_OF_MEM;
         }
-        MEMCPY(m_assemble_bits, *bits, *bitsLen32);
-        *bits = m_assemble_bits;
+        MEMCPY(cs.assemble_bits, *bits, *bitsLen32);
+        *bits = cs.assemble_bits;
         delete kernel;
         return translateDiagnostics(errHandler);
     }
@@ -424,8 +463,19 @@ public:
         uint32_t bitsLen,
         Kernel *&k)
     {
-        k = nullptr;
         checkForLegacyFields(dopts, errHandler);
+        return decodeKernel(errHandler, dopts, bits, bitsLen, k);
+    }
+
+    // decodes without touching dopts (so it's safe to share across threads)
+    iga_status_t decodeKernel(
+        iga::ErrorHandler &errHandler,
+        const iga_disassemble_options_t &dopts,
+        const void *bits,
+        uint32_t bitsLen,
+        Kernel *&k) const
+    {
+        k = nullptr;
         DecoderOpts dopts2(
             (dopts.formatting_opts & IGA_FORMATTING_OPT_NUMERIC_LABELS) != 0);
         if ((dopts.decoder_opts & IGA_DECODING_OPT_NATIVE) == 0) {
@@ -452,8 +502,9 @@ public:
         void *formatLblEnv,
         char **output)
     {
+        CallState &cs = callState();
         if (output)
-            *output = &m_empty_string[0];
+            *output = &cs.empty_string[0];
 
         iga::Kernel *k = nullptr;
         iga::ErrorHandler errHandler;
@@ -467,31 +518,32 @@ public:
             k);
         if (k != nullptr) {
             // we succeeded in decoding; now format the output to text
-            std::stringstream ss;
+            std::string text;
             FormatOpts fopts = formatterOpts(dopts, formatLbl, formatLblEnv);
             DepAnalysis la;
             if (dopts.formatting_opts & IGA_FORMATTING_OPT_PRINT_DEPS) {
                 la = ComputeDepAnalysis(k);
                 fopts.liveAnalysis = &la;
             }
-            FormatKernel(errHandler, ss, fopts, *k, bits);
+            FormatKernel(errHandler, text, fopts, *k, bits);
 
             // copy the text out
-            if (m_disassemble_text) {
+            if (cs.disassemble_text) {
                 // previous disassemble clobbers new disassemble
-                free(m_disassemble_text);
+                free(cs.disassemble_text);
+                cs.disassemble_text = nullptr;
             }
-            size_t slen = (size_t)ss.tellp();
-            m_disassemble_text = (char *)malloc(1 + slen);
-            if (!m_disassemble_text) {
+            size_t slen = text.size();
+            cs.disassemble_text = (char *)malloc(1 + slen);
+            if (!cs.disassemble_text) {
                 // bail out
                 delete k;
                 return IGA_OUT_OF_MEM;
             }
-            ss.read(m_disassemble_text, slen);
-            m_disassemble_text[slen] = 0;
+            memcpy(cs.disassemble_text, text.data(), slen);
+            cs.disassemble_text[slen] = 0;
             if(output) {
-                *output = m_disassemble_text;
+                *output = cs.disassemble_text;
             }
 
             delete k;
@@ -505,6 +557,150 @@ public:
     }
 
 
+    // decodes and formats one batch entry; text and fopts are the calling
+    // worker's and are reused from one entry to the next
+    iga_status_t disassembleBatchEntry(
+        const iga_disassemble_options_t &dopts,
+        FormatOpts &fopts,
+        std::string &text,
+        iga_disassemble_batch_entry_t &e) const
+    {
+        e.output_size = 0;
+        if (e.output && e.output_capacity) {
+            e.output[0] = 0;
+        }
+
+        iga::Kernel *k = nullptr;
+        iga::ErrorHandler errHandler;
+        iga_status_t st =
+            decodeKernel(errHandler, dopts, e.input, e.input_size, k);
+        if (k == nullptr) {
+            return st;
+        }
+
+        text.clear();
+        DepAnalysis la;
+        fopts.liveAnalysis = nullptr;
+        if (dopts.formatting_opts & IGA_FORMATTING_OPT_PRINT_DEPS) {
+            la = ComputeDepAnalysis(k);
+            fopts.liveAnalysis = &la;
+        }
+        FormatKernel(errHandler, text, fopts, *k, e.input);
+        delete k;
+
+        size_t slen = text.size();
+        e.output_size = (uint32_t)slen;
+        if (e.output && e.output_capacity) {
+            size_t n = std::min(slen, (size_t)e.output_capacity - 1);
+            memcpy(e.output, text.data(), n);
+            e.output[n] = 0;
+        }
+        if (errHandler.hasErrors()) {
+            return IGA_DECODE_ERROR;
+        }
+        return slen < e.output_capacity ? IGA_SUCCESS : IGA_OUT_OF_MEM;
+    }
+
+
+    iga_status_t disassembleBatch(
+        iga_disassemble_options_t &dopts,
+        iga_disassemble_batch_entry_t *entries,
+        uint32_t numEntries,
+        uint32_t numThreads)
+    {
+        // fold in the legacy fields once up front; workers only read dopts
+        iga::ErrorHandler legacyErrs;
+        checkForLegacyFields(dopts, legacyErrs);
+        dopts._reserved0 = dopts._reserved1 = 0;
+
+        const FormatOpts fopts = formatterOpts(dopts, nullptr, nullptr);
+        std::atomic<uint32_t> nextEntry(0);
+        std::atomic<bool> anyFailed(false);
+        auto worker = [&]() {
+            std::string text;
+            FormatOpts workerOpts = fopts;
+            for (uint32_t i = nextEntry++; i < numEntries; i = nextEntry++) {
+                iga_disassemble_batch_entry_t &e = entries[i];
+                try {
+                    e.status = disassembleBatchEntry(dopts, workerOpts, text, e);
+                } catch (const std::bad_alloc &) {
+                    e.status = IGA_OUT_OF_MEM;
+                } catch (...) {
+                    e.status = IGA_ERROR;
+                }
+                if (e.status != IGA_SUCCESS) {
+                    anyFailed = true;
+                }
+            }
+        };
+
+        if (numThreads == 0) {
+            numThreads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        numThreads = std::min(numThreads, std::max(1u, numEntries));
+
+        // the calling thread is one of the workers
+        std::vector<std::thread> threads;
+        for (uint32_t t = 1; t < numThreads; t++) {
+            try {
+                threads.emplace_back(worker);
+            } catch (const std::system_error &) {
+                break; // make do with the workers we have
+            }
+        }
+        worker();
+        for (auto &t : threads) {
+            t.join();
+        }
+
+        return anyFailed ? IGA_ERROR : IGA_SUCCESS;
+    }
+
+
+    iga_status_t scanInstructions(
+        const void *bits,
+        uint32_t bitsLen,
+        iga_instruction_scan_t &scan) const
+    {
+        const uint8_t *bytes = (const uint8_t *)bits;
+        uint32_t n = 0;
+        uint32_t pc = 0;
+        while (pc < bitsLen) {
+            // need at least the first dword to see the compaction control
+            if (bitsLen - pc < 4) {
+                scan.count = n;
+                return IGA_DECODE_ERROR;
+            }
+            const MInst *mi = (const MInst *)(bytes + pc);
+            bool compacted = mi->isCompact();
+            uint32_t iLen = compacted ? 8 : 16;
+            if (bitsLen - pc < iLen) {
+                scan.count = n;
+                return IGA_DECODE_ERROR;
+            }
+            if (n < scan.capacity) {
+                const OpSpec *os =
+                    &m_model.lookupOpSpecByCode((unsigned)mi->getField(0, 7));
+                if (os->isGroup() && !compacted) {
+                    OpSpecMissInfo missInfo;
+                    os = &m_model.lookupOpSpecFromBits(mi, missInfo);
+                }
+                if (scan.pcs)
+                    scan.pcs[n] = pc;
+                if (scan.ops)
+                    scan.ops[n] = os->isValid() ?
+                        (uint32_t)os->op : (uint32_t)Op::INVALID;
+                if (scan.compacted)
+                    scan.compacted[n] = compacted ? 1 : 0;
+            }
+            n++;
+            pc += iLen;
+        }
+        scan.count = n;
+        return n <= scan.capacity ? IGA_SUCCESS : IGA_OUT_OF_MEM;
+    }
+
+
     iga_status_t disassembleInstruction(
         iga_disassemble_options_t &dopts,
         const void *bits,
@@ -512,8 +708,9 @@ public:
         void *formatLblEnv,
         char **output)
     {
+        CallState &cs = callState();
         if (output)
-            *output = &m_empty_string[0];
+            *output = &cs.empty_string[0];
 
         // infer the length based on compaction bit
         size_t bitsLen = ((const MInst *)bits)->isCompact() ? 8 : 16;
@@ -532,9 +729,10 @@ public:
             (uint32_t)bitsLen,
             k);
         if (k != nullptr) {
-            if (m_disassemble_text) {
+            if (cs.disassemble_text) {
                 // previous disassemble clobbers new disassemble
-                free(m_disassemble_text);
+                free(cs.disassemble_text);
+                cs.disassemble_text = nullptr;
             }
 
             const Instruction *firstInst = nullptr;
@@ -553,15 +751,15 @@ public:
             FormatInstruction(errHandler, ss, fopts, *firstInst);
 
             size_t slen = (size_t)ss.tellp();
-            m_disassemble_text = (char *)malloc(1 + slen);
-            if (!m_disassemble_text) {
+            cs.disassemble_text = (char *)malloc(1 + slen);
+            if (!cs.disassemble_text) {
                 delete k;
                 return IGA_OUT_OF_MEM;
             }
-            ss.read(m_disassemble_text, slen);
-            m_disassemble_text[slen] = 0;
+            ss.read(cs.disassemble_text, slen);
+            cs.disassemble_text[slen] = 0;
             if (output) {
-                *output = m_disassemble_text;
+                *output = cs.disassemble_text;
             }
 
             delete k;
@@ -578,13 +776,14 @@ public:
     iga_status_t getErrors(
         const iga_diagnostic_t **ds, uint32_t *ds_len) const
     {
-        if (!m_errorsValid) {
+        const CallState &cs = callState();
+        if (!cs.errorsValid) {
             *ds = nullptr;
             *ds_len = 0;
             return IGA_INVALID_STATE;
         }
-        *ds_len = (uint32_t)m_errors.size();
-        *ds = *ds_len ? &m_errors[0] : nullptr;
+        *ds_len = (uint32_t)cs.errors.size();
+        *ds = *ds_len ? &cs.errors[0] : nullptr;
         return IGA_SUCCESS;
     }
 
@@ -592,13 +791,14 @@ public:
     iga_status_t getWarnings(
         const iga_diagnostic_t **ds, uint32_t *ds_len) const
     {
-        if (!m_warningsValid) {
+        const CallState &cs = callState();
+        if (!cs.warningsValid) {
             *ds = nullptr;
             *ds_len = 0;
             return IGA_INVALID_STATE;
         }
-        *ds_len = (uint32_t)m_warnings.size();
-        *ds = *ds_len ? &m_warnings[0] : nullptr;
+        *ds_len = (uint32_t)cs.warnings.size();
+        *ds = *ds_len ? &cs.warnings[0] : nullptr;
         return IGA_SUCCESS;
     }
 };
@@ -659,12 +859,44 @@ iga_status_t  iga_create_context(
     return iga_context_create(opts, ctx);
 }
 
+iga_status_t  iga_context_get_shared(
+    iga_gen_t gen,
+    iga_context_t *ctx)
+{
+    RETURN_INVALID_ARG_ON_NULL(ctx);
+
+    iga::Platform p = ToPlatform(gen);
+    if (p == iga::Platform::INVALID) {
+        return IGA_UNSUPPORTED_PLATFORM;
+    }
+
+    // never freed; the contexts are handed out until the process exits
+    static std::mutex sharedLock;
+    static std::map<iga_gen_t,IGAContext *> *sharedContexts =
+        new std::map<iga_gen_t,IGAContext *>();
+
+    std::lock_guard<std::mutex> lock(sharedLock);
+    IGAContext *&ctx_obj = (*sharedContexts)[gen];
+    if (ctx_obj == nullptr) {
+        try {
+            ctx_obj = new IGAContext(IGA_CONTEXT_OPTIONS_INIT(gen), p, true);
+        } catch (std::bad_alloc &) {
+            return IGA_OUT_OF_MEM;
+        }
+    }
+    *ctx = (iga_context_t *)ctx_obj;
+
+    return IGA_SUCCESS;
+}
+
 iga_status_t  iga_context_release(iga_context_t ctx)
 {
     RETURN_INVALID_ARG_ON_NULL(ctx);
 
     CAST_CONTEXT(ctx_obj, ctx);
-    delete ctx_obj;
+    if (!ctx_obj->shared()) {
+        delete ctx_obj;
+    }
 
     return IGA_SUCCESS;
 }
@@ -751,6 +983,47 @@ iga_status_t  iga_disassemble(
         ctx, dopts, input, input_size, fmt_label_name, fmt_label_ctx, kernel_text);
 }
 
+iga_status_t  iga_context_disassemble_batch(
+    iga_context_t ctx,
+    const iga_disassemble_options_t *dopts,
+    iga_disassemble_batch_entry_t *entries,
+    uint32_t num_entries,
+    uint32_t num_threads)
+{
+    RETURN_INVALID_ARG_ON_NULL(ctx);
+    RETURN_INVALID_ARG_ON_NULL(dopts);
+    if (entries == nullptr && num_entries != 0)
+        return IGA_INVALID_ARG;
+    for (uint32_t i = 0; i < num_entries; i++) {
+        if (entries[i].input == nullptr && entries[i].input_size != 0)
+            return IGA_INVALID_ARG;
+    }
+    if (dopts->cb > sizeof(*dopts)) {
+        return IGA_VERSION_ERROR;
+    }
+    iga_disassemble_options_t doptsInternal = IGA_DISASSEMBLE_OPTIONS_INIT();
+    MEMCPY(&doptsInternal, dopts, dopts->cb);
+
+    CAST_CONTEXT(ctx_obj, ctx);
+    return ctx_obj->disassembleBatch(
+        doptsInternal, entries, num_entries, num_threads);
+}
+
+iga_status_t  iga_context_scan_instructions(
+    iga_context_t ctx,
+    const void *input,
+    uint32_t input_size,
+    iga_instruction_scan_t *scan)
+{
+    RETURN_INVALID_ARG_ON_NULL(ctx);
+    RETURN_INVALID_ARG_ON_NULL(scan);
+    if (input == nullptr && input_size != 0)
+        return IGA_INVALID_ARG;
+
+    CAST_CONTEXT(ctx_obj, ctx);
+    return ctx_obj->scanInstructions(input, input_size, *scan);
+}
+
 iga_status_t  iga_disassemble_instruction(
     iga_context_t ctx,
     const iga_disassemble_options_t *dopts,
@@ -173,6 +173,11 @@ typedef struct {
  * A context manages internal dynamically allocated memory containing
  * the diagnostics.
  *
+ * A context is immutable after creation and may be used from several threads
+ * concurrently.  The memory returned by a call (assembled bits, disassembly
+ * text and diagnostics) is kept per calling thread; it remains valid until
+ * the next call on this context from the same thread.
+ *
  * PARAMETERS:
  *  opts         the options to this iga context
  *  ctx          points to the newly created context
@@ -192,6 +197,23 @@ IGA_API iga_status_t  iga_create_context(
     const iga_context_options_t *opts,
     iga_context_t *ctx);
 
+/*
+ * Returns the process-wide context for a platform, creating it on first use.
+ * Every caller (and thread) asking for the same platform gets the same
+ * context, so encoders running in parallel need not create their own.
+ * The shared context lives until the process exits; passing it to
+ * 'iga_context_release' has no effect.
+ *
+ * RETURNS:
+ *  IGA_SUCCESS               upon success
+ *  IGA_INVALID_ARG           if ctx is NULL
+ *  IGA_OUT_OF_MEM            upon internal allocation failure
+ *  IGA_UNSUPPORTED_PLATFORM  if the platform passed is unsupported
+ */
+IGA_API iga_status_t  iga_context_get_shared(
+    iga_gen_t gen,
+    iga_context_t *ctx);
+
 
 /*
  * Releases a context previously created via 'iga_context_create'.
@@ -498,6 +520,97 @@ IGA_API  iga_status_t  iga_disassemble_instruction(
     void *fmt_label_ctx,
     char **kernel_text);
 
+
+/*
+ * One kernel of a batch passed to 'iga_context_disassemble_batch'.
+ */
+typedef struct {
+    const void   *input;           /* the kernel bits */
+    uint32_t      input_size;      /* the size of 'input' in bytes */
+    uint32_t      output_capacity; /* bytes available in 'output' (incl. NUL) */
+    char         *output;          /* caller-owned buffer for the text */
+    uint32_t      output_size;     /* [out] full text length (excl. NUL) */
+    iga_status_t  status;          /* [out] the result for this kernel */
+} iga_disassemble_batch_entry_t;
+
+/*
+ * Disassembles an array of kernels in parallel.
+ *
+ * Kernels are decoded and formatted on up to 'num_threads' worker threads
+ * of the calling context; each worker reuses its formatter state across the
+ * kernels it picks up.  The text of each kernel is written NUL-terminated
+ * into the entry's caller-supplied 'output' buffer; no memory is retained by
+ * the context.  Labels are always generated by IGA (there is no label
+ * callback) and the context's error and warning lists are left untouched.
+ *
+ * PARAMETERS:
+ *  ctx             an iga context
+ *  dopts           the disassemble options, applied to every kernel
+ *  entries         the kernels to disassemble
+ *  num_entries     the number of elements in 'entries'
+ *  num_threads     the maximum number of threads to use;
+ *                  0 means one per hardware thread
+ *
+ * Each entry's 'status' is set to:
+ *  IGA_SUCCESS         upon successful disassembly
+ *  IGA_OUT_OF_MEM      if 'output' was too small; the text is truncated
+ *                      and 'output_size' holds the length required
+ *  IGA_DECODE_ERROR    if the bits failed to decode
+ *  IGA_UNSUPPORTED_PLATFORM if the decoder does not support the platform
+ *
+ * RETURNS:
+ *  IGA_SUCCESS         if every entry succeeded
+ *  IGA_ERROR           if at least one entry failed (see the entry's status)
+ *  IGA_INVALID_ARG     if an argument is NULL
+ *  IGA_INVALID_OBJECT  if ctx has already been destroyed
+ */
+IGA_API  iga_status_t  iga_context_disassemble_batch(
+    iga_context_t ctx,
+    const iga_disassemble_options_t *dopts,
+    iga_disassemble_batch_entry_t *entries,
+    uint32_t num_entries,
+    uint32_t num_threads);
+
+/*
+ * The structure-of-arrays filled in by 'iga_context_scan_instructions'.
+ * The caller owns all the arrays; each holds 'capacity' elements.  Any of
+ * the arrays may be NULL if the caller is not interested in that attribute.
+ */
+typedef struct {
+    uint32_t      capacity;     /* elements available in each array */
+    uint32_t      count;        /* [out] number of instructions found */
+    uint32_t     *pcs;          /* [out] byte offset of each instruction */
+    uint32_t     *ops;          /* [out] the iga::Op of each instruction */
+    uint8_t      *compacted;    /* [out] 1 if the instruction is compacted */
+} iga_instruction_scan_t;
+
+/*
+ * Scans a kernel binary for instruction boundaries and operations.
+ *
+ * This does not go through the full decoder: each instruction costs one
+ * opcode table lookup (plus the function control bits for group ops such
+ * as math), which makes it considerably cheaper than a disassembly when
+ * only the instruction stream is of interest.  Compacted group ops report
+ * the group op itself (e.g. math), since their function control bits are
+ * only available after decompaction.  Unknown opcodes report Op::INVALID.
+ *
+ * If the binary holds more than 'capacity' instructions, the arrays are
+ * filled up to 'capacity', 'count' holds the total number and the function
+ * returns IGA_OUT_OF_MEM.
+ *
+ * RETURNS:
+ *  IGA_SUCCESS         upon success
+ *  IGA_OUT_OF_MEM      if the arrays were too small
+ *  IGA_DECODE_ERROR    if the binary ends in the middle of an instruction
+ *  IGA_INVALID_ARG     if an argument is NULL
+ *  IGA_INVALID_OBJECT  if ctx has already been destroyed
+ */
+IGA_API  iga_status_t  iga_context_scan_instructions(
+    iga_context_t ctx,
+    const void *input,
+    uint32_t input_size,
+    iga_instruction_scan_t *scan);
+
 /*
  * A diagnostic message (e.g. error or warning)
  *
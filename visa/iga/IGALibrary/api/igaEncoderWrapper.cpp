@@ -77,4 +77,32 @@ bool KernelEncoder::patchImmValue(const Model& model, unsigned char* binary, Typ
         return false;
 
     return true;
-}
\ No newline at end of file
+}
+bool KernelEncoder::patchJipValue(const Model& model, unsigned char* binary, int32_t jip) {
+    // calls to other compilation units are never compacted (see BinaryEncodingIGA),
+    // since a compacted JIP could not hold an arbitrary link offset
+    const uint32_t* inst_start = (const uint32_t*)binary;
+    uint32_t mask = (1 << (uint32_t)1) - 1;
+    if (((inst_start[COMPACTION_CONTROL / 32] >> (COMPACTION_CONTROL % 32)) & mask) != 0)
+        return false;
+
+    ged_ins_t ged_inst;
+    memset(&ged_inst, 0, sizeof(ged_inst));
+    const GED_MODEL& ged_model = IGAToGEDTranslation::lowerPlatform(model.platform);
+    GED_RETURN_VALUE status = GED_DecodeIns(ged_model, binary, (uint32_t)UNCOMPACTED_SIZE, &ged_inst);
+    assert(status == GED_RETURN_VALUE_SUCCESS);
+    if (status != GED_RETURN_VALUE_SUCCESS)
+        return false;
+
+    status = GED_SetJIP(&ged_inst, jip);
+    assert(status == GED_RETURN_VALUE_SUCCESS);
+    if (status != GED_RETURN_VALUE_SUCCESS)
+        return false;
+
+    status = GED_EncodeIns(&ged_inst, GED_INS_TYPE_NATIVE, binary);
+    assert(status == GED_RETURN_VALUE_SUCCESS);
+    if (status != GED_RETURN_VALUE_SUCCESS)
+        return false;
+
+    return true;
+}
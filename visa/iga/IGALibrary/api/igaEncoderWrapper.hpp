@@ -34,4 +34,10 @@ public:
     // FIXME: Move this api to somewhere else that's more apporopriate
     static bool patchImmValue(const iga::Model& model, unsigned char* binary, iga::Type type, const iga::ImmVal &val);
 
+    // patchJipValue - Decode the first instruction start from binary, and patch its JIP to the given
+    // byte offset relative to the instruction
+    // return - true on success, false if any error
+    // This function is used by visa to link calls to separately encoded stack call functions
+    static bool patchJipValue(const iga::Model& model, unsigned char* binary, int32_t jip);
+
 };
\ No newline at end of file
@@ -77,6 +77,11 @@ typedef iga_status_t(CDECLATTRIBUTE * pIGAAssemble)(
     void **output,
     uint32_t *output_size);
 
+#define IGA_CONTEXT_GET_SHARED_STR "iga_context_get_shared"
+typedef iga_status_t(CDECLATTRIBUTE * pIGAContextGetShared)(
+    iga_gen_t gen,
+    iga_context_t *ctx);
+
 #define IGA_CONTEXT_DISASSEMBLE_STR "iga_context_disassemble"
 typedef iga_status_t(CDECLATTRIBUTE * pIGAContextDisassemble)(
     iga_context_t ctx,
@@ -115,6 +120,21 @@ typedef iga_status_t(CDECLATTRIBUTE * pIGADisassembleInstruction)(
     void *fmt_label_ctx,
     char **kernel_text);
 
+#define IGA_CONTEXT_DISASSEMBLE_BATCH_STR "iga_context_disassemble_batch"
+typedef iga_status_t(CDECLATTRIBUTE * pIGAContextDisassembleBatch)(
+    iga_context_t ctx,
+    const iga_disassemble_options_t *dopts,
+    iga_disassemble_batch_entry_t *entries,
+    uint32_t num_entries,
+    uint32_t num_threads);
+
+#define IGA_CONTEXT_SCAN_INSTRUCTIONS_STR "iga_context_scan_instructions"
+typedef iga_status_t(CDECLATTRIBUTE * pIGAContextScanInstructions)(
+    iga_context_t ctx,
+    const void *input,
+    uint32_t input_size,
+    iga_instruction_scan_t *scan);
+
 #define IGA_CONTEXT_GET_ERRORS_STR "iga_context_get_errors"
 typedef iga_status_t(CDECLATTRIBUTE * pIGAContextGetErrors)(
     iga_context_t ctx,
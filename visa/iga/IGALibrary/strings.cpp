@@ -145,14 +145,24 @@ void iga::fmtBinary(std::ostream &os, uint64_t val, int w)
 
 void iga::fmtHexDigits(std::ostream &os, uint64_t val, int w)
 {
-    std::stringstream ss;
-    if (w > 0) {
-        ss << std::setw(w) << std::setfill('0') <<
-            std::hex << std::uppercase << val;
-    } else {
-        ss << std::hex << std::uppercase << val;
+    // formatted by hand since this is hot in the formatter and a
+    // temporary std::stringstream costs far more than the digits
+    char digits[16];
+    int n = 0;
+    do {
+        digits[n++] = "0123456789ABCDEF"[val & 0xF];
+        val >>= 4;
+    } while (val != 0);
+    char buf[80];
+    int len = 0;
+    for (int i = n; i < w && len < (int)sizeof(buf) - 17; i++) {
+        buf[len++] = '0';
+    }
+    while (n > 0) {
+        buf[len++] = digits[--n];
     }
-    os << ss.str();
+    buf[len] = 0;
+    os << buf;
 }
 void iga::fmtHex(std::ostream &os, uint64_t val, int w)
 {
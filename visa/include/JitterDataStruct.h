@@ -72,6 +72,26 @@ typedef struct _CM_JIT_INFO {
 
     void* freeGRFInfo;
     unsigned int freeGRFInfoSize;
+
+    // Peak KB held in the finalizer's memory arenas while building and
+    // optimizing the IR, during register allocation, and from the end
+    // of register allocation to the end of encoding.
+    unsigned int peakIRArenaKB;
+    unsigned int peakRAArenaKB;
+    unsigned int peakPostRAArenaKB;
+
+    // Number of instructions encoded in compacted form.
+    unsigned int numCompactedInst;
+
+    // Number of send instructions by target: sampler, data port (including
+    // spill/fill), and all remaining shared functions.
+    unsigned int numSamplerSends;
+    unsigned int numDataPortSends;
+    unsigned int numOtherSends;
+
+    // Static cycle estimate of the kernel weighted by loop nest level,
+    // saturated to 32 bits; only computed with vISA_EstimateCycles.
+    unsigned int numEstimatedCycles;
 } FINALIZER_INFO;
 
 #define MAX_ERROR_MSG_LEN               511
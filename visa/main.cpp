@@ -24,6 +24,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 ======================= end_copyright_notice ==================================*/
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 
@@ -43,6 +44,12 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "JitterDataStruct.h"
 #ifndef DLL_MODE
 #include "EnumFiles.hpp"
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 #endif
 
 using namespace std;
@@ -94,62 +101,93 @@ void parseNativeRelocs(CISA_IR_Builder* cisaBuilder)
     }
 }
 
-void parse(const char *fileName, std::string testName, int argc, const char *argv[], Options &opt)
+// Read-only view of a vISA binary file. The file is memory mapped where the
+// OS supports it and read into a heap buffer otherwise.
+class MappedISAFile
 {
-    vISA::Mem_Manager phyRegMem(PHY_REG_MEM_SIZE);
-    vISA::PhyRegPool phyRegPool(phyRegMem, opt.getuInt32Option(vISA_TotalGRFNum));
+    char* buf = nullptr;
+    size_t size = 0;
+    bool mapped = false;
 
-    // read in common isa binary file
-    int c;
-    char *buf;
-    FILE *commonISAInput = NULL;
-    long file_size;
-    unsigned byte_pos = 0;
-    common_isa_header commonISAHeader;
-    vISA::Mem_Manager globalMem(KERNEL_MEM_SIZE);
-
-    // open common isa file
-    if ((commonISAInput = fopen(fileName, "rb")) == NULL)
+public:
+    ~MappedISAFile() { close(); }
+
+    bool open(const char* fileName)
     {
-        fprintf(stderr, "Cannot open file %s\n", fileName);
-        exit(1);
+#if !defined(_WIN32)
+        int fd = ::open(fileName, O_RDONLY);
+        if (fd == -1)
+        {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED)
+            {
+                buf = (char*)p;
+                size = (size_t)st.st_size;
+                mapped = true;
+            }
+        }
+        ::close(fd);
+        if (mapped)
+        {
+            return true;
+        }
+#endif
+        FILE* fp = fopen(fileName, "rb");
+        if (fp == NULL)
+        {
+            return false;
+        }
+        fseek(fp, 0, SEEK_END);
+        long fileSize = ftell(fp);
+        rewind(fp);
+        buf = (char*)malloc(fileSize > 0 ? fileSize : 1);
+        size = fread(buf, 1, fileSize > 0 ? fileSize : 0, fp);
+        fclose(fp);
+        if ((long)size != fileSize)
+        {
+            cerr << "Unable to read entire file into buffer." << endl;
+            exit(EXIT_FAILURE);
+        }
+        return true;
     }
 
-    fseek(commonISAInput, 0, SEEK_END);
-    file_size = ftell(commonISAInput);
-    fseek(commonISAInput, 0, SEEK_SET);
-
-    buf = (char*)globalMem.alloc(file_size + 1);
-    char *buf_ptr = buf;
-    while ((c = fgetc(commonISAInput)) != EOF) {
-        *buf_ptr = c;
-        buf_ptr++;
+    void close()
+    {
+#if !defined(_WIN32)
+        if (mapped)
+        {
+            munmap(buf, size);
+        }
+        else
+#endif
+        {
+            free(buf);
+        }
+        buf = nullptr;
+        mapped = false;
     }
 
-    processCommonISAHeader(commonISAHeader, byte_pos, buf, &globalMem);
-    fclose(commonISAInput);
-    vISA::Mem_Manager mem(4096);
-
-    /// Try opening the file.
-    FILE* isafile = fopen(fileName, "rb");
-    if (!isafile) {
-        cerr << "Failure, unable to be opened." << endl;
-        exit(EXIT_FAILURE);
-    }
+    const char* data() const { return buf; }
+};
 
-    /// Calculate file size.
-    fseek(isafile, 0, SEEK_END);
-    long isafilesize = ftell(isafile);
-    rewind(isafile);
+void parse(const char *fileName, std::string testName, int argc, const char *argv[], Options &opt, unsigned iteration = 0)
+{
+    vISA::Mem_Manager phyRegMem(PHY_REG_MEM_SIZE);
+    vISA::PhyRegPool phyRegPool(phyRegMem, opt.getuInt32Option(vISA_TotalGRFNum));
 
-    /// Reading file into buffer.
-    char* isafilebuf = (char*)mem.alloc(isafilesize);
-    if (isafilesize != fread(isafilebuf, 1, isafilesize, isafile))
+    // the byte code reader decodes straight out of the mapped file
+    MappedISAFile isafile;
+    if (!isafile.open(fileName))
     {
-        cerr << "Unable to read entire file into buffer." << endl;
-        exit(EXIT_FAILURE);
+        fprintf(stderr, "Cannot open file %s\n", fileName);
+        exit(1);
     }
-    fclose(isafile);
+    const char* isafilebuf = isafile.data();
 
     TARGET_PLATFORM platform = getGenxPlatform();
     CM_VISA_BUILDER_OPTION builderOption =
@@ -175,9 +213,11 @@ void parse(const char *fileName, std::string testName, int argc, const char *arg
     // Pass testname to CISA IR Builder instance so that
     // it can use it to create filename for FC patch
     cisa_builder->setTestName(testName);
+    cisa_builder->setBenchmarkIteration(iteration);
 
     int result = cisa_builder->Compile((char*)binFileName.c_str());
     CISA_IR_Builder::DestroyBuilder(cisa_builder);
+    isafile.close();
     if (result != CM_SUCCESS)
     {
         exit(1);
@@ -472,7 +512,19 @@ int main( int argc, const char *argv[] )
         }
         else
         {
-            parse(fName.c_str(), testName, argc - startPos, &argv[startPos], opt);
+            // -benchmark replays each input several times, with a fresh
+            // builder per iteration, and names the results after the input.
+            std::string inputName = testName;
+            unsigned numIterations = 1;
+            if (opt.getOptionCstr(vISA_BenchmarkFile))
+            {
+                inputName = fName.substr(0, fName.find_last_of("."));
+                numIterations = std::max(1u, opt.getuInt32Option(vISA_BenchmarkIterations));
+            }
+            for (unsigned iter = 0; iter < numIterations; iter++)
+            {
+                parse(fName.c_str(), inputName, argc - startPos, &argv[startPos], opt, iter);
+            }
         }
     }
 